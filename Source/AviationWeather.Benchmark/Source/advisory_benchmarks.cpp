@@ -0,0 +1,144 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.BenchmarkPch.h"
+
+#include <random>
+
+#include <AviationWeather/advisory.h>
+#include <AviationWeather/advisory_index.h>
+
+#include "benchmark.h"
+#include "corpus.h"
+
+namespace aw
+{
+namespace benchmark
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+// Several hours of SIGMETs for a continent, queried along many route legs
+const size_t g_advisoryCount = 5000;
+const size_t g_queryCount = 20000;
+
+struct route_leg
+{
+    geo_point from;
+    geo_point to;
+    time      at;
+};
+
+std::vector<route_leg> generate_legs(std::vector<advisory> const& advisories)
+{
+    std::mt19937 random(3);
+    std::uniform_real_distribution<double> latitude(25.0, 55.0);
+    std::uniform_real_distribution<double> longitude(-125.0, -65.0);
+    std::uniform_real_distribution<double> length(-1.5, 1.5);
+    std::uniform_int_distribution<size_t> reference(0, advisories.size() - 1);
+
+    // Query at the start of a random advisory so some of the set is active
+    std::vector<route_leg> legs(g_queryCount);
+    for (auto& leg : legs)
+    {
+        leg.from = { latitude(random), longitude(random) };
+        leg.to = { leg.from.latitude + length(random), leg.from.longitude + length(random) };
+        leg.at = *advisories[reference(random)].valid_from;
+    }
+    return legs;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+BENCHMARK(Advisory_Decode)
+{
+    auto bulletin = generate_sigmet_bulletin(g_advisoryCount);
+    const size_t iterations = 5;
+
+    auto elapsed = measure([&]()
+    {
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            consume(decode_advisories(bulletin).size());
+        }
+    });
+    report("SIGMET bulletin", g_advisoryCount * iterations, elapsed);
+}
+
+BENCHMARK(Advisory_Query)
+{
+    auto advisories = decode_advisories(generate_sigmet_bulletin(g_advisoryCount));
+    auto legs = generate_legs(advisories);
+
+    advisory_index index;
+    auto elapsed = measure([&]()
+    {
+        index.build(advisories);
+        consume(index.size());
+    });
+    report("index build", advisories.size(), elapsed);
+
+    size_t matches = 0;
+    elapsed = measure([&]()
+    {
+        for (auto const& leg : legs)
+        {
+            for (auto const& a : advisories)
+            {
+                if (a.active(leg.at) && a.intersects(leg.from, leg.to))
+                {
+                    ++matches;
+                }
+            }
+        }
+    });
+    consume(matches);
+    report("route legs, every advisory", legs.size(), elapsed);
+
+    std::vector<size_t> results;
+    size_t indexedMatches = 0;
+    elapsed = measure([&]()
+    {
+        for (auto const& leg : legs)
+        {
+            index.query(leg.from, leg.to, leg.at, results);
+            indexedMatches += results.size();
+        }
+    });
+    consume(indexedMatches);
+    report("route legs, index", legs.size(), elapsed);
+    note(std::to_string(indexedMatches) + " matches, " + std::to_string(matches) + " expected");
+
+    elapsed = measure([&]()
+    {
+        for (auto const& leg : legs)
+        {
+            index.query(leg.from, leg.at, results);
+            consume(results.size());
+        }
+    });
+    report("points, index", legs.size(), elapsed);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
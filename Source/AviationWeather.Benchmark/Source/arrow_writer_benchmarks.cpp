@@ -0,0 +1,115 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.BenchmarkPch.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <AviationWeather/arrow_writer.h>
+#include <AviationWeather/json_writer.h>
+#include <AviationWeather/metar.h>
+
+#include "benchmark.h"
+#include "corpus.h"
+
+namespace aw
+{
+namespace benchmark
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const size_t g_reportCount = 100000;
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+BENCHMARK(ArrowWriter_Write)
+{
+    auto reports = generate_metars(g_reportCount);
+
+    std::vector<metar> parsed;
+    parsed.reserve(reports.size());
+    auto parseTime = measure([&]()
+    {
+        for (auto const& report : reports)
+        {
+            parsed.emplace_back(report);
+        }
+    });
+    report("parse text", parsed.size(), parseTime);
+
+    // The second pass reuses the buffer's capacity
+    std::vector<uint8_t> buffer;
+    write_arrow(parsed, buffer);
+
+    auto elapsed = measure([&]()
+    {
+        buffer.clear();
+        write_arrow(parsed, buffer);
+    });
+    report("write Arrow stream", parsed.size(), elapsed);
+    consume(buffer.size());
+
+    std::vector<metar_view> views;
+    views.reserve(reports.size());
+    for (auto const& report : reports)
+    {
+        views.emplace_back(report);
+    }
+
+    std::vector<uint8_t> viewBuffer;
+    viewBuffer.reserve(buffer.capacity());
+    auto viewTime = measure([&]()
+    {
+        viewBuffer.clear();
+        arrow_writer writer(viewBuffer);
+        writer.write(views.data(), views.size());
+        writer.close();
+    });
+    report("write Arrow stream from views", views.size(), viewTime);
+    consume(viewBuffer.size());
+
+    std::string json;
+    write_json(parsed, json);
+    auto jsonTime = measure([&]()
+    {
+        json.clear();
+        write_json(parsed, json);
+    });
+    report("write NDJSON", parsed.size(), jsonTime);
+    consume(json.size());
+
+    char text[160];
+    snprintf(text, sizeof(text), "%.1f bytes per report (NDJSON %.1f), %.0f MB/s, writing %.1fx faster than parsing",
+        static_cast<double>(buffer.size()) / parsed.size(),
+        static_cast<double>(json.size()) / parsed.size(),
+        buffer.size() / (elapsed.count() / 1000.0),
+        static_cast<double>(parseTime.count()) / elapsed.count());
+    note(text);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
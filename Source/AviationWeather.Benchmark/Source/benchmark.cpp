@@ -0,0 +1,94 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.BenchmarkPch.h"
+
+#include <atomic>
+#include <utility>
+
+#include "benchmark.h"
+
+namespace aw
+{
+namespace benchmark
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+typedef std::vector<std::pair<std::string, benchmark_function>> benchmark_list;
+
+benchmark_list& registered_benchmarks()
+{
+    static benchmark_list benchmarks;
+    return benchmarks;
+}
+
+std::atomic<size_t> g_sink(0);
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+registration::registration(const char* name, benchmark_function function)
+{
+    registered_benchmarks().emplace_back(name, function);
+}
+
+size_t run(std::string const& filter)
+{
+    size_t count = 0;
+    for (auto const& benchmark : registered_benchmarks())
+    {
+        if (benchmark.first.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        printf("%s\n", benchmark.first.c_str());
+        benchmark.second();
+        printf("\n");
+        ++count;
+    }
+    return count;
+}
+
+void report(std::string const& label, size_t operations, std::chrono::nanoseconds elapsed)
+{
+    auto nanoseconds = static_cast<double>(elapsed.count());
+    auto perOperation = operations ? nanoseconds / operations : 0.0;
+    auto perSecond = nanoseconds > 0.0 ? operations * 1e9 / nanoseconds : 0.0;
+
+    printf("  %-40s %10.2f ms %12.1f ns/op %14.0f op/s\n",
+        label.c_str(), nanoseconds / 1e6, perOperation, perSecond);
+}
+
+void note(std::string const& text)
+{
+    printf("    %s\n", text.c_str());
+}
+
+void consume(size_t value)
+{
+    g_sink.fetch_add(value, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
@@ -0,0 +1,68 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace aw
+{
+namespace benchmark
+{
+
+//-----------------------------------------------------------------------------
+
+typedef void (*benchmark_function)();
+
+// Registers a benchmark with the runner at static initialization time. Use
+// the BENCHMARK macro rather than instantiating this directly.
+struct registration
+{
+    registration(const char* name, benchmark_function function);
+};
+
+// Runs every registered benchmark whose name contains the filter, in
+// registration order. Returns the number of benchmarks run.
+size_t run(std::string const& filter);
+
+// Prints a single result line: total time, time per operation and throughput
+void report(std::string const& label, size_t operations, std::chrono::nanoseconds elapsed);
+
+// Prints a free-form line beneath the current benchmark
+void note(std::string const& text);
+
+// Keeps a computed value observable so the measured work is not optimized away
+void consume(size_t value);
+
+template <class TLambda>
+std::chrono::nanoseconds measure(TLambda&& l)
+{
+    auto start = std::chrono::steady_clock::now();
+    l();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
+
+#define BENCHMARK(name) \
+    static void name(); \
+    static ::aw::benchmark::registration name##_registration(#name, &name); \
+    static void name()
@@ -0,0 +1,90 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.BenchmarkPch.h"
+
+#include <random>
+
+#include <AviationWeather/converters.h>
+
+#include "benchmark.h"
+
+namespace aw
+{
+namespace benchmark
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const size_t g_columnSize = 100000;
+const size_t g_iterations = 20;
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+BENCHMARK(Converters_Distance)
+{
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> distribution(0.0f, 20000.0f);
+    std::vector<float> values(g_columnSize);
+    for (auto& value : values)
+    {
+        value = distribution(random);
+    }
+    std::vector<float> results(g_columnSize);
+
+    auto elapsed = measure([&]()
+    {
+        for (size_t n = 0; n < g_iterations; ++n)
+        {
+            for (size_t i = 0; i < g_columnSize; ++i)
+            {
+                results[i] = convert<float>(values[i], distance_unit::feet, distance_unit::metres);
+            }
+            consume(results[n]);
+        }
+    });
+    report("scalar", g_iterations * g_columnSize, elapsed);
+
+    elapsed = measure([&]()
+    {
+        for (size_t n = 0; n < g_iterations; ++n)
+        {
+            convert(values.data(), values.size(), distance_unit::feet, distance_unit::metres, results.data());
+            consume(results[n]);
+        }
+    });
+    report("batch", g_iterations * g_columnSize, elapsed);
+
+    elapsed = measure([&]()
+    {
+        for (size_t n = 0; n < g_iterations; ++n)
+        {
+            convert<distance_unit::feet, distance_unit::metres>(values.data(), values.size(), results.data());
+            consume(results[n]);
+        }
+    });
+    report("compile-time batch", g_iterations * g_columnSize, elapsed);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
@@ -0,0 +1,538 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.BenchmarkPch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+#include "corpus.h"
+
+namespace aw
+{
+namespace benchmark
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const char* g_weather[] =
+{
+    "-RA", "RA", "+RA", "-SN", "BR", "HZ", "FG", "TSRA", "-DZ", "SHRA", "-RA BR", "VCSH"
+};
+
+const char* g_cover[] = { "FEW", "SCT", "BKN", "OVC" };
+
+const char* g_visibility[] = { "10SM", "9SM", "7SM", "5SM", "3SM", "1 1/2SM", "1SM", "1/2SM", "1/4SM" };
+
+const char* g_metricVisibility[] = { "9999", "8000", "6000", "4000", "2500", "1200", "0800", "0400" };
+
+const char* g_trends[] =
+{
+    "NOSIG", "BECMG 6000 -RA", "TEMPO 3000 SHRA BKN012", "BECMG FM1200 TL1300 27015G25KT", "TEMPO TL1500 0800 FG"
+};
+
+const char* g_remarks[] =
+{
+    "RMK AO2", "RMK AO2 SLP132", "RMK AO2 SLP119 T01610150", "RMK AO1", "RMK AO2 PK WND 18028/0112 SLP057"
+};
+
+template <class T, size_t N>
+T const& pick(T const (&values)[N], std::mt19937& random)
+{
+    return values[std::uniform_int_distribution<size_t>(0, N - 1)(random)];
+}
+
+int uniform(std::mt19937& random, int lower, int upper)
+{
+    return std::uniform_int_distribution<int>(lower, upper)(random);
+}
+
+std::string temperature(int value)
+{
+    char buffer[8];
+    snprintf(buffer, sizeof(buffer), value < 0 ? "M%02d" : "%02d", value < 0 ? -value : value);
+    return buffer;
+}
+
+std::string wind_group(std::mt19937& random)
+{
+    char buffer[32];
+    auto speed = uniform(random, 0, 30);
+    if (speed < 3)
+    {
+        snprintf(buffer, sizeof(buffer), "VRB%02dKT", speed);
+    }
+    else if (speed > 18)
+    {
+        snprintf(buffer, sizeof(buffer), "%03d%02dG%02dKT", uniform(random, 1, 36) * 10, speed, speed + uniform(random, 5, 15));
+    }
+    else
+    {
+        snprintf(buffer, sizeof(buffer), "%03d%02dKT", uniform(random, 1, 36) * 10, speed);
+    }
+    return buffer;
+}
+
+// Wind, visibility, optional weather and one to three cloud layers
+std::string forecast_conditions(std::mt19937& random, bool includeWind)
+{
+    std::string conditions;
+    if (includeWind)
+    {
+        conditions += wind_group(random) + " ";
+    }
+
+    auto visibility = uniform(random, 0, 2) ? 0 : uniform(random, 1, 8);
+    conditions += visibility == 0 ? "P6SM" : g_visibility[visibility];
+
+    if (visibility > 0)
+    {
+        conditions += " ";
+        conditions += pick(g_weather, random);
+    }
+
+    char buffer[16];
+    for (int layer = 0, layers = uniform(random, 1, 3), height = uniform(random, 5, 40); layer < layers;
+        ++layer, height += uniform(random, 10, 80))
+    {
+        snprintf(buffer, sizeof(buffer), " %s%03d", pick(g_cover, random), height);
+        conditions += buffer;
+    }
+    return conditions;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+std::vector<std::string> generate_metars(size_t count, uint32_t seed)
+{
+    std::mt19937 random(seed);
+    std::vector<std::string> reports;
+    reports.reserve(count);
+
+    char buffer[64];
+    for (size_t i = 0; i < count; ++i)
+    {
+        // Station identifiers cycle through a fixed set while the observation
+        // time advances so that every report is distinct
+        auto station = i % 2000;
+        std::string report = "K";
+        report += static_cast<char>('A' + station / 676 % 26);
+        report += static_cast<char>('A' + station / 26 % 26);
+        report += static_cast<char>('A' + station % 26);
+
+        auto minutes = static_cast<int>(i / 2000);
+        snprintf(buffer, sizeof(buffer), " %02d%02d%02dZ", 1 + minutes / 1440 % 28, minutes / 60 % 24, minutes % 60);
+        report += buffer;
+
+        if (uniform(random, 0, 9) < 3)
+        {
+            report += " AUTO";
+        }
+
+        auto speed = uniform(random, 0, 25);
+        if (speed == 0)
+        {
+            report += " 00000KT";
+        }
+        else
+        {
+            snprintf(buffer, sizeof(buffer), " %03d%02d", uniform(random, 1, 36) * 10, speed);
+            report += buffer;
+            if (speed > 15)
+            {
+                snprintf(buffer, sizeof(buffer), "G%02d", speed + uniform(random, 5, 15));
+                report += buffer;
+            }
+            report += "KT";
+        }
+
+        auto visibility = uniform(random, 0, 3) ? 0 : uniform(random, 1, 8);
+        report += " ";
+        report += g_visibility[visibility];
+
+        if (visibility > 0 || uniform(random, 0, 4) == 0)
+        {
+            report += " ";
+            report += pick(g_weather, random);
+        }
+
+        auto layers = uniform(random, 0, 3);
+        if (layers == 0)
+        {
+            report += " CLR";
+        }
+        for (int layer = 0, height = uniform(random, 3, 40); layer < layers; ++layer, height += uniform(random, 10, 60))
+        {
+            snprintf(buffer, sizeof(buffer), " %s%03d", pick(g_cover, random), height);
+            report += buffer;
+        }
+
+        auto t = uniform(random, -20, 35);
+        auto td = t - uniform(random, 0, 15);
+        report += " " + temperature(t) + "/" + temperature(td);
+
+        snprintf(buffer, sizeof(buffer), " A%04d", uniform(random, 2920, 3080));
+        report += buffer;
+
+        if (uniform(random, 0, 1))
+        {
+            report += " ";
+            report += pick(g_remarks, random);
+        }
+
+        reports.push_back(std::move(report));
+    }
+
+    return reports;
+}
+
+//-----------------------------------------------------------------------------
+
+std::vector<std::string> generate_international_metars(size_t count, uint32_t seed)
+{
+    std::mt19937 random(seed);
+    std::vector<std::string> reports;
+    reports.reserve(count);
+
+    char buffer[64];
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto station = i % 2000;
+        std::string report = "METAR E";
+        report += static_cast<char>('A' + station / 676 % 26);
+        report += static_cast<char>('A' + station / 26 % 26);
+        report += static_cast<char>('A' + station % 26);
+
+        auto minutes = static_cast<int>(i / 2000);
+        snprintf(buffer, sizeof(buffer), " %02d%02d%02dZ", 1 + minutes / 1440 % 28, minutes / 60 % 24, minutes % 60);
+        report += buffer;
+
+        auto speed = uniform(random, 1, 15);
+        snprintf(buffer, sizeof(buffer), " %03d%02d%s", uniform(random, 1, 36) * 10, speed, uniform(random, 0, 3) ? "KT" : "MPS");
+        report += buffer;
+
+        auto visibility = uniform(random, 0, 2) ? 0 : uniform(random, 1, 7);
+        report += " ";
+        report += g_metricVisibility[visibility];
+
+        if (visibility >= 5)
+        {
+            snprintf(buffer, sizeof(buffer), " R%02dL/%04d%c", uniform(random, 1, 36), visibility == 7 ? 350 : 900,
+                "UDN"[uniform(random, 0, 2)]);
+            report += buffer;
+        }
+
+        if (visibility > 0)
+        {
+            report += " ";
+            report += pick(g_weather, random);
+        }
+
+        auto layers = uniform(random, 0, 3);
+        if (layers == 0)
+        {
+            report += uniform(random, 0, 1) ? " NSC" : " NCD";
+        }
+        for (int layer = 0, height = uniform(random, 3, 40); layer < layers; ++layer, height += uniform(random, 10, 60))
+        {
+            snprintf(buffer, sizeof(buffer), " %s%03d", pick(g_cover, random), height);
+            report += buffer;
+        }
+
+        auto t = uniform(random, -20, 35);
+        auto td = t - uniform(random, 0, 15);
+        report += " " + temperature(t) + "/" + temperature(td);
+
+        snprintf(buffer, sizeof(buffer), " Q%04d", uniform(random, 990, 1040));
+        report += buffer;
+
+        report += " ";
+        report += pick(g_trends, random);
+        report += "=";
+
+        reports.push_back(std::move(report));
+    }
+
+    return reports;
+}
+
+std::vector<std::string> generate_tafs(size_t count, uint32_t seed)
+{
+    std::mt19937 random(seed);
+    std::vector<std::string> tafs;
+    tafs.reserve(count);
+
+    char buffer[64];
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto station = i % 700;
+        auto day = static_cast<int>(1 + i / 700 % 27);
+        auto hour = static_cast<int>(i / 700 / 27 % 4) * 6;
+
+        std::string taf = uniform(random, 0, 9) == 0 ? "TAF AMD K" : "TAF K";
+        taf += static_cast<char>('A' + station / 676 % 26);
+        taf += static_cast<char>('A' + station / 26 % 26);
+        taf += static_cast<char>('A' + station % 26);
+
+        snprintf(buffer, sizeof(buffer), " %02d%02d40Z %02d%02d/%02d%02d ", day, (hour + 23) % 24, day, hour, day + 1, hour);
+        taf += buffer;
+        taf += forecast_conditions(random, true);
+
+        // Change groups spread over the 24 hour validity period
+        for (int offset = uniform(random, 2, 5); offset < 22; offset += uniform(random, 3, 6))
+        {
+            auto begin = hour + offset;
+            auto beginDay = day + begin / 24;
+            switch (uniform(random, 0, 3))
+            {
+            case 0:
+                snprintf(buffer, sizeof(buffer), "\n  FM%02d%02d00 ", beginDay, begin % 24);
+                taf += buffer + forecast_conditions(random, true);
+                break;
+            case 1:
+                snprintf(buffer, sizeof(buffer), "\n  TEMPO %02d%02d/%02d%02d ", beginDay, begin % 24, day + (begin + 3) / 24, (begin + 3) % 24);
+                taf += buffer + forecast_conditions(random, false);
+                break;
+            case 2:
+                snprintf(buffer, sizeof(buffer), "\n  PROB30 %02d%02d/%02d%02d ", beginDay, begin % 24, day + (begin + 4) / 24, (begin + 4) % 24);
+                taf += buffer + forecast_conditions(random, false);
+                break;
+            default:
+                snprintf(buffer, sizeof(buffer), "\n  BECMG %02d%02d/%02d%02d ", beginDay, begin % 24, day + (begin + 2) / 24, (begin + 2) % 24);
+                taf += buffer + wind_group(random);
+                break;
+            }
+        }
+
+        tafs.push_back(std::move(taf));
+    }
+
+    return tafs;
+}
+
+std::string generate_winds_aloft(size_t stations, uint32_t seed)
+{
+    std::mt19937 random(seed);
+
+    const char* header = "FT  3000    6000    9000   12000   18000   24000  30000  34000  39000";
+    const int altitudes[] = { 3000, 6000, 9000, 12000, 18000, 24000, 30000, 34000, 39000 };
+    const size_t labelEnds[] = { 8, 16, 24, 32, 40, 48, 55, 62, 69 };
+
+    std::string result =
+        "DATA BASED ON 011200Z\n"
+        "VALID 011800Z   FOR USE 1400-2100Z. TEMPS NEG ABV 24000\n"
+        "\n";
+    result += header;
+    result += '\n';
+
+    for (size_t i = 0; i < stations; ++i)
+    {
+        std::string line(strlen(header), ' ');
+        line[0] = static_cast<char>('A' + i / (26 * 26) % 26);
+        line[1] = static_cast<char>('A' + i / 26 % 26);
+        line[2] = static_cast<char>('A' + i % 26);
+
+        // Higher stations have no forecast at the lowest levels
+        auto const firstLevel = uniform(random, 0, 4) == 0 ? 2 : 0;
+        for (int level = firstLevel; level < 9; ++level)
+        {
+            auto const altitude = altitudes[level];
+            auto direction = uniform(random, 1, 36);
+            auto speed = uniform(random, 0, 20) + altitude / 400;
+            if (speed >= 100)
+            {
+                direction += 50;
+                speed = (std::min)(speed - 100, 99);
+            }
+
+            char cell[16];
+            if (speed < 5 && altitude < 24000)
+            {
+                snprintf(cell, sizeof(cell), "9900%+03d", uniform(random, -5, 20));
+            }
+            else if (level == 0)
+            {
+                snprintf(cell, sizeof(cell), "%02d%02d", direction, speed);
+            }
+            else if (altitude <= 24000)
+            {
+                snprintf(cell, sizeof(cell), "%02d%02d%+03d", direction, speed, 15 - altitude / 600);
+            }
+            else
+            {
+                snprintf(cell, sizeof(cell), "%02d%02d%02d", direction, speed, altitude / 800 + uniform(random, 0, 10));
+            }
+
+            // Cells are right-aligned with the altitude labels
+            line.replace(labelEnds[level] - strlen(cell), strlen(cell), cell);
+        }
+
+        result += line;
+        result += '\n';
+    }
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+
+std::string generate_pirep_bulletin(size_t count, uint32_t seed)
+{
+    std::mt19937 random(seed);
+
+    const char* stations[] = { "OKC", "DEN", "ABQ", "ORD", "DFW", "ATL", "SEA", "BOS" };
+    const char* aircraft[] = { "C172", "PA28", "B737", "A320", "BE20", "CRJ2", "E145", "PC12" };
+    const char* turbulence[] = { "NEG", "LGT", "LGT-MOD CHOP", "MOD", "MOD CAT", "SEV" };
+    const char* icing[] = { "NEG", "TRACE RIME", "LGT RIME", "LGT-MOD MX", "MOD CLR" };
+
+    std::string result;
+    char buffer[64];
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto station = pick(stations, random);
+        auto altitude = uniform(random, 20, 390);
+
+        result += station;
+        result += uniform(random, 0, 9) == 0 ? " UUA" : " UA";
+        snprintf(buffer, sizeof(buffer), " /OV %s%03d%03d/TM %02d%02d/FL%03d/TP %s",
+            station, uniform(random, 1, 360), uniform(random, 5, 60), uniform(random, 0, 23), uniform(random, 0, 59), altitude, pick(aircraft, random));
+        result += buffer;
+
+        if (uniform(random, 0, 1) == 0)
+        {
+            auto base = uniform(random, 5, 120);
+            snprintf(buffer, sizeof(buffer), "/SK %s%03d-TOP%03d", pick(g_cover, random), base, base + uniform(random, 5, 40));
+            result += buffer;
+        }
+        if (uniform(random, 0, 3) == 0)
+        {
+            result += "/WX FV";
+            result += pick(g_visibility, random);
+            result += ' ';
+            result += pick(g_weather, random);
+        }
+        snprintf(buffer, sizeof(buffer), "/TA %s/WV %s", temperature(15 - altitude / 20).c_str(), wind_group(random).c_str());
+        result += buffer;
+        if (uniform(random, 0, 1) == 0)
+        {
+            result += "/TB ";
+            result += pick(turbulence, random);
+        }
+        if (altitude > 60 && uniform(random, 0, 2) == 0)
+        {
+            result += "/IC ";
+            result += pick(icing, random);
+        }
+        if (uniform(random, 0, 3) == 0)
+        {
+            result += "/RM SMOOTH ABV ";
+            result += std::to_string(altitude + 20);
+        }
+        result += '\n';
+    }
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+
+std::string generate_sigmet_bulletin(size_t count, uint32_t seed)
+{
+    std::mt19937 random(seed);
+
+    const char* regions[] = { "KZAB", "KZDV", "KZKC", "KZMP", "KZOB", "KZNY", "KZLA", "KZSE" };
+    const char* hazards[] = { "SEV TURB", "SEV ICE", "EMBD TS", "SEV MTW", "VA CLD", "HVY DS" };
+    const char* directions[] = { "N", "NE", "E", "SE", "S", "SW", "W", "NW" };
+
+    std::string result;
+    char buffer[64];
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto region = pick(regions, random);
+        auto day = uniform(random, 1, 28);
+        auto hour = uniform(random, 0, 19);
+        snprintf(buffer, sizeof(buffer), "%s SIGMET %d VALID %02d%02d00/%02d%02d00 %s-\n",
+            region, static_cast<int>(i % 99) + 1, day, hour, day, hour + 4, region);
+        result += buffer;
+        result += region;
+        result += " FIR ";
+        result += pick(hazards, random);
+        result += " FCST WI";
+
+        // A convex polygon around a centre, in minutes of arc
+        auto latitude = uniform(random, 25 * 60, 55 * 60);
+        auto longitude = uniform(random, 65 * 60, 125 * 60);
+        auto radius = uniform(random, 30, 180);
+        auto vertices = uniform(random, 4, 7);
+        for (int v = 0; v <= vertices; ++v)
+        {
+            auto angle = 2.0 * 3.14159265358979323846 * (v % vertices) / vertices;
+            auto pointLatitude = latitude + static_cast<int>(radius * std::sin(angle));
+            auto pointLongitude = longitude + static_cast<int>(radius * std::cos(angle));
+            snprintf(buffer, sizeof(buffer), "%s N%02d%02d W%03d%02d", v == 0 ? "" : " -",
+                pointLatitude / 60, pointLatitude % 60, pointLongitude / 60, pointLongitude % 60);
+            result += buffer;
+        }
+
+        auto base = uniform(random, 0, 30) * 10;
+        snprintf(buffer, sizeof(buffer), " FL%03d/%03d MOV %s %dKT NC=\n", base, base + uniform(random, 5, 15) * 10,
+            pick(directions, random), uniform(random, 5, 40));
+        result += buffer;
+    }
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+
+std::vector<std::string> generate_feed(std::vector<std::string> const& reports, size_t deliveries,
+    double duplicateRatio, uint32_t seed)
+{
+    // Feeds typically redeliver the most recent hour or so of reports
+    const size_t recentWindow = 4096;
+
+    std::mt19937 random(seed);
+    std::bernoulli_distribution duplicate(duplicateRatio);
+
+    std::vector<std::string> feed;
+    feed.reserve(deliveries);
+
+    size_t next = 0;
+    for (size_t i = 0; i < deliveries; ++i)
+    {
+        if (next > 0 && duplicate(random))
+        {
+            auto window = (std::min)(next, recentWindow);
+            auto back = std::uniform_int_distribution<size_t>(1, window)(random);
+            feed.push_back(reports[(next - back) % reports.size()]);
+        }
+        else
+        {
+            feed.push_back(reports[next++ % reports.size()]);
+        }
+    }
+
+    return feed;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
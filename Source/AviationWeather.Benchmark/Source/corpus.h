@@ -0,0 +1,60 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace aw
+{
+namespace benchmark
+{
+
+//-----------------------------------------------------------------------------
+
+// Generates distinct, well-formed METARs with a realistic mix of groups.
+// The same seed always produces the same reports.
+std::vector<std::string> generate_metars(size_t count, uint32_t seed = 1);
+
+// Generates distinct ICAO format METARs with metre visibility, RVR, Q
+// altimeter settings and trend forecasts
+std::vector<std::string> generate_international_metars(size_t count, uint32_t seed = 1);
+
+// Generates distinct TAFs with a mix of FM, BECMG, TEMPO and PROB groups
+std::vector<std::string> generate_tafs(size_t count, uint32_t seed = 1);
+
+// Generates a winds and temperatures aloft (FB) table in the fixed column
+// layout of the national bulletins, with the given number of stations
+std::string generate_winds_aloft(size_t stations, uint32_t seed = 1);
+
+// Generates a bulletin of PIREPs, one per line, with a mix of fields
+std::string generate_pirep_bulletin(size_t count, uint32_t seed = 1);
+
+// Generates a bulletin of ICAO format SIGMETs, each with a polygon of
+// latitude and longitude points scattered over North America
+std::string generate_sigmet_bulletin(size_t count, uint32_t seed = 1);
+
+// Simulates a feed that redelivers reports: each delivery is, with the given
+// probability, a repeat of one of the recently delivered reports, otherwise
+// the next unseen report from the corpus (wrapping if it runs out).
+std::vector<std::string> generate_feed(std::vector<std::string> const& reports, size_t deliveries,
+    double duplicateRatio, uint32_t seed = 1);
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
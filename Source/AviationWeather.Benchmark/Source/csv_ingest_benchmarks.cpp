@@ -0,0 +1,96 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.BenchmarkPch.h"
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <AviationWeather/csv_ingest.h>
+
+#include "benchmark.h"
+#include "corpus.h"
+
+namespace aw
+{
+namespace benchmark
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const size_t g_reportCount = 100000;
+
+// A dump in the dataserver's layout, with the raw text quoted as it is
+// whenever a report holds a comma
+std::string make_dump(std::vector<std::string> const& reports)
+{
+    std::string text = "No errors\nNo warnings\n";
+    text += "raw_text,station_id,observation_time,latitude,longitude,temp_c,elevation_m\n";
+
+    char row[96];
+    for (size_t i = 0; i < reports.size(); ++i)
+    {
+        text += '"';
+        text += reports[i];
+        snprintf(row, sizeof(row), "\",%.4s,2015-12-12T17:56:00Z,%.2f,%.2f,18.3,%u\n",
+            reports[i].c_str(), 20.0 + (i % 4000) * 0.01, -70.0 - (i % 6000) * 0.01, static_cast<unsigned>(i % 3000));
+        text += row;
+    }
+    return text;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+BENCHMARK(CsvIngest_Read)
+{
+    auto text = make_dump(generate_metars(g_reportCount));
+    std::vector<csv_observation> results;
+    results.reserve(g_reportCount);
+
+    auto single = measure([&]()
+    {
+        results.clear();
+        read_csv(text.data(), text.size(), results, 1);
+    });
+    report("1 thread", results.size(), single);
+
+    auto threads = std::max(1u, std::thread::hardware_concurrency());
+    auto parallel = measure([&]()
+    {
+        results.clear();
+        read_csv(text.data(), text.size(), results);
+    });
+    report(std::to_string(threads) + " threads", results.size(), parallel);
+    consume(results.size());
+
+    char summary[96];
+    snprintf(summary, sizeof(summary), "%.1f MB, %.0f MB/s on 1 thread, %.1fx faster on %u",
+        text.size() / 1e6, text.size() / (single.count() / 1000.0),
+        static_cast<double>(single.count()) / parallel.count(), threads);
+    note(summary);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
@@ -0,0 +1,123 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.BenchmarkPch.h"
+
+#include <random>
+
+#include <AviationWeather/derived_quantities.h>
+
+#include "benchmark.h"
+
+namespace aw
+{
+namespace benchmark
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+// Every station, many times over
+const size_t g_columnSize = 100000;
+const size_t g_iterations = 20;
+
+std::vector<float> random_column(std::mt19937& random, float lower, float upper)
+{
+    std::uniform_real_distribution<float> distribution(lower, upper);
+    std::vector<float> column(g_columnSize);
+    for (auto& value : column)
+    {
+        value = distribution(random);
+    }
+    return column;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+BENCHMARK(Derived_DensityAltitude)
+{
+    std::mt19937 random(1);
+    auto altimeter = random_column(random, 960.0f, 1050.0f);
+    auto elevation = random_column(random, 0.0f, 10000.0f);
+    auto temperature = random_column(random, -30.0f, 45.0f);
+    std::vector<float> results(g_columnSize);
+
+    auto elapsed = measure([&]()
+    {
+        for (size_t n = 0; n < g_iterations; ++n)
+        {
+            for (size_t i = 0; i < g_columnSize; ++i)
+            {
+                results[i] = static_cast<float>(density_altitude(altimeter[i], elevation[i], temperature[i]));
+            }
+            consume(results[n]);
+        }
+    });
+    report("scalar", g_iterations * g_columnSize, elapsed);
+
+    elapsed = measure([&]()
+    {
+        for (size_t n = 0; n < g_iterations; ++n)
+        {
+            density_altitude(altimeter, elevation, temperature, results);
+            consume(results[n]);
+        }
+    });
+    report("batch", g_iterations * g_columnSize, elapsed);
+}
+
+BENCHMARK(Derived_Humidity)
+{
+    std::mt19937 random(2);
+    auto temperature = random_column(random, -30.0f, 45.0f);
+    auto dewpoint = random_column(random, -35.0f, 25.0f);
+    std::vector<float> humidity(g_columnSize);
+    std::vector<float> results(g_columnSize);
+
+    auto elapsed = measure([&]()
+    {
+        for (size_t n = 0; n < g_iterations; ++n)
+        {
+            for (size_t i = 0; i < g_columnSize; ++i)
+            {
+                humidity[i] = static_cast<float>(relative_humidity(temperature[i], dewpoint[i]));
+                results[i] = static_cast<float>(heat_index(temperature[i], humidity[i]));
+            }
+            consume(results[n]);
+        }
+    });
+    report("scalar humidity and heat index", g_iterations * g_columnSize, elapsed);
+
+    elapsed = measure([&]()
+    {
+        for (size_t n = 0; n < g_iterations; ++n)
+        {
+            relative_humidity(temperature, dewpoint, humidity);
+            heat_index(temperature, humidity, results);
+            consume(results[n]);
+        }
+    });
+    report("batch humidity and heat index", g_iterations * g_columnSize, elapsed);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
@@ -0,0 +1,96 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.BenchmarkPch.h"
+
+#include <AviationWeather/json_writer.h>
+#include <AviationWeather/metar.h>
+
+#include "benchmark.h"
+#include "corpus.h"
+
+namespace aw
+{
+namespace benchmark
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const size_t g_reportCount = 20000;
+
+void run_write(std::vector<std::string> const& reports, std::string const& label)
+{
+    std::vector<metar> parsed;
+    parsed.reserve(reports.size());
+
+    auto parseTime = measure([&]()
+    {
+        for (auto const& report : reports)
+        {
+            parsed.emplace_back(report);
+        }
+    });
+    report(label + ", parse text", reports.size(), parseTime);
+
+    // The second pass reuses the buffer and so allocates nothing
+    std::string buffer;
+    write_json(parsed, buffer);
+
+    auto elapsed = measure([&]()
+    {
+        buffer.clear();
+        write_json(parsed, buffer);
+    });
+    report(label + ", write NDJSON", parsed.size(), elapsed);
+    consume(buffer.size());
+
+    std::vector<char> fixed(4096);
+    size_t total = 0;
+    auto fixedTime = measure([&]()
+    {
+        for (auto const& report : parsed)
+        {
+            total += write_json(report, fixed.data(), fixed.size());
+        }
+    });
+    report(label + ", write fixed buffer", parsed.size(), fixedTime);
+    consume(total);
+
+    char text[96];
+    snprintf(text, sizeof(text), "%.1f bytes per report, %.0f MB/s, writing %.1fx faster than parsing",
+        static_cast<double>(buffer.size()) / parsed.size(),
+        buffer.size() / (elapsed.count() / 1000.0),
+        static_cast<double>(parseTime.count()) / elapsed.count());
+    note(text);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+BENCHMARK(JsonWriter_Write)
+{
+    run_write(generate_metars(g_reportCount), "US");
+    run_write(generate_international_metars(g_reportCount), "international");
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
@@ -0,0 +1,72 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.BenchmarkPch.h"
+
+#include <AviationWeather/metar.h>
+
+#include "benchmark.h"
+#include "corpus.h"
+
+namespace aw
+{
+namespace benchmark
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const size_t g_reportCount = 20000;
+
+void run_parse(std::vector<std::string> const& reports, std::string const& label)
+{
+    auto elapsed = measure([&]()
+    {
+        for (auto const& report : reports)
+        {
+            metar m(report);
+            consume(m.sky_condition_group.size());
+        }
+    });
+    report(label + ", metar", reports.size(), elapsed);
+
+    elapsed = measure([&]()
+    {
+        for (auto const& report : reports)
+        {
+            metar_view view(report);
+            consume(view.sky_condition_group.size());
+        }
+    });
+    report(label + ", metar_view", reports.size(), elapsed);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+BENCHMARK(Metar_Parse)
+{
+    run_parse(generate_metars(g_reportCount), "US");
+    run_parse(generate_international_metars(g_reportCount), "international");
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
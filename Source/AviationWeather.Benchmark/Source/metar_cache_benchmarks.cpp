@@ -0,0 +1,134 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.BenchmarkPch.h"
+
+#include <thread>
+
+#include <AviationWeather/metar.h>
+#include <AviationWeather/metar_cache.h>
+
+#include "benchmark.h"
+#include "corpus.h"
+
+namespace aw
+{
+namespace benchmark
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const size_t g_deliveries = 5000;
+
+std::string statistics_text(metar_cache const& cache)
+{
+    auto statistics = cache.statistics();
+    char buffer[160];
+    snprintf(buffer, sizeof(buffer), "hits %llu, misses %llu, evictions %llu, entries %llu, %.1f KB",
+        static_cast<unsigned long long>(statistics.hits),
+        static_cast<unsigned long long>(statistics.misses),
+        static_cast<unsigned long long>(statistics.evictions),
+        static_cast<unsigned long long>(statistics.entries),
+        statistics.bytes / 1024.0);
+    return buffer;
+}
+
+void run_feed(std::vector<std::string> const& feed, size_t memoryLimit, std::string const& label)
+{
+    metar_cache cache(memoryLimit);
+    auto elapsed = measure([&]()
+    {
+        for (auto const& report : feed)
+        {
+            consume(cache.parse(report)->raw_data.size());
+        }
+    });
+    report(label, feed.size(), elapsed);
+    note(statistics_text(cache));
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+BENCHMARK(MetarCache_DuplicateFeed)
+{
+    auto reports = generate_metars(g_deliveries);
+
+    for (auto duplicateRatio : { 0.0, 0.5, 0.8, 0.95 })
+    {
+        auto feed = generate_feed(reports, g_deliveries, duplicateRatio);
+        auto percent = std::to_string(static_cast<int>(duplicateRatio * 100)) + "% duplicates";
+
+        auto elapsed = measure([&]()
+        {
+            for (auto const& report : feed)
+            {
+                metar m(report);
+                consume(m.raw_data.size());
+            }
+        });
+        report("uncached, " + percent, feed.size(), elapsed);
+
+        run_feed(feed, 64 * 1024 * 1024, "cached 64 MB, " + percent);
+        run_feed(feed, 1024 * 1024, "cached 1 MB, " + percent);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+BENCHMARK(MetarCache_Concurrent)
+{
+    auto reports = generate_metars(g_deliveries);
+    auto feed = generate_feed(reports, g_deliveries, 0.8);
+
+    auto threadCount = (std::max)(2u, std::thread::hardware_concurrency());
+    for (size_t shards : { size_t(1), metar_cache::default_shard_count })
+    {
+        metar_cache cache(64 * 1024 * 1024, shards);
+        auto elapsed = measure([&]()
+        {
+            std::vector<std::thread> threads;
+            for (unsigned t = 0; t < threadCount; ++t)
+            {
+                threads.emplace_back([&cache, &feed, t, threadCount]()
+                {
+                    size_t total = 0;
+                    for (size_t i = t; i < feed.size(); i += threadCount)
+                    {
+                        total += cache.parse(feed[i])->raw_data.size();
+                    }
+                    consume(total);
+                });
+            }
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+        });
+
+        report(std::to_string(threadCount) + " threads, " + std::to_string(shards) + " shard(s)", feed.size(), elapsed);
+        note(statistics_text(cache));
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
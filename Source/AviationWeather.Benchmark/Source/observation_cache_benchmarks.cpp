@@ -0,0 +1,167 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.BenchmarkPch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <AviationWeather/observation_cache.h>
+
+#include "benchmark.h"
+
+namespace aw
+{
+namespace benchmark
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const size_t g_stationCount = 3000;
+const size_t g_lookupsPerReader = 200000;
+const uint32_t g_updateBursts = 60;
+
+std::string station_name(size_t station)
+{
+    char identifier[8];
+    snprintf(identifier, sizeof(identifier), "K%03u", static_cast<unsigned>(station % 1000));
+    identifier[0] = static_cast<char>('K' + station / 1000);
+    return identifier;
+}
+
+std::vector<metar::const_pointer> generate_burst(uint32_t minute)
+{
+    std::vector<metar::const_pointer> burst;
+    for (size_t station = 0; station < g_stationCount; ++station)
+    {
+        char text[80];
+        snprintf(text, sizeof(text), "%s 12%02u%02uZ 27010KT 10SM CLR 15/05 A2992",
+            station_name(station).c_str(), (minute / 60) % 24, minute % 60);
+        burst.push_back(std::make_shared<const metar>(text));
+    }
+    return burst;
+}
+
+// The map every service writes by hand: one lock shared by readers and writers
+class locked_map
+{
+public:
+    void update(std::vector<metar::const_pointer> const& reports)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto const& report : reports)
+        {
+            m_reports[report->identifier] = report;
+        }
+    }
+
+    metar::const_pointer find(std::string const& identifier) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_reports.find(identifier);
+        return it == m_reports.end() ? nullptr : it->second;
+    }
+
+private:
+    mutable std::mutex                                     m_mutex;
+    std::unordered_map<std::string, metar::const_pointer> m_reports;
+};
+
+// Readers look up every station in turn while a writer replaces them all
+// in repeated bursts
+template <class TCache>
+void run_readers(TCache& cache, std::vector<std::vector<metar::const_pointer>> const& bursts, std::string const& label)
+{
+    std::vector<std::string> stations;
+    for (size_t station = 0; station < g_stationCount; ++station)
+    {
+        stations.push_back(station_name(station));
+    }
+
+    auto readerCount = std::max(2U, std::thread::hardware_concurrency()) - 1;
+    for (auto writing : { false, true })
+    {
+        std::atomic<bool> done(false);
+        std::thread writer([&]()
+        {
+            while (writing && !done.load())
+            {
+                for (auto const& burst : bursts)
+                {
+                    cache.update(burst);
+                }
+            }
+        });
+
+        auto elapsed = measure([&]()
+        {
+            std::vector<std::thread> readers;
+            for (size_t t = 0; t < readerCount; ++t)
+            {
+                readers.emplace_back([&cache, &stations, t]()
+                {
+                    size_t found = 0;
+                    for (size_t i = 0; i < g_lookupsPerReader; ++i)
+                    {
+                        found += cache.find(stations[(i + t * 97) % stations.size()]) ? 1 : 0;
+                    }
+                    consume(found);
+                });
+            }
+            for (auto& reader : readers)
+            {
+                reader.join();
+            }
+        });
+
+        done.store(true);
+        writer.join();
+
+        report(label + (writing ? ", during updates" : ", idle"), readerCount * g_lookupsPerReader, elapsed);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+BENCHMARK(ObservationCache_Readers)
+{
+    std::vector<std::vector<metar::const_pointer>> bursts;
+    for (uint32_t minute = 0; minute < g_updateBursts; ++minute)
+    {
+        bursts.push_back(generate_burst(minute));
+    }
+
+    locked_map map;
+    map.update(bursts.front());
+    run_readers(map, bursts, "mutex and unordered_map");
+
+    observation_cache cache;
+    cache.update(bursts.front());
+    run_readers(cache, bursts, "observation_cache");
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
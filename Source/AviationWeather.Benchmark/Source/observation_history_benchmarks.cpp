@@ -0,0 +1,211 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.BenchmarkPch.h"
+
+#include <algorithm>
+#include <climits>
+#include <random>
+#include <unordered_map>
+
+#include <AviationWeather/converters.h>
+#include <AviationWeather/observation_history.h>
+
+#include "benchmark.h"
+
+namespace aw
+{
+namespace benchmark
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const size_t g_stationCount = 3000;
+const uint32_t g_hours = 24;
+const size_t g_passes = 20;
+
+std::string station_name(size_t station)
+{
+    char identifier[8];
+    snprintf(identifier, sizeof(identifier), "%c%03u", static_cast<char>('K' + station / 1000), static_cast<unsigned>(station % 1000));
+    return identifier;
+}
+
+// A day of hourly reports per station, in time order
+std::vector<metar> generate_day()
+{
+    std::mt19937 random(1);
+    std::uniform_int_distribution<int> temperature(-5, 30);
+    std::uniform_int_distribution<int> altimeter(2950, 3050);
+
+    std::vector<metar> reports;
+    for (uint32_t hour = 0; hour < g_hours; ++hour)
+    {
+        for (size_t station = 0; station < g_stationCount; ++station)
+        {
+            char text[96];
+            auto t = temperature(random);
+            snprintf(text, sizeof(text), "%s 12%02u56Z 27010KT 10SM BKN030 %s%02d/M05 A%04d",
+                station_name(station).c_str(), hour, t < 0 ? "M" : "", t < 0 ? -t : t, altimeter(random));
+            reports.emplace_back(text);
+        }
+    }
+    return reports;
+}
+
+// The three-hour pressure tendency from a history of decoded reports
+double vector_tendency(std::vector<metar> const& history)
+{
+    auto const& latest = history.back();
+    auto now = convert(latest.altimeter_group->pressure, latest.altimeter_group->unit, pressure_unit::hPa);
+    for (auto it = history.rbegin(); it != history.rend(); ++it)
+    {
+        if (latest.observation_time.hour_of_day - it->observation_time.hour_of_day == 3)
+        {
+            return now - convert(it->altimeter_group->pressure, it->altimeter_group->unit, pressure_unit::hPa);
+        }
+    }
+    return 0.0;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+BENCHMARK(ObservationHistory_Trends)
+{
+    auto reports = generate_day();
+
+    std::unordered_map<std::string, std::vector<metar>> vectors;
+    auto elapsed = measure([&]()
+    {
+        for (auto const& report : reports)
+        {
+            vectors[report.identifier].push_back(report);
+        }
+    });
+    report("append, vector<metar>", reports.size(), elapsed);
+
+    observation_history history(g_hours, 32);
+    elapsed = measure([&]()
+    {
+        for (auto const& report : reports)
+        {
+            history.append(report);
+        }
+    });
+    report("append, observation_history", reports.size(), elapsed);
+
+    std::vector<std::string> stations;
+    for (size_t station = 0; station < g_stationCount; ++station)
+    {
+        stations.push_back(station_name(station));
+    }
+
+    elapsed = measure([&]()
+    {
+        double total = 0.0;
+        for (size_t pass = 0; pass < g_passes; ++pass)
+        {
+            for (auto const& station : stations)
+            {
+                auto const& v = vectors[station];
+                for (auto it = v.rbegin(); it != v.rend() && it->observation_time.hour_of_day + 3 >= v.back().observation_time.hour_of_day; ++it)
+                {
+                    total += *it->temperature;
+                }
+                total += vector_tendency(v);
+            }
+        }
+        consume(static_cast<size_t>(total));
+    });
+    report("last 3 hours and tendency, vector<metar>", g_passes * g_stationCount, elapsed);
+
+    std::vector<observation_record> records;
+    elapsed = measure([&]()
+    {
+        double total = 0.0;
+        for (size_t pass = 0; pass < g_passes; ++pass)
+        {
+            for (auto const& station : stations)
+            {
+                history.last_hours(station, 3, records);
+                for (auto const& record : records)
+                {
+                    total += record.temperature;
+                }
+                total += *history.pressure_tendency(station);
+            }
+        }
+        consume(static_cast<size_t>(total));
+    });
+    report("last 3 hours and tendency, observation_history", g_passes * g_stationCount, elapsed);
+
+    elapsed = measure([&]()
+    {
+        int range = 0;
+        for (size_t pass = 0; pass < g_passes; ++pass)
+        {
+            for (auto const& station : stations)
+            {
+                int lowest = INT8_MAX;
+                int highest = INT8_MIN;
+                for (auto const& report : vectors[station])
+                {
+                    lowest = std::min<int>(lowest, *report.temperature);
+                    highest = std::max<int>(highest, *report.temperature);
+                }
+                range += highest - lowest;
+            }
+        }
+        consume(static_cast<size_t>(range));
+    });
+    report("temperature range over 24 hours, vector<metar>", g_passes * g_stationCount, elapsed);
+
+    elapsed = measure([&]()
+    {
+        int range = 0;
+        for (size_t pass = 0; pass < g_passes; ++pass)
+        {
+            for (auto const& station : stations)
+            {
+                history.last_hours(station, g_hours, records);
+
+                int lowest = INT8_MAX;
+                int highest = INT8_MIN;
+                for (auto const& record : records)
+                {
+                    lowest = std::min<int>(lowest, record.temperature);
+                    highest = std::max<int>(highest, record.temperature);
+                }
+                range += highest - lowest;
+            }
+        }
+        consume(static_cast<size_t>(range));
+    });
+    report("temperature range over 24 hours, observation_history", g_passes * g_stationCount, elapsed);
+
+    note("memory per report: " + std::to_string(sizeof(metar)) + " bytes plus heap for a metar, " +
+        std::to_string(sizeof(observation_record)) + " bytes for a record");
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
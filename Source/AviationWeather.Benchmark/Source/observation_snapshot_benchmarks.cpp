@@ -0,0 +1,167 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.BenchmarkPch.h"
+
+#include <cstdio>
+#include <random>
+
+#include <AviationWeather/observation_history.h>
+#include <AviationWeather/observation_snapshot.h>
+
+#include "benchmark.h"
+
+namespace aw
+{
+namespace benchmark
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const size_t g_stationCount = 3000;
+const uint32_t g_hours = 72;
+const size_t g_passes = 20;
+
+std::string station_name(size_t station)
+{
+    char identifier[8];
+    snprintf(identifier, sizeof(identifier), "%c%03u", static_cast<char>('K' + station / 1000), static_cast<unsigned>(station % 1000));
+    return identifier;
+}
+
+// Three days of hourly reports per station, in time order
+std::vector<std::string> generate_reports()
+{
+    std::mt19937 random(1);
+    std::uniform_int_distribution<int> temperature(-5, 30);
+    std::uniform_int_distribution<int> altimeter(2950, 3050);
+
+    std::vector<std::string> reports;
+    for (uint32_t hour = 0; hour < g_hours; ++hour)
+    {
+        for (size_t station = 0; station < g_stationCount; ++station)
+        {
+            char text[96];
+            auto t = temperature(random);
+            snprintf(text, sizeof(text), "%s %02u%02u56Z 27010KT 10SM BKN030 %s%02d/M05 A%04d",
+                station_name(station).c_str(), 10 + hour / 24, hour % 24, t < 0 ? "M" : "", t < 0 ? -t : t, altimeter(random));
+            reports.emplace_back(text);
+        }
+    }
+    return reports;
+}
+
+template <class TObservations>
+double query_all(TObservations const& observations, std::vector<std::string> const& stations)
+{
+    std::vector<observation_record> records;
+    double total = 0.0;
+    for (auto const& station : stations)
+    {
+        observations.last_hours(station, 3, records);
+        for (auto const& record : records)
+        {
+            total += record.temperature;
+        }
+        total += *observations.pressure_tendency(station);
+    }
+    return total;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+BENCHMARK(ObservationSnapshot_WarmStart)
+{
+    const std::string path = "observation_snapshot_benchmark.bin";
+
+    auto reports = generate_reports();
+    std::vector<std::string> stations;
+    for (size_t station = 0; station < g_stationCount; ++station)
+    {
+        stations.push_back(station_name(station));
+    }
+
+    // What a restart does today: reparse every report
+    observation_history history(g_hours, 80);
+    auto elapsed = measure([&]()
+    {
+        for (auto const& report : reports)
+        {
+            history.append(metar_view(report));
+        }
+    });
+    report("start by reparsing, per report", reports.size(), elapsed);
+
+    elapsed = measure([&]()
+    {
+        observation_snapshot::write(history, path);
+    });
+    report("write snapshot, per report", reports.size(), elapsed);
+
+    // Mapping the file and answering a query for every station
+    double total = 0.0;
+    elapsed = measure([&]()
+    {
+        observation_snapshot snapshot(path);
+        total = query_all(snapshot, stations);
+    });
+    report("start from snapshot, per station", stations.size(), elapsed);
+    consume(static_cast<size_t>(total));
+
+    elapsed = measure([&]()
+    {
+        observation_snapshot mapped(path);
+        consume(mapped.station_count());
+    });
+    report("map snapshot", 1, elapsed);
+
+    elapsed = measure([&]()
+    {
+        for (size_t pass = 0; pass < g_passes; ++pass)
+        {
+            total += query_all(history, stations);
+        }
+    });
+    report("last 3 hours and tendency, observation_history", g_passes * stations.size(), elapsed);
+
+    {
+        observation_snapshot snapshot(path);
+        elapsed = measure([&]()
+        {
+            for (size_t pass = 0; pass < g_passes; ++pass)
+            {
+                total += query_all(snapshot, stations);
+            }
+        });
+        report("last 3 hours and tendency, observation_snapshot", g_passes * stations.size(), elapsed);
+        consume(static_cast<size_t>(total));
+
+        note("snapshot of " + std::to_string(snapshot.record_count()) + " records, " +
+            std::to_string(snapshot.record_count() * sizeof(observation_record) / 1024) + " KB of records");
+    }
+
+    std::remove(path.c_str());
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
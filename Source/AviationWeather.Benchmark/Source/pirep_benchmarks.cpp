@@ -0,0 +1,81 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.BenchmarkPch.h"
+
+#include <AviationWeather/pirep.h>
+
+#include "benchmark.h"
+#include "corpus.h"
+
+namespace aw
+{
+namespace benchmark
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const size_t g_pirepCount = 20000;
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+BENCHMARK(PIREP_Decode)
+{
+    auto bulletin = generate_pirep_bulletin(g_pirepCount);
+
+    // The per-report path has to split the bulletin itself
+    std::vector<std::string> lines;
+    size_t start = 0;
+    for (auto end = bulletin.find('\n'); end != std::string::npos; start = end + 1, end = bulletin.find('\n', start))
+    {
+        lines.push_back(bulletin.substr(start, end - start));
+    }
+
+    auto elapsed = measure([&]()
+    {
+        std::vector<pirep> reports;
+        for (auto const& line : lines)
+        {
+            reports.emplace_back(line);
+        }
+        consume(reports.size());
+    });
+    report("pirep per report", lines.size(), elapsed);
+
+    std::vector<pirep_record> records;
+    elapsed = measure([&]()
+    {
+        consume(decode_pireps(bulletin, records));
+    });
+    report("decode_pireps, first bulletin", records.size(), elapsed);
+
+    elapsed = measure([&]()
+    {
+        consume(decode_pireps(bulletin, records));
+    });
+    report("decode_pireps, reused records", records.size(), elapsed);
+    note(std::to_string(bulletin.size() / 1024.0 / 1024.0 * 1e9 / elapsed.count()) + " MB/s");
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
@@ -0,0 +1,112 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.BenchmarkPch.h"
+
+#include <random>
+
+#include <AviationWeather/metar.h>
+#include <AviationWeather/runway_wind.h>
+
+#include "benchmark.h"
+#include "corpus.h"
+
+namespace aw
+{
+namespace benchmark
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+// Roughly every airport with a METAR in the US feed
+const size_t g_stationCount = 2000;
+const size_t g_updates = 50;
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+BENCHMARK(RunwayWind_AllRunways)
+{
+    // The corpus cycles through g_stationCount stations, so the first reports
+    // give one wind per station
+    auto reports = generate_metars(g_stationCount);
+
+    std::mt19937 random(1);
+    runway_table runways;
+    std::vector<util::optional<wind>> winds(g_stationCount);
+    for (auto const& report : reports)
+    {
+        metar m(report);
+        for (int i = 0, pairs = std::uniform_int_distribution<int>(1, 4)(random); i < pairs; ++i)
+        {
+            auto number = static_cast<uint8_t>(std::uniform_int_distribution<int>(1, 18)(random));
+            runways.add(m.identifier, number);
+            runways.add(m.identifier, number + 18);
+        }
+        winds[*runways.find(m.identifier)] = m.wind_group;
+    }
+
+    // Steady, gust and extreme components with the scalar members
+    std::vector<float> scalar(runways.runway_count() * 4);
+    auto elapsed = measure([&]()
+    {
+        for (size_t update = 0; update < g_updates; ++update)
+        {
+            for (size_t r = 0; r < runways.runway_count(); ++r)
+            {
+                auto const& windGroup = winds[runways.runway_station(r)];
+                auto heading = runways.runway_number(r) * 10.0;
+                scalar[r * 4 + 0] = static_cast<float>(windGroup->headwind_component(heading));
+                scalar[r * 4 + 1] = static_cast<float>(windGroup->crosswind_component(heading));
+                scalar[r * 4 + 2] = static_cast<float>(windGroup->headwind_component(heading, true));
+                scalar[r * 4 + 3] = static_cast<float>(windGroup->crosswind_component(heading, true));
+            }
+            consume(scalar[update % scalar.size()]);
+        }
+    });
+    report("scalar, " + std::to_string(runways.runway_count()) + " runways", g_updates * runways.runway_count(), elapsed);
+
+    runway_winds components;
+    std::vector<util::optional<size_t>> best;
+    elapsed = measure([&]()
+    {
+        for (size_t update = 0; update < g_updates; ++update)
+        {
+            components.compute(runways, winds);
+            consume(components.max_crosswind[update % components.max_crosswind.size()]);
+        }
+    });
+    report("batch, " + std::to_string(runways.runway_count()) + " runways", g_updates * runways.runway_count(), elapsed);
+
+    elapsed = measure([&]()
+    {
+        for (size_t update = 0; update < g_updates; ++update)
+        {
+            components.best_runways(runways, best);
+            consume(best.size());
+        }
+    });
+    report("best runway, " + std::to_string(runways.station_count()) + " stations", g_updates * runways.station_count(), elapsed);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
@@ -0,0 +1,108 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.BenchmarkPch.h"
+
+#include <AviationWeather/metar.h>
+#include <AviationWeather/serialization.h>
+
+#include "benchmark.h"
+#include "corpus.h"
+
+namespace aw
+{
+namespace benchmark
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const size_t g_reportCount = 20000;
+
+void run_decode(std::vector<std::string> const& reports, std::string const& label)
+{
+    std::vector<metar> parsed;
+    parsed.reserve(reports.size());
+
+    auto parseTime = measure([&]()
+    {
+        for (auto const& report : reports)
+        {
+            parsed.emplace_back(report);
+        }
+    });
+    report(label + ", parse text", reports.size(), parseTime);
+
+    for (auto includeText : { true, false })
+    {
+        auto suffix = includeText ? " with text" : " without text";
+        std::vector<uint8_t> buffer;
+
+        auto elapsed = measure([&]()
+        {
+            encode(parsed, buffer, includeText);
+        });
+        report(label + ", encode" + suffix, parsed.size(), elapsed);
+
+        std::vector<metar> decoded;
+        elapsed = measure([&]()
+        {
+            decode(buffer.data(), buffer.size(), decoded);
+        });
+        report(label + ", decode" + suffix, decoded.size(), elapsed);
+        consume(decoded.size());
+
+        char text[100];
+        snprintf(text, sizeof(text), "%.1f bytes per report, decoding %.1fx faster than parsing",
+            static_cast<double>(buffer.size()) / parsed.size(),
+            static_cast<double>(parseTime.count()) / elapsed.count());
+        note(text);
+
+        // Reading the stream into a view copies nothing out of the buffer
+        size_t groups = 0;
+        elapsed = measure([&]()
+        {
+            binary_stream_reader reader(buffer.data(), buffer.size());
+            while (reader.next())
+            {
+                groups += reader.report().sky_condition_group.size();
+            }
+        });
+        report(label + ", read view" + suffix, parsed.size(), elapsed);
+        consume(groups);
+
+        snprintf(text, sizeof(text), "reading views %.1fx faster than parsing",
+            static_cast<double>(parseTime.count()) / elapsed.count());
+        note(text);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+BENCHMARK(Serialization_Decode)
+{
+    run_decode(generate_metars(g_reportCount), "US");
+    run_decode(generate_international_metars(g_reportCount), "international");
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
@@ -0,0 +1,139 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.BenchmarkPch.h"
+
+#include <AviationWeather/taf.h>
+#include <AviationWeather/taf_index.h>
+
+#include "benchmark.h"
+#include "corpus.h"
+
+namespace aw
+{
+namespace benchmark
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const size_t g_tafCount = 5000;
+const size_t g_queryCount = 1000000;
+
+size_t total_size(std::vector<std::string> const& reports)
+{
+    size_t size = 0;
+    for (auto const& report : reports)
+    {
+        size += report.size();
+    }
+    return size;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+BENCHMARK(TAF_Parse)
+{
+    auto tafs = generate_tafs(g_tafCount);
+    auto megabytes = total_size(tafs) / (1024.0 * 1024.0);
+
+    // Warm up so that both runs start from the same state
+    for (auto const& text : tafs)
+    {
+        consume(taf(text).forecast_group.size());
+    }
+
+    auto elapsed = measure([&]()
+    {
+        for (auto const& text : tafs)
+        {
+            taf t(text);
+            consume(t.forecast_group.size());
+        }
+    });
+    report("new taf per report", tafs.size(), elapsed);
+    note(std::to_string(megabytes * 1e9 / elapsed.count()) + " MB/s");
+
+    taf reused;
+    elapsed = measure([&]()
+    {
+        for (auto const& text : tafs)
+        {
+            reused.parse(text);
+            consume(reused.forecast_group.size());
+        }
+    });
+    report("reused taf", tafs.size(), elapsed);
+    note(std::to_string(megabytes * 1e9 / elapsed.count()) + " MB/s");
+}
+
+//-----------------------------------------------------------------------------
+
+BENCHMARK(TAF_IndexLookup)
+{
+    auto tafs = generate_tafs(g_tafCount);
+
+    std::vector<taf> parsed;
+    parsed.reserve(tafs.size());
+    for (auto const& text : tafs)
+    {
+        parsed.emplace_back(text);
+    }
+
+    taf_index_set set;
+    auto elapsed = measure([&]()
+    {
+        for (auto const& forecast : parsed)
+        {
+            set.insert(forecast);
+        }
+    });
+    report("compile", parsed.size(), elapsed);
+
+    // Queries grouped by station, as a route plan would issue them
+    std::vector<taf_query> queries;
+    queries.reserve(g_queryCount);
+    for (size_t i = 0; i < g_queryCount; ++i)
+    {
+        auto const& forecast = parsed[(i / 16) % parsed.size()];
+        auto minutes = static_cast<uint32_t>((i * 37) % (24 * 60));
+        queries.push_back({ forecast.identifier, time(1, static_cast<uint8_t>(minutes / 60), static_cast<uint8_t>(minutes % 60)) });
+    }
+
+    std::vector<taf_conditions const*> results;
+    elapsed = measure([&]()
+    {
+        set.prevailing(queries, results);
+        consume(results.size());
+    });
+    report("prevailing, batch", queries.size(), elapsed);
+
+    elapsed = measure([&]()
+    {
+        set.worst_case(queries, results);
+        consume(results.size());
+    });
+    report("worst case, batch", queries.size(), elapsed);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
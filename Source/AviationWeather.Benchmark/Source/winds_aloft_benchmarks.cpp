@@ -0,0 +1,88 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.BenchmarkPch.h"
+
+#include <AviationWeather/winds_aloft.h>
+
+#include "benchmark.h"
+#include "corpus.h"
+
+namespace aw
+{
+namespace benchmark
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+// Roughly the size of the national FB bulletins
+const size_t g_stationCount = 2000;
+const size_t g_routeCount = 2000;
+const size_t g_pointsPerRoute = 500;
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+BENCHMARK(WindsAloft_Parse)
+{
+    auto table = generate_winds_aloft(g_stationCount);
+    const size_t iterations = 20;
+
+    winds_aloft forecast;
+    auto elapsed = measure([&]()
+    {
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            forecast.parse(table);
+            consume(forecast.stations.size());
+        }
+    });
+    report("national table", iterations, elapsed);
+    note(std::to_string(table.size() * iterations / 1024.0 / 1024.0 * 1e9 / elapsed.count()) + " MB/s");
+}
+
+BENCHMARK(WindsAloft_Interpolate)
+{
+    winds_aloft forecast(generate_winds_aloft(g_stationCount));
+
+    // A climb, cruise and descent profile sampled along each route
+    std::vector<double> profile(g_pointsPerRoute);
+    for (size_t i = 0; i < g_pointsPerRoute; ++i)
+    {
+        auto const position = static_cast<double>(i) / g_pointsPerRoute;
+        profile[i] = 1000.0 + 36000.0 * (std::min)(1.0, 4.0 * (std::min)(position, 1.0 - position));
+    }
+
+    std::vector<winds_aloft_sample> samples;
+    auto elapsed = measure([&]()
+    {
+        for (size_t route = 0; route < g_routeCount; ++route)
+        {
+            forecast.interpolate(route % forecast.stations.size(), profile, samples);
+            consume(samples.size());
+        }
+    });
+    report("route profiles", g_routeCount * g_pointsPerRoute, elapsed);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
@@ -0,0 +1,134 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.BenchmarkPch.h"
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <AviationWeather/metar.h>
+#include <AviationWeather/xml_ingest.h>
+
+#include "benchmark.h"
+#include "corpus.h"
+
+namespace aw
+{
+namespace benchmark
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const size_t g_reportCount = 50000;
+
+// A response in the dataserver's layout, with the decoded fields that the
+// reader recognizes
+std::string make_document(std::vector<std::string> const& reports)
+{
+    std::string text = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<response>\n  <data>\n";
+
+    char fields[1024];
+    for (size_t i = 0; i < reports.size(); ++i)
+    {
+        text += "    <METAR>\n      <raw_text>";
+        text += reports[i];
+        snprintf(fields, sizeof(fields),
+            "</raw_text>\n      <station_id>%.4s</station_id>\n"
+            "      <observation_time>2015-12-12T17:56:00Z</observation_time>\n"
+            "      <latitude>%.2f</latitude>\n      <longitude>%.2f</longitude>\n"
+            "      <temp_c>18.3</temp_c>\n      <dewpoint_c>9.4</dewpoint_c>\n"
+            "      <wind_dir_degrees>280</wind_dir_degrees>\n      <wind_speed_kt>10</wind_speed_kt>\n"
+            "      <visibility_statute_mi>10.0</visibility_statute_mi>\n      <altim_in_hg>30.008858</altim_in_hg>\n"
+            "      <sky_condition sky_cover=\"FEW\" cloud_base_ft_agl=\"1500\" />\n"
+            "      <flight_category>VFR</flight_category>\n      <metar_type>METAR</metar_type>\n"
+            "      <elevation_m>%u</elevation_m>\n    </METAR>\n",
+            reports[i].c_str(), 20.0 + (i % 4000) * 0.01, -70.0 - (i % 6000) * 0.01, static_cast<unsigned>(i % 3000));
+        text += fields;
+    }
+    text += "  </data>\n</response>\n";
+    return text;
+}
+
+template <class TLambda>
+size_t read_all(xml_reader& reader, TLambda&& l)
+{
+    size_t count = 0;
+    while (reader.next())
+    {
+        l(reader);
+        ++count;
+    }
+    return count;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+BENCHMARK(XmlIngest_Read)
+{
+    auto reports = generate_metars(g_reportCount);
+    auto document = make_document(reports);
+
+    size_t total = 0;
+    auto parseTime = measure([&]()
+    {
+        for (auto const& report : reports)
+        {
+            total += metar_view(report).sky_condition_group.size();
+        }
+    });
+    report("parse raw text only", reports.size(), parseTime);
+
+    auto memoryTime = measure([&]()
+    {
+        xml_reader reader(document.data(), document.size());
+        read_all(reader, [&](xml_reader const& r) { total += r.report().sky_condition_group.size(); });
+    });
+    report("read document in memory", reports.size(), memoryTime);
+
+    auto checkedTime = measure([&]()
+    {
+        xml_reader reader(document.data(), document.size(), true);
+        read_all(reader, [&](xml_reader const& r) { total += r.mismatches(); });
+    });
+    report("read in memory, cross-checked", reports.size(), checkedTime);
+
+    auto streamTime = measure([&]()
+    {
+        std::istringstream stream(document);
+        xml_reader reader(stream);
+        read_all(reader, [&](xml_reader const& r) { total += r.report().sky_condition_group.size(); });
+    });
+    report("read from a stream", reports.size(), streamTime);
+    consume(total);
+
+    char summary[128];
+    snprintf(summary, sizeof(summary), "%.1f MB, %.0f MB/s; XML adds %.0f%% to parsing the raw text",
+        document.size() / 1e6, document.size() / (memoryTime.count() / 1000.0),
+        100.0 * (static_cast<double>(memoryTime.count()) / parseTime.count() - 1.0));
+    note(summary);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace benchmark
+} // namespace aw
@@ -0,0 +1,370 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <AviationWeather/advisory.h>
+#include <AviationWeather/advisory_index.h>
+
+#include "framework.h"
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+const char* g_airmet =
+    "WAUS45 KKCI 051445\n"
+    "SLCT WA 051445\n"
+    "AIRMET TANGO UPDT 2 FOR TURB STG WNDS AND LLWS VALID UNTIL 052100\n"
+    ".\n"
+    "AIRMET TURB...WA OR ID\n"
+    "FROM 30SE YDC TO 40E PDT TO 20NW BOI TO 60SW REO TO 30SE YDC\n"
+    "MOD TURB BTN FL240 AND FL400. CONDS CONTG BYD 21Z THRU 03Z.\n"
+    ".\n"
+    "AIRMET LLWS...OR\n"
+    "FROM 40E PDT TO 20NW BOI TO 60SW REO TO 40E PDT\n"
+    "LLWS EXP. CONDS ENDG 18-21Z.\n"
+    ".\n"
+    "OTLK VALID 2100-0300Z\n"
+    "AREA 1...TURB WA OR\n"
+    "FROM YDC TO PDT TO BOI TO YDC\n";
+
+const char* g_convective =
+    "WSUS32 KKCI 051855\n"
+    "SIGC\n"
+    "CONVECTIVE SIGMET 45C\n"
+    "VALID UNTIL 2055Z\n"
+    "KS OK\n"
+    "FROM 30NW ICT-40S MCI-50SE OSW-30NW ICT\n"
+    "AREA SCT EMBD TS MOV FROM 26025KT. TOPS ABV FL450.\n"
+    "\n"
+    "CONVECTIVE SIGMET 46C\n"
+    "VALID UNTIL 2055Z\n"
+    "KS MO\n"
+    "FROM 20W MCI-30SE OSW\n"
+    "LINE TS 20 NM WIDE MOV FROM 24020KT. TOPS TO FL380.\n"
+    "\n"
+    "CONVECTIVE SIGMET 47C\n"
+    "VALID UNTIL 2055Z\n"
+    "OK\n"
+    "20W OSW\n"
+    "ISOL SEV TS D30 MOV FROM 25015KT. TOPS TO FL400.\n"
+    "\n"
+    "OUTLOOK VALID 052055-060055\n"
+    "FROM ICT-MCI-OSW-ICT\n"
+    "WST ISSUANCES EXPD.\n";
+
+const char* g_international =
+    "EGTT SIGMET 3 VALID 051200/051600 EGRR-\n"
+    "EGTT LONDON FIR SEV TURB FCST WI N5130 W00200 - N5300 W00100 - N5300 E00100 - N5130 E00100 - N5130 W00200\n"
+    "FL250/370 MOV E 20KT NC=";
+
+aw::navaid_table navaids()
+{
+    aw::navaid_table table;
+    table.add("YDC", { 49.4722, -120.5133 });
+    table.add("PDT", { 45.6984, -118.9411 });
+    table.add("BOI", { 43.5522, -116.1925 });
+    table.add("REO", { 42.5903, -117.8684 });
+    table.add("ICT", { 37.7450, -97.5839 });
+    table.add("MCI", { 39.2853, -94.7370 });
+    table.add("OSW", { 37.1546, -95.6158 });
+    return table;
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(AdvisoryTests)
+{
+public:
+    TEST_METHOD(Advisory_Airmet);
+    TEST_METHOD(Advisory_ConvectiveSigmet);
+    TEST_METHOD(Advisory_International);
+    TEST_METHOD(Advisory_Resolve);
+    TEST_METHOD(Advisory_Geometry);
+    TEST_METHOD(Advisory_Index);
+    TEST_METHOD(Advisory_Antimeridian);
+};
+
+//-----------------------------------------------------------------------------
+
+void AdvisoryTests::Advisory_Airmet()
+{
+    auto advisories = decode_advisories(g_airmet);
+    Assert::AreEqual(size_t(2), advisories.size());
+
+    auto const& turbulence = advisories[0];
+    Assert::IsTrue(advisory_type::airmet == turbulence.type);
+    Assert::AreEqual(std::string("TANGO"), turbulence.identifier);
+    Assert::IsTrue(hazard_type::turbulence == turbulence.hazard);
+    Assert::IsTrue(time(5, 14, 45) == *turbulence.valid_from);
+    Assert::IsTrue(time(5, 21, 0) == turbulence.valid_to);
+    Assert::AreEqual(uint32_t(24000), *turbulence.lower_altitude);
+    Assert::AreEqual(uint32_t(40000), *turbulence.upper_altitude);
+    Assert::IsTrue(advisory_geometry::area == turbulence.geometry);
+
+    // The closing point repeats the first and is dropped
+    Assert::AreEqual(size_t(4), turbulence.points.size());
+    Assert::AreEqual(std::string("YDC"), turbulence.points[0].navaid);
+    Assert::AreEqual(uint16_t(30), turbulence.points[0].distance);
+    Assert::AreEqual(135.0, turbulence.points[0].bearing, 0.001);
+    Assert::AreEqual(std::string("REO"), turbulence.points[3].navaid);
+    Assert::AreEqual(225.0, turbulence.points[3].bearing, 0.001);
+    Assert::IsFalse(turbulence.has_position());
+
+    auto const& shear = advisories[1];
+    Assert::IsTrue(hazard_type::low_level_wind_shear == shear.hazard);
+    Assert::AreEqual(size_t(3), shear.points.size());
+    Assert::IsFalse(static_cast<bool>(shear.lower_altitude));
+
+    Assert::IsTrue(turbulence.active(time(5, 18, 0)));
+    Assert::IsFalse(turbulence.active(time(5, 14, 0)));
+    Assert::IsFalse(turbulence.active(time(5, 21, 0)));
+}
+
+void AdvisoryTests::Advisory_ConvectiveSigmet()
+{
+    auto advisories = decode_advisories(g_convective);
+    Assert::AreEqual(size_t(3), advisories.size());
+
+    auto const& area = advisories[0];
+    Assert::IsTrue(advisory_type::convective_sigmet == area.type);
+    Assert::AreEqual(std::string("45C"), area.identifier);
+    Assert::IsTrue(hazard_type::thunderstorm == area.hazard);
+    Assert::IsTrue(time(5, 20, 55) == area.valid_to);
+    Assert::IsTrue(advisory_geometry::area == area.geometry);
+    Assert::AreEqual(size_t(3), area.points.size());
+    Assert::AreEqual(uint32_t(0), *area.lower_altitude);
+    Assert::IsFalse(static_cast<bool>(area.upper_altitude));
+    Assert::IsTrue(area.covers_altitude(50000));
+
+    auto const& line = advisories[1];
+    Assert::AreEqual(std::string("46C"), line.identifier);
+    Assert::IsTrue(advisory_geometry::line == line.geometry);
+    Assert::AreEqual(uint16_t(20), line.width);
+    Assert::AreEqual(size_t(2), line.points.size());
+    Assert::AreEqual(uint32_t(38000), *line.upper_altitude);
+    Assert::IsFalse(line.covers_altitude(39000));
+
+    // Isolated cells are a single point with a diameter
+    auto const& cell = advisories[2];
+    Assert::IsTrue(advisory_geometry::line == cell.geometry);
+    Assert::AreEqual(uint16_t(30), cell.width);
+    Assert::AreEqual(size_t(1), cell.points.size());
+    Assert::AreEqual(std::string("OSW"), cell.points[0].navaid);
+    Assert::AreEqual(uint16_t(20), cell.points[0].distance);
+}
+
+void AdvisoryTests::Advisory_International()
+{
+    auto advisories = decode_advisories(g_international);
+    Assert::AreEqual(size_t(1), advisories.size());
+
+    auto const& sigmet = advisories[0];
+    Assert::IsTrue(advisory_type::sigmet == sigmet.type);
+    Assert::AreEqual(std::string("EGTT 3"), sigmet.identifier);
+    Assert::IsTrue(hazard_type::turbulence == sigmet.hazard);
+    Assert::IsTrue(time(5, 12, 0) == *sigmet.valid_from);
+    Assert::IsTrue(time(5, 16, 0) == sigmet.valid_to);
+    Assert::AreEqual(uint32_t(25000), *sigmet.lower_altitude);
+    Assert::AreEqual(uint32_t(37000), *sigmet.upper_altitude);
+    Assert::IsTrue(advisory_geometry::area == sigmet.geometry);
+    Assert::AreEqual(size_t(4), sigmet.points.size());
+    Assert::IsTrue(sigmet.has_position());
+    Assert::AreEqual(51.5, sigmet.points[0].position->latitude, 0.0001);
+    Assert::AreEqual(-2.0, sigmet.points[0].position->longitude, 0.0001);
+
+    Assert::IsTrue(sigmet.contains({ 52.0, -1.0 }));
+    Assert::IsFalse(sigmet.contains({ 52.0, 2.0 }));
+    Assert::IsTrue(sigmet.intersects({ 52.0, -4.0 }, { 52.0, 4.0 }));
+    Assert::IsFalse(sigmet.intersects({ 50.0, -4.0 }, { 50.0, 4.0 }));
+
+    // A single advisory parses the same way without the bulletin
+    aw::advisory single(g_international);
+    Assert::IsTrue(single == sigmet);
+}
+
+void AdvisoryTests::Advisory_Resolve()
+{
+    navaid_table table;
+    table.add("ABC", { 0.0, 0.0 });
+
+    advisory a("SIGMET ALFA 1 VALID UNTIL 051200 FROM 60N ABC-60E ABC-60S ABC-60W ABC SEV ICE BLW FL180.");
+    Assert::AreEqual(std::string("ALFA 1"), a.identifier);
+    Assert::IsTrue(hazard_type::icing == a.hazard);
+    Assert::AreEqual(uint32_t(18000), *a.upper_altitude);
+    Assert::IsFalse(a.contains({ 0.0, 0.0 }));
+
+    Assert::IsTrue(a.resolve(table));
+    Assert::AreEqual(1.0, a.points[0].position->latitude, 0.01);
+    Assert::AreEqual(0.0, a.points[0].position->longitude, 0.01);
+    Assert::AreEqual(0.0, a.points[1].position->latitude, 0.01);
+    Assert::AreEqual(1.0, a.points[1].position->longitude, 0.01);
+    Assert::IsTrue(a.contains({ 0.0, 0.0 }));
+    Assert::IsFalse(a.contains({ 0.9, 0.9 }));
+
+    advisory unknown("SIGMET ALFA 2 VALID UNTIL 051200 FROM XYZ-ABC-60S ABC SEV ICE");
+    Assert::IsFalse(unknown.resolve(table));
+    Assert::IsTrue(static_cast<bool>(unknown.points[1].position));
+}
+
+void AdvisoryTests::Advisory_Geometry()
+{
+    auto advisories = decode_advisories(g_convective);
+    auto table = navaids();
+    for (auto& a : advisories)
+    {
+        a.resolve(table);
+    }
+
+    auto const& area = advisories[0];
+    Assert::IsTrue(area.contains({ 38.0, -96.0 }));
+    Assert::IsFalse(area.contains({ 38.0, -99.0 }));
+    Assert::IsTrue(area.intersects({ 38.0, -100.0 }, { 38.0, -90.0 }));
+    Assert::IsFalse(area.intersects({ 41.0, -100.0 }, { 41.0, -90.0 }));
+
+    // 20 NM wide, so 10 NM either side of the line
+    auto const& line = advisories[1];
+    auto const& from = *line.points[0].position;
+    auto const& to = *line.points[1].position;
+    geo_point middle = { (from.latitude + to.latitude) / 2.0, (from.longitude + to.longitude) / 2.0 };
+    Assert::IsTrue(line.contains(middle));
+    Assert::IsTrue(line.contains({ from.latitude + 9.0 / 60.0, from.longitude }));
+    Assert::IsFalse(line.contains({ from.latitude + 11.0 / 60.0, from.longitude }));
+    Assert::IsTrue(line.intersects({ middle.latitude + 1.0, middle.longitude - 1.0 }, { middle.latitude - 1.0, middle.longitude + 1.0 }));
+}
+
+void AdvisoryTests::Advisory_Index()
+{
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> latitude(25.0, 49.0);
+    std::uniform_real_distribution<double> longitude(-125.0, -67.0);
+    std::uniform_real_distribution<double> size(0.2, 3.0);
+
+    std::vector<advisory> advisories;
+    for (size_t i = 0; i < 200; ++i)
+    {
+        advisory a;
+        a.valid_from = time(5, i % 2 == 0 ? 12 : 18, 0);
+        a.valid_to = time(5, i % 2 == 0 ? 18 : 23, 0);
+        a.geometry = i % 5 == 0 ? advisory_geometry::line : advisory_geometry::area;
+        a.width = 40;
+
+        auto lat = latitude(random);
+        auto lon = longitude(random);
+        auto extent = size(random);
+        for (size_t j = 0; j < (i % 5 == 0 ? 2u : 4u); ++j)
+        {
+            advisory_point p;
+            p.position = geo_point{ lat + (j == 1 || j == 2 ? extent : 0.0), lon + (j >= 2 ? extent : 0.0) };
+            a.points.push_back(p);
+        }
+        advisories.push_back(a);
+    }
+    advisories.push_back(advisory());
+
+    advisory_index index(advisories);
+    Assert::AreEqual(advisories.size(), index.size());
+
+    std::vector<size_t> results, expected;
+    for (size_t i = 0; i < 500; ++i)
+    {
+        geo_point from = { latitude(random), longitude(random) };
+        geo_point to = { from.latitude + size(random), from.longitude - size(random) };
+        time at(5, i % 2 == 0 ? 13 : 20, 0);
+
+        expected.clear();
+        for (size_t j = 0; j < advisories.size(); ++j)
+        {
+            if (advisories[j].active(at) && advisories[j].contains(from))
+            {
+                expected.push_back(j);
+            }
+        }
+        index.query(from, at, results);
+        Assert::IsTrue(expected == results);
+
+        expected.clear();
+        for (size_t j = 0; j < advisories.size(); ++j)
+        {
+            if (advisories[j].active(at) && advisories[j].intersects(from, to))
+            {
+                expected.push_back(j);
+            }
+        }
+        index.query(from, to, at, results);
+        Assert::IsTrue(expected == results);
+    }
+}
+
+void AdvisoryTests::Advisory_Antimeridian()
+{
+    auto advisories = decode_advisories(
+        "NZZO SIGMET 2 VALID 051200/051600 NZKL-\n"
+        "NZZO AUCKLAND OCEANIC FIR SEV TURB FCST WI S3000 E17500 - S3000 W17500 - S3500 W17500 - S3500 E17500\n"
+        "FL250/370 STNR NC=");
+    Assert::AreEqual(size_t(1), advisories.size());
+
+    auto const& area = advisories[0];
+    Assert::IsTrue(area.contains({ -32.0, 179.5 }));
+    Assert::IsTrue(area.contains({ -32.0, -179.5 }));
+    Assert::IsTrue(area.contains({ -32.0, 175.5 }));
+    Assert::IsFalse(area.contains({ -32.0, 0.0 }));
+    Assert::IsFalse(area.contains({ -32.0, -170.0 }));
+
+    // Segments across the antimeridian take the shorter way
+    Assert::IsTrue(area.intersects({ -28.0, 179.0 }, { -37.0, -179.0 }));
+    Assert::IsFalse(area.intersects({ -28.0, 179.0 }, { -28.0, -179.0 }));
+    Assert::IsFalse(area.intersects({ -32.0, 10.0 }, { -32.0, -10.0 }));
+
+    std::vector<advisory> items(advisories);
+    items.push_back(advisory(
+        "SIGMET ALFA 1 VALID UNTIL 051600 WI S3000 E00100 - S3000 W00100 - S3500 W00100 - S3500 E00100 SEV TURB"));
+    advisory_index index(items);
+
+    std::vector<size_t> results;
+    time at(5, 13, 0);
+    index.query({ -32.0, -179.5 }, at, results);
+    Assert::IsTrue(results == std::vector<size_t>{ 0 });
+    index.query({ -32.0, 179.5 }, at, results);
+    Assert::IsTrue(results == std::vector<size_t>{ 0 });
+    index.query({ -32.0, 0.0 }, at, results);
+    Assert::IsTrue(results == std::vector<size_t>{ 1 });
+    index.query({ -36.0, 178.0 }, { -31.0, -178.0 }, at, results);
+    Assert::IsTrue(results == std::vector<size_t>{ 0 });
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
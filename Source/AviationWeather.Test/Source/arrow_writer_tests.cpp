@@ -0,0 +1,483 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <AviationWeather/arrow_writer.h>
+#include <AviationWeather/metar.h>
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const char* g_reports[] =
+{
+    "SPECI KPDX 041453Z 32007KT 1 1/2SM R10R/3000VP6000FT BR BKN003 OVC010 10/09 A3000 RMK AO2 SFC VIS 4",
+    "KORD 190151Z COR 19010G25KT 150V220 5SM TSRA BR FEW027 BKN048CB OVC090 21/19 A2971 RMK AO2 PK WND 18028/0112",
+    "LFPG 121030Z VRB05MPS CAVOK M02/M05 Q1015",
+    "EDDF 121020Z 06008KT R25L/0800U R25R/P1500N 0600 +SHRASN FZFG VV002 02/02 Q1025 NOSIG",
+    "KXYZ 121020Z"
+};
+
+template <class T>
+T read(uint8_t const* data)
+{
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+// A FlatBuffers table, read as the format describes rather than as the
+// writer builds it
+class table
+{
+public:
+    explicit table(uint8_t const* data) :
+        m_data(data)
+    {}
+
+    // The field's data, or null if the field is absent
+    uint8_t const* field(uint16_t id) const
+    {
+        auto vtable = m_data - read<int32_t>(m_data);
+        auto vtableSize = read<uint16_t>(vtable);
+        if (4u + 2u * id >= vtableSize)
+        {
+            return nullptr;
+        }
+        auto offset = read<uint16_t>(vtable + 4 + 2 * id);
+        return offset == 0 ? nullptr : m_data + offset;
+    }
+
+    template <class T>
+    T scalar(uint16_t id) const
+    {
+        auto data = field(id);
+        return data == nullptr ? T() : read<T>(data);
+    }
+
+    table child(uint16_t id) const
+    {
+        return table(follow(field(id)));
+    }
+
+    std::string text(uint16_t id) const
+    {
+        auto data = follow(field(id));
+        return std::string(reinterpret_cast<const char*>(data + 4), read<uint32_t>(data));
+    }
+
+    // A vector's length, and the start of its elements
+    uint32_t vector(uint16_t id, uint8_t const*& elements) const
+    {
+        auto data = follow(field(id));
+        elements = data + 4;
+        return read<uint32_t>(data);
+    }
+
+    std::vector<table> tables(uint16_t id) const
+    {
+        uint8_t const* elements = nullptr;
+        std::vector<table> results;
+        auto count = field(id) == nullptr ? 0 : vector(id, elements);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            results.push_back(table(follow(elements + 4 * i)));
+        }
+        return results;
+    }
+
+    static uint8_t const* follow(uint8_t const* offset)
+    {
+        return offset + read<uint32_t>(offset);
+    }
+
+private:
+    uint8_t const* m_data;
+};
+
+// A column of the schema, flattened depth-first
+struct column
+{
+    std::string path;
+    uint8_t     type;
+    int         bit_width;
+    bool        is_signed;
+    bool        nullable;
+};
+
+void flatten(table const& field, std::string const& prefix, std::vector<column>& columns)
+{
+    auto type = field.child(3);
+    column c = { prefix + field.text(0), field.scalar<uint8_t>(2), type.scalar<int32_t>(0), type.scalar<uint8_t>(1) != 0,
+        field.scalar<uint8_t>(1) != 0 };
+    columns.push_back(c);
+
+    for (auto const& child : field.tables(5))
+    {
+        flatten(child, c.path + ".", columns);
+    }
+}
+
+// The messages of a stream, decoded with just enough of the format to check
+// the writer
+class stream_reader
+{
+public:
+    explicit stream_reader(std::vector<uint8_t> const& stream) :
+        m_stream(stream),
+        m_position(0),
+        m_ended(false)
+    {
+        auto schema = next_message(1);
+        Assert::IsTrue(schema.scalar<int16_t>(0) == 0);   // Little endian
+        for (auto const& field : schema.tables(1))
+        {
+            flatten(field, "", m_columns);
+        }
+    }
+
+    std::vector<column> const& columns() const
+    {
+        return m_columns;
+    }
+
+    bool ended() const
+    {
+        return m_ended;
+    }
+
+    // Reads the next record batch, returning false at the end of the stream
+    bool next()
+    {
+        if (read<uint32_t>(&m_stream[m_position + 4]) == 0)
+        {
+            Assert::AreEqual(0xFFFFFFFFu, read<uint32_t>(&m_stream[m_position]));
+            Assert::AreEqual(m_stream.size(), m_position + 8);
+            m_ended = true;
+            return false;
+        }
+
+        auto batch = next_message(3);
+        m_length = batch.scalar<int64_t>(0);
+
+        uint8_t const* nodes = nullptr;
+        uint8_t const* buffers = nullptr;
+        Assert::AreEqual(static_cast<uint32_t>(m_columns.size()), batch.vector(1, nodes));
+        auto bufferCount = batch.vector(2, buffers);
+        Assert::AreEqual(size_t(0), reinterpret_cast<uintptr_t>(nodes) % 8);
+
+        m_nodes.clear();
+        m_buffers.clear();
+        for (size_t i = 0; i < m_columns.size(); ++i)
+        {
+            m_nodes.push_back(read<int64_t>(nodes + 16 * i + 8));
+        }
+        for (uint32_t i = 0; i < bufferCount; ++i)
+        {
+            auto offset = read<int64_t>(buffers + 16 * i);
+            auto length = read<int64_t>(buffers + 16 * i + 8);
+            Assert::IsTrue(offset % 8 == 0 && offset + length <= m_bodyLength);
+            m_buffers.push_back(m_body + offset);
+        }
+
+        // Validity, then offsets for utf8 and lists, then values for all but
+        // lists and structs
+        m_firstBuffer.clear();
+        size_t index = 0;
+        for (auto const& c : m_columns)
+        {
+            m_firstBuffer.push_back(index);
+            index += 1 + (c.type == 5 || c.type == 12 ? 1 : 0) + (c.type == 12 || c.type == 13 ? 0 : 1);
+        }
+        Assert::AreEqual(index, static_cast<size_t>(bufferCount));
+
+        m_position += static_cast<size_t>(m_bodyLength);
+        return true;
+    }
+
+    int64_t length() const
+    {
+        return m_length;
+    }
+
+    size_t index(std::string const& path) const
+    {
+        for (size_t i = 0; i < m_columns.size(); ++i)
+        {
+            if (m_columns[i].path == path)
+            {
+                return i;
+            }
+        }
+        Assert::Fail(L"No such column");
+        return 0;
+    }
+
+    bool is_valid(std::string const& path, size_t row) const
+    {
+        auto i = index(path);
+        if (m_nodes[i] == 0)
+        {
+            return true;
+        }
+        auto bitmap = m_buffers[m_firstBuffer[i]];
+        return (bitmap[row / 8] & (1 << (row % 8))) != 0;
+    }
+
+    template <class T>
+    T value(std::string const& path, size_t row) const
+    {
+        auto i = index(path);
+        return read<T>(m_buffers[m_firstBuffer[i] + 1] + sizeof(T) * row);
+    }
+
+    int32_t offset(std::string const& path, size_t row) const
+    {
+        return value<int32_t>(path, row);
+    }
+
+    std::string text(std::string const& path, size_t row) const
+    {
+        auto i = index(path);
+        auto begin = offset(path, row);
+        auto end = offset(path, row + 1);
+        return std::string(reinterpret_cast<const char*>(m_buffers[m_firstBuffer[i] + 2]) + begin, static_cast<size_t>(end - begin));
+    }
+
+private:
+    table next_message(uint8_t type)
+    {
+        Assert::AreEqual(size_t(0), m_position % 8);
+        Assert::AreEqual(0xFFFFFFFFu, read<uint32_t>(&m_stream[m_position]));
+        auto size = read<int32_t>(&m_stream[m_position + 4]);
+        Assert::AreEqual(0, size % 8);
+
+        auto metadata = &m_stream[m_position + 8];
+        table message(table::follow(metadata));
+        Assert::AreEqual(int16_t(4), message.scalar<int16_t>(0));
+        Assert::AreEqual(type, message.scalar<uint8_t>(1));
+
+        m_bodyLength = message.scalar<int64_t>(3);
+        m_position += 8 + static_cast<size_t>(size);
+        m_body = &m_stream[m_position];
+        return message.child(2);
+    }
+
+private:
+    std::vector<uint8_t> const&  m_stream;
+    size_t                       m_position;
+    bool                         m_ended;
+    std::vector<column>          m_columns;
+    int64_t                      m_length;
+    uint8_t const*               m_body;
+    int64_t                      m_bodyLength;
+    std::vector<int64_t>         m_nodes;      // Null counts
+    std::vector<uint8_t const*>  m_buffers;
+    std::vector<size_t>          m_firstBuffer;
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(ArrowWriterTests)
+{
+public:
+    TEST_METHOD(ArrowWriter_Schema);
+    TEST_METHOD(ArrowWriter_Columns);
+    TEST_METHOD(ArrowWriter_Batches);
+};
+
+//-----------------------------------------------------------------------------
+
+void ArrowWriterTests::ArrowWriter_Schema()
+{
+    std::vector<uint8_t> stream;
+    arrow_writer writer(stream);
+    writer.close();
+
+    stream_reader reader(stream);
+    auto const& columns = reader.columns();
+    Assert::AreEqual(size_t(42), columns.size());
+
+    Assert::AreEqual(std::string("raw_text"), columns[0].path);
+    Assert::AreEqual(uint8_t(5), columns[0].type);
+    Assert::IsFalse(columns[0].nullable);
+
+    auto const& temperature = columns[reader.index("temperature")];
+    Assert::AreEqual(uint8_t(2), temperature.type);
+    Assert::AreEqual(8, temperature.bit_width);
+    Assert::IsTrue(temperature.is_signed);
+    Assert::IsTrue(temperature.nullable);
+
+    Assert::AreEqual(uint8_t(3), columns[reader.index("visibility")].type);
+    Assert::AreEqual(uint8_t(12), columns[reader.index("sky_condition")].type);
+    Assert::AreEqual(uint8_t(13), columns[reader.index("sky_condition.item")].type);
+    Assert::AreEqual(32, columns[reader.index("sky_condition.item.layer_height")].bit_width);
+    Assert::IsFalse(columns[reader.index("sky_condition.item.layer_height")].is_signed);
+    Assert::AreEqual(uint8_t(12), columns[reader.index("weather.item.phenomena")].type);
+    Assert::AreEqual(std::string("remarks"), columns.back().path);
+
+    // A stream without batches
+    Assert::IsFalse(reader.next());
+    Assert::IsTrue(reader.ended());
+}
+
+//-----------------------------------------------------------------------------
+
+void ArrowWriterTests::ArrowWriter_Columns()
+{
+    std::vector<metar> reports(std::begin(g_reports), std::end(g_reports));
+    std::vector<uint8_t> stream;
+    write_arrow(reports, stream);
+
+    stream_reader reader(stream);
+    Assert::IsTrue(reader.next());
+    Assert::AreEqual(int64_t(5), reader.length());
+
+    for (size_t row = 0; row < reports.size(); ++row)
+    {
+        Assert::AreEqual(reports[row].raw_data, reader.text("raw_text", row));
+        Assert::AreEqual(reports[row].identifier, reader.text("station", row));
+        Assert::AreEqual(reports[row].remarks, reader.text("remarks", row));
+        Assert::AreEqual(reports[row].observation_time.hour_of_day, reader.value<uint8_t>("observation_hour", row));
+    }
+
+    Assert::AreEqual(uint8_t(metar_report_type::special), reader.value<uint8_t>("report_type", 0));
+    Assert::AreEqual(uint8_t(metar_modifier_type::corrected), reader.value<uint8_t>("modifier", 1));
+
+    // Winds varying between two directions keep the direction; VRB does not
+    Assert::AreEqual(uint16_t(190), reader.value<uint16_t>("wind_direction", 1));
+    Assert::AreEqual(uint16_t(150), reader.value<uint16_t>("wind_variation_lower", 1));
+    Assert::AreEqual(uint8_t(25), reader.value<uint8_t>("wind_gust", 1));
+    Assert::IsFalse(reader.is_valid("wind_gust", 0));
+    Assert::IsFalse(reader.is_valid("wind_direction", 2));
+    Assert::AreEqual(uint8_t(speed_unit::mps), reader.value<uint8_t>("wind_unit", 2));
+
+    Assert::AreEqual(1.5, reader.value<double>("visibility", 0));
+    Assert::AreEqual(int8_t(-2), reader.value<int8_t>("temperature", 2));
+    Assert::AreEqual(1015.0, reader.value<double>("altimeter", 2));
+
+    // The last report has none of the optional groups
+    for (auto path : { "wind_direction", "wind_speed", "wind_unit", "visibility", "temperature", "dewpoint", "altimeter" })
+    {
+        Assert::IsTrue(reader.is_valid(path, 3));
+        Assert::IsFalse(reader.is_valid(path, 4));
+    }
+
+    // Lists: report 3 has two RVRs, report 0 one
+    Assert::AreEqual(0, reader.offset("runway_visual_range", 0));
+    Assert::AreEqual(1, reader.offset("runway_visual_range", 1));
+    Assert::AreEqual(1, reader.offset("runway_visual_range", 3));
+    Assert::AreEqual(3, reader.offset("runway_visual_range", 4));
+    Assert::AreEqual(3, reader.offset("runway_visual_range", 5));
+    Assert::AreEqual(6000.0, reader.value<double>("runway_visual_range.item.visibility_max", 0));
+    Assert::AreEqual(uint8_t(visibility_modifier_type::greater_than), reader.value<uint8_t>("runway_visual_range.item.visibility_max_modifier", 0));
+    Assert::AreEqual(uint8_t(25), reader.value<uint8_t>("runway_visual_range.item.runway_number", 2));
+    Assert::AreEqual(uint8_t(rvr_tendency::no_change), reader.value<uint8_t>("runway_visual_range.item.tendency", 2));
+
+    // Sky conditions: 2 + 3 + 0 + 1 + 0 layers
+    Assert::AreEqual(5, reader.offset("sky_condition", 2));
+    Assert::AreEqual(6, reader.offset("sky_condition", 4));
+    Assert::AreEqual(4800u, reader.value<uint32_t>("sky_condition.item.layer_height", 3));
+    Assert::AreEqual(uint8_t(sky_cover_cloud_type::cumulonimbus), reader.value<uint8_t>("sky_condition.item.cloud_type", 3));
+    Assert::AreEqual(uint8_t(sky_cover_type::vertical_visibility), reader.value<uint8_t>("sky_condition.item.sky_cover", 5));
+
+    // Weather nests a list of phenomena in each item: +SHRASN has two
+    auto item = reader.offset("weather", 3);
+    Assert::AreEqual(uint8_t(weather_intensity::heavy), reader.value<uint8_t>("weather.item.intensity", static_cast<size_t>(item)));
+    auto phenomena = reader.offset("weather.item.phenomena", static_cast<size_t>(item));
+    Assert::AreEqual(phenomena + 2, reader.offset("weather.item.phenomena", static_cast<size_t>(item) + 1));
+    Assert::AreEqual(uint8_t(weather_phenomena::rain), reader.value<uint8_t>("weather.item.phenomena.item", static_cast<size_t>(phenomena)));
+    Assert::AreEqual(uint8_t(weather_phenomena::snow), reader.value<uint8_t>("weather.item.phenomena.item", static_cast<size_t>(phenomena) + 1));
+
+    Assert::IsFalse(reader.next());
+    Assert::IsTrue(reader.ended());
+}
+
+//-----------------------------------------------------------------------------
+
+void ArrowWriterTests::ArrowWriter_Batches()
+{
+    std::vector<metar> reports;
+    std::vector<metar_view> views;
+    for (size_t i = 0; i < 23; ++i)
+    {
+        reports.emplace_back(g_reports[i % 5]);
+        views.emplace_back(g_reports[i % 5]);
+    }
+
+    // After what the buffer held already
+    std::vector<uint8_t> buffer(3, 0xAB);
+    write_arrow(reports, buffer, 10);
+    std::vector<uint8_t> stream(buffer.begin() + 3, buffer.end());
+
+    stream_reader reader(stream);
+    size_t row = 0;
+    for (auto expected : { 10, 10, 3 })
+    {
+        Assert::IsTrue(reader.next());
+        Assert::AreEqual(int64_t(expected), reader.length());
+        for (size_t i = 0; i < static_cast<size_t>(expected); ++i, ++row)
+        {
+            Assert::AreEqual(reports[row].raw_data, reader.text("raw_text", i));
+            Assert::AreEqual(static_cast<bool>(reports[row].temperature), reader.is_valid("temperature", i));
+        }
+    }
+    Assert::IsFalse(reader.next());
+
+    // Views write the same stream as the reports they were parsed from
+    std::vector<uint8_t> viewStream;
+    arrow_writer writer(viewStream);
+    writer.write(views.data(), 10);
+    writer.write(views.data() + 10, 10);
+    writer.write(views.data() + 20, 3);
+    writer.close();
+    writer.close();
+    Assert::IsTrue(stream == viewStream);
+
+    Assert::ExpectException<aw_exception>([&]() { writer.write(reports); });
+
+    // Covers without clouds have no height
+    stream.clear();
+    write_arrow(std::vector<metar>(1, metar("EHAM 121155Z AUTO 22009KT 9999 NCD 15/08 Q1013")), stream);
+    stream_reader clear(stream);
+    Assert::IsTrue(clear.next());
+    Assert::AreEqual(uint8_t(sky_cover_type::no_cloud_detected), clear.value<uint8_t>("sky_condition.item.sky_cover", 0));
+    Assert::IsFalse(clear.is_valid("sky_condition.item.layer_height", 0));
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
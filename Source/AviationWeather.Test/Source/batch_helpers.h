@@ -0,0 +1,74 @@
+/**********************************************************************************
+*                                                                                *
+* Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+*                                                                                *
+* This source is subject to the MIT License.                                     *
+* See http://opensource.org/licenses/MIT                                         *
+*                                                                                *
+* THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+* EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+* WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+*                                                                                *
+* NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+*                                                                                *
+**********************************************************************************/
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <CppUnitTest.h>
+
+namespace aw
+{
+namespace test
+{
+
+//-----------------------------------------------------------------------------
+
+// Not a multiple of four or eight, so the batch kernels and conversions
+// finish with their scalar loops
+const size_t g_columnSize = 1003;
+
+template <class T>
+std::vector<T> random_column(std::mt19937& random, T lower, T upper)
+{
+    std::uniform_real_distribution<T> distribution(lower, upper);
+    std::vector<T> column(g_columnSize);
+    for (auto& value : column)
+    {
+        value = distribution(random);
+    }
+    return column;
+}
+
+// Batch results against a double precision reference for each index
+template <class T, class TReference>
+void check_batch(std::vector<T> const& results, double tolerance, TReference&& reference)
+{
+    Microsoft::VisualStudio::CppUnitTestFramework::Assert::AreEqual(g_columnSize, results.size());
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        Microsoft::VisualStudio::CppUnitTestFramework::Assert::AreEqual(reference(i), static_cast<double>(results[i]), tolerance);
+    }
+}
+
+// As check_batch, with the tolerance scaled by the size of the expected value
+template <class T, class TReference>
+void check_batch_relative(std::vector<T> const& results, double tolerance, TReference&& reference)
+{
+    Microsoft::VisualStudio::CppUnitTestFramework::Assert::AreEqual(g_columnSize, results.size());
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        auto expected = reference(i);
+        Microsoft::VisualStudio::CppUnitTestFramework::Assert::AreEqual(expected, static_cast<double>(results[i]), tolerance * (1.0 + std::abs(expected)));
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
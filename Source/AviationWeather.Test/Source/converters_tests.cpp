@@ -0,0 +1,152 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <random>
+#include <vector>
+
+#include <AviationWeather/converters.h>
+
+#include "batch_helpers.h"
+#include "framework.h"
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+template <class TUnit>
+void check_conversion(std::vector<double> const& values, TUnit from, TUnit to)
+{
+    std::vector<double> results(values.size());
+    convert(values.data(), values.size(), from, to, results.data());
+    check_batch(results, 1e-9, [&](size_t i) { return convert(values[i], from, to); });
+
+    std::vector<float> singles(values.begin(), values.end());
+    std::vector<float> singleResults(values.size());
+    convert(singles.data(), singles.size(), from, to, singleResults.data());
+    check_batch_relative(singleResults, 1e-6, [&](size_t i) { return convert(static_cast<double>(singles[i]), from, to); });
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(ConvertersTests)
+{
+public:
+    TEST_METHOD(Converters_BatchMatchesScalar);
+    TEST_METHOD(Converters_BatchInPlace);
+    TEST_METHOD(Converters_CompileTimeRatios);
+};
+
+//-----------------------------------------------------------------------------
+
+void ConvertersTests::Converters_BatchMatchesScalar()
+{
+    std::mt19937 random(1);
+    auto distances = random_column(random, 0.0, 20000.0);
+    auto pressures = random_column(random, 900.0, 1100.0);
+    auto speeds = random_column(random, 0.0, 150.0);
+
+    check_conversion(distances, distance_unit::feet, distance_unit::metres);
+    check_conversion(distances, distance_unit::statute_miles, distance_unit::nautical_miles);
+    check_conversion(distances, distance_unit::metres, distance_unit::metres);
+    check_conversion(pressures, pressure_unit::hPa, pressure_unit::inHg);
+    check_conversion(speeds, speed_unit::kt, speed_unit::mps);
+    check_conversion(speeds, speed_unit::mph, speed_unit::kt);
+
+    // Short arrays never reach the vector loop
+    double one = 10.0;
+    double result = 0.0;
+    convert(&one, 1, speed_unit::mps, speed_unit::kt, &result);
+    Assert::AreEqual(19.438, result, 0.001);
+    convert(&one, 0, speed_unit::mps, speed_unit::kt, &result);
+    Assert::AreEqual(19.438, result, 0.001);
+}
+
+//-----------------------------------------------------------------------------
+
+void ConvertersTests::Converters_BatchInPlace()
+{
+    std::mt19937 random(2);
+    auto values = random_column(random, 0.0, 100.0);
+    auto original = values;
+
+    convert(values.data(), values.size(), distance_unit::nautical_miles, distance_unit::feet, values.data());
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        Assert::AreEqual(original[i] * 1852.0 / 0.3048, values[i], 1e-6);
+    }
+
+    convert(values.data(), values.size(), distance_unit::feet, distance_unit::nautical_miles, values.data());
+    convert(values.data(), values.size(), distance_unit::feet, distance_unit::feet, values.data());
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        Assert::AreEqual(original[i], values[i], 1e-9);
+    }
+
+    std::vector<float> singles = { 29.92f, 30.01f, 28.5f };
+    convert(singles.data(), singles.size(), pressure_unit::inHg, pressure_unit::hPa, singles.data());
+    Assert::AreEqual(1013.2, static_cast<double>(singles[0]), 0.1);
+    Assert::AreEqual(1016.2, static_cast<double>(singles[1]), 0.1);
+    Assert::AreEqual(965.1, static_cast<double>(singles[2]), 0.1);
+}
+
+//-----------------------------------------------------------------------------
+
+void ConvertersTests::Converters_CompileTimeRatios()
+{
+    const double feetToMetres = unit_ratio<distance_unit, distance_unit::feet, distance_unit::metres>::value;
+    static_assert(unit_ratio<speed_unit, speed_unit::kt, speed_unit::kt>::value == 1.0, "same unit");
+    Assert::AreEqual(0.3048, feetToMetres, 1e-12);
+
+    const distance_unit distances[] = { distance_unit::feet, distance_unit::metres, distance_unit::statute_miles, distance_unit::nautical_miles };
+    for (auto from : distances)
+    {
+        for (auto to : distances)
+        {
+            Assert::AreEqual(detail::lookup_ratio(from, to), detail::si_factor(from) / detail::si_factor(to), 1e-9 * detail::lookup_ratio(from, to));
+        }
+    }
+
+    Assert::AreEqual(convert(1013.25, pressure_unit::hPa, pressure_unit::inHg), convert<pressure_unit::hPa, pressure_unit::inHg>(1013.25), 1e-9);
+    Assert::AreEqual(convert(25.0, speed_unit::kt, speed_unit::mph), convert<speed_unit::kt, speed_unit::mph>(25.0), 1e-9);
+    Assert::AreEqual(10, convert<distance_unit::statute_miles, distance_unit::statute_miles, int>(10));
+    Assert::AreEqual(5280.0, convert<distance_unit::statute_miles, distance_unit::feet>(1), 1e-9);
+
+    std::vector<float> speeds = { 10.0f, 20.0f, 30.0f };
+    convert<speed_unit::kt, speed_unit::mps>(speeds.data(), speeds.size(), speeds.data());
+    Assert::AreEqual(5.144, static_cast<double>(speeds[0]), 0.001);
+    Assert::AreEqual(15.433, static_cast<double>(speeds[2]), 0.001);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
@@ -0,0 +1,237 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <AviationWeather/csv_ingest.h>
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+// The layout of the dataserver's CSV output, abbreviated
+const char* g_dump =
+    "No errors\n"
+    "No warnings\n"
+    "12 ms\n"
+    "data source=metars\n"
+    "4 results\n"
+    "raw_text,station_id,latitude,longitude,elevation_m\n"
+    "KSFO 121756Z 28010KT 10SM FEW015 18/09 A3001,KSFO,37.62,-122.37,3.0\n"
+    "\"EGLL 121750Z 27012KT 9999 SCT020 08/07 Q1002\",\"EGLL\",\"51.48\",\"-0.45\",\"24.0\"\n"
+    "KPDX 121753Z 32007KT 10SM BKN030 10/09 A3000,KPDX,,-122.6,\n"
+    ",KOAK,37.72,-122.22,2.0\n"
+    "CYYZ 121800Z 24015KT 15SM OVC040 05/M01 A2992,CYYZ,43.68,-79.63,abc\n";
+
+// A dump large enough to be split across several threads, with a quoted
+// column of commas, quotes and line breaks in every row so that ranges often
+// start inside a quoted field
+std::string make_dump(size_t rows)
+{
+    std::string text = "raw_text,notes,latitude,longitude,elevation_m\r\n";
+    char row[256];
+    for (size_t i = 0; i < rows; ++i)
+    {
+        snprintf(row, sizeof(row),
+            "K%03u 12%02u56Z 28010KT 10SM BKN015 %02u/05 A3010,\"line one,\r\nline \"\"two\"\"\n%u\",%u.5,-%u.25,%u\r\n",
+            static_cast<unsigned>(i % 1000), static_cast<unsigned>(i % 24), static_cast<unsigned>(i % 30),
+            static_cast<unsigned>(i), static_cast<unsigned>(i % 90), static_cast<unsigned>(i % 180), static_cast<unsigned>(i));
+        text += row;
+    }
+    return text;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(CsvIngestTests)
+{
+public:
+    TEST_METHOD(CsvIngest_Dataserver);
+    TEST_METHOD(CsvIngest_Quoting);
+    TEST_METHOD(CsvIngest_Columns);
+    TEST_METHOD(CsvIngest_Parallel);
+    TEST_METHOD(CsvIngest_File);
+};
+
+//-----------------------------------------------------------------------------
+
+void CsvIngestTests::CsvIngest_Dataserver()
+{
+    std::vector<csv_observation> results;
+    read_csv(g_dump, strlen(g_dump), results);
+    Assert::AreEqual(size_t(4), results.size());
+
+    Assert::AreEqual(std::string("KSFO"), results[0].report.identifier);
+    Assert::IsTrue(static_cast<bool>(results[0].position));
+    Assert::AreEqual(37.62, results[0].position->latitude);
+    Assert::AreEqual(-122.37, results[0].position->longitude);
+    Assert::AreEqual(3.0, *results[0].elevation);
+
+    // Quoted fields
+    Assert::AreEqual(std::string("EGLL 121750Z 27012KT 9999 SCT020 08/07 Q1002"), results[1].report.raw_data);
+    Assert::AreEqual(51.48, results[1].position->latitude);
+    Assert::AreEqual(24.0, *results[1].elevation);
+
+    // Missing latitude and elevation
+    Assert::AreEqual(std::string("KPDX"), results[2].report.identifier);
+    Assert::IsFalse(static_cast<bool>(results[2].position));
+    Assert::IsFalse(static_cast<bool>(results[2].elevation));
+
+    // The row without raw text is skipped; an elevation that is not a number
+    // is left unset
+    Assert::AreEqual(std::string("CYYZ"), results[3].report.identifier);
+    Assert::AreEqual(-79.63, results[3].position->longitude);
+    Assert::IsFalse(static_cast<bool>(results[3].elevation));
+
+    // Appends to what the results already hold
+    read_csv(g_dump, strlen(g_dump), results);
+    Assert::AreEqual(size_t(8), results.size());
+    Assert::AreEqual(std::string("KSFO"), results[4].report.identifier);
+
+    const char* headerless = "KSFO 121756Z 28010KT 10SM FEW015 18/09 A3001,37.62,-122.37\n";
+    Assert::ExpectException<aw_exception>([&]() { read_csv(headerless, strlen(headerless), results); });
+    Assert::ExpectException<aw_exception>([&]() { read_csv("", 0, results); });
+}
+
+//-----------------------------------------------------------------------------
+
+void CsvIngestTests::CsvIngest_Quoting()
+{
+    const char* text =
+        "\"station, name\",\"raw_text\",latitude,longitude\r\n"
+        "\"San Francisco, \"\"SFO\"\"\",\"KSFO 121756Z 28010KT 10SM FEW015 18/09 A3001 RMK \"\"A\"\", B\",1.5,2.5\r\n"
+        "\"Line\r\nbreaks\",KOAK 121753Z 30008KT 10SM CLR 17/08 A3002,-1,-2\r\n"
+        "Portland,KPDX 121753Z 32007KT 10SM BKN030 10/09 A3000,3,4";
+
+    std::vector<csv_observation> results;
+    read_csv(text, strlen(text), results);
+    Assert::AreEqual(size_t(3), results.size());
+
+    Assert::AreEqual(std::string("KSFO 121756Z 28010KT 10SM FEW015 18/09 A3001 RMK \"A\", B"), results[0].report.raw_data);
+    Assert::AreEqual(1.5, results[0].position->latitude);
+    Assert::AreEqual(std::string("KOAK"), results[1].report.identifier);
+    Assert::AreEqual(-2.0, results[1].position->longitude);
+
+    // The last row needs no line break
+    Assert::AreEqual(std::string("KPDX 121753Z 32007KT 10SM BKN030 10/09 A3000"), results[2].report.raw_data);
+    Assert::AreEqual(4.0, results[2].position->longitude);
+}
+
+//-----------------------------------------------------------------------------
+
+void CsvIngestTests::CsvIngest_Columns()
+{
+    const char* text =
+        "report,lat,lon,height\n"
+        "KSFO 121756Z 28010KT 10SM FEW015 18/09 A3001,37.62,-122.37,3\n";
+
+    csv_columns columns;
+    columns.raw_text = "report";
+    columns.latitude = "lat";
+    columns.longitude = "lon";
+
+    std::vector<csv_observation> results;
+    read_csv(text, strlen(text), results, 1, columns);
+    Assert::AreEqual(size_t(1), results.size());
+    Assert::AreEqual(37.62, results[0].position->latitude);
+    Assert::IsFalse(static_cast<bool>(results[0].elevation));
+
+    // Without the raw text column the header row is not found
+    Assert::ExpectException<aw_exception>([&]() { read_csv(text, strlen(text), results); });
+}
+
+//-----------------------------------------------------------------------------
+
+void CsvIngestTests::CsvIngest_Parallel()
+{
+    const size_t rows = 12000;
+    auto text = make_dump(rows);
+
+    std::vector<csv_observation> expected;
+    read_csv(text.data(), text.size(), expected, 1);
+    Assert::AreEqual(rows, expected.size());
+
+    // Every split gives the rows of a single thread, in the same order
+    for (unsigned threads : { 2u, 3u, 5u, 8u, 0u })
+    {
+        std::vector<csv_observation> actual;
+        read_csv(text.data(), text.size(), actual, threads);
+        Assert::AreEqual(expected.size(), actual.size());
+
+        for (size_t i = 0; i < rows; ++i)
+        {
+            Assert::AreEqual(expected[i].report.raw_data, actual[i].report.raw_data);
+            Assert::AreEqual(expected[i].position->latitude, actual[i].position->latitude);
+            Assert::AreEqual(expected[i].position->longitude, actual[i].position->longitude);
+            Assert::AreEqual(static_cast<double>(i), *actual[i].elevation);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void CsvIngestTests::CsvIngest_File()
+{
+    const std::string path = "csv_ingest_test.csv";
+    auto text = make_dump(3000);
+
+    auto file = fopen(path.c_str(), "wb");
+    Assert::IsTrue(file != nullptr);
+    fwrite(text.data(), 1, text.size(), file);
+    fclose(file);
+
+    std::vector<csv_observation> expected;
+    std::vector<csv_observation> actual;
+    read_csv(text.data(), text.size(), expected, 1);
+    read_csv_file(path, actual);
+    Assert::AreEqual(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        Assert::AreEqual(expected[i].report.raw_data, actual[i].report.raw_data);
+    }
+
+    // An empty file has no header row
+    file = fopen(path.c_str(), "wb");
+    fclose(file);
+    Assert::ExpectException<aw_exception>([&]() { read_csv_file(path, actual); });
+
+    std::remove(path.c_str());
+    Assert::ExpectException<aw_exception>([&]() { read_csv_file(path, actual); });
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
@@ -0,0 +1,175 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <AviationWeather/derived_quantities.h>
+#include <AviationWeather/metar.h>
+
+#include "batch_helpers.h"
+#include "framework.h"
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(DerivedQuantitiesTests)
+{
+public:
+    TEST_METHOD(Derived_Scalar);
+    TEST_METHOD(Derived_BatchMatchesScalar);
+    TEST_METHOD(Derived_BatchMissingValues);
+    TEST_METHOD(Derived_MetarAccessors);
+};
+
+//-----------------------------------------------------------------------------
+
+void DerivedQuantitiesTests::Derived_Scalar()
+{
+    Assert::AreEqual(100.0, relative_humidity(25.0, 25.0), 1e-9);
+    Assert::AreEqual(52.54, relative_humidity(20.0, 10.0), 0.01);
+
+    // The standard atmosphere
+    Assert::AreEqual(0.0, pressure_altitude(1013.25, 0.0), 1e-6);
+    Assert::AreEqual(5000.0, pressure_altitude(1013.25, 5000.0), 1.0);
+    Assert::AreEqual(364.0, pressure_altitude(1000.0, 0.0), 1.0);
+    Assert::AreEqual(0.0, density_altitude(1013.25, 0.0, 15.0), 20.0);
+    Assert::AreEqual(5000.0, density_altitude(1013.25, 5000.0, 5.1), 25.0);
+
+    // A hot day at a high field
+    Assert::AreEqual(7821.0, density_altitude(1013.25, 5000.0, 30.0), 1.0);
+
+    Assert::AreEqual(-20.43, wind_chill(-10.0, 20.0), 0.01);
+    Assert::AreEqual(15.0, wind_chill(15.0, 20.0));
+    Assert::AreEqual(-10.0, wind_chill(-10.0, 2.0));
+
+    Assert::AreEqual(40.41, heat_index(32.0, 70.0), 0.01);
+    Assert::AreEqual(19.36, heat_index(20.0, 50.0), 0.01);
+}
+
+//-----------------------------------------------------------------------------
+
+void DerivedQuantitiesTests::Derived_BatchMatchesScalar()
+{
+    std::mt19937 random(1);
+    auto temperature = random_column(random, -40.0f, 45.0f);
+    auto spread = random_column(random, 0.0f, 20.0f);
+    auto altimeter = random_column(random, 960.0f, 1050.0f);
+    auto elevation = random_column(random, -200.0f, 14000.0f);
+    auto windSpeed = random_column(random, 0.0f, 60.0f);
+    auto humidity = random_column(random, 5.0f, 100.0f);
+
+    std::vector<float> dewpoint(g_columnSize);
+    for (size_t i = 0; i < g_columnSize; ++i)
+    {
+        dewpoint[i] = temperature[i] - spread[i];
+    }
+
+    std::vector<float> results;
+    relative_humidity(temperature, dewpoint, results);
+    check_batch(results, 1e-3, [&](size_t i) { return relative_humidity(temperature[i], dewpoint[i]); });
+
+    dewpoint_depression(temperature, dewpoint, results);
+    check_batch(results, 1e-5, [&](size_t i) { return static_cast<double>(temperature[i]) - dewpoint[i]; });
+
+    pressure_altitude(altimeter, elevation, results);
+    check_batch(results, 1.0, [&](size_t i) { return pressure_altitude(altimeter[i], elevation[i]); });
+
+    density_altitude(altimeter, elevation, temperature, results);
+    check_batch(results, 1.0, [&](size_t i) { return density_altitude(altimeter[i], elevation[i], temperature[i]); });
+
+    wind_chill(temperature, windSpeed, results);
+    check_batch(results, 1e-3, [&](size_t i) { return wind_chill(temperature[i], windSpeed[i]); });
+
+    heat_index(temperature, humidity, results);
+    check_batch(results, 1e-3, [&](size_t i) { return heat_index(temperature[i], humidity[i]); });
+
+    temperature.pop_back();
+    Assert::ExpectException<aw_exception>([&]() { heat_index(temperature, humidity, results); });
+}
+
+//-----------------------------------------------------------------------------
+
+void DerivedQuantitiesTests::Derived_BatchMissingValues()
+{
+    auto missing = std::numeric_limits<float>::quiet_NaN();
+    std::vector<float> temperature = { 20.0f, missing, -5.0f, 35.0f, -12.0f };
+    std::vector<float> dewpoint = { 10.0f, 5.0f, missing, 30.0f, -15.0f };
+    std::vector<float> windSpeed = { 10.0f, 10.0f, 10.0f, 10.0f, missing };
+
+    std::vector<float> results;
+    relative_humidity(temperature, dewpoint, results);
+    Assert::IsFalse(std::isnan(results[0]));
+    Assert::IsTrue(std::isnan(results[1]));
+    Assert::IsTrue(std::isnan(results[2]));
+    Assert::IsFalse(std::isnan(results[3]));
+
+    wind_chill(temperature, windSpeed, results);
+    Assert::IsTrue(std::isnan(results[1]));
+    Assert::IsFalse(std::isnan(results[2]));
+    Assert::IsTrue(std::isnan(results[4]));
+
+    std::vector<float> humidity(temperature.size(), missing);
+    heat_index(temperature, humidity, results);
+    for (auto value : results)
+    {
+        Assert::IsTrue(std::isnan(value));
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void DerivedQuantitiesTests::Derived_MetarAccessors()
+{
+    aw::metar m("KDEN 121853Z 20015KT 10SM FEW080 32/04 A3001");
+
+    Assert::AreEqual(relative_humidity(32.0, 4.0), m.relative_humidity(), 1e-9);
+    Assert::AreEqual(pressure_altitude(30.01 * 33.86389, 5434.0), m.pressure_altitude(5434.0), 1.0);
+    Assert::AreEqual(density_altitude(30.01 * 33.86389, 5434.0, 32.0), m.density_altitude(5434.0), 1e-6);
+    Assert::AreEqual(32.0, m.wind_chill());
+    Assert::AreEqual(heat_index(32.0, m.relative_humidity()), m.heat_index(), 1e-9);
+    Assert::IsTrue(m.density_altitude(5434.0) > 8000.0);
+
+    aw::metar_view view(m.raw_data);
+    Assert::AreEqual(m.density_altitude(5434.0), view.density_altitude(5434.0));
+
+    // MPS winds are converted to knots
+    aw::metar cold("UUEE 121030Z 24010MPS 9999 BKN020 M15/M18 Q1015");
+    Assert::AreEqual(wind_chill(-15.0, 10 * 3600.0 / 1852.0), cold.wind_chill(), 1e-6);
+
+    aw::metar missing("KDEN 121853Z 20015KT 10SM FEW080 A3001");
+    Assert::ExpectException<aw_exception>([&]() { missing.density_altitude(5434.0); });
+    Assert::ExpectException<aw_exception>([&]() { missing.heat_index(); });
+    Assert::ExpectException<aw_exception>([&]() { aw::metar_view(missing.raw_data).heat_index(); });
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
@@ -66,6 +66,9 @@ DEFINE_ENUM_TOSTRING_GROUP(aw::metar_report_type)
 DEFINE_ENUM_TOSTRING_GROUP(aw::metar_modifier_type)
 DEFINE_ENUM_TOSTRING_GROUP(aw::runway_designator_type)
 DEFINE_ENUM_TOSTRING_GROUP(aw::visibility_modifier_type)
+DEFINE_ENUM_TOSTRING_GROUP(aw::rvr_tendency)
+DEFINE_ENUM_TOSTRING_GROUP(aw::compass_direction)
+DEFINE_ENUM_TOSTRING_GROUP(aw::metar_trend_type)
 
 } // namespace CppUnitTestFramework
 } // namespace VisualStudio
@@ -0,0 +1,176 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <thread>
+#include <vector>
+
+#include <AviationWeather/interning.h>
+#include <AviationWeather/metar.h>
+
+#include "framework.h"
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(InterningTests)
+{
+public:
+    TEST_METHOD(Interning_Weather);
+    TEST_METHOD(Interning_CloudLayer);
+    TEST_METHOD(Interning_Groups);
+    TEST_METHOD(Interning_Concurrent);
+};
+
+//-----------------------------------------------------------------------------
+
+void InterningTests::Interning_Weather()
+{
+    aw::metar m1("KSTS 181253Z AUTO 00000KT 10SM -RA HZ FU OVC007 14/12 A2990 RMK AO2");
+    aw::metar m2("KSTS 181353Z AUTO 00000KT 10SM -RA BR OVC005 14/13 A2990 RMK AO2");
+
+    auto lightRain1 = intern(m1.weather_group[0]);
+    auto haze = intern(m1.weather_group[1]);
+    auto smoke = intern(m1.weather_group[2]);
+    auto lightRain2 = intern(m2.weather_group[0]);
+    auto mist = intern(m2.weather_group[1]);
+
+    Assert::IsTrue(lightRain1 == lightRain2);
+    Assert::IsTrue(lightRain1 != haze);
+    Assert::IsTrue(haze != smoke);
+    Assert::IsTrue(smoke != mist);
+
+    Assert::IsTrue(m1.weather_group[0] == resolve(lightRain1));
+    Assert::IsTrue(m1.weather_group[1] == resolve(haze));
+    Assert::IsTrue(m2.weather_group[1] == resolve(mist));
+
+    Assert::IsTrue(find_interned(m2.weather_group[1]) == mist);
+
+    weather heavySnow;
+    heavySnow.intensity = weather_intensity::heavy;
+    heavySnow.descriptor = weather_descriptor::blowing;
+    heavySnow.phenomena.push_back(weather_phenomena::snow);
+    heavySnow.phenomena.push_back(weather_phenomena::ice_pellets);
+    Assert::IsFalse(static_cast<bool>(find_interned(heavySnow)));
+
+    auto count = interned_weather_count();
+    auto heavySnowId = intern(heavySnow);
+    Assert::AreEqual(count + 1, interned_weather_count());
+    Assert::IsTrue(find_interned(heavySnow) == heavySnowId);
+    Assert::IsTrue(heavySnow == resolve(heavySnowId));
+}
+
+//-----------------------------------------------------------------------------
+
+void InterningTests::Interning_CloudLayer()
+{
+    aw::metar m1("KSFO 102356Z 27019G24KT 10SM FEW008 SCT012 BKN015 21/14 A2994");
+    aw::metar m2("KOAK 102353Z 27016KT 10SM FEW008 BKN015CB 20/13 A2995");
+
+    auto few1 = intern(m1.sky_condition_group[0]);
+    auto few2 = intern(m2.sky_condition_group[0]);
+    auto broken = intern(m1.sky_condition_group[2]);
+    auto brokenCb = intern(m2.sky_condition_group[1]);
+
+    Assert::IsTrue(few1 == few2);
+    Assert::IsTrue(broken != brokenCb);
+    Assert::IsTrue(m2.sky_condition_group[1] == resolve(brokenCb));
+    Assert::AreEqual(uint32_t(1500), resolve(broken).layer_height);
+    Assert::AreEqual(sky_cover_cloud_type::cumulonimbus, resolve(brokenCb).cloud_type);
+
+    Assert::ExpectException<aw_exception>([]()
+    {
+        resolve(static_cast<cloud_layer_id>(UINT16_MAX));
+    });
+}
+
+//-----------------------------------------------------------------------------
+
+void InterningTests::Interning_Groups()
+{
+    aw::metar m1("KORD 190151Z 19010KT 5SM TSRA BR FEW027 BKN048CB OVC090 21/19 A2971");
+
+    std::vector<weather_id> weatherIds;
+    std::vector<cloud_layer_id> cloudIds;
+    intern(m1.weather_group, weatherIds);
+    intern(m1.sky_condition_group, cloudIds);
+
+    Assert::AreEqual(m1.weather_group.size(), weatherIds.size());
+    Assert::AreEqual(m1.sky_condition_group.size(), cloudIds.size());
+
+    for (size_t i = 0; i < weatherIds.size(); ++i)
+    {
+        Assert::IsTrue(m1.weather_group[i] == resolve(weatherIds[i]));
+    }
+    for (size_t i = 0; i < cloudIds.size(); ++i)
+    {
+        Assert::IsTrue(m1.sky_condition_group[i] == resolve(cloudIds[i]));
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void InterningTests::Interning_Concurrent()
+{
+    const uint32_t threadCount = 8;
+    const uint32_t layerCount = 500;
+
+    std::vector<std::vector<cloud_layer_id>> results(threadCount);
+    std::vector<std::thread> threads;
+
+    for (uint32_t t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&results, t, layerCount]()
+        {
+            for (uint32_t i = 0; i < layerCount; ++i)
+            {
+                cloud_layer layer;
+                layer.sky_cover = sky_cover_type::overcast;
+                layer.layer_height = 100000 + (((i + t * 37) % layerCount) * 100);
+                results[t].push_back(intern(layer));
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (uint32_t t = 0; t < threadCount; ++t)
+    {
+        for (uint32_t i = 0; i < layerCount; ++i)
+        {
+            auto height = 100000 + (((i + t * 37) % layerCount) * 100);
+            Assert::AreEqual(height, resolve(results[t][i]).layer_height);
+            Assert::IsTrue(results[t][i] == results[0][(i + t * 37) % layerCount]);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
@@ -0,0 +1,279 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <AviationWeather/json_writer.h>
+#include <AviationWeather/metar.h>
+
+#include <JSON/json.h>
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace nlohmann;
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+// Reports covering the groups that the expectation file does not
+const char* g_reports[] =
+{
+    "SPECI KPDX 041453Z 32007KT 1 1/2SM R10R/3000VP6000FT BR BKN003 OVC010 10/09 A3000 RMK AO2 SFC VIS 4",
+    "KORD 190151Z COR 19010G25KT 150V220 5SM TSRA BR FEW027 BKN048CB OVC090 21/19 A2971 RMK AO2 PK WND 18028/0112",
+    "EGLL 121050Z 27012KT 4000 1500SW BR SCT008 BKN012 08/07 Q1002 RERA WS R27L BECMG FM1130 TL1230 9999 NSW SCT020",
+    "LFPG 121030Z 24005MPS 200V280 CAVOK M02/M05 Q1015 TEMPO AT1100 3000 SHRA BKN010CB",
+    "EDDF 121020Z 06008KT R25L/0800U R25R/P1500N 0600 FG NSC 02/02 Q1025 WS ALL RWY NOSIG"
+};
+
+json to_json(metar const& report)
+{
+    std::string text;
+    write_json(report, text);
+    return json::parse(text);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(JsonWriterTests)
+{
+public:
+    TEST_METHOD(JsonWriter_Expectations);
+    TEST_METHOD(JsonWriter_Groups);
+    TEST_METHOD(JsonWriter_Escaping);
+    TEST_METHOD(JsonWriter_FixedBuffer);
+    TEST_METHOD(JsonWriter_Batch);
+};
+
+//-----------------------------------------------------------------------------
+
+// The output of every report in the expectation file matches its expectation,
+// which lists report_type and unlimited layer heights only sometimes, and
+// remarks as a flag
+void JsonWriterTests::JsonWriter_Expectations()
+{
+    std::wstring resourcesPath(RESOURCES_DIR);
+    std::ifstream stream(resourcesPath + L"metar.json");
+    std::stringstream buffer;
+    buffer << stream.rdbuf();
+
+    auto tests = json::parse(buffer.str())["tests"];
+    Assert::IsTrue(tests.size() > 0);
+
+    for (auto test : tests)
+    {
+        if (test.find("broken") != test.end())
+        {
+            continue;
+        }
+
+        auto actual = to_json(metar(test["string"].get<std::string>()));
+
+        if (test.find("report_type") == test.end())
+        {
+            test["report_type"] = "metar";
+        }
+        if (test.find("remarks") != test.end())
+        {
+            Assert::AreEqual(test["remarks"].get<bool>(), actual.find("remarks") != actual.end());
+            test.erase("remarks");
+            actual.erase("remarks");
+        }
+        if (test.find("sky_condition") != test.end())
+        {
+            for (auto& layer : test["sky_condition"])
+            {
+                if (layer.find("layer_height") != layer.end() && layer["layer_height"] == UINT32_MAX)
+                {
+                    layer.erase("layer_height");
+                }
+            }
+        }
+
+        Assert::AreEqual(test.dump(), actual.dump());
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void JsonWriterTests::JsonWriter_Groups()
+{
+    auto speci = to_json(metar(g_reports[0]));
+    Assert::AreEqual(std::string("special"), speci["report_type"].get<std::string>());
+    Assert::AreEqual(1.5, speci["visibility"]["distance"].get<double>());
+    Assert::AreEqual(std::string("right"), speci["runway_visual_range"][0]["runway_designator"].get<std::string>());
+    Assert::AreEqual(6000, speci["runway_visual_range"][0]["visibility_max"].get<int>());
+    Assert::AreEqual(std::string("greater_than"), speci["runway_visual_range"][0]["visibility_max_modifier"].get<std::string>());
+    Assert::AreEqual(std::string("AO2 SFC VIS 4"), speci["remarks"].get<std::string>());
+
+    auto corrected = to_json(metar(g_reports[1]));
+    Assert::AreEqual(std::string("corrected"), corrected["report_modifier"].get<std::string>());
+    Assert::AreEqual(25, corrected["wind"]["gust_speed"].get<int>());
+    Assert::AreEqual(150, corrected["wind"]["variation_lower"].get<int>());
+    Assert::AreEqual(220, corrected["wind"]["variation_upper"].get<int>());
+    Assert::AreEqual(std::string("cumulonimbus"), corrected["sky_condition"][1]["cloud_type"].get<std::string>());
+
+    auto egll = to_json(metar(g_reports[2]));
+    Assert::AreEqual(std::string("south_west"), egll["minimum_visibility"]["direction"].get<std::string>());
+    Assert::AreEqual(1500, egll["minimum_visibility"]["distance"].get<int>());
+    Assert::AreEqual(std::string("hPa"), egll["altimeter"]["unit"].get<std::string>());
+    Assert::AreEqual(1002, egll["altimeter"]["pressure"].get<int>());
+    Assert::AreEqual(std::string("rain"), egll["recent_weather"][0]["phenomena"][0].get<std::string>());
+    Assert::AreEqual(false, egll["wind_shear"][0]["all_runways"].get<bool>());
+    Assert::AreEqual(27, egll["wind_shear"][0]["runway_number"].get<int>());
+    Assert::AreEqual(std::string("left"), egll["wind_shear"][0]["runway_designator"].get<std::string>());
+    Assert::AreEqual(std::string("becoming"), egll["trend"][0]["type"].get<std::string>());
+    Assert::AreEqual(11, egll["trend"][0]["from"]["hour_of_day"].get<int>());
+    Assert::AreEqual(30, egll["trend"][0]["until"]["minute_of_hour"].get<int>());
+    Assert::AreEqual(true, egll["trend"][0]["no_significant_weather"].get<bool>());
+    Assert::AreEqual(std::string("scattered"), egll["trend"][0]["sky_condition"][0]["sky_cover"].get<std::string>());
+
+    auto lfpg = to_json(metar(g_reports[3]));
+    Assert::AreEqual(std::string("mps"), lfpg["wind"]["unit"].get<std::string>());
+    Assert::AreEqual(-2, lfpg["temperature_dewpoint"]["temperature"].get<int>());
+    Assert::AreEqual(-5, lfpg["temperature_dewpoint"]["dewpoint"].get<int>());
+    Assert::AreEqual(std::string("temporary"), lfpg["trend"][0]["type"].get<std::string>());
+    Assert::AreEqual(11, lfpg["trend"][0]["at"]["hour_of_day"].get<int>());
+    Assert::AreEqual(std::string("showers"), lfpg["trend"][0]["weather"][0]["descriptor"].get<std::string>());
+    Assert::IsTrue(lfpg.find("remarks") == lfpg.end());
+
+    auto eddf = to_json(metar(g_reports[4]));
+    auto rvr = eddf["runway_visual_range"];
+    Assert::AreEqual(std::string("metres"), rvr[0]["unit"].get<std::string>());
+    Assert::AreEqual(800, rvr[0]["visibility_min"].get<int>());
+    Assert::AreEqual(std::string("upward"), rvr[0]["tendency"].get<std::string>());
+    Assert::AreEqual(800, rvr[0]["visibility_max"].get<int>());
+    Assert::AreEqual(std::string("greater_than"), rvr[1]["visibility_min_modifier"].get<std::string>());
+    Assert::AreEqual(std::string("no_change"), rvr[1]["tendency"].get<std::string>());
+    Assert::AreEqual(true, eddf["wind_shear"][0]["all_runways"].get<bool>());
+    Assert::AreEqual(std::string("no_significant_cloud"), eddf["sky_condition"][0]["sky_cover"].get<std::string>());
+    Assert::AreEqual(size_t(1), eddf["sky_condition"][0].size());
+    Assert::AreEqual(std::string("no_significant_change"), eddf["trend"][0]["type"].get<std::string>());
+
+    // Views write the same output as the reports they were parsed from
+    for (auto text : g_reports)
+    {
+        std::string owned;
+        std::string viewed;
+        write_json(metar(text), owned);
+        write_json(metar_view(text), viewed);
+        Assert::AreEqual(owned, viewed);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void JsonWriterTests::JsonWriter_Escaping()
+{
+    metar report(g_reports[0]);
+    report.raw_data = "quote \" backslash \\ tab \t newline \n bell \x07";
+    report.remarks = "\x1F";
+
+    std::string text;
+    write_json(report, text);
+    Assert::IsTrue(text.find('\n') == std::string::npos);
+    Assert::IsTrue(text.find("\\u0007") != std::string::npos);
+    Assert::IsTrue(text.find("\\u001f") != std::string::npos);
+
+    auto value = json::parse(text);
+    Assert::AreEqual(report.raw_data, value["string"].get<std::string>());
+    Assert::AreEqual(report.remarks, value["remarks"].get<std::string>());
+
+    // Values that are not exact decimals keep every digit
+    report.visibility_group->distance = 1.0 / 3.0;
+    report.altimeter_group->pressure = -29.92;
+    value = to_json(report);
+    Assert::AreEqual(1.0 / 3.0, value["visibility"]["distance"].get<double>());
+    Assert::AreEqual(-29.92, value["altimeter"]["pressure"].get<double>());
+}
+
+//-----------------------------------------------------------------------------
+
+void JsonWriterTests::JsonWriter_FixedBuffer()
+{
+    metar report(g_reports[2]);
+
+    std::string expected;
+    write_json(report, expected);
+
+    std::vector<char> buffer(expected.size() + 1, '#');
+    auto size = write_json(report, buffer.data(), buffer.size());
+    Assert::AreEqual(expected.size(), size);
+    Assert::AreEqual(expected, std::string(buffer.data(), size));
+    Assert::AreEqual('#', buffer[size]);
+
+    // A short buffer receives what fits and the size that would be needed
+    std::fill(buffer.begin(), buffer.end(), '#');
+    size = write_json(report, buffer.data(), 40);
+    Assert::AreEqual(expected.size(), size);
+    Assert::AreEqual(expected.substr(0, 40), std::string(buffer.data(), 40));
+    Assert::AreEqual('#', buffer[40]);
+
+    Assert::AreEqual(expected.size(), write_json(report, nullptr, 0));
+}
+
+//-----------------------------------------------------------------------------
+
+void JsonWriterTests::JsonWriter_Batch()
+{
+    std::vector<metar> reports;
+    for (size_t i = 0; i < 12; ++i)
+    {
+        reports.emplace_back(g_reports[i % (sizeof(g_reports) / sizeof(g_reports[0]))]);
+    }
+
+    // Appends after what the buffer already holds
+    std::string text = "header\n";
+    write_json(reports, text);
+    Assert::AreEqual('\n', text.back());
+
+    std::istringstream lines(text);
+    std::string line;
+    std::getline(lines, line);
+    Assert::AreEqual(std::string("header"), line);
+
+    size_t count = 0;
+    while (std::getline(lines, line))
+    {
+        std::string expected;
+        write_json(reports[count], expected);
+        Assert::AreEqual(expected, line);
+        Assert::AreEqual(reports[count].raw_data, json::parse(line)["string"].get<std::string>());
+        ++count;
+    }
+    Assert::AreEqual(reports.size(), count);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
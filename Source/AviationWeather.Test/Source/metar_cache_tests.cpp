@@ -0,0 +1,222 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <AviationWeather/metar_cache.h>
+
+#include "framework.h"
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+const char* g_reports[] =
+{
+    "METAR KSFO 172256Z 00000KT 9SM CLR 19/04 A3012",
+    "KRHV 122047Z 32009KT 10SM SKC 28/11 A3002",
+    "KEDU 181255Z AUTO 9SM CLR 15/11 A2982 RMK AO1",
+    "KSTS 181253Z AUTO 00000KT 10SM -RA HZ FU OVC007 14/12 A2990 RMK AO2 RAB30 SLP116 P0000 T01390122",
+    "KORD 190151Z 19010KT 5SM TSRA BR FEW027 BKN048CB OVC090 21/19 A2971 RMK AO2 PK WND 18028/0112 SLP057",
+    "KPDX 041453Z 32007KT 1SM R10R/3000VP6000FT BR BKN003 OVC010 10/09 A3000 RMK AO2 SFC VIS 4",
+    "KWVI 171453Z AUTO 00000KT 1/4SM FG VV002 16/15 A2989 RMK AO2 SLP119 T01610150 53007",
+    "CYYZ 011800Z 27015G25KT 15SM FEW040 M01/M03 A3012"
+};
+
+const size_t g_reportCount = sizeof(g_reports) / sizeof(g_reports[0]);
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(MetarCacheTests)
+{
+public:
+    TEST_METHOD(MetarCache_Hit);
+    TEST_METHOD(MetarCache_Find);
+    TEST_METHOD(MetarCache_Eviction);
+    TEST_METHOD(MetarCache_Clear);
+    TEST_METHOD(MetarCache_Concurrent);
+};
+
+//-----------------------------------------------------------------------------
+
+void MetarCacheTests::MetarCache_Hit()
+{
+    metar_cache cache(1024 * 1024);
+
+    auto m1 = cache.parse(g_reports[0]);
+    auto m2 = cache.parse(g_reports[0]);
+    auto m3 = cache.parse(g_reports[1]);
+
+    Assert::IsTrue(m1 == m2);
+    Assert::IsTrue(m1 != m3);
+    Assert::IsTrue(*m1 == aw::metar(g_reports[0]));
+    Assert::IsTrue(*m3 == aw::metar(g_reports[1]));
+
+    auto statistics = cache.statistics();
+    Assert::AreEqual(uint64_t(1), statistics.hits);
+    Assert::AreEqual(uint64_t(2), statistics.misses);
+    Assert::AreEqual(uint64_t(2), statistics.insertions);
+    Assert::AreEqual(uint64_t(0), statistics.evictions);
+    Assert::AreEqual(size_t(2), statistics.entries);
+    Assert::IsTrue(statistics.bytes > 0);
+}
+
+//-----------------------------------------------------------------------------
+
+void MetarCacheTests::MetarCache_Find()
+{
+    metar_cache cache(1024 * 1024);
+
+    Assert::IsFalse(static_cast<bool>(cache.find(g_reports[0])));
+    cache.parse(g_reports[0]);
+    Assert::IsTrue(static_cast<bool>(cache.find(g_reports[0])));
+    Assert::IsFalse(static_cast<bool>(cache.find(g_reports[1])));
+
+    Assert::ExpectException<aw_exception>([]() { metar_cache(1024, 0); });
+}
+
+//-----------------------------------------------------------------------------
+
+void MetarCacheTests::MetarCache_Eviction()
+{
+    // A single shard with room for a handful of reports
+    metar_cache sizing(1024 * 1024, 1);
+    sizing.parse(g_reports[0]);
+    auto entrySize = sizing.statistics().bytes;
+
+    metar_cache cache(entrySize * 3, 1);
+    for (size_t i = 0; i < g_reportCount; ++i)
+    {
+        cache.parse(g_reports[i]);
+    }
+
+    auto statistics = cache.statistics();
+    Assert::IsTrue(statistics.evictions > 0);
+    Assert::IsTrue(statistics.bytes <= cache.memory_limit());
+    Assert::AreEqual(statistics.insertions - statistics.evictions, uint64_t(statistics.entries));
+
+    // The most recently used report is retained, the oldest is evicted
+    Assert::IsTrue(static_cast<bool>(cache.find(g_reports[g_reportCount - 1])));
+    Assert::IsFalse(static_cast<bool>(cache.find(g_reports[0])));
+
+    // A report larger than the whole budget is returned but not cached
+    metar_cache tiny(16, 1);
+    auto m = tiny.parse(g_reports[0]);
+    Assert::IsTrue(*m == aw::metar(g_reports[0]));
+    Assert::AreEqual(size_t(0), tiny.statistics().entries);
+
+    // Recent weather, wind shear and the groups of each trend count too
+    metar_cache plain(1024 * 1024, 1);
+    plain.parse("EGLL 121050Z 27012KT 4000 BR BKN012 08/07 Q1002");
+    metar_cache international(1024 * 1024, 1);
+    international.parse("EGLL 121050Z 27012KT 4000 BR BKN012 08/07 Q1002 RERA WS R27L BECMG FM1130 9999 -SHRA SCT020");
+    Assert::IsTrue(international.statistics().bytes >= plain.statistics().bytes +
+        2 * sizeof(weather) + sizeof(runway_wind_shear) + sizeof(metar_trend) + sizeof(cloud_layer));
+}
+
+//-----------------------------------------------------------------------------
+
+void MetarCacheTests::MetarCache_Clear()
+{
+    metar_cache cache(1024 * 1024);
+    for (auto report : g_reports)
+    {
+        cache.parse(report);
+    }
+
+    auto m = cache.find(g_reports[0]);
+    cache.clear();
+
+    auto statistics = cache.statistics();
+    Assert::AreEqual(size_t(0), statistics.entries);
+    Assert::AreEqual(size_t(0), statistics.bytes);
+
+    // Reports handed out before clearing remain valid
+    Assert::IsTrue(*m == aw::metar(g_reports[0]));
+    Assert::IsFalse(static_cast<bool>(cache.find(g_reports[0])));
+}
+
+//-----------------------------------------------------------------------------
+
+void MetarCacheTests::MetarCache_Concurrent()
+{
+    std::vector<aw::metar> expected;
+    for (auto report : g_reports)
+    {
+        expected.emplace_back(report);
+    }
+
+    metar_cache cache(1024 * 1024, 4);
+
+    const size_t threadCount = 4;
+    std::vector<std::thread> threads;
+    std::vector<int> results(threadCount, 1);
+
+    for (size_t t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&cache, &expected, &results, t]()
+        {
+            for (size_t pass = 0; pass < 10; ++pass)
+            {
+                for (size_t i = 0; i < expected.size(); ++i)
+                {
+                    auto index = (i + t) % expected.size();
+                    auto m = cache.parse(g_reports[index]);
+                    if (!(*m == expected[index]))
+                    {
+                        results[t] = 0;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (auto result : results)
+    {
+        Assert::IsTrue(result != 0);
+    }
+
+    auto statistics = cache.statistics();
+    Assert::AreEqual(uint64_t(threadCount * 10 * expected.size()), statistics.hits + statistics.misses);
+    Assert::AreEqual(size_t(expected.size()), statistics.entries);
+    Assert::AreEqual(uint64_t(expected.size()), statistics.insertions);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
@@ -0,0 +1,137 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <string>
+
+#include <AviationWeather/metar.h>
+#include <AviationWeather/metar_diff.h>
+
+#include "framework.h"
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(MetarDiffTests)
+{
+public:
+    TEST_METHOD(MetarDiff_NoChange);
+    TEST_METHOD(MetarDiff_Changes);
+    TEST_METHOD(MetarDiff_TemperatureDewpoint);
+    TEST_METHOD(MetarDiff_Move);
+};
+
+//-----------------------------------------------------------------------------
+
+void MetarDiffTests::MetarDiff_NoChange()
+{
+    aw::metar m1("KSFO 172256Z 00000KT 9SM CLR 19/04 A3012 RMK AO2");
+    aw::metar m2("METAR KSFO 172256Z 00000KT 9SM CLR 19/04 A3012 RMK AO2");
+
+    auto d = diff(m1, m2);
+
+    Assert::IsTrue(d.empty());
+    Assert::AreEqual(uint16_t(0), d.mask);
+    Assert::IsFalse(static_cast<bool>(d.sky_condition_group));
+    Assert::IsFalse(static_cast<bool>(d.remarks));
+}
+
+//-----------------------------------------------------------------------------
+
+void MetarDiffTests::MetarDiff_Changes()
+{
+    aw::metar m1("KRHV 112150Z 22512G15KT 10SM SKC 27/13 A2990");
+    aw::metar m2("KRHV 112250Z 31015KT 3SM -RA BKN008 OVC020 27/13 A2990");
+
+    auto d = diff(m1, m2);
+
+    Assert::IsFalse(d.empty());
+    auto expected = element_mask(metar_element_type::observation_time) |
+        element_mask(metar_element_type::wind) |
+        element_mask(metar_element_type::visibility) |
+        element_mask(metar_element_type::weather) |
+        element_mask(metar_element_type::sky_condition);
+    Assert::AreEqual(static_cast<uint16_t>(expected), d.mask);
+
+    Assert::IsTrue(d.changed(metar_element_type::wind));
+    Assert::IsFalse(d.changed(metar_element_type::altimeter));
+    Assert::IsFalse(d.changed(metar_element_type::temperature_dewpoint));
+    Assert::IsFalse(static_cast<bool>(d.altimeter_group));
+
+    // Wind shift
+    Assert::AreEqual(uint16_t(225), d.wind_group->before->direction);
+    Assert::AreEqual(uint16_t(310), d.wind_group->after->direction);
+
+    // New weather phenomenon
+    Assert::AreEqual(size_t(0), d.weather_group->before.size());
+    Assert::AreEqual(size_t(1), d.weather_group->after.size());
+
+    // Ceiling drop
+    Assert::AreEqual(size_t(1), d.sky_condition_group->before.size());
+    Assert::AreEqual(size_t(2), d.sky_condition_group->after.size());
+    Assert::AreEqual(uint32_t(800), d.sky_condition_group->after[0].layer_height);
+
+    Assert::AreEqual(10.0, d.visibility_group->before->distance, 0.001);
+    Assert::AreEqual(3.0, d.visibility_group->after->distance, 0.001);
+}
+
+//-----------------------------------------------------------------------------
+
+void MetarDiffTests::MetarDiff_TemperatureDewpoint()
+{
+    aw::metar m1("KSFO 172256Z 00000KT 9SM CLR 19/04 A3012");
+    aw::metar m2("KSFO 172256Z 00000KT 9SM CLR 19/06 A3012");
+
+    auto d = diff(m1, m2);
+
+    Assert::AreEqual(element_mask(metar_element_type::temperature_dewpoint), d.mask);
+    Assert::AreEqual(int8_t(19), *d.temperature->before);
+    Assert::AreEqual(int8_t(19), *d.temperature->after);
+    Assert::AreEqual(int8_t(4), *d.dewpoint->before);
+    Assert::AreEqual(int8_t(6), *d.dewpoint->after);
+}
+
+//-----------------------------------------------------------------------------
+
+void MetarDiffTests::MetarDiff_Move()
+{
+    aw::metar m1("KSFO 172256Z 00000KT 9SM CLR 19/04 A3012 RMK AO2");
+    aw::metar m2("KSFO 172356Z 00000KT 9SM CLR 19/04 A3012 RMK AO1");
+
+    auto d1 = diff(m1, m2);
+    metar_diff d2(std::move(d1));
+
+    Assert::IsTrue(d1.empty());
+    Assert::IsFalse(static_cast<bool>(d1.remarks));
+    Assert::IsTrue(d2.changed(metar_element_type::remarks));
+    Assert::AreEqual(std::string("AO2"), d2.remarks->before);
+    Assert::AreEqual(std::string("AO1"), d2.remarks->after);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
@@ -0,0 +1,235 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <string>
+
+#include <AviationWeather/metar.h>
+#include <AviationWeather/metar_diff.h>
+#include <AviationWeather/types.h>
+
+#include "framework.h"
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(MetarInternationalTests)
+{
+public:
+    TEST_METHOD(METAR_MetresPerSecond);
+    TEST_METHOD(METAR_MinimumVisibility);
+    TEST_METHOD(METAR_RunwayVisualRangeTendency);
+    TEST_METHOD(METAR_NoCloudDetected);
+    TEST_METHOD(METAR_RecentWeatherAndWindShear);
+    TEST_METHOD(METAR_Trends);
+    TEST_METHOD(METAR_InternationalView);
+};
+
+//-----------------------------------------------------------------------------
+
+void MetarInternationalTests::METAR_MetresPerSecond()
+{
+    aw::metar m("METAR UUEE 121030Z 24005MPS 200V280 9999 BKN020 M02/M05 Q1015 NOSIG=");
+
+    Assert::IsTrue(m.type == metar_report_type::metar);
+    Assert::AreEqual(std::string("UUEE"), m.identifier);
+    Assert::IsTrue(m.wind_group->unit == speed_unit::mps);
+    Assert::AreEqual(static_cast<uint16_t>(240), m.wind_group->direction);
+    Assert::AreEqual(static_cast<uint8_t>(5), m.wind_group->wind_speed);
+    Assert::AreEqual(static_cast<uint16_t>(200), *m.wind_group->variation_lower);
+    Assert::AreEqual(static_cast<uint16_t>(280), *m.wind_group->variation_upper);
+    Assert::IsTrue(*m.visibility_group == visibility(9999, distance_unit::metres));
+    Assert::AreEqual(static_cast<int8_t>(-2), *m.temperature);
+    Assert::AreEqual(static_cast<int8_t>(-5), *m.dewpoint);
+    Assert::IsTrue(m.altimeter_group->unit == pressure_unit::hPa);
+    Assert::AreEqual(1015.0, m.altimeter_group->pressure);
+}
+
+//-----------------------------------------------------------------------------
+
+void MetarInternationalTests::METAR_MinimumVisibility()
+{
+    aw::metar m("EGLL 121050Z 27012KT 4000 1500SW BR SCT008 BKN012 08/07 Q1002");
+
+    Assert::IsTrue(*m.visibility_group == visibility(4000, distance_unit::metres));
+    Assert::IsTrue(static_cast<bool>(m.minimum_visibility_group));
+    Assert::IsTrue(m.minimum_visibility_group->distance == visibility(1500, distance_unit::metres));
+    Assert::AreEqual(compass_direction::south_west, m.minimum_visibility_group->direction);
+    Assert::AreEqual(size_t(1), m.weather_group.size());
+    Assert::AreEqual(size_t(2), m.sky_condition_group.size());
+
+    aw::metar ndv("LFPG 121100Z AUTO 18004KT 9999NDV NCD 14/09 Q1020");
+
+    Assert::IsTrue(ndv.modifier == metar_modifier_type::automatic);
+    Assert::IsTrue(*ndv.visibility_group == visibility(9999, distance_unit::metres));
+    Assert::IsFalse(static_cast<bool>(ndv.minimum_visibility_group));
+}
+
+//-----------------------------------------------------------------------------
+
+void MetarInternationalTests::METAR_RunwayVisualRangeTendency()
+{
+    aw::metar m("EDDF 120620Z 05003KT 0300 R25R/0450U R07C/P2000N R18/0350V0600D FG VV001 03/03 Q1024");
+
+    Assert::AreEqual(size_t(3), m.runway_visual_range_group.size());
+
+    auto const& r1 = m.runway_visual_range_group[0];
+    Assert::AreEqual(static_cast<uint8_t>(25), r1.runway_number);
+    Assert::AreEqual(runway_designator_type::right, r1.runway_designator);
+    Assert::IsTrue(r1.visibility_min == visibility(450, distance_unit::metres));
+    Assert::AreEqual(rvr_tendency::upward, r1.tendency);
+    Assert::IsFalse(r1.is_variable());
+
+    auto const& r2 = m.runway_visual_range_group[1];
+    Assert::AreEqual(runway_designator_type::center, r2.runway_designator);
+    Assert::IsTrue(r2.visibility_min == visibility(2000, distance_unit::metres, visibility_modifier_type::greater_than));
+    Assert::AreEqual(rvr_tendency::no_change, r2.tendency);
+
+    auto const& r3 = m.runway_visual_range_group[2];
+    Assert::AreEqual(runway_designator_type::none, r3.runway_designator);
+    Assert::IsTrue(r3.is_variable());
+    Assert::IsTrue(r3.visibility_max == visibility(600, distance_unit::metres));
+    Assert::AreEqual(rvr_tendency::downward, r3.tendency);
+
+    aw::metar us("KSFO 121056Z 00000KT 1/4SM R28L/1600V3000FT FG VV002 12/12 A3001");
+
+    Assert::AreEqual(size_t(1), us.runway_visual_range_group.size());
+    Assert::IsTrue(us.runway_visual_range_group[0].visibility_min == visibility(1600, distance_unit::feet));
+    Assert::AreEqual(rvr_tendency::none, us.runway_visual_range_group[0].tendency);
+}
+
+//-----------------------------------------------------------------------------
+
+void MetarInternationalTests::METAR_NoCloudDetected()
+{
+    aw::metar nsc("LEMD 121200Z 36008KT 9999 NSC 21/04 Q1019 NOSIG");
+
+    Assert::AreEqual(size_t(1), nsc.sky_condition_group.size());
+    Assert::AreEqual(sky_cover_type::no_significant_cloud, nsc.sky_condition_group[0].sky_cover);
+    Assert::AreEqual(UINT32_MAX, nsc.sky_condition_group[0].layer_height);
+
+    aw::metar ncd("EHAM 121155Z AUTO 22009KT 9999 NCD 15/08 Q1013");
+
+    Assert::AreEqual(size_t(1), ncd.sky_condition_group.size());
+    Assert::AreEqual(sky_cover_type::no_cloud_detected, ncd.sky_condition_group[0].sky_cover);
+
+    // Distinct from a clear sky, but with no ceiling either
+    aw::metar skc("LEMD 121200Z 36008KT 9999 SKC 21/04 Q1019 NOSIG");
+    Assert::IsFalse(skc == nsc);
+    Assert::AreNotEqual(skc.content_hash(), nsc.content_hash());
+    Assert::IsTrue(diff(skc, nsc).changed(metar_element_type::sky_condition));
+    Assert::AreEqual(skc.flight_category(), nsc.flight_category());
+    Assert::AreEqual(flight_category::vfr, ncd.flight_category());
+}
+
+//-----------------------------------------------------------------------------
+
+void MetarInternationalTests::METAR_RecentWeatherAndWindShear()
+{
+    aw::metar m("LSZH 121520Z 25018G32KT 9000 -SHRA FEW030CB BKN050 17/13 Q1008 RETSRA WS R34 WS RWY28 WS ALL RWY");
+
+    Assert::AreEqual(size_t(1), m.recent_weather_group.size());
+    Assert::AreEqual(weather_descriptor::thunderstorm, m.recent_weather_group[0].descriptor);
+    Assert::AreEqual(size_t(1), m.recent_weather_group[0].phenomena.size());
+    Assert::AreEqual(weather_phenomena::rain, m.recent_weather_group[0].phenomena[0]);
+
+    Assert::AreEqual(size_t(3), m.wind_shear_group.size());
+    Assert::AreEqual(static_cast<uint8_t>(34), m.wind_shear_group[0].runway_number);
+    Assert::IsFalse(m.wind_shear_group[0].all_runways);
+    Assert::AreEqual(static_cast<uint8_t>(28), m.wind_shear_group[1].runway_number);
+    Assert::IsTrue(m.wind_shear_group[2].all_runways);
+
+    // Recent weather is not present weather
+    Assert::AreEqual(size_t(1), m.weather_group.size());
+    Assert::AreEqual(size_t(2), m.sky_condition_group.size());
+}
+
+//-----------------------------------------------------------------------------
+
+void MetarInternationalTests::METAR_Trends()
+{
+    aw::metar m("EGKK 121420Z 19015KT 9999 SCT025 16/11 Q1010 BECMG FM1500 TL1600 24020G30KT 6000 RA BKN012 TEMPO 3000 +SHRA NOSIG=");
+
+    Assert::AreEqual(size_t(1), m.sky_condition_group.size());
+    Assert::AreEqual(size_t(0), m.weather_group.size());
+    Assert::IsTrue(*m.visibility_group == visibility(9999, distance_unit::metres));
+
+    Assert::AreEqual(size_t(3), m.trend_group.size());
+
+    auto const& becoming = m.trend_group[0];
+    Assert::AreEqual(metar_trend_type::becoming, becoming.type);
+    Assert::IsTrue(*becoming.from == time(12, 15, 0));
+    Assert::IsTrue(*becoming.until == time(12, 16, 0));
+    Assert::IsFalse(static_cast<bool>(becoming.at));
+    Assert::AreEqual(static_cast<uint16_t>(240), becoming.wind_group->direction);
+    Assert::AreEqual(static_cast<uint8_t>(30), becoming.wind_group->gust_speed);
+    Assert::IsTrue(*becoming.visibility_group == visibility(6000, distance_unit::metres));
+    Assert::AreEqual(size_t(1), becoming.weather_group.size());
+    Assert::AreEqual(size_t(1), becoming.sky_condition_group.size());
+
+    auto const& temporary = m.trend_group[1];
+    Assert::AreEqual(metar_trend_type::temporary, temporary.type);
+    Assert::IsTrue(*temporary.visibility_group == visibility(3000, distance_unit::metres));
+    Assert::AreEqual(weather_intensity::heavy, temporary.weather_group[0].intensity);
+
+    Assert::AreEqual(metar_trend_type::no_significant_change, m.trend_group[2].type);
+
+    aw::metar nsw("EGPH 121420Z 27010KT 9999 FEW030 12/06 Q1012 TEMPO AT1500 NSW");
+    Assert::AreEqual(size_t(1), nsw.trend_group.size());
+    Assert::IsTrue(*nsw.trend_group[0].at == time(12, 15, 0));
+    Assert::IsTrue(nsw.trend_group[0].no_significant_weather);
+
+    // Trends participate in equality and diffs
+    aw::metar other("EGKK 121420Z 19015KT 9999 SCT025 16/11 Q1010 NOSIG");
+    auto d = diff(m, other);
+    Assert::IsTrue(d.changed(metar_element_type::trend));
+    Assert::IsFalse(d.changed(metar_element_type::sky_condition));
+    Assert::IsFalse(m == other);
+    Assert::IsTrue(m.content_hash() != other.content_hash());
+}
+
+//-----------------------------------------------------------------------------
+
+void MetarInternationalTests::METAR_InternationalView()
+{
+    std::string raw = "METAR LFPO 121430Z 31012KT 280V350 5000 2000NE R24/0800U -RA BKN006 OVC010 11/10 Q0998 REDZ TEMPO 2000 BR RMK QFE995=";
+    aw::metar_view view(raw);
+    aw::metar owned(raw);
+
+    Assert::IsTrue(view.identifier == util::string_view("LFPO"));
+    Assert::IsTrue(view.remarks == util::string_view("QFE995="));
+    Assert::IsTrue(static_cast<bool>(view.minimum_visibility_group));
+    Assert::AreEqual(compass_direction::north_east, view.minimum_visibility_group->direction);
+    Assert::AreEqual(size_t(1), view.recent_weather_group.size());
+    Assert::AreEqual(size_t(1), view.trend_group.size());
+    Assert::IsTrue(view.to_owned() == owned);
+    Assert::AreEqual(owned.content_hash(), view.content_hash());
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
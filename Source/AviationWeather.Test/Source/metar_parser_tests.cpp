@@ -15,10 +15,16 @@
 
 #include "AviationWeather.TestPch.h"
 
-#include "../Source/parsers.h"
+#include <sstream>
+#include <string>
+#include <vector>
 
+#include <AviationWeather/metar.h>
 #include <AviationWeather/optional.h>
 
+#include "../Source/metar_decoders.h"
+#include "../Source/token_decoders.h"
+
 #include "framework.h"
 
 //-----------------------------------------------------------------------------
@@ -31,6 +37,31 @@ namespace aw
 {
 namespace test
 {
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+// Decodes each space-separated token of text, as the report walker offers
+// them, failing if any of them is not a group of that kind
+template <class T, class TDecode>
+std::vector<T> decode_each(std::string const& text, TDecode && decode)
+{
+    std::vector<T> results;
+    std::istringstream tokens(text);
+    std::string token;
+    while (tokens >> token)
+    {
+        T value;
+        Assert::IsTrue(decode(util::string_view(token), value));
+        results.push_back(value);
+    }
+    return results;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
 
 //-----------------------------------------------------------------------------
 
@@ -53,31 +84,19 @@ public:
 
 //-----------------------------------------------------------------------------
 
+// The header groups are decoded in place by the report walker, so they are
+// checked through the reports they are part of
+
 void MetarParserTests::METAR_Parser_ReportType()
 {
-    // Empty
-    parse_metar_report_type("", [&](metar_report_type type)
-    {
-        Assert::Fail();
-    });
+    // None
+    Assert::AreEqual(metar_report_type::metar, metar("KSFO 081753Z").type);
 
     // METAR
-    bool parsed = false;
-    parse_metar_report_type("METAR ", [&](metar_report_type type)
-    {
-        parsed = true;
-        Assert::AreEqual(metar_report_type::metar, type);
-    });
-    Assert::IsTrue(parsed);
+    Assert::AreEqual(metar_report_type::metar, metar("METAR KSFO 081753Z").type);
 
     // SPECI
-    parsed = false;
-    parse_metar_report_type(std::string("SPECI "), [&](metar_report_type type)
-    {
-        parsed = true;
-        Assert::AreEqual(metar_report_type::special, type);
-    });
-    Assert::IsTrue(parsed);
+    Assert::AreEqual(metar_report_type::special, metar("SPECI KSFO 081753Z").type);
 }
 
 //-----------------------------------------------------------------------------
@@ -85,346 +104,243 @@ void MetarParserTests::METAR_Parser_ReportType()
 void MetarParserTests::METAR_Parser_StationIdentifier()
 {
     // Empty
-    parse_station_identifier(std::string(""), [&](std::string const& identifier)
-    {
-        Assert::Fail();
-    });
+    Assert::AreEqual(std::string(""), metar("").identifier);
 
     // KSFO
-    bool parsed = false;
-    parse_station_identifier(std::string("KSFO "), [&](std::string const& identifier)
-    {
-        parsed = true;
-        Assert::AreEqual(std::string("KSFO"), identifier);
-    });
-    Assert::IsTrue(parsed);
+    Assert::AreEqual(std::string("KSFO"), metar("METAR KSFO 081753Z").identifier);
 
     // EBGE
-    parsed = false;
-    parse_station_identifier(std::string("EGBE "), [&](std::string const& identifier)
-    {
-        parsed = true;
-        Assert::AreEqual(std::string("EGBE"), identifier);
-    });
-    Assert::IsTrue(parsed);
+    Assert::AreEqual(std::string("EGBE"), metar("EGBE 081753Z").identifier);
 }
 
 //-----------------------------------------------------------------------------
 
 void MetarParserTests::METAR_Parser_ObservationTime()
 {
-    // Empty
-    parse_time(std::string(""), [&](aw::time && time)
-    {
-        Assert::Fail();
-    });
-
     // 8th, 17:53
-    bool parsed = false;
-    parse_time(std::string("081753Z "), [&](aw::time && time)
-    {
-        parsed = true;
-        Assert::AreEqual(uint8_t(8), time.day_of_month);
-        Assert::AreEqual(uint8_t(17), time.hour_of_day);
-        Assert::AreEqual(uint8_t(53), time.minute_of_hour);
-    });
-    Assert::IsTrue(parsed);
+    auto time = metar("KSFO 081753Z").observation_time;
+    Assert::AreEqual(uint8_t(8), time.day_of_month);
+    Assert::AreEqual(uint8_t(17), time.hour_of_day);
+    Assert::AreEqual(uint8_t(53), time.minute_of_hour);
 
     // 20th, 03:28
-    parsed = false;
-    parse_time(std::string("200328Z "), [&](aw::time && time)
-    {
-        parsed = true;
-        Assert::AreEqual(uint8_t(20), time.day_of_month);
-        Assert::AreEqual(uint8_t(3), time.hour_of_day);
-        Assert::AreEqual(uint8_t(28), time.minute_of_hour);
-    });
-    Assert::IsTrue(parsed);
+    time = metar("KSFO 200328Z").observation_time;
+    Assert::AreEqual(uint8_t(20), time.day_of_month);
+    Assert::AreEqual(uint8_t(3), time.hour_of_day);
+    Assert::AreEqual(uint8_t(28), time.minute_of_hour);
 }
 
 //-----------------------------------------------------------------------------
 
 void MetarParserTests::METAR_Parser_Modifier()
 {
-    // Empty
-    parse_metar_modifier(std::string(""), [&](metar_modifier_type type)
-    {
-        Assert::Fail();
-    });
+    // None
+    Assert::AreEqual(metar_modifier_type::none, metar("KSFO 081753Z").modifier);
 
     // AUTO
-    bool parsed = false;
-    parse_metar_modifier(std::string("AUTO "), [&](metar_modifier_type type)
-    {
-        parsed = true;
-        Assert::AreEqual(metar_modifier_type::automatic, type);
-    });
-    Assert::IsTrue(parsed);
+    Assert::AreEqual(metar_modifier_type::automatic, metar("KSFO 081753Z AUTO").modifier);
 
     // COR
-    parsed = false;
-    parse_metar_modifier(std::string("COR "), [&](metar_modifier_type type)
-    {
-        parsed = true;
-        Assert::AreEqual(metar_modifier_type::corrected, type);
-    });
-    Assert::IsTrue(parsed);
+    Assert::AreEqual(metar_modifier_type::corrected, metar("KSFO 081753Z COR").modifier);
 }
 
 //-----------------------------------------------------------------------------
 
 void MetarParserTests::METAR_Parser_Wind()
 {
+    wind windGroup;
+
     // Empty
-    parse_wind(std::string(""), [&](wind && windGroup)
-    {
-        Assert::Fail();
-    });
+    Assert::IsFalse(decode_wind_token("", windGroup));
 
     // 240 @15kts
-    bool parsed = false;
-    parse_wind(std::string("24015KT "), [&](wind && windGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(uint16_t(240), windGroup.direction);
-        Assert::AreEqual(uint8_t(15), windGroup.wind_speed);
-        Assert::AreEqual(uint8_t(0), windGroup.gust_speed);
-        Assert::IsFalse(static_cast<bool>(windGroup.variation_lower));
-        Assert::IsFalse(static_cast<bool>(windGroup.variation_upper));
-        Assert::AreEqual(speed_unit::kt, windGroup.unit);
-    });
-    Assert::IsTrue(parsed);
+    Assert::IsTrue(decode_wind_token("24015KT", windGroup));
+    Assert::AreEqual(uint16_t(240), windGroup.direction);
+    Assert::AreEqual(uint8_t(15), windGroup.wind_speed);
+    Assert::AreEqual(uint8_t(0), windGroup.gust_speed);
+    Assert::IsFalse(static_cast<bool>(windGroup.variation_lower));
+    Assert::IsFalse(static_cast<bool>(windGroup.variation_upper));
+    Assert::AreEqual(speed_unit::kt, windGroup.unit);
 
     // Variable @ 2kts
-    parsed = false;
-    parse_wind(std::string("VRB02KT "), [&](wind && windGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(UINT16_MAX, windGroup.direction);
-        Assert::AreEqual(uint8_t(2), windGroup.wind_speed);
-        Assert::AreEqual(uint8_t(0), windGroup.gust_speed);
-        Assert::IsFalse(static_cast<bool>(windGroup.variation_lower));
-        Assert::IsFalse(static_cast<bool>(windGroup.variation_upper));
-        Assert::AreEqual(speed_unit::kt, windGroup.unit);
-    });
-    Assert::IsTrue(parsed);
+    windGroup = wind();
+    Assert::IsTrue(decode_wind_token("VRB02KT", windGroup));
+    Assert::AreEqual(UINT16_MAX, windGroup.direction);
+    Assert::AreEqual(uint8_t(2), windGroup.wind_speed);
+    Assert::AreEqual(uint8_t(0), windGroup.gust_speed);
+    Assert::IsFalse(static_cast<bool>(windGroup.variation_lower));
+    Assert::IsFalse(static_cast<bool>(windGroup.variation_upper));
+    Assert::AreEqual(speed_unit::kt, windGroup.unit);
 
     // 120 @ 10kts, variable between 100 and 140
-    parsed = false;
-    parse_wind(std::string("12010KT 100V140 "), [&](wind && windGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(uint16_t(120), windGroup.direction);
-        Assert::AreEqual(uint8_t(10), windGroup.wind_speed);
-        Assert::AreEqual(uint8_t(0), windGroup.gust_speed);
-        Assert::AreEqual(uint16_t(100), *(windGroup.variation_lower));
-        Assert::AreEqual(uint16_t(140), *(windGroup.variation_upper));
-        Assert::AreEqual(speed_unit::kt, windGroup.unit);
-    });
-    Assert::IsTrue(parsed);
+    windGroup = wind();
+    Assert::IsTrue(decode_wind_token("12010KT", windGroup));
+    Assert::IsTrue(decode_wind_variation_token("100V140", windGroup));
+    Assert::AreEqual(uint16_t(120), windGroup.direction);
+    Assert::AreEqual(uint8_t(10), windGroup.wind_speed);
+    Assert::AreEqual(uint8_t(0), windGroup.gust_speed);
+    Assert::AreEqual(uint16_t(100), *(windGroup.variation_lower));
+    Assert::AreEqual(uint16_t(140), *(windGroup.variation_upper));
+    Assert::AreEqual(speed_unit::kt, windGroup.unit);
 
     // 120 @ 8kts, gusting 12kts
-    parsed = false;
-    parse_wind(std::string("12008G12KT "), [&](wind && windGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(uint16_t(120), windGroup.direction);
-        Assert::AreEqual(uint8_t(8), windGroup.wind_speed);
-        Assert::AreEqual(uint8_t(12), windGroup.gust_speed);
-        Assert::IsFalse(static_cast<bool>(windGroup.variation_lower));
-        Assert::IsFalse(static_cast<bool>(windGroup.variation_upper));
-        Assert::AreEqual(speed_unit::kt, windGroup.unit);
-    });
-    Assert::IsTrue(parsed);
+    windGroup = wind();
+    Assert::IsTrue(decode_wind_token("12008G12KT", windGroup));
+    Assert::AreEqual(uint16_t(120), windGroup.direction);
+    Assert::AreEqual(uint8_t(8), windGroup.wind_speed);
+    Assert::AreEqual(uint8_t(12), windGroup.gust_speed);
+    Assert::IsFalse(static_cast<bool>(windGroup.variation_lower));
+    Assert::IsFalse(static_cast<bool>(windGroup.variation_upper));
+    Assert::AreEqual(speed_unit::kt, windGroup.unit);
 
     // 340 @ 112kts
-    parsed = false;
-    parse_wind(std::string("340112KT "), [&](wind && windGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(uint16_t(340), windGroup.direction);
-        Assert::AreEqual(uint8_t(112), windGroup.wind_speed);
-        Assert::AreEqual(uint8_t(0), windGroup.gust_speed);
-        Assert::IsFalse(static_cast<bool>(windGroup.variation_lower));
-        Assert::IsFalse(static_cast<bool>(windGroup.variation_upper));
-        Assert::AreEqual(speed_unit::kt, windGroup.unit);
-    });
-    Assert::IsTrue(parsed);
+    windGroup = wind();
+    Assert::IsTrue(decode_wind_token("340112KT", windGroup));
+    Assert::AreEqual(uint16_t(340), windGroup.direction);
+    Assert::AreEqual(uint8_t(112), windGroup.wind_speed);
+    Assert::AreEqual(uint8_t(0), windGroup.gust_speed);
+    Assert::IsFalse(static_cast<bool>(windGroup.variation_lower));
+    Assert::IsFalse(static_cast<bool>(windGroup.variation_upper));
+    Assert::AreEqual(speed_unit::kt, windGroup.unit);
 
     // 000 @ 0kts
-    parsed = false;
-    parse_wind(std::string("00000KT "), [&](wind && windGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(uint16_t(0), windGroup.direction);
-        Assert::AreEqual(uint8_t(0), windGroup.wind_speed);
-        Assert::AreEqual(uint8_t(0), windGroup.gust_speed);
-        Assert::IsFalse(static_cast<bool>(windGroup.variation_lower));
-        Assert::IsFalse(static_cast<bool>(windGroup.variation_upper));
-        Assert::AreEqual(speed_unit::kt, windGroup.unit);
-    });
-    Assert::IsTrue(parsed);
+    windGroup = wind();
+    Assert::IsTrue(decode_wind_token("00000KT", windGroup));
+    Assert::AreEqual(uint16_t(0), windGroup.direction);
+    Assert::AreEqual(uint8_t(0), windGroup.wind_speed);
+    Assert::AreEqual(uint8_t(0), windGroup.gust_speed);
+    Assert::IsFalse(static_cast<bool>(windGroup.variation_lower));
+    Assert::IsFalse(static_cast<bool>(windGroup.variation_upper));
+    Assert::AreEqual(speed_unit::kt, windGroup.unit);
+
+    // 050 @ 4m/s
+    windGroup = wind();
+    Assert::IsTrue(decode_wind_token("05004MPS", windGroup));
+    Assert::AreEqual(uint16_t(50), windGroup.direction);
+    Assert::AreEqual(uint8_t(4), windGroup.wind_speed);
+    Assert::AreEqual(speed_unit::mps, windGroup.unit);
+
+    // Not wind groups
+    Assert::IsFalse(decode_wind_token("24015", windGroup));
+    Assert::IsFalse(decode_wind_token("2401KT", windGroup));
+    Assert::IsFalse(decode_wind_variation_token("100V14", windGroup));
 }
 
 //-----------------------------------------------------------------------------
 
 void MetarParserTests::METAR_Parser_Visibility()
 {
+    visibility visibilityGroup;
+
     // Empty
-    parse_visibility(std::string(""), [&](visibility && visibilityGroup)
-    {
-        Assert::Fail();
-    });
+    Assert::IsFalse(decode_visibility_token("", visibilityGroup));
 
     // M1/4SM
-    bool parsed = false;
-    parse_visibility(std::string("M1/4SM "), [&](visibility && visibilityGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(distance_unit::statute_miles, visibilityGroup.unit);
-        Assert::AreEqual(1.0 / 4.0, visibilityGroup.distance, 0.00001);
-        Assert::AreEqual(visibility_modifier_type::less_than, visibilityGroup.modifier);
-    });
-    Assert::IsTrue(parsed);
+    Assert::IsTrue(decode_visibility_token("M1/4SM", visibilityGroup));
+    Assert::AreEqual(distance_unit::statute_miles, visibilityGroup.unit);
+    Assert::AreEqual(1.0 / 4.0, visibilityGroup.distance, 0.00001);
+    Assert::AreEqual(visibility_modifier_type::less_than, visibilityGroup.modifier);
 
     // 1/2SM
-    parsed = false;
-    parse_visibility(std::string("1/2SM "), [&](visibility && visibilityGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(distance_unit::statute_miles, visibilityGroup.unit);
-        Assert::AreEqual(1.0 / 2.0, visibilityGroup.distance, 0.00001);
-        Assert::AreEqual(visibility_modifier_type::none, visibilityGroup.modifier);
-    });
-    Assert::IsTrue(parsed);
+    Assert::IsTrue(decode_visibility_token("1/2SM", visibilityGroup));
+    Assert::AreEqual(distance_unit::statute_miles, visibilityGroup.unit);
+    Assert::AreEqual(1.0 / 2.0, visibilityGroup.distance, 0.00001);
+    Assert::AreEqual(visibility_modifier_type::none, visibilityGroup.modifier);
 
     // 1SM
-    parsed = false;
-    parse_visibility(std::string("1SM "), [&](visibility && visibilityGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(distance_unit::statute_miles, visibilityGroup.unit);
-        Assert::AreEqual(1.0, visibilityGroup.distance, 0.00001);
-        Assert::AreEqual(visibility_modifier_type::none, visibilityGroup.modifier);
-    });
-    Assert::IsTrue(parsed);
+    Assert::IsTrue(decode_visibility_token("1SM", visibilityGroup));
+    Assert::AreEqual(distance_unit::statute_miles, visibilityGroup.unit);
+    Assert::AreEqual(1.0, visibilityGroup.distance, 0.00001);
+    Assert::AreEqual(visibility_modifier_type::none, visibilityGroup.modifier);
 
     // 1 3/4SM
-    parsed = false;
-    parse_visibility(std::string("1 3/4SM "), [&](visibility && visibilityGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(distance_unit::statute_miles, visibilityGroup.unit);
-        Assert::AreEqual(1.0 + (3.0 / 4.0), visibilityGroup.distance, 0.00001);
-        Assert::AreEqual(visibility_modifier_type::none, visibilityGroup.modifier);
-    });
-    Assert::IsTrue(parsed);
+    Assert::IsTrue(decode_visibility_token("1", "3/4SM", visibilityGroup));
+    Assert::AreEqual(distance_unit::statute_miles, visibilityGroup.unit);
+    Assert::AreEqual(1.0 + (3.0 / 4.0), visibilityGroup.distance, 0.00001);
+    Assert::AreEqual(visibility_modifier_type::none, visibilityGroup.modifier);
 
     // 5/16SM
-    parsed = false;
-    parse_visibility(std::string("5/16SM "), [&](visibility && visibilityGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(distance_unit::statute_miles, visibilityGroup.unit);
-        Assert::AreEqual(5.0 / 16.0, visibilityGroup.distance, 0.00001);
-        Assert::AreEqual(visibility_modifier_type::none, visibilityGroup.modifier);
-    });
-    Assert::IsTrue(parsed);
+    Assert::IsTrue(decode_visibility_token("5/16SM", visibilityGroup));
+    Assert::AreEqual(distance_unit::statute_miles, visibilityGroup.unit);
+    Assert::AreEqual(5.0 / 16.0, visibilityGroup.distance, 0.00001);
+    Assert::AreEqual(visibility_modifier_type::none, visibilityGroup.modifier);
 
     // 3SM
-    parsed = false;
-    parse_visibility(std::string("3SM "), [&](visibility && visibilityGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(distance_unit::statute_miles, visibilityGroup.unit);
-        Assert::AreEqual(3.0, visibilityGroup.distance, 0.00001);
-        Assert::AreEqual(visibility_modifier_type::none, visibilityGroup.modifier);
-    });
-    Assert::IsTrue(parsed);
+    Assert::IsTrue(decode_visibility_token("3SM", visibilityGroup));
+    Assert::AreEqual(distance_unit::statute_miles, visibilityGroup.unit);
+    Assert::AreEqual(3.0, visibilityGroup.distance, 0.00001);
+    Assert::AreEqual(visibility_modifier_type::none, visibilityGroup.modifier);
 
     // 15SM
-    parsed = false;
-    parse_visibility(std::string("15SM "), [&](visibility && visibilityGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(distance_unit::statute_miles, visibilityGroup.unit);
-        Assert::AreEqual(15.0, visibilityGroup.distance, 0.00001);
-        Assert::AreEqual(visibility_modifier_type::none, visibilityGroup.modifier);
-    });
-    Assert::IsTrue(parsed);
+    Assert::IsTrue(decode_visibility_token("15SM", visibilityGroup));
+    Assert::AreEqual(distance_unit::statute_miles, visibilityGroup.unit);
+    Assert::AreEqual(15.0, visibilityGroup.distance, 0.00001);
+    Assert::AreEqual(visibility_modifier_type::none, visibilityGroup.modifier);
+
+    // 0800 metres
+    Assert::IsTrue(decode_visibility_token("0800", visibilityGroup));
+    Assert::AreEqual(distance_unit::metres, visibilityGroup.unit);
+    Assert::AreEqual(800.0, visibilityGroup.distance, 0.00001);
+
+    // The whole number of a split visibility is not a group by itself when
+    // the next token is not a fraction
+    Assert::IsFalse(decode_visibility_token("1", "BR", visibilityGroup));
 }
 
 //-----------------------------------------------------------------------------
 
 void MetarParserTests::METAR_Parser_RunwayVisualRange()
 {
+    runway_visual_range rvr;
+
     // Empty
-    parse_runway_visual_range(std::string(""), [&](runway_visual_range && rvr)
-    {
-        Assert::Fail();
-    });
+    Assert::IsFalse(decode_runway_visual_range_token("", rvr));
 
     // R09/3000FT
-    bool parsed = false;
-    parse_runway_visual_range(std::string("R09/3000FT "), [&](runway_visual_range && rvr)
-    {
-        parsed = true;
-        Assert::AreEqual(runway_designator_type::none, rvr.runway_designator);
-        Assert::AreEqual(uint8_t(9), rvr.runway_number);
-        Assert::AreEqual(double(3000), rvr.visibility_min.distance);
-        Assert::AreEqual(double(3000), rvr.visibility_max.distance);
-        Assert::AreEqual(visibility_modifier_type::none, rvr.visibility_min.modifier);
-        Assert::AreEqual(visibility_modifier_type::none, rvr.visibility_max.modifier);
-        Assert::AreEqual(distance_unit::feet, rvr.visibility_min.unit);
-        Assert::AreEqual(distance_unit::feet, rvr.visibility_max.unit);
-    });
-    Assert::IsTrue(parsed);
+    Assert::IsTrue(decode_runway_visual_range_token("R09/3000FT", rvr));
+    Assert::AreEqual(runway_designator_type::none, rvr.runway_designator);
+    Assert::AreEqual(uint8_t(9), rvr.runway_number);
+    Assert::AreEqual(double(3000), rvr.visibility_min.distance);
+    Assert::AreEqual(double(3000), rvr.visibility_max.distance);
+    Assert::AreEqual(visibility_modifier_type::none, rvr.visibility_min.modifier);
+    Assert::AreEqual(visibility_modifier_type::none, rvr.visibility_max.modifier);
+    Assert::AreEqual(distance_unit::feet, rvr.visibility_min.unit);
+    Assert::AreEqual(distance_unit::feet, rvr.visibility_max.unit);
 
     // R27L/2000FT
-    parsed = false;
-    parse_runway_visual_range(std::string("R27L/2000FT "), [&](runway_visual_range && rvr)
-    {
-        parsed = true;
-        Assert::AreEqual(runway_designator_type::left, rvr.runway_designator);
-        Assert::AreEqual(uint8_t(27), rvr.runway_number);
-        Assert::AreEqual(double(2000), rvr.visibility_min.distance);
-        Assert::AreEqual(double(2000), rvr.visibility_max.distance);
-        Assert::AreEqual(visibility_modifier_type::none, rvr.visibility_min.modifier);
-        Assert::AreEqual(visibility_modifier_type::none, rvr.visibility_max.modifier);
-        Assert::AreEqual(distance_unit::feet, rvr.visibility_min.unit);
-        Assert::AreEqual(distance_unit::feet, rvr.visibility_max.unit);
-    });
-    Assert::IsTrue(parsed);
+    rvr = runway_visual_range();
+    Assert::IsTrue(decode_runway_visual_range_token("R27L/2000FT", rvr));
+    Assert::AreEqual(runway_designator_type::left, rvr.runway_designator);
+    Assert::AreEqual(uint8_t(27), rvr.runway_number);
+    Assert::AreEqual(double(2000), rvr.visibility_min.distance);
+    Assert::AreEqual(double(2000), rvr.visibility_max.distance);
+    Assert::AreEqual(visibility_modifier_type::none, rvr.visibility_min.modifier);
+    Assert::AreEqual(visibility_modifier_type::none, rvr.visibility_max.modifier);
+    Assert::AreEqual(distance_unit::feet, rvr.visibility_min.unit);
+    Assert::AreEqual(distance_unit::feet, rvr.visibility_max.unit);
 
     // R06R/2000V3000FT
-    parsed = false;
-    parse_runway_visual_range(std::string("R06R/2000V3000FT "), [&](runway_visual_range && rvr)
-    {
-        parsed = true;
-        Assert::AreEqual(runway_designator_type::right, rvr.runway_designator);
-        Assert::AreEqual(uint8_t(6), rvr.runway_number);
-        Assert::AreEqual(double(2000), rvr.visibility_min.distance);
-        Assert::AreEqual(double(3000), rvr.visibility_max.distance);
-        Assert::AreEqual(visibility_modifier_type::none, rvr.visibility_min.modifier);
-        Assert::AreEqual(visibility_modifier_type::none, rvr.visibility_max.modifier);
-        Assert::AreEqual(distance_unit::feet, rvr.visibility_min.unit);
-        Assert::AreEqual(distance_unit::feet, rvr.visibility_max.unit);
-    });
-    Assert::IsTrue(parsed);
-
-    // R06R/2000V3000FT
-    {
-        std::vector<runway_visual_range> rvrGroup;
-        std::vector<runway_visual_range>::iterator it;
-
-        parse_runway_visual_range(std::string("R09L/3500V4500FT R09R/3000V4000FT "), [&](runway_visual_range && rvr)
+    rvr = runway_visual_range();
+    Assert::IsTrue(decode_runway_visual_range_token("R06R/2000V3000FT", rvr));
+    Assert::AreEqual(runway_designator_type::right, rvr.runway_designator);
+    Assert::AreEqual(uint8_t(6), rvr.runway_number);
+    Assert::AreEqual(double(2000), rvr.visibility_min.distance);
+    Assert::AreEqual(double(3000), rvr.visibility_max.distance);
+    Assert::AreEqual(visibility_modifier_type::none, rvr.visibility_min.modifier);
+    Assert::AreEqual(visibility_modifier_type::none, rvr.visibility_max.modifier);
+    Assert::AreEqual(distance_unit::feet, rvr.visibility_min.unit);
+    Assert::AreEqual(distance_unit::feet, rvr.visibility_max.unit);
+
+    // R09L/3500V4500FT R09R/3000V4000FT
+    {
+        auto rvrGroup = decode_each<runway_visual_range>("R09L/3500V4500FT R09R/3000V4000FT", [](util::string_view const& t, runway_visual_range& v)
         {
-            rvrGroup.push_back(rvr);
+            return decode_runway_visual_range_token(t, v);
         });
 
         Assert::AreEqual(size_t(2), rvrGroup.size());
 
-        it = rvrGroup.begin();
+        auto it = rvrGroup.begin();
         Assert::AreEqual(runway_designator_type::left, it->runway_designator);
         Assert::AreEqual(uint8_t(9), it->runway_number);
         Assert::AreEqual(double(3500), it->visibility_min.distance);
@@ -445,102 +361,82 @@ void MetarParserTests::METAR_Parser_RunwayVisualRange()
     }
 
     // R01L/M0600FT
-    parsed = false;
-    parse_runway_visual_range(std::string("R01L/M0600FT "), [&](runway_visual_range && rvr)
-    {
-        parsed = true;
-        Assert::AreEqual(runway_designator_type::left, rvr.runway_designator);
-        Assert::AreEqual(uint8_t(1), rvr.runway_number);
-        Assert::AreEqual(double(600), rvr.visibility_min.distance);
-        Assert::AreEqual(double(600), rvr.visibility_max.distance);
-        Assert::AreEqual(visibility_modifier_type::less_than, rvr.visibility_min.modifier);
-        Assert::AreEqual(visibility_modifier_type::none, rvr.visibility_max.modifier);
-        Assert::AreEqual(distance_unit::feet, rvr.visibility_min.unit);
-        Assert::AreEqual(distance_unit::feet, rvr.visibility_max.unit);
-    });
-    Assert::IsTrue(parsed);
+    rvr = runway_visual_range();
+    Assert::IsTrue(decode_runway_visual_range_token("R01L/M0600FT", rvr));
+    Assert::AreEqual(runway_designator_type::left, rvr.runway_designator);
+    Assert::AreEqual(uint8_t(1), rvr.runway_number);
+    Assert::AreEqual(double(600), rvr.visibility_min.distance);
+    Assert::AreEqual(double(600), rvr.visibility_max.distance);
+    Assert::AreEqual(visibility_modifier_type::less_than, rvr.visibility_min.modifier);
+    Assert::AreEqual(visibility_modifier_type::less_than, rvr.visibility_max.modifier);
+    Assert::AreEqual(distance_unit::feet, rvr.visibility_min.unit);
+    Assert::AreEqual(distance_unit::feet, rvr.visibility_max.unit);
 
     // R27/P6000FT
-    parsed = false;
-    parse_runway_visual_range(std::string("R27/P6000FT "), [&](runway_visual_range && rvr)
-    {
-        parsed = true;
-        Assert::AreEqual(runway_designator_type::none, rvr.runway_designator);
-        Assert::AreEqual(uint8_t(27), rvr.runway_number);
-        Assert::AreEqual(double(6000), rvr.visibility_min.distance);
-        Assert::AreEqual(double(6000), rvr.visibility_max.distance);
-        Assert::AreEqual(visibility_modifier_type::greater_than, rvr.visibility_min.modifier);
-        Assert::AreEqual(visibility_modifier_type::none, rvr.visibility_max.modifier);
-        Assert::AreEqual(distance_unit::feet, rvr.visibility_min.unit);
-        Assert::AreEqual(distance_unit::feet, rvr.visibility_max.unit);
-    });
-    Assert::IsTrue(parsed);
+    rvr = runway_visual_range();
+    Assert::IsTrue(decode_runway_visual_range_token("R27/P6000FT", rvr));
+    Assert::AreEqual(runway_designator_type::none, rvr.runway_designator);
+    Assert::AreEqual(uint8_t(27), rvr.runway_number);
+    Assert::AreEqual(double(6000), rvr.visibility_min.distance);
+    Assert::AreEqual(double(6000), rvr.visibility_max.distance);
+    Assert::AreEqual(visibility_modifier_type::greater_than, rvr.visibility_min.modifier);
+    Assert::AreEqual(visibility_modifier_type::greater_than, rvr.visibility_max.modifier);
+    Assert::AreEqual(distance_unit::feet, rvr.visibility_min.unit);
+    Assert::AreEqual(distance_unit::feet, rvr.visibility_max.unit);
 
     // R01L/M0600VP6000FT
-    parsed = false;
-    parse_runway_visual_range(std::string("R01L/M0600VP6000FT "), [&](runway_visual_range && rvr)
-    {
-        parsed = true;
-        Assert::AreEqual(runway_designator_type::left, rvr.runway_designator);
-        Assert::AreEqual(uint8_t(1), rvr.runway_number);
-        Assert::AreEqual(double(600), rvr.visibility_min.distance);
-        Assert::AreEqual(double(6000), rvr.visibility_max.distance);
-        Assert::AreEqual(visibility_modifier_type::less_than, rvr.visibility_min.modifier);
-        Assert::AreEqual(visibility_modifier_type::greater_than, rvr.visibility_max.modifier);
-        Assert::AreEqual(distance_unit::feet, rvr.visibility_min.unit);
-        Assert::AreEqual(distance_unit::feet, rvr.visibility_max.unit);
-    });
-    Assert::IsTrue(parsed);
+    rvr = runway_visual_range();
+    Assert::IsTrue(decode_runway_visual_range_token("R01L/M0600VP6000FT", rvr));
+    Assert::AreEqual(runway_designator_type::left, rvr.runway_designator);
+    Assert::AreEqual(uint8_t(1), rvr.runway_number);
+    Assert::AreEqual(double(600), rvr.visibility_min.distance);
+    Assert::AreEqual(double(6000), rvr.visibility_max.distance);
+    Assert::AreEqual(visibility_modifier_type::less_than, rvr.visibility_min.modifier);
+    Assert::AreEqual(visibility_modifier_type::greater_than, rvr.visibility_max.modifier);
+    Assert::AreEqual(distance_unit::feet, rvr.visibility_min.unit);
+    Assert::AreEqual(distance_unit::feet, rvr.visibility_max.unit);
+
+    // R25L/0800U, in metres
+    rvr = runway_visual_range();
+    Assert::IsTrue(decode_runway_visual_range_token("R25L/0800U", rvr));
+    Assert::AreEqual(double(800), rvr.visibility_min.distance);
+    Assert::AreEqual(distance_unit::metres, rvr.visibility_min.unit);
+    Assert::AreEqual(rvr_tendency::upward, rvr.tendency);
 }
 
 //-----------------------------------------------------------------------------
 
 void MetarParserTests::METAR_Parser_Weather()
 {
+    auto decode = [](util::string_view const& t, weather& v) { return decode_weather_token(t, v); };
+    weather weatherGroup;
+
     // Empty
-    parse_weather(std::string(""), [&](weather && rvr)
-    {
-        Assert::Fail();
-    });
+    Assert::IsFalse(decode_weather_token("", weatherGroup));
 
     // -DZ
-    bool parsed = false;
-    parse_weather(std::string("-DZ "), [&](weather && weatherGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(weather_intensity::light, weatherGroup.intensity);
-        Assert::AreEqual(weather_descriptor::none, weatherGroup.descriptor);
-        Assert::AreEqual(size_t(1), weatherGroup.phenomena.size());
-        Assert::AreEqual(weather_phenomena::drizzle, weatherGroup.phenomena.at(0));
-    });
-    Assert::IsTrue(parsed);
+    Assert::IsTrue(decode_weather_token("-DZ", weatherGroup));
+    Assert::AreEqual(weather_intensity::light, weatherGroup.intensity);
+    Assert::AreEqual(weather_descriptor::none, weatherGroup.descriptor);
+    Assert::AreEqual(size_t(1), weatherGroup.phenomena.size());
+    Assert::AreEqual(weather_phenomena::drizzle, weatherGroup.phenomena.at(0));
 
     // -RASN
-    parsed = false;
-    parse_weather(std::string("-RASN "), [&](weather && weatherGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(weather_intensity::light, weatherGroup.intensity);
-        Assert::AreEqual(weather_descriptor::none, weatherGroup.descriptor);
-        Assert::AreEqual(size_t(2), weatherGroup.phenomena.size());
-        Assert::AreEqual(weather_phenomena::rain, weatherGroup.phenomena.at(0));
-        Assert::AreEqual(weather_phenomena::snow, weatherGroup.phenomena.at(1));
-    });
-    Assert::IsTrue(parsed);
+    weatherGroup = weather();
+    Assert::IsTrue(decode_weather_token("-RASN", weatherGroup));
+    Assert::AreEqual(weather_intensity::light, weatherGroup.intensity);
+    Assert::AreEqual(weather_descriptor::none, weatherGroup.descriptor);
+    Assert::AreEqual(size_t(2), weatherGroup.phenomena.size());
+    Assert::AreEqual(weather_phenomena::rain, weatherGroup.phenomena.at(0));
+    Assert::AreEqual(weather_phenomena::snow, weatherGroup.phenomena.at(1));
 
     // SN BR
     {
-        std::vector<weather> weatherGroups;
-        std::vector<weather>::iterator it;
-
-        parse_weather(std::string("SN BR "), [&](weather && weatherGroup)
-        {
-            weatherGroups.push_back(weatherGroup);
-        });
+        auto weatherGroups = decode_each<weather>("SN BR", decode);
 
         Assert::AreEqual(size_t(2), weatherGroups.size());
 
-        it = weatherGroups.begin();
+        auto it = weatherGroups.begin();
         Assert::AreEqual(weather_intensity::moderate, it->intensity);
         Assert::AreEqual(weather_descriptor::none, it->descriptor);
         Assert::AreEqual(size_t(1), it->phenomena.size());
@@ -554,17 +450,11 @@ void MetarParserTests::METAR_Parser_Weather()
 
     // -FZRA FG
     {
-        std::vector<weather> weatherGroups;
-        std::vector<weather>::iterator it;
-
-        parse_weather(std::string("-FZRA FG "), [&](weather && weatherGroup)
-        {
-            weatherGroups.push_back(weatherGroup);
-        });
+        auto weatherGroups = decode_each<weather>("-FZRA FG", decode);
 
         Assert::AreEqual(size_t(2), weatherGroups.size());
 
-        it = weatherGroups.begin();
+        auto it = weatherGroups.begin();
         Assert::AreEqual(weather_intensity::light, it->intensity);
         Assert::AreEqual(weather_descriptor::freezing, it->descriptor);
         Assert::AreEqual(size_t(1), it->phenomena.size());
@@ -577,42 +467,28 @@ void MetarParserTests::METAR_Parser_Weather()
     }
 
     // SHRA
-    parsed = false;
-    parse_weather(std::string("SHRA "), [&](weather && weatherGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(weather_intensity::moderate, weatherGroup.intensity);
-        Assert::AreEqual(weather_descriptor::showers, weatherGroup.descriptor);
-        Assert::AreEqual(size_t(1), weatherGroup.phenomena.size());
-        Assert::AreEqual(weather_phenomena::rain, weatherGroup.phenomena.at(0));
-    });
-    Assert::IsTrue(parsed);
+    weatherGroup = weather();
+    Assert::IsTrue(decode_weather_token("SHRA", weatherGroup));
+    Assert::AreEqual(weather_intensity::moderate, weatherGroup.intensity);
+    Assert::AreEqual(weather_descriptor::showers, weatherGroup.descriptor);
+    Assert::AreEqual(size_t(1), weatherGroup.phenomena.size());
+    Assert::AreEqual(weather_phenomena::rain, weatherGroup.phenomena.at(0));
 
     // VCBLSA
-    parsed = false;
-    parse_weather(std::string("VCBLSA "), [&](weather && weatherGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(weather_intensity::in_the_vicinity, weatherGroup.intensity);
-        Assert::AreEqual(weather_descriptor::blowing, weatherGroup.descriptor);
-        Assert::AreEqual(size_t(1), weatherGroup.phenomena.size());
-        Assert::AreEqual(weather_phenomena::sand, weatherGroup.phenomena.at(0));
-    });
-    Assert::IsTrue(parsed);
+    weatherGroup = weather();
+    Assert::IsTrue(decode_weather_token("VCBLSA", weatherGroup));
+    Assert::AreEqual(weather_intensity::in_the_vicinity, weatherGroup.intensity);
+    Assert::AreEqual(weather_descriptor::blowing, weatherGroup.descriptor);
+    Assert::AreEqual(size_t(1), weatherGroup.phenomena.size());
+    Assert::AreEqual(weather_phenomena::sand, weatherGroup.phenomena.at(0));
 
     // -RASN FG HZ
     {
-        std::vector<weather> weatherGroups;
-        std::vector<weather>::iterator it;
-
-        parse_weather(std::string("-RASN FG HZ "), [&](weather && weatherGroup)
-        {
-            weatherGroups.push_back(weatherGroup);
-        });
+        auto weatherGroups = decode_each<weather>("-RASN FG HZ", decode);
 
         Assert::AreEqual(size_t(3), weatherGroups.size());
 
-        it = weatherGroups.begin();
+        auto it = weatherGroups.begin();
         Assert::AreEqual(weather_intensity::light, it->intensity);
         Assert::AreEqual(weather_descriptor::none, it->descriptor);
         Assert::AreEqual(size_t(2), it->phenomena.size());
@@ -631,41 +507,27 @@ void MetarParserTests::METAR_Parser_Weather()
     }
 
     // TS
-    parsed = false;
-    parse_weather(std::string("TS "), [&](weather && weatherGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(weather_intensity::moderate, weatherGroup.intensity);
-        Assert::AreEqual(weather_descriptor::thunderstorm, weatherGroup.descriptor);
-        Assert::AreEqual(size_t(0), weatherGroup.phenomena.size());
-    });
-    Assert::IsTrue(parsed);
+    weatherGroup = weather();
+    Assert::IsTrue(decode_weather_token("TS", weatherGroup));
+    Assert::AreEqual(weather_intensity::moderate, weatherGroup.intensity);
+    Assert::AreEqual(weather_descriptor::thunderstorm, weatherGroup.descriptor);
+    Assert::AreEqual(size_t(0), weatherGroup.phenomena.size());
 
     // +TSRA
-    parsed = false;
-    parse_weather(std::string("+TSRA "), [&](weather && weatherGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(weather_intensity::heavy, weatherGroup.intensity);
-        Assert::AreEqual(weather_descriptor::thunderstorm, weatherGroup.descriptor);
-        Assert::AreEqual(size_t(1), weatherGroup.phenomena.size());
-        Assert::AreEqual(weather_phenomena::rain, weatherGroup.phenomena.at(0));
-    });
-    Assert::IsTrue(parsed);
+    weatherGroup = weather();
+    Assert::IsTrue(decode_weather_token("+TSRA", weatherGroup));
+    Assert::AreEqual(weather_intensity::heavy, weatherGroup.intensity);
+    Assert::AreEqual(weather_descriptor::thunderstorm, weatherGroup.descriptor);
+    Assert::AreEqual(size_t(1), weatherGroup.phenomena.size());
+    Assert::AreEqual(weather_phenomena::rain, weatherGroup.phenomena.at(0));
 
     // +FC TSRAGR BR
     {
-        std::vector<weather> weatherGroups;
-        std::vector<weather>::iterator it;
-
-        parse_weather(std::string("+FC TSRAGR BR "), [&](weather && weatherGroup)
-        {
-            weatherGroups.push_back(weatherGroup);
-        });
+        auto weatherGroups = decode_each<weather>("+FC TSRAGR BR", decode);
 
         Assert::AreEqual(size_t(3), weatherGroups.size());
 
-        it = weatherGroups.begin();
+        auto it = weatherGroups.begin();
         Assert::AreEqual(weather_intensity::heavy, it->intensity);
         Assert::AreEqual(weather_descriptor::none, it->descriptor);
         Assert::AreEqual(size_t(1), it->phenomena.size());
@@ -682,79 +544,65 @@ void MetarParserTests::METAR_Parser_Weather()
         Assert::AreEqual(size_t(1), it->phenomena.size());
         Assert::AreEqual(weather_phenomena::mist, it->phenomena.at(0));
     }
+
+    // RETSRA, recent weather
+    weatherGroup = weather();
+    Assert::IsFalse(decode_recent_weather_token("TSRA", weatherGroup));
+    Assert::IsTrue(decode_recent_weather_token("RETSRA", weatherGroup));
+    Assert::AreEqual(weather_descriptor::thunderstorm, weatherGroup.descriptor);
+    Assert::AreEqual(weather_phenomena::rain, weatherGroup.phenomena.at(0));
 }
 
 //-----------------------------------------------------------------------------
 
 void MetarParserTests::METAR_Parser_SkyCondition()
 {
+    cloud_layer cloudLayer;
+
     // Empty
-    parse_sky_condition(std::string(""), [&](cloud_layer && cloudLayer)
-    {
-        Assert::Fail();
-    });
+    Assert::IsFalse(decode_sky_condition_token("", cloudLayer));
 
     // CLR
-    bool parsed = false;
-    parse_sky_condition(std::string("CLR "), [&](cloud_layer && cloudLayer)
-    {
-        parsed = true;
-        Assert::AreEqual(sky_cover_type::clear_below_12000, cloudLayer.sky_cover);
-        Assert::AreEqual(sky_cover_cloud_type::none, cloudLayer.cloud_type);
-        Assert::AreEqual(UINT32_MAX, cloudLayer.layer_height);
-        Assert::AreEqual(distance_unit::feet, cloudLayer.unit);
-    });
-    Assert::IsTrue(parsed);
+    Assert::IsTrue(decode_sky_condition_token("CLR", cloudLayer));
+    Assert::AreEqual(sky_cover_type::clear_below_12000, cloudLayer.sky_cover);
+    Assert::AreEqual(sky_cover_cloud_type::none, cloudLayer.cloud_type);
+    Assert::AreEqual(UINT32_MAX, cloudLayer.layer_height);
+    Assert::AreEqual(distance_unit::feet, cloudLayer.unit);
 
     // SKC
-    parsed = false;
-    parse_sky_condition(std::string("SKC "), [&](cloud_layer && cloudLayer)
-    {
-        parsed = true;
-        Assert::AreEqual(sky_cover_type::sky_clear, cloudLayer.sky_cover);
-        Assert::AreEqual(sky_cover_cloud_type::none, cloudLayer.cloud_type);
-        Assert::AreEqual(UINT32_MAX, cloudLayer.layer_height);
-        Assert::AreEqual(distance_unit::feet, cloudLayer.unit);
-    });
-    Assert::IsTrue(parsed);
+    cloudLayer = cloud_layer();
+    Assert::IsTrue(decode_sky_condition_token("SKC", cloudLayer));
+    Assert::AreEqual(sky_cover_type::sky_clear, cloudLayer.sky_cover);
+    Assert::AreEqual(sky_cover_cloud_type::none, cloudLayer.cloud_type);
+    Assert::AreEqual(UINT32_MAX, cloudLayer.layer_height);
+    Assert::AreEqual(distance_unit::feet, cloudLayer.unit);
 
     // VV003
-    parsed = false;
-    parse_sky_condition(std::string("VV003 "), [&](cloud_layer && cloudLayer)
-    {
-        parsed = true;
-        Assert::AreEqual(sky_cover_type::vertical_visibility, cloudLayer.sky_cover);
-        Assert::AreEqual(sky_cover_cloud_type::unspecified, cloudLayer.cloud_type);
-        Assert::AreEqual(uint32_t(300), cloudLayer.layer_height);
-        Assert::AreEqual(distance_unit::feet, cloudLayer.unit);
-    });
-    Assert::IsTrue(parsed);
+    cloudLayer = cloud_layer();
+    Assert::IsTrue(decode_sky_condition_token("VV003", cloudLayer));
+    Assert::AreEqual(sky_cover_type::vertical_visibility, cloudLayer.sky_cover);
+    Assert::AreEqual(sky_cover_cloud_type::unspecified, cloudLayer.cloud_type);
+    Assert::AreEqual(uint32_t(300), cloudLayer.layer_height);
+    Assert::AreEqual(distance_unit::feet, cloudLayer.unit);
 
     // BKN060CB
-    parsed = false;
-    parse_sky_condition(std::string("BKN060CB "), [&](cloud_layer && cloudLayer)
-    {
-        parsed = true;
-        Assert::AreEqual(sky_cover_type::broken, cloudLayer.sky_cover);
-        Assert::AreEqual(sky_cover_cloud_type::cumulonimbus, cloudLayer.cloud_type);
-        Assert::AreEqual(uint32_t(6000), cloudLayer.layer_height);
-        Assert::AreEqual(distance_unit::feet, cloudLayer.unit);
-    });
-    Assert::IsTrue(parsed);
+    cloudLayer = cloud_layer();
+    Assert::IsTrue(decode_sky_condition_token("BKN060CB", cloudLayer));
+    Assert::AreEqual(sky_cover_type::broken, cloudLayer.sky_cover);
+    Assert::AreEqual(sky_cover_cloud_type::cumulonimbus, cloudLayer.cloud_type);
+    Assert::AreEqual(uint32_t(6000), cloudLayer.layer_height);
+    Assert::AreEqual(distance_unit::feet, cloudLayer.unit);
 
     // FEW008 SCT030
     {
-        std::vector<cloud_layer> skyConditionGroup;
-        std::vector<cloud_layer>::iterator it;
-
-        parse_sky_condition(std::string("FEW008 SCT030 "), [&](cloud_layer && cloudLayer)
+        auto skyConditionGroup = decode_each<cloud_layer>("FEW008 SCT030", [](util::string_view const& t, cloud_layer& v)
         {
-            skyConditionGroup.push_back(cloudLayer);
+            return decode_sky_condition_token(t, v);
         });
 
         Assert::AreEqual(size_t(2), skyConditionGroup.size());
 
-        it = skyConditionGroup.begin();
+        auto it = skyConditionGroup.begin();
         Assert::AreEqual(sky_cover_type::few, it->sky_cover);
         Assert::AreEqual(sky_cover_cloud_type::unspecified, it->cloud_type);
         Assert::AreEqual(uint32_t(800), it->layer_height);
@@ -771,92 +619,58 @@ void MetarParserTests::METAR_Parser_SkyCondition()
 
 void MetarParserTests::METAR_Parser_TemperatureDewpoint()
 {
+    temperature_dewpoint value;
+
     // Empty
-    parse_temperature_dewpoint(std::string(""), [&](util::optional<int8_t> temperature, util::optional<int8_t> dewpoint)
-    {
-        Assert::Fail();
-    });
+    Assert::IsFalse(decode_temperature_dewpoint_token("", value));
 
     // Temperature: 19C, Dewpoint: 4C
-    bool parsed = false;
-    parse_temperature_dewpoint(std::string("19/04 "), [&](util::optional<int8_t> temperature, util::optional<int8_t> dewpoint)
-    {
-        parsed = true;
-        Assert::AreEqual(int8_t(19), *(temperature));
-        Assert::AreEqual(int8_t(4), *(dewpoint));
-    });
-    Assert::IsTrue(parsed);
+    Assert::IsTrue(decode_temperature_dewpoint_token("19/04", value));
+    Assert::AreEqual(int8_t(19), *(value.first));
+    Assert::AreEqual(int8_t(4), *(value.second));
 
     // Temperature: -3C, Dewpoint: -9C
-    parsed = false;
-    parse_temperature_dewpoint(std::string("M03/M09 "), [&](util::optional<int8_t> temperature, util::optional<int8_t> dewpoint)
-    {
-        parsed = true;
-        Assert::AreEqual(int8_t(-3), *(temperature));
-        Assert::AreEqual(int8_t(-9), *(dewpoint));
-    });
-    Assert::IsTrue(parsed);
-    
+    value = temperature_dewpoint();
+    Assert::IsTrue(decode_temperature_dewpoint_token("M03/M09", value));
+    Assert::AreEqual(int8_t(-3), *(value.first));
+    Assert::AreEqual(int8_t(-9), *(value.second));
+
     // Temperature: 17C, Dewpoint: missing
-    parsed = false;
-    parse_temperature_dewpoint(std::string("17/ "), [&](util::optional<int8_t> temperature, util::optional<int8_t> dewpoint)
-    {
-        parsed = true;
-        Assert::AreEqual(int8_t(17), *(temperature));
-        Assert::IsFalse(static_cast<bool>(dewpoint));
-    });
-    Assert::IsTrue(parsed);
+    value = temperature_dewpoint();
+    Assert::IsTrue(decode_temperature_dewpoint_token("17/", value));
+    Assert::AreEqual(int8_t(17), *(value.first));
+    Assert::IsFalse(static_cast<bool>(value.second));
 }
 
 //-----------------------------------------------------------------------------
 
 void MetarParserTests::METAR_Parser_Altimeter()
 {
+    altimeter altimeterGroup;
+
     // Empty
-    parse_altimeter(std::string(""), [&](altimeter && altimeterGroup)
-    {
-        Assert::Fail();
-    });
+    Assert::IsFalse(decode_altimeter_token("", altimeterGroup));
 
     // QNH 1013
-    bool parsed = false;
-    parse_altimeter(std::string("Q1013"), [&](altimeter && altimeterGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(1013.0, altimeterGroup.pressure);
-        Assert::AreEqual(pressure_unit::hPa, altimeterGroup.unit);
-    });
-    Assert::IsTrue(parsed);
+    Assert::IsTrue(decode_altimeter_token("Q1013", altimeterGroup));
+    Assert::AreEqual(1013.0, altimeterGroup.pressure);
+    Assert::AreEqual(pressure_unit::hPa, altimeterGroup.unit);
 
     // Altimeter 29.92
-    parsed = false;
-    parse_altimeter(std::string("A2992"), [&](altimeter && altimeterGroup)
-    {
-        parsed = true;
-        Assert::AreEqual(29.92, altimeterGroup.pressure);
-        Assert::AreEqual(pressure_unit::inHg, altimeterGroup.unit);
-    });
-    Assert::IsTrue(parsed);
+    Assert::IsTrue(decode_altimeter_token("A2992", altimeterGroup));
+    Assert::AreEqual(29.92, altimeterGroup.pressure);
+    Assert::AreEqual(pressure_unit::inHg, altimeterGroup.unit);
 }
 
 //-----------------------------------------------------------------------------
 
 void MetarParserTests::METAR_Parser_Remarks()
 {
-    // Empty
-    parse_remarks(std::string(""), [&](std::string const& remarks)
-    {
-        Assert::Fail();
-    });
+    // None
+    Assert::AreEqual(std::string(""), metar("KSFO 081753Z A2992").remarks);
 
     // RMK AO1
-    bool parsed = false;
-    parse_remarks(std::string("RMK AO1"), [&](std::string const& remarks)
-    {
-        parsed = true;
-        Assert::AreEqual(std::string("AO1"), remarks);
-    });
-    Assert::IsTrue(parsed);
+    Assert::AreEqual(std::string("AO1"), metar("KSFO 081753Z A2992 RMK AO1").remarks);
 }
 
 //-----------------------------------------------------------------------------
@@ -16,9 +16,12 @@
 #include "AviationWeather.TestPch.h"
 
 #include <string>
+#include <unordered_set>
+#include <vector>
 
 #include <AviationWeather/converters.h>
 #include <AviationWeather/metar.h>
+#include <AviationWeather/serialization.h>
 #include <AviationWeather/types.h>
 
 #include "framework.h"
@@ -45,6 +48,9 @@ public:
     TEST_METHOD(METAR_Phenomena);
     TEST_METHOD(METAR_TemperatureDewpointSpread);
     TEST_METHOD(METAR_CeilingAndFlightCategory);
+    TEST_METHOD(METAR_View);
+    TEST_METHOD(METAR_ViewToOwned);
+    TEST_METHOD(METAR_ContentHash);
 };
 
 //-----------------------------------------------------------------------------
@@ -444,5 +450,114 @@ void MetarTests::METAR_CeilingAndFlightCategory()
 
 //-----------------------------------------------------------------------------
 
+void MetarTests::METAR_View()
+{
+    const char buffer[] = "METAR KSFO 102356Z 27019G24KT 10SM FEW008 SCT012 BKN015 21/14 A2994 RMK AO2 PK WND 27028/2303 SLP137";
+
+    aw::metar_view v1(buffer);
+    Assert::IsTrue(v1.raw_data.data() == buffer);
+    Assert::IsTrue(v1.identifier.data() == buffer + 6);
+    Assert::AreEqual(std::string("KSFO"), v1.identifier.to_string());
+    Assert::AreEqual(std::string("AO2 PK WND 27028/2303 SLP137"), v1.remarks.to_string());
+    Assert::IsTrue(v1.remarks.data() >= buffer && v1.remarks.data() < buffer + sizeof(buffer));
+
+    aw::metar m1(buffer);
+    Assert::AreEqual(m1.identifier, v1.identifier.to_string());
+    Assert::AreEqual(m1.remarks, v1.remarks.to_string());
+    Assert::IsTrue(m1.wind_group == v1.wind_group);
+    Assert::IsTrue(m1.visibility_group == v1.visibility_group);
+    Assert::IsTrue(m1.sky_condition_group == v1.sky_condition_group);
+    Assert::IsTrue(m1.altimeter_group == v1.altimeter_group);
+    Assert::AreEqual(m1.ceiling().layer_height, v1.ceiling().layer_height);
+    Assert::AreEqual(m1.flight_category(), v1.flight_category());
+    Assert::AreEqual(m1.temperature_dewpoint_spread(), v1.temperature_dewpoint_spread());
+
+    // A view over a sub-range of a larger buffer
+    std::string feed = "KRHV 122047Z 32009KT 10SM SKC 28/11 A3002\nKHAF 291935Z AUTO 24004KT 10SM 18/18 A3004 RMK AO2\n";
+    auto newline = feed.find('\n');
+
+    aw::metar_view v2(util::string_view(feed.data(), newline));
+    Assert::AreEqual(std::string("KRHV"), v2.identifier.to_string());
+    Assert::IsTrue(v2.remarks.empty());
+
+    aw::metar_view v3(util::string_view(feed.data() + newline + 1, feed.size() - newline - 2));
+    Assert::AreEqual(std::string("KHAF"), v3.identifier.to_string());
+    Assert::AreEqual(std::string("AO2"), v3.remarks.to_string());
+    Assert::AreEqual(aw::metar_modifier_type::automatic, v3.modifier);
+    Assert::ExpectException<aw_exception>([&v3]()
+    {
+        v3.ceiling();
+    });
+}
+
+//-----------------------------------------------------------------------------
+
+void MetarTests::METAR_ViewToOwned()
+{
+    aw::metar_view::unique_pointer view;
+    {
+        std::string buffer("KPDX 041453Z 32007KT 1SM R10R/3000VP6000FT BR BKN003 OVC010 10/09 A3000 RMK AO2 SFC VIS 4");
+        view.reset(new aw::metar_view(buffer));
+
+        aw::metar owned = view->to_owned();
+        buffer.assign(buffer.size(), 'X');
+
+        aw::metar expected("KPDX 041453Z 32007KT 1SM R10R/3000VP6000FT BR BKN003 OVC010 10/09 A3000 RMK AO2 SFC VIS 4");
+        Assert::IsTrue(expected == owned);
+        Assert::AreEqual(expected.raw_data, owned.raw_data);
+        Assert::AreEqual(std::string("KPDX"), owned.identifier);
+        Assert::AreEqual(std::string("AO2 SFC VIS 4"), owned.remarks);
+        Assert::AreEqual(aw::flight_category::lifr, owned.flight_category());
+    }
+    Assert::AreEqual(size_t(1), view->runway_visual_range_group.size());
+}
+
+//-----------------------------------------------------------------------------
+
+void MetarTests::METAR_ContentHash()
+{
+    aw::metar m1("KSFO 172256Z 00000KT 9SM CLR 19/04 A3012 RMK AO2");
+    aw::metar m2("METAR KSFO 172256Z 00000KT 9SM CLR 19/04 A3012 RMK AO2");
+    aw::metar m3("KSFO 172256Z 00000KT 9SM CLR 19/04 A3011 RMK AO2");
+    aw::metar m4("KSFO 172256Z 00000KT 9SM CLR 19/04 A3012 RMK AO1");
+    aw::metar m5("KSFO 172356Z 00000KT 9SM CLR 19/04 A3012 RMK AO2");
+
+    // Equal reports share a fingerprint even when the raw text differs
+    Assert::IsTrue(m1 == m2);
+    Assert::AreEqual(m1.content_hash(), m2.content_hash());
+
+    Assert::AreNotEqual(m1.content_hash(), m3.content_hash());
+    Assert::AreNotEqual(m1.content_hash(), m4.content_hash());
+    Assert::AreNotEqual(m1.content_hash(), m5.content_hash());
+
+    // The fingerprint follows the report through copies and moves
+    aw::metar copy(m1);
+    Assert::AreEqual(m1.content_hash(), copy.content_hash());
+    aw::metar moved(std::move(copy));
+    Assert::AreEqual(m1.content_hash(), moved.content_hash());
+    Assert::AreNotEqual(m1.content_hash(), copy.content_hash());
+
+    // Moved-from reports skip hashing their empty fields, and agree with
+    // decoding, which hashes every field
+    std::vector<uint8_t> encoded;
+    encode(copy, encoded);
+    Assert::AreEqual(copy.content_hash(), decode(encoded.data(), encoded.size()).content_hash());
+
+    std::string buffer(m1.raw_data);
+    aw::metar_view view(buffer);
+    Assert::AreEqual(m1.content_hash(), view.content_hash());
+    Assert::AreEqual(m1.content_hash(), view.to_owned().content_hash());
+
+    std::unordered_set<aw::metar> reports;
+    reports.insert(m1);
+    reports.insert(m2);
+    reports.insert(m3);
+    Assert::AreEqual(size_t(2), reports.size());
+    Assert::IsTrue(reports.count(m2) == 1);
+    Assert::AreEqual(std::hash<aw::metar>()(m1), std::hash<aw::metar>()(m2));
+}
+
+//-----------------------------------------------------------------------------
+
 } // namespace test
 } // namespace aw
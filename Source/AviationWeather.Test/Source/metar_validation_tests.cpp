@@ -48,6 +48,9 @@ std::string element_type_strings[] =
     STRINGIFY(sky_condition),
     STRINGIFY(temperature_dewpoint),
     STRINGIFY(altimeter),
+    STRINGIFY(recent_weather),
+    STRINGIFY(wind_shear),
+    STRINGIFY(trend),
     STRINGIFY(remarks)
 };
 
@@ -161,7 +164,8 @@ std::string flight_category_strings[] =
 std::string speed_unit_strings[] =
 {
     STRINGIFY(kt),
-    STRINGIFY(mph)
+    STRINGIFY(mph),
+    STRINGIFY(mps)
 };
 
 std::string distance_unit_strings[] =
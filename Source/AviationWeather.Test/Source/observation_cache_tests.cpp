@@ -0,0 +1,249 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <AviationWeather/observation_cache.h>
+
+#include "framework.h"
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+metar::const_pointer make_report(std::string const& text)
+{
+    return std::make_shared<const metar>(text);
+}
+
+// A report for a synthetic station at the given minute of the day
+metar::const_pointer make_report(size_t station, uint32_t minutes)
+{
+    char text[64];
+    snprintf(text, sizeof(text), "K%03u 12%02u%02uZ 27010KT 10SM CLR 15/05 A2992",
+        static_cast<unsigned>(station % 1000), (minutes / 60) % 24, minutes % 60);
+    return make_report(text);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(ObservationCacheTests)
+{
+public:
+    TEST_METHOD(ObservationCache_Ordering);
+    TEST_METHOD(ObservationCache_CorrectionsAndSpecials);
+    TEST_METHOD(ObservationCache_Growth);
+    TEST_METHOD(ObservationCache_Clear);
+    TEST_METHOD(ObservationCache_ConcurrentReaders);
+};
+
+//-----------------------------------------------------------------------------
+
+void ObservationCacheTests::ObservationCache_Ordering()
+{
+    observation_cache cache;
+    Assert::IsFalse(static_cast<bool>(cache.find("KSFO")));
+
+    Assert::IsTrue(cache.update(make_report("METAR KSFO 121756Z 28010KT 10SM CLR 18/08 A3001")));
+    Assert::IsTrue(cache.update(make_report("METAR KSFO 121856Z 28014KT 10SM FEW010 19/08 A3000")));
+    Assert::IsFalse(cache.update(make_report("METAR KSFO 121656Z 28008KT 10SM CLR 17/08 A3002")));
+    Assert::IsFalse(cache.update(make_report("METAR KSFO 121856Z 28014KT 10SM FEW010 19/08 A3000")));
+
+    auto current = cache.find("KSFO");
+    Assert::IsTrue(static_cast<bool>(current));
+    Assert::AreEqual(uint8_t(18), current->observation_time.hour_of_day);
+    Assert::AreEqual(size_t(1), cache.size());
+
+    // Across the end of a month
+    Assert::IsTrue(cache.update(metar("METAR KOAK 312356Z 28010KT 10SM CLR 18/08 A3001")));
+    Assert::IsTrue(cache.update(metar("METAR KOAK 010056Z 28010KT 10SM CLR 17/08 A3001")));
+    Assert::AreEqual(uint8_t(1), cache.find(std::string("KOAK"))->observation_time.day_of_month);
+    Assert::AreEqual(size_t(2), cache.size());
+
+    Assert::ExpectException<aw_exception>([&cache]() { cache.update(metar::const_pointer()); });
+}
+
+//-----------------------------------------------------------------------------
+
+void ObservationCacheTests::ObservationCache_CorrectionsAndSpecials()
+{
+    metar routine("METAR KPDX 041453Z 32007KT 10SM BKN030 10/09 A3000");
+    metar special("SPECI KPDX 041512Z 32007KT 1SM BR BKN003 10/09 A3000");
+    metar corrected("METAR KPDX 041453Z COR 32007KT 10SM BKN025 10/09 A3000");
+
+    Assert::IsTrue(supersedes(special, routine));
+    Assert::IsFalse(supersedes(routine, special));
+    Assert::IsTrue(supersedes(corrected, routine));
+    Assert::IsFalse(supersedes(routine, corrected));
+    Assert::IsFalse(supersedes(corrected, corrected));
+    Assert::IsFalse(supersedes(corrected, special));
+
+    observation_cache cache;
+    cache.update(routine);
+    cache.update(corrected);
+    Assert::IsTrue(cache.find("KPDX")->modifier == metar_modifier_type::corrected);
+
+    cache.update(special);
+    Assert::IsTrue(cache.find("KPDX")->type == metar_report_type::special);
+
+    // A late correction to the earlier routine report does not displace the SPECI
+    Assert::IsFalse(cache.update(metar("METAR KPDX 041453Z COR 32007KT 10SM BKN020 10/09 A3000")));
+    Assert::IsTrue(cache.find("KPDX")->type == metar_report_type::special);
+}
+
+//-----------------------------------------------------------------------------
+
+void ObservationCacheTests::ObservationCache_Growth()
+{
+    observation_cache cache(4);
+
+    std::vector<metar::const_pointer> reports;
+    for (size_t station = 0; station < 1000; ++station)
+    {
+        reports.push_back(make_report(station, 60));
+    }
+    Assert::AreEqual(size_t(1000), cache.update(reports));
+    Assert::AreEqual(size_t(1000), cache.size());
+    Assert::AreEqual(size_t(1000), cache.snapshot().size());
+
+    for (size_t station = 0; station < 1000; ++station)
+    {
+        Assert::IsTrue(cache.find(reports[station]->identifier) == reports[station]);
+    }
+    Assert::IsFalse(static_cast<bool>(cache.find("KXYZ")));
+
+    // Only half of the burst is newer than what is held
+    std::vector<metar::const_pointer> burst;
+    for (size_t station = 0; station < 1000; ++station)
+    {
+        burst.push_back(make_report(station, station % 2 == 0 ? 120 : 30));
+    }
+    Assert::AreEqual(size_t(500), cache.update(burst));
+    Assert::AreEqual(uint8_t(2), cache.find("K000")->observation_time.hour_of_day);
+    Assert::AreEqual(uint8_t(1), cache.find("K001")->observation_time.hour_of_day);
+}
+
+//-----------------------------------------------------------------------------
+
+void ObservationCacheTests::ObservationCache_Clear()
+{
+    observation_cache cache;
+    cache.update(make_report(1, 60));
+    cache.update(make_report(2, 60));
+
+    auto held = cache.find("K001");
+    cache.clear();
+
+    Assert::AreEqual(size_t(0), cache.size());
+    Assert::IsFalse(static_cast<bool>(cache.find("K001")));
+    Assert::IsTrue(cache.snapshot().empty());
+
+    // Reports handed out before clearing remain valid
+    Assert::AreEqual(std::string("K001"), held->identifier);
+
+    cache.update(make_report(1, 30));
+    Assert::AreEqual(uint8_t(0), cache.find("K001")->observation_time.hour_of_day);
+}
+
+//-----------------------------------------------------------------------------
+
+void ObservationCacheTests::ObservationCache_ConcurrentReaders()
+{
+    const size_t stationCount = 200;
+    const uint32_t updateCount = 50;
+
+    observation_cache cache(16);
+    std::atomic<bool> done(false);
+    std::vector<int> results(4, 1);
+
+    // Readers must only ever see each station move forward in time
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < results.size(); ++t)
+    {
+        readers.emplace_back([&cache, &done, &results, t, stationCount]()
+        {
+            std::vector<int32_t> latest(stationCount, -1);
+            char identifier[8];
+            while (!done.load())
+            {
+                for (size_t station = 0; station < stationCount; ++station)
+                {
+                    snprintf(identifier, sizeof(identifier), "K%03u", static_cast<unsigned>(station));
+                    auto report = cache.find(identifier);
+                    if (!report)
+                    {
+                        continue;
+                    }
+
+                    auto minutes = report->observation_time.hour_of_day * 60 + report->observation_time.minute_of_hour;
+                    if (report->identifier != identifier || minutes < latest[station])
+                    {
+                        results[t] = 0;
+                    }
+                    latest[station] = minutes;
+                }
+            }
+        });
+    }
+
+    for (uint32_t update = 1; update <= updateCount; ++update)
+    {
+        std::vector<metar::const_pointer> burst;
+        for (size_t station = 0; station < stationCount; ++station)
+        {
+            burst.push_back(make_report(station, update));
+        }
+        cache.update(burst);
+    }
+
+    done.store(true);
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+
+    for (auto result : results)
+    {
+        Assert::AreEqual(1, result);
+    }
+    Assert::AreEqual(stationCount, cache.size());
+    Assert::AreEqual(uint8_t(updateCount), cache.find("K199")->observation_time.minute_of_hour);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
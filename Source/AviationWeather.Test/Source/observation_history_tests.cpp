@@ -0,0 +1,271 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include <AviationWeather/observation_history.h>
+
+#include "framework.h"
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+// Hourly reports with a falling altimeter and a rising temperature
+std::string hourly_report(uint32_t hour, int temperature, int altimeter)
+{
+    char text[96];
+    snprintf(text, sizeof(text), "METAR KSFO %02u%02u56Z 28010G18KT 10SM BKN015 %s%02d/05 A%04d",
+        12 + hour / 24, hour % 24, temperature < 0 ? "M" : "", temperature < 0 ? -temperature : temperature, altimeter);
+    return text;
+}
+
+// Hourly reports from the last day of a month of the given length into the
+// next month, with a falling altimeter
+std::string rollover_report(uint32_t hour, uint32_t monthLength)
+{
+    auto day = monthLength + hour / 24;
+    if (day > monthLength)
+    {
+        day -= monthLength;
+    }
+
+    char text[96];
+    snprintf(text, sizeof(text), "METAR KSFO %02u%02u56Z 28010KT 10SM BKN015 10/05 A%04u", day, hour % 24, 3010 - 3 * hour);
+    return text;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(ObservationHistoryTests)
+{
+public:
+    TEST_METHOD(ObservationHistory_Record);
+    TEST_METHOD(ObservationHistory_Append);
+    TEST_METHOD(ObservationHistory_Retention);
+    TEST_METHOD(ObservationHistory_Scans);
+    TEST_METHOD(ObservationHistory_Trends);
+    TEST_METHOD(ObservationHistory_MonthRollover);
+};
+
+//-----------------------------------------------------------------------------
+
+void ObservationHistoryTests::ObservationHistory_Record()
+{
+    Assert::AreEqual(size_t(20), sizeof(observation_record));
+
+    observation_history history;
+    Assert::IsTrue(history.append(metar("SPECI KPDX 041512Z 32007MPS 1SM BR BKN003 OVC010 10/09 A3000")));
+
+    auto record = history.latest("KPDX");
+    Assert::IsTrue(record != nullptr);
+    Assert::IsTrue(record->observation_time() == time(4, 15, 12));
+    Assert::IsTrue(record->flight_category() == flight_category::lifr);
+    Assert::IsTrue((record->flags & observation_record::special_flag) != 0);
+    Assert::AreEqual(1015.9, *record->altimeter(), 0.05);
+    Assert::AreEqual(int8_t(10), *record->temperature_celsius());
+    Assert::AreEqual(int8_t(9), *record->dewpoint_celsius());
+    Assert::AreEqual(uint8_t(14), *record->wind_speed_knots());
+    Assert::AreEqual(uint16_t(320), record->wind_direction);
+    Assert::AreEqual(1609.0, *record->visibility_metres(), 1.0);
+    Assert::AreEqual(uint16_t(3), record->ceiling);
+
+    Assert::IsTrue(history.append(metar_view("KOAK 041553Z 10SM CLR A2992")));
+    record = history.latest("KOAK");
+    Assert::IsFalse(static_cast<bool>(record->temperature_celsius()));
+    Assert::IsFalse(static_cast<bool>(record->wind_speed_knots()));
+    Assert::AreEqual(uint16_t(UINT16_MAX), record->ceiling);
+    Assert::AreEqual(size_t(2), history.station_count());
+
+    Assert::ExpectException<aw_exception>([]() { observation_history(24, 0); });
+}
+
+//-----------------------------------------------------------------------------
+
+void ObservationHistoryTests::ObservationHistory_Append()
+{
+    observation_history history;
+    Assert::IsTrue(history.append(metar("METAR KPDX 041453Z 32007KT 10SM BKN030 10/09 A3000")));
+    Assert::IsFalse(history.append(metar("METAR KPDX 041453Z 32007KT 10SM BKN030 10/09 A3000")));
+    Assert::IsFalse(history.append(metar("METAR KPDX 041353Z 32007KT 10SM BKN030 11/09 A3001")));
+    Assert::IsTrue(history.previous("KPDX") == nullptr);
+
+    // A correction replaces the report it corrects rather than adding one
+    Assert::IsTrue(history.append(metar("METAR KPDX 041453Z COR 32007KT 10SM BKN025 10/09 A3000")));
+    Assert::AreEqual(size_t(1), history.size("KPDX"));
+    Assert::AreEqual(uint16_t(25), history.latest("KPDX")->ceiling);
+
+    Assert::IsTrue(history.append(metar("SPECI KPDX 041512Z 32007KT 1SM BR BKN003 10/09 A3000")));
+    Assert::AreEqual(size_t(2), history.size("KPDX"));
+    Assert::AreEqual(uint16_t(25), history.previous("KPDX")->ceiling);
+    Assert::AreEqual(uint16_t(3), history.latest("KPDX")->ceiling);
+
+    Assert::IsTrue(history.latest("KSFO") == nullptr);
+    Assert::AreEqual(size_t(0), history.size("KSFO"));
+}
+
+//-----------------------------------------------------------------------------
+
+void ObservationHistoryTests::ObservationHistory_Retention()
+{
+    // Capacity limits the records held
+    observation_history small(48, 4);
+    for (uint32_t hour = 0; hour < 10; ++hour)
+    {
+        small.append(metar(hourly_report(hour, 10, 3000)));
+    }
+    Assert::AreEqual(size_t(4), small.size("KSFO"));
+    Assert::AreEqual(uint8_t(9), small.latest("KSFO")->observation_time().hour_of_day);
+    Assert::AreEqual(uint8_t(8), small.previous("KSFO")->observation_time().hour_of_day);
+
+    // The retention period limits them too, across the day boundary
+    observation_history recent(6, 48);
+    for (uint32_t hour = 0; hour < 30; ++hour)
+    {
+        recent.append(metar(hourly_report(hour, 10, 3000)));
+    }
+    Assert::AreEqual(size_t(7), recent.size("KSFO"));
+    Assert::IsTrue(recent.latest("KSFO")->observation_time() == time(13, 5, 56));
+}
+
+//-----------------------------------------------------------------------------
+
+void ObservationHistoryTests::ObservationHistory_Scans()
+{
+    observation_history history(24, 8);
+    for (uint32_t hour = 0; hour < 12; ++hour)
+    {
+        history.append(metar(hourly_report(hour, 10 + static_cast<int>(hour), 3000)));
+    }
+
+    std::vector<observation_record> records;
+    history.last_hours("KSFO", 3, records);
+    Assert::AreEqual(size_t(4), records.size());
+    Assert::AreEqual(uint8_t(8), records.front().observation_time().hour_of_day);
+    Assert::AreEqual(uint8_t(11), records.back().observation_time().hour_of_day);
+
+    // Only the last eight records are held, so the ring has wrapped
+    history.range("KSFO", time(12, 0, 0), time(12, 10, 0), records);
+    Assert::AreEqual(size_t(6), records.size());
+    for (size_t i = 1; i < records.size(); ++i)
+    {
+        Assert::IsTrue(records[i - 1].epoch_minute < records[i].epoch_minute);
+    }
+    Assert::AreEqual(int8_t(14), *records.front().temperature_celsius());
+
+    history.last_hours("KXYZ", 3, records);
+    Assert::IsTrue(records.empty());
+}
+
+//-----------------------------------------------------------------------------
+
+void ObservationHistoryTests::ObservationHistory_Trends()
+{
+    observation_history history;
+    Assert::IsFalse(static_cast<bool>(history.pressure_tendency("KSFO")));
+
+    for (uint32_t hour = 0; hour < 6; ++hour)
+    {
+        history.append(metar(hourly_report(hour, 20 - 2 * static_cast<int>(hour), 3010 - 3 * static_cast<int>(hour))));
+    }
+
+    // 29.95 inHg now, 30.04 inHg three hours before
+    Assert::AreEqual(-3.0, *history.pressure_tendency("KSFO"), 0.1);
+    Assert::AreEqual(-6.0, *history.temperature_change("KSFO"));
+    Assert::AreEqual(-2.0, *history.temperature_change("KSFO", 1));
+
+    // No report near the requested time
+    Assert::IsFalse(static_cast<bool>(history.temperature_change("KSFO", 12)));
+
+    // A report without temperature has no trend
+    history.append(metar("METAR KSFO 120656Z 28010KT 10SM CLR A2990"));
+    Assert::IsFalse(static_cast<bool>(history.temperature_change("KSFO")));
+    Assert::AreEqual(-3.7, *history.pressure_tendency("KSFO"), 0.15);
+}
+
+//-----------------------------------------------------------------------------
+
+void ObservationHistoryTests::ObservationHistory_MonthRollover()
+{
+    // Midnight UTC on the first day of each run, in months of 30, 28, 29 and
+    // 31 days
+    struct
+    {
+        uint32_t    monthLength;
+        std::time_t start;
+    } months[] =
+    {
+        { 30, 1790726400 },  // 2026-09-30
+        { 28, 1772236800 },  // 2026-02-28
+        { 29, 1709164800 },  // 2024-02-29
+        { 31, 1793404800 }   // 2026-10-31
+    };
+
+    for (auto const& month : months)
+    {
+        observation_history history;
+        for (uint32_t hour = 0; hour < 30; ++hour)
+        {
+            Assert::IsTrue(history.append(metar(rollover_report(hour, month.monthLength)), month.start + hour * 3600));
+        }
+
+        // A day of hourly reports, whatever the length of the month
+        Assert::AreEqual(size_t(25), history.size("KSFO"));
+        Assert::IsTrue(history.latest("KSFO")->observation_time() == time(1, 5, 56));
+        Assert::AreEqual(-3.0, *history.pressure_tendency("KSFO"), 0.15);
+
+        std::vector<observation_record> records;
+        history.last_hours("KSFO", 8, records);
+        Assert::AreEqual(size_t(9), records.size());
+        Assert::IsTrue(records.front().observation_time() == time(static_cast<uint8_t>(month.monthLength), 21, 56));
+
+        history.range("KSFO", time(static_cast<uint8_t>(month.monthLength), 22, 0), time(1, 2, 0), records);
+        Assert::AreEqual(size_t(4), records.size());
+        Assert::AreEqual(60u, records[2].epoch_minute - records[1].epoch_minute);
+    }
+
+    // Later reports are placed relative to the station's latest one, not to
+    // the time they were received
+    observation_history history(48);
+    Assert::IsTrue(history.append(metar(rollover_report(0, 30)), 1790726400));
+    Assert::IsTrue(history.append(metar(rollover_report(30, 30)), 0));
+    Assert::AreEqual(size_t(2), history.size("KSFO"));
+    Assert::AreEqual(30u * 60u, history.latest("KSFO")->epoch_minute - history.previous("KSFO")->epoch_minute);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
@@ -0,0 +1,266 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include <AviationWeather/observation_history.h>
+#include <AviationWeather/observation_snapshot.h>
+
+#include "framework.h"
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const char* g_stations[] = { "KSFO", "EGLL", "KOAK", "CYYZ", "KPDX" };
+
+// Hourly reports for several stations over more hours than each ring holds
+observation_history make_history()
+{
+    observation_history history(24, 8);
+    for (uint32_t hour = 0; hour < 12; ++hour)
+    {
+        for (size_t station = 0; station < sizeof(g_stations) / sizeof(g_stations[0]); ++station)
+        {
+            char text[96];
+            snprintf(text, sizeof(text), "METAR %s 12%02u56Z 28010KT 10SM BKN015 %02u/05 A%04u",
+                g_stations[station], hour, static_cast<unsigned>(10 + hour + station), static_cast<unsigned>(3010 - 3 * hour));
+            history.append(metar(text));
+        }
+    }
+    return history;
+}
+
+bool same_records(std::vector<observation_record> const& a, std::vector<observation_record> const& b)
+{
+    return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(observation_record)) == 0);
+}
+
+void check_queries(observation_history const& history, observation_snapshot const& snapshot)
+{
+    Assert::AreEqual(history.hours(), snapshot.hours());
+    Assert::AreEqual(history.station_count(), snapshot.station_count());
+
+    std::vector<observation_record> expected;
+    std::vector<observation_record> actual;
+    for (auto identifier : g_stations)
+    {
+        Assert::AreEqual(history.size(identifier), snapshot.size(identifier));
+        Assert::AreEqual(0, memcmp(history.latest(identifier), snapshot.latest(identifier), sizeof(observation_record)));
+        Assert::AreEqual(0, memcmp(history.previous(identifier), snapshot.previous(identifier), sizeof(observation_record)));
+
+        history.last_hours(identifier, 3, expected);
+        snapshot.last_hours(identifier, 3, actual);
+        Assert::IsTrue(same_records(expected, actual));
+
+        history.range(identifier, time(12, 5, 0), time(12, 10, 0), expected);
+        snapshot.range(identifier, time(12, 5, 0), time(12, 10, 0), actual);
+        Assert::IsTrue(same_records(expected, actual));
+
+        Assert::AreEqual(*history.pressure_tendency(identifier), *snapshot.pressure_tendency(identifier));
+        Assert::AreEqual(*history.temperature_change(identifier, 2), *snapshot.temperature_change(identifier, 2));
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(ObservationSnapshotTests)
+{
+public:
+    TEST_METHOD(ObservationSnapshot_Queries);
+    TEST_METHOD(ObservationSnapshot_File);
+    TEST_METHOD(ObservationSnapshot_Move);
+    TEST_METHOD(ObservationSnapshot_MonthRollover);
+    TEST_METHOD(ObservationSnapshot_InvalidImage);
+};
+
+//-----------------------------------------------------------------------------
+
+void ObservationSnapshotTests::ObservationSnapshot_Queries()
+{
+    auto history = make_history();
+
+    std::vector<uint8_t> image;
+    observation_snapshot::write(history, image);
+
+    observation_snapshot snapshot(image.data(), image.size());
+    check_queries(history, snapshot);
+    Assert::AreEqual(size_t(40), snapshot.record_count());
+
+    // The index is sorted, and each station's records are one block
+    Assert::IsTrue(snapshot.identifier(0) == "CYYZ");
+    Assert::IsTrue(snapshot.identifier(4) == "KSFO");
+
+    size_t count = 0;
+    auto records = snapshot.records("KOAK", count);
+    Assert::AreEqual(size_t(8), count);
+    Assert::IsTrue(records == snapshot.latest("KOAK") - 7);
+    Assert::AreEqual(uint8_t(4), records[0].observation_time().hour_of_day);
+
+    Assert::IsTrue(snapshot.records("KXYZ", count) == nullptr);
+    Assert::AreEqual(size_t(0), count);
+    Assert::IsTrue(snapshot.latest("KSFOX") == nullptr);
+    Assert::IsFalse(static_cast<bool>(snapshot.pressure_tendency("KXYZ")));
+}
+
+//-----------------------------------------------------------------------------
+
+void ObservationSnapshotTests::ObservationSnapshot_File()
+{
+    const std::string path = "observation_snapshot_test.bin";
+    auto history = make_history();
+    observation_snapshot::write(history, path);
+
+    {
+        observation_snapshot snapshot(path);
+        check_queries(history, snapshot);
+
+        // Copies share the mapping
+        auto copy = snapshot;
+        snapshot = observation_snapshot(path);
+        Assert::AreEqual(size_t(8), copy.size("KSFO"));
+    }
+
+    std::remove(path.c_str());
+    Assert::ExpectException<aw_exception>([&]() { observation_snapshot snapshot(path); });
+}
+
+//-----------------------------------------------------------------------------
+
+void ObservationSnapshotTests::ObservationSnapshot_Move()
+{
+    std::vector<uint8_t> image;
+    observation_snapshot::write(make_history(), image);
+
+    observation_snapshot snapshot(image.data(), image.size());
+    observation_snapshot moved(std::move(snapshot));
+
+    Assert::AreEqual(size_t(5), moved.station_count());
+    Assert::AreEqual(size_t(0), snapshot.station_count());
+    Assert::IsTrue(snapshot.latest("KSFO") == nullptr);
+}
+
+//-----------------------------------------------------------------------------
+
+void ObservationSnapshotTests::ObservationSnapshot_MonthRollover()
+{
+    // Hourly reports from the last day of September and of February 2026, at
+    // midnight UTC, into the next month
+    struct
+    {
+        const char* identifier;
+        uint32_t    monthLength;
+        std::time_t start;
+    } stations[] =
+    {
+        { "KSFO", 30, 1790726400 },
+        { "KOAK", 28, 1772236800 }
+    };
+
+    observation_history history;
+    for (auto const& station : stations)
+    {
+        for (uint32_t hour = 0; hour < 30; ++hour)
+        {
+            auto day = station.monthLength + hour / 24;
+            char text[96];
+            snprintf(text, sizeof(text), "METAR %s %02u%02u56Z 28010KT 10SM BKN015 10/05 A%04u",
+                station.identifier, day > station.monthLength ? day - station.monthLength : day, hour % 24, 3010 - 3 * hour);
+            history.append(metar(text), station.start + hour * 3600);
+        }
+    }
+
+    std::vector<uint8_t> image;
+    observation_snapshot::write(history, image);
+    observation_snapshot snapshot(image.data(), image.size());
+
+    std::vector<observation_record> expected;
+    std::vector<observation_record> actual;
+    for (auto const& station : stations)
+    {
+        // A day of reports is held across the short month
+        Assert::AreEqual(size_t(25), snapshot.size(station.identifier));
+        Assert::AreEqual(-3.0, *snapshot.pressure_tendency(station.identifier), 0.15);
+
+        history.last_hours(station.identifier, 8, expected);
+        snapshot.last_hours(station.identifier, 8, actual);
+        Assert::AreEqual(size_t(9), actual.size());
+        Assert::IsTrue(same_records(expected, actual));
+
+        snapshot.range(station.identifier, time(static_cast<uint8_t>(station.monthLength), 22, 0), time(1, 2, 0), actual);
+        Assert::AreEqual(size_t(4), actual.size());
+        Assert::IsTrue(actual.front().observation_time() == time(static_cast<uint8_t>(station.monthLength), 22, 56));
+        Assert::IsTrue(actual.back().observation_time() == time(1, 1, 56));
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void ObservationSnapshotTests::ObservationSnapshot_InvalidImage()
+{
+    std::vector<uint8_t> image;
+    observation_snapshot::write(make_history(), image);
+
+    for (size_t size = 0; size < image.size(); size += 7)
+    {
+        Assert::ExpectException<aw_exception>([&]() { observation_snapshot(image.data(), size); });
+    }
+
+    auto corrupt = image;
+    corrupt[0] = 'X';
+    Assert::ExpectException<aw_exception>([&]() { observation_snapshot(corrupt.data(), corrupt.size()); });
+
+    // Version, then byte order
+    corrupt = image;
+    corrupt[4] = observation_snapshot::format_version + 1;
+    Assert::ExpectException<aw_exception>([&]() { observation_snapshot(corrupt.data(), corrupt.size()); });
+
+    corrupt = image;
+    std::swap(corrupt[8], corrupt[11]);
+    Assert::ExpectException<aw_exception>([&]() { observation_snapshot(corrupt.data(), corrupt.size()); });
+
+    // Only identifiers of one to eight characters can be indexed; this one
+    // is not recognised as an identifier, so it is left empty
+    observation_history history;
+    history.append(metar("METAR KSFOXYZ12 121256Z 28010KT 10SM CLR 15/05 A3010"));
+    Assert::AreEqual(size_t(1), history.size(""));
+    Assert::ExpectException<aw_exception>([&]() { observation_snapshot::write(history, image); });
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
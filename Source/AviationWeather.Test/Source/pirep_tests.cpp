@@ -0,0 +1,172 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <string>
+#include <vector>
+
+#include <AviationWeather/pirep.h>
+
+#include "framework.h"
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+const char* g_routine =
+    "OKC UA /OV OKC063015/TM 1522/FL080/TP C172/SK SCT040-TOP060/BKN080/WX FV05SM -RA HZ/TA M05/WV 27015KT"
+    "/TB LGT-MOD CHOP BLO 090/IC LGT RIME 060-080/RM SMOOTH ABV 090";
+
+const char* g_urgent = "DEN UUA /OV DEN270020/TM 1800/FL350/TP B737/TB SEV CAT 330-370/RM LLWS -15 KT SFC-003 DURGC RWY26";
+
+const char* g_bulletin =
+    "PIREPS FOR THE PAST HOUR\n"
+    "OKC UA /OV OKC063015/TM 1522/FL080/TP C172/SK SCT040-TOP060/BKN080/WX FV05SM -RA HZ/TA M05/WV 27015KT\n"
+    "    /TB LGT-MOD CHOP BLO 090/IC LGT RIME 060-080/RM SMOOTH ABV 090\n"
+    "DEN UUA /OV DEN270020/TM 1800/FL350/TP B737/TB SEV CAT 330-370/RM LLWS -15 KT SFC-003 DURGC RWY26\n"
+    "UA /OV ABQ/TM 2115/FL100/TP PA28/SK OVC030/TA 02/WV 190020/IC NEG=\n";
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(PirepTests)
+{
+public:
+    TEST_METHOD(PIREP_Fields);
+    TEST_METHOD(PIREP_TurbulenceIcing);
+    TEST_METHOD(PIREP_Batch);
+    TEST_METHOD(PIREP_Limits);
+};
+
+//-----------------------------------------------------------------------------
+
+void PirepTests::PIREP_Fields()
+{
+    aw::pirep p(g_routine);
+
+    Assert::IsTrue(pirep_type::routine == p.type);
+    Assert::AreEqual(std::string("OKC"), p.identifier);
+    Assert::AreEqual(std::string("OKC063015"), p.location);
+    Assert::AreEqual(uint8_t(15), p.observation_time->hour_of_day);
+    Assert::AreEqual(uint8_t(22), p.observation_time->minute_of_hour);
+    Assert::AreEqual(uint32_t(8000), *p.altitude);
+    Assert::AreEqual(std::string("C172"), p.aircraft_type);
+
+    Assert::AreEqual(size_t(2), p.sky_condition_group.size());
+    Assert::IsTrue(sky_cover_type::scattered == p.sky_condition_group[0].sky_cover);
+    Assert::AreEqual(uint32_t(4000), p.sky_condition_group[0].layer_height);
+    Assert::AreEqual(uint32_t(6000), p.cloud_tops[0]);
+    Assert::IsTrue(sky_cover_type::broken == p.sky_condition_group[1].sky_cover);
+    Assert::AreEqual(uint32_t(UINT32_MAX), p.cloud_tops[1]);
+
+    Assert::AreEqual(5.0, p.flight_visibility->distance, 0.001);
+    Assert::IsTrue(distance_unit::statute_miles == p.flight_visibility->unit);
+    Assert::AreEqual(size_t(2), p.weather_group.size());
+    Assert::IsTrue(weather_intensity::light == p.weather_group[0].intensity);
+    Assert::IsTrue(weather_phenomena::rain == p.weather_group[0].phenomena[0]);
+    Assert::IsTrue(weather_phenomena::haze == p.weather_group[1].phenomena[0]);
+
+    Assert::AreEqual(int8_t(-5), *p.temperature);
+    Assert::AreEqual(uint16_t(270), p.wind_group->direction);
+    Assert::AreEqual(uint8_t(15), p.wind_group->wind_speed);
+    Assert::AreEqual(std::string("SMOOTH ABV 090"), p.remarks);
+}
+
+void PirepTests::PIREP_TurbulenceIcing()
+{
+    aw::pirep routine(g_routine);
+    Assert::IsTrue(turbulence_intensity::light == routine.turbulence_group->lower);
+    Assert::IsTrue(turbulence_intensity::moderate == routine.turbulence_group->upper);
+    Assert::IsTrue(turbulence_type::chop == routine.turbulence_group->type);
+    Assert::IsFalse(static_cast<bool>(routine.turbulence_group->base));
+    Assert::AreEqual(uint32_t(9000), *routine.turbulence_group->top);
+
+    Assert::IsTrue(icing_intensity::light == routine.icing_group->lower);
+    Assert::IsTrue(icing_intensity::light == routine.icing_group->upper);
+    Assert::IsTrue(icing_type::rime == routine.icing_group->type);
+    Assert::AreEqual(uint32_t(6000), *routine.icing_group->base);
+    Assert::AreEqual(uint32_t(8000), *routine.icing_group->top);
+
+    aw::pirep urgent(g_urgent);
+    Assert::IsTrue(pirep_type::urgent == urgent.type);
+    Assert::IsTrue(turbulence_intensity::severe == urgent.turbulence_group->upper);
+    Assert::IsTrue(turbulence_type::clear_air == urgent.turbulence_group->type);
+    Assert::AreEqual(uint32_t(33000), *urgent.turbulence_group->base);
+    Assert::AreEqual(uint32_t(37000), *urgent.turbulence_group->top);
+    Assert::IsFalse(static_cast<bool>(urgent.icing_group));
+    Assert::IsTrue(urgent.sky_condition_group.empty());
+}
+
+void PirepTests::PIREP_Batch()
+{
+    std::vector<pirep_record> records;
+    Assert::AreEqual(size_t(3), decode_pireps(g_bulletin, records));
+    Assert::AreEqual(size_t(3), records.size());
+
+    // The continuation line belongs to the first report
+    aw::pirep first(records[0], g_bulletin);
+    Assert::IsTrue(aw::pirep(g_routine) == first);
+    Assert::IsTrue(static_cast<bool>(first.icing_group));
+
+    Assert::IsTrue(aw::pirep(g_urgent) == aw::pirep(records[1], g_bulletin));
+    Assert::AreEqual(std::string("DEN"), span_text(g_bulletin, records[1].identifier).to_string());
+
+    auto const& last = records[2];
+    Assert::AreEqual(size_t(0), size_t(last.identifier.length));
+    Assert::AreEqual(std::string("ABQ"), span_text(g_bulletin, last.location).to_string());
+    Assert::AreEqual(uint16_t(190), last.wind_group->direction);
+    Assert::AreEqual(uint8_t(20), last.wind_group->wind_speed);
+    Assert::AreEqual(int8_t(2), *last.temperature);
+    Assert::IsTrue(icing_intensity::none == last.icing_group->upper);
+    // The trailing '=' is not part of the report
+    Assert::IsTrue(span_text(g_bulletin, last.raw).to_string().back() == 'G');
+
+    // Records are reused and trimmed to the new bulletin
+    Assert::AreEqual(size_t(1), decode_pireps(g_urgent, records));
+    Assert::AreEqual(size_t(1), records.size());
+    Assert::IsTrue(pirep_type::urgent == records[0].type);
+
+    Assert::AreEqual(size_t(0), decode_pireps("NO PIREPS", records));
+    Assert::IsTrue(records.empty());
+}
+
+void PirepTests::PIREP_Limits()
+{
+    aw::pirep p("UA /OV DEN/TM 0100/FL120/TP BE20/SK FEW010 SCT020 BKN030 OVC040/WX -SHRA BR FG HZ");
+
+    Assert::AreEqual(size_t(pirep_record::max_sky_layers), p.sky_condition_group.size());
+    Assert::AreEqual(uint32_t(3000), p.sky_condition_group.back().layer_height);
+    Assert::AreEqual(size_t(pirep_record::max_weather), p.weather_group.size());
+    Assert::IsTrue(weather_descriptor::showers == p.weather_group[0].descriptor);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
@@ -0,0 +1,135 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <AviationWeather/components.h>
+#include <AviationWeather/metar.h>
+#include <AviationWeather/quantities.h>
+
+#include "framework.h"
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+
+//-----------------------------------------------------------------------------
+
+// Conversions between static units are constant expressions
+static_assert(length<units::feet>(length<units::statute_miles>(1.0)).value() == 1609.344 / 0.3048, "statute miles to feet");
+static_assert(speed<units::kt>(speed<units::kt>(12.0)).value() == 12.0, "same unit");
+static_assert(pressure<units::hPa>::unit() == pressure_unit::hPa, "unit");
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(QuantitiesTests)
+{
+public:
+    TEST_METHOD(Quantities_Conversion);
+    TEST_METHOD(Quantities_Comparison);
+    TEST_METHOD(Quantities_Arithmetic);
+    TEST_METHOD(Quantities_RuntimeUnits);
+};
+
+//-----------------------------------------------------------------------------
+
+void QuantitiesTests::Quantities_Conversion()
+{
+    length<units::metres> metres = length<units::feet>(1000.0);
+    Assert::AreEqual(304.8, metres.value(), 1e-9);
+    Assert::AreEqual(1000.0, metres.in<units::feet>().value(), 1e-9);
+    Assert::AreEqual(1.0, length<units::nautical_miles>(metres.in<units::metres>() * (1852.0 / 304.8)).value(), 1e-12);
+
+    pressure<units::inHg> standard = pressure<units::hPa>(1013.25);
+    Assert::AreEqual(29.921, standard.value(), 0.001);
+
+    speed<units::mps> wind = speed<units::kt>(20.0);
+    Assert::AreEqual(10.289, wind.value(), 0.001);
+    Assert::AreEqual(23.016, wind.in<units::mph>().value(), 0.001);
+
+    Assert::AreEqual(convert(7.0, distance_unit::statute_miles, distance_unit::metres), length<units::metres>(length<units::statute_miles>(7.0)).value(), 1e-9);
+}
+
+//-----------------------------------------------------------------------------
+
+void QuantitiesTests::Quantities_Comparison()
+{
+    Assert::IsTrue(length<units::feet>(5280.0) == length<units::statute_miles>(1.0));
+    Assert::IsTrue(length<units::statute_miles>(1.0) == length<units::feet>(5280.0));
+    Assert::IsTrue(length<units::feet>(5281.0) != length<units::statute_miles>(1.0));
+    Assert::IsTrue(length<units::nautical_miles>(1.0) > length<units::statute_miles>(1.0));
+    Assert::IsTrue(length<units::metres>(1000.0) < length<units::statute_miles>(1.0));
+    Assert::IsTrue(length<units::metres>(1609.344) <= length<units::statute_miles>(1.0));
+    Assert::IsTrue(length<units::metres>(1609.344) >= length<units::statute_miles>(1.0));
+
+    Assert::IsTrue(pressure<units::inHg>(29.92) < pressure<units::hPa>(1013.25));
+    Assert::IsTrue(pressure<units::inHg>(29.93) > pressure<units::hPa>(1013.25));
+    Assert::IsTrue(speed<units::kt>(10.0) < speed<units::mph>(12.0));
+}
+
+//-----------------------------------------------------------------------------
+
+void QuantitiesTests::Quantities_Arithmetic()
+{
+    auto total = length<units::feet>(1000.0) + length<units::metres>(100.0);
+    Assert::IsTrue(total.unit() == distance_unit::feet);
+    Assert::AreEqual(1000.0 + 100.0 / 0.3048, total.value(), 1e-9);
+
+    total -= length<units::metres>(100.0);
+    Assert::AreEqual(1000.0, total.value(), 1e-9);
+
+    total += length<units::feet>(500.0);
+    Assert::AreEqual(1500.0, total.value(), 1e-9);
+
+    Assert::AreEqual(3000.0, (2.0 * total).value(), 1e-9);
+    Assert::AreEqual(750.0, (total / 2.0).value(), 1e-9);
+    Assert::AreEqual(-1500.0, (-total).value(), 1e-9);
+    Assert::AreEqual(500.0, (total - length<units::feet>(1000.0)).value(), 1e-9);
+}
+
+//-----------------------------------------------------------------------------
+
+void QuantitiesTests::Quantities_RuntimeUnits()
+{
+    visibility v(length<units::statute_miles>(10.0));
+    Assert::IsTrue(v == visibility(10.0, distance_unit::statute_miles));
+    Assert::IsTrue(visibility(length<units::metres>(800.0), visibility_modifier_type::less_than) ==
+        visibility(800.0, distance_unit::metres, visibility_modifier_type::less_than));
+
+    Assert::AreEqual(16093.44, v.distance_in<units::metres>().value(), 1e-9);
+    Assert::IsTrue(visibility(9999.0, distance_unit::metres).distance_in<units::statute_miles>() < length<units::statute_miles>(10.0));
+
+    altimeter a(pressure<units::inHg>(29.92));
+    Assert::IsTrue(a == altimeter(29.92, pressure_unit::inHg));
+    Assert::AreEqual(1013.2, a.pressure_in<units::hPa>().value(), 0.1);
+    Assert::AreEqual(29.92, a.pressure_in<units::inHg>().value());
+
+    metar m("KSFO 121853Z 28016KT 10SM FEW008 18/12 A2992");
+    Assert::IsTrue(static_cast<bool>(m.visibility_group));
+    Assert::IsTrue(m.visibility_group->distance_in<units::statute_miles>() == length<units::feet>(52800.0));
+    Assert::IsTrue(m.altimeter_group->pressure_in<units::hPa>() < pressure<units::hPa>(1013.25));
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
@@ -0,0 +1,209 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <AviationWeather/metar.h>
+#include <AviationWeather/remarks.h>
+
+#include "framework.h"
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(RemarksTests)
+{
+public:
+    TEST_METHOD(Remarks_NumericGroups);
+    TEST_METHOD(Remarks_Wind);
+    TEST_METHOD(Remarks_WeatherEvents);
+    TEST_METHOD(Remarks_Flags);
+    TEST_METHOD(Remarks_Unparsed);
+    TEST_METHOD(Remarks_Concurrent);
+};
+
+//-----------------------------------------------------------------------------
+
+void RemarksTests::Remarks_NumericGroups()
+{
+    aw::metar m("KSTS 181253Z AUTO 00000KT 10SM -RA OVC007 14/12 A2990 RMK AO2 SLP116 P0012 60034 70125 T01390122 10150 21012 401561017");
+    metar_remarks r(m);
+
+    Assert::IsTrue(automated_station_type::with_precipitation_discriminator == r.automated_station());
+    Assert::AreEqual(1011.6, *r.sea_level_pressure(), 0.001);
+    Assert::AreEqual(13.9, *r.precise_temperature(), 0.001);
+    Assert::AreEqual(12.2, *r.precise_dewpoint(), 0.001);
+    Assert::AreEqual(0.12, *r.hourly_precipitation(), 0.001);
+    Assert::AreEqual(0.34, *r.period_precipitation(), 0.001);
+    Assert::AreEqual(1.25, *r.daily_precipitation(), 0.001);
+    Assert::AreEqual(15.0, *r.maximum_temperature_6_hour(), 0.001);
+    Assert::AreEqual(-1.2, *r.minimum_temperature_6_hour(), 0.001);
+    Assert::AreEqual(15.6, *r.maximum_temperature_24_hour(), 0.001);
+    Assert::AreEqual(-1.7, *r.minimum_temperature_24_hour(), 0.001);
+    Assert::AreEqual(size_t(0), r.unparsed().size());
+
+    metar_remarks low("AO1 SLP982 6////");
+    Assert::IsTrue(automated_station_type::without_precipitation_discriminator == low.automated_station());
+    Assert::AreEqual(998.2, *low.sea_level_pressure(), 0.001);
+    Assert::IsFalse(static_cast<bool>(low.period_precipitation()));
+    Assert::IsFalse(static_cast<bool>(low.precise_temperature()));
+}
+
+//-----------------------------------------------------------------------------
+
+void RemarksTests::Remarks_Wind()
+{
+    metar_remarks r1("AO2 PK WND 18028/0112 WSHFT 0130 FROPA SLP057");
+
+    Assert::AreEqual(uint16_t(180), r1.peak_wind_group()->direction);
+    Assert::AreEqual(uint16_t(28), r1.peak_wind_group()->speed);
+    Assert::AreEqual(uint8_t(1), *r1.peak_wind_group()->time.hour);
+    Assert::AreEqual(uint8_t(12), r1.peak_wind_group()->time.minute);
+
+    Assert::AreEqual(uint8_t(1), *r1.wind_shift_group()->time.hour);
+    Assert::AreEqual(uint8_t(30), r1.wind_shift_group()->time.minute);
+    Assert::IsTrue(r1.wind_shift_group()->frontal_passage);
+    Assert::AreEqual(1005.7, *r1.sea_level_pressure(), 0.001);
+
+    metar_remarks r2("PK WND 280105/45 WSHFT 30");
+
+    Assert::AreEqual(uint16_t(280), r2.peak_wind_group()->direction);
+    Assert::AreEqual(uint16_t(105), r2.peak_wind_group()->speed);
+    Assert::IsFalse(static_cast<bool>(r2.peak_wind_group()->time.hour));
+    Assert::AreEqual(uint8_t(45), r2.peak_wind_group()->time.minute);
+    Assert::IsFalse(r2.wind_shift_group()->frontal_passage);
+}
+
+//-----------------------------------------------------------------------------
+
+void RemarksTests::Remarks_WeatherEvents()
+{
+    metar_remarks r("AO2 RAB05E30SNB30 TSB0159E30 -FZDZE12");
+    auto const& events = r.weather_events();
+
+    Assert::AreEqual(size_t(4), events.size());
+
+    Assert::IsTrue(weather_phenomena::rain == events[0].phenomenon);
+    Assert::AreEqual(uint8_t(5), events[0].begin->minute);
+    Assert::AreEqual(uint8_t(30), events[0].end->minute);
+
+    Assert::IsTrue(weather_phenomena::snow == events[1].phenomenon);
+    Assert::AreEqual(uint8_t(30), events[1].begin->minute);
+    Assert::IsFalse(static_cast<bool>(events[1].end));
+
+    Assert::IsTrue(weather_descriptor::thunderstorm == events[2].descriptor);
+    Assert::IsTrue(weather_phenomena::none == events[2].phenomenon);
+    Assert::AreEqual(uint8_t(1), *events[2].begin->hour);
+    Assert::AreEqual(uint8_t(59), events[2].begin->minute);
+    Assert::IsFalse(static_cast<bool>(events[2].end->hour));
+
+    Assert::IsTrue(weather_intensity::light == events[3].intensity);
+    Assert::IsTrue(weather_descriptor::freezing == events[3].descriptor);
+    Assert::IsTrue(weather_phenomena::drizzle == events[3].phenomenon);
+    Assert::IsFalse(static_cast<bool>(events[3].begin));
+    Assert::AreEqual(uint8_t(12), events[3].end->minute);
+}
+
+//-----------------------------------------------------------------------------
+
+void RemarksTests::Remarks_Flags()
+{
+    metar_remarks r1("AO2 TSNO PWINO $");
+    Assert::IsTrue(r1.lightning_detector_not_operating());
+    Assert::IsTrue(r1.precipitation_identifier_not_operating());
+    Assert::IsTrue(r1.maintenance_required());
+
+    metar_remarks r2("");
+    Assert::IsFalse(r2.lightning_detector_not_operating());
+    Assert::IsFalse(r2.maintenance_required());
+    Assert::IsTrue(automated_station_type::none == r2.automated_station());
+    Assert::AreEqual(size_t(0), r2.weather_events().size());
+}
+
+//-----------------------------------------------------------------------------
+
+void RemarksTests::Remarks_Unparsed()
+{
+    std::string buffer("KPDX 041453Z 32007KT 1SM BR BKN003 OVC010 10/09 A3000 RMK AO2 SFC VIS 4 RAB");
+    aw::metar_view view(buffer);
+    metar_remarks r(view);
+
+    auto const& unparsed = r.unparsed();
+    Assert::AreEqual(size_t(4), unparsed.size());
+    Assert::AreEqual(std::string("SFC"), unparsed[0].to_string());
+    Assert::AreEqual(std::string("VIS"), unparsed[1].to_string());
+    Assert::AreEqual(std::string("4"), unparsed[2].to_string());
+    Assert::AreEqual(std::string("RAB"), unparsed[3].to_string());
+    Assert::AreEqual(size_t(0), r.weather_events().size());
+}
+
+//-----------------------------------------------------------------------------
+
+void RemarksTests::Remarks_Concurrent()
+{
+    // Threads sharing const remarks race to decode them first
+    const size_t threadCount = 4;
+    for (size_t pass = 0; pass < 100; ++pass)
+    {
+        metar_remarks const r("AO2 PK WND 18028/0112 RAB05E30SNB30 SLP116 T01390122 $");
+        metar_remarks copy(r);
+
+        std::vector<std::thread> threads;
+        std::vector<int> results(threadCount, 0);
+        for (size_t t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([&r, &results, t]()
+            {
+                results[t] = r.weather_events().size() == 2 && r.peak_wind_group() &&
+                    *r.sea_level_pressure() == 1011.6 && r.maintenance_required() && r.unparsed().empty();
+            });
+        }
+
+        // Copying while the source decodes copies either nothing or the
+        // published groups
+        metar_remarks concurrentCopy(r);
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        for (auto result : results)
+        {
+            Assert::IsTrue(result != 0);
+        }
+        Assert::AreEqual(size_t(2), copy.weather_events().size());
+        Assert::AreEqual(size_t(2), concurrentCopy.weather_events().size());
+        Assert::AreEqual(1011.6, *concurrentCopy.sea_level_pressure(), 0.001);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
@@ -0,0 +1,315 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <AviationWeather/metar.h>
+#include <AviationWeather/runway_wind.h>
+
+#include "framework.h"
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const double g_tolerance = 0.01;
+
+// KSFO 01L/R, 10L/R, 19L/R and 28L/R
+runway_table sfo_runways()
+{
+    runway_table runways;
+    for (uint8_t number : { 1, 19, 10, 28 })
+    {
+        runways.add("KSFO", number, runway_designator_type::left);
+        runways.add("KSFO", number, runway_designator_type::right);
+    }
+    return runways;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(RunwayWindTests)
+{
+public:
+    TEST_METHOD(RunwayWind_ScalarComponents);
+    TEST_METHOD(RunwayWind_Table);
+    TEST_METHOD(RunwayWind_SteadyAndGust);
+    TEST_METHOD(RunwayWind_VariableRange);
+    TEST_METHOD(RunwayWind_Lanes);
+    TEST_METHOD(RunwayWind_BestRunway);
+};
+
+//-----------------------------------------------------------------------------
+
+void RunwayWindTests::RunwayWind_ScalarComponents()
+{
+    aw::metar m("KSFO 121856Z 31020G30KT 10SM FEW010 18/12 A3001");
+
+    // 30 degrees off runway 28
+    Assert::AreEqual(20 * std::cos(30 * 3.14159265358979 / 180), m.wind_group->headwind_component(280), g_tolerance);
+    Assert::AreEqual(20 * std::sin(30 * 3.14159265358979 / 180), m.wind_group->crosswind_component(280), g_tolerance);
+    Assert::AreEqual(30 * std::sin(30 * 3.14159265358979 / 180), m.wind_group->crosswind_component(280, true), g_tolerance);
+    Assert::AreEqual(-20.0, m.wind_group->headwind_component(130), g_tolerance);
+    Assert::AreEqual(-20.0, m.wind_group->crosswind_component(40), g_tolerance);
+
+    aw::metar variable("KSFO 121856Z VRB04KT 10SM FEW010 18/12 A3001");
+    Assert::AreEqual(0.0, variable.wind_group->headwind_component(280));
+    Assert::AreEqual(0.0, variable.wind_group->crosswind_component(280));
+}
+
+//-----------------------------------------------------------------------------
+
+void RunwayWindTests::RunwayWind_Table()
+{
+    runway_table runways;
+    runways.add("KOAK", 12);
+    runways.add("KSJC", 12, runway_designator_type::left);
+    runways.add("KOAK", 30);
+
+    Assert::AreEqual(size_t(2), runways.station_count());
+    Assert::AreEqual(size_t(3), runways.runway_count());
+
+    auto oak = *runways.find("KOAK");
+    auto sjc = *runways.find("KSJC");
+    Assert::IsFalse(static_cast<bool>(runways.find("KSFO")));
+    Assert::AreEqual(std::string("KOAK"), runways.station(oak));
+
+    // Runways are kept together per station
+    Assert::AreEqual(size_t(2), runways.last_runway(oak) - runways.first_runway(oak));
+    Assert::AreEqual(static_cast<uint8_t>(30), runways.runway_number(runways.first_runway(oak) + 1));
+    Assert::AreEqual(size_t(1), runways.last_runway(sjc) - runways.first_runway(sjc));
+    Assert::AreEqual(runway_designator_type::left, runways.runway_designator(runways.first_runway(sjc)));
+    Assert::AreEqual(sjc, runways.runway_station(runways.first_runway(sjc)));
+
+    Assert::ExpectException<aw_exception>([&]() { runways.add("KOAK", 37); });
+}
+
+//-----------------------------------------------------------------------------
+
+void RunwayWindTests::RunwayWind_SteadyAndGust()
+{
+    runway_table runways;
+    runways.add("EGLL", 27, runway_designator_type::left);
+    runways.add("EGLL", 9, runway_designator_type::right);
+    runways.add("UUEE", 24, runway_designator_type::left);
+
+    aw::metar egll("EGLL 121050Z 30015G25KT 9999 FEW030 15/08 Q1012");
+    aw::metar uuee("UUEE 121030Z 24005MPS 9999 BKN020 M02/M05 Q1015");
+
+    std::vector<util::optional<wind>> winds(runways.station_count());
+    winds[*runways.find("EGLL")] = egll.wind_group;
+    winds[*runways.find("UUEE")] = uuee.wind_group;
+
+    runway_winds components;
+    components.compute(runways, winds);
+    Assert::AreEqual(size_t(3), components.headwind.size());
+
+    // Agrees with the scalar calculation
+    Assert::AreEqual(egll.wind_group->headwind_component(270), static_cast<double>(components.headwind[0]), g_tolerance);
+    Assert::AreEqual(egll.wind_group->crosswind_component(270), static_cast<double>(components.crosswind[0]), g_tolerance);
+    Assert::AreEqual(egll.wind_group->headwind_component(270, true), static_cast<double>(components.gust_headwind[0]), g_tolerance);
+    Assert::AreEqual(egll.wind_group->crosswind_component(90, true), static_cast<double>(components.gust_crosswind[1]), g_tolerance);
+
+    // Runway 09 has a tailwind, which at the gust speed is its extreme
+    Assert::IsTrue(components.headwind[1] < 0.0f);
+    Assert::AreEqual(static_cast<double>(-components.gust_headwind[1]), static_cast<double>(components.max_tailwind[1]), g_tolerance);
+    Assert::AreEqual(0.0, static_cast<double>(components.max_tailwind[0]), g_tolerance);
+
+    // Metres per second are converted to knots
+    Assert::AreEqual(5 * 3600.0 / 1852.0, static_cast<double>(components.headwind[2]), g_tolerance);
+    Assert::AreEqual(0.0, static_cast<double>(components.crosswind[2]), g_tolerance);
+
+    // Stations without a wind
+    winds[*runways.find("UUEE")] = util::nullopt;
+    components.compute(runways, winds);
+    Assert::IsTrue(std::isnan(components.headwind[2]));
+    Assert::IsTrue(std::isnan(components.max_crosswind[2]));
+    Assert::IsFalse(std::isnan(components.headwind[0]));
+}
+
+//-----------------------------------------------------------------------------
+
+void RunwayWindTests::RunwayWind_VariableRange()
+{
+    runway_table runways;
+    runways.add("KSFO", 28);
+    runways.add("KSFO", 1);
+    runways.add("KSFO", 10);
+
+    // 250V330 holds 280 but neither 190 nor 010
+    aw::metar m("KSFO 121856Z 29012KT 250V330 10SM FEW010 18/12 A3001");
+
+    std::vector<util::optional<wind>> winds(1, m.wind_group);
+    runway_winds components;
+    components.compute(runways, winds);
+
+    // Runway 28: the largest crosswind is at 330, and there is no tailwind
+    Assert::AreEqual(12 * std::sin(50 * 3.14159265358979 / 180), static_cast<double>(components.max_crosswind[0]), g_tolerance);
+    Assert::AreEqual(0.0, static_cast<double>(components.max_tailwind[0]), g_tolerance);
+
+    // Runway 01: 280 is directly across it
+    Assert::AreEqual(12.0, static_cast<double>(components.max_crosswind[1]), g_tolerance);
+    Assert::AreEqual(12 * std::cos(60 * 3.14159265358979 / 180), static_cast<double>(components.max_tailwind[1]), g_tolerance);
+
+    // Runway 10: 280 is directly behind it
+    Assert::AreEqual(12.0, static_cast<double>(components.max_tailwind[2]), g_tolerance);
+
+    // A variable wind without a range covers every direction
+    aw::metar variable("KSFO 121856Z VRB05G15KT 10SM FEW010 18/12 A3001");
+    winds[0] = variable.wind_group;
+    components.compute(runways, winds);
+    for (size_t r = 0; r < runways.runway_count(); ++r)
+    {
+        Assert::AreEqual(0.0, static_cast<double>(components.headwind[r]), g_tolerance);
+        Assert::AreEqual(15.0, static_cast<double>(components.max_crosswind[r]), g_tolerance);
+        Assert::AreEqual(15.0, static_cast<double>(components.max_tailwind[r]), g_tolerance);
+    }
+
+    // A range across north
+    aw::metar north("KSFO 121856Z 36010KT 340V020 10SM FEW010 18/12 A3001");
+    winds[0] = north.wind_group;
+    components.compute(runways, winds);
+    Assert::AreEqual(10 * std::sin(30 * 3.14159265358979 / 180), static_cast<double>(components.max_crosswind[1]), g_tolerance);
+    Assert::AreEqual(10 * std::cos(60 * 3.14159265358979 / 180), static_cast<double>(components.max_tailwind[2]), g_tolerance);
+}
+
+//-----------------------------------------------------------------------------
+
+void RunwayWindTests::RunwayWind_Lanes()
+{
+    std::vector<util::optional<wind>> kinds =
+    {
+        aw::metar("KSFO 121856Z 29012KT 250V330 10SM FEW010 18/12 A3001").wind_group,
+        aw::metar("KSFO 121856Z VRB05G15KT 10SM FEW010 18/12 A3001").wind_group,
+        aw::metar("KSFO 121856Z 36010KT 340V020 10SM FEW010 18/12 A3001").wind_group,
+        aw::metar("KSFO 121856Z 21518G27KT 10SM FEW010 18/12 A3001").wind_group,
+        util::nullopt
+    };
+    const uint8_t numbers[] = { 28, 1, 10 };
+
+    // Each station alone has fewer than four runways and so takes the
+    // scalar path
+    std::vector<runway_winds> expected(kinds.size());
+    for (size_t k = 0; k < kinds.size(); ++k)
+    {
+        runway_table single;
+        for (auto number : numbers)
+        {
+            single.add("KSFO", number);
+        }
+        expected[k].compute(single, std::vector<util::optional<wind>>(1, kinds[k]));
+    }
+
+    // Three runways per station moves each one through every lane of the
+    // four-lane path. 270 runways span two tiles and leave a remainder of
+    // two in the second.
+    runway_table runways;
+    std::vector<util::optional<wind>> winds;
+    for (size_t copy = 0; copy < 18; ++copy)
+    {
+        for (size_t k = 0; k < kinds.size(); ++k)
+        {
+            std::string identifier = "K" + std::to_string(copy) + std::to_string(k) + "X";
+            for (auto number : numbers)
+            {
+                runways.add(identifier.c_str(), number);
+            }
+            winds.push_back(kinds[k]);
+        }
+    }
+
+    runway_winds components;
+    components.compute(runways, winds);
+
+    auto check = [](float expected, float actual)
+    {
+        if (std::isnan(expected))
+        {
+            Assert::IsTrue(std::isnan(actual));
+        }
+        else
+        {
+            Assert::AreEqual(static_cast<double>(expected), static_cast<double>(actual), 1e-4);
+        }
+    };
+    for (size_t r = 0; r < runways.runway_count(); ++r)
+    {
+        auto const& reference = expected[runways.runway_station(r) % kinds.size()];
+        auto i = r % 3;
+        check(reference.headwind[i], components.headwind[r]);
+        check(reference.crosswind[i], components.crosswind[r]);
+        check(reference.gust_headwind[i], components.gust_headwind[r]);
+        check(reference.gust_crosswind[i], components.gust_crosswind[r]);
+        check(reference.max_tailwind[i], components.max_tailwind[r]);
+        check(reference.max_crosswind[i], components.max_crosswind[r]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void RunwayWindTests::RunwayWind_BestRunway()
+{
+    auto runways = sfo_runways();
+    runways.add("KOAK", 12);
+    runways.add("KOAK", 30);
+    runways.add("KHAF", 12);
+
+    aw::metar sfo("KSFO 121856Z 29015KT 10SM FEW010 18/12 A3001");
+    aw::metar oak("KOAK 121853Z 13008KT 10SM SKC 19/10 A3000");
+
+    std::vector<util::optional<wind>> winds(runways.station_count());
+    winds[*runways.find("KSFO")] = sfo.wind_group;
+    winds[*runways.find("KOAK")] = oak.wind_group;
+
+    runway_winds components;
+    components.compute(runways, winds);
+
+    std::vector<util::optional<size_t>> best;
+    components.best_runways(runways, best);
+    Assert::AreEqual(size_t(3), best.size());
+
+    // 28L and 28R are equal, so the first is taken
+    auto sfoBest = *best[*runways.find("KSFO")];
+    Assert::AreEqual(static_cast<uint8_t>(28), runways.runway_number(sfoBest));
+    Assert::AreEqual(runway_designator_type::left, runways.runway_designator(sfoBest));
+
+    Assert::AreEqual(static_cast<uint8_t>(12), runways.runway_number(*best[*runways.find("KOAK")]));
+    Assert::IsFalse(static_cast<bool>(best[*runways.find("KHAF")]));
+    Assert::IsTrue(components.best_runway(runways, *runways.find("KSFO")) == sfoBest);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
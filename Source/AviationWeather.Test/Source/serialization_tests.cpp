@@ -0,0 +1,318 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <string>
+#include <vector>
+
+#include <AviationWeather/metar.h>
+#include <AviationWeather/serialization.h>
+
+#include "framework.h"
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+// Reports covering every group the encoding stores
+const char* g_reports[] =
+{
+    "METAR KSFO 172256Z 00000KT 9SM CLR 19/04 A3012",
+    "SPECI KPDX 041453Z 32007KT 1 1/2SM R10R/3000VP6000FT BR BKN003 OVC010 10/09 A3000 RMK AO2 SFC VIS 4",
+    "KWVI 171453Z AUTO VRB03KT 1/4SM FG VV002 16/15 A2989 RMK AO2 SLP119 T01610150 53007",
+    "KORD 190151Z COR 19010G25KT 150V220 5SM TSRA BR FEW027 BKN048CB OVC090 21/19 A2971 RMK AO2 PK WND 18028/0112",
+    "CYYZ 011800Z 27015G25KT 15SM -SHSN BLSN FEW040TCU M01/M03 A3012",
+    "EGLL 121050Z 27012KT 4000 1500SW BR SCT008 BKN012 08/07 Q1002 RERA WS R27L BECMG FM1130 TL1230 9999 NSW SCT020",
+    "LFPG 121030Z 24005MPS 200V280 CAVOK M02/M05 Q1015 TEMPO AT1100 3000 SHRA BKN010CB",
+    "EDDF 121020Z 06008KT R25L/0800U R25R/P1500N 0600 FG NSC 02/02 Q1025 WS ALL RWY NOSIG",
+    "KMIA 121853Z 09012KT 10SM +TSRA FEW025CB SCT045 BKN250 31/24 A3001"
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(SerializationTests)
+{
+public:
+    TEST_METHOD(Serialization_RoundTrip);
+    TEST_METHOD(Serialization_WithoutText);
+    TEST_METHOD(Serialization_Stream);
+    TEST_METHOD(Serialization_View);
+    TEST_METHOD(Serialization_Encoding);
+    TEST_METHOD(Serialization_InvalidInput);
+};
+
+//-----------------------------------------------------------------------------
+
+void SerializationTests::Serialization_RoundTrip()
+{
+    for (auto text : g_reports)
+    {
+        metar original(text);
+
+        std::vector<uint8_t> buffer;
+        encode(original, buffer);
+
+        size_t consumed = 0;
+        auto decoded = decode(buffer.data(), buffer.size(), &consumed);
+
+        Assert::AreEqual(buffer.size(), consumed);
+        Assert::IsTrue(decoded == original);
+        Assert::AreEqual(original.content_hash(), decoded.content_hash());
+        Assert::AreEqual(original.raw_data, decoded.raw_data);
+        Assert::AreEqual(original.remarks, decoded.remarks);
+        Assert::IsTrue(decoded.flight_category() == original.flight_category());
+        Assert::IsTrue(buffer.size() < original.raw_data.size() * 2);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void SerializationTests::Serialization_WithoutText()
+{
+    size_t encodedSize = 0;
+    size_t textSize = 0;
+
+    for (auto text : g_reports)
+    {
+        metar original(text);
+
+        std::vector<uint8_t> buffer;
+        encode(original, buffer, false);
+
+        auto decoded = decode(buffer.data(), buffer.size());
+        Assert::IsTrue(decoded.raw_data.empty());
+        Assert::IsTrue(decoded.remarks.empty());
+
+        // Every group survives; only the text is left behind, and the stored
+        // fingerprint is that of the report without its remarks
+        std::string stripped(text);
+        metar withoutRemarks(stripped.substr(0, stripped.find(" RMK")));
+        Assert::AreEqual(withoutRemarks.content_hash(), decoded.content_hash());
+
+        decoded.remarks = original.remarks;
+        Assert::IsTrue(decoded == original);
+
+        encodedSize += buffer.size();
+        textSize += original.raw_data.size();
+    }
+
+    // The groups take much less space than the text they were parsed from
+    Assert::IsTrue(encodedSize * 3 < textSize * 2);
+}
+
+//-----------------------------------------------------------------------------
+
+void SerializationTests::Serialization_Stream()
+{
+    std::vector<metar> reports;
+    for (size_t i = 0; i < 40; ++i)
+    {
+        reports.emplace_back(g_reports[i % (sizeof(g_reports) / sizeof(g_reports[0]))]);
+    }
+
+    std::vector<uint8_t> buffer;
+    encode(reports, buffer);
+    Assert::AreEqual(uint8_t('A'), buffer[0]);
+    Assert::AreEqual(binary_format_version, buffer[4]);
+
+    std::vector<metar> decoded;
+    decode(buffer.data(), buffer.size(), decoded);
+    Assert::AreEqual(reports.size(), decoded.size());
+    for (size_t i = 0; i < reports.size(); ++i)
+    {
+        Assert::IsTrue(decoded[i] == reports[i]);
+        Assert::AreEqual(reports[i].raw_data, decoded[i].raw_data);
+    }
+
+    // Streams of the first version decode the same way
+    buffer[4] = 1;
+    decoded.clear();
+    decode(buffer.data(), buffer.size(), decoded);
+    Assert::AreEqual(reports.size(), decoded.size());
+
+    // An empty stream, and appending to existing results
+    buffer.clear();
+    encode(nullptr, 0, buffer);
+    decode(buffer.data(), buffer.size(), decoded);
+    Assert::AreEqual(reports.size(), decoded.size());
+}
+
+//-----------------------------------------------------------------------------
+
+void SerializationTests::Serialization_View()
+{
+    // Decoding over a view that held a larger report leaves nothing of it
+    metar_view view(g_reports[5]);
+    for (auto text : g_reports)
+    {
+        metar original(text);
+        std::vector<uint8_t> buffer;
+        encode(original, buffer);
+
+        size_t consumed = 0;
+        decode(buffer.data(), buffer.size(), view, &consumed);
+        Assert::AreEqual(buffer.size(), consumed);
+        Assert::IsTrue(view == metar_view(text));
+        Assert::AreEqual(original.content_hash(), view.content_hash());
+        Assert::IsTrue(view.to_owned() == original);
+
+        // The text refers into the buffer
+        Assert::IsTrue(view.raw_data.data() > reinterpret_cast<const char*>(buffer.data()));
+        Assert::IsTrue(view.raw_data.data() < reinterpret_cast<const char*>(buffer.data() + buffer.size()));
+        Assert::AreEqual(original.raw_data, view.raw_data.to_string());
+    }
+
+    std::vector<metar> reports;
+    for (size_t i = 0; i < 20; ++i)
+    {
+        reports.emplace_back(g_reports[(i * 7) % (sizeof(g_reports) / sizeof(g_reports[0]))]);
+    }
+
+    std::vector<uint8_t> buffer;
+    encode(reports, buffer, false);
+
+    binary_stream_reader reader(buffer.data(), buffer.size());
+    Assert::AreEqual(reports.size(), reader.size());
+    for (auto const& original : reports)
+    {
+        Assert::IsTrue(reader.next());
+        Assert::IsTrue(reader.report().raw_data.empty());
+
+        auto decoded = reader.report().to_owned();
+        decoded.remarks = original.remarks;
+        Assert::IsTrue(decoded == original);
+    }
+    Assert::IsFalse(reader.next());
+    Assert::IsFalse(reader.next());
+
+    // An empty stream, and invalid streams
+    std::vector<uint8_t> empty;
+    encode(nullptr, 0, empty);
+    binary_stream_reader emptyReader(empty.data(), empty.size());
+    Assert::AreEqual(size_t(0), emptyReader.size());
+    Assert::IsFalse(emptyReader.next());
+
+    auto corrupt = buffer;
+    corrupt[0] = 'X';
+    Assert::ExpectException<aw_exception>([&]() { binary_stream_reader(corrupt.data(), corrupt.size()); });
+
+    binary_stream_reader truncated(buffer.data(), buffer.size() - 1);
+    Assert::ExpectException<aw_exception>([&]()
+    {
+        while (truncated.next())
+        {
+        }
+    });
+}
+
+//-----------------------------------------------------------------------------
+
+void SerializationTests::Serialization_Encoding()
+{
+    // Fixed layout: length, flags, identifier, time and the altimeter. Empty
+    // lists are left out entirely.
+    metar m("KSFO 172256Z A3012");
+    std::vector<uint8_t> buffer;
+    encode(m, buffer, false);
+
+    std::vector<uint8_t> expected =
+    {
+        0x0D,                       // Body length
+        0x80, 0x02,                 // Flags: altimeter
+        0x04, 'K', 'S', 'F', 'O',   // Identifier
+        0xB8, 0x9B, 0x02,           // Day 17, 22:56
+        0x01, 0x88, 0x2F            // inHg, 30.12 in hundredths
+    };
+    Assert::IsTrue(buffer == expected);
+
+    // The content hash is computed from the fields as decoded, so an edited
+    // buffer cannot carry a stale one
+    expected[12] = 0x8A;
+    auto edited = decode(expected.data(), expected.size());
+    Assert::AreEqual(metar("KSFO 172256Z A3013").content_hash(), edited.content_hash());
+    Assert::AreNotEqual(m.content_hash(), edited.content_hash());
+
+    // Values without an exact scaled form are stored as little-endian doubles
+    m.altimeter_group->pressure = 30.125;
+    buffer.clear();
+    encode(m, buffer, false);
+    Assert::AreEqual(size_t(21), buffer.size());
+    Assert::AreEqual(uint8_t(0x01), buffer[12]);
+    Assert::AreEqual(uint8_t(0x40), buffer[20]);
+    Assert::AreEqual(30.125, decode(buffer.data(), buffer.size()).altimeter_group->pressure);
+
+    // Sky covers that do not fit in a layer's flags follow them in a byte
+    std::vector<uint8_t> clear;
+    encode(metar("EDDF 121020Z SKC"), clear, false);
+    buffer.clear();
+    encode(metar("EDDF 121020Z NCD"), buffer, false);
+    Assert::AreEqual(clear.size() + 1, buffer.size());
+    Assert::AreEqual(7, buffer[buffer.size() - 2] & 0x7);
+    Assert::AreEqual(uint8_t(sky_cover_type::no_cloud_detected), buffer.back());
+    Assert::AreEqual(sky_cover_type::no_cloud_detected, decode(buffer.data(), buffer.size()).sky_condition_group[0].sky_cover);
+}
+
+//-----------------------------------------------------------------------------
+
+void SerializationTests::Serialization_InvalidInput()
+{
+    std::vector<metar> reports = { metar(g_reports[1]), metar(g_reports[5]) };
+    std::vector<uint8_t> buffer;
+    encode(reports, buffer);
+
+    std::vector<metar> decoded;
+    for (size_t size = 0; size < buffer.size(); ++size)
+    {
+        Assert::ExpectException<aw_exception>([&]() { decode(buffer.data(), size, decoded); });
+    }
+
+    // A failed decode leaves nothing behind
+    Assert::IsTrue(decoded.empty());
+
+    auto corrupt = buffer;
+    corrupt[0] = 'X';
+    Assert::ExpectException<aw_exception>([&]() { decode(corrupt.data(), corrupt.size(), decoded); });
+
+    corrupt = buffer;
+    corrupt[4] = binary_format_version + 1;
+    Assert::ExpectException<aw_exception>([&]() { decode(corrupt.data(), corrupt.size(), decoded); });
+
+    // An out of range enumeration
+    std::vector<uint8_t> single;
+    encode(reports[1], single, false);
+    single[single.size() - 4] = 0xFF;
+    Assert::ExpectException<aw_exception>([&]() { decode(single.data(), single.size()); });
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
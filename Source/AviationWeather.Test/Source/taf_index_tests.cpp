@@ -0,0 +1,244 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <string>
+#include <vector>
+
+#include <AviationWeather/taf.h>
+#include <AviationWeather/taf_index.h>
+
+#include "framework.h"
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+// The TEMPO and PROB groups overlap from 0400 to 0600 on the 13th
+const char* g_domesticTaf =
+    "TAF KLMN 121730Z 1218/1324 18010KT P6SM BKN040 "
+    "FM122200 20015G25KT 4SM -RA OVC025 "
+    "TEMPO 1300/1306 2SM TSRA BKN012CB "
+    "PROB30 1304/1310 1SM BR OVC004 "
+    "BECMG 1312/1314 27008KT "
+    "FM131800 30010KT P6SM SKC";
+
+// Crosses from a 30 day month into the next
+const char* g_internationalTaf =
+    "TAF EGLL 301100Z 3012/0118 24015KT 9999 SCT030 TEMPO 3012/3016 7000 -SHRA "
+    "BECMG 3018/3021 20008KT CAVOK FM010600 18012KT 8000 BKN015";
+
+// Crosses from February in a year that is not a leap year
+const char* g_februaryTaf =
+    "TAF LFPG 281700Z 2818/0124 31010KT 9999 FEW040 FM010600 29008KT CAVOK";
+
+// Names the 31st, so the month is known to have 31 days
+const char* g_longMonthTaf =
+    "TAF EDDF 301700Z 3018/0124 22010KT 9999 BKN030 FM310600 25015KT 6000 -RA BKN012";
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(TafIndexTests)
+{
+public:
+    TEST_METHOD(TAFIndex_Prevailing);
+    TEST_METHOD(TAFIndex_WorstCase);
+    TEST_METHOD(TAFIndex_MonthBoundary);
+    TEST_METHOD(TAFIndex_MonthLength);
+    TEST_METHOD(TAFIndex_Batch);
+};
+
+//-----------------------------------------------------------------------------
+
+void TafIndexTests::TAFIndex_Prevailing()
+{
+    aw::taf forecast(g_domesticTaf);
+    aw::taf_index index(forecast);
+
+    Assert::AreEqual(std::string("KLMN"), index.identifier());
+    Assert::IsTrue(index.covers(time(12, 18, 0)));
+    Assert::IsFalse(index.covers(time(12, 17, 59)));
+    Assert::IsTrue(index.covers(time(13, 23, 59)));
+    Assert::IsFalse(index.covers(time(14, 0, 0)));
+
+    auto const& initial = index.prevailing(time(12, 19, 0));
+    Assert::AreEqual(uint16_t(180), initial.wind_group->direction);
+    Assert::AreEqual(uint32_t(4000), initial.ceiling.layer_height);
+    Assert::AreEqual(aw::flight_category::vfr, initial.category);
+
+    auto const& from = index.prevailing(time(12, 23, 0));
+    Assert::AreEqual(uint16_t(200), from.wind_group->direction);
+    Assert::AreEqual(4.0, from.visibility_group->distance, 0.001);
+    Assert::AreEqual(size_t(1), from.weather_group.size());
+    Assert::AreEqual(uint32_t(2500), from.ceiling.layer_height);
+    Assert::AreEqual(aw::flight_category::mvfr, from.category);
+
+    // TEMPO and PROB groups do not change the prevailing conditions, alone or
+    // together
+    Assert::IsTrue(from == index.prevailing(time(13, 2, 0)));
+    Assert::IsTrue(from == index.prevailing(time(13, 5, 0)));
+    Assert::IsTrue(from == index.prevailing(time(13, 8, 0)));
+
+    // BECMG changes apply once the transition has finished
+    Assert::AreEqual(uint16_t(200), index.prevailing(time(13, 13, 0)).wind_group->direction);
+    auto const& becoming = index.prevailing(time(13, 14, 0));
+    Assert::AreEqual(uint16_t(270), becoming.wind_group->direction);
+    Assert::AreEqual(4.0, becoming.visibility_group->distance, 0.001);
+
+    auto const& last = index.prevailing(time(13, 23, 59));
+    Assert::AreEqual(uint16_t(300), last.wind_group->direction);
+    Assert::IsTrue(last.ceiling.is_unlimited());
+    Assert::AreEqual(aw::flight_category::vfr, last.category);
+
+    Assert::ExpectException<aw_exception>([&index]()
+    {
+        index.prevailing(time(14, 0, 0));
+    });
+}
+
+void TafIndexTests::TAFIndex_WorstCase()
+{
+    aw::taf forecast(g_domesticTaf);
+    aw::taf_index index(forecast);
+
+    Assert::IsTrue(index.prevailing(time(12, 19, 0)) == index.worst_case(time(12, 19, 0)));
+
+    auto const& tempo = index.worst_case(time(13, 2, 0));
+    Assert::AreEqual(2.0, tempo.visibility_group->distance, 0.001);
+    Assert::AreEqual(size_t(2), tempo.weather_group.size());
+    Assert::AreEqual(uint32_t(1200), tempo.ceiling.layer_height);
+    Assert::AreEqual(aw::flight_category::ifr, tempo.category);
+
+    // While both groups apply, each element is the worse of the two and the
+    // weather is that of both
+    auto const& overlap = index.worst_case(time(13, 5, 0));
+    Assert::AreEqual(1.0, overlap.visibility_group->distance, 0.001);
+    Assert::AreEqual(size_t(3), overlap.weather_group.size());
+    Assert::AreEqual(uint32_t(400), overlap.ceiling.layer_height);
+    Assert::AreEqual(aw::flight_category::lifr, overlap.category);
+    Assert::AreEqual(aw::flight_category::mvfr, index.prevailing(time(13, 5, 0)).category);
+
+    // The TEMPO group ends first
+    auto const& probability = index.worst_case(time(13, 8, 0));
+    Assert::AreEqual(1.0, probability.visibility_group->distance, 0.001);
+    Assert::AreEqual(size_t(2), probability.weather_group.size());
+    Assert::AreEqual(uint32_t(400), probability.ceiling.layer_height);
+    Assert::IsTrue(index.prevailing(time(13, 10, 0)) == index.worst_case(time(13, 10, 0)));
+
+    // Gusts from the FM group are stronger than the BECMG wind
+    Assert::AreEqual(uint8_t(25), index.worst_case(time(13, 13, 0)).wind_group->gust_speed);
+}
+
+void TafIndexTests::TAFIndex_MonthBoundary()
+{
+    aw::taf forecast(g_internationalTaf);
+    aw::taf_index index(forecast);
+
+    Assert::IsTrue(index.covers(time(30, 23, 0)));
+    Assert::IsTrue(index.covers(time(1, 17, 59)));
+    Assert::IsFalse(index.covers(time(1, 18, 0)));
+
+    // The month has 30 days, so there is no 31st
+    Assert::IsFalse(index.covers(time(31, 6, 0)));
+    Assert::IsTrue(index.prevailing(time(30, 23, 59)) == index.prevailing(time(1, 0, 0)));
+
+    auto const& tempo = index.worst_case(time(30, 13, 0));
+    Assert::AreEqual(7000.0, tempo.visibility_group->distance, 0.001);
+    Assert::AreEqual(9999.0, index.prevailing(time(30, 13, 0)).visibility_group->distance, 0.001);
+
+    auto const& cavok = index.prevailing(time(1, 5, 59));
+    Assert::AreEqual(uint16_t(200), cavok.wind_group->direction);
+    Assert::IsTrue(cavok.ceiling.is_unlimited());
+    Assert::AreEqual(aw::flight_category::vfr, cavok.category);
+
+    auto const& from = index.prevailing(time(1, 6, 0));
+    Assert::AreEqual(uint16_t(180), from.wind_group->direction);
+    Assert::AreEqual(uint32_t(1500), from.ceiling.layer_height);
+    Assert::AreEqual(aw::flight_category::mvfr, from.category);
+}
+
+void TafIndexTests::TAFIndex_MonthLength()
+{
+    aw::taf_index february{ aw::taf(g_februaryTaf) };
+    Assert::IsTrue(february.covers(time(28, 23, 59)));
+    Assert::IsFalse(february.covers(time(29, 0, 0)));
+    Assert::IsFalse(february.covers(time(30, 0, 0)));
+    Assert::IsTrue(february.covers(time(1, 0, 0)));
+    Assert::AreEqual(uint16_t(310), february.prevailing(time(1, 5, 59)).wind_group->direction);
+    Assert::AreEqual(uint16_t(290), february.prevailing(time(1, 6, 0)).wind_group->direction);
+
+    aw::taf_index longMonth{ aw::taf(g_longMonthTaf) };
+    Assert::IsTrue(longMonth.covers(time(31, 0, 0)));
+    Assert::AreEqual(uint16_t(220), longMonth.prevailing(time(31, 5, 59)).wind_group->direction);
+    Assert::AreEqual(uint16_t(250), longMonth.prevailing(time(31, 6, 0)).wind_group->direction);
+    Assert::IsTrue(longMonth.covers(time(1, 23, 59)));
+    Assert::IsFalse(longMonth.covers(time(2, 0, 0)));
+}
+
+void TafIndexTests::TAFIndex_Batch()
+{
+    aw::taf_index_set set;
+    set.insert(aw::taf(g_domesticTaf));
+    set.insert(aw::taf(g_internationalTaf));
+    Assert::AreEqual(size_t(2), set.size());
+
+    std::vector<taf_query> queries =
+    {
+        { "KLMN", time(12, 19, 0) },
+        { "KLMN", time(13, 2, 0) },
+        { "EGLL", time(1, 6, 0) },
+        { "KLMN", time(14, 0, 0) },
+        { "KABC", time(12, 19, 0) }
+    };
+
+    std::vector<taf_conditions const*> results;
+    set.prevailing(queries, results);
+    Assert::AreEqual(queries.size(), results.size());
+    Assert::IsTrue(&set.find("KLMN")->prevailing(time(12, 19, 0)) == results[0]);
+    Assert::IsTrue(&set.find("KLMN")->prevailing(time(13, 2, 0)) == results[1]);
+    Assert::IsTrue(&set.find("EGLL")->prevailing(time(1, 6, 0)) == results[2]);
+    Assert::IsTrue(results[3] == nullptr);
+    Assert::IsTrue(results[4] == nullptr);
+
+    set.worst_case(queries, results);
+    Assert::AreEqual(aw::flight_category::ifr, results[1]->category);
+
+    std::vector<time> times = { time(12, 17, 0), time(12, 19, 0), time(13, 5, 0) };
+    set.find("KLMN")->worst_case(times, results);
+    Assert::AreEqual(size_t(3), results.size());
+    Assert::IsTrue(results[0] == nullptr);
+    Assert::AreEqual(aw::flight_category::vfr, results[1]->category);
+    Assert::AreEqual(aw::flight_category::lifr, results[2]->category);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
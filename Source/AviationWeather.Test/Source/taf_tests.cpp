@@ -0,0 +1,210 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <string>
+
+#include <AviationWeather/taf.h>
+
+#include "framework.h"
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+const char* g_domesticTaf =
+    "TAF KXYZ 051130Z 0512/0618 31008KT P6SM SCT025 BKN250 "
+    "FM051800 33012G20KT 5SM -SHRA BKN030 "
+    "TEMPO 0520/0524 3SM TSRA BKN015CB "
+    "PROB30 0600/0606 2SM BR OVC008 "
+    "BECMG 0608/0610 VRB03KT "
+    "FM061200 27010KT P6SM SKC";
+
+const char* g_internationalTaf =
+    "TAF EGLL 311100Z 3112/0118 24015KT 9999 SCT030 TEMPO 3112/3116 7000 -SHRA BECMG 3118/3121 20008KT CAVOK";
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(TafTests)
+{
+public:
+    TEST_METHOD(TAF_ChangeGroups);
+    TEST_METHOD(TAF_Elements);
+    TEST_METHOD(TAF_International);
+    TEST_METHOD(TAF_Reuse);
+    TEST_METHOD(TAF_Nil);
+};
+
+//-----------------------------------------------------------------------------
+
+void TafTests::TAF_ChangeGroups()
+{
+    aw::taf t(g_domesticTaf);
+
+    Assert::AreEqual(std::string("KXYZ"), t.identifier);
+    Assert::IsTrue(taf_report_type::routine == t.type);
+    Assert::IsTrue(time(5, 11, 30) == t.issue_time);
+    Assert::IsTrue(time(5, 12, 0) == t.valid_from);
+    Assert::IsTrue(time(6, 18, 0) == t.valid_to);
+    Assert::AreEqual(size_t(6), t.forecast_group.size());
+
+    auto const& initial = t.forecast_group[0];
+    Assert::IsTrue(taf_change_type::initial == initial.change);
+    Assert::IsTrue(time(5, 12, 0) == initial.begin);
+    Assert::IsTrue(time(5, 18, 0) == initial.end);
+    Assert::AreEqual(uint16_t(310), initial.wind_group->direction);
+    Assert::IsTrue(visibility_modifier_type::greater_than == initial.visibility_group->modifier);
+    Assert::AreEqual(6.0, initial.visibility_group->distance, 0.001);
+    Assert::AreEqual(size_t(2), initial.sky_condition_group.size());
+
+    auto const& from = t.forecast_group[1];
+    Assert::IsTrue(taf_change_type::from == from.change);
+    Assert::IsTrue(time(5, 18, 0) == from.begin);
+    Assert::IsTrue(time(6, 12, 0) == from.end);
+    Assert::AreEqual(uint8_t(20), from.wind_group->gust_speed);
+    Assert::AreEqual(size_t(1), from.weather_group.size());
+    Assert::IsTrue(weather_intensity::light == from.weather_group[0].intensity);
+    Assert::IsTrue(weather_descriptor::showers == from.weather_group[0].descriptor);
+
+    auto const& tempo = t.forecast_group[2];
+    Assert::IsTrue(taf_change_type::temporary == tempo.change);
+    Assert::AreEqual(uint8_t(0), tempo.probability);
+    Assert::IsTrue(time(5, 20, 0) == tempo.begin);
+    Assert::IsTrue(time(5, 24, 0) == tempo.end);
+    Assert::IsTrue(sky_cover_cloud_type::cumulonimbus == tempo.sky_condition_group[0].cloud_type);
+    Assert::AreEqual(uint32_t(1500), tempo.sky_condition_group[0].layer_height);
+
+    auto const& prob = t.forecast_group[3];
+    Assert::IsTrue(taf_change_type::probability == prob.change);
+    Assert::AreEqual(uint8_t(30), prob.probability);
+    Assert::IsTrue(time(6, 0, 0) == prob.begin);
+    Assert::IsTrue(time(6, 6, 0) == prob.end);
+
+    auto const& becoming = t.forecast_group[4];
+    Assert::IsTrue(taf_change_type::becoming == becoming.change);
+    Assert::IsTrue(becoming.wind_group->is_variable());
+    Assert::IsFalse(static_cast<bool>(becoming.visibility_group));
+
+    auto const& last = t.forecast_group[5];
+    Assert::IsTrue(time(6, 12, 0) == last.begin);
+    Assert::IsTrue(time(6, 18, 0) == last.end);
+    Assert::IsTrue(sky_cover_type::sky_clear == last.sky_condition_group[0].sky_cover);
+}
+
+//-----------------------------------------------------------------------------
+
+void TafTests::TAF_Elements()
+{
+    aw::taf t(
+        "TAF AMD KPDX 041720Z 0418/0518 32007KT 1 1/2SM BR OVC004 WS015/30045KT\n"
+        "  FM042100 30010KT 210V250 P6SM NSW BKN020\n"
+        "  PROB40 TEMPO 0500/0504 9999 -RA RMK NXT FCST BY 00Z=");
+
+    Assert::IsTrue(taf_report_type::amended == t.type);
+    Assert::AreEqual(size_t(3), t.forecast_group.size());
+    Assert::AreEqual(std::string("NXT FCST BY 00Z"), t.remarks);
+
+    auto const& initial = t.forecast_group[0];
+    Assert::AreEqual(1.5, initial.visibility_group->distance, 0.001);
+    Assert::IsTrue(distance_unit::statute_miles == initial.visibility_group->unit);
+    Assert::IsTrue(weather_phenomena::mist == initial.weather_group[0].phenomena[0]);
+    Assert::AreEqual(uint32_t(1500), initial.wind_shear_group->height);
+    Assert::AreEqual(uint16_t(300), initial.wind_shear_group->wind_group.direction);
+    Assert::AreEqual(uint8_t(45), initial.wind_shear_group->wind_group.wind_speed);
+
+    auto const& from = t.forecast_group[1];
+    Assert::IsTrue(from.no_significant_weather);
+    Assert::AreEqual(uint16_t(210), *from.wind_group->variation_lower);
+    Assert::AreEqual(uint16_t(250), *from.wind_group->variation_upper);
+    Assert::IsTrue(time(5, 18, 0) == from.end);
+
+    auto const& prob = t.forecast_group[2];
+    Assert::IsTrue(taf_change_type::temporary == prob.change);
+    Assert::AreEqual(uint8_t(40), prob.probability);
+    Assert::IsTrue(distance_unit::metres == prob.visibility_group->unit);
+    Assert::AreEqual(9999.0, prob.visibility_group->distance, 0.001);
+    Assert::IsTrue(weather_phenomena::rain == prob.weather_group[0].phenomena[0]);
+}
+
+//-----------------------------------------------------------------------------
+
+void TafTests::TAF_International()
+{
+    aw::taf t(g_internationalTaf);
+
+    Assert::AreEqual(std::string("EGLL"), t.identifier);
+    Assert::IsTrue(time(1, 18, 0) == t.valid_to);
+    Assert::AreEqual(size_t(3), t.forecast_group.size());
+    Assert::AreEqual(7000.0, t.forecast_group[1].visibility_group->distance, 0.001);
+    Assert::AreEqual(double(UINT16_MAX), t.forecast_group[2].visibility_group->distance, 0.001);
+
+    aw::taf nsc("TAF EDDF 311100Z 3112/0118 24015KT 9999 NSC BECMG 3118/3121 NCD");
+    Assert::IsTrue(sky_cover_type::no_significant_cloud == nsc.forecast_group[0].sky_condition_group[0].sky_cover);
+    Assert::IsTrue(sky_cover_type::no_cloud_detected == nsc.forecast_group[1].sky_condition_group[0].sky_cover);
+}
+
+//-----------------------------------------------------------------------------
+
+void TafTests::TAF_Reuse()
+{
+    aw::taf reused(g_domesticTaf);
+    reused.parse(g_internationalTaf);
+
+    aw::taf expected(g_internationalTaf);
+    Assert::IsTrue(expected == reused);
+    Assert::AreEqual(expected.raw_data, reused.raw_data);
+
+    reused.parse(g_domesticTaf);
+    Assert::IsTrue(aw::taf(g_domesticTaf) == reused);
+    Assert::IsTrue(expected != reused);
+
+    aw::taf moved(std::move(reused));
+    Assert::AreEqual(size_t(6), moved.forecast_group.size());
+    Assert::AreEqual(size_t(0), reused.forecast_group.size());
+}
+
+//-----------------------------------------------------------------------------
+
+void TafTests::TAF_Nil()
+{
+    aw::taf t("TAF KXYZ 051130Z NIL=");
+
+    Assert::AreEqual(std::string("KXYZ"), t.identifier);
+    Assert::AreEqual(size_t(0), t.forecast_group.size());
+
+    aw::taf cancelled("TAF AMD KXYZ 051530Z 0515/0618 CNL=");
+    Assert::IsTrue(cancelled.cancelled);
+    Assert::AreEqual(size_t(1), cancelled.forecast_group.size());
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
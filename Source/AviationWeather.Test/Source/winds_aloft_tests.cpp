@@ -0,0 +1,218 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <string>
+#include <vector>
+
+#include <AviationWeather/winds_aloft.h>
+
+#include "framework.h"
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+const char* g_windsAloft =
+    "FBUS31 KWNO 011359\n"
+    "FD1US1\n"
+    "DATA BASED ON 011200Z\n"
+    "VALID 011800Z   FOR USE 1400-2100Z. TEMPS NEG ABV 24000\n"
+    "\n"
+    "FT  3000    6000    9000   12000   18000   24000  30000  34000  39000\n"
+    "ABI      2206+18 2212+14 2309+08 2415-07 2529-18 252634 252944 263154\n"
+    "BOS 3119 2725-03 2740-07 2854-11 2874-23 2893-35 780651 781059 780958\n"
+    "DEN              2420+02 2535-04 2561-17 2581-29 760743 770453 771563\n"
+    "MIA 0510 3510+16 9900+11 3605+06 3111-06 2915-18 282533 272742 262951\n"
+    "\n"
+    "DATA BASED ON 011200Z\n"
+    "VALID 011800Z   FOR USE 1400-2100Z. TEMPS NEG ABV 24000\n"
+    "\n"
+    "FT  45000  53000\n"
+    "BOS 771056 750455\n";
+
+const char* g_laterWindsAloft =
+    "DATA BASED ON 011200Z\n"
+    "VALID 020000Z   FOR USE 2100-0600Z. TEMPS NEG ABV 24000\n"
+    "\n"
+    "FT  3000    6000    9000   12000   18000   24000  30000  34000  39000\n"
+    "BOS 3119 2735-07 2750-11 2854-11 2874-23 2893-35 780651 781059 780958\n";
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(WindsAloftTests)
+{
+public:
+    TEST_METHOD(WindsAloft_Header);
+    TEST_METHOD(WindsAloft_Cells);
+    TEST_METHOD(WindsAloft_Interpolate);
+    TEST_METHOD(WindsAloft_InterpolateTime);
+    TEST_METHOD(WindsAloft_Reuse);
+};
+
+//-----------------------------------------------------------------------------
+
+void WindsAloftTests::WindsAloft_Header()
+{
+    aw::winds_aloft w(g_windsAloft);
+
+    Assert::IsTrue(time(1, 12, 0) == w.based_on);
+    Assert::IsTrue(time(1, 18, 0) == w.valid);
+    Assert::AreEqual(uint8_t(14), w.use_from.hour_of_day);
+    Assert::AreEqual(uint8_t(21), w.use_to.hour_of_day);
+    Assert::AreEqual(uint32_t(24000), w.negative_above);
+
+    // Both sections share one set of columns
+    Assert::AreEqual(size_t(11), w.altitudes.size());
+    Assert::AreEqual(uint32_t(3000), w.altitudes.front());
+    Assert::AreEqual(uint32_t(53000), w.altitudes.back());
+
+    Assert::AreEqual(size_t(4), w.stations.size());
+    Assert::AreEqual(size_t(1), w.find_station("BOS"));
+    Assert::AreEqual(size_t(3), w.find_station("MIA"));
+    Assert::AreEqual(aw::winds_aloft::npos, w.find_station("XYZ"));
+}
+
+void WindsAloftTests::WindsAloft_Cells()
+{
+    aw::winds_aloft w(g_windsAloft);
+    auto const bos = w.find_station("BOS");
+
+    auto low = w.wind_at(bos, 0);
+    Assert::AreEqual(uint16_t(310), low->direction);
+    Assert::AreEqual(uint8_t(19), low->wind_speed);
+    Assert::IsFalse(static_cast<bool>(w.temperature_at(bos, 0)));
+    Assert::AreEqual(int8_t(-3), *w.temperature_at(bos, 1));
+
+    // 50 is added to the direction code for 100 knots or more, and
+    // temperatures above 24000 feet are negative without a sign
+    auto high = w.wind_at(bos, 6);
+    Assert::AreEqual(uint16_t(280), high->direction);
+    Assert::AreEqual(uint8_t(106), high->wind_speed);
+    Assert::AreEqual(int8_t(-51), *w.temperature_at(bos, 6));
+
+    auto highest = w.wind_at(bos, 10);
+    Assert::AreEqual(uint16_t(250), highest->direction);
+    Assert::AreEqual(uint8_t(104), highest->wind_speed);
+    Assert::AreEqual(int8_t(-55), *w.temperature_at(bos, 10));
+
+    auto const abi = w.find_station("ABI");
+    Assert::IsFalse(static_cast<bool>(w.wind_at(abi, 0)));
+    Assert::AreEqual(int8_t(18), *w.temperature_at(abi, 1));
+    Assert::IsFalse(static_cast<bool>(w.wind_at(abi, 9)));
+
+    auto const den = w.find_station("DEN");
+    Assert::IsFalse(static_cast<bool>(w.wind_at(den, 1)));
+    Assert::AreEqual(uint16_t(240), w.wind_at(den, 2)->direction);
+
+    auto lightAndVariable = w.wind_at(w.find_station("MIA"), 2);
+    Assert::IsTrue(lightAndVariable->is_variable());
+    Assert::AreEqual(uint8_t(0), lightAndVariable->wind_speed);
+    Assert::AreEqual(int8_t(11), *w.temperature_at(w.find_station("MIA"), 2));
+}
+
+void WindsAloftTests::WindsAloft_Interpolate()
+{
+    aw::winds_aloft w(g_windsAloft);
+    auto const bos = w.find_station("BOS");
+
+    winds_aloft_sample sample;
+    Assert::IsTrue(w.interpolate(bos, 9000.0, sample));
+    Assert::AreEqual(270.0, sample.direction, 0.001);
+    Assert::AreEqual(40.0, sample.speed, 0.001);
+    Assert::AreEqual(-7.0, sample.temperature, 0.001);
+
+    Assert::IsTrue(w.interpolate(bos, 7500.0, sample));
+    Assert::AreEqual(270.0, sample.direction, 0.001);
+    Assert::AreEqual(32.5, sample.speed, 0.001);
+    Assert::IsTrue(sample.has_temperature);
+    Assert::AreEqual(-5.0, sample.temperature, 0.001);
+
+    // No temperature is forecast at 3000 feet
+    Assert::IsTrue(w.interpolate(bos, 4500.0, sample));
+    Assert::IsFalse(sample.has_temperature);
+
+    // Direction wraps through north: 050/10 and 350/10
+    Assert::IsTrue(w.interpolate(w.find_station("MIA"), 4500.0, sample));
+    Assert::AreEqual(20.0, sample.direction, 0.001);
+    Assert::AreEqual(8.660, sample.speed, 0.001);
+
+    // Missing cells are skipped, but values are not extrapolated
+    auto const den = w.find_station("DEN");
+    Assert::IsFalse(w.interpolate(den, 5000.0, sample));
+    Assert::IsTrue(w.interpolate(den, 10500.0, sample));
+    Assert::IsFalse(w.interpolate(bos, 60000.0, sample));
+    Assert::IsFalse(w.interpolate(aw::winds_aloft::npos, 9000.0, sample));
+
+    std::vector<double> altitudes = { 2000.0, 9000.0, 45000.0 };
+    std::vector<winds_aloft_sample> samples;
+    w.interpolate(bos, altitudes, samples);
+    Assert::AreEqual(size_t(3), samples.size());
+    Assert::IsFalse(samples[0].has_wind);
+    Assert::AreEqual(40.0, samples[1].speed, 0.001);
+    Assert::AreEqual(110.0, samples[2].speed, 0.001);
+}
+
+void WindsAloftTests::WindsAloft_InterpolateTime()
+{
+    aw::winds_aloft earlier(g_windsAloft);
+    aw::winds_aloft later(g_laterWindsAloft);
+
+    winds_aloft_sample sample;
+    Assert::IsTrue(interpolate(earlier, later, "BOS", 9000.0, time(1, 21, 0), sample));
+    Assert::AreEqual(270.0, sample.direction, 0.001);
+    Assert::AreEqual(45.0, sample.speed, 0.001);
+    Assert::AreEqual(-9.0, sample.temperature, 0.001);
+
+    // Clamped outside the two valid times
+    Assert::IsTrue(interpolate(earlier, later, "BOS", 9000.0, time(1, 12, 0), sample));
+    Assert::AreEqual(40.0, sample.speed, 0.001);
+    Assert::IsTrue(interpolate(earlier, later, "BOS", 9000.0, time(2, 6, 0), sample));
+    Assert::AreEqual(50.0, sample.speed, 0.001);
+
+    Assert::IsFalse(interpolate(earlier, later, "MIA", 9000.0, time(1, 21, 0), sample));
+}
+
+void WindsAloftTests::WindsAloft_Reuse()
+{
+    aw::winds_aloft w(g_windsAloft);
+    w.parse(g_laterWindsAloft);
+
+    Assert::IsTrue(aw::winds_aloft(g_laterWindsAloft) == w);
+    Assert::AreEqual(size_t(1), w.stations.size());
+    Assert::AreEqual(size_t(9), w.altitudes.size());
+    Assert::AreEqual(aw::winds_aloft::npos, w.find_station("MIA"));
+    Assert::AreEqual(uint8_t(35), w.wind_at(0, 1)->wind_speed);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
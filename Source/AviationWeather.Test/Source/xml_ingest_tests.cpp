@@ -0,0 +1,291 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeather.TestPch.h"
+
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <AviationWeather/metar_diff.h>
+#include <AviationWeather/xml_ingest.h>
+
+//-----------------------------------------------------------------------------
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+namespace test
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+// The layout of the dataserver's XML output, abbreviated
+const char* g_document =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<response xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" version=\"1.2\">\n"
+    "  <request_index>41373941</request_index>\n"
+    "  <data_source name=\"metars\" />\n"
+    "  <errors />\n"
+    "  <data num_results=\"3\">\n"
+    "    <METAR>\n"
+    "      <raw_text>KSFO 121756Z 28010G20KT 250V310 10SM FEW015 BKN200 18/09 A3001 RMK AO2 T01830094</raw_text>\n"
+    "      <station_id>KSFO</station_id>\n"
+    "      <observation_time>2015-12-12T17:56:00Z</observation_time>\n"
+    "      <latitude>37.62</latitude>\n"
+    "      <longitude>-122.37</longitude>\n"
+    "      <temp_c>18.3</temp_c>\n"
+    "      <dewpoint_c>9.4</dewpoint_c>\n"
+    "      <wind_dir_degrees>280</wind_dir_degrees>\n"
+    "      <wind_speed_kt>10</wind_speed_kt>\n"
+    "      <wind_gust_kt>20</wind_gust_kt>\n"
+    "      <visibility_statute_mi>10.0</visibility_statute_mi>\n"
+    "      <altim_in_hg>30.008858</altim_in_hg>\n"
+    "      <quality_control_flags>\n"
+    "        <auto_station>TRUE</auto_station>\n"
+    "      </quality_control_flags>\n"
+    "      <sky_condition sky_cover=\"FEW\" cloud_base_ft_agl=\"1500\" />\n"
+    "      <sky_condition sky_cover=\"BKN\" cloud_base_ft_agl=\"20000\" />\n"
+    "      <flight_category>VFR</flight_category>\n"
+    "      <metar_type>METAR</metar_type>\n"
+    "      <elevation_m>3.0</elevation_m>\n"
+    "    </METAR>\n"
+    "    <!-- <METAR><raw_text>commented out</raw_text></METAR> -->\n"
+    "    <METAR>\n"
+    "      <raw_text>EGLL 121750Z 27005MPS 9999 VV002 M01/M03 Q1002 RMK &lt;A&amp;B&gt; &#x41;</raw_text>\n"
+    "      <station_id>EGLL</station_id>\n"
+    "      <observation_time>2015-12-12T17:50:00Z</observation_time>\n"
+    "      <latitude>51.48</latitude>\n"
+    "      <temp_c>-1.0</temp_c>\n"
+    "      <dewpoint_c>-3.0</dewpoint_c>\n"
+    "      <wind_dir_degrees>270</wind_dir_degrees>\n"
+    "      <wind_speed_kt>10</wind_speed_kt>\n"
+    "      <visibility_statute_mi>6.21</visibility_statute_mi>\n"
+    "      <altim_in_hg>29.588583</altim_in_hg>\n"
+    "      <sky_condition sky_cover='OVX' cloud_base_ft_agl='200'/>\n"
+    "      <metar_type>METAR</metar_type>\n"
+    "    </METAR>\n"
+    "    <METAR>\n"
+    "      <raw_text><![CDATA[SPECI KPDX 121753Z 32007KT 2SM BR OVC004 10/09 A3000]]></raw_text>\n"
+    "      <station_id>KPDX</station_id>\n"
+    "      <observation_time>2015-12-12T17:43:00Z</observation_time>\n"
+    "      <temp_c>12.0</temp_c>\n"
+    "      <dewpoint_c>9.0</dewpoint_c>\n"
+    "      <wind_dir_degrees>320</wind_dir_degrees>\n"
+    "      <wind_speed_kt>7</wind_speed_kt>\n"
+    "      <visibility_statute_mi>10+</visibility_statute_mi>\n"
+    "      <altim_in_hg>30.0</altim_in_hg>\n"
+    "      <sky_condition sky_cover=\"BKN\" cloud_base_ft_agl=\"400\" />\n"
+    "      <metar_type>METAR</metar_type>\n"
+    "    </METAR>\n"
+    "  </data>\n"
+    "</response>\n";
+
+// Reads every report, returning its raw text and decoded station
+std::vector<std::string> read_all(xml_reader& reader)
+{
+    std::vector<std::string> results;
+    while (reader.next())
+    {
+        results.push_back(reader.report().raw_data.to_string() + "|" + reader.fields().station_id.to_string());
+    }
+    return results;
+}
+
+std::string make_document(size_t reports)
+{
+    std::string text = "<response><data>";
+    char element[256];
+    for (size_t i = 0; i < reports; ++i)
+    {
+        snprintf(element, sizeof(element),
+            "<METAR><raw_text>K%03u 12%02u56Z 28010KT 10SM BKN015 %02u/05 A3010</raw_text><station_id>K%03u</station_id>"
+            "<temp_c>%u</temp_c></METAR>\n",
+            static_cast<unsigned>(i % 1000), static_cast<unsigned>(i % 24), static_cast<unsigned>(i % 30),
+            static_cast<unsigned>(i % 1000), static_cast<unsigned>(i % 30));
+        text += element;
+    }
+    text += "</data></response>";
+    return text;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+TEST_CLASS(XmlIngestTests)
+{
+public:
+    TEST_METHOD(XmlIngest_Dataserver);
+    TEST_METHOD(XmlIngest_CrossCheck);
+    TEST_METHOD(XmlIngest_Stream);
+    TEST_METHOD(XmlIngest_Errors);
+};
+
+//-----------------------------------------------------------------------------
+
+void XmlIngestTests::XmlIngest_Dataserver()
+{
+    xml_reader reader(g_document, strlen(g_document));
+
+    Assert::IsTrue(reader.next());
+    auto const& ksfo = reader.report();
+    auto const& fields = reader.fields();
+    Assert::AreEqual(std::string("KSFO"), ksfo.identifier.to_string());
+    Assert::AreEqual(std::string("AO2 T01830094"), ksfo.remarks.to_string());
+
+    // Parsed in place from the document
+    Assert::IsTrue(ksfo.raw_data.data() > g_document && ksfo.raw_data.data() < g_document + strlen(g_document));
+
+    Assert::AreEqual(std::string("2015-12-12T17:56:00Z"), fields.observation_time.to_string());
+    Assert::AreEqual(37.62, fields.position->latitude);
+    Assert::AreEqual(-122.37, fields.position->longitude);
+    Assert::AreEqual(3.0, *fields.elevation);
+    Assert::AreEqual(18.3, *fields.temperature);
+    Assert::AreEqual(20.0, *fields.wind_gust);
+    Assert::AreEqual(30.008858, *fields.altimeter);
+    Assert::AreEqual(size_t(2), fields.sky_condition.size());
+    Assert::AreEqual(std::string("BKN"), fields.sky_condition[1].sky_cover.to_string());
+    Assert::AreEqual(20000u, *fields.sky_condition[1].cloud_base);
+
+    // Entities are replaced; a position needs both coordinates. The element
+    // in the comment is skipped.
+    Assert::IsTrue(reader.next());
+    Assert::AreEqual(std::string("EGLL 121750Z 27005MPS 9999 VV002 M01/M03 Q1002 RMK <A&B> A"), reader.report().raw_data.to_string());
+    Assert::AreEqual(std::string("<A&B> A"), reader.report().remarks.to_string());
+    Assert::IsFalse(static_cast<bool>(reader.fields().position));
+    Assert::IsFalse(static_cast<bool>(reader.fields().elevation));
+    Assert::AreEqual(std::string("OVX"), reader.fields().sky_condition[0].sky_cover.to_string());
+
+    // CDATA, and visibility beyond what is reported
+    Assert::IsTrue(reader.next());
+    Assert::AreEqual(std::string("SPECI KPDX 121753Z 32007KT 2SM BR OVC004 10/09 A3000"), reader.report().raw_data.to_string());
+    Assert::IsTrue(reader.report().type == metar_report_type::special);
+    Assert::AreEqual(10.0, *reader.fields().visibility);
+
+    Assert::IsFalse(reader.next());
+    Assert::IsFalse(reader.next());
+}
+
+//-----------------------------------------------------------------------------
+
+void XmlIngestTests::XmlIngest_CrossCheck()
+{
+    xml_reader unchecked(g_document, strlen(g_document));
+    while (unchecked.next())
+    {
+        Assert::AreEqual(uint16_t(0), unchecked.mismatches());
+    }
+
+    xml_reader reader(g_document, strlen(g_document), true);
+
+    // Decoded values that are rounded or converted agree with the report
+    Assert::IsTrue(reader.next());
+    Assert::AreEqual(uint16_t(0), reader.mismatches());
+    Assert::IsTrue(reader.next());
+    Assert::AreEqual(uint16_t(0), reader.mismatches());
+
+    // The last element was decoded from a different report
+    Assert::IsTrue(reader.next());
+    auto mismatches = reader.mismatches();
+    Assert::IsTrue((mismatches & element_mask(metar_element_type::report_type)) != 0);
+    Assert::IsTrue((mismatches & element_mask(metar_element_type::observation_time)) != 0);
+    Assert::IsTrue((mismatches & element_mask(metar_element_type::visibility)) != 0);
+    Assert::IsTrue((mismatches & element_mask(metar_element_type::sky_condition)) != 0);
+    Assert::IsTrue((mismatches & element_mask(metar_element_type::temperature_dewpoint)) != 0);
+    Assert::AreEqual(uint16_t(0), static_cast<uint16_t>(mismatches & (
+        element_mask(metar_element_type::station_identifier) | element_mask(metar_element_type::wind) |
+        element_mask(metar_element_type::altimeter))));
+
+    // Winds varying between two directions still have a direction to check
+    const char* varying =
+        "<METAR><raw_text>KSFO 121756Z 28010KT 250V310 10SM FEW015 18/09 A3001</raw_text>"
+        "<wind_dir_degrees>290</wind_dir_degrees><wind_speed_kt>10</wind_speed_kt></METAR>";
+    xml_reader windReader(varying, strlen(varying), true);
+    Assert::IsTrue(windReader.next());
+    Assert::AreEqual(element_mask(metar_element_type::wind), windReader.mismatches());
+}
+
+//-----------------------------------------------------------------------------
+
+void XmlIngestTests::XmlIngest_Stream()
+{
+    std::string document(g_document);
+    xml_reader memory(document.data(), document.size());
+    auto expected = read_all(memory);
+    Assert::AreEqual(size_t(3), expected.size());
+
+    // Blocks smaller than a tag split every construct across reads
+    for (size_t blockSize : { 1u, 5u, 7u, 64u, 1000u, 65536u })
+    {
+        std::istringstream stream(document);
+        xml_reader reader(stream, true, blockSize);
+        Assert::IsTrue(expected == read_all(reader));
+    }
+
+    // The buffer holds one element and a block, whatever the document size
+    auto large = make_document(20000);
+    std::istringstream stream(large);
+    xml_reader reader(stream, true, 4096);
+    size_t count = 0;
+    while (reader.next())
+    {
+        char station[8];
+        snprintf(station, sizeof(station), "K%03u", static_cast<unsigned>(count % 1000));
+        Assert::AreEqual(std::string(station), reader.report().identifier.to_string());
+        Assert::AreEqual(uint16_t(0), reader.mismatches());
+        ++count;
+    }
+    Assert::AreEqual(size_t(20000), count);
+}
+
+//-----------------------------------------------------------------------------
+
+void XmlIngestTests::XmlIngest_Errors()
+{
+    const char* truncated = "<data><METAR><raw_text>KSFO 121756Z 28010KT 10SM FEW015 18/09 A3001</raw_text>";
+    xml_reader reader(truncated, strlen(truncated));
+    Assert::ExpectException<aw_exception>([&]() { reader.next(); });
+
+    std::istringstream stream(truncated);
+    xml_reader streamed(stream, false, 16);
+    Assert::ExpectException<aw_exception>([&]() { streamed.next(); });
+
+    const char* missing = "<data><METAR><station_id>KSFO</station_id></METAR></data>";
+    xml_reader noText(missing, strlen(missing));
+    Assert::ExpectException<aw_exception>([&]() { noText.next(); });
+
+    // Elements with other names are not reports
+    const char* other = "<data><METARS><raw_text>KSFO</raw_text></METARS><TAF/></data>";
+    xml_reader none(other, strlen(other));
+    Assert::IsFalse(none.next());
+
+    xml_reader empty("", 0);
+    Assert::IsFalse(empty.next());
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace test
+} // namespace aw
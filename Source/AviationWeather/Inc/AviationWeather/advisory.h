@@ -0,0 +1,179 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <AviationWeather/components.h>
+#include <AviationWeather/optional.h>
+#include <AviationWeather/string_view.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+enum class advisory_type
+{
+    airmet,
+    sigmet,
+    convective_sigmet
+};
+
+enum class hazard_type
+{
+    unknown,
+    thunderstorm,          // TS, convective SIGMETs
+    turbulence,            // TURB
+    icing,                 // ICE, ICG
+    ifr,                   // IFR
+    mountain_obscuration,  // MTN OBSCN
+    surface_wind,          // SFC WND
+    low_level_wind_shear,  // LLWS
+    mountain_wave,         // MTW
+    volcanic_ash,          // VA
+    dust_sand,             // DS, SS
+    tropical_cyclone       // TC
+};
+
+enum class advisory_geometry
+{
+    none,  // No location, or one that could not be decoded
+    area,  // Closed polygon
+    line   // Line or isolated cell, with a width
+};
+
+//-----------------------------------------------------------------------------
+
+// Position in decimal degrees, north and east positive
+struct geo_point
+{
+    double latitude;
+    double longitude;
+};
+
+// Known navaid positions, used to place VOR-relative advisory points
+class navaid_table
+{
+public:
+    void add(station_identifier const& identifier, geo_point const& position);
+    geo_point const* find(util::string_view const& identifier) const;
+    size_t size() const;
+
+private:
+    std::unordered_map<std::string, geo_point> m_navaids;
+};
+
+//-----------------------------------------------------------------------------
+
+// A vertex of an advisory area, either relative to a navaid (30NW ICT) or a
+// latitude and longitude (N5130 W00200).
+class advisory_point
+{
+public:
+    typedef std::shared_ptr<advisory_point> pointer;
+    typedef std::unique_ptr<advisory_point> unique_pointer;
+
+    advisory_point();
+
+    advisory_point(advisory_point const& other) = default;
+    advisory_point(advisory_point && other);
+
+    advisory_point& operator= (advisory_point const& rhs) = default;
+    advisory_point& operator= (advisory_point && rhs);
+
+    bool operator== (advisory_point const& rhs) const;
+    bool operator!= (advisory_point const& rhs) const;
+
+public:
+    station_identifier        navaid;    // Empty for latitude and longitude points
+    double                    bearing;   // Degrees from the navaid
+    uint16_t                  distance;  // Nautical miles from the navaid
+    util::optional<geo_point> position;  // Set when decoded or resolved
+};
+
+//-----------------------------------------------------------------------------
+
+// AIRMET, SIGMET or convective SIGMET in the US domestic or ICAO format.
+// Geometry tests treat latitude and longitude as a plane scaled by the
+// cosine of the latitude, which is accurate enough for advisory sized areas
+// away from the poles. Longitudes are taken relative to the first point, so
+// areas and segments may cross the antimeridian.
+class advisory
+{
+public:
+    typedef std::shared_ptr<advisory> pointer;
+    typedef std::unique_ptr<advisory> unique_pointer;
+
+    advisory();
+    advisory(std::string const& advisory);
+
+    advisory(advisory const& other) = default;
+    advisory(advisory && other);
+
+    advisory& operator= (advisory const& rhs) = default;
+    advisory& operator= (advisory && rhs);
+
+    bool operator== (advisory const& rhs) const;
+    bool operator!= (advisory const& rhs) const;
+
+    // Places navaid-relative points. Returns whether every point has a position.
+    bool resolve(navaid_table const& navaids);
+    bool has_position() const;
+
+    // Whether the time is within the validity period
+    bool active(time const& at) const;
+
+    // Whether the advisory covers the point or any part of the segment.
+    // Always false until every point has a position.
+    bool contains(geo_point const& point) const;
+    bool intersects(geo_point const& from, geo_point const& to) const;
+
+    // Whether the altitude in feet is within the altitude band
+    bool covers_altitude(uint32_t altitude) const;
+
+public:
+    std::string                 raw_data;
+    advisory_type               type;
+    std::string                 identifier;      // 45C, NOVEMBER 3, TANGO, EGTT 3
+    hazard_type                 hazard;
+    util::optional<time>        valid_from;      // Issue time if the report has no start
+    time                        valid_to;
+    util::optional<uint32_t>    lower_altitude;  // Feet, 0 for the surface
+    util::optional<uint32_t>    upper_altitude;  // Feet, missing if unbounded
+    advisory_geometry           geometry;
+    uint16_t                    width;           // Nautical miles, for lines and isolated cells
+    std::vector<advisory_point> points;
+
+private:
+    friend std::vector<advisory> decode_advisories(std::string const& bulletin);
+
+    void parse(util::string_view const& text, util::optional<time> const& issueTime, std::string const& series,
+        util::optional<time> const& seriesValidTo);
+};
+
+// Splits a bulletin into its advisories. The WMO or AIRMET header supplies
+// the issue time, and an AIRMET series header (AIRMET TANGO ... VALID UNTIL)
+// supplies the validity for the areas that follow it. Outlooks are skipped.
+std::vector<advisory> decode_advisories(std::string const& bulletin);
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -0,0 +1,91 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <AviationWeather/advisory.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+struct geo_box
+{
+    double min_latitude;
+    double min_longitude;
+    double max_latitude;
+    double max_longitude;
+};
+
+//-----------------------------------------------------------------------------
+
+// Spatial index over a set of advisories, packed once with the sort-tile-
+// recursive method into a read-only R-tree. Queries first walk the bounding
+// boxes and then apply the validity and exact geometry tests to the
+// candidates, so results match testing every advisory in turn. Advisories
+// without a position are kept but never returned.
+class advisory_index
+{
+public:
+    typedef std::shared_ptr<advisory_index> pointer;
+    typedef std::unique_ptr<advisory_index> unique_pointer;
+
+    static const size_t node_capacity = 8;
+
+    advisory_index();
+    advisory_index(std::vector<advisory> advisories);
+
+    advisory_index(advisory_index const& other) = default;
+    advisory_index(advisory_index && other);
+
+    advisory_index& operator= (advisory_index const& rhs) = default;
+    advisory_index& operator= (advisory_index && rhs);
+
+    void build(std::vector<advisory> advisories);
+
+    std::vector<advisory> const& advisories() const;
+    size_t size() const;
+
+    // Indexes into advisories() of those active at the time that contain the
+    // point, or that intersect the segment, in ascending order
+    void query(geo_point const& point, time const& at, std::vector<size_t>& results) const;
+    void query(geo_point const& from, geo_point const& to, time const& at, std::vector<size_t>& results) const;
+
+private:
+    struct node
+    {
+        geo_box  bounds;
+        uint32_t first;  // First child in the level below, or entry for the leaves
+        uint32_t count;
+    };
+
+    template <typename TIntersects, typename TAccept>
+    void search(TIntersects && intersects, TAccept && accept, std::vector<size_t>& results) const;
+
+private:
+    std::vector<advisory>          m_advisories;
+    std::vector<geo_box>           m_entryBounds;  // In tree order
+    std::vector<uint32_t>          m_entries;      // Advisory index per entry
+    std::vector<std::vector<node>> m_levels;       // Leaves first, root last
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -0,0 +1,108 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <AviationWeather/metar.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// Output of decoded reports in the Apache Arrow IPC streaming format, which
+// pyarrow.ipc.open_stream and the other Arrow readers accept. Each write is
+// one record batch with a row per report and these columns:
+//
+//   raw_text, station, remarks                       utf8
+//   report_type, modifier                            uint8
+//   observation_day, observation_hour,
+//   observation_minute                               uint8
+//   wind_direction, wind_variation_lower,
+//   wind_variation_upper                             uint16, null if absent
+//   wind_speed, wind_gust, wind_unit                 uint8, null if absent
+//   visibility                                       double, null if absent
+//   visibility_unit, visibility_modifier             uint8, null if absent
+//   runway_visual_range                              list<struct<runway_number,
+//                                                      runway_designator, unit,
+//                                                      visibility_min,
+//                                                      visibility_min_modifier,
+//                                                      visibility_max,
+//                                                      visibility_max_modifier,
+//                                                      tendency>>
+//   weather                                          list<struct<intensity,
+//                                                      descriptor,
+//                                                      phenomena: list<uint8>>>
+//   sky_condition                                    list<struct<sky_cover,
+//                                                      layer_height: uint32,
+//                                                      cloud_type>>
+//   temperature, dewpoint                            int8, null if absent
+//   altimeter                                        double, null if absent
+//   altimeter_unit                                   uint8, null if absent
+//
+// Enumerations are stored as the values of their enum types, and RVR
+// visibilities as doubles. A VRB wind has a null direction, and an unlimited
+// layer a null height; heights are in feet. The recent weather, wind shear and
+// trend groups are not written.
+//
+// Reports are encoded straight into the column buffers of the batch, which
+// are kept between writes, so a writer that is reused allocates only when a
+// batch needs more room than the ones before it.
+
+//-----------------------------------------------------------------------------
+
+class arrow_writer
+{
+public:
+    typedef std::shared_ptr<arrow_writer> pointer;
+    typedef std::unique_ptr<arrow_writer> unique_pointer;
+
+    // Appends the stream to the buffer, starting with the schema
+    explicit arrow_writer(std::vector<uint8_t>& buffer);
+    ~arrow_writer();
+
+    arrow_writer(arrow_writer const&) = delete;
+    arrow_writer& operator= (arrow_writer const&) = delete;
+
+    // Appends a record batch. Throws aw_exception after close().
+    void write(metar const* reports, size_t count);
+    void write(metar_view const* reports, size_t count);
+    void write(std::vector<metar> const& reports);
+
+    // Appends the end of stream marker. Further calls do nothing.
+    void close();
+
+private:
+    class batch;
+
+    std::vector<uint8_t>&  m_buffer;
+    size_t                 m_start;   // Where the stream starts in the buffer
+    std::unique_ptr<batch> m_batch;
+    bool                   m_closed;
+};
+
+//-----------------------------------------------------------------------------
+
+// Appends a complete stream of the reports, in batches of at most batchSize
+void write_arrow(std::vector<metar> const& reports, std::vector<uint8_t>& buffer, size_t batchSize = 64 * 1024);
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -19,6 +19,7 @@
 #include <string>
 
 #include <AviationWeather/optional.h>
+#include <AviationWeather/quantities.h>
 #include <AviationWeather/types.h>
 
 namespace aw
@@ -78,6 +79,10 @@ public:
 
     uint8_t gust_factor() const;
 
+    // Components along and across a heading in degrees, in the wind's unit.
+    // Negative headwinds are tailwinds and positive crosswinds are from the
+    // right. Variable winds without a direction return 0; runway_winds gives
+    // the extremes over the variation range.
     double headwind_component(double heading, bool useGusts = false) const;
     double crosswind_component(double heading, bool useGusts = false) const;
 
@@ -101,6 +106,13 @@ public:
     visibility();
     visibility(double distance, distance_unit unit, visibility_modifier_type modifier = visibility_modifier_type::none);
 
+    template <distance_unit Unit>
+    visibility(length<Unit> const& distance, visibility_modifier_type modifier = visibility_modifier_type::none) :
+        unit(Unit),
+        distance(distance.value()),
+        modifier(modifier)
+    {}
+
     visibility(visibility const& other) = default;
     visibility(visibility && other);
 
@@ -116,6 +128,13 @@ public:
     bool operator< (visibility const& rhs) const;
     bool operator> (visibility const& rhs) const;
 
+    // Distance as a quantity in a unit known at compile time
+    template <distance_unit To>
+    length<To> distance_in() const
+    {
+        return length<To>(convert(distance, unit, To));
+    }
+
 public:
     distance_unit            unit;     // Unit of distance
     double                   distance; // Visibility distance in distance_units
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 
 #include <AviationWeather/types.h>
 
@@ -28,6 +29,41 @@ namespace detail
 
 double lookup_ratio(distance_unit from, distance_unit to);
 double lookup_ratio(pressure_unit from, pressure_unit to);
+double lookup_ratio(speed_unit from, speed_unit to);
+
+//-----------------------------------------------------------------------------
+
+// Size of one unit in SI units (metres, pascals and metres per second), for
+// ratios between units that are known at compile time
+constexpr double si_factor(distance_unit unit)
+{
+    return unit == distance_unit::feet ? 0.3048 :
+        unit == distance_unit::metres ? 1.0 :
+        unit == distance_unit::statute_miles ? 1609.344 : 1852.0;
+}
+
+constexpr double si_factor(pressure_unit unit)
+{
+    return unit == pressure_unit::hPa ? 100.0 : 3386.389;
+}
+
+constexpr double si_factor(speed_unit unit)
+{
+    return unit == speed_unit::kt ? 1852.0 / 3600.0 :
+        unit == speed_unit::mph ? 1609.344 / 3600.0 : 1.0;
+}
+
+// Multiplies count values by a ratio; simple enough for the compiler to
+// vectorize once the ratio is a constant
+template <class TValue>
+void scale(TValue const* values, size_t count, double ratio, TValue* results)
+{
+    auto const factor = static_cast<TValue>(ratio);
+    for (size_t i = 0; i < count; ++i)
+    {
+        results[i] = values[i] * factor;
+    }
+}
 
 //-----------------------------------------------------------------------------
 
@@ -35,6 +71,15 @@ double lookup_ratio(pressure_unit from, pressure_unit to);
 
 //-----------------------------------------------------------------------------
 
+// Ratio that converts a value from one unit to another, as a constant
+template <class TUnit, TUnit From, TUnit To>
+struct unit_ratio
+{
+    static constexpr double value = From == To ? 1.0 : detail::si_factor(From) / detail::si_factor(To);
+};
+
+//-----------------------------------------------------------------------------
+
 template <class TReturn = double, class TValue, class TA, class TB>
 TReturn convert(TValue const& value, TA const& from, TB const& to)
 {
@@ -47,4 +92,58 @@ TReturn convert(TValue const& value, TA const& from, TB const& to)
 
 //-----------------------------------------------------------------------------
 
+// Conversions between units known at compile time, which inline to a single
+// multiply, or nothing for the same unit. For example:
+//
+//   auto metres = convert<distance_unit::feet, distance_unit::metres>(feet);
+
+template <distance_unit From, distance_unit To, class TReturn = double, class TValue>
+TReturn convert(TValue const& value)
+{
+    return static_cast<TReturn>(value * unit_ratio<distance_unit, From, To>::value);
+}
+
+template <pressure_unit From, pressure_unit To, class TReturn = double, class TValue>
+TReturn convert(TValue const& value)
+{
+    return static_cast<TReturn>(value * unit_ratio<pressure_unit, From, To>::value);
+}
+
+template <speed_unit From, speed_unit To, class TReturn = double, class TValue>
+TReturn convert(TValue const& value)
+{
+    return static_cast<TReturn>(value * unit_ratio<speed_unit, From, To>::value);
+}
+
+template <distance_unit From, distance_unit To, class TValue>
+void convert(TValue const* values, size_t count, TValue* results)
+{
+    detail::scale(values, count, unit_ratio<distance_unit, From, To>::value, results);
+}
+
+template <pressure_unit From, pressure_unit To, class TValue>
+void convert(TValue const* values, size_t count, TValue* results)
+{
+    detail::scale(values, count, unit_ratio<pressure_unit, From, To>::value, results);
+}
+
+template <speed_unit From, speed_unit To, class TValue>
+void convert(TValue const* values, size_t count, TValue* results)
+{
+    detail::scale(values, count, unit_ratio<speed_unit, From, To>::value, results);
+}
+
+//-----------------------------------------------------------------------------
+
+// Converts count values at once, using SSE2 where available. results may be
+// the same array as values to convert in place.
+void convert(double const* values, size_t count, distance_unit from, distance_unit to, double* results);
+void convert(double const* values, size_t count, pressure_unit from, pressure_unit to, double* results);
+void convert(double const* values, size_t count, speed_unit from, speed_unit to, double* results);
+void convert(float const* values, size_t count, distance_unit from, distance_unit to, float* results);
+void convert(float const* values, size_t count, pressure_unit from, pressure_unit to, float* results);
+void convert(float const* values, size_t count, speed_unit from, speed_unit to, float* results);
+
+//-----------------------------------------------------------------------------
+
 } // namespace aw
@@ -0,0 +1,98 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <AviationWeather/advisory.h>
+#include <AviationWeather/metar.h>
+#include <AviationWeather/optional.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// Ingest of bulk report dumps in CSV, such as the dataserver's: the raw text
+// of each report with decoded columns alongside. Lines before the header row
+// (the dataserver writes a few lines of status first) are skipped; the header
+// row is the first line with a field naming the raw text column. Fields
+// follow RFC 4180: they may be quoted, and quoted fields may hold commas,
+// doubled quotes and line breaks. Lines may end in CRLF.
+//
+// The input is split into byte ranges that are parsed on separate threads.
+// A first pass counts the quotes in each range, which tells each range
+// whether it starts inside a quoted field and so where its first row begins.
+
+//-----------------------------------------------------------------------------
+
+// Names of the columns read from the header row. The defaults are those of
+// the dataserver. The raw text column is required; the others are optional.
+class csv_columns
+{
+public:
+    csv_columns();
+
+public:
+    std::string raw_text;
+    std::string latitude;
+    std::string longitude;
+    std::string elevation;
+};
+
+//-----------------------------------------------------------------------------
+
+// A report with the columns that accompanied it. Columns that are missing or
+// empty, or that do not hold a decimal number, are left unset; the position
+// needs both the latitude and the longitude.
+class csv_observation
+{
+public:
+    typedef std::shared_ptr<csv_observation> pointer;
+    typedef std::unique_ptr<csv_observation> unique_pointer;
+
+    csv_observation(std::string const& rawText);
+
+    csv_observation(csv_observation const& other) = default;
+    csv_observation(csv_observation && other);
+
+    csv_observation& operator= (csv_observation const& rhs) = default;
+    csv_observation& operator= (csv_observation && rhs);
+
+public:
+    metar                     report;
+    util::optional<geo_point> position;
+    util::optional<double>    elevation;    // Station elevation in metres
+};
+
+//-----------------------------------------------------------------------------
+
+// Parses every row with raw text, appending the results in the order of the
+// input. threads is the most threads to use, or 0 for one per hardware
+// thread; small inputs use fewer. Throws aw_exception if there is no header
+// row. Rows with an empty raw text field are skipped.
+void read_csv(const char* data, size_t size, std::vector<csv_observation>& results, unsigned threads = 0, csv_columns const& columns = csv_columns());
+
+// The same for a file, which is mapped rather than read. Throws aw_exception
+// if it cannot be opened.
+void read_csv_file(std::string const& path, std::vector<csv_observation>& results, unsigned threads = 0, csv_columns const& columns = csv_columns());
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -0,0 +1,78 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// Quantities derived from observed values. Temperatures are in degrees
+// Celsius, pressures in hPa, elevations and altitudes in feet and wind speeds
+// in knots.
+
+// Percent, from the Magnus formula over water
+double relative_humidity(double temperature, double dewpoint);
+
+// Station pressure from the altimeter setting and the field elevation
+double station_pressure(double altimeter, double elevation);
+
+// Altitude in the standard atmosphere at the station pressure
+double pressure_altitude(double altimeter, double elevation);
+
+// Altitude in the standard atmosphere with the same air density, for dry air
+double density_altitude(double altimeter, double elevation, double temperature);
+
+// Environment Canada / NWS wind chill index. Returns the temperature above
+// 10 degrees or below 4.8 km/h, where the index is not defined.
+double wind_chill(double temperature, double windSpeed);
+
+// NWS heat index (Rothfusz regression with the NWS adjustments, and the
+// simple formula below 80 degrees Fahrenheit)
+double heat_index(double temperature, double relativeHumidity);
+
+//-----------------------------------------------------------------------------
+
+// Batch kernels over columns of observations, such as one entry per station.
+// Every input must have the same size; results are resized to match. Missing
+// values are NaN and give NaN results. The kernels use SSE2 where available
+// and agree with the scalar functions above to single precision.
+//
+// Throws aw_exception if the input sizes differ.
+
+void relative_humidity(std::vector<float> const& temperature, std::vector<float> const& dewpoint,
+    std::vector<float>& results);
+
+void dewpoint_depression(std::vector<float> const& temperature, std::vector<float> const& dewpoint,
+    std::vector<float>& results);
+
+void pressure_altitude(std::vector<float> const& altimeter, std::vector<float> const& elevation,
+    std::vector<float>& results);
+
+void density_altitude(std::vector<float> const& altimeter, std::vector<float> const& elevation,
+    std::vector<float> const& temperature, std::vector<float>& results);
+
+void wind_chill(std::vector<float> const& temperature, std::vector<float> const& windSpeed,
+    std::vector<float>& results);
+
+void heat_index(std::vector<float> const& temperature, std::vector<float> const& relativeHumidity,
+    std::vector<float>& results);
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
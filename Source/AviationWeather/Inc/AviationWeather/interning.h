@@ -0,0 +1,58 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <AviationWeather/components.h>
+#include <AviationWeather/optional.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// Compact identifiers for interned weather and sky condition groups. A small
+// set of groups (-RA, BR, FEW250, BKN008, ...) covers most reports, so long
+// histories can store these instead of the decoded objects. Identifiers are
+// stable for the lifetime of the process and shared by all threads.
+enum class weather_id : uint16_t {};
+enum class cloud_layer_id : uint16_t {};
+
+//-----------------------------------------------------------------------------
+
+// Returns the identifier for the value, adding it to the table if required.
+// Throws aw_exception if the table is full.
+weather_id     intern(weather const& value);
+cloud_layer_id intern(cloud_layer const& value);
+
+void intern(std::vector<weather> const& values, std::vector<weather_id>& ids);
+void intern(std::vector<cloud_layer> const& values, std::vector<cloud_layer_id>& ids);
+
+// Lock-free lookups; neither function modifies the tables.
+util::optional<weather_id>     find_interned(weather const& value);
+util::optional<cloud_layer_id> find_interned(cloud_layer const& value);
+
+weather const&     resolve(weather_id id);
+cloud_layer const& resolve(cloud_layer_id id);
+
+size_t interned_weather_count();
+size_t interned_cloud_layer_count();
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -0,0 +1,63 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <AviationWeather/metar.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// JSON output of decoded reports, using the field and enumerator names of the
+// test expectation file (Resources/metar.json). Each report is one object on
+// a single line. The raw text is written as "string" and the remarks as their
+// text. Absent groups are left out, and so are fields holding their default:
+// report_modifier none, gust_speed 0, weather intensity moderate, descriptor
+// none, visibility modifiers none, runway designators none, sky condition
+// unit feet, unlimited layer heights, and the cloud type a layer has when
+// none is reported.
+//
+// Nothing is allocated beyond the growth of the output buffer, so reusing a
+// buffer across calls avoids allocation altogether. Text is copied byte for
+// byte apart from escapes, so it must be UTF-8.
+
+//-----------------------------------------------------------------------------
+
+// Appends one report to the buffer, without a trailing newline
+void write_json(metar const& report, std::string& buffer);
+void write_json(metar_view const& report, std::string& buffer);
+
+// Writes one report to a fixed buffer, without a terminating null, and
+// returns its length. The output is complete only if the length is not
+// greater than capacity; otherwise, the buffer holds a truncated report and
+// the call may be repeated with a buffer of the returned length.
+size_t write_json(metar const& report, char* buffer, size_t capacity);
+size_t write_json(metar_view const& report, char* buffer, size_t capacity);
+
+//-----------------------------------------------------------------------------
+
+// Appends the reports as newline-delimited JSON, each followed by '\n'
+void write_json(metar const* reports, size_t count, std::string& buffer);
+void write_json(std::vector<metar> const& reports, std::string& buffer);
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -15,12 +15,16 @@
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include <AviationWeather/components.h>
 #include <AviationWeather/optional.h>
+#include <AviationWeather/quantities.h>
+#include <AviationWeather/string_view.h>
 #include <AviationWeather/types.h>
 
 //-----------------------------------------------------------------------------
@@ -43,6 +47,9 @@ enum class metar_element_type
     sky_condition,
     temperature_dewpoint,
     altimeter,
+    recent_weather,
+    wind_shear,
+    trend,
     remarks
 };
 
@@ -59,6 +66,33 @@ enum class metar_modifier_type
     corrected   // Corrected by someone
 };
 
+enum class rvr_tendency
+{
+    none,
+    upward,     // U
+    downward,   // D
+    no_change   // N
+};
+
+enum class compass_direction
+{
+    north,
+    north_east,
+    east,
+    south_east,
+    south,
+    south_west,
+    west,
+    north_west
+};
+
+enum class metar_trend_type
+{
+    no_significant_change,  // NOSIG
+    becoming,               // BECMG
+    temporary               // TEMPO
+};
+
 //-----------------------------------------------------------------------------
 
 class altimeter
@@ -70,6 +104,12 @@ public:
     altimeter();
     altimeter(double pressure, pressure_unit unit);
 
+    template <pressure_unit Unit>
+    altimeter(aw::pressure<Unit> const& pressure) :
+        unit(Unit),
+        pressure(pressure.value())
+    {}
+
     altimeter(altimeter const& other) = default;
     altimeter(altimeter && other);
 
@@ -85,6 +125,13 @@ public:
     bool operator< (altimeter const& rhs) const;
     bool operator> (altimeter const& rhs) const;
 
+    // Pressure as a quantity in a unit known at compile time
+    template <pressure_unit To>
+    aw::pressure<To> pressure_in() const
+    {
+        return aw::pressure<To>(convert(pressure, unit, To));
+    }
+
 public:
     pressure_unit unit;     // Unit of pressure
     double        pressure; // Pressure in pressure_units
@@ -116,14 +163,107 @@ public:
     runway_designator_type runway_designator;   // Runway designator (L, R, C)
     visibility             visibility_min;      // Minimum visibility
     visibility             visibility_max;      // Maximum visibility
+    rvr_tendency           tendency;            // Past tendency, reported with metric RVR
+};
+
+//-----------------------------------------------------------------------------
+
+// Lowest visibility and its direction when it differs from the prevailing
+// visibility, e.g. 1500SW
+class directional_visibility
+{
+public:
+    typedef std::shared_ptr<directional_visibility> pointer;
+    typedef std::unique_ptr<directional_visibility> unique_pointer;
+
+    directional_visibility();
+
+    directional_visibility(directional_visibility const& other) = default;
+    directional_visibility(directional_visibility && other);
+
+    directional_visibility& operator=(directional_visibility const& rhs) = default;
+    directional_visibility& operator=(directional_visibility && rhs);
+
+    bool operator== (directional_visibility const& rhs) const;
+    bool operator!= (directional_visibility const& rhs) const;
+
+public:
+    visibility        distance;   // Minimum visibility
+    compass_direction direction;  // Direction of the minimum visibility
 };
 
 //-----------------------------------------------------------------------------
 
+// Wind shear in the take-off or approach path, e.g. WS R24L or WS ALL RWY
+class runway_wind_shear
+{
+public:
+    typedef std::shared_ptr<runway_wind_shear> pointer;
+    typedef std::unique_ptr<runway_wind_shear> unique_pointer;
+
+    runway_wind_shear();
+
+    runway_wind_shear(runway_wind_shear const& other) = default;
+    runway_wind_shear(runway_wind_shear && other);
+
+    runway_wind_shear& operator=(runway_wind_shear const& rhs) = default;
+    runway_wind_shear& operator=(runway_wind_shear && rhs);
+
+    bool operator== (runway_wind_shear const& rhs) const;
+    bool operator!= (runway_wind_shear const& rhs) const;
+
+public:
+    bool                   all_runways;         // WS ALL RWY
+    uint8_t                runway_number;       // Runway number, 0 for all runways
+    runway_designator_type runway_designator;   // Runway designator (L, R, C)
+};
+
+//-----------------------------------------------------------------------------
+
+// Trend forecast appended to an ICAO report, e.g. NOSIG or
+// TEMPO FM1230 TL1330 3000 SHRA BKN010CB
+class metar_trend
+{
+public:
+    typedef std::shared_ptr<metar_trend> pointer;
+    typedef std::unique_ptr<metar_trend> unique_pointer;
+
+    metar_trend();
+
+    metar_trend(metar_trend const& other) = default;
+    metar_trend(metar_trend && other);
+
+    metar_trend& operator=(metar_trend const& rhs) = default;
+    metar_trend& operator=(metar_trend && rhs);
+
+    bool operator== (metar_trend const& rhs) const;
+    bool operator!= (metar_trend const& rhs) const;
+
+public:
+    metar_trend_type           type;
+    util::optional<time>       from;                    // FMhhmm, on the observation day
+    util::optional<time>       until;                   // TLhhmm
+    util::optional<time>       at;                      // AThhmm
+    util::optional<wind>       wind_group;
+    util::optional<visibility> visibility_group;
+    std::vector<weather>       weather_group;
+    bool                       no_significant_weather;  // NSW, the weather ends
+    std::vector<cloud_layer>   sky_condition_group;
+};
+
+//-----------------------------------------------------------------------------
+
+class binary_reader;
+class metar_view;
+
 class metar
 {
+    friend class binary_reader;
+    friend class metar_view;
+
 public:
     typedef std::shared_ptr<metar> pointer;
+    typedef std::shared_ptr<const metar> const_pointer;
     typedef std::unique_ptr<metar> unique_pointer;
 
     metar(std::string const& metar);
@@ -142,27 +282,145 @@ public:
     flight_category flight_category() const;
     int16_t temperature_dewpoint_spread() const;
 
+    // Derived quantities (see derived_quantities.h), in degrees Celsius and
+    // feet. Throw aw_exception if the report lacks the groups they need.
+    double relative_humidity() const;
+    double pressure_altitude(double elevation) const;
+    double density_altitude(double elevation) const;
+    double wind_chill() const;
+    double heat_index() const;
+
+    // 64-bit fingerprint of the decoded report, computed once when parsing.
+    // Reports that compare equal have the same fingerprint; like operator==,
+    // it does not depend on raw_data. It is not updated if the public fields
+    // are modified after construction.
+    uint64_t content_hash() const;
+
 private:
+    metar();
+
     void parse();
+    void update_content_hash();
     cloud_layer ceiling_nothrow() const;
 
 public:
-    std::string                      raw_data;
-    metar_report_type                type;
-    station_identifier               identifier;
-    time                             observation_time;
-    metar_modifier_type              modifier;
-    util::optional<wind>             wind_group;
-    util::optional<visibility>       visibility_group;
-    std::vector<runway_visual_range> runway_visual_range_group;
-    std::vector<weather>             weather_group;
-    std::vector<cloud_layer>         sky_condition_group;
-    util::optional<int8_t>           temperature;
-    util::optional<int8_t>           dewpoint;
-    util::optional<altimeter>        altimeter_group;
-    std::string                      remarks;
+    std::string                            raw_data;
+    metar_report_type                      type;
+    station_identifier                     identifier;
+    time                                   observation_time;
+    metar_modifier_type                    modifier;
+    util::optional<wind>                   wind_group;
+    util::optional<visibility>             visibility_group;
+    util::optional<directional_visibility> minimum_visibility_group;
+    std::vector<runway_visual_range>       runway_visual_range_group;
+    std::vector<weather>                   weather_group;
+    std::vector<cloud_layer>               sky_condition_group;
+    util::optional<int8_t>                 temperature;
+    util::optional<int8_t>                 dewpoint;
+    util::optional<altimeter>              altimeter_group;
+    std::vector<weather>                   recent_weather_group;
+    std::vector<runway_wind_shear>         wind_shear_group;
+    std::vector<metar_trend>               trend_group;
+    std::string                            remarks;
+
+private:
+    uint64_t                               m_contentHash;
+};
+
+//-----------------------------------------------------------------------------
+
+// Non-owning counterpart of metar. The text fields refer directly into the
+// buffer the view was parsed from, which must outlive the view. Use to_owned()
+// when the report needs to outlive the buffer.
+class metar_view
+{
+    friend class binary_reader;
+
+public:
+    typedef std::shared_ptr<metar_view> pointer;
+    typedef std::unique_ptr<metar_view> unique_pointer;
+
+    metar_view(util::string_view const& metar);
+
+    metar_view(metar_view const& other) = default;
+    metar_view(metar_view && other);
+
+    metar_view& operator= (metar_view const& rhs) = default;
+    metar_view& operator= (metar_view && rhs);
+
+    bool operator== (metar_view const& rhs) const;
+    bool operator!= (metar_view const& rhs) const;
+
+    cloud_layer ceiling() const;
+
+    flight_category flight_category() const;
+    int16_t temperature_dewpoint_spread() const;
+
+    // Derived quantities (see derived_quantities.h), in degrees Celsius and
+    // feet. Throw aw_exception if the report lacks the groups they need.
+    double relative_humidity() const;
+    double pressure_altitude(double elevation) const;
+    double density_altitude(double elevation) const;
+    double wind_chill() const;
+    double heat_index() const;
+
+    // Same fingerprint as metar::content_hash() for the equivalent report
+    uint64_t content_hash() const;
+
+    metar to_owned() const;
+
+private:
+    void update_content_hash();
+
+public:
+    util::string_view                      raw_data;
+    metar_report_type                      type;
+    util::string_view                      identifier;
+    time                                   observation_time;
+    metar_modifier_type                    modifier;
+    util::optional<wind>                   wind_group;
+    util::optional<visibility>             visibility_group;
+    util::optional<directional_visibility> minimum_visibility_group;
+    std::vector<runway_visual_range>       runway_visual_range_group;
+    std::vector<weather>                   weather_group;
+    std::vector<cloud_layer>               sky_condition_group;
+    util::optional<int8_t>                 temperature;
+    util::optional<int8_t>                 dewpoint;
+    util::optional<altimeter>              altimeter_group;
+    std::vector<weather>                   recent_weather_group;
+    std::vector<runway_wind_shear>         wind_shear_group;
+    std::vector<metar_trend>               trend_group;
+    util::string_view                      remarks;
+
+private:
+    uint64_t                               m_contentHash;
 };
 
 //-----------------------------------------------------------------------------
 
 } // namespace aw
+
+//-----------------------------------------------------------------------------
+
+namespace std
+{
+
+template <>
+struct hash<aw::metar>
+{
+    size_t operator()(aw::metar const& value) const
+    {
+        return static_cast<size_t>(value.content_hash());
+    }
+};
+
+template <>
+struct hash<aw::metar_view>
+{
+    size_t operator()(aw::metar_view const& value) const
+    {
+        return static_cast<size_t>(value.content_hash());
+    }
+};
+
+} // namespace std
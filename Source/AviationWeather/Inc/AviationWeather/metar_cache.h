@@ -0,0 +1,82 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <AviationWeather/metar.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+struct metar_cache_statistics
+{
+    uint64_t hits;          // Reports returned without parsing
+    uint64_t misses;        // Reports that had to be parsed
+    uint64_t insertions;    // Parsed reports added to the cache
+    uint64_t evictions;     // Reports evicted to stay within the memory limit
+    size_t   entries;       // Reports currently cached
+    size_t   bytes;         // Approximate memory used by the cached reports
+};
+
+//-----------------------------------------------------------------------------
+
+// Bounded LRU cache in front of the metar constructor for feeds that deliver
+// the same report text many times. Reports are keyed on a hash of the raw
+// text and shared as immutable objects. The cache is split into independently
+// locked shards so that concurrent parsing threads rarely contend; the memory
+// limit is divided evenly between the shards.
+class metar_cache
+{
+public:
+    static const size_t default_shard_count = 16;
+
+    metar_cache(size_t memoryLimit, size_t shardCount = default_shard_count);
+    ~metar_cache();
+
+    metar_cache(metar_cache const&) = delete;
+    metar_cache& operator= (metar_cache const&) = delete;
+
+    // Returns the cached report for the text, parsing and caching it if it
+    // has not been seen or has been evicted.
+    metar::const_pointer parse(std::string const& metar);
+
+    // Returns the cached report for the text without parsing, or nullptr
+    metar::const_pointer find(std::string const& metar);
+
+    void clear();
+
+    size_t memory_limit() const;
+    metar_cache_statistics statistics() const;
+
+private:
+    struct shard;
+
+    shard& shard_for(uint64_t hash) const;
+
+private:
+    size_t                              m_memoryLimit;
+    std::vector<std::unique_ptr<shard>> m_shards;
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -0,0 +1,100 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <AviationWeather/metar.h>
+#include <AviationWeather/optional.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+template <class T>
+struct value_change
+{
+    T before;
+    T after;
+};
+
+//-----------------------------------------------------------------------------
+
+inline uint16_t element_mask(metar_element_type element)
+{
+    return static_cast<uint16_t>(1u << static_cast<unsigned>(element));
+}
+
+//-----------------------------------------------------------------------------
+
+// Changes between two reports for the same station. Each changed element sets
+// its bit in the mask and carries its before and after values; unchanged
+// elements are left empty, so a diff with no changes holds no allocations.
+// The temperature_dewpoint bit covers both temperature and dewpoint, and the
+// visibility bit covers the directional minimum visibility as well.
+class metar_diff
+{
+public:
+    typedef std::shared_ptr<metar_diff> pointer;
+    typedef std::unique_ptr<metar_diff> unique_pointer;
+
+    metar_diff();
+
+    metar_diff(metar_diff const& other) = default;
+    metar_diff(metar_diff && other);
+
+    metar_diff& operator= (metar_diff const& rhs) = default;
+    metar_diff& operator= (metar_diff && rhs);
+
+    bool empty() const;
+    bool changed(metar_element_type element) const;
+
+public:
+    uint16_t                                                       mask;
+    util::optional<value_change<metar_report_type>>                type;
+    util::optional<value_change<station_identifier>>               identifier;
+    util::optional<value_change<time>>                             observation_time;
+    util::optional<value_change<metar_modifier_type>>              modifier;
+    util::optional<value_change<util::optional<wind>>>             wind_group;
+    util::optional<value_change<util::optional<visibility>>>       visibility_group;
+    util::optional<value_change<util::optional<directional_visibility>>> minimum_visibility_group;
+    util::optional<value_change<std::vector<runway_visual_range>>> runway_visual_range_group;
+    util::optional<value_change<std::vector<weather>>>             weather_group;
+    util::optional<value_change<std::vector<cloud_layer>>>         sky_condition_group;
+    util::optional<value_change<util::optional<int8_t>>>           temperature;
+    util::optional<value_change<util::optional<int8_t>>>           dewpoint;
+    util::optional<value_change<util::optional<altimeter>>>        altimeter_group;
+    util::optional<value_change<std::vector<weather>>>             recent_weather_group;
+    util::optional<value_change<std::vector<runway_wind_shear>>>   wind_shear_group;
+    util::optional<value_change<std::vector<metar_trend>>>         trend_group;
+    util::optional<value_change<std::string>>                      remarks;
+};
+
+//-----------------------------------------------------------------------------
+
+// Compares the elements of two reports using the same element comparisons as
+// metar::operator==. Reports with the same content_hash() are taken to be
+// unchanged without comparing their elements, so changes made to the public
+// fields after construction are only seen if the hashes differ.
+metar_diff diff(metar const& before, metar const& after);
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
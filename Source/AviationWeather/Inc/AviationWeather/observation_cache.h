@@ -0,0 +1,99 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <AviationWeather/metar.h>
+#include <AviationWeather/string_view.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// True if the report should replace the current report for its station.
+// Later observation times win. A report for the same minute replaces the
+// current one only if it is a correction (COR) with different text, so
+// repeated deliveries are ignored. SPECI reports are ordered by time like
+// routine reports.
+bool supersedes(metar const& report, metar const& current);
+
+//-----------------------------------------------------------------------------
+
+// Latest report per station, for services that publish current conditions.
+// Lookups never lock or wait: readers announce themselves in an epoch
+// counter, follow atomic pointers to immutable entries and copy out a shared
+// pointer to the report. Writers serialise on a mutex, publish replacement
+// entries atomically and free the entries they replace once every reader
+// that could still see them has finished.
+class observation_cache
+{
+public:
+    static const size_t default_capacity = 1024;
+
+    explicit observation_cache(size_t capacity = default_capacity);
+    ~observation_cache();
+
+    observation_cache(observation_cache const&) = delete;
+    observation_cache& operator= (observation_cache const&) = delete;
+
+    // Offers a report to the cache. Returns true if it became the current
+    // report for its station.
+    bool update(metar::const_pointer const& report);
+    bool update(metar const& report);
+
+    // Offers a burst of reports under a single acquisition of the writer
+    // lock. Returns the number that became current.
+    size_t update(std::vector<metar::const_pointer> const& reports);
+
+    // Current report for the station, or nullptr. Lock-free.
+    metar::const_pointer find(util::string_view identifier) const;
+
+    // Current reports for every station, in no particular order. Lock-free.
+    std::vector<metar::const_pointer> snapshot() const;
+
+    void clear();
+
+    size_t size() const;
+
+private:
+    struct entry;
+    struct table;
+    struct reader_slot;
+    struct retired_list;
+    class read_guard;
+
+    bool update_nolock(metar::const_pointer const& report);
+    void reclaim_nolock();
+
+private:
+    std::atomic<table*>            m_table;
+    std::atomic<uint64_t>          m_epoch;
+    std::atomic<size_t>            m_size;
+    std::unique_ptr<reader_slot[]> m_readers;
+    std::unique_ptr<retired_list>  m_retired[2];
+    std::mutex                     m_mutex;
+    size_t                         m_initialCapacity;
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
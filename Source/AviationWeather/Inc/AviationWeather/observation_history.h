@@ -0,0 +1,171 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <AviationWeather/metar.h>
+#include <AviationWeather/optional.h>
+#include <AviationWeather/string_view.h>
+#include <AviationWeather/types.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// Fixed-size summary of a report for long histories, in fixed units. Missing
+// groups are stored as sentinel values rather than optionals so that a record
+// is 20 bytes; use the accessors to read them.
+struct observation_record
+{
+    uint32_t epoch_minute;      // Minutes since 1970-01-01 00:00 UTC
+    int16_t  altimeter_tenths;  // Tenths of hPa, INT16_MIN if missing
+    int8_t   temperature;       // Degrees Celsius, INT8_MIN if missing
+    int8_t   dewpoint;          // Degrees Celsius, INT8_MIN if missing
+    uint8_t  wind_speed;        // Knots
+    uint8_t  gust_speed;        // Knots, 0 if there are no gusts
+    uint16_t wind_direction;    // Degrees, UINT16_MAX if variable or missing
+    uint16_t visibility;        // Metres, UINT16_MAX if missing
+    uint16_t ceiling;           // Hundreds of feet, UINT16_MAX if unlimited
+    uint8_t  category;          // flight_category
+    uint8_t  flags;             // special and corrected flags
+    uint16_t reserved;          // Zero
+
+    static const uint8_t special_flag = 1;
+    static const uint8_t corrected_flag = 2;
+    static const uint8_t wind_flag = 4;
+
+    time observation_time() const;
+    flight_category flight_category() const;
+
+    util::optional<double>  altimeter() const;  // hPa
+    util::optional<int8_t>  temperature_celsius() const;
+    util::optional<int8_t>  dewpoint_celsius() const;
+    util::optional<uint8_t> wind_speed_knots() const;
+    util::optional<double>  visibility_metres() const;
+};
+
+//-----------------------------------------------------------------------------
+
+// Recent observations for many stations, in one contiguous block of fixed-size
+// ring buffers. Each station holds at most capacity records and nothing older
+// than the retention period before its latest report; appending is O(1) and
+// scans walk at most two contiguous runs of records.
+//
+// Reports must arrive in time order per station. A report older than the
+// latest one is ignored, and one for the same minute replaces the latest only
+// if it is a correction (see supersedes() in observation_cache.h).
+//
+// Reports carry the day of the month but not the month. A station's first
+// report is placed in the month closest to the time it was received, and
+// later ones in the month closest to the station's latest report, so that
+// the months in between are counted at their real length.
+class observation_snapshot;
+
+class observation_history
+{
+    friend class observation_snapshot;
+
+public:
+    typedef std::shared_ptr<observation_history> pointer;
+    typedef std::unique_ptr<observation_history> unique_pointer;
+
+    static const uint32_t default_hours = 24;
+    static const uint32_t default_capacity = 48;
+
+    observation_history(uint32_t hours = default_hours, uint32_t capacity = default_capacity);
+
+    observation_history(observation_history const& other) = default;
+    observation_history(observation_history && other);
+
+    observation_history& operator= (observation_history const& rhs) = default;
+    observation_history& operator= (observation_history && rhs);
+
+    // Returns true if the report was recorded. The report was received at the
+    // given time, or now.
+    bool append(metar const& report);
+    bool append(metar_view const& report);
+    bool append(metar const& report, std::time_t received);
+    bool append(metar_view const& report, std::time_t received);
+
+    uint32_t hours() const;
+    uint32_t capacity() const;
+    size_t station_count() const;
+
+    // Records held for the station
+    size_t size(util::string_view identifier) const;
+
+    // The latest report and the one before it, or nullptr. The pointers are
+    // invalidated by the next append.
+    observation_record const* latest(util::string_view identifier) const;
+    observation_record const* previous(util::string_view identifier) const;
+
+    // Records from the given number of hours before the latest report up to
+    // and including it, oldest first. Results are cleared first.
+    void last_hours(util::string_view identifier, uint32_t hours, std::vector<observation_record>& results) const;
+
+    // Records observed within [from, to], oldest first
+    void range(util::string_view identifier, time const& from, time const& to, std::vector<observation_record>& results) const;
+
+    // Change from the report closest to the given number of hours before the
+    // latest, within half an hour, to the latest: hPa for pressure and
+    // degrees Celsius for temperature. Empty if either report is missing or
+    // lacks the group.
+    util::optional<double> pressure_tendency(util::string_view identifier, uint32_t hours = 3) const;
+    util::optional<double> temperature_change(util::string_view identifier, uint32_t hours = 3) const;
+
+private:
+    struct ring
+    {
+        uint32_t head;  // Index of the next record to write
+        uint32_t count;
+    };
+
+    class ring_view;
+
+    static const size_t npos = static_cast<size_t>(-1);
+
+    bool append(std::string const& identifier, time const& observed, std::time_t received, observation_record record);
+
+    // Station index, or npos
+    size_t find(util::string_view identifier) const;
+    size_t find_slot(util::string_view identifier) const;
+    void rehash(size_t slotCount);
+
+    // Index 0 is the oldest record held for the station
+    ring_view records(size_t station) const;
+    observation_record const& at(size_t station, uint32_t index) const;
+
+    // Records between the given numbers of minutes before the latest report
+    void collect(size_t station, int32_t minimumAge, int32_t maximumAge, std::vector<observation_record>& results) const;
+
+private:
+    uint32_t                                  m_hours;
+    uint32_t                                  m_capacity;
+    std::vector<observation_record>           m_records;  // capacity records per station
+    std::vector<ring>                         m_rings;
+    std::vector<std::string>                  m_identifiers;  // One per ring
+    std::vector<uint32_t>                     m_slots;        // Open-addressed index of station + 1, 0 if empty
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
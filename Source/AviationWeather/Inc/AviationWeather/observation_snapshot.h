@@ -0,0 +1,117 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <AviationWeather/components.h>
+#include <AviationWeather/observation_history.h>
+#include <AviationWeather/optional.h>
+#include <AviationWeather/string_view.h>
+
+namespace aw
+{
+namespace detail
+{
+class mapped_file;
+}
+
+//-----------------------------------------------------------------------------
+
+// Read-only image of an observation_history that is queried where it lies,
+// so a restarted process can map the file written by its predecessor and
+// answer immediately. The image holds no pointers, only offsets from its
+// start: a header, the stations sorted by identifier, a hashed index of them,
+// then each station's records oldest first in one contiguous block. Opening
+// checks the header; nothing is decoded or copied.
+//
+// Images use the byte order of the machine that wrote them and are rejected
+// by readers with the other order. Station identifiers are limited to eight
+// characters.
+class observation_snapshot
+{
+public:
+    typedef std::shared_ptr<observation_snapshot> pointer;
+    typedef std::unique_ptr<observation_snapshot> unique_pointer;
+
+    // Version 1 images held the minute of the month in each record and are
+    // no longer read
+    static const uint32_t format_version = 2;
+
+    // Writes an image of the history, replacing the contents of the buffer
+    // or file. Throws aw_exception if a station identifier is too long or the
+    // file cannot be written.
+    static void write(observation_history const& history, std::vector<uint8_t>& buffer);
+    static void write(observation_history const& history, std::string const& path);
+
+    // Queries an image in memory, which must outlive the snapshot and be
+    // aligned to eight bytes
+    observation_snapshot(uint8_t const* data, size_t size);
+
+    // Maps the image in the file, which is unmapped when the last copy of the
+    // snapshot is destroyed
+    explicit observation_snapshot(std::string const& path);
+
+    observation_snapshot(observation_snapshot const& other) = default;
+    observation_snapshot(observation_snapshot && other);
+
+    observation_snapshot& operator= (observation_snapshot const& rhs) = default;
+    observation_snapshot& operator= (observation_snapshot && rhs);
+
+    uint32_t hours() const;
+    size_t station_count() const;
+    size_t record_count() const;
+
+    // Identifier of the station at the given index, in sorted order
+    util::string_view identifier(size_t station) const;
+
+    // The station's records, oldest first, or nullptr if it has none. The
+    // records point into the image.
+    observation_record const* records(util::string_view identifier, size_t& count) const;
+
+    // The same queries as observation_history
+    size_t size(util::string_view identifier) const;
+    observation_record const* latest(util::string_view identifier) const;
+    observation_record const* previous(util::string_view identifier) const;
+    void last_hours(util::string_view identifier, uint32_t hours, std::vector<observation_record>& results) const;
+    void range(util::string_view identifier, time const& from, time const& to, std::vector<observation_record>& results) const;
+    util::optional<double> pressure_tendency(util::string_view identifier, uint32_t hours = 3) const;
+    util::optional<double> temperature_change(util::string_view identifier, uint32_t hours = 3) const;
+
+private:
+    class block_view;
+    struct header;
+    struct station_entry;
+
+    void open(uint8_t const* data, size_t size);
+
+    block_view find(util::string_view identifier) const;
+    void collect(block_view const& block, int32_t minimumAge, int32_t maximumAge, std::vector<observation_record>& results) const;
+
+private:
+    std::shared_ptr<detail::mapped_file> m_file;
+    header const*                        m_header;
+    station_entry const*                 m_stations;  // Sorted by identifier
+    uint32_t const*                      m_slots;     // Hashed index of the stations
+    observation_record const*            m_records;
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -0,0 +1,245 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <AviationWeather/components.h>
+#include <AviationWeather/optional.h>
+#include <AviationWeather/string_view.h>
+#include <AviationWeather/types.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+enum class pirep_type
+{
+    routine, // UA
+    urgent   // UUA
+};
+
+enum class turbulence_intensity
+{
+    none,     // NEG, SMTH
+    light,    // LGT
+    moderate, // MOD
+    severe,   // SEV
+    extreme   // EXTRM
+};
+
+enum class turbulence_type
+{
+    unspecified,
+    clear_air,  // CAT
+    chop        // CHOP
+};
+
+enum class turbulence_frequency
+{
+    unspecified,
+    occasional,   // OCNL
+    intermittent, // INTMT
+    continuous    // CONS
+};
+
+enum class icing_intensity
+{
+    none,     // NEG
+    trace,    // TRACE
+    light,    // LGT
+    moderate, // MOD
+    severe    // SEV
+};
+
+enum class icing_type
+{
+    unspecified,
+    rime,   // RIME
+    clear,  // CLR
+    mixed   // MX
+};
+
+//-----------------------------------------------------------------------------
+
+class turbulence
+{
+public:
+    typedef std::shared_ptr<turbulence> pointer;
+    typedef std::unique_ptr<turbulence> unique_pointer;
+
+    turbulence();
+
+    turbulence(turbulence const& other) = default;
+    turbulence(turbulence && other);
+
+    turbulence& operator= (turbulence const& rhs) = default;
+    turbulence& operator= (turbulence && rhs);
+
+    bool operator== (turbulence const& rhs) const;
+    bool operator!= (turbulence const& rhs) const;
+
+public:
+    turbulence_intensity     lower;     // Equal to upper unless a range such as LGT-MOD was reported
+    turbulence_intensity     upper;
+    turbulence_type          type;
+    turbulence_frequency     frequency;
+    util::optional<uint32_t> base;      // Feet
+    util::optional<uint32_t> top;       // Feet
+};
+
+//-----------------------------------------------------------------------------
+
+class icing
+{
+public:
+    typedef std::shared_ptr<icing> pointer;
+    typedef std::unique_ptr<icing> unique_pointer;
+
+    icing();
+
+    icing(icing const& other) = default;
+    icing(icing && other);
+
+    icing& operator= (icing const& rhs) = default;
+    icing& operator= (icing && rhs);
+
+    bool operator== (icing const& rhs) const;
+    bool operator!= (icing const& rhs) const;
+
+public:
+    icing_intensity          lower;     // Equal to upper unless a range such as LGT-MOD was reported
+    icing_intensity          upper;
+    icing_type               type;
+    util::optional<uint32_t> base;      // Feet
+    util::optional<uint32_t> top;       // Feet
+};
+
+//-----------------------------------------------------------------------------
+
+// Offset and length of a field within the text a record was decoded from
+struct text_span
+{
+    uint32_t offset;
+    uint32_t length;
+};
+
+inline util::string_view span_text(util::string_view const& source, text_span const& span)
+{
+    return source.substr(span.offset, span.length);
+}
+
+// A weather group without the phenomena vector of aw::weather
+struct compact_weather
+{
+    static const size_t max_phenomena = 3;
+
+    weather_intensity  intensity;
+    weather_descriptor descriptor;
+    uint8_t            phenomena_count;
+    weather_phenomena  phenomena[max_phenomena];
+
+    weather to_weather() const;
+};
+
+// Fixed-size decoded PIREP for batch decoding. Text fields refer back into
+// the decoded bulletin, and the repeating groups are held in fixed arrays,
+// so a vector of records needs no allocation per report.
+struct pirep_record
+{
+    static const size_t max_sky_layers = 3;
+    static const size_t max_weather = 3;
+
+    text_span                  raw;
+    pirep_type                 type;
+    text_span                  identifier;          // Reporting station, empty if not given
+    text_span                  location;            // OV
+    util::optional<time>       observation_time;    // TM, day_of_month is 0
+    util::optional<uint32_t>   altitude;            // FL, in feet
+    text_span                  aircraft_type;       // TP
+    uint8_t                    sky_condition_count; // SK
+    cloud_layer                sky_condition_group[max_sky_layers];
+    uint32_t                   cloud_tops[max_sky_layers]; // UINT32_MAX if not reported
+    util::optional<visibility> flight_visibility;   // WX FVxxSM
+    uint8_t                    weather_count;       // WX
+    compact_weather            weather_group[max_weather];
+    util::optional<int8_t>     temperature;         // TA
+    util::optional<wind>       wind_group;          // WV
+    util::optional<turbulence> turbulence_group;    // TB
+    util::optional<icing>      icing_group;         // IC
+    text_span                  remarks;             // RM
+
+    pirep_record();
+};
+
+// Decodes every UA and UUA report in a bulletin in one pass. Reports start
+// on a line containing UA or UUA, optionally after the station, and continue
+// over any following lines that do not. The records are overwritten in
+// place and refer into the bulletin, which must outlive them. Groups beyond
+// the fixed array sizes are dropped. Returns the number of reports decoded.
+size_t decode_pireps(util::string_view const& bulletin, std::vector<pirep_record>& records);
+
+//-----------------------------------------------------------------------------
+
+// Pilot weather report (PIREP) with owned fields, for individual reports
+class pirep
+{
+public:
+    typedef std::shared_ptr<pirep> pointer;
+    typedef std::unique_ptr<pirep> unique_pointer;
+
+    pirep();
+    pirep(std::string const& pirep);
+    pirep(pirep_record const& record, util::string_view const& source);
+
+    pirep(pirep const& other) = default;
+    pirep(pirep && other);
+
+    pirep& operator= (pirep const& rhs) = default;
+    pirep& operator= (pirep && rhs);
+
+    bool operator== (pirep const& rhs) const;
+    bool operator!= (pirep const& rhs) const;
+
+public:
+    std::string                raw_data;
+    pirep_type                 type;
+    station_identifier         identifier;
+    std::string                location;
+    util::optional<time>       observation_time;
+    util::optional<uint32_t>   altitude;
+    std::string                aircraft_type;
+    std::vector<cloud_layer>   sky_condition_group;
+    std::vector<uint32_t>      cloud_tops;          // One per layer, UINT32_MAX if not reported
+    util::optional<visibility> flight_visibility;
+    std::vector<weather>       weather_group;
+    util::optional<int8_t>     temperature;
+    util::optional<wind>       wind_group;
+    util::optional<turbulence> turbulence_group;
+    util::optional<icing>      icing_group;
+    std::string                remarks;
+
+private:
+    void assign(pirep_record const& record, util::string_view const& source);
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -0,0 +1,186 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cmath>
+#include <limits>
+
+#include <AviationWeather/converters.h>
+#include <AviationWeather/types.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// Units as constants so quantities read naturally, e.g. length<units::feet>
+namespace units
+{
+
+constexpr distance_unit feet = distance_unit::feet;
+constexpr distance_unit metres = distance_unit::metres;
+constexpr distance_unit statute_miles = distance_unit::statute_miles;
+constexpr distance_unit nautical_miles = distance_unit::nautical_miles;
+
+constexpr pressure_unit hPa = pressure_unit::hPa;
+constexpr pressure_unit inHg = pressure_unit::inHg;
+
+constexpr speed_unit kt = speed_unit::kt;
+constexpr speed_unit mph = speed_unit::mph;
+constexpr speed_unit mps = speed_unit::mps;
+
+} // namespace units
+
+//-----------------------------------------------------------------------------
+
+// A value whose unit is part of its type. Conversion between units of the
+// same kind is implicit and costs at most one multiply by a constant ratio,
+// so mixed-unit arithmetic and comparisons need no runtime unit lookups.
+template <class TUnit, TUnit Unit>
+class quantity
+{
+public:
+    typedef TUnit unit_type;
+
+    constexpr quantity() : m_value(0.0) {}
+    constexpr explicit quantity(double value) : m_value(value) {}
+
+    template <TUnit From>
+    constexpr quantity(quantity<TUnit, From> const& other) :
+        m_value(other.value() * unit_ratio<TUnit, From, Unit>::value)
+    {}
+
+    quantity(quantity const& other) = default;
+    quantity& operator= (quantity const& rhs) = default;
+
+    static constexpr TUnit unit() { return Unit; }
+    constexpr double value() const { return m_value; }
+
+    template <TUnit To>
+    constexpr quantity<TUnit, To> in() const
+    {
+        return quantity<TUnit, To>(*this);
+    }
+
+    // Equal within the same relative tolerance as the runtime-unit components
+    template <TUnit Other>
+    bool operator== (quantity<TUnit, Other> const& rhs) const
+    {
+        auto l = m_value;
+        auto r = quantity(rhs).m_value;
+        auto L = std::abs(l);
+        auto R = std::abs(r);
+
+        return std::abs(l - r) <= ((L < R ? R : L) * std::numeric_limits<double>::epsilon());
+    }
+
+    template <TUnit Other>
+    bool operator!= (quantity<TUnit, Other> const& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    template <TUnit Other>
+    bool operator< (quantity<TUnit, Other> const& rhs) const
+    {
+        return m_value < quantity(rhs).m_value;
+    }
+
+    template <TUnit Other>
+    bool operator> (quantity<TUnit, Other> const& rhs) const
+    {
+        return m_value > quantity(rhs).m_value;
+    }
+
+    template <TUnit Other>
+    bool operator<= (quantity<TUnit, Other> const& rhs) const
+    {
+        return !(*this > rhs);
+    }
+
+    template <TUnit Other>
+    bool operator>= (quantity<TUnit, Other> const& rhs) const
+    {
+        return !(*this < rhs);
+    }
+
+    constexpr quantity operator- () const
+    {
+        return quantity(-m_value);
+    }
+
+    template <TUnit Other>
+    constexpr quantity operator+ (quantity<TUnit, Other> const& rhs) const
+    {
+        return quantity(m_value + quantity(rhs).m_value);
+    }
+
+    template <TUnit Other>
+    constexpr quantity operator- (quantity<TUnit, Other> const& rhs) const
+    {
+        return quantity(m_value - quantity(rhs).m_value);
+    }
+
+    constexpr quantity operator* (double scale) const
+    {
+        return quantity(m_value * scale);
+    }
+
+    constexpr quantity operator/ (double scale) const
+    {
+        return quantity(m_value / scale);
+    }
+
+    template <TUnit Other>
+    quantity& operator+= (quantity<TUnit, Other> const& rhs)
+    {
+        m_value += quantity(rhs).m_value;
+        return *this;
+    }
+
+    template <TUnit Other>
+    quantity& operator-= (quantity<TUnit, Other> const& rhs)
+    {
+        m_value -= quantity(rhs).m_value;
+        return *this;
+    }
+
+private:
+    double m_value;
+};
+
+//-----------------------------------------------------------------------------
+
+template <class TUnit, TUnit Unit>
+constexpr quantity<TUnit, Unit> operator* (double scale, quantity<TUnit, Unit> const& rhs)
+{
+    return rhs * scale;
+}
+
+//-----------------------------------------------------------------------------
+
+template <distance_unit Unit>
+using length = quantity<distance_unit, Unit>;
+
+template <pressure_unit Unit>
+using pressure = quantity<pressure_unit, Unit>;
+
+template <speed_unit Unit>
+using speed = quantity<speed_unit, Unit>;
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -0,0 +1,168 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <AviationWeather/metar.h>
+#include <AviationWeather/optional.h>
+#include <AviationWeather/string_view.h>
+#include <AviationWeather/types.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+enum class automated_station_type
+{
+    none,
+    without_precipitation_discriminator, // AO1
+    with_precipitation_discriminator     // AO2
+};
+
+//-----------------------------------------------------------------------------
+
+struct remark_time
+{
+    util::optional<uint8_t> hour;   // Omitted when within the hour of the observation
+    uint8_t                 minute;
+};
+
+struct peak_wind
+{
+    uint16_t    direction; // Degrees true
+    uint16_t    speed;     // Knots
+    remark_time time;
+};
+
+struct wind_shift
+{
+    remark_time time;
+    bool        frontal_passage;
+};
+
+struct weather_event
+{
+    weather_intensity           intensity;
+    weather_descriptor          descriptor;
+    weather_phenomena           phenomenon;
+    util::optional<remark_time> begin;
+    util::optional<remark_time> end;
+};
+
+//-----------------------------------------------------------------------------
+
+// Typed view over the common US remark groups of a METAR. The remarks text is
+// not examined until the first accessor is called, at which point every group
+// is decoded in a single pass over its tokens; consumers that never look at
+// remarks pay nothing. The text is not copied and must outlive the object.
+// Like the rest of the library, const access is safe from several threads at
+// once; the first accessor decodes and the others wait for it.
+class metar_remarks
+{
+public:
+    typedef std::shared_ptr<metar_remarks> pointer;
+    typedef std::unique_ptr<metar_remarks> unique_pointer;
+
+    explicit metar_remarks(util::string_view const& remarks);
+    explicit metar_remarks(metar const& report);
+    explicit metar_remarks(metar_view const& report);
+
+    metar_remarks(metar_remarks const& other);
+    metar_remarks(metar_remarks && other);
+
+    metar_remarks& operator= (metar_remarks const& rhs);
+    metar_remarks& operator= (metar_remarks && rhs);
+
+    automated_station_type automated_station() const;
+
+    util::optional<double> sea_level_pressure() const;          // SLPppp, hPa
+    util::optional<double> precise_temperature() const;         // Tsnnnsnnn, degrees Celsius
+    util::optional<double> precise_dewpoint() const;            // Tsnnnsnnn, degrees Celsius
+
+    util::optional<double> hourly_precipitation() const;        // Prrrr, inches
+    util::optional<double> period_precipitation() const;        // 6rrrr, 3 or 6 hour, inches
+    util::optional<double> daily_precipitation() const;         // 7rrrr, 24 hour, inches
+
+    util::optional<double> maximum_temperature_6_hour() const;  // 1snnn, degrees Celsius
+    util::optional<double> minimum_temperature_6_hour() const;  // 2snnn, degrees Celsius
+    util::optional<double> maximum_temperature_24_hour() const; // 4snnnsnnn, degrees Celsius
+    util::optional<double> minimum_temperature_24_hour() const; // 4snnnsnnn, degrees Celsius
+
+    util::optional<peak_wind> peak_wind_group() const;          // PK WND dddff/hhmm
+    util::optional<wind_shift> wind_shift_group() const;        // WSHFT hhmm [FROPA]
+
+    std::vector<weather_event> const& weather_events() const;   // e.g. RAB05E30SNB30
+
+    bool lightning_detector_not_operating() const;              // TSNO
+    bool precipitation_identifier_not_operating() const;        // PWINO
+    bool maintenance_required() const;                          // $
+
+    // Tokens that are not one of the groups above
+    std::vector<util::string_view> const& unparsed() const;
+
+private:
+    enum decode_state : uint8_t
+    {
+        state_pending,
+        state_decoding,
+        state_decoded
+    };
+
+    struct decoded_groups;
+
+    void decode() const;
+    static void decode_groups(util::string_view const& text, decoded_groups& groups);
+
+private:
+    struct decoded_groups
+    {
+        decoded_groups();
+
+        automated_station_type         automated_station;
+        util::optional<double>         sea_level_pressure;
+        util::optional<double>         precise_temperature;
+        util::optional<double>         precise_dewpoint;
+        util::optional<double>         hourly_precipitation;
+        util::optional<double>         period_precipitation;
+        util::optional<double>         daily_precipitation;
+        util::optional<double>         maximum_temperature_6_hour;
+        util::optional<double>         minimum_temperature_6_hour;
+        util::optional<double>         maximum_temperature_24_hour;
+        util::optional<double>         minimum_temperature_24_hour;
+        util::optional<peak_wind>      peak_wind_group;
+        util::optional<wind_shift>     wind_shift_group;
+        std::vector<weather_event>     weather_events;
+        bool                           lightning_detector_not_operating;
+        bool                           precipitation_identifier_not_operating;
+        bool                           maintenance_required;
+        std::vector<util::string_view> unparsed;
+    };
+
+    // The groups are written only by the thread that moves the state from
+    // pending to decoding, and published by the release of state_decoded
+    util::string_view                    m_text;
+    mutable std::atomic<decode_state>    m_state;
+    mutable decoded_groups               m_groups;
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
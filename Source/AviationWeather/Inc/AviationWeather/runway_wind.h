@@ -0,0 +1,132 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <AviationWeather/components.h>
+#include <AviationWeather/optional.h>
+#include <AviationWeather/types.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// Runways of many stations, stored as flat columns with each station's
+// runways kept together. Runway numbers (1 - 36) give the heading in tens of
+// degrees, which is what the wind component tables are indexed by.
+class runway_table
+{
+    friend class runway_winds;
+
+public:
+    typedef std::shared_ptr<runway_table> pointer;
+    typedef std::unique_ptr<runway_table> unique_pointer;
+
+    runway_table();
+
+    runway_table(runway_table const& other) = default;
+    runway_table(runway_table && other);
+
+    runway_table& operator= (runway_table const& rhs) = default;
+    runway_table& operator= (runway_table && rhs);
+
+    // Adds one end of a runway, so 09/27 is added as 9 and 27. Throws
+    // aw_exception if the number is not between 1 and 36.
+    void add(station_identifier const& identifier, uint8_t number,
+        runway_designator_type designator = runway_designator_type::none);
+
+    // Returns the index of the station, or nullopt
+    util::optional<size_t> find(station_identifier const& identifier) const;
+
+    size_t station_count() const;
+    size_t runway_count() const;
+
+    station_identifier const& station(size_t stationIndex) const;
+
+    // The station's runways are the indices [first_runway, last_runway)
+    size_t first_runway(size_t stationIndex) const;
+    size_t last_runway(size_t stationIndex) const;
+
+    uint8_t runway_number(size_t runwayIndex) const;
+    runway_designator_type runway_designator(size_t runwayIndex) const;
+    size_t runway_station(size_t runwayIndex) const;
+
+private:
+    std::unordered_map<station_identifier, size_t> m_stationIndices;
+    std::vector<station_identifier>                m_stations;
+    std::vector<uint32_t>                          m_offsets;      // First runway of each station, plus the runway count
+    std::vector<uint32_t>                          m_runwayStation;
+    std::vector<uint8_t>                           m_numbers;
+    std::vector<runway_designator_type>            m_designators;
+};
+
+//-----------------------------------------------------------------------------
+
+// Wind components in knots for every runway of a runway_table, one entry per
+// runway in table order. The whole table is computed in one pass over flat
+// columns, using precomputed sines and cosines of the 36 runway headings and
+// of wind directions in 10 degree steps.
+//
+// Negative headwinds are tailwinds and positive crosswinds are from the
+// right. The gust columns use the gust speed, or the steady speed if there is
+// no gust. The extremes cover every direction in the variation range at the
+// gust speed: a variable wind without a range covers every direction, and a
+// steady wind only its own. Stations without a wind have NaN components.
+class runway_winds
+{
+public:
+    typedef std::shared_ptr<runway_winds> pointer;
+    typedef std::unique_ptr<runway_winds> unique_pointer;
+
+    runway_winds();
+
+    runway_winds(runway_winds const& other) = default;
+    runway_winds(runway_winds && other);
+
+    runway_winds& operator= (runway_winds const& rhs) = default;
+    runway_winds& operator= (runway_winds && rhs);
+
+    // Computes every column. winds holds one entry per station of the table.
+    // Throws aw_exception if the sizes differ.
+    void compute(runway_table const& runways, std::vector<util::optional<wind>> const& winds);
+
+    // The runway with the most headwind, preferring the least crosswind
+    // between equals. Returns nullopt if the station has no runways or wind.
+    util::optional<size_t> best_runway(runway_table const& runways, size_t stationIndex) const;
+
+    // Best runway of every station, indexed by station
+    void best_runways(runway_table const& runways, std::vector<util::optional<size_t>>& results) const;
+
+public:
+    std::vector<float> headwind;
+    std::vector<float> crosswind;
+    std::vector<float> gust_headwind;
+    std::vector<float> gust_crosswind;
+    std::vector<float> max_tailwind;   // Largest tailwind over the variation range, 0 if there is none
+    std::vector<float> max_crosswind;  // Largest crosswind magnitude over the variation range
+
+private:
+    std::vector<float> m_columns;      // Inputs to compute(), kept to avoid allocating on every update
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
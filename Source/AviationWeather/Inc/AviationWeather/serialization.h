@@ -0,0 +1,105 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <AviationWeather/metar.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// Compact binary encoding of decoded reports, for caching parsed results
+// between processes. The encoding is independent of the machine's byte order
+// and word size. Each report is prefixed with its length so that readers can
+// skip reports, and a stream of reports starts with a header holding the
+// format version. Decoding reads the current version and every earlier one.
+//
+// The raw report text and remarks may be left out to save space; decoded
+// reports then have empty raw_data and remarks but every group intact.
+// The content_hash() of a decoded report is computed from its fields rather
+// than stored, so it cannot disagree with them.
+const uint8_t binary_format_version = 2;
+
+//-----------------------------------------------------------------------------
+
+// A single report, without a stream header. Appends to the buffer.
+void encode(metar const& report, std::vector<uint8_t>& buffer, bool includeText = true);
+
+// Decodes one report written by encode(metar const&, ...). If consumed is
+// not null it receives the number of bytes read. Throws aw_exception if the
+// data is truncated or malformed.
+metar decode(uint8_t const* data, size_t size, size_t* consumed = nullptr);
+
+// Decodes one report over the previous contents of a view, reusing its lists,
+// so that decoding many reports into one view rarely allocates. The text
+// fields refer into data, which must outlive the view. If decoding throws,
+// the view is left in an unspecified state.
+void decode(uint8_t const* data, size_t size, metar_view& report, size_t* consumed = nullptr);
+
+//-----------------------------------------------------------------------------
+
+// A stream of reports with a header. Appends to the buffer.
+void encode(metar const* reports, size_t count, std::vector<uint8_t>& buffer, bool includeText = true);
+void encode(std::vector<metar> const& reports, std::vector<uint8_t>& buffer, bool includeText = true);
+
+// Decodes a stream written by the bulk encode(), appending the reports.
+// Throws aw_exception if the header, the version or any report is invalid,
+// leaving reports as it was.
+void decode(uint8_t const* data, size_t size, std::vector<metar>& reports);
+
+//-----------------------------------------------------------------------------
+
+// Reads a stream written by the bulk encode() one report at a time, decoding
+// each into the same view. This is the fastest way to scan a stream: nothing
+// is copied out of the data and steady-state reading does not allocate. The
+// view refers into data, which must outlive the reader, and is overwritten
+// by every call to next(). Throws aw_exception like the bulk decode().
+struct binary_spares;
+
+class binary_stream_reader
+{
+public:
+    binary_stream_reader(uint8_t const* data, size_t size);
+    ~binary_stream_reader();
+
+    binary_stream_reader(binary_stream_reader const&) = delete;
+    binary_stream_reader& operator= (binary_stream_reader const&) = delete;
+
+    // Number of reports in the stream
+    size_t size() const;
+
+    // Decodes the next report into report(), or returns false at the end
+    bool next();
+    metar_view const& report() const;
+
+private:
+    uint8_t const* m_position;
+    uint8_t const* m_end;
+    size_t         m_remaining;
+    size_t         m_size;
+    metar_view     m_report;
+
+    std::unique_ptr<binary_spares> m_spares;
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -0,0 +1,97 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace util
+{
+
+//-----------------------------------------------------------------------------
+
+// Minimal non-owning view over a contiguous character sequence. This mirrors
+// the subset of std::string_view (C++17) used by the library so that the
+// supported toolsets (v120, v140) do not need it.
+class string_view
+{
+public:
+    typedef const char* const_iterator;
+    typedef size_t size_type;
+
+    static const size_type npos = static_cast<size_type>(-1);
+
+    string_view() : m_data(nullptr), m_size(0) {}
+    string_view(const char* data) : m_data(data), m_size(data ? strlen(data) : 0) {}
+    string_view(const char* data, size_type size) : m_data(data), m_size(size) {}
+    string_view(std::string const& str) : m_data(str.data()), m_size(str.size()) {}
+
+    string_view(string_view const& other) = default;
+    string_view& operator= (string_view const& rhs) = default;
+
+    const char* data() const { return m_data; }
+    size_type size() const { return m_size; }
+    size_type length() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    const_iterator begin() const { return m_data; }
+    const_iterator end() const { return m_data + m_size; }
+
+    char operator[] (size_type pos) const { return m_data[pos]; }
+
+    string_view substr(size_type pos, size_type count = npos) const
+    {
+        if (pos > m_size)
+        {
+            throw std::out_of_range("string_view::substr");
+        }
+        return string_view(m_data + pos, (std::min)(count, m_size - pos));
+    }
+
+    size_type find(char c, size_type pos = 0) const
+    {
+        for (; pos < m_size; ++pos)
+        {
+            if (m_data[pos] == c)
+            {
+                return pos;
+            }
+        }
+        return npos;
+    }
+
+    std::string to_string() const { return std::string(m_data, m_size); }
+
+    bool operator== (string_view const& rhs) const
+    {
+        return m_size == rhs.m_size && (m_size == 0 || memcmp(m_data, rhs.m_data, m_size) == 0);
+    }
+
+    bool operator!= (string_view const& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+private:
+    const char* m_data;
+    size_type   m_size;
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace util
@@ -0,0 +1,148 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <AviationWeather/components.h>
+#include <AviationWeather/optional.h>
+#include <AviationWeather/string_view.h>
+#include <AviationWeather/types.h>
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+enum class taf_report_type
+{
+    routine,
+    amended,    // AMD
+    corrected   // COR
+};
+
+enum class taf_change_type
+{
+    initial,     // Conditions from the start of the validity period
+    from,        // FM: conditions change completely at the start time
+    becoming,    // BECMG: conditions change gradually over the period
+    temporary,   // TEMPO: temporary fluctuations during the period
+    probability  // PROBnn: conditions with the given probability during the period
+};
+
+//-----------------------------------------------------------------------------
+
+class wind_shear
+{
+public:
+    typedef std::shared_ptr<wind_shear> pointer;
+    typedef std::unique_ptr<wind_shear> unique_pointer;
+
+    wind_shear();
+
+    wind_shear(wind_shear const& other) = default;
+    wind_shear(wind_shear && other);
+
+    wind_shear& operator= (wind_shear const& rhs) = default;
+    wind_shear& operator= (wind_shear && rhs);
+
+    bool operator== (wind_shear const& rhs) const;
+    bool operator!= (wind_shear const& rhs) const;
+
+public:
+    uint32_t height;      // Height of the shear layer above ground level in feet
+    wind     wind_group;  // Wind at the top of the shear layer
+};
+
+//-----------------------------------------------------------------------------
+
+class taf_period
+{
+public:
+    typedef std::shared_ptr<taf_period> pointer;
+    typedef std::unique_ptr<taf_period> unique_pointer;
+
+    taf_period();
+
+    taf_period(taf_period const& other) = default;
+    taf_period(taf_period && other);
+
+    taf_period& operator= (taf_period const& rhs) = default;
+    taf_period& operator= (taf_period && rhs);
+
+    bool operator== (taf_period const& rhs) const;
+    bool operator!= (taf_period const& rhs) const;
+
+public:
+    taf_change_type            change;
+    uint8_t                    probability;            // 30 or 40 for PROB groups (including PROB TEMPO), otherwise 0
+    time                       begin;
+    time                       end;                    // For FM groups, the start of the next FM group or the end of validity
+    util::optional<wind>       wind_group;
+    util::optional<visibility> visibility_group;
+    std::vector<weather>       weather_group;
+    std::vector<cloud_layer>   sky_condition_group;
+    bool                       no_significant_weather; // NSW
+    util::optional<wind_shear> wind_shear_group;
+};
+
+//-----------------------------------------------------------------------------
+
+// Terminal Aerodrome Forecast. Parsing is a single pass over the tokens of
+// the report using the regex-free group decoders. For batch processing, one
+// taf can be reused with parse(), which keeps the storage allocated for
+// earlier reports.
+class taf
+{
+public:
+    typedef std::shared_ptr<taf> pointer;
+    typedef std::unique_ptr<taf> unique_pointer;
+
+    taf();
+    taf(std::string const& taf);
+
+    taf(taf const& other) = default;
+    taf(taf && other);
+
+    taf& operator= (taf const& rhs) = default;
+    taf& operator= (taf && rhs);
+
+    bool operator== (taf const& rhs) const;
+    bool operator!= (taf const& rhs) const;
+
+    // Replaces the contents with the parsed report
+    void parse(util::string_view const& taf);
+
+public:
+    std::string             raw_data;
+    taf_report_type         type;
+    station_identifier      identifier;
+    time                    issue_time;
+    time                    valid_from;
+    time                    valid_to;
+    bool                    cancelled;      // CNL
+    std::vector<taf_period> forecast_group; // In report order, starting with the initial conditions
+    std::string             remarks;
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
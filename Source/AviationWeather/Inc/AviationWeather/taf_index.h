@@ -0,0 +1,162 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <AviationWeather/components.h>
+#include <AviationWeather/optional.h>
+#include <AviationWeather/taf.h>
+#include <AviationWeather/types.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// Conditions forecast for an instant, with the ceiling and flight category
+// derived by the same rules as metar::ceiling() and metar::flight_category().
+class taf_conditions
+{
+public:
+    typedef std::shared_ptr<taf_conditions> pointer;
+    typedef std::unique_ptr<taf_conditions> unique_pointer;
+
+    taf_conditions();
+
+    taf_conditions(taf_conditions const& other) = default;
+    taf_conditions(taf_conditions && other);
+
+    taf_conditions& operator= (taf_conditions const& rhs) = default;
+    taf_conditions& operator= (taf_conditions && rhs);
+
+    bool operator== (taf_conditions const& rhs) const;
+    bool operator!= (taf_conditions const& rhs) const;
+
+public:
+    util::optional<wind>       wind_group;
+    util::optional<visibility> visibility_group;
+    std::vector<weather>       weather_group;
+    std::vector<cloud_layer>   sky_condition_group;
+    cloud_layer                ceiling;         // Unlimited if there is no ceiling layer
+    flight_category            category;
+};
+
+//-----------------------------------------------------------------------------
+
+// A TAF compiled into a sorted list of intervals over its validity period.
+// The boundaries are the begin and end times of every change group, so the
+// conditions are constant within each interval and are resolved once when
+// the index is built. Lookups are a binary search over the boundaries.
+//
+// Prevailing conditions come from the initial and FM groups, with BECMG
+// changes applied from the end of their transition period. The worst case
+// additionally takes the lowest visibility, lowest ceiling, strongest wind
+// and all weather from any TEMPO, PROB or in-progress BECMG group.
+class taf_index
+{
+public:
+    typedef std::shared_ptr<taf_index> pointer;
+    typedef std::unique_ptr<taf_index> unique_pointer;
+
+    taf_index();
+    taf_index(taf const& forecast);
+
+    taf_index(taf_index const& other) = default;
+    taf_index(taf_index && other);
+
+    taf_index& operator= (taf_index const& rhs) = default;
+    taf_index& operator= (taf_index && rhs);
+
+    station_identifier const& identifier() const;
+    time const& valid_from() const;
+    time const& valid_to() const;
+
+    // Whether the time falls within [valid_from, valid_to)
+    bool covers(time const& at) const;
+
+    // Throws aw_exception if the time is not covered
+    taf_conditions const& prevailing(time const& at) const;
+    taf_conditions const& worst_case(time const& at) const;
+
+    // Batch lookups. Each result points into the index, or is nullptr if the
+    // corresponding time is not covered.
+    void prevailing(std::vector<time> const& times, std::vector<taf_conditions const*>& results) const;
+    void worst_case(std::vector<time> const& times, std::vector<taf_conditions const*>& results) const;
+
+private:
+    uint32_t to_minutes(time const& at) const;
+    taf_conditions const* find(std::vector<taf_conditions> const& conditions, time const& at) const;
+
+private:
+    station_identifier          m_identifier;
+    time                        m_validFrom;
+    time                        m_validTo;
+    uint8_t                     m_monthLength; // Days in the month valid_from falls in
+    std::vector<uint32_t>       m_boundaries; // Minutes from the start of the day of valid_from, ascending
+    std::vector<taf_conditions> m_prevailing; // One entry per interval, m_boundaries.size() - 1 in total
+    std::vector<taf_conditions> m_worstCase;
+};
+
+//-----------------------------------------------------------------------------
+
+struct taf_query
+{
+    station_identifier identifier;
+    time               at;
+};
+
+// Compiled forecasts for many stations, keyed by station identifier.
+class taf_index_set
+{
+public:
+    typedef std::shared_ptr<taf_index_set> pointer;
+    typedef std::unique_ptr<taf_index_set> unique_pointer;
+
+    taf_index_set();
+
+    taf_index_set(taf_index_set const& other) = default;
+    taf_index_set(taf_index_set && other);
+
+    taf_index_set& operator= (taf_index_set const& rhs) = default;
+    taf_index_set& operator= (taf_index_set && rhs);
+
+    // Compiles the forecast, replacing any earlier forecast for the station
+    void insert(taf const& forecast);
+
+    // Returns the index for the station, or nullptr
+    taf_index const* find(station_identifier const& identifier) const;
+
+    size_t size() const;
+    void clear();
+
+    // Batch lookups. Each result points into the set, or is nullptr if there
+    // is no forecast for the station or it does not cover the time. Results
+    // are invalidated by insert() and clear().
+    void prevailing(std::vector<taf_query> const& queries, std::vector<taf_conditions const*>& results) const;
+    void worst_case(std::vector<taf_query> const& queries, std::vector<taf_conditions const*>& results) const;
+
+private:
+    std::unordered_map<station_identifier, taf_index> m_indices;
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
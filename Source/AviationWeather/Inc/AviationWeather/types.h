@@ -86,7 +86,9 @@ enum class sky_cover_type
     few,
     scattered,
     broken,
-    overcast
+    overcast,
+    no_significant_cloud,
+    no_cloud_detected
 };
 
 enum class sky_cover_cloud_type
@@ -124,7 +126,8 @@ enum class flight_category
 enum class speed_unit
 {
     kt  = 0, // Knots
-    mph = 1  // Miles per hour
+    mph = 1, // Miles per hour
+    mps = 2  // Metres per second
 };
 
 enum class distance_unit
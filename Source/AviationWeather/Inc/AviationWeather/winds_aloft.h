@@ -0,0 +1,125 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <AviationWeather/components.h>
+#include <AviationWeather/optional.h>
+#include <AviationWeather/string_view.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// Wind and temperature interpolated at an altitude
+struct winds_aloft_sample
+{
+    bool   has_wind;
+    bool   has_temperature;
+    double direction;    // Degrees true the wind is blowing from, 0 if calm
+    double speed;        // Knots
+    double temperature;  // Degrees Celsius
+};
+
+//-----------------------------------------------------------------------------
+
+// Winds and temperatures aloft forecast (FD/FB). The table is decoded into a
+// grid of station rows by altitude columns. Each decoded field is held in its
+// own array with a station's altitudes adjacent, so interpolation reads a few
+// contiguous values. Tables split into
+// several sections, such as a national bulletin with separate low and high
+// altitude parts, are merged into one grid; cells a section does not forecast
+// are left empty.
+class winds_aloft
+{
+public:
+    typedef std::shared_ptr<winds_aloft> pointer;
+    typedef std::unique_ptr<winds_aloft> unique_pointer;
+
+    static const size_t npos = static_cast<size_t>(-1);
+
+    winds_aloft();
+    winds_aloft(std::string const& forecast);
+
+    winds_aloft(winds_aloft const& other) = default;
+    winds_aloft(winds_aloft && other);
+
+    winds_aloft& operator= (winds_aloft const& rhs) = default;
+    winds_aloft& operator= (winds_aloft && rhs);
+
+    bool operator== (winds_aloft const& rhs) const;
+    bool operator!= (winds_aloft const& rhs) const;
+
+    // Replaces the contents with the parsed forecast, reusing storage
+    void parse(util::string_view const& forecast);
+
+    // Row of the station in the grid, or npos
+    size_t find_station(util::string_view const& identifier) const;
+
+    // Decoded cell values. Light and variable winds (9900) are reported as
+    // a variable direction with zero speed.
+    util::optional<wind> wind_at(size_t station, size_t altitude) const;
+    util::optional<int8_t> temperature_at(size_t station, size_t altitude) const;
+
+    // Interpolates linearly between the nearest forecast altitudes above and
+    // below, using the wind vector so that direction wraps correctly. Values
+    // are not extrapolated beyond the highest or lowest forecast altitude.
+    // Returns result.has_wind; neither overload allocates once the results
+    // vector has grown to size.
+    bool interpolate(size_t station, double altitude, winds_aloft_sample& result) const;
+    void interpolate(size_t station, std::vector<double> const& sampleAltitudes, std::vector<winds_aloft_sample>& results) const;
+
+public:
+    std::string                     raw_data;
+    time                            based_on;            // DATA BASED ON
+    time                            valid;               // VALID
+    time                            use_from;            // FOR USE, hour and minute only
+    time                            use_to;
+    uint32_t                        negative_above;      // TEMPS NEG ABV, in feet
+    std::vector<uint32_t>           altitudes;           // Column altitudes in feet, ascending
+    std::vector<station_identifier> stations;            // Row identifiers in report order
+
+private:
+    size_t cell(size_t station, size_t altitude) const;
+
+private:
+    // One entry per cell, indexed by station * altitudes.size() + altitude
+    std::vector<float>    m_windU;           // Wind vector in knots, east and north components
+    std::vector<float>    m_windV;
+    std::vector<uint16_t> m_direction;
+    std::vector<uint8_t>  m_speed;
+    std::vector<int8_t>   m_temperature;
+    std::vector<uint8_t>  m_flags;
+    std::vector<uint32_t> m_stationOrder;    // Rows sorted by identifier, for find_station
+};
+
+//-----------------------------------------------------------------------------
+
+// Interpolates between two forecasts for the same station, in altitude within
+// each forecast and then linearly in time between their valid times. Times
+// outside the two valid times are clamped. Returns false if either forecast
+// has no wind for the station at the altitude.
+bool interpolate(winds_aloft const& earlier, winds_aloft const& later, util::string_view const& identifier,
+    double altitude, time const& at, winds_aloft_sample& result);
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
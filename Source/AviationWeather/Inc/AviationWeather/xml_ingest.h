@@ -0,0 +1,170 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <AviationWeather/advisory.h>
+#include <AviationWeather/metar.h>
+#include <AviationWeather/optional.h>
+#include <AviationWeather/string_view.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// Forward-only reader of the dataserver's XML responses, which hold one
+// <METAR> element per report: its raw text alongside the decoded fields.
+// Only the elements of that schema are recognized; anything else between
+// them is skipped without being checked.
+//
+// Each report is parsed in place from the raw_text element, as a metar_view
+// that refers into the reader's buffer. A stream is read in blocks into a
+// buffer that only grows to hold the largest single <METAR> element, so a
+// document of any size is read in constant memory.
+
+//-----------------------------------------------------------------------------
+
+// A cloud layer as the dataserver decodes it. sky_cover is the contraction
+// (FEW, SCT, BKN, OVC, CLR, SKC, or OVX for a vertical visibility).
+class xml_sky_condition
+{
+public:
+    typedef std::shared_ptr<xml_sky_condition> pointer;
+    typedef std::unique_ptr<xml_sky_condition> unique_pointer;
+
+    xml_sky_condition();
+
+    xml_sky_condition(xml_sky_condition const& other) = default;
+    xml_sky_condition(xml_sky_condition && other);
+
+    xml_sky_condition& operator= (xml_sky_condition const& rhs) = default;
+    xml_sky_condition& operator= (xml_sky_condition && rhs);
+
+public:
+    util::string_view        sky_cover;
+    util::optional<uint32_t> cloud_base;   // Feet above ground level
+};
+
+//-----------------------------------------------------------------------------
+
+// Decoded fields of a <METAR> element. Like the report, the text fields refer
+// into the reader's buffer. Fields that are absent, or that do not hold a
+// number, are left unset; the position needs both latitude and longitude.
+class xml_fields
+{
+public:
+    typedef std::shared_ptr<xml_fields> pointer;
+    typedef std::unique_ptr<xml_fields> unique_pointer;
+
+    xml_fields();
+
+    xml_fields(xml_fields const& other) = default;
+    xml_fields(xml_fields && other);
+
+    xml_fields& operator= (xml_fields const& rhs) = default;
+    xml_fields& operator= (xml_fields && rhs);
+
+    void clear();
+
+public:
+    util::string_view               station_id;
+    util::string_view               observation_time;   // ISO 8601, such as 2015-12-12T17:56:00Z
+    util::string_view               metar_type;         // METAR or SPECI
+    util::optional<geo_point>       position;
+    util::optional<double>          elevation;          // Metres
+    util::optional<double>          temperature;        // Degrees Celsius
+    util::optional<double>          dewpoint;           // Degrees Celsius
+    util::optional<double>          wind_direction;     // Degrees true
+    util::optional<double>          wind_speed;         // Knots
+    util::optional<double>          wind_gust;          // Knots
+    util::optional<double>          visibility;         // Statute miles
+    util::optional<double>          altimeter;          // Inches of mercury
+    std::vector<xml_sky_condition>  sky_condition;
+};
+
+//-----------------------------------------------------------------------------
+
+// Reads the <METAR> elements of a document in order:
+//
+//   std::ifstream stream(path, std::ios::binary);
+//   xml_reader reader(stream);
+//   while (reader.next())
+//   {
+//       auto const& report = reader.report();
+//       ...
+//   }
+//
+// The report and fields stay valid until the next call to next(). With
+// cross-checking on, each report's decoded fields are compared with the
+// parsed report, and mismatches() gives the elements where they disagree.
+// Decoded values may be rounded or converted from metric units, and are
+// compared to within that; fields missing from the element are not checked.
+class xml_reader
+{
+public:
+    typedef std::shared_ptr<xml_reader> pointer;
+    typedef std::unique_ptr<xml_reader> unique_pointer;
+
+    // Reads a stream blockSize bytes at a time
+    xml_reader(std::istream& stream, bool crossCheck = false, size_t blockSize = 64 * 1024);
+
+    // Reads a document in memory, which must outlive the reader
+    xml_reader(const char* data, size_t size, bool crossCheck = false);
+
+    xml_reader(xml_reader const&) = delete;
+    xml_reader& operator= (xml_reader const&) = delete;
+
+    // Moves to the next report, returning false after the last. Throws
+    // aw_exception if the document ends inside a <METAR> element, or if one
+    // has no raw_text.
+    bool next();
+
+    metar_view const& report() const;
+    xml_fields const& fields() const;
+
+    // Elements whose decoded fields disagree with the report, as
+    // element_mask bits (see metar_diff.h). Always 0 without cross-checking.
+    uint16_t mismatches() const;
+
+private:
+    bool fill();
+    void read_element(const char* begin, const char* end);
+    void cross_check();
+
+private:
+    std::istream*                  m_stream;
+    std::vector<char>              m_buffer;
+    const char*                    m_data;
+    size_t                         m_size;
+    size_t                         m_position;
+    size_t                         m_blockSize;
+    bool                           m_crossCheck;
+    std::string                    m_text;       // Raw text with its entities replaced
+    util::optional<metar_view>     m_report;
+    xml_fields                     m_fields;
+    uint16_t                       m_mismatches;
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -18,7 +18,6 @@
 #include <ctime>
 #include <iostream>
 #include <list>
-#include <regex>
 #include <sstream>
 #include <string>
 #include <vector>
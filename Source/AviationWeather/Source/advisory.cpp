@@ -0,0 +1,935 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/advisory.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "time_utility.h"
+#include "tokens.h"
+#include "utility.h"
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const double pi = 3.14159265358979323846;
+const double degrees_to_radians = pi / 180.0;
+const double earth_radius_nm = 3440.065;
+
+const char* g_compass[] =
+{
+    "N", "NNE", "NE", "ENE", "E", "ESE", "SE", "SSE", "S", "SSW", "SW", "WSW", "W", "WNW", "NW", "NNW"
+};
+
+const char* g_airmetSeries[] = { "SIERRA", "TANGO", "ZULU" };
+
+//-----------------------------------------------------------------------------
+
+// Whitespace separated tokens, also split at "..." and without trailing
+// full stops, commas or '='
+void split_tokens(util::string_view const& text, std::vector<util::string_view>& tokens)
+{
+    for_each_token(text, [&](util::string_view const& token)
+    {
+        size_t start = 0;
+        for (size_t i = 0; i <= token.size(); ++i)
+        {
+            bool ellipsis = i + 3 <= token.size() && token[i] == '.' && token[i + 1] == '.' && token[i + 2] == '.';
+            if (i == token.size() || ellipsis)
+            {
+                auto part = token.substr(start, i - start);
+                while (!part.empty() && (part[part.size() - 1] == '.' || part[part.size() - 1] == ',' || part[part.size() - 1] == '='))
+                {
+                    part = part.substr(0, part.size() - 1);
+                }
+                if (!part.empty())
+                {
+                    tokens.push_back(part);
+                }
+                if (ellipsis)
+                {
+                    i += 2;
+                    start = i + 1;
+                }
+            }
+        }
+    });
+}
+
+bool is_letters(util::string_view const& token, size_t minimum, size_t maximum)
+{
+    if (token.size() < minimum || token.size() > maximum)
+    {
+        return false;
+    }
+    for (auto c : token)
+    {
+        if (c < 'A' || c > 'Z')
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool is_airmet_series(util::string_view const& token)
+{
+    for (auto series : g_airmetSeries)
+    {
+        if (token == series)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// hhmmZ, taking the day from the reference time, or ddhhmm
+bool decode_time(util::string_view const& token, util::optional<time> const& reference, time& result)
+{
+    if (token.size() == 5 && are_digits(token, 0, 4) && token[4] == 'Z')
+    {
+        auto hour = static_cast<uint8_t>(to_number(token, 0, 2));
+        auto minute = static_cast<uint8_t>(to_number(token, 2, 2));
+        uint8_t day = reference ? reference->day_of_month : 0;
+
+        // Validity ends after the issue time, so an earlier time is the next day
+        if (reference && (hour * 60 + minute) < (reference->hour_of_day * 60 + reference->minute_of_hour))
+        {
+            day = day % 31 + 1;
+        }
+        result = time(day, hour, minute);
+        return true;
+    }
+    if (token.size() == 6 && are_digits(token, 0, 6))
+    {
+        result = time(static_cast<uint8_t>(to_number(token, 0, 2)), static_cast<uint8_t>(to_number(token, 2, 2)), static_cast<uint8_t>(to_number(token, 4, 2)));
+        return true;
+    }
+    return false;
+}
+
+// FLddd, ddd (hundreds of feet) or SFC, in feet
+bool decode_altitude(util::string_view const& token, uint32_t& result)
+{
+    if (token == "SFC")
+    {
+        result = 0;
+        return true;
+    }
+    auto digits = starts_with(token, "FL") ? token.substr(2) : token;
+    if (digits.size() != 3 || !are_digits(digits, 0, 3))
+    {
+        return false;
+    }
+    result = static_cast<uint32_t>(to_number(digits, 0, 3)) * 100;
+    return true;
+}
+
+hazard_type decode_hazard(util::string_view const& token, util::string_view const& next)
+{
+    if (token == "TS" || token == "TSGR" || token == "CB")  { return hazard_type::thunderstorm; }
+    if (token == "TURB")                                    { return hazard_type::turbulence; }
+    if (token == "ICE" || token == "ICG")                   { return hazard_type::icing; }
+    if (token == "IFR")                                     { return hazard_type::ifr; }
+    if (token == "MTN" && next == "OBSCN")                  { return hazard_type::mountain_obscuration; }
+    if (token == "SFC" && starts_with(next, "WND"))         { return hazard_type::surface_wind; }
+    if (token == "LLWS")                                    { return hazard_type::low_level_wind_shear; }
+    if (token == "MTW")                                     { return hazard_type::mountain_wave; }
+    if (token == "VA")                                      { return hazard_type::volcanic_ash; }
+    if (token == "DS" || token == "SS")                     { return hazard_type::dust_sand; }
+    if (token == "TC")                                      { return hazard_type::tropical_cyclone; }
+    return hazard_type::unknown;
+}
+
+// 30NW: a distance in nautical miles and a compass point
+bool decode_offset(util::string_view const& token, uint16_t& distance, double& bearing)
+{
+    size_t digits = 0;
+    while (digits < token.size() && digits < 3 && is_digit(token[digits]))
+    {
+        ++digits;
+    }
+    if (digits == 0)
+    {
+        return false;
+    }
+
+    auto direction = token.substr(digits);
+    for (size_t i = 0; i < sizeof(g_compass) / sizeof(g_compass[0]); ++i)
+    {
+        if (direction == g_compass[i])
+        {
+            distance = static_cast<uint16_t>(to_number(token, 0, digits));
+            bearing = i * 22.5;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Nddmm or Ndd, Edddmm or Eddd
+bool decode_coordinate(util::string_view const& token, char positive, char negative, size_t degreeDigits, double& result)
+{
+    if (token.empty() || (token[0] != positive && token[0] != negative))
+    {
+        return false;
+    }
+    auto digits = token.size() - 1;
+    if ((digits != degreeDigits && digits != degreeDigits + 2) || !are_digits(token, 1, digits))
+    {
+        return false;
+    }
+    result = to_number(token, 1, degreeDigits);
+    if (digits > degreeDigits)
+    {
+        result += to_number(token, 1 + degreeDigits, 2) / 60.0;
+    }
+    if (token[0] == negative)
+    {
+        result = -result;
+    }
+    return true;
+}
+
+// Atoms of a point list: tokens split at '-', with "-" and "TO" as separators
+void split_atoms(std::vector<util::string_view> const& tokens, size_t begin, std::vector<util::string_view>& atoms)
+{
+    static const char* separator = "-";
+    for (auto i = begin; i < tokens.size(); ++i)
+    {
+        auto const& token = tokens[i];
+        if (token == "TO")
+        {
+            atoms.push_back(separator);
+            continue;
+        }
+        size_t start = 0;
+        for (size_t j = 0; j <= token.size(); ++j)
+        {
+            if (j == token.size() || token[j] == '-')
+            {
+                if (j > start)
+                {
+                    atoms.push_back(token.substr(start, j - start));
+                }
+                if (j < token.size())
+                {
+                    atoms.push_back(separator);
+                }
+                start = j + 1;
+            }
+        }
+    }
+}
+
+// FROM 30NW ICT-40S MCI-... or FROM 30SE YDC TO 40E PDT TO ...
+void decode_navaid_points(std::vector<util::string_view> const& atoms, std::vector<advisory_point>& points)
+{
+    bool expectPoint = true;
+    advisory_point point;
+    for (auto const& atom : atoms)
+    {
+        if (atom == "-")
+        {
+            expectPoint = true;
+            continue;
+        }
+        if (!expectPoint)
+        {
+            return;
+        }
+        if (decode_offset(atom, point.distance, point.bearing))
+        {
+            continue;
+        }
+        if (!is_letters(atom, 2, 4))
+        {
+            return;
+        }
+
+        point.navaid = atom.to_string();
+        points.push_back(point);
+        point = advisory_point();
+        expectPoint = false;
+    }
+}
+
+// WI N5130 W00200 - N5300 W00100 - ...
+void decode_coordinate_points(std::vector<util::string_view> const& atoms, std::vector<advisory_point>& points)
+{
+    bool expectPoint = true;
+    for (size_t i = 0; i < atoms.size(); ++i)
+    {
+        if (atoms[i] == "-")
+        {
+            expectPoint = true;
+            continue;
+        }
+
+        geo_point position;
+        if (!expectPoint || i + 1 >= atoms.size() ||
+            !decode_coordinate(atoms[i], 'N', 'S', 2, position.latitude) ||
+            !decode_coordinate(atoms[i + 1], 'E', 'W', 3, position.longitude))
+        {
+            return;
+        }
+
+        advisory_point point;
+        point.position = position;
+        points.push_back(point);
+        expectPoint = false;
+        ++i;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+// Planar coordinates in nautical miles around a reference latitude
+struct plane_point
+{
+    double x;
+    double y;
+};
+
+// The longitude is unwrapped around the reference longitude
+plane_point to_plane(geo_point const& point, double scale, double reference)
+{
+    return { unwrap_longitude(point.longitude, reference) * scale * 60.0, point.latitude * 60.0 };
+}
+
+double cross(plane_point const& o, plane_point const& a, plane_point const& b)
+{
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+bool on_segment(plane_point const& p, plane_point const& a, plane_point const& b)
+{
+    return (std::min)(a.x, b.x) <= p.x && p.x <= (std::max)(a.x, b.x) &&
+        (std::min)(a.y, b.y) <= p.y && p.y <= (std::max)(a.y, b.y);
+}
+
+bool segments_intersect(plane_point const& a, plane_point const& b, plane_point const& c, plane_point const& d)
+{
+    auto d1 = cross(c, d, a);
+    auto d2 = cross(c, d, b);
+    auto d3 = cross(a, b, c);
+    auto d4 = cross(a, b, d);
+    if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0)))
+    {
+        return true;
+    }
+    return (d1 == 0 && on_segment(a, c, d)) || (d2 == 0 && on_segment(b, c, d)) ||
+        (d3 == 0 && on_segment(c, a, b)) || (d4 == 0 && on_segment(d, a, b));
+}
+
+double point_segment_distance(plane_point const& p, plane_point const& a, plane_point const& b)
+{
+    auto dx = b.x - a.x;
+    auto dy = b.y - a.y;
+    auto length = dx * dx + dy * dy;
+    auto t = length == 0.0 ? 0.0 : (std::max)(0.0, (std::min)(1.0, ((p.x - a.x) * dx + (p.y - a.y) * dy) / length));
+    auto x = a.x + t * dx - p.x;
+    auto y = a.y + t * dy - p.y;
+    return std::sqrt(x * x + y * y);
+}
+
+double segment_distance(plane_point const& a, plane_point const& b, plane_point const& c, plane_point const& d)
+{
+    if (segments_intersect(a, b, c, d))
+    {
+        return 0.0;
+    }
+    return (std::min)((std::min)(point_segment_distance(a, c, d), point_segment_distance(b, c, d)),
+        (std::min)(point_segment_distance(c, a, b), point_segment_distance(d, a, b)));
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+void navaid_table::add(station_identifier const& identifier, geo_point const& position)
+{
+    m_navaids[identifier] = position;
+}
+
+geo_point const* navaid_table::find(util::string_view const& identifier) const
+{
+    auto result = m_navaids.find(identifier.to_string());
+    return result != m_navaids.end() ? &result->second : nullptr;
+}
+
+size_t navaid_table::size() const
+{
+    return m_navaids.size();
+}
+
+//-----------------------------------------------------------------------------
+
+advisory_point::advisory_point() :
+    navaid(""),
+    bearing(0.0),
+    distance(0)
+{}
+
+advisory_point::advisory_point(advisory_point && other) :
+    navaid(""),
+    bearing(0.0),
+    distance(0)
+{
+    *this = std::move(other);
+}
+
+advisory_point& advisory_point::operator=(advisory_point && rhs)
+{
+    if (this != &rhs)
+    {
+        navaid = std::move(rhs.navaid);
+        bearing = rhs.bearing;
+        distance = rhs.distance;
+        position = std::move(rhs.position);
+
+        rhs.navaid = "";
+        rhs.bearing = 0.0;
+        rhs.distance = 0;
+        rhs.position = util::nullopt;
+    }
+    return *this;
+}
+
+bool advisory_point::operator== (advisory_point const& rhs) const
+{
+    return (navaid == rhs.navaid) &&
+        (bearing == rhs.bearing) &&
+        (distance == rhs.distance) &&
+        (static_cast<bool>(position) == static_cast<bool>(rhs.position)) &&
+        (!position || (position->latitude == rhs.position->latitude && position->longitude == rhs.position->longitude));
+}
+
+bool advisory_point::operator!= (advisory_point const& rhs) const
+{
+    return !(*this == rhs);
+}
+
+//-----------------------------------------------------------------------------
+
+advisory::advisory() :
+    raw_data(""),
+    type(advisory_type::sigmet),
+    identifier(""),
+    hazard(hazard_type::unknown),
+    valid_to(0, 0, 0),
+    geometry(advisory_geometry::none),
+    width(0)
+{}
+
+advisory::advisory(std::string const& advisory) :
+    raw_data(""),
+    type(advisory_type::sigmet),
+    identifier(""),
+    hazard(hazard_type::unknown),
+    valid_to(0, 0, 0),
+    geometry(advisory_geometry::none),
+    width(0)
+{
+    parse(advisory, util::nullopt, "", util::nullopt);
+}
+
+advisory::advisory(advisory && other) :
+    raw_data(""),
+    type(advisory_type::sigmet),
+    identifier(""),
+    hazard(hazard_type::unknown),
+    valid_to(0, 0, 0),
+    geometry(advisory_geometry::none),
+    width(0)
+{
+    *this = std::move(other);
+}
+
+advisory& advisory::operator=(advisory && rhs)
+{
+    if (this != &rhs)
+    {
+        raw_data = std::move(rhs.raw_data);
+        type = rhs.type;
+        identifier = std::move(rhs.identifier);
+        hazard = rhs.hazard;
+        valid_from = std::move(rhs.valid_from);
+        valid_to = std::move(rhs.valid_to);
+        lower_altitude = std::move(rhs.lower_altitude);
+        upper_altitude = std::move(rhs.upper_altitude);
+        geometry = rhs.geometry;
+        width = rhs.width;
+        points = std::move(rhs.points);
+
+        rhs.raw_data = "";
+        rhs.type = advisory_type::sigmet;
+        rhs.identifier = "";
+        rhs.hazard = hazard_type::unknown;
+        rhs.valid_from = util::nullopt;
+        rhs.valid_to = time(0, 0, 0);
+        rhs.lower_altitude = util::nullopt;
+        rhs.upper_altitude = util::nullopt;
+        rhs.geometry = advisory_geometry::none;
+        rhs.width = 0;
+        rhs.points.clear();
+    }
+    return *this;
+}
+
+bool advisory::operator== (advisory const& rhs) const
+{
+    return (type == rhs.type) &&
+        (identifier == rhs.identifier) &&
+        (hazard == rhs.hazard) &&
+        (valid_from == rhs.valid_from) &&
+        (valid_to == rhs.valid_to) &&
+        (lower_altitude == rhs.lower_altitude) &&
+        (upper_altitude == rhs.upper_altitude) &&
+        (geometry == rhs.geometry) &&
+        (width == rhs.width) &&
+        (points == rhs.points);
+}
+
+bool advisory::operator!= (advisory const& rhs) const
+{
+    return !(*this == rhs);
+}
+
+bool advisory::resolve(navaid_table const& navaids)
+{
+    for (auto& point : points)
+    {
+        if (point.position)
+        {
+            continue;
+        }
+        auto navaid = navaids.find(point.navaid);
+        if (navaid == nullptr)
+        {
+            continue;
+        }
+
+        // Great circle destination from the navaid
+        auto latitude = navaid->latitude * degrees_to_radians;
+        auto longitude = navaid->longitude * degrees_to_radians;
+        auto bearing = point.bearing * degrees_to_radians;
+        auto angle = point.distance / earth_radius_nm;
+
+        auto resultLatitude = std::asin(std::sin(latitude) * std::cos(angle) + std::cos(latitude) * std::sin(angle) * std::cos(bearing));
+        auto resultLongitude = longitude + std::atan2(std::sin(bearing) * std::sin(angle) * std::cos(latitude),
+            std::cos(angle) - std::sin(latitude) * std::sin(resultLatitude));
+
+        point.position = geo_point{ resultLatitude / degrees_to_radians, resultLongitude / degrees_to_radians };
+    }
+    return has_position();
+}
+
+bool advisory::has_position() const
+{
+    return geometry != advisory_geometry::none && std::all_of(points.begin(), points.end(), [](advisory_point const& point)
+    {
+        return static_cast<bool>(point.position);
+    });
+}
+
+bool advisory::active(time const& at) const
+{
+    if (valid_from && minutes_between(*valid_from, at) < 0)
+    {
+        return false;
+    }
+    return minutes_between(at, valid_to) > 0;
+}
+
+bool advisory::contains(geo_point const& point) const
+{
+    if (!has_position())
+    {
+        return false;
+    }
+
+    auto scale = std::cos(point.latitude * degrees_to_radians);
+    auto reference = points[0].position->longitude;
+    auto p = to_plane(point, scale, reference);
+
+    if (geometry == advisory_geometry::line)
+    {
+        auto limit = width / 2.0;
+        auto previous = to_plane(*points[0].position, scale, reference);
+        if (points.size() == 1)
+        {
+            return point_segment_distance(p, previous, previous) <= limit;
+        }
+        for (size_t i = 1; i < points.size(); ++i)
+        {
+            auto current = to_plane(*points[i].position, scale, reference);
+            if (point_segment_distance(p, previous, current) <= limit)
+            {
+                return true;
+            }
+            previous = current;
+        }
+        return false;
+    }
+
+    // Even-odd rule
+    bool inside = false;
+    for (size_t i = 0, j = points.size() - 1; i < points.size(); j = i++)
+    {
+        auto a = to_plane(*points[i].position, scale, reference);
+        auto b = to_plane(*points[j].position, scale, reference);
+        if ((a.y > p.y) != (b.y > p.y) && p.x < (b.x - a.x) * (p.y - a.y) / (b.y - a.y) + a.x)
+        {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+bool advisory::intersects(geo_point const& from, geo_point const& to) const
+{
+    if (!has_position())
+    {
+        return false;
+    }
+    if (contains(from) || contains(to))
+    {
+        return true;
+    }
+
+    // The segment takes the shorter way between its ends
+    auto scale = std::cos((from.latitude + to.latitude) / 2.0 * degrees_to_radians);
+    auto reference = points[0].position->longitude;
+    auto a = to_plane(from, scale, reference);
+    auto b = to_plane(to, scale, unwrap_longitude(from.longitude, reference));
+
+    if (geometry == advisory_geometry::line)
+    {
+        auto limit = width / 2.0;
+        auto previous = to_plane(*points[0].position, scale, reference);
+        if (points.size() == 1)
+        {
+            return point_segment_distance(previous, a, b) <= limit;
+        }
+        for (size_t i = 1; i < points.size(); ++i)
+        {
+            auto current = to_plane(*points[i].position, scale, reference);
+            if (segment_distance(a, b, previous, current) <= limit)
+            {
+                return true;
+            }
+            previous = current;
+        }
+        return false;
+    }
+
+    for (size_t i = 0, j = points.size() - 1; i < points.size(); j = i++)
+    {
+        if (segments_intersect(a, b, to_plane(*points[i].position, scale, reference), to_plane(*points[j].position, scale, reference)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool advisory::covers_altitude(uint32_t altitude) const
+{
+    return (!lower_altitude || altitude >= *lower_altitude) && (!upper_altitude || altitude <= *upper_altitude);
+}
+
+void advisory::parse(util::string_view const& text, util::optional<time> const& issueTime, std::string const& series,
+    util::optional<time> const& seriesValidTo)
+{
+    raw_data.assign(text.data(), text.size());
+    type = advisory_type::sigmet;
+    identifier.clear();
+    hazard = hazard_type::unknown;
+    valid_from = issueTime;
+    valid_to = seriesValidTo ? *seriesValidTo : time(0, 0, 0);
+    lower_altitude = util::nullopt;
+    upper_altitude = util::nullopt;
+    geometry = advisory_geometry::none;
+    width = 0;
+    points.clear();
+
+    std::vector<util::string_view> tokens;
+    split_tokens(text, tokens);
+    if (tokens.size() < 2)
+    {
+        return;
+    }
+
+    auto token = [&](size_t i)
+    {
+        return i < tokens.size() ? tokens[i] : util::string_view();
+    };
+
+    // Header: CONVECTIVE SIGMET 45C, SIGMET NOVEMBER 3, AIRMET TURB, EGTT SIGMET 3
+    if (tokens[0] == "CONVECTIVE" && tokens[1] == "SIGMET")
+    {
+        type = advisory_type::convective_sigmet;
+        identifier = token(2).to_string();
+        hazard = hazard_type::thunderstorm;
+    }
+    else if (tokens[0] == "SIGMET")
+    {
+        identifier = tokens[1].to_string();
+        if (are_digits(token(2), 0, token(2).size()) && !token(2).empty())
+        {
+            identifier += " " + tokens[2].to_string();
+        }
+    }
+    else if (tokens[0] == "AIRMET")
+    {
+        type = advisory_type::airmet;
+        identifier = series;
+        hazard = decode_hazard(tokens[1], token(2));
+    }
+    else if (tokens[1] == "SIGMET")
+    {
+        identifier = tokens[0].to_string() + " " + token(2).to_string();
+    }
+
+    bool altitudeFound = false;
+    for (size_t i = 0; i < tokens.size(); ++i)
+    {
+        auto const& current = tokens[i];
+
+        if (current == "VALID")
+        {
+            // VALID UNTIL 1955Z, VALID UNTIL 052200 or VALID 051200/051600
+            time from, to;
+            auto slash = token(i + 1).find('/');
+            if (token(i + 1) == "UNTIL" && decode_time(token(i + 2), issueTime, to))
+            {
+                valid_to = to;
+            }
+            else if (slash != util::string_view::npos &&
+                decode_time(token(i + 1).substr(0, slash), issueTime, from) &&
+                decode_time(token(i + 1).substr(slash + 1), issueTime, to))
+            {
+                valid_from = from;
+                valid_to = to;
+            }
+            continue;
+        }
+
+        if (hazard == hazard_type::unknown)
+        {
+            hazard = decode_hazard(current, token(i + 1));
+        }
+
+        if (!altitudeFound)
+        {
+            uint32_t lower, upper;
+            auto slash = current.find('/');
+            if (current == "BTN" && decode_altitude(token(i + 3), upper) && token(i + 2) == "AND")
+            {
+                if (decode_altitude(token(i + 1), lower))
+                {
+                    lower_altitude = lower;
+                }
+                upper_altitude = upper;
+                altitudeFound = true;
+            }
+            else if (current == "BLW" && decode_altitude(token(i + 1), upper))
+            {
+                lower_altitude = 0;
+                upper_altitude = upper;
+                altitudeFound = true;
+            }
+            else if (current == "ABV" && decode_altitude(token(i + 1), lower))
+            {
+                // TOPS ABV FL450 extends from the surface
+                lower_altitude = token(i - 1) == "TOPS" ? 0 : lower;
+                altitudeFound = true;
+            }
+            else if ((current == "TOPS" || current == "TOP") &&
+                (decode_altitude(token(i + 1), upper) || (token(i + 1) == "TO" && decode_altitude(token(i + 2), upper))))
+            {
+                lower_altitude = 0;
+                upper_altitude = upper;
+                altitudeFound = true;
+            }
+            else if (slash != util::string_view::npos &&
+                decode_altitude(current.substr(0, slash), lower) && decode_altitude(current.substr(slash + 1), upper))
+            {
+                lower_altitude = lower;
+                upper_altitude = upper;
+                altitudeFound = true;
+            }
+        }
+
+        if (points.empty() && (current == "FROM" || current == "WI"))
+        {
+            std::vector<util::string_view> atoms;
+            split_atoms(tokens, i + 1, atoms);
+            if (current == "FROM")
+            {
+                decode_navaid_points(atoms, points);
+            }
+            else
+            {
+                decode_coordinate_points(atoms, points);
+            }
+        }
+        else if (points.empty() && current == "ISOL" && type == advisory_type::convective_sigmet && i > 0)
+        {
+            // Isolated cells give their location without FROM: 20W OSW ISOL SEV TS D30
+            std::vector<util::string_view> atoms;
+            uint16_t distance;
+            double bearing;
+            if (i > 1 && decode_offset(tokens[i - 2], distance, bearing))
+            {
+                atoms.push_back(tokens[i - 2]);
+            }
+            atoms.push_back(tokens[i - 1]);
+            decode_navaid_points(atoms, points);
+        }
+        else if (current == "LINE")
+        {
+            geometry = advisory_geometry::line;
+        }
+        else if (current == "WIDE" && token(i - 1) == "NM" && are_digits(token(i - 2), 0, token(i - 2).size()) && !token(i - 2).empty())
+        {
+            width = static_cast<uint16_t>(to_number(token(i - 2), 0, token(i - 2).size()));
+        }
+        else if (current == "DIAM" && are_digits(token(i + 1), 0, token(i + 1).size()) && !token(i + 1).empty())
+        {
+            width = static_cast<uint16_t>(to_number(token(i + 1), 0, token(i + 1).size()));
+        }
+        else if (current.size() >= 2 && current.size() <= 4 && current[0] == 'D' && are_digits(current, 1, current.size() - 1))
+        {
+            // ISOL TS D20
+            width = static_cast<uint16_t>(to_number(current, 1, current.size() - 1));
+        }
+    }
+
+    // Closed areas repeat the first point at the end
+    if (points.size() > 1 && points.front() == points.back())
+    {
+        points.pop_back();
+    }
+
+    if (points.empty())
+    {
+        geometry = advisory_geometry::none;
+    }
+    else if (geometry != advisory_geometry::line)
+    {
+        geometry = points.size() < 3 ? advisory_geometry::line : advisory_geometry::area;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+std::vector<advisory> decode_advisories(std::string const& bulletin)
+{
+    std::vector<advisory> result;
+
+    util::optional<time> issueTime;
+    util::optional<time> seriesValidTo;
+    std::string series;
+    size_t start = util::string_view::npos;
+    size_t end = 0;
+
+    util::string_view text(bulletin);
+    auto flush = [&]()
+    {
+        if (start != util::string_view::npos)
+        {
+            advisory current;
+            current.parse(text.substr(start, end - start), issueTime, series, seriesValidTo);
+            result.push_back(std::move(current));
+        }
+        start = util::string_view::npos;
+    };
+
+    std::vector<util::string_view> tokens;
+    for_each_line(text, [&](util::string_view const& line)
+    {
+        auto const offset = static_cast<size_t>(line.data() - text.data());
+        tokens.clear();
+        split_tokens(line, tokens);
+        if (tokens.empty())
+        {
+            return;
+        }
+
+        // WSUS32 KKCI 051755, SLCT WA 051445
+        time header;
+        if (tokens.size() == 3 && is_letters(tokens[1], 2, 4) && tokens[2].size() == 6 && decode_time(tokens[2], util::nullopt, header))
+        {
+            issueTime = header;
+            return;
+        }
+
+        if (tokens[0] == "AIRMET" && tokens.size() > 1 && is_airmet_series(tokens[1]))
+        {
+            flush();
+            series = tokens[1].to_string();
+            seriesValidTo = util::nullopt;
+            for (size_t i = 0; i + 2 < tokens.size(); ++i)
+            {
+                time validTo;
+                if (tokens[i] == "VALID" && tokens[i + 1] == "UNTIL" && decode_time(tokens[i + 2], issueTime, validTo))
+                {
+                    seriesValidTo = validTo;
+                }
+            }
+            return;
+        }
+
+        bool isStart = (tokens[0] == "CONVECTIVE" && tokens.size() > 1 && tokens[1] == "SIGMET") ||
+            tokens[0] == "SIGMET" || tokens[0] == "AIRMET" ||
+            (tokens.size() > 1 && tokens[1] == "SIGMET" && is_letters(tokens[0], 4, 4));
+
+        if (isStart)
+        {
+            flush();
+            start = offset;
+        }
+        else if (tokens[0] == "OUTLOOK" || tokens[0] == "OTLK")
+        {
+            flush();
+            return;
+        }
+        end = offset + line.size();
+    });
+    flush();
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
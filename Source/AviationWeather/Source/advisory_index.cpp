@@ -0,0 +1,334 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/advisory_index.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "utility.h"
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const double degrees_to_radians = 3.14159265358979323846 / 180.0;
+
+geo_box empty_box()
+{
+    return { 90.0, 180.0, -90.0, -180.0 };
+}
+
+void expand(geo_box& box, geo_box const& other)
+{
+    box.min_latitude = (std::min)(box.min_latitude, other.min_latitude);
+    box.min_longitude = (std::min)(box.min_longitude, other.min_longitude);
+    box.max_latitude = (std::max)(box.max_latitude, other.max_latitude);
+    box.max_longitude = (std::max)(box.max_longitude, other.max_longitude);
+}
+
+void expand(geo_box& box, geo_point const& point)
+{
+    expand(box, geo_box{ point.latitude, point.longitude, point.latitude, point.longitude });
+}
+
+// Boxes of areas and segments across the antimeridian extend past 180
+// degrees either way, so the boxes are also compared a turn apart
+bool overlaps(geo_box const& a, geo_box const& b)
+{
+    if (a.min_latitude > b.max_latitude || b.min_latitude > a.max_latitude)
+    {
+        return false;
+    }
+
+    for (auto shift : { -360.0, 0.0, 360.0 })
+    {
+        if (a.min_longitude <= b.max_longitude + shift && b.min_longitude + shift <= a.max_longitude)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+double center_latitude(geo_box const& box)
+{
+    return (box.min_latitude + box.max_latitude) / 2.0;
+}
+
+double center_longitude(geo_box const& box)
+{
+    return (box.min_longitude + box.max_longitude) / 2.0;
+}
+
+// Longitudes are unwrapped around the first point, as the geometry tests do
+geo_box advisory_bounds(advisory const& item)
+{
+    auto box = empty_box();
+    auto reference = item.points[0].position->longitude;
+    for (auto const& point : item.points)
+    {
+        expand(box, geo_point{ point.position->latitude, unwrap_longitude(point.position->longitude, reference) });
+    }
+
+    // Lines cover half their width either side
+    if (item.geometry == advisory_geometry::line)
+    {
+        auto margin = item.width / 2.0 / 60.0;
+        auto latitude = (std::min)(89.0, (std::max)(std::abs(box.min_latitude), std::abs(box.max_latitude)) + margin);
+        auto scale = std::cos(latitude * degrees_to_radians);
+
+        box.min_latitude -= margin;
+        box.max_latitude += margin;
+        box.min_longitude -= margin / scale;
+        box.max_longitude += margin / scale;
+    }
+    return box;
+}
+
+// Orders items into runs of node_capacity by slicing on longitude and then
+// sorting each slice on latitude
+void sort_tile(std::vector<uint32_t>& order, std::vector<geo_box> const& bounds, size_t capacity)
+{
+    auto const count = order.size();
+    auto const nodes = (count + capacity - 1) / capacity;
+    auto const slices = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(nodes))));
+    auto const sliceSize = slices * capacity;
+
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+    {
+        return center_longitude(bounds[a]) < center_longitude(bounds[b]);
+    });
+    for (size_t start = 0; start < count; start += sliceSize)
+    {
+        auto end = (std::min)(count, start + sliceSize);
+        std::sort(order.begin() + start, order.begin() + end, [&](uint32_t a, uint32_t b)
+        {
+            return center_latitude(bounds[a]) < center_latitude(bounds[b]);
+        });
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+const size_t advisory_index::node_capacity;
+
+//-----------------------------------------------------------------------------
+
+advisory_index::advisory_index()
+{}
+
+advisory_index::advisory_index(std::vector<advisory> advisories)
+{
+    build(std::move(advisories));
+}
+
+advisory_index::advisory_index(advisory_index && other)
+{
+    *this = std::move(other);
+}
+
+advisory_index& advisory_index::operator=(advisory_index && rhs)
+{
+    if (this != &rhs)
+    {
+        m_advisories = std::move(rhs.m_advisories);
+        m_entryBounds = std::move(rhs.m_entryBounds);
+        m_entries = std::move(rhs.m_entries);
+        m_levels = std::move(rhs.m_levels);
+
+        rhs.m_advisories.clear();
+        rhs.m_entryBounds.clear();
+        rhs.m_entries.clear();
+        rhs.m_levels.clear();
+    }
+    return *this;
+}
+
+void advisory_index::build(std::vector<advisory> advisories)
+{
+    m_advisories = std::move(advisories);
+    m_entryBounds.clear();
+    m_entries.clear();
+    m_levels.clear();
+
+    std::vector<geo_box> bounds;
+    std::vector<uint32_t> order;
+    for (size_t i = 0; i < m_advisories.size(); ++i)
+    {
+        if (m_advisories[i].has_position())
+        {
+            order.push_back(static_cast<uint32_t>(bounds.size()));
+            bounds.push_back(advisory_bounds(m_advisories[i]));
+            m_entries.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    if (order.empty())
+    {
+        return;
+    }
+
+    sort_tile(order, bounds, node_capacity);
+
+    std::vector<uint32_t> entries(order.size());
+    m_entryBounds.resize(order.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        entries[i] = m_entries[order[i]];
+        m_entryBounds[i] = bounds[order[i]];
+    }
+    m_entries.swap(entries);
+
+    // Each level groups consecutive runs of the level below until one node remains
+    auto const* childBounds = &m_entryBounds;
+    std::vector<geo_box> levelBounds;
+    do
+    {
+        std::vector<node> level;
+        for (size_t first = 0; first < childBounds->size(); first += node_capacity)
+        {
+            auto count = (std::min)(node_capacity, childBounds->size() - first);
+            node current = { empty_box(), static_cast<uint32_t>(first), static_cast<uint32_t>(count) };
+            for (size_t i = first; i < first + count; ++i)
+            {
+                expand(current.bounds, (*childBounds)[i]);
+            }
+            level.push_back(current);
+        }
+
+        // Order the new level for the next one up, remapping the child ranges
+        std::vector<geo_box> nextBounds(level.size());
+        std::vector<uint32_t> nodeOrder(level.size());
+        for (size_t i = 0; i < level.size(); ++i)
+        {
+            nextBounds[i] = level[i].bounds;
+            nodeOrder[i] = static_cast<uint32_t>(i);
+        }
+        if (level.size() > 1)
+        {
+            sort_tile(nodeOrder, nextBounds, node_capacity);
+        }
+
+        std::vector<node> sorted(level.size());
+        for (size_t i = 0; i < level.size(); ++i)
+        {
+            sorted[i] = level[nodeOrder[i]];
+            nextBounds[i] = sorted[i].bounds;
+        }
+        m_levels.push_back(std::move(sorted));
+
+        levelBounds.swap(nextBounds);
+        childBounds = &levelBounds;
+    } while (m_levels.back().size() > 1);
+}
+
+std::vector<advisory> const& advisory_index::advisories() const
+{
+    return m_advisories;
+}
+
+size_t advisory_index::size() const
+{
+    return m_advisories.size();
+}
+
+template <typename TIntersects, typename TAccept>
+void advisory_index::search(TIntersects && intersects, TAccept && accept, std::vector<size_t>& results) const
+{
+    results.clear();
+    if (m_levels.empty())
+    {
+        return;
+    }
+
+    struct frame
+    {
+        size_t level;
+        size_t index;
+    };
+
+    std::vector<frame> stack;
+    stack.push_back({ m_levels.size() - 1, 0 });
+    while (!stack.empty())
+    {
+        auto current = stack.back();
+        stack.pop_back();
+
+        auto const& item = m_levels[current.level][current.index];
+        if (!intersects(item.bounds))
+        {
+            continue;
+        }
+        for (size_t i = item.first; i < item.first + item.count; ++i)
+        {
+            if (current.level > 0)
+            {
+                stack.push_back({ current.level - 1, i });
+            }
+            else if (intersects(m_entryBounds[i]) && accept(m_advisories[m_entries[i]]))
+            {
+                results.push_back(m_entries[i]);
+            }
+        }
+    }
+    std::sort(results.begin(), results.end());
+}
+
+void advisory_index::query(geo_point const& point, time const& at, std::vector<size_t>& results) const
+{
+    geo_box box = { point.latitude, point.longitude, point.latitude, point.longitude };
+    search([&](geo_box const& bounds)
+    {
+        return overlaps(bounds, box);
+    },
+    [&](advisory const& item)
+    {
+        return item.active(at) && item.contains(point);
+    }, results);
+}
+
+void advisory_index::query(geo_point const& from, geo_point const& to, time const& at, std::vector<size_t>& results) const
+{
+    auto box = empty_box();
+    expand(box, from);
+    expand(box, geo_point{ to.latitude, unwrap_longitude(to.longitude, from.longitude) });
+    search([&](geo_box const& bounds)
+    {
+        return overlaps(bounds, box);
+    },
+    [&](advisory const& item)
+    {
+        return item.active(at) && item.intersects(from, to);
+    }, results);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
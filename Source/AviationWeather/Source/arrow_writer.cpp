@@ -0,0 +1,913 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/arrow_writer.h>
+
+#include <AviationWeather/converters.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace aw
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+// Values from the Arrow format's Schema.fbs and Message.fbs
+const int16_t metadata_version_v5 = 4;
+const uint8_t header_schema = 1;
+const uint8_t header_record_batch = 3;
+const uint8_t type_int = 2;
+const uint8_t type_floating_point = 3;
+const uint8_t type_utf8 = 5;
+const uint8_t type_list = 12;
+const uint8_t type_struct = 13;
+const int16_t precision_double = 2;
+
+const uint32_t continuation_marker = 0xFFFFFFFF;
+
+// Buffers in the body, and messages in the stream, start on 8-byte boundaries
+const size_t arrow_alignment = 8;
+
+size_t padded(size_t size)
+{
+    return (size + arrow_alignment - 1) & ~(arrow_alignment - 1);
+}
+
+//-----------------------------------------------------------------------------
+
+// Builds a FlatBuffer back to front, as the FlatBuffers library does, so that
+// every object is written before the objects that refer to it. Positions are
+// counted from the end of the buffer, where the first object was written.
+class flatbuffer_builder
+{
+public:
+    flatbuffer_builder() :
+        m_size(0),
+        m_alignment(1),
+        m_tableStart(0),
+        m_fieldCount(0)
+    {}
+
+    void clear()
+    {
+        m_size = 0;
+        m_alignment = 1;
+    }
+
+    uint8_t const* data() const
+    {
+        return m_buffer.data() + m_buffer.size() - m_size;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    uint32_t create_string(const char* text)
+    {
+        auto length = strlen(text);
+        pre_align(length + 1, sizeof(uint32_t));
+        push_zeros(1);
+        push(text, length);
+        push_scalar(static_cast<uint32_t>(length));
+        return position();
+    }
+
+    uint32_t create_vector(uint32_t const* offsets, size_t count)
+    {
+        pre_align(count * sizeof(uint32_t), sizeof(uint32_t));
+        for (size_t i = count; i > 0; --i)
+        {
+            push_offset(offsets[i - 1]);
+        }
+        push_scalar(static_cast<uint32_t>(count));
+        return position();
+    }
+
+    // A vector of structs made of 64-bit fields
+    template <class TStruct>
+    uint32_t create_vector(TStruct const* values, size_t count)
+    {
+        pre_align(count * sizeof(TStruct), sizeof(uint32_t));
+        pre_align(count * sizeof(TStruct), sizeof(int64_t));
+        push(values, count * sizeof(TStruct));
+        push_scalar(static_cast<uint32_t>(count));
+        return position();
+    }
+
+    void start_table()
+    {
+        m_tableStart = m_size;
+        m_fieldCount = 0;
+    }
+
+    template <class T>
+    void add_scalar(uint16_t field, T value)
+    {
+        push_scalar(value);
+        add_field(field);
+    }
+
+    void add_offset(uint16_t field, uint32_t offset)
+    {
+        pre_align(sizeof(uint32_t), sizeof(uint32_t));
+        push_offset(offset);
+        add_field(field);
+    }
+
+    uint32_t end_table()
+    {
+        push_scalar(int32_t(0));
+        auto table = position();
+
+        // The vtable holds its own size, the table's size and the position of
+        // each field within the table
+        uint16_t count = 0;
+        std::array<uint16_t, maximum_fields> entries = {};
+        for (size_t i = 0; i < m_fieldCount; ++i)
+        {
+            auto const& field = m_fields[i];
+            entries[field.id] = static_cast<uint16_t>(table - field.position);
+            count = (std::max)(count, static_cast<uint16_t>(field.id + 1));
+        }
+        for (size_t i = count; i > 0; --i)
+        {
+            push_scalar(entries[i - 1]);
+        }
+        push_scalar(static_cast<uint16_t>(table - m_tableStart));
+        push_scalar(static_cast<uint16_t>(sizeof(uint16_t) * (count + 2)));
+
+        // The table starts with the distance back to its vtable
+        auto vtable = static_cast<int32_t>(position() - table);
+        memcpy(m_buffer.data() + m_buffer.size() - table, &vtable, sizeof(vtable));
+        return table;
+    }
+
+    void finish(uint32_t root)
+    {
+        pre_align(sizeof(uint32_t), m_alignment);
+        push_offset(root);
+    }
+
+private:
+    static const size_t maximum_fields = 8;
+
+    struct field_position
+    {
+        uint16_t id;
+        uint32_t position;
+    };
+
+    uint32_t position() const
+    {
+        return static_cast<uint32_t>(m_size);
+    }
+
+    void add_field(uint16_t id)
+    {
+        m_fields[m_fieldCount++] = field_position{ id, position() };
+    }
+
+    void push(void const* bytes, size_t size)
+    {
+        if (m_size + size > m_buffer.size())
+        {
+            std::vector<uint8_t> buffer((std::max)(m_buffer.size() * 2, m_size + size + 256));
+            if (m_size > 0)
+            {
+                memcpy(buffer.data() + buffer.size() - m_size, data(), m_size);
+            }
+            m_buffer.swap(buffer);
+        }
+        m_size += size;
+        memcpy(m_buffer.data() + m_buffer.size() - m_size, bytes, size);
+    }
+
+    void push_zeros(size_t count)
+    {
+        static const uint8_t zeros[arrow_alignment] = {};
+        push(zeros, count);
+    }
+
+    template <class T>
+    void push_scalar(T value)
+    {
+        pre_align(sizeof(T), sizeof(T));
+        push(&value, sizeof(T));
+    }
+
+    // Refers to an object from the position about to be written
+    void push_offset(uint32_t target)
+    {
+        auto offset = position() + static_cast<uint32_t>(sizeof(uint32_t)) - target;
+        push(&offset, sizeof(offset));
+    }
+
+    // Pads so that size bytes written next end on an alignment boundary
+    void pre_align(size_t size, size_t alignment)
+    {
+        m_alignment = (std::max)(m_alignment, alignment);
+        push_zeros((~(m_size + size) + 1) & (alignment - 1));
+    }
+
+private:
+    std::vector<uint8_t>                         m_buffer;
+    size_t                                       m_size;
+    size_t                                       m_alignment;
+    size_t                                       m_tableStart;
+    std::array<field_position, maximum_fields>   m_fields;
+    size_t                                       m_fieldCount;
+};
+
+//-----------------------------------------------------------------------------
+
+enum class column_type
+{
+    int8,
+    uint8,
+    uint16,
+    uint32,
+    float64,
+    utf8,
+    list,
+    structure
+};
+
+struct column_definition
+{
+    const char* name;
+    column_type type;
+    bool        nullable;
+    int         parent;     // Index of the list or struct holding the column
+};
+
+// Every column in depth-first order, which is the order of the nodes and
+// buffers in a record batch
+const column_definition column_definitions[] =
+{
+    { "raw_text",                column_type::utf8,      false, -1 },
+    { "report_type",             column_type::uint8,     false, -1 },
+    { "station",                 column_type::utf8,      false, -1 },
+    { "observation_day",         column_type::uint8,     false, -1 },
+    { "observation_hour",        column_type::uint8,     false, -1 },
+    { "observation_minute",      column_type::uint8,     false, -1 },
+    { "modifier",                column_type::uint8,     false, -1 },
+    { "wind_direction",          column_type::uint16,    true,  -1 },
+    { "wind_speed",              column_type::uint8,     true,  -1 },
+    { "wind_gust",               column_type::uint8,     true,  -1 },
+    { "wind_unit",               column_type::uint8,     true,  -1 },
+    { "wind_variation_lower",    column_type::uint16,    true,  -1 },
+    { "wind_variation_upper",    column_type::uint16,    true,  -1 },
+    { "visibility",              column_type::float64,   true,  -1 },
+    { "visibility_unit",         column_type::uint8,     true,  -1 },
+    { "visibility_modifier",     column_type::uint8,     true,  -1 },
+    { "runway_visual_range",     column_type::list,      false, -1 },
+    { "item",                    column_type::structure, false, 16 },
+    { "runway_number",           column_type::uint8,     false, 17 },
+    { "runway_designator",       column_type::uint8,     false, 17 },
+    { "unit",                    column_type::uint8,     false, 17 },
+    { "visibility_min",          column_type::float64,   false, 17 },
+    { "visibility_min_modifier", column_type::uint8,     false, 17 },
+    { "visibility_max",          column_type::float64,   false, 17 },
+    { "visibility_max_modifier", column_type::uint8,     false, 17 },
+    { "tendency",                column_type::uint8,     false, 17 },
+    { "weather",                 column_type::list,      false, -1 },
+    { "item",                    column_type::structure, false, 26 },
+    { "intensity",               column_type::uint8,     false, 27 },
+    { "descriptor",              column_type::uint8,     false, 27 },
+    { "phenomena",               column_type::list,      false, 27 },
+    { "item",                    column_type::uint8,     false, 30 },
+    { "sky_condition",           column_type::list,      false, -1 },
+    { "item",                    column_type::structure, false, 32 },
+    { "sky_cover",               column_type::uint8,     false, 33 },
+    { "layer_height",            column_type::uint32,    true,  33 },
+    { "cloud_type",              column_type::uint8,     false, 33 },
+    { "temperature",             column_type::int8,      true,  -1 },
+    { "dewpoint",                column_type::int8,      true,  -1 },
+    { "altimeter",               column_type::float64,   true,  -1 },
+    { "altimeter_unit",          column_type::uint8,     true,  -1 },
+    { "remarks",                 column_type::utf8,      false, -1 }
+};
+
+// Indices into column_definitions
+enum column_index
+{
+    raw_text_column,
+    report_type_column,
+    station_column,
+    observation_day_column,
+    observation_hour_column,
+    observation_minute_column,
+    modifier_column,
+    wind_direction_column,
+    wind_speed_column,
+    wind_gust_column,
+    wind_unit_column,
+    wind_variation_lower_column,
+    wind_variation_upper_column,
+    visibility_column,
+    visibility_unit_column,
+    visibility_modifier_column,
+    rvr_column,
+    rvr_item_column,
+    rvr_runway_number_column,
+    rvr_runway_designator_column,
+    rvr_unit_column,
+    rvr_visibility_min_column,
+    rvr_visibility_min_modifier_column,
+    rvr_visibility_max_column,
+    rvr_visibility_max_modifier_column,
+    rvr_tendency_column,
+    weather_column,
+    weather_item_column,
+    weather_intensity_column,
+    weather_descriptor_column,
+    weather_phenomena_column,
+    weather_phenomena_item_column,
+    sky_condition_column,
+    sky_condition_item_column,
+    sky_cover_column,
+    layer_height_column,
+    cloud_type_column,
+    temperature_column,
+    dewpoint_column,
+    altimeter_column,
+    altimeter_unit_column,
+    remarks_column,
+    column_count
+};
+
+static_assert(column_count == sizeof(column_definitions) / sizeof(column_definitions[0]),
+    "Every column needs an index");
+
+//-----------------------------------------------------------------------------
+
+// The values of one column in a batch. The validity bitmap is only built
+// once a null is appended, as Arrow lets columns without nulls leave it out.
+class column_data
+{
+public:
+    column_data() :
+        m_length(0),
+        m_nullCount(0)
+    {
+        m_offsets.push_back(0);
+    }
+
+    void clear()
+    {
+        m_length = 0;
+        m_nullCount = 0;
+        m_validity.clear();
+        m_values.clear();
+        m_offsets.resize(1);
+    }
+
+    size_t length() const
+    {
+        return m_length;
+    }
+
+    size_t null_count() const
+    {
+        return m_nullCount;
+    }
+
+    std::vector<uint8_t> const& validity() const
+    {
+        return m_validity;
+    }
+
+    std::vector<uint8_t> const& values() const
+    {
+        return m_values;
+    }
+
+    std::vector<int32_t> const& offsets() const
+    {
+        return m_offsets;
+    }
+
+    template <class T>
+    void append(T value)
+    {
+        auto size = m_values.size();
+        m_values.resize(size + sizeof(T));
+        memcpy(m_values.data() + size, &value, sizeof(T));
+        mark_valid();
+    }
+
+    template <class T>
+    void append_null()
+    {
+        m_values.resize(m_values.size() + sizeof(T));
+        mark_null();
+    }
+
+    template <class T, class TValue>
+    void append(util::optional<TValue> const& value)
+    {
+        if (value)
+        {
+            append(static_cast<T>(*value));
+        }
+        else
+        {
+            append_null<T>();
+        }
+    }
+
+    void append_text(const char* text, size_t size)
+    {
+        m_values.insert(m_values.end(), text, text + size);
+        m_offsets.push_back(static_cast<int32_t>(m_values.size()));
+        mark_valid();
+    }
+
+    // Ends a list holding the items of the child column appended since the
+    // last list
+    void append_list(column_data const& items)
+    {
+        m_offsets.push_back(static_cast<int32_t>(items.length()));
+        mark_valid();
+    }
+
+    void append_struct()
+    {
+        mark_valid();
+    }
+
+private:
+    void mark_valid()
+    {
+        if (m_nullCount != 0)
+        {
+            set_bit(true);
+        }
+        ++m_length;
+    }
+
+    void mark_null()
+    {
+        if (m_nullCount == 0)
+        {
+            m_validity.assign((m_length + 7) / 8, 0xFF);
+        }
+        set_bit(false);
+        ++m_nullCount;
+        ++m_length;
+    }
+
+    void set_bit(bool valid)
+    {
+        auto index = m_length / 8;
+        if (index == m_validity.size())
+        {
+            m_validity.push_back(0);
+        }
+
+        auto mask = static_cast<uint8_t>(1u << (m_length % 8));
+        if (valid)
+        {
+            m_validity[index] |= mask;
+        }
+        else
+        {
+            m_validity[index] &= static_cast<uint8_t>(~mask);
+        }
+    }
+
+private:
+    size_t               m_length;
+    size_t               m_nullCount;
+    std::vector<uint8_t> m_validity;
+    std::vector<uint8_t> m_values;    // Fixed-width values, or the bytes of text
+    std::vector<int32_t> m_offsets;   // Ends of each text or list, after a leading 0
+};
+
+//-----------------------------------------------------------------------------
+
+// FieldNode and Buffer structs of a RecordBatch message
+struct field_node
+{
+    int64_t length;
+    int64_t null_count;
+};
+
+struct buffer_span
+{
+    int64_t offset;
+    int64_t length;
+};
+
+void append_bytes(std::vector<uint8_t>& buffer, void const* data, size_t size)
+{
+    auto bytes = static_cast<uint8_t const*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+// Pads the stream, which starts at start, to the next 8-byte boundary
+void append_padding(std::vector<uint8_t>& buffer, size_t start)
+{
+    buffer.resize(start + padded(buffer.size() - start));
+}
+
+// Appends an encapsulated message: the continuation marker, the size of the
+// padded metadata, the metadata itself and the body that follows
+void append_message(std::vector<uint8_t>& buffer, size_t start, flatbuffer_builder const& metadata)
+{
+    auto size = static_cast<int32_t>(padded(metadata.size()));
+    append_bytes(buffer, &continuation_marker, sizeof(continuation_marker));
+    append_bytes(buffer, &size, sizeof(size));
+    append_bytes(buffer, metadata.data(), metadata.size());
+    append_padding(buffer, start);
+}
+
+uint32_t create_message(flatbuffer_builder& builder, uint8_t headerType, uint32_t header, int64_t bodyLength)
+{
+    builder.start_table();
+    builder.add_scalar(3, bodyLength);
+    builder.add_offset(2, header);
+    builder.add_scalar(0, metadata_version_v5);
+    builder.add_scalar(1, headerType);
+    return builder.end_table();
+}
+
+// The Type table of a column, which is empty for all but numbers
+uint32_t create_type(flatbuffer_builder& builder, column_type type, uint8_t& typeType)
+{
+    builder.start_table();
+    switch (type)
+    {
+    case column_type::float64:
+        typeType = type_floating_point;
+        builder.add_scalar(0, precision_double);
+        break;
+    case column_type::utf8:
+        typeType = type_utf8;
+        break;
+    case column_type::list:
+        typeType = type_list;
+        break;
+    case column_type::structure:
+        typeType = type_struct;
+        break;
+    default:
+        typeType = type_int;
+        builder.add_scalar(0, static_cast<int32_t>(type == column_type::uint32 ? 32 : type == column_type::uint16 ? 16 : 8));
+        builder.add_scalar(1, static_cast<uint8_t>(type == column_type::int8));
+        break;
+    }
+    return builder.end_table();
+}
+
+uint32_t create_field(flatbuffer_builder& builder, int index)
+{
+    std::vector<uint32_t> children;
+    for (int i = index + 1; i < column_count; ++i)
+    {
+        if (column_definitions[i].parent == index)
+        {
+            children.push_back(create_field(builder, i));
+        }
+    }
+
+    auto const& definition = column_definitions[index];
+    auto childVector = builder.create_vector(children.data(), children.size());
+    auto name = builder.create_string(definition.name);
+    uint8_t typeType = 0;
+    auto type = create_type(builder, definition.type, typeType);
+
+    builder.start_table();
+    builder.add_offset(0, name);
+    builder.add_offset(3, type);
+    builder.add_offset(5, childVector);
+    builder.add_scalar(1, static_cast<uint8_t>(definition.nullable));
+    builder.add_scalar(2, typeType);
+    return builder.end_table();
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+class arrow_writer::batch
+{
+public:
+    batch() :
+        m_columns(column_count)
+    {}
+
+    void write_schema(std::vector<uint8_t>& buffer, size_t start)
+    {
+        std::vector<uint32_t> fields;
+        for (int i = 0; i < column_count; ++i)
+        {
+            if (column_definitions[i].parent < 0)
+            {
+                fields.push_back(create_field(m_builder, i));
+            }
+        }
+
+        auto fieldVector = m_builder.create_vector(fields.data(), fields.size());
+        m_builder.start_table();
+        m_builder.add_offset(1, fieldVector);
+        m_builder.add_scalar(0, int16_t(0));    // Little endian
+        auto schema = m_builder.end_table();
+
+        m_builder.finish(create_message(m_builder, header_schema, schema, 0));
+        append_message(buffer, start, m_builder);
+    }
+
+    template <class TReport>
+    void write(TReport const* reports, size_t count, std::vector<uint8_t>& buffer, size_t start)
+    {
+        for (auto& column : m_columns)
+        {
+            column.clear();
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            append(reports[i]);
+        }
+
+        // The nodes and buffers of every column, in the order of the schema
+        m_nodes.clear();
+        m_spans.clear();
+        int64_t bodyLength = 0;
+        auto addSpan = [&](size_t size)
+        {
+            m_spans.push_back(buffer_span{ bodyLength, static_cast<int64_t>(size) });
+            bodyLength += static_cast<int64_t>(padded(size));
+        };
+
+        for (size_t i = 0; i < column_count; ++i)
+        {
+            auto const& column = m_columns[i];
+            m_nodes.push_back(field_node{ static_cast<int64_t>(column.length()), static_cast<int64_t>(column.null_count()) });
+            addSpan(column.validity().size());
+
+            auto type = column_definitions[i].type;
+            if (type == column_type::utf8 || type == column_type::list)
+            {
+                addSpan(column.offsets().size() * sizeof(int32_t));
+            }
+            if (type != column_type::list && type != column_type::structure)
+            {
+                addSpan(column.values().size());
+            }
+        }
+
+        m_builder.clear();
+        auto spans = m_builder.create_vector(m_spans.data(), m_spans.size());
+        auto nodes = m_builder.create_vector(m_nodes.data(), m_nodes.size());
+        m_builder.start_table();
+        m_builder.add_scalar(0, static_cast<int64_t>(count));
+        m_builder.add_offset(1, nodes);
+        m_builder.add_offset(2, spans);
+        auto recordBatch = m_builder.end_table();
+
+        m_builder.finish(create_message(m_builder, header_record_batch, recordBatch, bodyLength));
+        append_message(buffer, start, m_builder);
+
+        buffer.reserve(buffer.size() + static_cast<size_t>(bodyLength));
+        for (size_t i = 0; i < column_count; ++i)
+        {
+            auto const& column = m_columns[i];
+            append_body(buffer, start, column.validity().data(), column.validity().size());
+
+            auto type = column_definitions[i].type;
+            if (type == column_type::utf8 || type == column_type::list)
+            {
+                append_body(buffer, start, column.offsets().data(), column.offsets().size() * sizeof(int32_t));
+            }
+            if (type != column_type::list && type != column_type::structure)
+            {
+                append_body(buffer, start, column.values().data(), column.values().size());
+            }
+        }
+    }
+
+private:
+    static void append_body(std::vector<uint8_t>& buffer, size_t start, void const* data, size_t size)
+    {
+        append_bytes(buffer, data, size);
+        append_padding(buffer, start);
+    }
+
+    template <class TReport>
+    void append(TReport const& report)
+    {
+        auto& c = m_columns;
+
+        c[raw_text_column].append_text(report.raw_data.data(), report.raw_data.size());
+        c[report_type_column].append(static_cast<uint8_t>(report.type));
+        c[station_column].append_text(report.identifier.data(), report.identifier.size());
+        c[observation_day_column].append(report.observation_time.day_of_month);
+        c[observation_hour_column].append(report.observation_time.hour_of_day);
+        c[observation_minute_column].append(report.observation_time.minute_of_hour);
+        c[modifier_column].append(static_cast<uint8_t>(report.modifier));
+
+        if (report.wind_group)
+        {
+            auto const& wind = *report.wind_group;
+            if (wind.direction == UINT16_MAX)
+            {
+                c[wind_direction_column].append_null<uint16_t>();
+            }
+            else
+            {
+                c[wind_direction_column].append(wind.direction);
+            }
+            c[wind_speed_column].append(wind.wind_speed);
+            if (wind.gust_speed > 0)
+            {
+                c[wind_gust_column].append(wind.gust_speed);
+            }
+            else
+            {
+                c[wind_gust_column].append_null<uint8_t>();
+            }
+            c[wind_unit_column].append(static_cast<uint8_t>(wind.unit));
+            c[wind_variation_lower_column].append<uint16_t>(wind.variation_lower);
+            c[wind_variation_upper_column].append<uint16_t>(wind.variation_upper);
+        }
+        else
+        {
+            c[wind_direction_column].append_null<uint16_t>();
+            c[wind_speed_column].append_null<uint8_t>();
+            c[wind_gust_column].append_null<uint8_t>();
+            c[wind_unit_column].append_null<uint8_t>();
+            c[wind_variation_lower_column].append_null<uint16_t>();
+            c[wind_variation_upper_column].append_null<uint16_t>();
+        }
+
+        if (report.visibility_group)
+        {
+            auto const& visibility = *report.visibility_group;
+            c[visibility_column].append(visibility.distance);
+            c[visibility_unit_column].append(static_cast<uint8_t>(visibility.unit));
+            c[visibility_modifier_column].append(static_cast<uint8_t>(visibility.modifier));
+        }
+        else
+        {
+            c[visibility_column].append_null<double>();
+            c[visibility_unit_column].append_null<uint8_t>();
+            c[visibility_modifier_column].append_null<uint8_t>();
+        }
+
+        for (auto const& rvr : report.runway_visual_range_group)
+        {
+            c[rvr_item_column].append_struct();
+            c[rvr_runway_number_column].append(rvr.runway_number);
+            c[rvr_runway_designator_column].append(static_cast<uint8_t>(rvr.runway_designator));
+            c[rvr_unit_column].append(static_cast<uint8_t>(rvr.visibility_min.unit));
+            c[rvr_visibility_min_column].append(rvr.visibility_min.distance);
+            c[rvr_visibility_min_modifier_column].append(static_cast<uint8_t>(rvr.visibility_min.modifier));
+            c[rvr_visibility_max_column].append(rvr.visibility_max.distance);
+            c[rvr_visibility_max_modifier_column].append(static_cast<uint8_t>(rvr.visibility_max.modifier));
+            c[rvr_tendency_column].append(static_cast<uint8_t>(rvr.tendency));
+        }
+        c[rvr_column].append_list(c[rvr_item_column]);
+
+        for (auto const& weather : report.weather_group)
+        {
+            c[weather_item_column].append_struct();
+            c[weather_intensity_column].append(static_cast<uint8_t>(weather.intensity));
+            c[weather_descriptor_column].append(static_cast<uint8_t>(weather.descriptor));
+            for (auto phenomena : weather.phenomena)
+            {
+                c[weather_phenomena_item_column].append(static_cast<uint8_t>(phenomena));
+            }
+            c[weather_phenomena_column].append_list(c[weather_phenomena_item_column]);
+        }
+        c[weather_column].append_list(c[weather_item_column]);
+
+        for (auto const& layer : report.sky_condition_group)
+        {
+            c[sky_condition_item_column].append_struct();
+            c[sky_cover_column].append(static_cast<uint8_t>(layer.sky_cover));
+            if (layer.is_unlimited())
+            {
+                c[layer_height_column].append_null<uint32_t>();
+            }
+            else if (layer.unit == distance_unit::feet)
+            {
+                c[layer_height_column].append(layer.layer_height);
+            }
+            else
+            {
+                c[layer_height_column].append(convert<uint32_t>(layer.layer_height, layer.unit, distance_unit::feet));
+            }
+            c[cloud_type_column].append(static_cast<uint8_t>(layer.cloud_type));
+        }
+        c[sky_condition_column].append_list(c[sky_condition_item_column]);
+
+        c[temperature_column].append<int8_t>(report.temperature);
+        c[dewpoint_column].append<int8_t>(report.dewpoint);
+
+        if (report.altimeter_group)
+        {
+            c[altimeter_column].append(report.altimeter_group->pressure);
+            c[altimeter_unit_column].append(static_cast<uint8_t>(report.altimeter_group->unit));
+        }
+        else
+        {
+            c[altimeter_column].append_null<double>();
+            c[altimeter_unit_column].append_null<uint8_t>();
+        }
+
+        c[remarks_column].append_text(report.remarks.data(), report.remarks.size());
+    }
+
+private:
+    std::vector<column_data> m_columns;
+    flatbuffer_builder       m_builder;
+    std::vector<field_node>  m_nodes;
+    std::vector<buffer_span> m_spans;
+};
+
+//-----------------------------------------------------------------------------
+
+arrow_writer::arrow_writer(std::vector<uint8_t>& buffer) :
+    m_buffer(buffer),
+    m_start(buffer.size()),
+    m_batch(new batch()),
+    m_closed(false)
+{
+    m_batch->write_schema(m_buffer, m_start);
+}
+
+arrow_writer::~arrow_writer()
+{}
+
+void arrow_writer::write(metar const* reports, size_t count)
+{
+    if (m_closed)
+    {
+        throw aw_exception("Arrow stream is closed");
+    }
+    m_batch->write(reports, count, m_buffer, m_start);
+}
+
+void arrow_writer::write(metar_view const* reports, size_t count)
+{
+    if (m_closed)
+    {
+        throw aw_exception("Arrow stream is closed");
+    }
+    m_batch->write(reports, count, m_buffer, m_start);
+}
+
+void arrow_writer::write(std::vector<metar> const& reports)
+{
+    write(reports.data(), reports.size());
+}
+
+void arrow_writer::close()
+{
+    if (!m_closed)
+    {
+        const uint32_t end[] = { continuation_marker, 0 };
+        append_bytes(m_buffer, end, sizeof(end));
+        m_closed = true;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void write_arrow(std::vector<metar> const& reports, std::vector<uint8_t>& buffer, size_t batchSize)
+{
+    arrow_writer writer(buffer);
+    batchSize = (std::max)(batchSize, size_t(1));
+    for (size_t i = 0; i < reports.size(); i += batchSize)
+    {
+        writer.write(reports.data() + i, (std::min)(batchSize, reports.size() - i));
+    }
+    writer.close();
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -0,0 +1,260 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <AviationWeather/components.h>
+#include <AviationWeather/metar.h>
+#include <AviationWeather/optional.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// Primitive encodings of the binary report format. Integers are unsigned
+// LEB128 varints, with signed values zigzag encoded first, so the encoding
+// does not depend on the byte order of the machine. Doubles that are exact
+// multiples of a unit's natural resolution are stored as scaled varints;
+// anything else falls back to the IEEE 754 bits in little-endian order.
+class binary_writer
+{
+public:
+    explicit binary_writer(std::vector<uint8_t>& buffer);
+
+    binary_writer(binary_writer const&) = delete;
+    binary_writer& operator= (binary_writer const&) = delete;
+
+    void write_byte(uint8_t value);
+    void write_varint(uint64_t value);
+    void write_signed(int64_t value);
+    void write_fixed(uint64_t value);
+    void write_double(double value);
+    void write_string(std::string const& value);
+
+    // Writes the value as a varint of value * scale when that is exact
+    void write_scaled(double value, double scale);
+
+    void write(time const& value);
+    void write(wind const& value);
+    void write(visibility const& value);
+    void write(directional_visibility const& value);
+    void write(runway_visual_range const& value);
+    void write(weather const& value);
+    void write(cloud_layer const& value);
+    void write(altimeter const& value);
+    void write(runway_wind_shear const& value);
+    void write(metar_trend const& value);
+    void write(metar const& value, bool includeText);
+
+    template <class T>
+    void write(std::vector<T> const& values)
+    {
+        write_varint(values.size());
+        for (auto const& value : values)
+        {
+            write(value);
+        }
+    }
+
+private:
+    std::vector<uint8_t>& m_buffer;
+};
+
+//-----------------------------------------------------------------------------
+
+// Buffers of the weather groups dropped when a report is read over an
+// earlier one with more of them. New groups take them over instead of
+// allocating their own.
+struct binary_spares
+{
+    std::vector<std::vector<weather_phenomena>> phenomena;
+};
+
+// Reads what binary_writer writes. Throws aw_exception if the input ends
+// early or holds values that no writer produces.
+class binary_reader
+{
+public:
+    binary_reader(uint8_t const* data, size_t size, binary_spares* spares = nullptr);
+
+    binary_reader(binary_reader const&) = delete;
+    binary_reader& operator= (binary_reader const&) = delete;
+
+    size_t remaining() const;
+    uint8_t const* position() const;
+    void skip(size_t count);
+
+    // The common cases are inline, since reports are made of little else
+    uint8_t read_byte()
+    {
+        if (m_position == m_end)
+        {
+            throw_truncated();
+        }
+        return *m_position++;
+    }
+
+    // Nearly every value takes three bytes or fewer
+    uint64_t read_varint()
+    {
+        if (m_end - m_position >= 3)
+        {
+            uint64_t value = m_position[0];
+            if (value < 0x80)
+            {
+                m_position += 1;
+                return value;
+            }
+            value = (value & 0x7F) | (static_cast<uint64_t>(m_position[1]) << 7);
+            if (m_position[1] < 0x80)
+            {
+                m_position += 2;
+                return value;
+            }
+            value = (value & 0x3FFF) | (static_cast<uint64_t>(m_position[2]) << 14);
+            if (m_position[2] < 0x80)
+            {
+                m_position += 3;
+                return value;
+            }
+        }
+        return read_long_varint();
+    }
+
+    int64_t read_signed();
+    uint64_t read_fixed();
+    double read_double();
+    void read_string(std::string& value);
+    void read_string(util::string_view& value);
+    double read_scaled(double scale);
+
+    // Enumerations are checked against their last value
+    template <class TEnum>
+    TEnum read_enum(uint64_t value, TEnum last)
+    {
+        if (value > static_cast<uint64_t>(last))
+        {
+            throw aw_exception("Invalid value in binary report");
+        }
+        return static_cast<TEnum>(value);
+    }
+
+    void read(time& value);
+    void read(wind& value);
+    void read(visibility& value);
+    void read(directional_visibility& value);
+    void read(runway_visual_range& value);
+    void read(weather& value);
+    void read(cloud_layer& value);
+    void read(altimeter& value);
+    void read(runway_wind_shear& value);
+    void read(metar_trend& value);
+
+    // Reads a length-prefixed report into a copy of empty_metar()
+    void read(metar& value);
+    static metar const& empty_metar();
+
+    // Reads a length-prefixed report over whatever value held before, reusing
+    // its lists. The text fields refer into the data being read.
+    void read(metar_view& value);
+
+    template <class T>
+    void read(std::vector<T>& values)
+    {
+        auto count = read_varint();
+        if (count > remaining())
+        {
+            throw aw_exception("Truncated binary report");
+        }
+
+        read_list(values, static_cast<size_t>(count), std::is_trivially_destructible<T>());
+    }
+
+    // Resizes a list that is about to be read over
+    template <class T>
+    void resize_list(std::vector<T>& values, size_t count)
+    {
+        values.resize(count);
+    }
+
+    void resize_list(std::vector<weather>& values, size_t count)
+    {
+        if (m_spares == nullptr)
+        {
+            values.resize(count);
+            return;
+        }
+
+        auto& spares = m_spares->phenomena;
+        for (size_t i = count; i < values.size(); ++i)
+        {
+            spares.push_back(std::move(values[i].phenomena));
+        }
+
+        auto size = values.size();
+        values.resize(count);
+        for (size_t i = size; i < count && !spares.empty(); ++i)
+        {
+            values[i].phenomena = std::move(spares.back());
+            spares.pop_back();
+        }
+    }
+
+private:
+    // Lists of plain values are rebuilt from one element, which is cheaper
+    // than default constructing each new one. Elements that own memory are
+    // read in place, keeping their buffers.
+    template <class T>
+    void read_list(std::vector<T>& values, size_t count, std::true_type)
+    {
+        values.clear();
+        T value;
+        for (size_t i = 0; i < count; ++i)
+        {
+            read(value);
+            values.push_back(value);
+        }
+    }
+
+    template <class T>
+    void read_list(std::vector<T>& values, size_t count, std::false_type)
+    {
+        resize_list(values, count);
+        for (auto& value : values)
+        {
+            read(value);
+        }
+    }
+
+    [[noreturn]] static void throw_truncated();
+    uint64_t read_long_varint();
+
+    template <class TReport>
+    void read_report(TReport& value);
+
+    uint8_t const* m_position;
+    uint8_t const* m_end;
+    binary_spares* m_spares;
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -15,6 +15,8 @@
 
 #include "AviationWeatherPch.h"
 
+#include <cmath>
+
 #include <AviationWeather/components.h>
 #include <AviationWeather/converters.h>
 
@@ -22,6 +24,38 @@
 
 namespace aw
 {
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const double degrees_to_radians = 3.14159265358979323846 / 180.0;
+
+//-----------------------------------------------------------------------------
+
+// Converting to local time reloads the time zone rules on every call, and
+// every default-constructed report asks for the current time, so each
+// thread keeps its last conversion. Within a second the answer is the same.
+errno_t cached_localtime(struct tm* result, time_t const* value)
+{
+    thread_local time_t lastTime = 0;
+    thread_local struct tm lastResult = {};
+    thread_local errno_t lastError = EINVAL;
+    thread_local bool valid = false;
+
+    if (!valid || lastTime != *value)
+    {
+        lastError = localtime_s(&lastResult, value);
+        lastTime = *value;
+        valid = true;
+    }
+    *result = lastResult;
+    return lastError;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
 
 //-----------------------------------------------------------------------------
 
@@ -41,7 +75,7 @@ time::time(time_t time) :
     minute_of_hour(0)
 {
     struct tm t;
-    auto result = localtime_s(&t, &time);
+    auto result = cached_localtime(&t, &time);
 
     if (result != EINVAL)
     {
@@ -156,12 +190,22 @@ uint8_t wind::gust_factor() const
 
 double wind::headwind_component(double heading, bool useGusts) const
 {
-    return (useGusts ? gust_speed : wind_speed) * cos(direction - heading);
+    if (direction == UINT16_MAX)
+    {
+        return 0.0;
+    }
+    auto speed = useGusts && gust_speed > 0 ? gust_speed : wind_speed;
+    return speed * std::cos((direction - heading) * degrees_to_radians);
 }
 
 double wind::crosswind_component(double heading, bool useGusts) const
 {
-    return (useGusts ? gust_speed : wind_speed) * sin(direction - heading);
+    if (direction == UINT16_MAX)
+    {
+        return 0.0;
+    }
+    auto speed = useGusts && gust_speed > 0 ? gust_speed : wind_speed;
+    return speed * std::sin((direction - heading) * degrees_to_radians);
 }
 
 //-----------------------------------------------------------------------------
@@ -16,8 +16,13 @@
 #include "AviationWeatherPch.h"
 
 #include <AviationWeather/converters.h>
+
+#include <algorithm>
+
 #include <AviationWeather/types.h>
 
+#include "simd.h"
+
 namespace aw
 {
 namespace detail
@@ -43,6 +48,15 @@ std::array<double, PRESSURE_UNIT_VALUES * PRESSURE_UNIT_VALUES> pressure_unit_co
     1.0 / 33.86389  , 1.0        /* inHg */
 };
 
+#define SPEED_UNIT_VALUES 3
+std::array<double, SPEED_UNIT_VALUES * SPEED_UNIT_VALUES> speed_unit_conversion_ratio_table =
+{
+    /*      kt       */ /*       mph        */ /*      mps       */
+    1.0               , 1609.344 / 1852.0   , 3600.0 / 1852.0    , /* kt  */
+    1852.0 / 1609.344 , 1.0                 , 3600.0 / 1609.344  , /* mph */
+    1852.0 / 3600.0   , 1609.344 / 3600.0   , 1.0                  /* mps */
+};
+
 //-----------------------------------------------------------------------------
 
 double lookup_ratio(distance_unit from, distance_unit to)
@@ -59,5 +73,96 @@ double lookup_ratio(pressure_unit from, pressure_unit to)
 
 //-----------------------------------------------------------------------------
 
+double lookup_ratio(speed_unit from, speed_unit to)
+{
+    return speed_unit_conversion_ratio_table[(SPEED_UNIT_VALUES * static_cast<size_t>(to)) + static_cast<size_t>(from)];
+}
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+// Runtime units only choose the ratio; the loop is the same for every unit
+void scale_values(double const* values, size_t count, double ratio, double* results)
+{
+    size_t i = 0;
+#if defined(AW_SSE2)
+    auto factor = _mm_set1_pd(ratio);
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_pd(results + i, _mm_mul_pd(_mm_loadu_pd(values + i), factor));
+        _mm_storeu_pd(results + i + 2, _mm_mul_pd(_mm_loadu_pd(values + i + 2), factor));
+    }
+#endif
+    scale(values + i, count - i, ratio, results + i);
+}
+
+void scale_values(float const* values, size_t count, double ratio, float* results)
+{
+    size_t i = 0;
+#if defined(AW_SSE2)
+    auto factor = _mm_set1_ps(static_cast<float>(ratio));
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm_storeu_ps(results + i, _mm_mul_ps(_mm_loadu_ps(values + i), factor));
+        _mm_storeu_ps(results + i + 4, _mm_mul_ps(_mm_loadu_ps(values + i + 4), factor));
+    }
+#endif
+    scale(values + i, count - i, ratio, results + i);
+}
+
+template <class TValue, class TUnit>
+void convert_values(TValue const* values, size_t count, TUnit from, TUnit to, TValue* results)
+{
+    if (from != to)
+    {
+        scale_values(values, count, lookup_ratio(from, to), results);
+    }
+    else if (values != results)
+    {
+        std::copy(values, values + count, results);
+    }
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
 } // namespace detail
+
+//-----------------------------------------------------------------------------
+
+void convert(double const* values, size_t count, distance_unit from, distance_unit to, double* results)
+{
+    detail::convert_values(values, count, from, to, results);
+}
+
+void convert(double const* values, size_t count, pressure_unit from, pressure_unit to, double* results)
+{
+    detail::convert_values(values, count, from, to, results);
+}
+
+void convert(double const* values, size_t count, speed_unit from, speed_unit to, double* results)
+{
+    detail::convert_values(values, count, from, to, results);
+}
+
+void convert(float const* values, size_t count, distance_unit from, distance_unit to, float* results)
+{
+    detail::convert_values(values, count, from, to, results);
+}
+
+void convert(float const* values, size_t count, pressure_unit from, pressure_unit to, float* results)
+{
+    detail::convert_values(values, count, from, to, results);
+}
+
+void convert(float const* values, size_t count, speed_unit from, speed_unit to, float* results)
+{
+    detail::convert_values(values, count, from, to, results);
+}
+
+//-----------------------------------------------------------------------------
+
 } // namespace aw
@@ -0,0 +1,468 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/csv_ingest.h>
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <system_error>
+#include <thread>
+
+#include "decimal.h"
+#include "mapped_file.h"
+
+namespace aw
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+// Ranges smaller than this are not worth a thread of their own
+const size_t minimum_range_size = 256 * 1024;
+
+const size_t no_column = static_cast<size_t>(-1);
+
+//-----------------------------------------------------------------------------
+
+// One field of a row, with any quotes still in place
+struct csv_field
+{
+    const char* data;
+    size_t      size;
+    bool        quoted;
+};
+
+struct column_indices
+{
+    size_t raw_text;
+    size_t latitude;
+    size_t longitude;
+    size_t elevation;
+};
+
+//-----------------------------------------------------------------------------
+
+// Reads rows from a position outside quotes. Every quote toggles between
+// quoted and unquoted text, so a doubled quote inside a quoted field leaves
+// the state as it was; this is what lets a range find its first row by
+// counting the quotes before it.
+class csv_cursor
+{
+public:
+    csv_cursor(const char* data, size_t size, size_t position) :
+        m_data(data),
+        m_size(size),
+        m_position(position)
+    {}
+
+    bool at_end() const
+    {
+        return m_position >= m_size;
+    }
+
+    size_t position() const
+    {
+        return m_position;
+    }
+
+    // Reads the next row, passing each field and its index to the handler
+    template <class THandler>
+    void read_row(THandler&& handler)
+    {
+        size_t index = 0;
+        auto start = m_position;
+        auto inQuotes = false;
+        auto quoted = false;
+
+        for (; m_position < m_size; ++m_position)
+        {
+            auto c = m_data[m_position];
+            if (c == '"')
+            {
+                inQuotes = !inQuotes;
+                quoted = true;
+            }
+            else if (c == ',' && !inQuotes)
+            {
+                handler(index++, field(start, m_position, quoted));
+                start = m_position + 1;
+                quoted = false;
+            }
+            else if (c == '\n' && !inQuotes)
+            {
+                handler(index, line_end_field(start, m_position, quoted));
+                ++m_position;
+                return;
+            }
+        }
+        handler(index, line_end_field(start, m_position, quoted));
+    }
+
+private:
+    csv_field field(size_t start, size_t end, bool quoted) const
+    {
+        csv_field result = { m_data + start, end - start, quoted };
+        return result;
+    }
+
+    // The last field of a row without the carriage return of a CRLF
+    csv_field line_end_field(size_t start, size_t end, bool quoted) const
+    {
+        if (end > start && m_data[end - 1] == '\r')
+        {
+            --end;
+        }
+        return field(start, end, quoted);
+    }
+
+private:
+    const char* m_data;
+    size_t      m_size;
+    size_t      m_position;
+};
+
+//-----------------------------------------------------------------------------
+
+// Text of a field with its quotes removed and doubled quotes undone
+std::string field_text(csv_field const& field)
+{
+    if (!field.quoted)
+    {
+        return std::string(field.data, field.size);
+    }
+
+    std::string result;
+    result.reserve(field.size);
+
+    auto inQuotes = false;
+    for (size_t i = 0; i < field.size; ++i)
+    {
+        auto c = field.data[i];
+        if (c != '"')
+        {
+            result.push_back(c);
+        }
+        else if (inQuotes && i + 1 < field.size && field.data[i + 1] == '"')
+        {
+            result.push_back('"');
+            ++i;
+        }
+        else
+        {
+            inQuotes = !inQuotes;
+        }
+    }
+    return result;
+}
+
+util::optional<double> parse_field(csv_field const& field)
+{
+    if (field.quoted)
+    {
+        auto text = field_text(field);
+        return parse_decimal(text.data(), text.size());
+    }
+    return parse_decimal(field.data, field.size);
+}
+
+//-----------------------------------------------------------------------------
+
+// Finds the header row, returning the position of the row after it
+size_t find_header(const char* data, size_t size, csv_columns const& names, column_indices& columns)
+{
+    csv_cursor cursor(data, size, 0);
+    while (!cursor.at_end())
+    {
+        column_indices found = { no_column, no_column, no_column, no_column };
+        cursor.read_row([&](size_t index, csv_field const& field)
+        {
+            auto name = field_text(field);
+            if (name.empty())
+            {
+                return;
+            }
+
+            if (name == names.raw_text)
+            {
+                found.raw_text = index;
+            }
+            else if (name == names.latitude)
+            {
+                found.latitude = index;
+            }
+            else if (name == names.longitude)
+            {
+                found.longitude = index;
+            }
+            else if (name == names.elevation)
+            {
+                found.elevation = index;
+            }
+        });
+
+        if (found.raw_text != no_column)
+        {
+            columns = found;
+            return cursor.position();
+        }
+    }
+
+    throw aw_exception("CSV input has no header row naming the raw text column");
+}
+
+// First row that starts at or after position, given whether position is
+// inside quotes
+size_t find_row_start(const char* data, size_t size, size_t position, bool inQuotes)
+{
+    if (!inQuotes && position > 0 && data[position - 1] == '\n')
+    {
+        return position;
+    }
+
+    for (; position < size; ++position)
+    {
+        if (data[position] == '"')
+        {
+            inQuotes = !inQuotes;
+        }
+        else if (data[position] == '\n' && !inQuotes)
+        {
+            return position + 1;
+        }
+    }
+    return size;
+}
+
+// Parses the rows that start in [begin, end)
+void read_rows(const char* data, size_t size, size_t begin, size_t end, column_indices const& columns, std::vector<csv_observation>& results)
+{
+    csv_cursor cursor(data, size, begin);
+    while (!cursor.at_end() && cursor.position() < end)
+    {
+        csv_field rawText = { nullptr, 0, false };
+        csv_field latitude = rawText;
+        csv_field longitude = rawText;
+        csv_field elevation = rawText;
+
+        cursor.read_row([&](size_t index, csv_field const& field)
+        {
+            if (index == columns.raw_text)
+            {
+                rawText = field;
+            }
+            else if (index == columns.latitude)
+            {
+                latitude = field;
+            }
+            else if (index == columns.longitude)
+            {
+                longitude = field;
+            }
+            else if (index == columns.elevation)
+            {
+                elevation = field;
+            }
+        });
+
+        auto text = field_text(rawText);
+        if (text.empty())
+        {
+            continue;
+        }
+
+        results.emplace_back(text);
+        auto& observation = results.back();
+
+        auto lat = parse_field(latitude);
+        auto lon = parse_field(longitude);
+        if (lat && lon)
+        {
+            geo_point position = { *lat, *lon };
+            observation.position = position;
+        }
+        observation.elevation = parse_field(elevation);
+    }
+}
+
+// Calls function(i) for each i below count, on separate threads. The calling
+// thread takes the first, and any that a thread could not be started for.
+// The first exception thrown is rethrown once every call has finished.
+template <class TFunction>
+void run_parallel(size_t count, TFunction const& function)
+{
+    std::vector<std::exception_ptr> errors(count);
+    auto run = [&function, &errors](size_t i)
+    {
+        try
+        {
+            function(i);
+        }
+        catch (...)
+        {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    std::vector<size_t> remaining(1, 0);
+    for (size_t i = 1; i < count; ++i)
+    {
+        try
+        {
+            threads.emplace_back(run, i);
+        }
+        catch (std::system_error const&)
+        {
+            remaining.push_back(i);
+        }
+    }
+
+    for (auto i : remaining)
+    {
+        run(i);
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (auto const& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+csv_columns::csv_columns() :
+    raw_text("raw_text"),
+    latitude("latitude"),
+    longitude("longitude"),
+    elevation("elevation_m")
+{}
+
+//-----------------------------------------------------------------------------
+
+csv_observation::csv_observation(std::string const& rawText) :
+    report(rawText)
+{}
+
+csv_observation::csv_observation(csv_observation && other) :
+    report(std::move(other.report)),
+    position(std::move(other.position)),
+    elevation(std::move(other.elevation))
+{
+    other.position = util::nullopt;
+    other.elevation = util::nullopt;
+}
+
+csv_observation& csv_observation::operator=(csv_observation && rhs)
+{
+    if (this != &rhs)
+    {
+        report = std::move(rhs.report);
+        position = std::move(rhs.position);
+        elevation = std::move(rhs.elevation);
+
+        rhs.position = util::nullopt;
+        rhs.elevation = util::nullopt;
+    }
+    return *this;
+}
+
+//-----------------------------------------------------------------------------
+
+void read_csv(const char* data, size_t size, std::vector<csv_observation>& results, unsigned threads, csv_columns const& columns)
+{
+    column_indices indices;
+    auto body = find_header(data, size, columns, indices);
+
+    if (threads == 0)
+    {
+        threads = (std::max)(1u, std::thread::hardware_concurrency());
+    }
+
+    auto bodySize = size - body;
+    auto count = (std::min)(static_cast<size_t>(threads), (std::max)(static_cast<size_t>(1), bodySize / minimum_range_size));
+    if (count == 1)
+    {
+        read_rows(data, size, body, size, indices, results);
+        return;
+    }
+
+    // Nominal boundaries of the ranges, then the quotes in each
+    std::vector<size_t> bounds(count + 1);
+    for (size_t i = 0; i < count; ++i)
+    {
+        bounds[i] = body + bodySize / count * i;
+    }
+    bounds[count] = size;
+
+    std::vector<size_t> quotes(count);
+    run_parallel(count, [&](size_t i)
+    {
+        quotes[i] = static_cast<size_t>(std::count(data + bounds[i], data + bounds[i + 1], '"'));
+    });
+
+    // An odd number of quotes before a boundary puts it inside a quoted
+    // field, in which case the range starts at the end of that field's row
+    std::vector<size_t> starts(count + 1);
+    auto inQuotes = false;
+    for (size_t i = 0; i < count; ++i)
+    {
+        starts[i] = (i == 0) ? body : find_row_start(data, size, bounds[i], inQuotes);
+        inQuotes ^= (quotes[i] & 1) != 0;
+    }
+    starts[count] = size;
+
+    std::vector<std::vector<csv_observation>> ranges(count);
+    run_parallel(count, [&](size_t i)
+    {
+        read_rows(data, size, starts[i], starts[i + 1], indices, ranges[i]);
+    });
+
+    size_t total = results.size();
+    for (auto const& range : ranges)
+    {
+        total += range.size();
+    }
+    results.reserve(total);
+
+    for (auto& range : ranges)
+    {
+        std::move(range.begin(), range.end(), std::back_inserter(results));
+    }
+}
+
+void read_csv_file(std::string const& path, std::vector<csv_observation>& results, unsigned threads, csv_columns const& columns)
+{
+    detail::mapped_file file(path);
+    read_csv(reinterpret_cast<const char*>(file.data()), file.size(), results, threads, columns);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
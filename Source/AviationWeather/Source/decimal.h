@@ -0,0 +1,93 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <AviationWeather/optional.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// Parses a decimal number such as -122.38 or 4, independent of the locale.
+// Anything else, including empty text, gives no value.
+inline util::optional<double> parse_decimal(const char* data, size_t size)
+{
+    static const double powers_of_ten[] =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+        1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18
+    };
+
+    // Digits kept; further fraction digits are ignored
+    const int maximum_digits = 18;
+
+    size_t i = 0;
+    auto negative = false;
+    if (i < size && (data[i] == '-' || data[i] == '+'))
+    {
+        negative = data[i] == '-';
+        ++i;
+    }
+
+    uint64_t mantissa = 0;
+    auto digits = 0;
+    auto fractionDigits = 0;
+    auto point = false;
+    auto any = false;
+
+    for (; i < size; ++i)
+    {
+        auto c = data[i];
+        if (c >= '0' && c <= '9')
+        {
+            any = true;
+            if (digits < maximum_digits && fractionDigits < maximum_digits)
+            {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(c - '0');
+                digits += (mantissa != 0) ? 1 : 0;
+                fractionDigits += point ? 1 : 0;
+            }
+            else if (!point)
+            {
+                return util::nullopt;
+            }
+        }
+        else if (c == '.' && !point)
+        {
+            point = true;
+        }
+        else
+        {
+            return util::nullopt;
+        }
+    }
+
+    if (!any)
+    {
+        return util::nullopt;
+    }
+
+    auto value = static_cast<double>(mantissa) / powers_of_ten[fractionDigits];
+    return negative ? -value : value;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
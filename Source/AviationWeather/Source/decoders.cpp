@@ -174,6 +174,12 @@ sky_cover_type decode_sky_cover(std::string const& symbol)
     else if (symbol == "OVC") {
         return sky_cover_type::overcast;
     }
+    else if (symbol == "NSC") {
+        return sky_cover_type::no_significant_cloud;
+    }
+    else if (symbol == "NCD") {
+        return sky_cover_type::no_cloud_detected;
+    }
     throw unsupported_symbol_exception(symbol);
 }
 
@@ -207,17 +213,18 @@ distance_unit decode_distance_unit(std::string const& symbol)
 
 //-----------------------------------------------------------------------------
 
-// TODO: Add support for MPH when adjusting the parsers for international metars.
-//       The MPH unit currently doesn't get decoded since we only check for KT
-//       in a wind group.
 speed_unit decode_speed_unit(std::string const& symbol)
 {
     if (symbol == "KT") {
         return speed_unit::kt;
     }
-    else {
+    else if (symbol == "MPS") {
+        return speed_unit::mps;
+    }
+    else if (symbol == "MPH") {
         return speed_unit::mph;
     }
+    throw unsupported_symbol_exception(symbol);
 }
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,374 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/derived_quantities.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <AviationWeather/types.h>
+
+#include "simd.h"
+
+namespace aw
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+// Magnus coefficients over water (Alduchov and Eskridge)
+const double magnus_a = 17.625;
+const double magnus_b = 243.04;
+
+// Standard atmosphere: 288 K at sea level, lapse rate 0.0065 K/m
+const double lapse_per_foot = 0.0065 * 0.3048 / 288.0;
+const double pressure_exponent = 5.2561;
+const double standard_pressure = 1013.25;
+const double hpa_per_inhg = 33.8639;
+
+const double knots_to_kmh = 1.852;
+
+void check_sizes(size_t a, size_t b)
+{
+    if (a != b)
+    {
+        throw aw_exception("Batch inputs must have the same size");
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+// Each kernel has a scalar form, which is the reference, and with SSE2 a
+// four-lane form. run_kernel uses the four-lane form for whole groups of four
+// and the scalar form for the remainder.
+
+template <class TKernel>
+void run_kernel(std::vector<float> const& a, std::vector<float> const& b, std::vector<float>& results)
+{
+    check_sizes(a.size(), b.size());
+    results.resize(a.size());
+
+    size_t i = 0;
+#if defined(AW_SSE2)
+    for (; i + 4 <= a.size(); i += 4)
+    {
+        _mm_storeu_ps(&results[i], TKernel::vector(_mm_loadu_ps(&a[i]), _mm_loadu_ps(&b[i])));
+    }
+#endif
+    for (; i < a.size(); ++i)
+    {
+        results[i] = static_cast<float>(TKernel::scalar(a[i], b[i]));
+    }
+}
+
+template <class TKernel>
+void run_kernel(std::vector<float> const& a, std::vector<float> const& b, std::vector<float> const& c,
+    std::vector<float>& results)
+{
+    check_sizes(a.size(), b.size());
+    check_sizes(a.size(), c.size());
+    results.resize(a.size());
+
+    size_t i = 0;
+#if defined(AW_SSE2)
+    for (; i + 4 <= a.size(); i += 4)
+    {
+        _mm_storeu_ps(&results[i], TKernel::vector(_mm_loadu_ps(&a[i]), _mm_loadu_ps(&b[i]), _mm_loadu_ps(&c[i])));
+    }
+#endif
+    for (; i < a.size(); ++i)
+    {
+        results[i] = static_cast<float>(TKernel::scalar(a[i], b[i], c[i]));
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+struct relative_humidity_kernel
+{
+    static double scalar(double temperature, double dewpoint)
+    {
+        return 100.0 * std::exp(magnus_a * dewpoint / (magnus_b + dewpoint) - magnus_a * temperature / (magnus_b + temperature));
+    }
+
+#if defined(AW_SSE2)
+    static __m128 vector(__m128 temperature, __m128 dewpoint)
+    {
+        using namespace simd;
+        auto a = set(static_cast<float>(magnus_a));
+        auto b = set(static_cast<float>(magnus_b));
+        auto exponent = _mm_sub_ps(
+            _mm_div_ps(_mm_mul_ps(a, dewpoint), _mm_add_ps(b, dewpoint)),
+            _mm_div_ps(_mm_mul_ps(a, temperature), _mm_add_ps(b, temperature)));
+        return _mm_mul_ps(set(100.0f), simd::exp(exponent));
+    }
+#endif
+};
+
+struct dewpoint_depression_kernel
+{
+    static double scalar(double temperature, double dewpoint)
+    {
+        return temperature - dewpoint;
+    }
+
+#if defined(AW_SSE2)
+    static __m128 vector(__m128 temperature, __m128 dewpoint)
+    {
+        return _mm_sub_ps(temperature, dewpoint);
+    }
+#endif
+};
+
+struct station_pressure_kernel
+{
+    static double scalar(double altimeter, double elevation)
+    {
+        return altimeter * std::pow(1.0 - elevation * lapse_per_foot, pressure_exponent);
+    }
+
+#if defined(AW_SSE2)
+    static __m128 vector(__m128 altimeter, __m128 elevation)
+    {
+        using namespace simd;
+        auto ratio = _mm_sub_ps(set(1.0f), _mm_mul_ps(elevation, set(static_cast<float>(lapse_per_foot))));
+        return _mm_mul_ps(altimeter, simd::pow(ratio, set(static_cast<float>(pressure_exponent))));
+    }
+#endif
+};
+
+struct pressure_altitude_kernel
+{
+    static double scalar(double altimeter, double elevation)
+    {
+        auto ratio = station_pressure_kernel::scalar(altimeter, elevation) / standard_pressure;
+        return 145366.45 * (1.0 - std::pow(ratio, 0.190284));
+    }
+
+#if defined(AW_SSE2)
+    static __m128 vector(__m128 altimeter, __m128 elevation)
+    {
+        using namespace simd;
+        auto ratio = _mm_div_ps(station_pressure_kernel::vector(altimeter, elevation), set(static_cast<float>(standard_pressure)));
+        return _mm_mul_ps(set(145366.45f), _mm_sub_ps(set(1.0f), simd::pow(ratio, set(0.190284f))));
+    }
+#endif
+};
+
+struct density_altitude_kernel
+{
+    static double scalar(double altimeter, double elevation, double temperature)
+    {
+        auto pressure = station_pressure_kernel::scalar(altimeter, elevation) / hpa_per_inhg;
+        auto rankine = temperature * 1.8 + 32.0 + 459.67;
+        return 145442.16 * (1.0 - std::pow(17.326 * pressure / rankine, 0.235));
+    }
+
+#if defined(AW_SSE2)
+    static __m128 vector(__m128 altimeter, __m128 elevation, __m128 temperature)
+    {
+        using namespace simd;
+        auto pressure = _mm_div_ps(station_pressure_kernel::vector(altimeter, elevation), set(static_cast<float>(hpa_per_inhg)));
+        auto rankine = _mm_add_ps(_mm_mul_ps(temperature, set(1.8f)), set(32.0f + 459.67f));
+        auto ratio = _mm_div_ps(_mm_mul_ps(set(17.326f), pressure), rankine);
+        return _mm_mul_ps(set(145442.16f), _mm_sub_ps(set(1.0f), simd::pow(ratio, set(0.235f))));
+    }
+#endif
+};
+
+struct wind_chill_kernel
+{
+    static double scalar(double temperature, double windSpeed)
+    {
+        auto speed = windSpeed * knots_to_kmh;
+        if (std::isnan(speed))
+        {
+            return speed;
+        }
+        if (!(temperature <= 10.0 && speed >= 4.8))
+        {
+            return temperature;
+        }
+        auto power = std::pow(speed, 0.16);
+        return 13.12 + 0.6215 * temperature - 11.37 * power + 0.3965 * temperature * power;
+    }
+
+#if defined(AW_SSE2)
+    static __m128 vector(__m128 temperature, __m128 windSpeed)
+    {
+        using namespace simd;
+        auto speed = _mm_mul_ps(windSpeed, set(static_cast<float>(knots_to_kmh)));
+        auto defined = _mm_and_ps(_mm_cmple_ps(temperature, set(10.0f)), _mm_cmpge_ps(speed, set(4.8f)));
+
+        // Below 4.8 km/h the index is unused, so clamp to keep log defined
+        auto power = simd::pow(_mm_max_ps(set(1.0f), speed), set(0.16f));
+        auto index = _mm_add_ps(
+            _mm_add_ps(set(13.12f), _mm_mul_ps(set(0.6215f), temperature)),
+            _mm_mul_ps(power, _mm_sub_ps(_mm_mul_ps(set(0.3965f), temperature), set(11.37f))));
+
+        // Adding zero times the speed keeps a missing speed as NaN
+        return select(defined, index, _mm_add_ps(temperature, _mm_mul_ps(speed, _mm_setzero_ps())));
+    }
+#endif
+};
+
+struct heat_index_kernel
+{
+    static double scalar(double temperature, double relativeHumidity)
+    {
+        auto t = temperature * 1.8 + 32.0;
+        auto rh = relativeHumidity;
+
+        auto result = 0.5 * (t + 61.0 + (t - 68.0) * 1.2 + rh * 0.094);
+        if ((result + t) / 2.0 >= 80.0)
+        {
+            result = -42.379 + 2.04901523 * t + 10.14333127 * rh - 0.22475541 * t * rh -
+                0.00683783 * t * t - 0.05481717 * rh * rh + 0.00122874 * t * t * rh +
+                0.00085282 * t * rh * rh - 0.00000199 * t * t * rh * rh;
+
+            if (rh < 13.0 && t > 80.0 && t < 112.0)
+            {
+                result -= ((13.0 - rh) / 4.0) * std::sqrt((std::max)(0.0, (17.0 - std::fabs(t - 95.0)) / 17.0));
+            }
+            else if (rh > 85.0 && t > 80.0 && t < 87.0)
+            {
+                result += ((rh - 85.0) / 10.0) * ((87.0 - t) / 5.0);
+            }
+        }
+        return (result - 32.0) / 1.8;
+    }
+
+#if defined(AW_SSE2)
+    static __m128 vector(__m128 temperature, __m128 relativeHumidity)
+    {
+        using namespace simd;
+        auto t = _mm_add_ps(_mm_mul_ps(temperature, set(1.8f)), set(32.0f));
+        auto rh = relativeHumidity;
+
+        auto simple = _mm_mul_ps(set(0.5f), _mm_add_ps(_mm_add_ps(t, set(61.0f)),
+            _mm_add_ps(_mm_mul_ps(_mm_sub_ps(t, set(68.0f)), set(1.2f)), _mm_mul_ps(rh, set(0.094f)))));
+
+        auto t2 = _mm_mul_ps(t, t);
+        auto rh2 = _mm_mul_ps(rh, rh);
+        auto trh = _mm_mul_ps(t, rh);
+        auto full = _mm_add_ps(
+            _mm_add_ps(
+                _mm_add_ps(set(-42.379f), _mm_mul_ps(set(2.04901523f), t)),
+                _mm_add_ps(_mm_mul_ps(set(10.14333127f), rh), _mm_mul_ps(set(-0.22475541f), trh))),
+            _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(set(-0.00683783f), t2), _mm_mul_ps(set(-0.05481717f), rh2)),
+                _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(set(0.00122874f), _mm_mul_ps(t2, rh)), _mm_mul_ps(set(0.00085282f), _mm_mul_ps(trh, rh))),
+                    _mm_mul_ps(set(-0.00000199f), _mm_mul_ps(t2, rh2)))));
+
+        // The two adjustments cover disjoint humidities, so both can be masked in
+        auto inRange = _mm_and_ps(_mm_cmpgt_ps(t, set(80.0f)), _mm_cmplt_ps(t, set(112.0f)));
+        auto distance = _mm_andnot_ps(set(-0.0f), _mm_sub_ps(t, set(95.0f)));
+        auto dry = _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(set(13.0f), rh), set(0.25f)),
+            _mm_sqrt_ps(_mm_max_ps(_mm_setzero_ps(), _mm_div_ps(_mm_sub_ps(set(17.0f), distance), set(17.0f)))));
+        full = _mm_sub_ps(full, _mm_and_ps(_mm_and_ps(_mm_cmplt_ps(rh, set(13.0f)), inRange), dry));
+
+        auto humid = _mm_mul_ps(_mm_mul_ps(_mm_sub_ps(rh, set(85.0f)), set(0.1f)), _mm_mul_ps(_mm_sub_ps(set(87.0f), t), set(0.2f)));
+        auto humidRange = _mm_and_ps(_mm_cmpgt_ps(rh, set(85.0f)), _mm_and_ps(inRange, _mm_cmplt_ps(t, set(87.0f))));
+        full = _mm_add_ps(full, _mm_and_ps(humidRange, humid));
+
+        // NaN lanes fail the comparison and take the simple formula, which
+        // keeps them NaN
+        auto useFull = _mm_cmpge_ps(_mm_mul_ps(_mm_add_ps(simple, t), set(0.5f)), set(80.0f));
+        return _mm_div_ps(_mm_sub_ps(select(useFull, full, simple), set(32.0f)), set(1.8f));
+    }
+#endif
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+double relative_humidity(double temperature, double dewpoint)
+{
+    return relative_humidity_kernel::scalar(temperature, dewpoint);
+}
+
+double station_pressure(double altimeter, double elevation)
+{
+    return station_pressure_kernel::scalar(altimeter, elevation);
+}
+
+double pressure_altitude(double altimeter, double elevation)
+{
+    return pressure_altitude_kernel::scalar(altimeter, elevation);
+}
+
+double density_altitude(double altimeter, double elevation, double temperature)
+{
+    return density_altitude_kernel::scalar(altimeter, elevation, temperature);
+}
+
+double wind_chill(double temperature, double windSpeed)
+{
+    return wind_chill_kernel::scalar(temperature, windSpeed);
+}
+
+double heat_index(double temperature, double relativeHumidity)
+{
+    return heat_index_kernel::scalar(temperature, relativeHumidity);
+}
+
+//-----------------------------------------------------------------------------
+
+void relative_humidity(std::vector<float> const& temperature, std::vector<float> const& dewpoint,
+    std::vector<float>& results)
+{
+    run_kernel<relative_humidity_kernel>(temperature, dewpoint, results);
+}
+
+void dewpoint_depression(std::vector<float> const& temperature, std::vector<float> const& dewpoint,
+    std::vector<float>& results)
+{
+    run_kernel<dewpoint_depression_kernel>(temperature, dewpoint, results);
+}
+
+void pressure_altitude(std::vector<float> const& altimeter, std::vector<float> const& elevation,
+    std::vector<float>& results)
+{
+    run_kernel<pressure_altitude_kernel>(altimeter, elevation, results);
+}
+
+void density_altitude(std::vector<float> const& altimeter, std::vector<float> const& elevation,
+    std::vector<float> const& temperature, std::vector<float>& results)
+{
+    run_kernel<density_altitude_kernel>(altimeter, elevation, temperature, results);
+}
+
+void wind_chill(std::vector<float> const& temperature, std::vector<float> const& windSpeed,
+    std::vector<float>& results)
+{
+    run_kernel<wind_chill_kernel>(temperature, windSpeed, results);
+}
+
+void heat_index(std::vector<float> const& temperature, std::vector<float> const& relativeHumidity,
+    std::vector<float>& results)
+{
+    run_kernel<heat_index_kernel>(temperature, relativeHumidity, results);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -0,0 +1,68 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include "flight_rules.h"
+
+#include <algorithm>
+
+#include <AviationWeather/converters.h>
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+cloud_layer find_ceiling(std::vector<cloud_layer> const& skyConditionGroup)
+{
+    auto result = std::find_if(skyConditionGroup.begin(), skyConditionGroup.end(), [](cloud_layer layer)
+    {
+        return layer.sky_cover == sky_cover_type::broken ||
+            layer.sky_cover == sky_cover_type::overcast ||
+            layer.sky_cover == sky_cover_type::vertical_visibility ||
+            layer.sky_cover == sky_cover_type::sky_clear ||
+            layer.sky_cover == sky_cover_type::clear_below_12000 ||
+            layer.sky_cover == sky_cover_type::no_significant_cloud ||
+            layer.sky_cover == sky_cover_type::no_cloud_detected;
+    });
+    return result != skyConditionGroup.end() ? *result : cloud_layer();
+}
+
+//-----------------------------------------------------------------------------
+
+flight_category find_flight_category(util::optional<visibility> const& visibilityGroup, std::vector<cloud_layer> const& skyConditionGroup)
+{
+    if (!visibilityGroup || skyConditionGroup.empty())
+    {
+        return flight_category::unknown;
+    }
+
+    cloud_layer ceiling = find_ceiling(skyConditionGroup);
+
+    auto distanceSM = aw::convert(visibilityGroup->distance, visibilityGroup->unit, distance_unit::statute_miles);
+
+    if (distanceSM >= 3.0 && ceiling.layer_height >= 1000L)
+    {
+        return (distanceSM > 5.0 && ceiling.layer_height > 3000L) ? flight_category::vfr : flight_category::mvfr;
+    }
+    return (distanceSM >= 1.0 && ceiling.layer_height >= 500L) ? flight_category::ifr : flight_category::lifr;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
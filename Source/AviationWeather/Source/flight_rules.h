@@ -0,0 +1,40 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include <AviationWeather/components.h>
+#include <AviationWeather/optional.h>
+#include <AviationWeather/types.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// Ceiling and flight category rules shared by observations and forecasts so
+// that both classify the same conditions identically.
+
+// The first broken, overcast, vertical visibility or clear layer. Layers are
+// reported in ascending order, so this is the lowest ceiling.
+cloud_layer find_ceiling(std::vector<cloud_layer> const& skyConditionGroup);
+
+flight_category find_flight_category(util::optional<visibility> const& visibilityGroup, std::vector<cloud_layer> const& skyConditionGroup);
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -0,0 +1,208 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#include <AviationWeather/components.h>
+#include <AviationWeather/converters.h>
+#include <AviationWeather/metar.h>
+#include <AviationWeather/optional.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// 64-bit variant of boost::hash_combine
+inline uint64_t hash_combine(uint64_t seed, uint64_t value)
+{
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+// Final avalanche step from MurmurHash3 so that low bits are usable for
+// power-of-two table indexing.
+inline uint64_t hash_finalize(uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+// FNV-1a over a byte range. Intended for short keys such as report groups.
+inline uint64_t hash_bytes(const char* data, size_t length)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+//-----------------------------------------------------------------------------
+
+inline uint64_t hash_value(weather const& value)
+{
+    uint64_t hash = hash_combine(static_cast<uint64_t>(value.intensity), static_cast<uint64_t>(value.descriptor));
+    for (auto phenomenon : value.phenomena)
+    {
+        hash = hash_combine(hash, static_cast<uint64_t>(phenomenon));
+    }
+    return hash_finalize(hash);
+}
+
+// Matches cloud_layer::operator==, which does not compare units
+inline uint64_t hash_value(cloud_layer const& value)
+{
+    uint64_t hash = hash_combine(static_cast<uint64_t>(value.sky_cover), value.layer_height);
+    hash = hash_combine(hash, static_cast<uint64_t>(value.cloud_type));
+    return hash_finalize(hash);
+}
+
+inline uint64_t hash_value(time const& value)
+{
+    return (static_cast<uint64_t>(value.day_of_month) << 16) |
+        (static_cast<uint64_t>(value.hour_of_day) << 8) |
+        value.minute_of_hour;
+}
+
+inline uint64_t hash_value(wind const& value)
+{
+    uint64_t hash = hash_combine(static_cast<uint64_t>(value.unit), value.direction);
+    hash = hash_combine(hash, (static_cast<uint64_t>(value.wind_speed) << 8) | value.gust_speed);
+    hash = hash_combine(hash, value.variation_lower ? *value.variation_lower : UINT32_MAX);
+    hash = hash_combine(hash, value.variation_upper ? *value.variation_upper : UINT32_MAX);
+    return hash;
+}
+
+// visibility and altimeter compare equal across units, so their hashes are
+// taken over the value converted to a common unit and rounded well below the
+// precision of any report.
+inline uint64_t hash_value(visibility const& value)
+{
+    auto feet = convert(value.distance, value.unit, distance_unit::feet);
+    auto hash = static_cast<uint64_t>(std::llround(feet * 100.0));
+    return hash_combine(hash, static_cast<uint64_t>(value.modifier));
+}
+
+inline uint64_t hash_value(altimeter const& value)
+{
+    auto hectopascals = convert(value.pressure, value.unit, pressure_unit::hPa);
+    return static_cast<uint64_t>(std::llround(hectopascals * 1000.0));
+}
+
+inline uint64_t hash_value(runway_visual_range const& value)
+{
+    uint64_t hash = hash_combine(value.runway_number, static_cast<uint64_t>(value.runway_designator));
+    hash = hash_combine(hash, hash_value(value.visibility_min));
+    hash = hash_combine(hash, hash_value(value.visibility_max));
+    return hash_combine(hash, static_cast<uint64_t>(value.tendency));
+}
+
+inline uint64_t hash_value(directional_visibility const& value)
+{
+    return hash_combine(hash_value(value.distance), static_cast<uint64_t>(value.direction));
+}
+
+inline uint64_t hash_value(runway_wind_shear const& value)
+{
+    uint64_t hash = hash_combine(value.all_runways ? 1 : 0, value.runway_number);
+    return hash_combine(hash, static_cast<uint64_t>(value.runway_designator));
+}
+
+inline uint64_t hash_value(int8_t value)
+{
+    return static_cast<uint8_t>(value);
+}
+
+template <class T>
+uint64_t hash_value(util::optional<T> const& value)
+{
+    return value ? hash_combine(1, hash_value(*value)) : 0;
+}
+
+template <class T>
+uint64_t hash_value(std::vector<T> const& values)
+{
+    uint64_t hash = values.size();
+    for (auto const& value : values)
+    {
+        hash = hash_combine(hash, hash_value(value));
+    }
+    return hash;
+}
+
+inline uint64_t hash_value(metar_trend const& value)
+{
+    uint64_t hash = hash_combine(static_cast<uint64_t>(value.type), hash_value(value.from));
+    hash = hash_combine(hash, hash_value(value.until));
+    hash = hash_combine(hash, hash_value(value.at));
+    hash = hash_combine(hash, hash_value(value.wind_group));
+    hash = hash_combine(hash, hash_value(value.visibility_group));
+    hash = hash_combine(hash, hash_value(value.weather_group));
+    hash = hash_combine(hash, value.no_significant_weather ? 1 : 0);
+    return hash_combine(hash, hash_value(value.sky_condition_group));
+}
+
+//-----------------------------------------------------------------------------
+
+// Fingerprint returned by metar::content_hash() and metar_view::content_hash().
+// Combines the same fields that operator== compares. The text fields are
+// hashed by content so that metar and metar_view agree. The observation time
+// is combined last, so that reports with no groups, whose time is read from
+// the clock, can start from a constant hash of the other fields.
+template <class TReport>
+uint64_t hash_content_fields(TReport const& report)
+{
+    uint64_t hash = static_cast<uint64_t>(report.type);
+    hash = hash_combine(hash, hash_bytes(report.identifier.data(), report.identifier.size()));
+    hash = hash_combine(hash, static_cast<uint64_t>(report.modifier));
+    hash = hash_combine(hash, hash_value(report.wind_group));
+    hash = hash_combine(hash, hash_value(report.visibility_group));
+    hash = hash_combine(hash, hash_value(report.minimum_visibility_group));
+    hash = hash_combine(hash, hash_value(report.runway_visual_range_group));
+    hash = hash_combine(hash, hash_value(report.weather_group));
+    hash = hash_combine(hash, hash_value(report.sky_condition_group));
+    hash = hash_combine(hash, hash_value(report.temperature));
+    hash = hash_combine(hash, hash_value(report.dewpoint));
+    hash = hash_combine(hash, hash_value(report.altimeter_group));
+    hash = hash_combine(hash, hash_value(report.recent_weather_group));
+    hash = hash_combine(hash, hash_value(report.wind_shear_group));
+    hash = hash_combine(hash, hash_value(report.trend_group));
+    return hash_combine(hash, hash_bytes(report.remarks.data(), report.remarks.size()));
+}
+
+inline uint64_t finish_content_hash(uint64_t fields, time const& observationTime)
+{
+    return hash_finalize(hash_combine(fields, hash_value(observationTime)));
+}
+
+template <class TReport>
+uint64_t compute_content_hash(TReport const& report)
+{
+    return finish_content_hash(hash_content_fields(report), report.observation_time);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
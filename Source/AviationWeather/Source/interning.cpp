@@ -0,0 +1,258 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/interning.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "hash.h"
+
+namespace aw
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+// Append-only table mapping values to 16-bit identifiers. Values are stored in
+// fixed-size chunks that never move once published, and the hash index is an
+// open-addressed array of atomic slots, so readers never take the lock. Writers
+// serialise on a mutex and publish each slot with release semantics after the
+// value it refers to has been written.
+template <class T, class TId>
+class intern_table
+{
+public:
+    static const size_t capacity = 65536;
+    static const size_t chunk_size = 256;
+    static const size_t chunk_count = capacity / chunk_size;
+    static const size_t index_size = capacity * 2;
+
+    intern_table() :
+        m_size(0),
+        m_index(new std::atomic<uint32_t>[index_size])
+    {
+        for (auto& chunk : m_chunks)
+        {
+            chunk.store(nullptr, std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < index_size; ++i)
+        {
+            m_index[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ~intern_table()
+    {
+        for (auto& chunk : m_chunks)
+        {
+            delete[] chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    intern_table(intern_table const&) = delete;
+    intern_table& operator= (intern_table const&) = delete;
+
+    util::optional<TId> find(T const& value) const
+    {
+        return find(value, hash_value(value));
+    }
+
+    TId intern(T const& value)
+    {
+        auto hash = hash_value(value);
+
+        auto existing = find(value, hash);
+        if (existing)
+        {
+            return *existing;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Another writer may have added the value since the unlocked lookup
+        existing = find(value, hash);
+        if (existing)
+        {
+            return *existing;
+        }
+
+        auto id = m_size.load(std::memory_order_relaxed);
+        if (id >= capacity)
+        {
+            throw aw_exception("Intern table is full");
+        }
+
+        auto chunk = m_chunks[id / chunk_size].load(std::memory_order_relaxed);
+        if (chunk == nullptr)
+        {
+            chunk = new T[chunk_size];
+            m_chunks[id / chunk_size].store(chunk, std::memory_order_release);
+        }
+        chunk[id % chunk_size] = value;
+
+        auto slot = static_cast<size_t>(hash) & (index_size - 1);
+        while (m_index[slot].load(std::memory_order_relaxed) != 0)
+        {
+            slot = (slot + 1) & (index_size - 1);
+        }
+        m_index[slot].store(make_slot(id, hash), std::memory_order_release);
+        m_size.store(id + 1, std::memory_order_release);
+
+        return static_cast<TId>(id);
+    }
+
+    T const& resolve(TId id) const
+    {
+        auto index = static_cast<size_t>(id);
+        if (index >= m_size.load(std::memory_order_acquire))
+        {
+            throw aw_exception("Unknown interned identifier");
+        }
+        return m_chunks[index / chunk_size].load(std::memory_order_acquire)[index % chunk_size];
+    }
+
+    size_t size() const
+    {
+        return m_size.load(std::memory_order_acquire);
+    }
+
+private:
+    // Slots hold the identifier plus one in the low 17 bits, so that zero marks
+    // an empty slot, and the top 15 bits of the hash as a tag which lets most
+    // probes be rejected without touching the stored value.
+    static uint32_t make_slot(size_t id, uint64_t hash)
+    {
+        return static_cast<uint32_t>(id + 1) | static_cast<uint32_t>((hash >> 49) << 17);
+    }
+
+    util::optional<TId> find(T const& value, uint64_t hash) const
+    {
+        auto tag = static_cast<uint32_t>((hash >> 49) << 17);
+        auto slot = static_cast<size_t>(hash) & (index_size - 1);
+
+        for (;;)
+        {
+            auto entry = m_index[slot].load(std::memory_order_acquire);
+            if (entry == 0)
+            {
+                return util::nullopt;
+            }
+
+            if ((entry & 0xFFFE0000U) == tag)
+            {
+                auto index = static_cast<size_t>(entry & 0x1FFFFU) - 1;
+                auto chunk = m_chunks[index / chunk_size].load(std::memory_order_acquire);
+                if (chunk[index % chunk_size] == value)
+                {
+                    return static_cast<TId>(index);
+                }
+            }
+            slot = (slot + 1) & (index_size - 1);
+        }
+    }
+
+private:
+    std::mutex                                  m_mutex;
+    std::atomic<size_t>                         m_size;
+    std::atomic<T*>                             m_chunks[chunk_count];
+    std::unique_ptr<std::atomic<uint32_t>[]>    m_index;
+};
+
+//-----------------------------------------------------------------------------
+
+intern_table<weather, weather_id>& weather_table()
+{
+    static intern_table<weather, weather_id> table;
+    return table;
+}
+
+intern_table<cloud_layer, cloud_layer_id>& cloud_layer_table()
+{
+    static intern_table<cloud_layer, cloud_layer_id> table;
+    return table;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+weather_id intern(weather const& value)
+{
+    return weather_table().intern(value);
+}
+
+cloud_layer_id intern(cloud_layer const& value)
+{
+    return cloud_layer_table().intern(value);
+}
+
+void intern(std::vector<weather> const& values, std::vector<weather_id>& ids)
+{
+    ids.reserve(ids.size() + values.size());
+    for (auto const& value : values)
+    {
+        ids.push_back(weather_table().intern(value));
+    }
+}
+
+void intern(std::vector<cloud_layer> const& values, std::vector<cloud_layer_id>& ids)
+{
+    ids.reserve(ids.size() + values.size());
+    for (auto const& value : values)
+    {
+        ids.push_back(cloud_layer_table().intern(value));
+    }
+}
+
+util::optional<weather_id> find_interned(weather const& value)
+{
+    return weather_table().find(value);
+}
+
+util::optional<cloud_layer_id> find_interned(cloud_layer const& value)
+{
+    return cloud_layer_table().find(value);
+}
+
+weather const& resolve(weather_id id)
+{
+    return weather_table().resolve(id);
+}
+
+cloud_layer const& resolve(cloud_layer_id id)
+{
+    return cloud_layer_table().resolve(id);
+}
+
+size_t interned_weather_count()
+{
+    return weather_table().size();
+}
+
+size_t interned_cloud_layer_count()
+{
+    return cloud_layer_table().size();
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -0,0 +1,756 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/json_writer.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "simd.h"
+
+namespace aw
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+struct name
+{
+    const char* text;
+    size_t      size;
+};
+
+#define JSON_NAME(x) { #x, sizeof(#x) - 1 }
+
+// Indexed by enumerator, in declaration order
+const name report_type_names[] = { JSON_NAME(metar), JSON_NAME(special) };
+const name modifier_type_names[] = { JSON_NAME(none), JSON_NAME(automatic), JSON_NAME(corrected) };
+const name speed_unit_names[] = { JSON_NAME(kt), JSON_NAME(mph), JSON_NAME(mps) };
+const name distance_unit_names[] = { JSON_NAME(feet), JSON_NAME(metres), JSON_NAME(statute_miles), JSON_NAME(nautical_miles) };
+const name pressure_unit_names[] = { JSON_NAME(hPa), JSON_NAME(inHg) };
+const name visibility_modifier_names[] = { JSON_NAME(none), JSON_NAME(less_than), JSON_NAME(greater_than) };
+const name runway_designator_names[] = { JSON_NAME(none), JSON_NAME(left), JSON_NAME(right), JSON_NAME(center) };
+const name rvr_tendency_names[] = { JSON_NAME(none), JSON_NAME(upward), JSON_NAME(downward), JSON_NAME(no_change) };
+const name weather_intensity_names[] = { JSON_NAME(light), JSON_NAME(moderate), JSON_NAME(heavy), JSON_NAME(in_the_vicinity) };
+const name sky_cover_cloud_type_names[] = { JSON_NAME(unspecified), JSON_NAME(none), JSON_NAME(cumulonimbus), JSON_NAME(towering_cumulus) };
+const name trend_type_names[] = { JSON_NAME(no_significant_change), JSON_NAME(becoming), JSON_NAME(temporary) };
+
+const name compass_direction_names[] =
+{
+    JSON_NAME(north), JSON_NAME(north_east), JSON_NAME(east), JSON_NAME(south_east),
+    JSON_NAME(south), JSON_NAME(south_west), JSON_NAME(west), JSON_NAME(north_west)
+};
+
+const name weather_descriptor_names[] =
+{
+    JSON_NAME(none), JSON_NAME(shallow), JSON_NAME(partial), JSON_NAME(patches), JSON_NAME(low_drifting),
+    JSON_NAME(blowing), JSON_NAME(showers), JSON_NAME(thunderstorm), JSON_NAME(freezing)
+};
+
+const name weather_phenomena_names[] =
+{
+    JSON_NAME(none), JSON_NAME(drizzle), JSON_NAME(rain), JSON_NAME(snow), JSON_NAME(snow_grains),
+    JSON_NAME(ice_crystals), JSON_NAME(ice_pellets), JSON_NAME(hail), JSON_NAME(small_hail),
+    JSON_NAME(unknown_precipitation), JSON_NAME(mist), JSON_NAME(fog), JSON_NAME(smoke),
+    JSON_NAME(volcanic_ash), JSON_NAME(widespread_dust), JSON_NAME(sand), JSON_NAME(haze), JSON_NAME(spray),
+    JSON_NAME(well_developed_dust_whirls), JSON_NAME(squalls), JSON_NAME(funnel_cloud_tornado_waterspout),
+    JSON_NAME(sandstorm), JSON_NAME(duststorm)
+};
+
+const name sky_cover_type_names[] =
+{
+    JSON_NAME(vertical_visibility), JSON_NAME(sky_clear), JSON_NAME(clear_below_12000), JSON_NAME(few),
+    JSON_NAME(scattered), JSON_NAME(broken), JSON_NAME(overcast), JSON_NAME(no_significant_cloud),
+    JSON_NAME(no_cloud_detected)
+};
+
+#undef JSON_NAME
+
+const char hex_digits[] = "0123456789abcdef";
+
+// Powers of ten tried when writing a fraction exactly; four places cover
+// sixteenths of a mile and two cover altimeter settings in inHg
+const double decimal_scales[] = { 1.0, 10.0, 100.0, 1000.0, 10000.0 };
+const uint64_t decimal_divisors[] = { 1, 10, 100, 1000, 10000 };
+
+// Room for the fields of a typical report besides its text, which is allowed
+// twice its length for escapes
+const size_t report_size_estimate = 512;
+
+//-----------------------------------------------------------------------------
+
+bool needs_escape(char c)
+{
+    return static_cast<unsigned char>(c) < 0x20 || c == '"' || c == '\\';
+}
+
+// Position of the first character at or after start that needs an escape, or
+// size if there is none. Report text rarely has any, so with SSE2 the search
+// skips 16 characters at a time until it reaches a block that has one.
+size_t find_escape(const char* data, size_t start, size_t size)
+{
+#if defined(AW_SSE2)
+    auto const controlMax = _mm_set1_epi8(0x1F);
+    auto const quote = _mm_set1_epi8('"');
+    auto const backslash = _mm_set1_epi8('\\');
+    for (; start + 16 <= size; start += 16)
+    {
+        auto block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + start));
+        auto control = _mm_cmpeq_epi8(_mm_max_epu8(block, controlMax), controlMax);
+        auto special = _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash));
+        if (_mm_movemask_epi8(_mm_or_si128(control, special)) != 0)
+        {
+            break;
+        }
+    }
+#endif
+    for (; start < size; ++start)
+    {
+        if (needs_escape(data[start]))
+        {
+            break;
+        }
+    }
+    return start;
+}
+
+//-----------------------------------------------------------------------------
+
+// Writes to a fixed buffer, counting what does not fit
+class array_sink
+{
+public:
+    array_sink(char* buffer, size_t capacity) :
+        m_buffer(buffer),
+        m_capacity(capacity),
+        m_size(0)
+    {}
+
+    void put(char c)
+    {
+        if (m_size < m_capacity)
+        {
+            m_buffer[m_size] = c;
+        }
+        ++m_size;
+    }
+
+    void put(const char* data, size_t size)
+    {
+        if (m_size <= m_capacity && size <= m_capacity - m_size)
+        {
+            memcpy(m_buffer + m_size, data, size);
+        }
+        else if (m_size < m_capacity)
+        {
+            memcpy(m_buffer + m_size, data, m_capacity - m_size);
+        }
+        m_size += size;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+private:
+    char*  m_buffer;
+    size_t m_capacity;
+    size_t m_size;
+};
+
+//-----------------------------------------------------------------------------
+
+// Writes one report as a JSON object. Fields are written as literals that
+// include their key and punctuation, so most of the output is a handful of
+// fixed-size copies.
+class json_writer
+{
+public:
+    explicit json_writer(array_sink& sink) :
+        m_sink(sink)
+    {}
+
+    template <class TReport>
+    void write_report(TReport const& value)
+    {
+        literal("{\"string\":");
+        write_string(value.raw_data.data(), value.raw_data.size());
+        literal(",\"report_type\":");
+        write_name(report_type_names, value.type);
+        literal(",\"station_identifier\":");
+        write_string(value.identifier.data(), value.identifier.size());
+        literal(",\"observation_time\":");
+        write(value.observation_time);
+
+        if (value.modifier != metar_modifier_type::none)
+        {
+            literal(",\"report_modifier\":");
+            write_name(modifier_type_names, value.modifier);
+        }
+        if (value.wind_group)
+        {
+            literal(",\"wind\":");
+            write(*value.wind_group);
+        }
+        if (value.visibility_group)
+        {
+            literal(",\"visibility\":");
+            write(*value.visibility_group);
+        }
+        if (value.minimum_visibility_group)
+        {
+            literal(",\"minimum_visibility\":");
+            write(*value.minimum_visibility_group);
+        }
+        if (!value.runway_visual_range_group.empty())
+        {
+            literal(",\"runway_visual_range\":");
+            write_array(value.runway_visual_range_group);
+        }
+        if (!value.weather_group.empty())
+        {
+            literal(",\"weather\":");
+            write_array(value.weather_group);
+        }
+        if (!value.sky_condition_group.empty())
+        {
+            literal(",\"sky_condition\":");
+            write_array(value.sky_condition_group);
+        }
+        if (value.temperature || value.dewpoint)
+        {
+            literal(",\"temperature_dewpoint\":");
+            write_temperature_dewpoint(value.temperature, value.dewpoint);
+        }
+        if (value.altimeter_group)
+        {
+            literal(",\"altimeter\":");
+            write(*value.altimeter_group);
+        }
+        if (!value.recent_weather_group.empty())
+        {
+            literal(",\"recent_weather\":");
+            write_array(value.recent_weather_group);
+        }
+        if (!value.wind_shear_group.empty())
+        {
+            literal(",\"wind_shear\":");
+            write_array(value.wind_shear_group);
+        }
+        if (!value.trend_group.empty())
+        {
+            literal(",\"trend\":");
+            write_array(value.trend_group);
+        }
+        if (!value.remarks.empty())
+        {
+            literal(",\"remarks\":");
+            write_string(value.remarks.data(), value.remarks.size());
+        }
+        m_sink.put('}');
+    }
+
+private:
+    template <size_t Size>
+    void literal(const char (&text)[Size])
+    {
+        m_sink.put(text, Size - 1);
+    }
+
+    template <class TEnum, size_t Count>
+    void write_name(const name (&names)[Count], TEnum value)
+    {
+        auto const& entry = names[static_cast<size_t>(value)];
+        m_sink.put('"');
+        m_sink.put(entry.text, entry.size);
+        m_sink.put('"');
+    }
+
+    // Writes a comma before every field but the first of an object whose
+    // fields are all optional
+    void separator(bool& first)
+    {
+        if (!first)
+        {
+            m_sink.put(',');
+        }
+        first = false;
+    }
+
+    void write_unsigned(uint64_t value)
+    {
+        char digits[20];
+        size_t count = 0;
+        do
+        {
+            digits[sizeof(digits) - ++count] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        m_sink.put(digits + sizeof(digits) - count, count);
+    }
+
+    void write_signed(int64_t value)
+    {
+        if (value < 0)
+        {
+            m_sink.put('-');
+            write_unsigned(0 - static_cast<uint64_t>(value));
+        }
+        else
+        {
+            write_unsigned(static_cast<uint64_t>(value));
+        }
+    }
+
+    // Decoded distances and pressures have at most four decimal places, so
+    // they are written exactly as an integer and a fraction. Other values
+    // fall back to the shortest-safe general format. JSON has no infinity
+    // or NaN, which are written as null.
+    void write_number(double value)
+    {
+        // Below this the scaled value is an exact integer at every scale
+        auto magnitude = std::fabs(value);
+        if (magnitude < 9.0e11)
+        {
+            for (size_t i = 0; i < sizeof(decimal_scales) / sizeof(decimal_scales[0]); ++i)
+            {
+                auto digits = static_cast<uint64_t>(magnitude * decimal_scales[i] + 0.5);
+                if (static_cast<double>(digits) / decimal_scales[i] == magnitude)
+                {
+                    if (value < 0.0)
+                    {
+                        m_sink.put('-');
+                    }
+                    write_unsigned(digits / decimal_divisors[i]);
+                    if (i != 0)
+                    {
+                        write_fraction(digits % decimal_divisors[i], i);
+                    }
+                    return;
+                }
+            }
+        }
+
+        if (!std::isfinite(value))
+        {
+            literal("null");
+            return;
+        }
+
+        char text[32];
+        auto size = snprintf(text, sizeof(text), "%.17g", value);
+        for (auto j = 0; j < size; ++j)
+        {
+            // The decimal point of the current locale
+            if (text[j] == ',')
+            {
+                text[j] = '.';
+            }
+        }
+        m_sink.put(text, static_cast<size_t>(size));
+    }
+
+    void write_fraction(uint64_t value, size_t places)
+    {
+        char digits[8];
+        digits[0] = '.';
+        for (auto i = places; i > 0; --i)
+        {
+            digits[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+        m_sink.put(digits, places + 1);
+    }
+
+    // Runs of characters that need no escape are copied at once
+    void write_string(const char* data, size_t size)
+    {
+        m_sink.put('"');
+        size_t start = 0;
+        for (auto i = find_escape(data, 0, size); i < size; i = find_escape(data, start, size))
+        {
+            m_sink.put(data + start, i - start);
+            start = i + 1;
+
+            auto c = static_cast<unsigned char>(data[i]);
+            switch (c)
+            {
+            case '"':  literal("\\\""); break;
+            case '\\': literal("\\\\"); break;
+            case '\b': literal("\\b"); break;
+            case '\f': literal("\\f"); break;
+            case '\n': literal("\\n"); break;
+            case '\r': literal("\\r"); break;
+            case '\t': literal("\\t"); break;
+            default:
+                {
+                    char escape[] = { '\\', 'u', '0', '0', hex_digits[c >> 4], hex_digits[c & 0x0F] };
+                    m_sink.put(escape, sizeof(escape));
+                }
+                break;
+            }
+        }
+        m_sink.put(data + start, size - start);
+        m_sink.put('"');
+    }
+
+    template <class TValue>
+    void write_array(std::vector<TValue> const& values)
+    {
+        m_sink.put('[');
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            if (i != 0)
+            {
+                m_sink.put(',');
+            }
+            write(values[i]);
+        }
+        m_sink.put(']');
+    }
+
+    void write(time const& value)
+    {
+        literal("{\"day_of_month\":");
+        write_unsigned(value.day_of_month);
+        literal(",\"hour_of_day\":");
+        write_unsigned(value.hour_of_day);
+        literal(",\"minute_of_hour\":");
+        write_unsigned(value.minute_of_hour);
+        m_sink.put('}');
+    }
+
+    void write(wind const& value)
+    {
+        literal("{\"unit\":");
+        write_name(speed_unit_names, value.unit);
+        literal(",\"direction\":");
+        write_unsigned(value.direction);
+        literal(",\"wind_speed\":");
+        write_unsigned(value.wind_speed);
+        if (value.gust_speed != 0)
+        {
+            literal(",\"gust_speed\":");
+            write_unsigned(value.gust_speed);
+        }
+        if (value.variation_lower && value.variation_upper)
+        {
+            literal(",\"variation_lower\":");
+            write_unsigned(*value.variation_lower);
+            literal(",\"variation_upper\":");
+            write_unsigned(*value.variation_upper);
+        }
+        m_sink.put('}');
+    }
+
+    void write_visibility_fields(visibility const& value)
+    {
+        literal("{\"unit\":");
+        write_name(distance_unit_names, value.unit);
+        literal(",\"distance\":");
+        write_number(value.distance);
+        if (value.modifier != visibility_modifier_type::none)
+        {
+            literal(",\"modifier\":");
+            write_name(visibility_modifier_names, value.modifier);
+        }
+    }
+
+    void write(visibility const& value)
+    {
+        write_visibility_fields(value);
+        m_sink.put('}');
+    }
+
+    void write(directional_visibility const& value)
+    {
+        write_visibility_fields(value.distance);
+        literal(",\"direction\":");
+        write_name(compass_direction_names, value.direction);
+        m_sink.put('}');
+    }
+
+    // The minimum and maximum share a unit
+    void write(runway_visual_range const& value)
+    {
+        literal("{\"unit\":");
+        write_name(distance_unit_names, value.visibility_min.unit);
+        literal(",\"runway_number\":");
+        write_unsigned(value.runway_number);
+        if (value.runway_designator != runway_designator_type::none)
+        {
+            literal(",\"runway_designator\":");
+            write_name(runway_designator_names, value.runway_designator);
+        }
+        literal(",\"visibility_min\":");
+        write_number(value.visibility_min.distance);
+        if (value.visibility_min.modifier != visibility_modifier_type::none)
+        {
+            literal(",\"visibility_min_modifier\":");
+            write_name(visibility_modifier_names, value.visibility_min.modifier);
+        }
+        literal(",\"visibility_max\":");
+        write_number(value.visibility_max.distance);
+        if (value.visibility_max.modifier != visibility_modifier_type::none)
+        {
+            literal(",\"visibility_max_modifier\":");
+            write_name(visibility_modifier_names, value.visibility_max.modifier);
+        }
+        if (value.tendency != rvr_tendency::none)
+        {
+            literal(",\"tendency\":");
+            write_name(rvr_tendency_names, value.tendency);
+        }
+        m_sink.put('}');
+    }
+
+    void write(weather const& value)
+    {
+        bool first = true;
+        m_sink.put('{');
+        if (value.intensity != weather_intensity::moderate)
+        {
+            separator(first);
+            literal("\"intensity\":");
+            write_name(weather_intensity_names, value.intensity);
+        }
+        if (value.descriptor != weather_descriptor::none)
+        {
+            separator(first);
+            literal("\"descriptor\":");
+            write_name(weather_descriptor_names, value.descriptor);
+        }
+        if (!value.phenomena.empty())
+        {
+            separator(first);
+            literal("\"phenomena\":[");
+            for (size_t i = 0; i < value.phenomena.size(); ++i)
+            {
+                if (i != 0)
+                {
+                    m_sink.put(',');
+                }
+                write_name(weather_phenomena_names, value.phenomena[i]);
+            }
+            m_sink.put(']');
+        }
+        m_sink.put('}');
+    }
+
+    // Clear skies have no clouds rather than clouds of an unknown type
+    void write(cloud_layer const& value)
+    {
+        literal("{\"sky_cover\":");
+        write_name(sky_cover_type_names, value.sky_cover);
+        if (value.unit != distance_unit::feet)
+        {
+            literal(",\"unit\":");
+            write_name(distance_unit_names, value.unit);
+        }
+        if (!value.is_unlimited())
+        {
+            literal(",\"layer_height\":");
+            write_unsigned(value.layer_height);
+        }
+
+        auto noClouds = value.sky_cover == sky_cover_type::clear_below_12000 || value.sky_cover == sky_cover_type::sky_clear ||
+            value.sky_cover == sky_cover_type::no_significant_cloud || value.sky_cover == sky_cover_type::no_cloud_detected;
+        if (value.cloud_type != (noClouds ? sky_cover_cloud_type::none : sky_cover_cloud_type::unspecified))
+        {
+            literal(",\"cloud_type\":");
+            write_name(sky_cover_cloud_type_names, value.cloud_type);
+        }
+        m_sink.put('}');
+    }
+
+    void write_temperature_dewpoint(util::optional<int8_t> const& temperature, util::optional<int8_t> const& dewpoint)
+    {
+        bool first = true;
+        m_sink.put('{');
+        if (temperature)
+        {
+            separator(first);
+            literal("\"temperature\":");
+            write_signed(*temperature);
+        }
+        if (dewpoint)
+        {
+            separator(first);
+            literal("\"dewpoint\":");
+            write_signed(*dewpoint);
+        }
+        m_sink.put('}');
+    }
+
+    void write(altimeter const& value)
+    {
+        literal("{\"unit\":");
+        write_name(pressure_unit_names, value.unit);
+        literal(",\"pressure\":");
+        write_number(value.pressure);
+        m_sink.put('}');
+    }
+
+    void write(runway_wind_shear const& value)
+    {
+        if (value.all_runways)
+        {
+            literal("{\"all_runways\":true}");
+            return;
+        }
+
+        literal("{\"all_runways\":false,\"runway_number\":");
+        write_unsigned(value.runway_number);
+        if (value.runway_designator != runway_designator_type::none)
+        {
+            literal(",\"runway_designator\":");
+            write_name(runway_designator_names, value.runway_designator);
+        }
+        m_sink.put('}');
+    }
+
+    void write(metar_trend const& value)
+    {
+        literal("{\"type\":");
+        write_name(trend_type_names, value.type);
+        if (value.from)
+        {
+            literal(",\"from\":");
+            write(*value.from);
+        }
+        if (value.until)
+        {
+            literal(",\"until\":");
+            write(*value.until);
+        }
+        if (value.at)
+        {
+            literal(",\"at\":");
+            write(*value.at);
+        }
+        if (value.wind_group)
+        {
+            literal(",\"wind\":");
+            write(*value.wind_group);
+        }
+        if (value.visibility_group)
+        {
+            literal(",\"visibility\":");
+            write(*value.visibility_group);
+        }
+        if (!value.weather_group.empty())
+        {
+            literal(",\"weather\":");
+            write_array(value.weather_group);
+        }
+        if (value.no_significant_weather)
+        {
+            literal(",\"no_significant_weather\":true");
+        }
+        if (!value.sky_condition_group.empty())
+        {
+            literal(",\"sky_condition\":");
+            write_array(value.sky_condition_group);
+        }
+        m_sink.put('}');
+    }
+
+private:
+    array_sink& m_sink;
+};
+
+//-----------------------------------------------------------------------------
+
+template <class TReport>
+size_t write_report(TReport const& report, char* buffer, size_t capacity)
+{
+    array_sink sink(buffer, capacity);
+    json_writer(sink).write_report(report);
+    return sink.size();
+}
+
+// Writing through the fixed buffer sink is much faster than appending each
+// piece to the string, so the string grows by an estimate first. Reports
+// with unusually long text or many groups are written again.
+template <class TReport>
+void write_report(TReport const& report, std::string& buffer, bool newline)
+{
+    auto offset = buffer.size();
+    auto estimate = report_size_estimate + 2 * (report.raw_data.size() + report.remarks.size());
+    buffer.resize(offset + estimate);
+
+    auto size = write_report(report, &buffer[offset], estimate);
+    if (size > estimate)
+    {
+        buffer.resize(offset + size);
+        write_report(report, &buffer[offset], size);
+    }
+
+    buffer.resize(offset + size);
+    if (newline)
+    {
+        buffer.push_back('\n');
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+void write_json(metar const& report, std::string& buffer)
+{
+    write_report(report, buffer, false);
+}
+
+void write_json(metar_view const& report, std::string& buffer)
+{
+    write_report(report, buffer, false);
+}
+
+size_t write_json(metar const& report, char* buffer, size_t capacity)
+{
+    return write_report(report, buffer, capacity);
+}
+
+size_t write_json(metar_view const& report, char* buffer, size_t capacity)
+{
+    return write_report(report, buffer, capacity);
+}
+
+//-----------------------------------------------------------------------------
+
+void write_json(metar const* reports, size_t count, std::string& buffer)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        write_report(reports[i], buffer, true);
+    }
+}
+
+void write_json(std::vector<metar> const& reports, std::string& buffer)
+{
+    write_json(reports.data(), reports.size(), buffer);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -0,0 +1,143 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/types.h>
+
+#include "mapped_file.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace aw
+{
+namespace detail
+{
+
+//-----------------------------------------------------------------------------
+
+#ifdef _WIN32
+
+mapped_file::mapped_file(std::string const& path) :
+    m_data(nullptr),
+    m_size(0),
+    m_file(INVALID_HANDLE_VALUE),
+    m_mapping(nullptr)
+{
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        throw aw_exception("Unable to open the file");
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || static_cast<uint64_t>(size.QuadPart) > SIZE_MAX)
+    {
+        close();
+        throw aw_exception("Unable to map the file");
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+
+    // Empty files cannot be mapped
+    if (m_size == 0)
+    {
+        return;
+    }
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping != nullptr)
+    {
+        m_data = static_cast<uint8_t const*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (m_data == nullptr)
+    {
+        close();
+        throw aw_exception("Unable to map the file");
+    }
+}
+
+void mapped_file::close()
+{
+    if (m_data != nullptr)
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != nullptr)
+    {
+        CloseHandle(m_mapping);
+    }
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_file);
+    }
+}
+
+#else
+
+mapped_file::mapped_file(std::string const& path) :
+    m_data(nullptr),
+    m_size(0)
+{
+    auto file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        throw aw_exception("Unable to open the file");
+    }
+
+    struct stat status;
+    auto valid = fstat(file, &status) == 0;
+    if (valid && status.st_size > 0)
+    {
+        m_size = static_cast<size_t>(status.st_size);
+        auto data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (data != MAP_FAILED)
+        {
+            m_data = static_cast<uint8_t const*>(data);
+        }
+    }
+
+    // The mapping outlives the descriptor. Empty files cannot be mapped.
+    ::close(file);
+    if (!valid || (m_size != 0 && m_data == nullptr))
+    {
+        m_size = 0;
+        throw aw_exception("Unable to map the file");
+    }
+}
+
+void mapped_file::close()
+{
+    if (m_data != nullptr)
+    {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+}
+
+#endif
+
+mapped_file::~mapped_file()
+{
+    close();
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace detail
+} // namespace aw
@@ -0,0 +1,71 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace aw
+{
+namespace detail
+{
+
+//-----------------------------------------------------------------------------
+
+// Read-only mapping of a whole file. Empty files are not mapped and have no
+// data. Throws aw_exception if the file cannot be opened or mapped.
+class mapped_file
+{
+public:
+    explicit mapped_file(std::string const& path);
+    ~mapped_file();
+
+    mapped_file(mapped_file const&) = delete;
+    mapped_file& operator= (mapped_file const&) = delete;
+
+    uint8_t const* data() const
+    {
+        return m_data;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+private:
+    void close();
+
+private:
+    uint8_t const* m_data;
+    size_t         m_size;
+#ifdef _WIN32
+    HANDLE         m_file;
+    HANDLE         m_mapping;
+#endif
+};
+
+//-----------------------------------------------------------------------------
+
+} // namespace detail
+} // namespace aw
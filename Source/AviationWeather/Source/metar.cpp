@@ -18,15 +18,18 @@
 #include <AviationWeather/metar.h>
 
 #include <algorithm>
-#include <ctime>
-#include <regex>
 #include <string>
-#include <map>
+#include <vector>
 
 #include <AviationWeather/converters.h>
+#include <AviationWeather/derived_quantities.h>
 #include <AviationWeather/optional.h>
 
-#include "parsers.h"
+#include "flight_rules.h"
+#include "hash.h"
+#include "metar_decoders.h"
+#include "token_decoders.h"
+#include "tokens.h"
 #include "utility.h"
 
 //-----------------------------------------------------------------------------
@@ -36,6 +39,373 @@ namespace aw
 
 //-----------------------------------------------------------------------------
 
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const uint32_t g_bodyGroups = ~(metar_group_trend_time | metar_group_no_significant_weather);
+const uint32_t g_trendGroups = metar_group_wind | metar_group_visibility | metar_group_weather |
+    metar_group_sky_condition | metar_group_trend | metar_group_trend_time |
+    metar_group_no_significant_weather | metar_group_remarks;
+
+bool is_station_identifier(util::string_view const& token)
+{
+    if (token.size() != 4)
+    {
+        return false;
+    }
+    for (auto c : token)
+    {
+        if (!is_digit(c) && (c < 'A' || c > 'Z'))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+// Walks the report token by token, assigning the typed groups directly onto
+// the target. After the header, each token is offered only to the groups its
+// leading character allows (see metar_group_candidates), in order, so adding
+// a group does not slow down reports that do not use it. Tokens that are not
+// any group are skipped. The free-text fields are reported through the
+// callback as an offset and length into rawData so that the caller can decide
+// whether to copy them or refer to them in place.
+template <class TReport, class TLambda>
+void parse_report(util::string_view const& rawData, TReport& report, TLambda && l)
+{
+    std::vector<util::string_view> tokens;
+    tokens.reserve(32);
+    for_each_token(rawData, [&](util::string_view const& token)
+    {
+        // ICAO reports end with '='
+        auto length = token.size();
+        while (length > 0 && token[length - 1] == '=')
+        {
+            --length;
+        }
+        if (length > 0)
+        {
+            tokens.push_back(token.substr(0, length));
+        }
+    });
+
+    auto offset = [&](util::string_view const& token)
+    {
+        return static_cast<size_t>(token.data() - rawData.data());
+    };
+
+    // Header: [METAR|SPECI] [COR] CCCC ddhhmmZ [AUTO|COR|NIL]
+    size_t i = 0;
+    if (i < tokens.size() && (tokens[i] == "METAR" || tokens[i] == "SPECI"))
+    {
+        report.type = tokens[i++] == "METAR" ? metar_report_type::metar : metar_report_type::special;
+    }
+    if (i < tokens.size() && tokens[i] == "COR")
+    {
+        report.modifier = metar_modifier_type::corrected;
+        ++i;
+    }
+    if (i < tokens.size() && is_station_identifier(tokens[i]))
+    {
+        l(metar_element_type::station_identifier, offset(tokens[i]), tokens[i].size());
+        ++i;
+    }
+    if (i < tokens.size() && tokens[i].size() == 7 && tokens[i][6] == 'Z' && are_digits(tokens[i], 0, 6))
+    {
+        report.observation_time = time(static_cast<uint8_t>(to_number(tokens[i], 0, 2)),
+            static_cast<uint8_t>(to_number(tokens[i], 2, 2)), static_cast<uint8_t>(to_number(tokens[i], 4, 2)));
+        ++i;
+    }
+    for (; i < tokens.size() && (tokens[i] == "AUTO" || tokens[i] == "COR" || tokens[i] == "NIL"); ++i)
+    {
+        if (tokens[i] != "NIL")
+        {
+            report.modifier = tokens[i] == "AUTO" ? metar_modifier_type::automatic : metar_modifier_type::corrected;
+        }
+    }
+
+    metar_trend* trend = nullptr;
+
+    for (; i < tokens.size(); ++i)
+    {
+        auto const& token = tokens[i];
+        auto candidates = metar_group_candidates(token) & (trend == nullptr ? g_bodyGroups : g_trendGroups);
+
+        // Try each candidate group, lowest bit first
+        while (candidates != 0)
+        {
+            auto group = candidates & (~candidates + 1);
+            candidates &= candidates - 1;
+
+            switch (group)
+            {
+            case metar_group_wind:
+            {
+                wind windGroup;
+                if (!decode_wind_token(token, windGroup))
+                {
+                    continue;
+                }
+                (trend != nullptr ? trend->wind_group : report.wind_group) = windGroup;
+                break;
+            }
+            case metar_group_wind_variation:
+                if (!report.wind_group || !decode_wind_variation_token(token, *report.wind_group))
+                {
+                    continue;
+                }
+                break;
+            case metar_group_visibility:
+            {
+                // Groups are ordered, so only the first visibility is taken
+                // and stray four-digit tokens later in the body are skipped.
+                auto& target = trend != nullptr ? trend->visibility_group : report.visibility_group;
+                if (target)
+                {
+                    continue;
+                }
+
+                // The whole-number part of 1 1/2SM is a separate token
+                visibility visibilityGroup;
+                if (i + 1 < tokens.size() && decode_visibility_token(token, tokens[i + 1], visibilityGroup))
+                {
+                    ++i;
+                }
+                else if (!decode_visibility_token(token, visibilityGroup))
+                {
+                    continue;
+                }
+                target = visibilityGroup;
+                break;
+            }
+            case metar_group_minimum_visibility:
+            {
+                directional_visibility minimum;
+                if (!report.visibility_group || report.minimum_visibility_group || !decode_minimum_visibility_token(token, minimum))
+                {
+                    continue;
+                }
+                report.minimum_visibility_group = minimum;
+                break;
+            }
+            case metar_group_runway_visual_range:
+            {
+                runway_visual_range rvr;
+                if (!decode_runway_visual_range_token(token, rvr))
+                {
+                    continue;
+                }
+                report.runway_visual_range_group.push_back(std::move(rvr));
+                break;
+            }
+            case metar_group_recent_weather:
+            {
+                weather weatherGroup;
+                if (!decode_recent_weather_token(token, weatherGroup))
+                {
+                    continue;
+                }
+                report.recent_weather_group.push_back(std::move(weatherGroup));
+                break;
+            }
+            case metar_group_weather:
+            {
+                weather weatherGroup;
+                if (!decode_weather_token(token, weatherGroup))
+                {
+                    continue;
+                }
+                (trend != nullptr ? trend->weather_group : report.weather_group).push_back(std::move(weatherGroup));
+                break;
+            }
+            case metar_group_sky_condition:
+            {
+                cloud_layer skyCondition;
+                if (!decode_sky_condition_token(token, skyCondition))
+                {
+                    continue;
+                }
+                (trend != nullptr ? trend->sky_condition_group : report.sky_condition_group).push_back(std::move(skyCondition));
+                break;
+            }
+            case metar_group_temperature_dewpoint:
+            {
+                temperature_dewpoint value;
+                if (!decode_temperature_dewpoint_token(token, value))
+                {
+                    continue;
+                }
+                report.temperature = value.first;
+                report.dewpoint = value.second;
+                break;
+            }
+            case metar_group_altimeter:
+            {
+                altimeter altimeterGroup;
+                if (!decode_altimeter_token(token, altimeterGroup))
+                {
+                    continue;
+                }
+                report.altimeter_group = altimeterGroup;
+                break;
+            }
+            case metar_group_wind_shear:
+            {
+                // WS R24, WS RWY24L, WS ALL RWY, and the older WS TKOF/LDG RWY24
+                if (token != "WS" || i + 1 >= tokens.size())
+                {
+                    continue;
+                }
+                auto next = i + 1;
+                if (tokens[next] == "TKOF" || tokens[next] == "LDG")
+                {
+                    ++next;
+                }
+
+                runway_wind_shear windShear;
+                if (next + 1 < tokens.size() && tokens[next] == "ALL" && tokens[next + 1] == "RWY")
+                {
+                    windShear.all_runways = true;
+                    ++next;
+                }
+                else if (next >= tokens.size() || !decode_wind_shear_runway_token(tokens[next], windShear))
+                {
+                    continue;
+                }
+                report.wind_shear_group.push_back(std::move(windShear));
+                i = next;
+                break;
+            }
+            case metar_group_trend:
+            {
+                metar_trend trendGroup;
+                if (token == "NOSIG")
+                {
+                    trendGroup.type = metar_trend_type::no_significant_change;
+                }
+                else if (token == "BECMG" || token == "TEMPO")
+                {
+                    trendGroup.type = token == "BECMG" ? metar_trend_type::becoming : metar_trend_type::temporary;
+                }
+                else
+                {
+                    continue;
+                }
+                report.trend_group.push_back(std::move(trendGroup));
+                trend = &report.trend_group.back();
+                break;
+            }
+            case metar_group_trend_time:
+                if (!decode_trend_time_token(token, report.observation_time, *trend))
+                {
+                    continue;
+                }
+                break;
+            case metar_group_no_significant_weather:
+                if (token != "NSW")
+                {
+                    continue;
+                }
+                trend->no_significant_weather = true;
+                break;
+            case metar_group_remarks:
+            {
+                if (token != "RMK")
+                {
+                    continue;
+                }
+                auto start = offset(token) + token.size() + 1;
+                if (start <= rawData.size())
+                {
+                    l(metar_element_type::remarks, start, rawData.size() - start);
+                }
+                return;
+            }
+            }
+            break;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+int16_t find_temperature_dewpoint_spread(util::optional<int8_t> const& temperature, util::optional<int8_t> const& dewpoint)
+{
+    if (!temperature || !dewpoint)
+    {
+        throw aw_exception("Missing temperature or dewpoint");
+    }
+    return *temperature - *dewpoint;
+}
+
+template <class TReport>
+double find_relative_humidity(TReport const& report)
+{
+    if (!report.temperature || !report.dewpoint)
+    {
+        throw aw_exception("Missing temperature or dewpoint");
+    }
+    return relative_humidity(*report.temperature, *report.dewpoint);
+}
+
+template <class TReport>
+double altimeter_hpa(TReport const& report)
+{
+    if (!report.altimeter_group)
+    {
+        throw aw_exception("Missing altimeter setting");
+    }
+    return convert(report.altimeter_group->pressure, report.altimeter_group->unit, pressure_unit::hPa);
+}
+
+template <class TReport>
+double find_density_altitude(TReport const& report, double elevation)
+{
+    if (!report.temperature)
+    {
+        throw aw_exception("Missing temperature");
+    }
+    return density_altitude(altimeter_hpa(report), elevation, *report.temperature);
+}
+
+template <class TReport>
+double find_wind_chill(TReport const& report)
+{
+    if (!report.temperature || !report.wind_group)
+    {
+        throw aw_exception("Missing temperature or wind");
+    }
+    return wind_chill(*report.temperature,
+        convert(report.wind_group->wind_speed, report.wind_group->unit, speed_unit::kt));
+}
+
+template <class TReport>
+double find_heat_index(TReport const& report)
+{
+    // Checks that the temperature is present before it is used
+    auto humidity = find_relative_humidity(report);
+    return heat_index(*report.temperature, humidity);
+}
+
+// Content hash of a report with no groups, as left by default construction
+// and by moving from a report. Only the observation time varies, so the other
+// fields are hashed once, from a view over no text.
+uint64_t empty_content_hash(time const& observationTime)
+{
+    static const uint64_t fields = hash_content_fields(metar_view(util::string_view()));
+    return finish_content_hash(fields, observationTime);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
 altimeter::altimeter() :
     unit(pressure_unit::hPa),
     pressure(0.0)
@@ -120,12 +490,14 @@ bool altimeter::operator>(altimeter const& rhs) const
 
 runway_visual_range::runway_visual_range() :
     runway_number(0U),
-    runway_designator(runway_designator_type::none)
+    runway_designator(runway_designator_type::none),
+    tendency(rvr_tendency::none)
 {}
 
 runway_visual_range::runway_visual_range(runway_visual_range && other) :
     runway_number(0U),
-    runway_designator(runway_designator_type::none)
+    runway_designator(runway_designator_type::none),
+    tendency(rvr_tendency::none)
 {
     *this = std::move(other);
 }
@@ -138,11 +510,13 @@ runway_visual_range& runway_visual_range::operator=(runway_visual_range && rhs)
         runway_designator = rhs.runway_designator;
         visibility_min = std::move(rhs.visibility_min);
         visibility_max = std::move(rhs.visibility_max);
+        tendency = rhs.tendency;
 
         rhs.runway_number = 0U;
         rhs.runway_designator = runway_designator_type::none;
         rhs.visibility_min = visibility();
         rhs.visibility_max = visibility();
+        rhs.tendency = rvr_tendency::none;
     }
     return *this;
 }
@@ -152,7 +526,8 @@ bool runway_visual_range::operator== (runway_visual_range const& rhs) const
     return (runway_number == rhs.runway_number) &&
         (runway_designator == rhs.runway_designator) &&
         (visibility_min == rhs.visibility_min) &&
-        (visibility_max == rhs.visibility_max);
+        (visibility_max == rhs.visibility_max) &&
+        (tendency == rhs.tendency);
 }
 
 bool runway_visual_range::operator!= (runway_visual_range const& rhs) const
@@ -167,6 +542,144 @@ bool runway_visual_range::is_variable() const
 
 //-----------------------------------------------------------------------------
 
+directional_visibility::directional_visibility() :
+    direction(compass_direction::north)
+{}
+
+directional_visibility::directional_visibility(directional_visibility && other) :
+    direction(compass_direction::north)
+{
+    *this = std::move(other);
+}
+
+directional_visibility& directional_visibility::operator=(directional_visibility && rhs)
+{
+    if (this != &rhs)
+    {
+        distance = std::move(rhs.distance);
+        direction = rhs.direction;
+
+        rhs.distance = visibility();
+        rhs.direction = compass_direction::north;
+    }
+    return *this;
+}
+
+bool directional_visibility::operator== (directional_visibility const& rhs) const
+{
+    return (distance == rhs.distance) &&
+        (direction == rhs.direction);
+}
+
+bool directional_visibility::operator!= (directional_visibility const& rhs) const
+{
+    return !(*this == rhs);
+}
+
+//-----------------------------------------------------------------------------
+
+runway_wind_shear::runway_wind_shear() :
+    all_runways(false),
+    runway_number(0U),
+    runway_designator(runway_designator_type::none)
+{}
+
+runway_wind_shear::runway_wind_shear(runway_wind_shear && other) :
+    all_runways(false),
+    runway_number(0U),
+    runway_designator(runway_designator_type::none)
+{
+    *this = std::move(other);
+}
+
+runway_wind_shear& runway_wind_shear::operator=(runway_wind_shear && rhs)
+{
+    if (this != &rhs)
+    {
+        all_runways = rhs.all_runways;
+        runway_number = rhs.runway_number;
+        runway_designator = rhs.runway_designator;
+
+        rhs.all_runways = false;
+        rhs.runway_number = 0U;
+        rhs.runway_designator = runway_designator_type::none;
+    }
+    return *this;
+}
+
+bool runway_wind_shear::operator== (runway_wind_shear const& rhs) const
+{
+    return (all_runways == rhs.all_runways) &&
+        (runway_number == rhs.runway_number) &&
+        (runway_designator == rhs.runway_designator);
+}
+
+bool runway_wind_shear::operator!= (runway_wind_shear const& rhs) const
+{
+    return !(*this == rhs);
+}
+
+//-----------------------------------------------------------------------------
+
+metar_trend::metar_trend() :
+    type(metar_trend_type::no_significant_change),
+    no_significant_weather(false)
+{}
+
+metar_trend::metar_trend(metar_trend && other) :
+    type(metar_trend_type::no_significant_change),
+    no_significant_weather(false)
+{
+    *this = std::move(other);
+}
+
+metar_trend& metar_trend::operator=(metar_trend && rhs)
+{
+    if (this != &rhs)
+    {
+        type = rhs.type;
+        from = std::move(rhs.from);
+        until = std::move(rhs.until);
+        at = std::move(rhs.at);
+        wind_group = std::move(rhs.wind_group);
+        visibility_group = std::move(rhs.visibility_group);
+        weather_group = std::move(rhs.weather_group);
+        no_significant_weather = rhs.no_significant_weather;
+        sky_condition_group = std::move(rhs.sky_condition_group);
+
+        rhs.type = metar_trend_type::no_significant_change;
+        rhs.from = util::nullopt;
+        rhs.until = util::nullopt;
+        rhs.at = util::nullopt;
+        rhs.wind_group = util::nullopt;
+        rhs.visibility_group = util::nullopt;
+        rhs.weather_group.clear();
+        rhs.no_significant_weather = false;
+        rhs.sky_condition_group.clear();
+    }
+    return *this;
+}
+
+bool metar_trend::operator== (metar_trend const& rhs) const
+{
+    return (type == rhs.type) &&
+        (from == rhs.from) &&
+        (until == rhs.until) &&
+        (at == rhs.at) &&
+        (wind_group == rhs.wind_group) &&
+        (visibility_group == rhs.visibility_group) &&
+        (weather_group == rhs.weather_group) &&
+        (no_significant_weather == rhs.no_significant_weather) &&
+        (sky_condition_group == rhs.sky_condition_group);
+}
+
+bool metar_trend::operator!= (metar_trend const& rhs) const
+{
+    return !(*this == rhs);
+}
+
+//-----------------------------------------------------------------------------
+
 metar::metar(std::string const& metar) :
     raw_data(metar),
     type(metar_report_type::metar),
@@ -174,12 +687,13 @@ metar::metar(std::string const& metar) :
     modifier(metar_modifier_type::none),
     temperature(util::nullopt),
     dewpoint(util::nullopt),
-    remarks("")
+    remarks(""),
+    m_contentHash(0)
 {
     parse();
 }
 
-metar::metar(metar && other) :
+metar::metar() :
     raw_data(""),
     type(metar_report_type::metar),
     identifier(""),
@@ -187,6 +701,19 @@ metar::metar(metar && other) :
     temperature(util::nullopt),
     dewpoint(util::nullopt),
     remarks("")
+{
+    m_contentHash = empty_content_hash(observation_time);
+}
+
+metar::metar(metar && other) :
+    raw_data(""),
+    type(metar_report_type::metar),
+    identifier(""),
+    modifier(metar_modifier_type::none),
+    temperature(util::nullopt),
+    dewpoint(util::nullopt),
+    remarks(""),
+    m_contentHash(0)
 {
     *this = std::move(other);
 }
@@ -202,13 +729,18 @@ metar& metar::operator=(metar && rhs)
         modifier = rhs.modifier;
         wind_group = std::move(rhs.wind_group);
         visibility_group = std::move(rhs.visibility_group);
+        minimum_visibility_group = std::move(rhs.minimum_visibility_group);
         runway_visual_range_group = std::move(rhs.runway_visual_range_group);
         weather_group = std::move(rhs.weather_group);
         sky_condition_group = std::move(rhs.sky_condition_group);
         temperature = rhs.temperature;
         dewpoint = rhs.dewpoint;
         altimeter_group = std::move(rhs.altimeter_group);
+        recent_weather_group = std::move(rhs.recent_weather_group);
+        wind_shear_group = std::move(rhs.wind_shear_group);
+        trend_group = std::move(rhs.trend_group);
         remarks = std::move(rhs.remarks);
+        m_contentHash = rhs.m_contentHash;
 
         rhs.raw_data = "";
         rhs.type = metar_report_type::metar;
@@ -217,13 +749,18 @@ metar& metar::operator=(metar && rhs)
         rhs.modifier = metar_modifier_type::none;
         rhs.wind_group = util::nullopt;
         rhs.visibility_group = util::nullopt;
+        rhs.minimum_visibility_group = util::nullopt;
         rhs.runway_visual_range_group.clear();
         rhs.weather_group.clear();
         rhs.sky_condition_group.clear();
         rhs.temperature = util::nullopt;
         rhs.dewpoint = util::nullopt;
         rhs.altimeter_group = util::nullopt;
+        rhs.recent_weather_group.clear();
+        rhs.wind_shear_group.clear();
+        rhs.trend_group.clear();
         rhs.remarks = "";
+        rhs.m_contentHash = empty_content_hash(rhs.observation_time);
     }
     return *this;
 }
@@ -236,12 +773,16 @@ bool metar::operator== (metar const& rhs) const
         (modifier == rhs.modifier) &&
         (wind_group == rhs.wind_group) &&
         (visibility_group == rhs.visibility_group) &&
+        (minimum_visibility_group == rhs.minimum_visibility_group) &&
         (runway_visual_range_group == rhs.runway_visual_range_group) &&
         (weather_group == rhs.weather_group) &&
         (sky_condition_group == rhs.sky_condition_group) &&
         (temperature == rhs.temperature) &&
         (dewpoint == rhs.dewpoint) &&
         (altimeter_group == rhs.altimeter_group) &&
+        (recent_weather_group == rhs.recent_weather_group) &&
+        (wind_shear_group == rhs.wind_shear_group) &&
+        (trend_group == rhs.trend_group) &&
         (remarks == rhs.remarks);
 }
 
@@ -252,72 +793,29 @@ bool metar::operator!= (metar const& rhs) const
 
 void metar::parse()
 {
-    std::string baseMetar = raw_data;
-
-    // We parse remarks first to avoid over-matching in earlier groups
-    baseMetar = parse_remarks(baseMetar, [&](std::string const& remarks)
+    parse_report(raw_data, *this, [&](metar_element_type element, size_t offset, size_t length)
     {
-        this->remarks = remarks;
+        if (element == metar_element_type::station_identifier)
+        {
+            this->identifier = raw_data.substr(offset, length);
+        }
+        else if (element == metar_element_type::remarks)
+        {
+            this->remarks = raw_data.substr(offset, length);
+        }
     });
 
-    baseMetar = parse_metar_report_type(baseMetar, [&](metar_report_type type)
-    {
-        this->type = type;
-    });
-    baseMetar = parse_station_identifier(baseMetar, [&](std::string const& identifier)
-    {
-        this->identifier = identifier;
-    });
-    baseMetar = parse_time(baseMetar, [&](time && observationTime)
-    {
-        this->observation_time = observationTime;
-    });
-    baseMetar = parse_metar_modifier(baseMetar, [&](metar_modifier_type type)
-    {
-        this->modifier = type;
-    });
-    baseMetar = parse_wind(baseMetar, [&](wind && windGroup)
-    {
-        this->wind_group = windGroup;
-    });
-    baseMetar = parse_visibility(baseMetar, [&](visibility && visibilityGroup)
-    {
-        this->visibility_group = visibilityGroup;
-    });
-    baseMetar = parse_runway_visual_range(baseMetar, [&](runway_visual_range && rvr)
-    {
-        this->runway_visual_range_group.push_back(rvr);
-    });
-    baseMetar = parse_weather(baseMetar, [&](weather && weatherGroup)
-    {
-        this->weather_group.push_back(weatherGroup);
-    });
-    baseMetar = parse_sky_condition(baseMetar, [&](cloud_layer && skyCondition)
-    {
-        this->sky_condition_group.push_back(skyCondition);
-    });
-    baseMetar = parse_temperature_dewpoint(baseMetar, [&](util::optional<int8_t> temperature, util::optional<int8_t> dewpoint)
-    {
-        this->temperature = temperature;
-        this->dewpoint = dewpoint;
-    });
-    baseMetar = parse_altimeter(baseMetar, [&](altimeter && altimeterGroup)
-    {
-        this->altimeter_group = altimeterGroup;
-    });
+    update_content_hash();
+}
+
+void metar::update_content_hash()
+{
+    m_contentHash = compute_content_hash(*this);
 }
 
 cloud_layer metar::ceiling_nothrow() const
 {
-    auto result = std::find_if(sky_condition_group.begin(), sky_condition_group.end(), [](cloud_layer layer)
-    {
-        return layer.sky_cover == sky_cover_type::broken ||
-            layer.sky_cover == sky_cover_type::overcast ||
-            layer.sky_cover == sky_cover_type::vertical_visibility ||
-            layer.sky_cover == sky_cover_type::sky_clear ||
-            layer.sky_cover == sky_cover_type::clear_below_12000;
-    });
-    return result != sky_condition_group.end() ? *result : cloud_layer();
+    return find_ceiling(sky_condition_group);
 }
 
 cloud_layer metar::ceiling() const
@@ -331,29 +829,229 @@ cloud_layer metar::ceiling() const
 
 flight_category metar::flight_category() const
 {
-    if (!visibility_group || sky_condition_group.empty())
+    return find_flight_category(visibility_group, sky_condition_group);
+}
+
+int16_t metar::temperature_dewpoint_spread() const
+{
+    return find_temperature_dewpoint_spread(temperature, dewpoint);
+}
+
+double metar::relative_humidity() const
+{
+    return find_relative_humidity(*this);
+}
+
+double metar::pressure_altitude(double elevation) const
+{
+    return aw::pressure_altitude(altimeter_hpa(*this), elevation);
+}
+
+double metar::density_altitude(double elevation) const
+{
+    return find_density_altitude(*this, elevation);
+}
+
+double metar::wind_chill() const
+{
+    return find_wind_chill(*this);
+}
+
+double metar::heat_index() const
+{
+    return find_heat_index(*this);
+}
+
+uint64_t metar::content_hash() const
+{
+    return m_contentHash;
+}
+
+//-----------------------------------------------------------------------------
+
+metar_view::metar_view(util::string_view const& metar) :
+    raw_data(metar),
+    type(metar_report_type::metar),
+    modifier(metar_modifier_type::none),
+    temperature(util::nullopt),
+    dewpoint(util::nullopt),
+    m_contentHash(0)
+{
+    parse_report(raw_data, *this, [&](metar_element_type element, size_t offset, size_t length)
     {
-        return flight_category::unknown;
-    }
+        if (element == metar_element_type::station_identifier)
+        {
+            this->identifier = raw_data.substr(offset, length);
+        }
+        else if (element == metar_element_type::remarks)
+        {
+            this->remarks = raw_data.substr(offset, length);
+        }
+    });
 
-    cloud_layer ceiling = ceiling_nothrow();
+    m_contentHash = compute_content_hash(*this);
+}
 
-    auto distanceSM = aw::convert(visibility_group->distance, visibility_group->unit, distance_unit::statute_miles);
+metar_view::metar_view(metar_view && other) :
+    type(metar_report_type::metar),
+    modifier(metar_modifier_type::none),
+    temperature(util::nullopt),
+    dewpoint(util::nullopt),
+    m_contentHash(0)
+{
+    *this = std::move(other);
+}
 
-    if (distanceSM >= 3.0 && ceiling.layer_height >= 1000L)
+metar_view& metar_view::operator=(metar_view && rhs)
+{
+    if (this != &rhs)
     {
-        return (distanceSM > 5.0 && ceiling.layer_height > 3000L) ? flight_category::vfr : flight_category::mvfr;
+        raw_data = rhs.raw_data;
+        type = rhs.type;
+        identifier = rhs.identifier;
+        observation_time = std::move(rhs.observation_time);
+        modifier = rhs.modifier;
+        wind_group = std::move(rhs.wind_group);
+        visibility_group = std::move(rhs.visibility_group);
+        minimum_visibility_group = std::move(rhs.minimum_visibility_group);
+        runway_visual_range_group = std::move(rhs.runway_visual_range_group);
+        weather_group = std::move(rhs.weather_group);
+        sky_condition_group = std::move(rhs.sky_condition_group);
+        temperature = rhs.temperature;
+        dewpoint = rhs.dewpoint;
+        altimeter_group = std::move(rhs.altimeter_group);
+        recent_weather_group = std::move(rhs.recent_weather_group);
+        wind_shear_group = std::move(rhs.wind_shear_group);
+        trend_group = std::move(rhs.trend_group);
+        remarks = rhs.remarks;
+        m_contentHash = rhs.m_contentHash;
+
+        rhs.raw_data = util::string_view();
+        rhs.type = metar_report_type::metar;
+        rhs.identifier = util::string_view();
+        rhs.observation_time = time();
+        rhs.modifier = metar_modifier_type::none;
+        rhs.wind_group = util::nullopt;
+        rhs.visibility_group = util::nullopt;
+        rhs.minimum_visibility_group = util::nullopt;
+        rhs.runway_visual_range_group.clear();
+        rhs.weather_group.clear();
+        rhs.sky_condition_group.clear();
+        rhs.temperature = util::nullopt;
+        rhs.dewpoint = util::nullopt;
+        rhs.altimeter_group = util::nullopt;
+        rhs.recent_weather_group.clear();
+        rhs.wind_shear_group.clear();
+        rhs.trend_group.clear();
+        rhs.remarks = util::string_view();
+        rhs.m_contentHash = empty_content_hash(rhs.observation_time);
     }
-    return (distanceSM >= 1.0 && ceiling.layer_height >= 500L) ? flight_category::ifr : flight_category::lifr;
+    return *this;
 }
 
-int16_t metar::temperature_dewpoint_spread() const
+bool metar_view::operator== (metar_view const& rhs) const
 {
-    if (!temperature || !dewpoint)
+    return (type == rhs.type) &&
+        (identifier == rhs.identifier) &&
+        (observation_time == rhs.observation_time) &&
+        (modifier == rhs.modifier) &&
+        (wind_group == rhs.wind_group) &&
+        (visibility_group == rhs.visibility_group) &&
+        (minimum_visibility_group == rhs.minimum_visibility_group) &&
+        (runway_visual_range_group == rhs.runway_visual_range_group) &&
+        (weather_group == rhs.weather_group) &&
+        (sky_condition_group == rhs.sky_condition_group) &&
+        (temperature == rhs.temperature) &&
+        (dewpoint == rhs.dewpoint) &&
+        (altimeter_group == rhs.altimeter_group) &&
+        (recent_weather_group == rhs.recent_weather_group) &&
+        (wind_shear_group == rhs.wind_shear_group) &&
+        (trend_group == rhs.trend_group) &&
+        (remarks == rhs.remarks);
+}
+
+bool metar_view::operator!= (metar_view const& rhs) const
+{
+    return !(*this == rhs);
+}
+
+cloud_layer metar_view::ceiling() const
+{
+    if (sky_condition_group.empty())
     {
-        throw aw_exception("Missing temperature or dewpoint");
+        throw aw_exception("Sky condition missing");
     }
-    return *temperature - *dewpoint;
+    return find_ceiling(sky_condition_group);
+}
+
+flight_category metar_view::flight_category() const
+{
+    return find_flight_category(visibility_group, sky_condition_group);
+}
+
+int16_t metar_view::temperature_dewpoint_spread() const
+{
+    return find_temperature_dewpoint_spread(temperature, dewpoint);
+}
+
+double metar_view::relative_humidity() const
+{
+    return find_relative_humidity(*this);
+}
+
+double metar_view::pressure_altitude(double elevation) const
+{
+    return aw::pressure_altitude(altimeter_hpa(*this), elevation);
+}
+
+double metar_view::density_altitude(double elevation) const
+{
+    return find_density_altitude(*this, elevation);
+}
+
+double metar_view::wind_chill() const
+{
+    return find_wind_chill(*this);
+}
+
+double metar_view::heat_index() const
+{
+    return find_heat_index(*this);
+}
+
+uint64_t metar_view::content_hash() const
+{
+    return m_contentHash;
+}
+
+metar metar_view::to_owned() const
+{
+    metar result;
+    result.raw_data = raw_data.to_string();
+    result.type = type;
+    result.identifier = identifier.to_string();
+    result.observation_time = observation_time;
+    result.modifier = modifier;
+    result.wind_group = wind_group;
+    result.visibility_group = visibility_group;
+    result.minimum_visibility_group = minimum_visibility_group;
+    result.runway_visual_range_group = runway_visual_range_group;
+    result.weather_group = weather_group;
+    result.sky_condition_group = sky_condition_group;
+    result.temperature = temperature;
+    result.dewpoint = dewpoint;
+    result.altimeter_group = altimeter_group;
+    result.recent_weather_group = recent_weather_group;
+    result.wind_shear_group = wind_shear_group;
+    result.trend_group = trend_group;
+    result.remarks = remarks.to_string();
+    result.m_contentHash = m_contentHash;
+    return result;
+}
+
+void metar_view::update_content_hash()
+{
+    m_contentHash = compute_content_hash(*this);
 }
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,251 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/metar_cache.h>
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "hash.h"
+
+namespace aw
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+// Heap footprint of weather groups, including their phenomena
+size_t approximate_size(std::vector<weather> const& groups)
+{
+    size_t size = groups.capacity() * sizeof(weather);
+    for (auto const& group : groups)
+    {
+        size += group.phenomena.capacity() * sizeof(weather_phenomena);
+    }
+    return size;
+}
+
+// Approximate heap footprint of a cached report, including the shared_ptr
+// control block and the LRU list and index nodes that refer to it.
+size_t approximate_size(metar const& report)
+{
+    const size_t bookkeeping = 96;
+
+    size_t size = sizeof(metar) + bookkeeping;
+    size += report.raw_data.capacity();
+    size += report.identifier.capacity();
+    size += report.remarks.capacity();
+    size += report.runway_visual_range_group.capacity() * sizeof(runway_visual_range);
+    size += report.sky_condition_group.capacity() * sizeof(cloud_layer);
+    size += approximate_size(report.weather_group);
+    size += approximate_size(report.recent_weather_group);
+    size += report.wind_shear_group.capacity() * sizeof(runway_wind_shear);
+    size += report.trend_group.capacity() * sizeof(metar_trend);
+    for (auto const& trend : report.trend_group)
+    {
+        size += approximate_size(trend.weather_group);
+        size += trend.sky_condition_group.capacity() * sizeof(cloud_layer);
+    }
+    return size;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+struct metar_cache::shard
+{
+    struct entry
+    {
+        uint64_t             hash;
+        size_t               size;
+        metar::const_pointer report;
+    };
+
+    typedef std::list<entry> lru_list;
+
+    explicit shard(size_t memoryLimit) :
+        memory_limit(memoryLimit),
+        bytes(0),
+        hits(0),
+        misses(0),
+        insertions(0),
+        evictions(0)
+    {}
+
+    // Must be called with the lock held. Moves a hit to the front of the list.
+    metar::const_pointer find_nolock(uint64_t hash, std::string const& metar)
+    {
+        auto it = index.find(hash);
+        if (it == index.end() || it->second->report->raw_data != metar)
+        {
+            return nullptr;
+        }
+
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->report;
+    }
+
+    // Must be called with the lock held
+    void insert_nolock(uint64_t hash, metar::const_pointer const& report)
+    {
+        auto size = approximate_size(*report);
+        if (size > memory_limit)
+        {
+            return;
+        }
+
+        // A different report with the same hash is replaced
+        auto existing = index.find(hash);
+        if (existing != index.end())
+        {
+            bytes -= existing->second->size;
+            entries.erase(existing->second);
+            index.erase(existing);
+        }
+
+        while (!entries.empty() && bytes + size > memory_limit)
+        {
+            auto const& victim = entries.back();
+            bytes -= victim.size;
+            index.erase(victim.hash);
+            entries.pop_back();
+            ++evictions;
+        }
+
+        entries.push_front(entry{ hash, size, report });
+        index[hash] = entries.begin();
+        bytes += size;
+        ++insertions;
+    }
+
+    std::mutex                                       mutex;
+    size_t                                           memory_limit;
+    size_t                                           bytes;
+    lru_list                                         entries;
+    std::unordered_map<uint64_t, lru_list::iterator> index;
+
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t insertions;
+    uint64_t evictions;
+};
+
+//-----------------------------------------------------------------------------
+
+metar_cache::metar_cache(size_t memoryLimit, size_t shardCount) :
+    m_memoryLimit(memoryLimit)
+{
+    if (shardCount == 0)
+    {
+        throw aw_exception("A metar cache requires at least one shard");
+    }
+
+    for (size_t i = 0; i < shardCount; ++i)
+    {
+        m_shards.emplace_back(new shard(memoryLimit / shardCount));
+    }
+}
+
+metar_cache::~metar_cache()
+{}
+
+metar::const_pointer metar_cache::parse(std::string const& metar)
+{
+    auto hash = hash_finalize(hash_bytes(metar.data(), metar.size()));
+    auto& s = shard_for(hash);
+
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto report = s.find_nolock(hash, metar);
+        if (report)
+        {
+            ++s.hits;
+            return report;
+        }
+        ++s.misses;
+    }
+
+    // Parse outside of the lock. If another thread parsed the same report in
+    // the meantime, the copy already in the cache is returned.
+    metar::const_pointer report = std::make_shared<const aw::metar>(metar);
+
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto existing = s.find_nolock(hash, metar);
+    if (existing)
+    {
+        return existing;
+    }
+    s.insert_nolock(hash, report);
+    return report;
+}
+
+metar::const_pointer metar_cache::find(std::string const& metar)
+{
+    auto hash = hash_finalize(hash_bytes(metar.data(), metar.size()));
+    auto& s = shard_for(hash);
+
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto report = s.find_nolock(hash, metar);
+    report ? ++s.hits : ++s.misses;
+    return report;
+}
+
+void metar_cache::clear()
+{
+    for (auto& s : m_shards)
+    {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        s->entries.clear();
+        s->index.clear();
+        s->bytes = 0;
+    }
+}
+
+size_t metar_cache::memory_limit() const
+{
+    return m_memoryLimit;
+}
+
+metar_cache_statistics metar_cache::statistics() const
+{
+    metar_cache_statistics result = { 0, 0, 0, 0, 0, 0 };
+    for (auto& s : m_shards)
+    {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        result.hits += s->hits;
+        result.misses += s->misses;
+        result.insertions += s->insertions;
+        result.evictions += s->evictions;
+        result.entries += s->index.size();
+        result.bytes += s->bytes;
+    }
+    return result;
+}
+
+metar_cache::shard& metar_cache::shard_for(uint64_t hash) const
+{
+    return *m_shards[static_cast<size_t>(hash >> 32) % m_shards.size()];
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
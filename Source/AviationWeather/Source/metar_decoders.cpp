@@ -0,0 +1,364 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include "metar_decoders.h"
+#include "token_decoders.h"
+#include "tokens.h"
+
+namespace aw
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+struct group_prefix
+{
+    const char* leading;  // Leading characters
+    uint32_t    groups;   // Groups that can start with any of them
+};
+
+const group_prefix g_groupPrefixes[] =
+{
+    { "0123456789", metar_group_wind | metar_group_wind_variation | metar_group_visibility |
+                    metar_group_minimum_visibility | metar_group_temperature_dewpoint },
+    { "M",          metar_group_visibility | metar_group_temperature_dewpoint | metar_group_weather },
+    { "P",          metar_group_visibility | metar_group_weather },
+    { "+-",         metar_group_weather },
+    { "V",          metar_group_wind | metar_group_sky_condition | metar_group_weather },
+    { "R",          metar_group_runway_visual_range | metar_group_recent_weather | metar_group_weather | metar_group_remarks },
+    { "C",          metar_group_visibility | metar_group_sky_condition },
+    { "S",          metar_group_sky_condition | metar_group_weather },
+    { "F",          metar_group_sky_condition | metar_group_weather | metar_group_trend_time },
+    { "B",          metar_group_sky_condition | metar_group_weather | metar_group_trend },
+    { "O",          metar_group_sky_condition },
+    { "N",          metar_group_sky_condition | metar_group_trend | metar_group_no_significant_weather },
+    { "T",          metar_group_weather | metar_group_trend | metar_group_trend_time },
+    { "A",          metar_group_altimeter | metar_group_trend_time },
+    { "Q",          metar_group_altimeter },
+    { "W",          metar_group_wind_shear },
+    { "DGHIU",      metar_group_weather }
+};
+
+// Candidate groups indexed by leading character
+class group_table
+{
+public:
+    group_table()
+    {
+        for (auto& groups : m_groups)
+        {
+            groups = 0;
+        }
+        for (auto const& prefix : g_groupPrefixes)
+        {
+            for (auto c = prefix.leading; *c; ++c)
+            {
+                m_groups[static_cast<uint8_t>(*c)] |= prefix.groups;
+            }
+        }
+    }
+
+    uint32_t operator[] (char c) const
+    {
+        return m_groups[static_cast<uint8_t>(c)];
+    }
+
+private:
+    uint32_t m_groups[256];
+};
+
+//-----------------------------------------------------------------------------
+
+const char* g_compassPoints[] = { "N", "NE", "E", "SE", "S", "SW", "W", "NW" };
+
+// Runway number and optional designator, returning the characters read
+size_t decode_runway(util::string_view const& token, size_t pos, uint8_t& number, runway_designator_type& designator)
+{
+    if (!are_digits(token, pos, 2))
+    {
+        return 0;
+    }
+    number = static_cast<uint8_t>(to_number(token, pos, 2));
+    designator = runway_designator_type::none;
+
+    if (pos + 2 < token.size())
+    {
+        switch (token[pos + 2])
+        {
+        case 'L': designator = runway_designator_type::left; return 3;
+        case 'R': designator = runway_designator_type::right; return 3;
+        case 'C': designator = runway_designator_type::center; return 3;
+        }
+    }
+    return 2;
+}
+
+// [M|P]dddd, returning the characters read
+size_t decode_rvr_value(util::string_view const& token, size_t pos, uint16_t& value, visibility_modifier_type& modifier)
+{
+    auto start = pos;
+    modifier = visibility_modifier_type::none;
+    if (pos < token.size() && (token[pos] == 'M' || token[pos] == 'P'))
+    {
+        modifier = token[pos] == 'M' ? visibility_modifier_type::less_than : visibility_modifier_type::greater_than;
+        ++pos;
+    }
+    if (!are_digits(token, pos, 4))
+    {
+        return 0;
+    }
+    value = static_cast<uint16_t>(to_number(token, pos, 4));
+    return pos + 4 - start;
+}
+
+// [M]dd
+bool decode_temperature(util::string_view const& text, int8_t& result)
+{
+    auto negative = !text.empty() && text[0] == 'M';
+    auto digits = text.substr(negative ? 1 : 0);
+    if (digits.size() != 2 || !are_digits(digits, 0, 2))
+    {
+        return false;
+    }
+    auto value = static_cast<int8_t>(to_number(digits, 0, 2));
+    result = negative ? -value : value;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+uint32_t metar_group_candidates(util::string_view const& token)
+{
+    static const group_table table;
+    return token.empty() ? 0 : table[token[0]];
+}
+
+//-----------------------------------------------------------------------------
+
+bool decode_runway_visual_range_token(util::string_view const& token, runway_visual_range& result)
+{
+    uint8_t number = 0;
+    auto designator = runway_designator_type::none;
+    if (token.size() < 8 || token[0] != 'R')
+    {
+        return false;
+    }
+
+    auto pos = 1 + decode_runway(token, 1, number, designator);
+    if (pos == 1 || pos >= token.size() || token[pos] != '/')
+    {
+        return false;
+    }
+    ++pos;
+
+    uint16_t minimum = 0;
+    auto minimumModifier = visibility_modifier_type::none;
+    auto length = decode_rvr_value(token, pos, minimum, minimumModifier);
+    if (length == 0)
+    {
+        return false;
+    }
+    pos += length;
+
+    auto maximum = minimum;
+    auto maximumModifier = minimumModifier;
+    if (pos < token.size() && token[pos] == 'V')
+    {
+        length = decode_rvr_value(token, pos + 1, maximum, maximumModifier);
+        if (length == 0)
+        {
+            return false;
+        }
+        pos += 1 + length;
+    }
+
+    auto unit = distance_unit::metres;
+    if (token.substr(pos, 2) == "FT")
+    {
+        unit = distance_unit::feet;
+        pos += 2;
+    }
+
+    // Tendency, sometimes written after a slash
+    auto tendency = rvr_tendency::none;
+    if (pos < token.size() && token[pos] == '/')
+    {
+        ++pos;
+    }
+    if (pos + 1 == token.size())
+    {
+        switch (token[pos])
+        {
+        case 'U': tendency = rvr_tendency::upward; break;
+        case 'D': tendency = rvr_tendency::downward; break;
+        case 'N': tendency = rvr_tendency::no_change; break;
+        default:  return false;
+        }
+        ++pos;
+    }
+    if (pos != token.size())
+    {
+        return false;
+    }
+
+    result = runway_visual_range();
+    result.runway_number = number;
+    result.runway_designator = designator;
+    result.visibility_min = visibility(minimum, unit, minimumModifier);
+    result.visibility_max = visibility(maximum, unit, maximumModifier);
+    result.tendency = tendency;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+bool decode_minimum_visibility_token(util::string_view const& token, directional_visibility& result)
+{
+    if (token.size() < 5 || token.size() > 6 || !are_digits(token, 0, 4))
+    {
+        return false;
+    }
+
+    auto direction = token.substr(4);
+    for (size_t i = 0; i < sizeof(g_compassPoints) / sizeof(g_compassPoints[0]); ++i)
+    {
+        if (direction == g_compassPoints[i])
+        {
+            result.distance = visibility(to_number(token, 0, 4), distance_unit::metres);
+            result.direction = static_cast<compass_direction>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+
+bool decode_temperature_dewpoint_token(util::string_view const& token, temperature_dewpoint& result)
+{
+    auto slash = token.find('/');
+    if (slash == util::string_view::npos)
+    {
+        return false;
+    }
+
+    int8_t temperature = 0;
+    if (!decode_temperature(token.substr(0, slash), temperature))
+    {
+        return false;
+    }
+
+    util::optional<int8_t> dewpoint;
+    auto dewpointText = token.substr(slash + 1);
+    if (!dewpointText.empty())
+    {
+        int8_t value = 0;
+        if (!decode_temperature(dewpointText, value))
+        {
+            return false;
+        }
+        dewpoint = value;
+    }
+
+    result = temperature_dewpoint(util::optional<int8_t>(temperature), dewpoint);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+bool decode_altimeter_token(util::string_view const& token, altimeter& result)
+{
+    if (token.size() != 5 || (token[0] != 'A' && token[0] != 'Q') || !are_digits(token, 1, 4))
+    {
+        return false;
+    }
+
+    auto value = to_number(token, 1, 4);
+    result = token[0] == 'Q' ?
+        altimeter(value, pressure_unit::hPa) :
+        altimeter(value / 100.0, pressure_unit::inHg);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+bool decode_recent_weather_token(util::string_view const& token, weather& result)
+{
+    return token.size() > 2 && starts_with(token, "RE") && decode_weather_token(token.substr(2), result);
+}
+
+//-----------------------------------------------------------------------------
+
+bool decode_wind_shear_runway_token(util::string_view const& token, runway_wind_shear& result)
+{
+    size_t pos = starts_with(token, "RWY") ? 3 : (starts_with(token, "R") ? 1 : 0);
+    if (pos == 0)
+    {
+        return false;
+    }
+
+    uint8_t number = 0;
+    auto designator = runway_designator_type::none;
+    auto length = decode_runway(token, pos, number, designator);
+    if (length == 0 || pos + length != token.size())
+    {
+        return false;
+    }
+
+    result = runway_wind_shear();
+    result.runway_number = number;
+    result.runway_designator = designator;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+bool decode_trend_time_token(util::string_view const& token, time const& observationTime, metar_trend& result)
+{
+    if (token.size() != 6 || !are_digits(token, 2, 4))
+    {
+        return false;
+    }
+
+    time at(observationTime.day_of_month, static_cast<uint8_t>(to_number(token, 2, 2)), static_cast<uint8_t>(to_number(token, 4, 2)));
+    if (starts_with(token, "FM"))
+    {
+        result.from = at;
+    }
+    else if (starts_with(token, "TL"))
+    {
+        result.until = at;
+    }
+    else if (starts_with(token, "AT"))
+    {
+        result.at = at;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -0,0 +1,84 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include <AviationWeather/metar.h>
+#include <AviationWeather/optional.h>
+#include <AviationWeather/string_view.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+typedef std::pair<util::optional<int8_t>, util::optional<int8_t>> temperature_dewpoint;
+
+//-----------------------------------------------------------------------------
+
+// Groups that can follow the report header, as bits in the order they are
+// tried when a token could be more than one of them.
+enum metar_group : uint32_t
+{
+    metar_group_wind                   = 1u << 0,   // 24015G25KT, 05004MPS
+    metar_group_wind_variation         = 1u << 1,   // 200V250
+    metar_group_visibility             = 1u << 2,   // 10SM, 1 1/2SM, 6000, CAVOK
+    metar_group_minimum_visibility     = 1u << 3,   // 1500SW
+    metar_group_runway_visual_range    = 1u << 4,   // R24L/1200V1800FT, R09/0550N
+    metar_group_recent_weather         = 1u << 5,   // RETSRA
+    metar_group_weather                = 1u << 6,   // +TSRA
+    metar_group_sky_condition          = 1u << 7,   // BKN012CB, NSC, NCD
+    metar_group_temperature_dewpoint   = 1u << 8,   // M01/M03
+    metar_group_altimeter              = 1u << 9,   // A2992, Q1013
+    metar_group_wind_shear             = 1u << 10,  // WS R24, WS ALL RWY
+    metar_group_trend                  = 1u << 11,  // NOSIG, BECMG, TEMPO
+    metar_group_trend_time             = 1u << 12,  // FM1230, TL1330, AT1300
+    metar_group_no_significant_weather = 1u << 13,  // NSW
+    metar_group_remarks                = 1u << 14   // RMK
+};
+
+// The groups a token could be, looked up on its leading character so that
+// a token is only offered to the decoders that can accept it
+uint32_t metar_group_candidates(util::string_view const& token);
+
+//-----------------------------------------------------------------------------
+
+// R24L/1200V1800FT, R06/M0600, R09/P1500U. Values without FT are in metres.
+bool decode_runway_visual_range_token(util::string_view const& token, runway_visual_range& result);
+
+// dddd followed by a compass point, in metres
+bool decode_minimum_visibility_token(util::string_view const& token, directional_visibility& result);
+
+// [M]tt/[M]dd, where the dewpoint may be missing
+bool decode_temperature_dewpoint_token(util::string_view const& token, temperature_dewpoint& result);
+
+// Annnn (hundredths of inHg), Qnnnn (hPa)
+bool decode_altimeter_token(util::string_view const& token, altimeter& result);
+
+// RE followed by a weather group
+bool decode_recent_weather_token(util::string_view const& token, weather& result);
+
+// Rdd[LRC] or RWYdd[LRC], following WS
+bool decode_wind_shear_runway_token(util::string_view const& token, runway_wind_shear& result);
+
+// FMhhmm, TLhhmm or AThhmm, on the day of the observation
+bool decode_trend_time_token(util::string_view const& token, time const& observationTime, metar_trend& result);
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
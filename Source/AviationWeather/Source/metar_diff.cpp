@@ -0,0 +1,152 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/metar_diff.h>
+
+namespace aw
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+template <class T>
+void compare_element(T const& before, T const& after, metar_element_type element, metar_diff& result,
+    util::optional<value_change<T>>& change)
+{
+    if (!(before == after))
+    {
+        result.mask |= element_mask(element);
+        change = value_change<T>{ before, after };
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+metar_diff::metar_diff() :
+    mask(0)
+{}
+
+metar_diff::metar_diff(metar_diff && other) :
+    mask(0)
+{
+    *this = std::move(other);
+}
+
+metar_diff& metar_diff::operator=(metar_diff && rhs)
+{
+    if (this != &rhs)
+    {
+        mask = rhs.mask;
+        type = std::move(rhs.type);
+        identifier = std::move(rhs.identifier);
+        observation_time = std::move(rhs.observation_time);
+        modifier = std::move(rhs.modifier);
+        wind_group = std::move(rhs.wind_group);
+        visibility_group = std::move(rhs.visibility_group);
+        minimum_visibility_group = std::move(rhs.minimum_visibility_group);
+        runway_visual_range_group = std::move(rhs.runway_visual_range_group);
+        weather_group = std::move(rhs.weather_group);
+        sky_condition_group = std::move(rhs.sky_condition_group);
+        temperature = std::move(rhs.temperature);
+        dewpoint = std::move(rhs.dewpoint);
+        altimeter_group = std::move(rhs.altimeter_group);
+        recent_weather_group = std::move(rhs.recent_weather_group);
+        wind_shear_group = std::move(rhs.wind_shear_group);
+        trend_group = std::move(rhs.trend_group);
+        remarks = std::move(rhs.remarks);
+
+        rhs.mask = 0;
+        rhs.type = util::nullopt;
+        rhs.identifier = util::nullopt;
+        rhs.observation_time = util::nullopt;
+        rhs.modifier = util::nullopt;
+        rhs.wind_group = util::nullopt;
+        rhs.visibility_group = util::nullopt;
+        rhs.minimum_visibility_group = util::nullopt;
+        rhs.runway_visual_range_group = util::nullopt;
+        rhs.weather_group = util::nullopt;
+        rhs.sky_condition_group = util::nullopt;
+        rhs.temperature = util::nullopt;
+        rhs.dewpoint = util::nullopt;
+        rhs.altimeter_group = util::nullopt;
+        rhs.recent_weather_group = util::nullopt;
+        rhs.wind_shear_group = util::nullopt;
+        rhs.trend_group = util::nullopt;
+        rhs.remarks = util::nullopt;
+    }
+    return *this;
+}
+
+bool metar_diff::empty() const
+{
+    return mask == 0;
+}
+
+bool metar_diff::changed(metar_element_type element) const
+{
+    return (mask & element_mask(element)) != 0;
+}
+
+//-----------------------------------------------------------------------------
+
+metar_diff diff(metar const& before, metar const& after)
+{
+    metar_diff result;
+
+    // Most reports in a feed are unchanged, and equal reports have equal
+    // fingerprints, so those skip the element comparisons
+    if (before.content_hash() == after.content_hash())
+    {
+        return result;
+    }
+
+    compare_element(before.type, after.type, metar_element_type::report_type, result, result.type);
+    compare_element(before.identifier, after.identifier, metar_element_type::station_identifier, result, result.identifier);
+    compare_element(before.observation_time, after.observation_time, metar_element_type::observation_time, result, result.observation_time);
+    compare_element(before.modifier, after.modifier, metar_element_type::report_modifier, result, result.modifier);
+    compare_element(before.wind_group, after.wind_group, metar_element_type::wind, result, result.wind_group);
+    compare_element(before.visibility_group, after.visibility_group, metar_element_type::visibility, result, result.visibility_group);
+    compare_element(before.minimum_visibility_group, after.minimum_visibility_group, metar_element_type::visibility, result, result.minimum_visibility_group);
+    compare_element(before.runway_visual_range_group, after.runway_visual_range_group, metar_element_type::runway_visual_range, result, result.runway_visual_range_group);
+    compare_element(before.weather_group, after.weather_group, metar_element_type::weather, result, result.weather_group);
+    compare_element(before.sky_condition_group, after.sky_condition_group, metar_element_type::sky_condition, result, result.sky_condition_group);
+    compare_element(before.altimeter_group, after.altimeter_group, metar_element_type::altimeter, result, result.altimeter_group);
+    compare_element(before.recent_weather_group, after.recent_weather_group, metar_element_type::recent_weather, result, result.recent_weather_group);
+    compare_element(before.wind_shear_group, after.wind_shear_group, metar_element_type::wind_shear, result, result.wind_shear_group);
+    compare_element(before.trend_group, after.trend_group, metar_element_type::trend, result, result.trend_group);
+    compare_element(before.remarks, after.remarks, metar_element_type::remarks, result, result.remarks);
+
+    // Temperature and dewpoint share an element, so both are reported when
+    // either changes.
+    if (before.temperature != after.temperature || before.dewpoint != after.dewpoint)
+    {
+        result.mask |= element_mask(metar_element_type::temperature_dewpoint);
+        result.temperature = value_change<util::optional<int8_t>>{ before.temperature, after.temperature };
+        result.dewpoint = value_change<util::optional<int8_t>>{ before.dewpoint, after.dewpoint };
+    }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
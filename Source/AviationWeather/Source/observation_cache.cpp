@@ -0,0 +1,395 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/observation_cache.h>
+
+#include "hash.h"
+#include "time_utility.h"
+
+namespace aw
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+// Readers are spread over this many counters so that a burst of lookups from
+// many threads does not bounce a single cache line between cores
+const size_t reader_slot_count = 64;
+
+std::atomic<size_t> g_nextReader(0);
+
+size_t reader_index()
+{
+    thread_local size_t index = g_nextReader.fetch_add(1, std::memory_order_relaxed) % reader_slot_count;
+    return index;
+}
+
+uint64_t hash_identifier(util::string_view identifier)
+{
+    return hash_finalize(hash_bytes(identifier.data(), identifier.size()));
+}
+
+size_t round_up_to_power_of_two(size_t value)
+{
+    size_t result = 16;
+    while (result < value)
+    {
+        result *= 2;
+    }
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+bool supersedes(metar const& report, metar const& current)
+{
+    auto minutes = minutes_between(current.observation_time, report.observation_time);
+    if (minutes != 0)
+    {
+        return minutes > 0;
+    }
+    return report.modifier == metar_modifier_type::corrected && report.raw_data != current.raw_data;
+}
+
+//-----------------------------------------------------------------------------
+
+// Immutable once published; replaced as a whole when a newer report arrives
+struct observation_cache::entry
+{
+    uint64_t             hash;
+    metar::const_pointer report;
+};
+
+// Open-addressed index of entries. Stations are never removed individually,
+// so probing stops at the first empty slot. The table is replaced by a larger
+// copy before it becomes half full.
+struct observation_cache::table
+{
+    explicit table(size_t capacity) :
+        mask(capacity - 1),
+        count(0),
+        slots(new std::atomic<entry const*>[capacity])
+    {
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            slots[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    size_t capacity() const
+    {
+        return mask + 1;
+    }
+
+    // The slot holding the station, or the empty slot where it belongs
+    size_t find_slot(util::string_view identifier, uint64_t hash) const
+    {
+        auto slot = static_cast<size_t>(hash) & mask;
+        for (;;)
+        {
+            auto e = slots[slot].load(std::memory_order_acquire);
+            if (e == nullptr || (e->hash == hash && util::string_view(e->report->identifier) == identifier))
+            {
+                return slot;
+            }
+            slot = (slot + 1) & mask;
+        }
+    }
+
+    size_t                                      mask;
+    size_t                                      count;  // Only used by writers
+    std::unique_ptr<std::atomic<entry const*>[]> slots;
+};
+
+// Counts the readers active in each of the two most recent epochs
+struct observation_cache::reader_slot
+{
+    reader_slot()
+    {
+        readers[0].store(0, std::memory_order_relaxed);
+        readers[1].store(0, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint32_t> readers[2];
+    char                  padding[64 - 2 * sizeof(std::atomic<uint32_t>)];
+};
+
+// Entries and tables unlinked during one epoch
+struct observation_cache::retired_list
+{
+    std::vector<entry const*> entries;
+    std::vector<table*>       tables;
+
+    void release()
+    {
+        for (auto e : entries)
+        {
+            delete e;
+        }
+        for (auto t : tables)
+        {
+            delete t;
+        }
+        entries.clear();
+        tables.clear();
+    }
+};
+
+//-----------------------------------------------------------------------------
+
+// Registers the calling thread as a reader for the current epoch. Anything a
+// writer unlinks stays allocated until the readers of the epoch in which it
+// was unlinked, and of the epoch before, have all left.
+class observation_cache::read_guard
+{
+public:
+    explicit read_guard(observation_cache const& cache) :
+        m_slot(cache.m_readers[reader_index()])
+    {
+        for (;;)
+        {
+            auto epoch = cache.m_epoch.load();
+            m_parity = static_cast<size_t>(epoch & 1);
+            m_slot.readers[m_parity].fetch_add(1);
+
+            // The writer may have moved on before the reader was counted
+            if (cache.m_epoch.load() == epoch)
+            {
+                break;
+            }
+            m_slot.readers[m_parity].fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    ~read_guard()
+    {
+        m_slot.readers[m_parity].fetch_sub(1, std::memory_order_release);
+    }
+
+    read_guard(read_guard const&) = delete;
+    read_guard& operator= (read_guard const&) = delete;
+
+private:
+    reader_slot& m_slot;
+    size_t       m_parity;
+};
+
+//-----------------------------------------------------------------------------
+
+observation_cache::observation_cache(size_t capacity) :
+    m_table(nullptr),
+    m_epoch(0),
+    m_size(0),
+    m_readers(new reader_slot[reader_slot_count]),
+    m_initialCapacity(round_up_to_power_of_two(capacity * 2))
+{
+    m_retired[0].reset(new retired_list());
+    m_retired[1].reset(new retired_list());
+    m_table.store(new table(m_initialCapacity), std::memory_order_release);
+}
+
+observation_cache::~observation_cache()
+{
+    auto t = m_table.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < t->capacity(); ++i)
+    {
+        delete t->slots[i].load(std::memory_order_relaxed);
+    }
+    delete t;
+
+    m_retired[0]->release();
+    m_retired[1]->release();
+}
+
+bool observation_cache::update(metar::const_pointer const& report)
+{
+    if (!report)
+    {
+        throw aw_exception("A null report cannot be added to an observation cache");
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto updated = update_nolock(report);
+    reclaim_nolock();
+    return updated;
+}
+
+bool observation_cache::update(metar const& report)
+{
+    return update(std::make_shared<const metar>(report));
+}
+
+size_t observation_cache::update(std::vector<metar::const_pointer> const& reports)
+{
+    for (auto const& report : reports)
+    {
+        if (!report)
+        {
+            throw aw_exception("A null report cannot be added to an observation cache");
+        }
+    }
+
+    size_t updated = 0;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto const& report : reports)
+    {
+        if (update_nolock(report))
+        {
+            ++updated;
+        }
+    }
+    reclaim_nolock();
+    return updated;
+}
+
+metar::const_pointer observation_cache::find(util::string_view identifier) const
+{
+    auto hash = hash_identifier(identifier);
+
+    read_guard guard(*this);
+    auto t = m_table.load(std::memory_order_acquire);
+    auto e = t->slots[t->find_slot(identifier, hash)].load(std::memory_order_acquire);
+    return e ? e->report : nullptr;
+}
+
+std::vector<metar::const_pointer> observation_cache::snapshot() const
+{
+    std::vector<metar::const_pointer> reports;
+    reports.reserve(m_size.load(std::memory_order_relaxed));
+
+    read_guard guard(*this);
+    auto t = m_table.load(std::memory_order_acquire);
+    for (size_t i = 0; i < t->capacity(); ++i)
+    {
+        auto e = t->slots[i].load(std::memory_order_acquire);
+        if (e)
+        {
+            reports.push_back(e->report);
+        }
+    }
+    return reports;
+}
+
+void observation_cache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto old = m_table.exchange(new table(m_initialCapacity));
+    m_size.store(0, std::memory_order_relaxed);
+
+    auto& retired = *m_retired[m_epoch.load(std::memory_order_relaxed) & 1];
+    for (size_t i = 0; i < old->capacity(); ++i)
+    {
+        auto e = old->slots[i].load(std::memory_order_relaxed);
+        if (e)
+        {
+            retired.entries.push_back(e);
+        }
+    }
+    retired.tables.push_back(old);
+    reclaim_nolock();
+}
+
+size_t observation_cache::size() const
+{
+    return m_size.load(std::memory_order_relaxed);
+}
+
+// Must be called with the lock held
+bool observation_cache::update_nolock(metar::const_pointer const& report)
+{
+    auto& retired = *m_retired[m_epoch.load(std::memory_order_relaxed) & 1];
+    auto hash = hash_identifier(report->identifier);
+
+    auto t = m_table.load(std::memory_order_relaxed);
+    auto slot = t->find_slot(report->identifier, hash);
+    auto current = t->slots[slot].load(std::memory_order_relaxed);
+
+    if (current)
+    {
+        if (!supersedes(*report, *current->report))
+        {
+            return false;
+        }
+        t->slots[slot].store(new entry{ hash, report }, std::memory_order_release);
+        retired.entries.push_back(current);
+        return true;
+    }
+
+    // Grow before the table is half full, so probe sequences stay short.
+    // Entries are shared between the old and new tables; only the old slot
+    // array is retired.
+    if ((t->count + 1) * 2 > t->capacity())
+    {
+        auto grown = new table(t->capacity() * 2);
+        for (size_t i = 0; i < t->capacity(); ++i)
+        {
+            auto e = t->slots[i].load(std::memory_order_relaxed);
+            if (e)
+            {
+                auto target = static_cast<size_t>(e->hash) & grown->mask;
+                while (grown->slots[target].load(std::memory_order_relaxed) != nullptr)
+                {
+                    target = (target + 1) & grown->mask;
+                }
+                grown->slots[target].store(e, std::memory_order_relaxed);
+            }
+        }
+        grown->count = t->count;
+
+        m_table.store(grown, std::memory_order_release);
+        retired.tables.push_back(t);
+
+        t = grown;
+        slot = t->find_slot(report->identifier, hash);
+    }
+
+    t->slots[slot].store(new entry{ hash, report }, std::memory_order_release);
+    ++t->count;
+    m_size.store(t->count, std::memory_order_relaxed);
+    return true;
+}
+
+// Must be called with the lock held. Advances the epoch once no reader is
+// left in the previous one, freeing what was unlinked during it. Never waits;
+// if readers are still active the garbage is freed by a later update.
+void observation_cache::reclaim_nolock()
+{
+    auto epoch = m_epoch.load();
+    auto previous = static_cast<size_t>((epoch + 1) & 1);
+
+    for (size_t i = 0; i < reader_slot_count; ++i)
+    {
+        if (m_readers[i].readers[previous].load() != 0)
+        {
+            return;
+        }
+    }
+
+    m_retired[previous]->release();
+    m_epoch.store(epoch + 1);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
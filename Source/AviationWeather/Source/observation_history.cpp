@@ -0,0 +1,468 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/observation_history.h>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+
+#include <AviationWeather/converters.h>
+
+#include "flight_rules.h"
+#include "hash.h"
+#include "observation_records.h"
+
+namespace aw
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+template <class TValue>
+TValue clamp_to(double value, TValue lower, TValue upper)
+{
+    return value <= lower ? lower : value >= upper ? upper : static_cast<TValue>(std::lround(value));
+}
+
+template <class TReport>
+observation_record make_record(TReport const& report)
+{
+    observation_record record;
+    record.epoch_minute = 0;
+    record.altimeter_tenths = INT16_MIN;
+    record.temperature = report.temperature ? *report.temperature : static_cast<int8_t>(INT8_MIN);
+    record.dewpoint = report.dewpoint ? *report.dewpoint : static_cast<int8_t>(INT8_MIN);
+    record.wind_speed = 0;
+    record.gust_speed = 0;
+    record.wind_direction = UINT16_MAX;
+    record.visibility = UINT16_MAX;
+    record.ceiling = UINT16_MAX;
+    record.category = static_cast<uint8_t>(find_flight_category(report.visibility_group, report.sky_condition_group));
+    record.flags = 0;
+    record.reserved = 0;
+
+    if (report.type == metar_report_type::special)
+    {
+        record.flags |= observation_record::special_flag;
+    }
+    if (report.modifier == metar_modifier_type::corrected)
+    {
+        record.flags |= observation_record::corrected_flag;
+    }
+
+    if (report.altimeter_group)
+    {
+        auto hPa = convert(report.altimeter_group->pressure, report.altimeter_group->unit, pressure_unit::hPa);
+        record.altimeter_tenths = clamp_to<int16_t>(hPa * 10.0, INT16_MIN + 1, INT16_MAX);
+    }
+
+    if (report.wind_group)
+    {
+        auto const& w = *report.wind_group;
+        record.flags |= observation_record::wind_flag;
+        record.wind_direction = w.direction;
+        record.wind_speed = clamp_to<uint8_t>(convert(static_cast<double>(w.wind_speed), w.unit, speed_unit::kt), 0, UINT8_MAX);
+        record.gust_speed = clamp_to<uint8_t>(convert(static_cast<double>(w.gust_speed), w.unit, speed_unit::kt), 0, UINT8_MAX);
+    }
+
+    if (report.visibility_group)
+    {
+        auto metres = convert(report.visibility_group->distance, report.visibility_group->unit, distance_unit::metres);
+        record.visibility = clamp_to<uint16_t>(metres, 0, UINT16_MAX - 1);
+    }
+
+    if (!report.sky_condition_group.empty())
+    {
+        auto ceiling = find_ceiling(report.sky_condition_group);
+        if (!ceiling.is_unlimited())
+        {
+            auto feet = convert(static_cast<double>(ceiling.layer_height), ceiling.unit, distance_unit::feet);
+            record.ceiling = clamp_to<uint16_t>(feet / 100.0, 0, UINT16_MAX - 1);
+        }
+    }
+
+    return record;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+time observation_record::observation_time() const
+{
+    int32_t year;
+    uint32_t month;
+    uint32_t day;
+    civil_from_days(static_cast<int32_t>(epoch_minute / minutes_per_day), year, month, day);
+
+    return time(
+        static_cast<uint8_t>(day),
+        static_cast<uint8_t>(epoch_minute % minutes_per_day / 60),
+        static_cast<uint8_t>(epoch_minute % 60));
+}
+
+flight_category observation_record::flight_category() const
+{
+    return static_cast<aw::flight_category>(category);
+}
+
+util::optional<double> observation_record::altimeter() const
+{
+    if (altimeter_tenths == INT16_MIN)
+    {
+        return util::nullopt;
+    }
+    return altimeter_tenths / 10.0;
+}
+
+util::optional<int8_t> observation_record::temperature_celsius() const
+{
+    if (temperature == INT8_MIN)
+    {
+        return util::nullopt;
+    }
+    return temperature;
+}
+
+util::optional<int8_t> observation_record::dewpoint_celsius() const
+{
+    if (dewpoint == INT8_MIN)
+    {
+        return util::nullopt;
+    }
+    return dewpoint;
+}
+
+util::optional<uint8_t> observation_record::wind_speed_knots() const
+{
+    if ((flags & wind_flag) == 0)
+    {
+        return util::nullopt;
+    }
+    return wind_speed;
+}
+
+util::optional<double> observation_record::visibility_metres() const
+{
+    if (visibility == UINT16_MAX)
+    {
+        return util::nullopt;
+    }
+    return static_cast<double>(visibility);
+}
+
+//-----------------------------------------------------------------------------
+
+// One station's ring, indexed from the oldest record
+class observation_history::ring_view
+{
+public:
+    ring_view(observation_record const* records, uint32_t head, uint32_t count, uint32_t capacity) :
+        m_records(records),
+        m_start(head + capacity - count),
+        m_count(count),
+        m_capacity(capacity)
+    {}
+
+    uint32_t size() const
+    {
+        return m_count;
+    }
+
+    observation_record const& operator[] (uint32_t index) const
+    {
+        auto position = m_start + index;
+        return m_records[position >= m_capacity ? position - m_capacity : position];
+    }
+
+private:
+    observation_record const* m_records;
+    uint32_t                  m_start;
+    uint32_t                  m_count;
+    uint32_t                  m_capacity;
+};
+
+//-----------------------------------------------------------------------------
+
+observation_history::observation_history(uint32_t hours, uint32_t capacity) :
+    m_hours(hours),
+    m_capacity(capacity)
+{
+    if (capacity == 0)
+    {
+        throw aw_exception("An observation history requires room for at least one record per station");
+    }
+}
+
+observation_history::observation_history(observation_history && other) :
+    m_hours(default_hours),
+    m_capacity(default_capacity)
+{
+    *this = std::move(other);
+}
+
+observation_history& observation_history::operator=(observation_history && rhs)
+{
+    if (this != &rhs)
+    {
+        m_hours = rhs.m_hours;
+        m_capacity = rhs.m_capacity;
+        m_records = std::move(rhs.m_records);
+        m_rings = std::move(rhs.m_rings);
+        m_identifiers = std::move(rhs.m_identifiers);
+        m_slots = std::move(rhs.m_slots);
+
+        rhs.m_records.clear();
+        rhs.m_rings.clear();
+        rhs.m_identifiers.clear();
+        rhs.m_slots.clear();
+    }
+    return *this;
+}
+
+bool observation_history::append(metar const& report)
+{
+    return append(report, std::time(nullptr));
+}
+
+bool observation_history::append(metar_view const& report)
+{
+    return append(report, std::time(nullptr));
+}
+
+bool observation_history::append(metar const& report, std::time_t received)
+{
+    return append(report.identifier, report.observation_time, received, make_record(report));
+}
+
+bool observation_history::append(metar_view const& report, std::time_t received)
+{
+    return append(report.identifier.to_string(), report.observation_time, received, make_record(report));
+}
+
+uint32_t observation_history::hours() const
+{
+    return m_hours;
+}
+
+uint32_t observation_history::capacity() const
+{
+    return m_capacity;
+}
+
+size_t observation_history::station_count() const
+{
+    return m_rings.size();
+}
+
+size_t observation_history::size(util::string_view identifier) const
+{
+    auto station = find(identifier);
+    return station == npos ? 0 : m_rings[station].count;
+}
+
+observation_record const* observation_history::latest(util::string_view identifier) const
+{
+    auto station = find(identifier);
+    return station == npos ? nullptr : &at(station, m_rings[station].count - 1);
+}
+
+observation_record const* observation_history::previous(util::string_view identifier) const
+{
+    auto station = find(identifier);
+    return station == npos || m_rings[station].count < 2 ? nullptr : &at(station, m_rings[station].count - 2);
+}
+
+void observation_history::last_hours(util::string_view identifier, uint32_t hours, std::vector<observation_record>& results) const
+{
+    results.clear();
+
+    auto station = find(identifier);
+    if (station != npos)
+    {
+        collect(station, 0, static_cast<int32_t>(hours) * 60, results);
+    }
+}
+
+void observation_history::range(util::string_view identifier, time const& from, time const& to, std::vector<observation_record>& results) const
+{
+    results.clear();
+
+    auto station = find(identifier);
+    if (station != npos)
+    {
+        auto newest = at(station, m_rings[station].count - 1).epoch_minute;
+        collect(station, minutes_between(resolve_minute(to, newest), newest), minutes_between(resolve_minute(from, newest), newest), results);
+    }
+}
+
+util::optional<double> observation_history::pressure_tendency(util::string_view identifier, uint32_t hours) const
+{
+    auto station = find(identifier);
+    if (station == npos)
+    {
+        return util::nullopt;
+    }
+    return find_change(records(station), hours, [](observation_record const& r) { return r.altimeter(); });
+}
+
+util::optional<double> observation_history::temperature_change(util::string_view identifier, uint32_t hours) const
+{
+    auto station = find(identifier);
+    if (station == npos)
+    {
+        return util::nullopt;
+    }
+    return find_change(records(station), hours, [](observation_record const& r) { return r.temperature_celsius(); });
+}
+
+bool observation_history::append(std::string const& identifier, time const& observed, std::time_t received, observation_record record)
+{
+    auto station = find(identifier);
+    if (station == npos)
+    {
+        // Keep the index at most half full
+        if ((m_rings.size() + 1) * 2 > m_slots.size())
+        {
+            rehash(m_slots.empty() ? 64 : m_slots.size() * 2);
+        }
+
+        station = m_rings.size();
+        m_slots[find_slot(identifier)] = static_cast<uint32_t>(station + 1);
+        m_identifiers.push_back(identifier);
+        m_rings.push_back(ring{ 0, 0 });
+        m_records.resize(m_records.size() + m_capacity);
+    }
+
+    auto& r = m_rings[station];
+    auto base = static_cast<size_t>(station) * m_capacity;
+
+    if (r.count == 0)
+    {
+        record.epoch_minute = resolve_minute(observed, static_cast<uint32_t>(received / 60));
+    }
+    else
+    {
+        auto const& newest = at(station, r.count - 1);
+        record.epoch_minute = resolve_minute(observed, newest.epoch_minute);
+
+        auto minutes = minutes_between(newest.epoch_minute, record.epoch_minute);
+        if (minutes < 0)
+        {
+            return false;
+        }
+        if (minutes == 0)
+        {
+            if ((record.flags & observation_record::corrected_flag) == 0)
+            {
+                return false;
+            }
+            m_records[base + (r.head + m_capacity - 1) % m_capacity] = record;
+            return true;
+        }
+    }
+
+    m_records[base + r.head] = record;
+    r.head = (r.head + 1) % m_capacity;
+    if (r.count < m_capacity)
+    {
+        ++r.count;
+    }
+
+    // Drop records that have aged out of the retention period
+    auto limit = static_cast<int32_t>(m_hours) * 60;
+    while (r.count > 1 && minutes_between(at(station, 0).epoch_minute, record.epoch_minute) > limit)
+    {
+        --r.count;
+    }
+    return true;
+}
+
+size_t observation_history::find(util::string_view identifier) const
+{
+    if (m_slots.empty())
+    {
+        return npos;
+    }
+
+    auto slot = m_slots[find_slot(identifier)];
+    return slot == 0 ? npos : slot - 1;
+}
+
+// The slot holding the station, or the empty slot where it belongs
+size_t observation_history::find_slot(util::string_view identifier) const
+{
+    auto mask = m_slots.size() - 1;
+    auto slot = static_cast<size_t>(hash_finalize(hash_bytes(identifier.data(), identifier.size()))) & mask;
+    while (m_slots[slot] != 0 && util::string_view(m_identifiers[m_slots[slot] - 1]) != identifier)
+    {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void observation_history::rehash(size_t slotCount)
+{
+    m_slots.assign(slotCount, 0);
+    for (size_t station = 0; station < m_identifiers.size(); ++station)
+    {
+        m_slots[find_slot(m_identifiers[station])] = static_cast<uint32_t>(station + 1);
+    }
+}
+
+observation_history::ring_view observation_history::records(size_t station) const
+{
+    auto const& r = m_rings[station];
+    return ring_view(m_records.data() + station * m_capacity, r.head, r.count, m_capacity);
+}
+
+observation_record const& observation_history::at(size_t station, uint32_t index) const
+{
+    return records(station)[index];
+}
+
+// Records are in time order, so the matching records are a contiguous run of
+// the ring, copied in at most two blocks
+void observation_history::collect(size_t station, int32_t minimumAge, int32_t maximumAge, std::vector<observation_record>& results) const
+{
+    auto const& r = m_rings[station];
+    auto view = records(station);
+    auto begin = first_younger_than(view, maximumAge + 1);
+    auto end = first_younger_than(view, minimumAge);
+    if (begin >= end)
+    {
+        return;
+    }
+
+    auto block = m_records.data() + station * m_capacity;
+    auto start = (r.head + m_capacity - r.count + begin) % m_capacity;
+    auto count = end - begin;
+    auto first = std::min(count, m_capacity - start);
+
+    results.insert(results.end(), block + start, block + start + first);
+    results.insert(results.end(), block, block + (count - first));
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
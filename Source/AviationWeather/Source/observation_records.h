@@ -0,0 +1,203 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+#include <AviationWeather/components.h>
+#include <AviationWeather/observation_history.h>
+#include <AviationWeather/optional.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// Queries over one station's records, oldest first, shared by the rings of
+// observation_history and the blocks of observation_snapshot. TRecords has
+// size() and operator[] with index 0 the oldest record.
+
+const int32_t minutes_per_day = 24 * 60;
+
+// Signed minutes between two record times
+inline int32_t minutes_between(uint32_t from, uint32_t to)
+{
+    return static_cast<int32_t>(to - from);
+}
+
+// Days since 1970-01-01 of a date in the Gregorian calendar, and the reverse
+inline int32_t days_from_civil(int32_t year, uint32_t month, uint32_t day)
+{
+    year -= month <= 2 ? 1 : 0;
+    auto era = (year >= 0 ? year : year - 399) / 400;
+    auto yearOfEra = static_cast<uint32_t>(year - era * 400);
+    auto dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    auto dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<int32_t>(dayOfEra) - 719468;
+}
+
+inline void civil_from_days(int32_t days, int32_t& year, uint32_t& month, uint32_t& day)
+{
+    days += 719468;
+    auto era = (days >= 0 ? days : days - 146096) / 146097;
+    auto dayOfEra = static_cast<uint32_t>(days - era * 146097);
+    auto yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    auto dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    auto shiftedMonth = (5 * dayOfYear + 2) / 153;
+
+    day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+    month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+    year = static_cast<int32_t>(yearOfEra) + era * 400 + (month <= 2 ? 1 : 0);
+}
+
+inline uint32_t days_in_month(int32_t year, uint32_t month)
+{
+    static const uint8_t lengths[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    auto leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == 2 && leap ? 29 : lengths[month - 1];
+}
+
+// Minutes since 1970-01-01 00:00 UTC of a report time. Reports carry the day
+// of the month but not the month, so the time is placed in the month before,
+// the month of or the month after the reference minute, whichever puts it
+// closest, using the real length of each month.
+inline uint32_t resolve_minute(time const& t, uint32_t reference)
+{
+    int32_t year;
+    uint32_t month;
+    uint32_t day;
+    civil_from_days(static_cast<int32_t>(reference / minutes_per_day), year, month, day);
+
+    uint32_t dayOfMonth = t.day_of_month > 0 ? t.day_of_month : 1;
+    int64_t minuteOfDay = t.hour_of_day * 60 + t.minute_of_hour;
+
+    auto best = static_cast<int64_t>(reference);
+    auto bestDistance = INT64_MAX;
+    for (int32_t offset = -1; offset <= 1; ++offset)
+    {
+        auto candidateYear = year;
+        auto candidateMonth = static_cast<int32_t>(month) + offset;
+        if (candidateMonth < 1)
+        {
+            candidateMonth += 12;
+            --candidateYear;
+        }
+        else if (candidateMonth > 12)
+        {
+            candidateMonth -= 12;
+            ++candidateYear;
+        }
+
+        if (dayOfMonth > days_in_month(candidateYear, static_cast<uint32_t>(candidateMonth)))
+        {
+            continue;
+        }
+
+        auto minute = static_cast<int64_t>(days_from_civil(candidateYear, static_cast<uint32_t>(candidateMonth), dayOfMonth)) * minutes_per_day + minuteOfDay;
+        auto distance = std::abs(minute - static_cast<int64_t>(reference));
+        if (distance < bestDistance)
+        {
+            best = minute;
+            bestDistance = distance;
+        }
+    }
+    return static_cast<uint32_t>(best);
+}
+
+//-----------------------------------------------------------------------------
+
+// Index of the first record less than the given number of minutes older than
+// the latest. Ages decrease with the index, so this is a binary search.
+template <class TRecords>
+uint32_t first_younger_than(TRecords const& records, int32_t age)
+{
+    auto newest = records[records.size() - 1].epoch_minute;
+
+    uint32_t lower = 0;
+    uint32_t upper = records.size();
+    while (lower < upper)
+    {
+        auto middle = lower + (upper - lower) / 2;
+        if (minutes_between(records[middle].epoch_minute, newest) < age)
+        {
+            upper = middle;
+        }
+        else
+        {
+            lower = middle + 1;
+        }
+    }
+    return lower;
+}
+
+// The record closest to the given number of hours before the latest, within
+// half an hour, or nullptr. Scans back from the latest report, stopping once
+// past the target.
+template <class TRecords>
+observation_record const* find_closest(TRecords const& records, uint32_t hours)
+{
+    const int32_t tolerance = 30;
+
+    auto count = records.size();
+    auto newest = records[count - 1].epoch_minute;
+    auto target = static_cast<int32_t>(hours) * 60;
+
+    observation_record const* best = nullptr;
+    auto bestDistance = tolerance + 1;
+    for (auto i = count - 1; i-- > 0;)
+    {
+        auto const& record = records[i];
+        auto age = minutes_between(record.epoch_minute, newest);
+        if (age > target + tolerance)
+        {
+            break;
+        }
+
+        auto distance = std::abs(age - target);
+        if (distance < bestDistance)
+        {
+            best = &record;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+// Change in a value from the record closest to the given number of hours
+// before the latest to the latest. Empty if either lacks the value.
+template <class TRecords, class TValue>
+util::optional<double> find_change(TRecords const& records, uint32_t hours, TValue value)
+{
+    auto earlier = find_closest(records, hours);
+    if (earlier == nullptr)
+    {
+        return util::nullopt;
+    }
+
+    auto now = value(records[records.size() - 1]);
+    auto then = value(*earlier);
+    if (!now || !then)
+    {
+        return util::nullopt;
+    }
+    return static_cast<double>(*now - *then);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -0,0 +1,459 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/observation_snapshot.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+#include "hash.h"
+#include "mapped_file.h"
+#include "observation_records.h"
+
+namespace aw
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const char snapshot_magic[] = { 'A', 'W', 'S', 'N' };
+
+// Written in the machine's byte order, so a reader with the other order sees
+// a different value
+const uint32_t byte_order_mark = 0x01020304;
+
+const size_t identifier_length = 8;
+const size_t section_alignment = 8;
+
+size_t align_section(size_t offset)
+{
+    return (offset + section_alignment - 1) & ~(section_alignment - 1);
+}
+
+// The station index is an open-addressed table of station number + 1, or 0
+// for an empty slot, kept at most half full. Readers hash identifiers the same
+// way, so the hash is part of the format.
+size_t first_slot(util::string_view identifier, size_t slotCount)
+{
+    return static_cast<size_t>(hash_finalize(hash_bytes(identifier.data(), identifier.size()))) & (slotCount - 1);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+// Start of the image. Every field is naturally aligned, so the layout is the
+// same for every compiler.
+struct observation_snapshot::header
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t record_size;
+    uint32_t hours;
+    uint32_t station_count;
+    uint32_t slot_count;
+    uint32_t reserved;
+    uint64_t record_count;
+    uint64_t stations_offset;
+    uint64_t slots_offset;
+    uint64_t records_offset;
+};
+
+struct observation_snapshot::station_entry
+{
+    char     identifier[identifier_length];  // Padded with zeros
+    uint32_t first;                          // Index of the oldest record
+    uint32_t count;
+};
+
+// One station's records, oldest first
+class observation_snapshot::block_view
+{
+public:
+    block_view() :
+        m_records(nullptr),
+        m_count(0)
+    {}
+
+    block_view(observation_record const* records, uint32_t count) :
+        m_records(records),
+        m_count(count)
+    {}
+
+    uint32_t size() const
+    {
+        return m_count;
+    }
+
+    observation_record const* data() const
+    {
+        return m_records;
+    }
+
+    observation_record const& operator[] (uint32_t index) const
+    {
+        return m_records[index];
+    }
+
+private:
+    observation_record const* m_records;
+    uint32_t                  m_count;
+};
+
+//-----------------------------------------------------------------------------
+
+void observation_snapshot::write(observation_history const& history, std::vector<uint8_t>& buffer)
+{
+    auto const& identifiers = history.m_identifiers;
+
+    // The index is sorted so that readers can binary search it in place
+    std::vector<uint32_t> order(identifiers.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&identifiers](uint32_t a, uint32_t b)
+    {
+        return identifiers[a] < identifiers[b];
+    });
+
+    uint64_t recordCount = 0;
+    for (size_t station = 0; station < identifiers.size(); ++station)
+    {
+        if (identifiers[station].empty() || identifiers[station].size() > identifier_length)
+        {
+            throw aw_exception("Station identifiers in a snapshot are limited to eight characters");
+        }
+        recordCount += history.m_rings[station].count;
+    }
+    if (recordCount > UINT32_MAX)
+    {
+        throw aw_exception("Too many records for a snapshot");
+    }
+
+    header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, snapshot_magic, sizeof(h.magic));
+    h.version = format_version;
+    h.byte_order = byte_order_mark;
+    h.record_size = sizeof(observation_record);
+    h.hours = history.m_hours;
+    h.station_count = static_cast<uint32_t>(identifiers.size());
+    h.record_count = recordCount;
+
+    h.slot_count = 16;
+    while (h.slot_count < identifiers.size() * 2)
+    {
+        h.slot_count *= 2;
+    }
+
+    h.stations_offset = align_section(sizeof(header));
+    h.slots_offset = align_section(static_cast<size_t>(h.stations_offset) + identifiers.size() * sizeof(station_entry));
+    h.records_offset = align_section(static_cast<size_t>(h.slots_offset) + h.slot_count * sizeof(uint32_t));
+
+    buffer.assign(static_cast<size_t>(h.records_offset + recordCount * sizeof(observation_record)), 0);
+    memcpy(buffer.data(), &h, sizeof(h));
+
+    auto entries = reinterpret_cast<station_entry*>(buffer.data() + h.stations_offset);
+    auto slots = reinterpret_cast<uint32_t*>(buffer.data() + h.slots_offset);
+    auto records = reinterpret_cast<observation_record*>(buffer.data() + h.records_offset);
+
+    uint32_t first = 0;
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        auto station = order[i];
+        auto count = history.m_rings[station].count;
+
+        auto& entry = entries[i];
+
+        memcpy(entry.identifier, identifiers[station].data(), identifiers[station].size());
+        entry.first = first;
+        entry.count = count;
+
+        auto slot = first_slot(identifiers[station], h.slot_count);
+        while (slots[slot] != 0)
+        {
+            slot = (slot + 1) & (h.slot_count - 1);
+        }
+        slots[slot] = static_cast<uint32_t>(i + 1);
+
+        for (uint32_t index = 0; index < count; ++index)
+        {
+            records[first + index] = history.at(station, index);
+        }
+        first += count;
+    }
+}
+
+void observation_snapshot::write(observation_history const& history, std::string const& path)
+{
+    std::vector<uint8_t> buffer;
+    write(history, buffer);
+
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    stream.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    if (!stream)
+    {
+        throw aw_exception("Unable to write the snapshot file");
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+observation_snapshot::observation_snapshot(uint8_t const* data, size_t size) :
+    m_header(nullptr),
+    m_stations(nullptr),
+    m_slots(nullptr),
+    m_records(nullptr)
+{
+    open(data, size);
+}
+
+observation_snapshot::observation_snapshot(std::string const& path) :
+    m_file(std::make_shared<detail::mapped_file>(path)),
+    m_header(nullptr),
+    m_stations(nullptr),
+    m_slots(nullptr),
+    m_records(nullptr)
+{
+    open(m_file->data(), m_file->size());
+}
+
+observation_snapshot::observation_snapshot(observation_snapshot && other) :
+    m_header(nullptr),
+    m_stations(nullptr),
+    m_slots(nullptr),
+    m_records(nullptr)
+{
+    *this = std::move(other);
+}
+
+observation_snapshot& observation_snapshot::operator=(observation_snapshot && rhs)
+{
+    if (this != &rhs)
+    {
+        m_file = std::move(rhs.m_file);
+        m_header = rhs.m_header;
+        m_stations = rhs.m_stations;
+        m_slots = rhs.m_slots;
+        m_records = rhs.m_records;
+
+        rhs.m_file.reset();
+        rhs.m_header = nullptr;
+        rhs.m_stations = nullptr;
+        rhs.m_slots = nullptr;
+        rhs.m_records = nullptr;
+    }
+    return *this;
+}
+
+uint32_t observation_snapshot::hours() const
+{
+    return m_header ? m_header->hours : 0;
+}
+
+size_t observation_snapshot::station_count() const
+{
+    return m_header ? m_header->station_count : 0;
+}
+
+size_t observation_snapshot::record_count() const
+{
+    return m_header ? static_cast<size_t>(m_header->record_count) : 0;
+}
+
+util::string_view observation_snapshot::identifier(size_t station) const
+{
+    if (station >= station_count())
+    {
+        throw aw_exception("Station index out of range");
+    }
+
+    auto const& entry = m_stations[station];
+    auto end = std::find(entry.identifier, entry.identifier + identifier_length, '\0');
+    return util::string_view(entry.identifier, static_cast<size_t>(end - entry.identifier));
+}
+
+observation_record const* observation_snapshot::records(util::string_view identifier, size_t& count) const
+{
+    auto block = find(identifier);
+    count = block.size();
+    return count > 0 ? block.data() : nullptr;
+}
+
+size_t observation_snapshot::size(util::string_view identifier) const
+{
+    return find(identifier).size();
+}
+
+observation_record const* observation_snapshot::latest(util::string_view identifier) const
+{
+    auto block = find(identifier);
+    return block.size() == 0 ? nullptr : &block[block.size() - 1];
+}
+
+observation_record const* observation_snapshot::previous(util::string_view identifier) const
+{
+    auto block = find(identifier);
+    return block.size() < 2 ? nullptr : &block[block.size() - 2];
+}
+
+void observation_snapshot::last_hours(util::string_view identifier, uint32_t hours, std::vector<observation_record>& results) const
+{
+    results.clear();
+
+    auto block = find(identifier);
+    if (block.size() > 0)
+    {
+        collect(block, 0, static_cast<int32_t>(hours) * 60, results);
+    }
+}
+
+void observation_snapshot::range(util::string_view identifier, time const& from, time const& to, std::vector<observation_record>& results) const
+{
+    results.clear();
+
+    auto block = find(identifier);
+    if (block.size() > 0)
+    {
+        auto newest = block[block.size() - 1].epoch_minute;
+        collect(block, minutes_between(resolve_minute(to, newest), newest), minutes_between(resolve_minute(from, newest), newest), results);
+    }
+}
+
+util::optional<double> observation_snapshot::pressure_tendency(util::string_view identifier, uint32_t hours) const
+{
+    auto block = find(identifier);
+    if (block.size() == 0)
+    {
+        return util::nullopt;
+    }
+    return find_change(block, hours, [](observation_record const& r) { return r.altimeter(); });
+}
+
+util::optional<double> observation_snapshot::temperature_change(util::string_view identifier, uint32_t hours) const
+{
+    auto block = find(identifier);
+    if (block.size() == 0)
+    {
+        return util::nullopt;
+    }
+    return find_change(block, hours, [](observation_record const& r) { return r.temperature_celsius(); });
+}
+
+// Only the header and the section bounds are checked, so opening takes the
+// same time for any size of image. Each station's bounds are checked when it
+// is looked up.
+void observation_snapshot::open(uint8_t const* data, size_t size)
+{
+    if (data == nullptr || size < sizeof(header) || reinterpret_cast<uintptr_t>(data) % section_alignment != 0)
+    {
+        throw aw_exception("Invalid snapshot");
+    }
+
+    auto h = reinterpret_cast<header const*>(data);
+    if (memcmp(h->magic, snapshot_magic, sizeof(h->magic)) != 0)
+    {
+        throw aw_exception("Not an observation snapshot");
+    }
+    if (h->byte_order != byte_order_mark)
+    {
+        throw aw_exception("Snapshot was written with a different byte order");
+    }
+    if (h->version != format_version || h->record_size != sizeof(observation_record))
+    {
+        throw aw_exception("Unsupported snapshot version");
+    }
+
+    // A power of two with at least one empty slot, so that probes end
+    if (h->slot_count == 0 || (h->slot_count & (h->slot_count - 1)) != 0 || h->slot_count <= h->station_count)
+    {
+        throw aw_exception("Invalid snapshot");
+    }
+
+    auto stationsEnd = h->stations_offset + static_cast<uint64_t>(h->station_count) * sizeof(station_entry);
+    auto slotsEnd = h->slots_offset + static_cast<uint64_t>(h->slot_count) * sizeof(uint32_t);
+    auto recordsEnd = h->records_offset + h->record_count * sizeof(observation_record);
+    if (h->stations_offset % section_alignment != 0 || h->slots_offset % section_alignment != 0 ||
+        h->records_offset % section_alignment != 0 || h->stations_offset < sizeof(header) ||
+        h->slots_offset < stationsEnd || h->records_offset < slotsEnd ||
+        h->record_count > UINT32_MAX || recordsEnd > size)
+    {
+        throw aw_exception("Truncated snapshot");
+    }
+
+    m_header = h;
+    m_stations = reinterpret_cast<station_entry const*>(data + h->stations_offset);
+    m_slots = reinterpret_cast<uint32_t const*>(data + h->slots_offset);
+    m_records = reinterpret_cast<observation_record const*>(data + h->records_offset);
+}
+
+observation_snapshot::block_view observation_snapshot::find(util::string_view identifier) const
+{
+    if (m_header == nullptr || identifier.empty() || identifier.size() > identifier_length)
+    {
+        return block_view();
+    }
+
+    char key[identifier_length] = {};
+    memcpy(key, identifier.data(), identifier.size());
+
+    auto mask = m_header->slot_count - 1;
+    station_entry const* entry = nullptr;
+    for (auto slot = first_slot(identifier, m_header->slot_count); m_slots[slot] != 0; slot = (slot + 1) & mask)
+    {
+        auto station = m_slots[slot] - 1;
+        if (station >= m_header->station_count)
+        {
+            throw aw_exception("Corrupt snapshot");
+        }
+        if (memcmp(m_stations[station].identifier, key, identifier_length) == 0)
+        {
+            entry = &m_stations[station];
+            break;
+        }
+    }
+    if (entry == nullptr)
+    {
+        return block_view();
+    }
+
+    if (static_cast<uint64_t>(entry->first) + entry->count > m_header->record_count)
+    {
+        throw aw_exception("Corrupt snapshot");
+    }
+    return block_view(m_records + entry->first, entry->count);
+}
+
+// Records are in time order, so the matching records are one contiguous run
+void observation_snapshot::collect(block_view const& block, int32_t minimumAge, int32_t maximumAge, std::vector<observation_record>& results) const
+{
+    auto begin = first_younger_than(block, maximumAge + 1);
+    auto end = first_younger_than(block, minimumAge);
+    if (begin < end)
+    {
+        results.insert(results.end(), block.data() + begin, block.data() + end);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
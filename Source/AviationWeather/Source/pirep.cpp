@@ -0,0 +1,798 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/pirep.h>
+
+#include "token_decoders.h"
+#include "tokens.h"
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const char* g_fieldCodes[] = { "OV", "TM", "FL", "TP", "SK", "WX", "TA", "WV", "TB", "IC", "RM" };
+
+// "/XX" followed by a space, a digit or the end of the report
+bool is_field_start(util::string_view const& text, size_t pos)
+{
+    if (text[pos] != '/' || pos + 3 > text.size())
+    {
+        return false;
+    }
+    if (pos + 3 < text.size() && !is_separator(text[pos + 3]) && !is_digit(text[pos + 3]))
+    {
+        return false;
+    }
+    for (auto code : g_fieldCodes)
+    {
+        if (text[pos + 1] == code[0] && text[pos + 2] == code[1])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t find_field_start(util::string_view const& text, size_t pos)
+{
+    for (; pos < text.size(); ++pos)
+    {
+        if (is_field_start(text, pos))
+        {
+            return pos;
+        }
+    }
+    return text.size();
+}
+
+util::string_view trim(util::string_view const& text)
+{
+    size_t begin = 0;
+    size_t end = text.size();
+    while (begin < end && is_separator(text[begin]))
+    {
+        ++begin;
+    }
+    while (end > begin && (is_separator(text[end - 1]) || text[end - 1] == '='))
+    {
+        --end;
+    }
+    return text.substr(begin, end - begin);
+}
+
+bool is_station_token(util::string_view const& token)
+{
+    if (token.size() < 3 || token.size() > 4)
+    {
+        return false;
+    }
+    for (auto c : token)
+    {
+        if (!is_digit(c) && (c < 'A' || c > 'Z'))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Calls l(part) for each part of the token separated by the delimiter
+template <class TLambda>
+void for_each_part(util::string_view const& token, char delimiter, TLambda && l)
+{
+    size_t start = 0;
+    for (size_t i = 0; i <= token.size(); ++i)
+    {
+        if (i == token.size() || token[i] == delimiter)
+        {
+            if (i > start)
+            {
+                l(token.substr(start, i - start));
+            }
+            start = i + 1;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+bool decode_turbulence_intensity(util::string_view const& symbol, turbulence_intensity& result)
+{
+    if (symbol == "NEG" || symbol == "SMTH" || symbol == "SMOOTH") { result = turbulence_intensity::none; }
+    else if (symbol == "LGT")   { result = turbulence_intensity::light; }
+    else if (symbol == "MOD")   { result = turbulence_intensity::moderate; }
+    else if (symbol == "SEV")   { result = turbulence_intensity::severe; }
+    else if (symbol == "EXTRM") { result = turbulence_intensity::extreme; }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+bool decode_icing_intensity(util::string_view const& symbol, icing_intensity& result)
+{
+    if (symbol == "NEG")                         { result = icing_intensity::none; }
+    else if (symbol == "TRACE" || symbol == "TR") { result = icing_intensity::trace; }
+    else if (symbol == "LGT")                    { result = icing_intensity::light; }
+    else if (symbol == "MOD")                    { result = icing_intensity::moderate; }
+    else if (symbol == "SEV")                    { result = icing_intensity::severe; }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+// LGT or a range such as LGT-MOD
+template <class TIntensity, class TDecoder>
+bool decode_intensity_range(util::string_view const& token, TDecoder && decoder, TIntensity& lower, TIntensity& upper)
+{
+    auto dash = token.find('-');
+    if (dash == util::string_view::npos)
+    {
+        if (!decoder(token, lower))
+        {
+            return false;
+        }
+        upper = lower;
+        return true;
+    }
+
+    TIntensity first, second;
+    if (!decoder(token.substr(0, dash), first) || !decoder(token.substr(dash + 1), second))
+    {
+        return false;
+    }
+    lower = first;
+    upper = second;
+    return true;
+}
+
+// Altitudes in hundreds of feet: BLO ddd, ABV ddd or ddd-ddd. Returns true if
+// the token was consumed; pending carries BLO or ABV over to the next token.
+bool decode_altitude_range(util::string_view const& token, char& pending, util::optional<uint32_t>& base, util::optional<uint32_t>& top)
+{
+    if (token == "BLO" || token == "ABV")
+    {
+        pending = token[0];
+        return true;
+    }
+    if (token.size() == 3 && are_digits(token, 0, 3))
+    {
+        auto altitude = static_cast<uint32_t>(to_number(token, 0, 3)) * 100;
+        if (pending == 'B')
+        {
+            top = altitude;
+        }
+        else if (pending == 'A')
+        {
+            base = altitude;
+        }
+        pending = 0;
+        return true;
+    }
+    if (token.size() == 7 && are_digits(token, 0, 3) && token[3] == '-' && are_digits(token, 4, 3))
+    {
+        base = static_cast<uint32_t>(to_number(token, 0, 3)) * 100;
+        top = static_cast<uint32_t>(to_number(token, 4, 3)) * 100;
+        return true;
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+
+void decode_sky_condition(util::string_view const& value, pirep_record& record)
+{
+    for_each_token(value, [&](util::string_view const& token)
+    {
+        for_each_part(token, '/', [&](util::string_view const& layer)
+        {
+            if (record.sky_condition_count == pirep_record::max_sky_layers)
+            {
+                return;
+            }
+
+            // BKN030-TOP050
+            auto base = layer;
+            auto top = UINT32_MAX;
+            auto dash = layer.find('-');
+            if (dash != util::string_view::npos)
+            {
+                auto topText = layer.substr(dash + 1);
+                if (starts_with(topText, "TOP") && topText.size() == 6 && are_digits(topText, 3, 3))
+                {
+                    top = static_cast<uint32_t>(to_number(topText, 3, 3)) * 100;
+                }
+                base = layer.substr(0, dash);
+            }
+
+            auto& result = record.sky_condition_group[record.sky_condition_count];
+            if (decode_sky_condition_token(base, result))
+            {
+                record.cloud_tops[record.sky_condition_count++] = top;
+            }
+        });
+    });
+}
+
+void decode_weather(util::string_view const& value, pirep_record& record, weather& scratch)
+{
+    for_each_token(value, [&](util::string_view const& token)
+    {
+        visibility flightVisibility;
+        if (starts_with(token, "FV") && decode_visibility_token(token.substr(2), flightVisibility))
+        {
+            record.flight_visibility = flightVisibility;
+            return;
+        }
+        if (record.weather_count == pirep_record::max_weather || !decode_weather_token(token, scratch))
+        {
+            return;
+        }
+
+        auto& result = record.weather_group[record.weather_count++];
+        result.intensity = scratch.intensity;
+        result.descriptor = scratch.descriptor;
+        result.phenomena_count = 0;
+        for (auto phenomenon : scratch.phenomena)
+        {
+            if (result.phenomena_count < compact_weather::max_phenomena)
+            {
+                result.phenomena[result.phenomena_count++] = phenomenon;
+            }
+        }
+    });
+}
+
+void decode_temperature(util::string_view const& value, pirep_record& record)
+{
+    if (value.empty())
+    {
+        return;
+    }
+
+    size_t pos = 0;
+    bool negative = false;
+    if (value[0] == 'M' || value[0] == '-' || value[0] == '+')
+    {
+        negative = value[0] != '+';
+        pos = 1;
+    }
+
+    auto digits = value.size() - pos;
+    if (digits < 1 || digits > 2 || !are_digits(value, pos, digits))
+    {
+        return;
+    }
+    auto temperature = to_number(value, pos, digits);
+    record.temperature = static_cast<int8_t>(negative ? -temperature : temperature);
+}
+
+void decode_wind(util::string_view const& value, pirep_record& record)
+{
+    wind result;
+    if (decode_wind_token(value, result))
+    {
+        record.wind_group = result;
+        return;
+    }
+
+    // The unit is often left off, in which case it is knots
+    if ((value.size() == 5 || value.size() == 6) && are_digits(value, 0, value.size()))
+    {
+        result.direction = static_cast<uint16_t>(to_number(value, 0, 3));
+        result.wind_speed = static_cast<uint8_t>(to_number(value, 3, value.size() - 3));
+        record.wind_group = result;
+    }
+}
+
+void decode_turbulence(util::string_view const& value, pirep_record& record)
+{
+    turbulence result;
+    bool found = false;
+    char pending = 0;
+
+    for_each_token(value, [&](util::string_view const& token)
+    {
+        if (decode_intensity_range(token, decode_turbulence_intensity, result.lower, result.upper))
+        {
+            found = true;
+        }
+        else if (token == "CAT")   { result.type = turbulence_type::clear_air; }
+        else if (token == "CHOP")  { result.type = turbulence_type::chop; }
+        else if (token == "OCNL")  { result.frequency = turbulence_frequency::occasional; }
+        else if (token == "INTMT") { result.frequency = turbulence_frequency::intermittent; }
+        else if (token == "CONS")  { result.frequency = turbulence_frequency::continuous; }
+        else
+        {
+            decode_altitude_range(token, pending, result.base, result.top);
+        }
+    });
+
+    if (found)
+    {
+        record.turbulence_group = result;
+    }
+}
+
+void decode_icing(util::string_view const& value, pirep_record& record)
+{
+    icing result;
+    bool found = false;
+    char pending = 0;
+
+    for_each_token(value, [&](util::string_view const& token)
+    {
+        if (decode_intensity_range(token, decode_icing_intensity, result.lower, result.upper))
+        {
+            found = true;
+        }
+        else if (token == "RIME")                 { result.type = icing_type::rime; }
+        else if (token == "CLR")                  { result.type = icing_type::clear; }
+        else if (token == "MX" || token == "MXD") { result.type = icing_type::mixed; }
+        else
+        {
+            decode_altitude_range(token, pending, result.base, result.top);
+        }
+    });
+
+    if (found)
+    {
+        record.icing_group = result;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+// Decodes one report. offset is the position of text within the source the
+// record's spans refer to.
+void decode_report(util::string_view const& text, size_t offset, pirep_record& record, weather& scratch)
+{
+    record = pirep_record();
+
+    auto spanOf = [&](util::string_view const& part)
+    {
+        text_span result;
+        result.offset = static_cast<uint32_t>(offset + (part.data() - text.data()));
+        result.length = static_cast<uint32_t>(part.size());
+        return result;
+    };
+
+    auto report = trim(text);
+    record.raw = spanOf(report);
+
+    // [station] UA|UUA
+    auto pos = find_field_start(report, 0);
+    for_each_token(report.substr(0, pos), [&](util::string_view const& token)
+    {
+        if (token == "UA" || token == "UUA")
+        {
+            record.type = token == "UUA" ? pirep_type::urgent : pirep_type::routine;
+        }
+        else if (record.identifier.length == 0 && is_station_token(token))
+        {
+            record.identifier = spanOf(token);
+        }
+    });
+
+    while (pos < report.size())
+    {
+        auto code = report.substr(pos + 1, 2);
+        auto end = code == "RM" ? report.size() : find_field_start(report, pos + 3);
+        auto value = trim(report.substr(pos + 3, end - pos - 3));
+        pos = end;
+
+        if (code == "OV")
+        {
+            record.location = spanOf(value);
+        }
+        else if (code == "TM")
+        {
+            if (value.size() == 4 && are_digits(value, 0, 4))
+            {
+                record.observation_time = time(0, static_cast<uint8_t>(to_number(value, 0, 2)), static_cast<uint8_t>(to_number(value, 2, 2)));
+            }
+        }
+        else if (code == "FL")
+        {
+            if (value.size() == 3 && are_digits(value, 0, 3))
+            {
+                record.altitude = static_cast<uint32_t>(to_number(value, 0, 3)) * 100;
+            }
+        }
+        else if (code == "TP")
+        {
+            record.aircraft_type = spanOf(value);
+        }
+        else if (code == "SK")
+        {
+            decode_sky_condition(value, record);
+        }
+        else if (code == "WX")
+        {
+            decode_weather(value, record, scratch);
+        }
+        else if (code == "TA")
+        {
+            decode_temperature(value, record);
+        }
+        else if (code == "WV")
+        {
+            decode_wind(value, record);
+        }
+        else if (code == "TB")
+        {
+            decode_turbulence(value, record);
+        }
+        else if (code == "IC")
+        {
+            decode_icing(value, record);
+        }
+        else if (code == "RM")
+        {
+            record.remarks = spanOf(value);
+        }
+    }
+}
+
+// Offset of the start of a report on the line, or npos. A report starts at
+// UA or UUA followed by a field, or at the station before it.
+size_t find_report_start(util::string_view const& line)
+{
+    size_t result = util::string_view::npos;
+    size_t previous = util::string_view::npos;
+    size_t index = 0;
+
+    for_each_token(line, [&](util::string_view const& token)
+    {
+        auto const tokenOffset = static_cast<size_t>(token.data() - line.data());
+        if (result == util::string_view::npos && (token == "UA" || token == "UUA"))
+        {
+            auto next = trim(line.substr(tokenOffset + token.size()));
+            if (!next.empty() && next[0] == '/')
+            {
+                result = (index == 1 && previous != util::string_view::npos) ? previous : tokenOffset;
+            }
+        }
+        if (index++ == 0 && is_station_token(token))
+        {
+            previous = tokenOffset;
+        }
+    });
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+turbulence::turbulence() :
+    lower(turbulence_intensity::none),
+    upper(turbulence_intensity::none),
+    type(turbulence_type::unspecified),
+    frequency(turbulence_frequency::unspecified)
+{}
+
+turbulence::turbulence(turbulence && other) :
+    lower(turbulence_intensity::none),
+    upper(turbulence_intensity::none),
+    type(turbulence_type::unspecified),
+    frequency(turbulence_frequency::unspecified)
+{
+    *this = std::move(other);
+}
+
+turbulence& turbulence::operator=(turbulence && rhs)
+{
+    if (this != &rhs)
+    {
+        lower = rhs.lower;
+        upper = rhs.upper;
+        type = rhs.type;
+        frequency = rhs.frequency;
+        base = std::move(rhs.base);
+        top = std::move(rhs.top);
+
+        rhs.lower = turbulence_intensity::none;
+        rhs.upper = turbulence_intensity::none;
+        rhs.type = turbulence_type::unspecified;
+        rhs.frequency = turbulence_frequency::unspecified;
+        rhs.base = util::nullopt;
+        rhs.top = util::nullopt;
+    }
+    return *this;
+}
+
+bool turbulence::operator== (turbulence const& rhs) const
+{
+    return (lower == rhs.lower) &&
+        (upper == rhs.upper) &&
+        (type == rhs.type) &&
+        (frequency == rhs.frequency) &&
+        (base == rhs.base) &&
+        (top == rhs.top);
+}
+
+bool turbulence::operator!= (turbulence const& rhs) const
+{
+    return !(*this == rhs);
+}
+
+//-----------------------------------------------------------------------------
+
+icing::icing() :
+    lower(icing_intensity::none),
+    upper(icing_intensity::none),
+    type(icing_type::unspecified)
+{}
+
+icing::icing(icing && other) :
+    lower(icing_intensity::none),
+    upper(icing_intensity::none),
+    type(icing_type::unspecified)
+{
+    *this = std::move(other);
+}
+
+icing& icing::operator=(icing && rhs)
+{
+    if (this != &rhs)
+    {
+        lower = rhs.lower;
+        upper = rhs.upper;
+        type = rhs.type;
+        base = std::move(rhs.base);
+        top = std::move(rhs.top);
+
+        rhs.lower = icing_intensity::none;
+        rhs.upper = icing_intensity::none;
+        rhs.type = icing_type::unspecified;
+        rhs.base = util::nullopt;
+        rhs.top = util::nullopt;
+    }
+    return *this;
+}
+
+bool icing::operator== (icing const& rhs) const
+{
+    return (lower == rhs.lower) &&
+        (upper == rhs.upper) &&
+        (type == rhs.type) &&
+        (base == rhs.base) &&
+        (top == rhs.top);
+}
+
+bool icing::operator!= (icing const& rhs) const
+{
+    return !(*this == rhs);
+}
+
+//-----------------------------------------------------------------------------
+
+weather compact_weather::to_weather() const
+{
+    weather result;
+    result.intensity = intensity;
+    result.descriptor = descriptor;
+    result.phenomena.assign(phenomena, phenomena + phenomena_count);
+    return result;
+}
+
+pirep_record::pirep_record() :
+    raw(),
+    type(pirep_type::routine),
+    identifier(),
+    location(),
+    aircraft_type(),
+    sky_condition_count(0),
+    weather_count(0),
+    remarks()
+{
+    for (auto& top : cloud_tops)
+    {
+        top = UINT32_MAX;
+    }
+}
+
+size_t decode_pireps(util::string_view const& bulletin, std::vector<pirep_record>& records)
+{
+    size_t count = 0;
+    size_t reportStart = util::string_view::npos;
+    size_t reportEnd = 0;
+    weather scratch;
+
+    auto flush = [&]()
+    {
+        if (reportStart == util::string_view::npos)
+        {
+            return;
+        }
+        if (count == records.size())
+        {
+            records.emplace_back();
+        }
+        decode_report(bulletin.substr(reportStart, reportEnd - reportStart), reportStart, records[count++], scratch);
+    };
+
+    for_each_line(bulletin, [&](util::string_view const& line)
+    {
+        auto const lineOffset = static_cast<size_t>(line.data() - bulletin.data());
+        auto start = find_report_start(line);
+        if (start != util::string_view::npos)
+        {
+            flush();
+            reportStart = lineOffset + start;
+        }
+        reportEnd = lineOffset + line.size();
+    });
+    flush();
+
+    records.resize(count);
+    return count;
+}
+
+//-----------------------------------------------------------------------------
+
+pirep::pirep() :
+    raw_data(""),
+    type(pirep_type::routine),
+    identifier(""),
+    location(""),
+    aircraft_type(""),
+    remarks("")
+{}
+
+pirep::pirep(std::string const& pirep) :
+    raw_data(""),
+    type(pirep_type::routine),
+    identifier(""),
+    location(""),
+    aircraft_type(""),
+    remarks("")
+{
+    pirep_record record;
+    weather scratch;
+    decode_report(pirep, 0, record, scratch);
+    assign(record, pirep);
+}
+
+pirep::pirep(pirep_record const& record, util::string_view const& source) :
+    raw_data(""),
+    type(pirep_type::routine),
+    identifier(""),
+    location(""),
+    aircraft_type(""),
+    remarks("")
+{
+    assign(record, source);
+}
+
+pirep::pirep(pirep && other) :
+    raw_data(""),
+    type(pirep_type::routine),
+    identifier(""),
+    location(""),
+    aircraft_type(""),
+    remarks("")
+{
+    *this = std::move(other);
+}
+
+pirep& pirep::operator=(pirep && rhs)
+{
+    if (this != &rhs)
+    {
+        raw_data = std::move(rhs.raw_data);
+        type = rhs.type;
+        identifier = std::move(rhs.identifier);
+        location = std::move(rhs.location);
+        observation_time = std::move(rhs.observation_time);
+        altitude = std::move(rhs.altitude);
+        aircraft_type = std::move(rhs.aircraft_type);
+        sky_condition_group = std::move(rhs.sky_condition_group);
+        cloud_tops = std::move(rhs.cloud_tops);
+        flight_visibility = std::move(rhs.flight_visibility);
+        weather_group = std::move(rhs.weather_group);
+        temperature = std::move(rhs.temperature);
+        wind_group = std::move(rhs.wind_group);
+        turbulence_group = std::move(rhs.turbulence_group);
+        icing_group = std::move(rhs.icing_group);
+        remarks = std::move(rhs.remarks);
+
+        rhs.raw_data = "";
+        rhs.type = pirep_type::routine;
+        rhs.identifier = "";
+        rhs.location = "";
+        rhs.observation_time = util::nullopt;
+        rhs.altitude = util::nullopt;
+        rhs.aircraft_type = "";
+        rhs.sky_condition_group.clear();
+        rhs.cloud_tops.clear();
+        rhs.flight_visibility = util::nullopt;
+        rhs.weather_group.clear();
+        rhs.temperature = util::nullopt;
+        rhs.wind_group = util::nullopt;
+        rhs.turbulence_group = util::nullopt;
+        rhs.icing_group = util::nullopt;
+        rhs.remarks = "";
+    }
+    return *this;
+}
+
+bool pirep::operator== (pirep const& rhs) const
+{
+    return (type == rhs.type) &&
+        (identifier == rhs.identifier) &&
+        (location == rhs.location) &&
+        (observation_time == rhs.observation_time) &&
+        (altitude == rhs.altitude) &&
+        (aircraft_type == rhs.aircraft_type) &&
+        (sky_condition_group == rhs.sky_condition_group) &&
+        (cloud_tops == rhs.cloud_tops) &&
+        (flight_visibility == rhs.flight_visibility) &&
+        (weather_group == rhs.weather_group) &&
+        (temperature == rhs.temperature) &&
+        (wind_group == rhs.wind_group) &&
+        (turbulence_group == rhs.turbulence_group) &&
+        (icing_group == rhs.icing_group) &&
+        (remarks == rhs.remarks);
+}
+
+bool pirep::operator!= (pirep const& rhs) const
+{
+    return !(*this == rhs);
+}
+
+void pirep::assign(pirep_record const& record, util::string_view const& source)
+{
+    raw_data = span_text(source, record.raw).to_string();
+    type = record.type;
+    identifier = span_text(source, record.identifier).to_string();
+    location = span_text(source, record.location).to_string();
+    observation_time = record.observation_time;
+    altitude = record.altitude;
+    aircraft_type = span_text(source, record.aircraft_type).to_string();
+    sky_condition_group.assign(record.sky_condition_group, record.sky_condition_group + record.sky_condition_count);
+    cloud_tops.assign(record.cloud_tops, record.cloud_tops + record.sky_condition_count);
+    flight_visibility = record.flight_visibility;
+    weather_group.clear();
+    for (uint8_t i = 0; i < record.weather_count; ++i)
+    {
+        weather_group.push_back(record.weather_group[i].to_weather());
+    }
+    temperature = record.temperature;
+    wind_group = record.wind_group;
+    turbulence_group = record.turbulence_group;
+    icing_group = record.icing_group;
+    remarks = span_text(source, record.remarks).to_string();
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
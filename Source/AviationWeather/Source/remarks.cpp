@@ -0,0 +1,537 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/remarks.h>
+
+#include <string>
+#include <thread>
+
+#include "decoders.h"
+#include "token_decoders.h"
+#include "tokens.h"
+
+namespace aw
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+bool is_sign(char c)
+{
+    return c == '0' || c == '1';
+}
+
+// Decodes an snnn temperature group: sign (0 positive, 1 negative) followed
+// by tenths of a degree Celsius.
+double to_temperature(util::string_view const& token, size_t offset)
+{
+    auto tenths = to_number(token, offset + 1, 3) / 10.0;
+    return token[offset] == '1' ? -tenths : tenths;
+}
+
+//-----------------------------------------------------------------------------
+
+bool decode_remark_time(util::string_view const& digits, remark_time& result)
+{
+    if ((digits.size() != 2 && digits.size() != 4) || !are_digits(digits, 0, digits.size()))
+    {
+        return false;
+    }
+
+    result.hour = util::nullopt;
+    if (digits.size() == 4)
+    {
+        auto hour = to_number(digits, 0, 2);
+        if (hour > 23)
+        {
+            return false;
+        }
+        result.hour = static_cast<uint8_t>(hour);
+    }
+
+    auto minute = to_number(digits, digits.size() - 2, 2);
+    if (minute > 59)
+    {
+        return false;
+    }
+    result.minute = static_cast<uint8_t>(minute);
+    return true;
+}
+
+// dddff(f)/(hh)mm
+bool decode_peak_wind(util::string_view const& token, peak_wind& result)
+{
+    auto separator = token.find('/');
+    if (separator != 5 && separator != 6)
+    {
+        return false;
+    }
+    if (!are_digits(token, 0, separator) || !decode_remark_time(token.substr(separator + 1), result.time))
+    {
+        return false;
+    }
+
+    result.direction = static_cast<uint16_t>(to_number(token, 0, 3));
+    result.speed = static_cast<uint16_t>(to_number(token, 3, separator - 3));
+    return true;
+}
+
+// Fixed-format numeric groups: SLPppp, Tsnnnsnnn, Prrrr, 6rrrr, 7rrrr, 1snnn,
+// 2snnn and 4snnnsnnn. Groups reported as missing (e.g. 6////) do not match.
+template <class TGroups>
+bool decode_numeric_group(util::string_view const& token, TGroups& groups)
+{
+    if (token.size() == 6 && starts_with(token, "SLP") && are_digits(token, 3, 3))
+    {
+        // Tenths of a hectopascal with the leading 9 or 10 omitted
+        auto tenths = to_number(token, 3, 3) / 10.0;
+        groups.sea_level_pressure = tenths + (tenths < 50.0 ? 1000.0 : 900.0);
+        return true;
+    }
+
+    if (token.size() == 9 && token[0] == 'T' && is_sign(token[1]) && is_sign(token[5]) &&
+        are_digits(token, 2, 3) && are_digits(token, 6, 3))
+    {
+        groups.precise_temperature = to_temperature(token, 1);
+        groups.precise_dewpoint = to_temperature(token, 5);
+        return true;
+    }
+
+    if (token.size() == 5 && token[0] == 'P' && are_digits(token, 1, 4))
+    {
+        groups.hourly_precipitation = to_number(token, 1, 4) / 100.0;
+        return true;
+    }
+
+    if (token.size() == 5 && are_digits(token, 0, 5))
+    {
+        switch (token[0])
+        {
+        case '6':
+            groups.period_precipitation = to_number(token, 1, 4) / 100.0;
+            return true;
+        case '7':
+            groups.daily_precipitation = to_number(token, 1, 4) / 100.0;
+            return true;
+        case '1':
+            if (!is_sign(token[1]))
+            {
+                return false;
+            }
+            groups.maximum_temperature_6_hour = to_temperature(token, 1);
+            return true;
+        case '2':
+            if (!is_sign(token[1]))
+            {
+                return false;
+            }
+            groups.minimum_temperature_6_hour = to_temperature(token, 1);
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    if (token.size() == 9 && token[0] == '4' && is_sign(token[1]) && is_sign(token[5]) && are_digits(token, 0, 9))
+    {
+        groups.maximum_temperature_24_hour = to_temperature(token, 1);
+        groups.minimum_temperature_24_hour = to_temperature(token, 5);
+        return true;
+    }
+
+    return false;
+}
+
+// Weather beginning and ending times, e.g. RAB05E30SNB30 or TSB0159E30. Each
+// beginning time starts a new event for the same weather. Nothing is added
+// unless the whole token decodes.
+bool decode_weather_events(util::string_view const& token, std::vector<weather_event>& events)
+{
+    auto const initialSize = events.size();
+    auto fail = [&]()
+    {
+        events.resize(initialSize);
+        return false;
+    };
+
+    size_t pos = 0;
+    while (pos < token.size())
+    {
+        weather_event event = { weather_intensity::moderate, weather_descriptor::none, weather_phenomena::none,
+            util::nullopt, util::nullopt };
+
+        if (token[pos] == '-' || token[pos] == '+')
+        {
+            event.intensity = decode_weather_intensity(std::string(1, token[pos]));
+            ++pos;
+        }
+        else if (pos + 2 <= token.size() && token[pos] == 'V' && token[pos + 1] == 'C')
+        {
+            event.intensity = weather_intensity::in_the_vicinity;
+            pos += 2;
+        }
+
+        if (pos + 2 <= token.size() && is_weather_descriptor(token.substr(pos, 2)))
+        {
+            event.descriptor = decode_weather_descriptor(token.substr(pos, 2).to_string());
+            pos += 2;
+        }
+        if (pos + 2 <= token.size() && is_weather_phenomenon(token.substr(pos, 2)))
+        {
+            event.phenomenon = decode_weather_phenomena(token.substr(pos, 2).to_string());
+            pos += 2;
+        }
+        if (event.descriptor == weather_descriptor::none && event.phenomenon == weather_phenomena::none)
+        {
+            return fail();
+        }
+
+        bool hasTime = false;
+        while (pos + 1 < token.size() && (token[pos] == 'B' || token[pos] == 'E') && is_digit(token[pos + 1]))
+        {
+            auto marker = token[pos++];
+            auto start = pos;
+            while (pos < token.size() && is_digit(token[pos]))
+            {
+                ++pos;
+            }
+
+            remark_time time;
+            if (!decode_remark_time(token.substr(start, pos - start), time))
+            {
+                return fail();
+            }
+
+            if (marker == 'B')
+            {
+                if (event.begin || event.end)
+                {
+                    events.push_back(event);
+                    event.end = util::nullopt;
+                }
+                event.begin = time;
+            }
+            else
+            {
+                if (event.end)
+                {
+                    events.push_back(event);
+                    event.begin = util::nullopt;
+                }
+                event.end = time;
+            }
+            hasTime = true;
+        }
+
+        if (!hasTime)
+        {
+            return fail();
+        }
+        events.push_back(event);
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+metar_remarks::decoded_groups::decoded_groups() :
+    automated_station(automated_station_type::none),
+    lightning_detector_not_operating(false),
+    precipitation_identifier_not_operating(false),
+    maintenance_required(false)
+{}
+
+//-----------------------------------------------------------------------------
+
+metar_remarks::metar_remarks(util::string_view const& remarks) :
+    m_text(remarks),
+    m_state(state_pending)
+{}
+
+metar_remarks::metar_remarks(metar const& report) :
+    m_text(report.remarks),
+    m_state(state_pending)
+{}
+
+metar_remarks::metar_remarks(metar_view const& report) :
+    m_text(report.remarks),
+    m_state(state_pending)
+{}
+
+metar_remarks::metar_remarks(metar_remarks const& other) :
+    m_state(state_pending)
+{
+    *this = other;
+}
+
+metar_remarks::metar_remarks(metar_remarks && other) :
+    m_state(state_pending)
+{
+    *this = std::move(other);
+}
+
+// The source may be decoding on another thread, so its groups are only
+// copied once they have been published
+metar_remarks& metar_remarks::operator=(metar_remarks const& rhs)
+{
+    if (this != &rhs)
+    {
+        m_text = rhs.m_text;
+        if (rhs.m_state.load(std::memory_order_acquire) == state_decoded)
+        {
+            m_groups = rhs.m_groups;
+            m_state.store(state_decoded, std::memory_order_relaxed);
+        }
+        else
+        {
+            m_groups = decoded_groups();
+            m_state.store(state_pending, std::memory_order_relaxed);
+        }
+    }
+    return *this;
+}
+
+metar_remarks& metar_remarks::operator=(metar_remarks && rhs)
+{
+    if (this != &rhs)
+    {
+        m_text = rhs.m_text;
+        m_groups = std::move(rhs.m_groups);
+        m_state.store(rhs.m_state.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        // The source keeps its text and decodes again if accessed
+        rhs.m_state.store(state_pending, std::memory_order_relaxed);
+        rhs.m_groups = decoded_groups();
+    }
+    return *this;
+}
+
+automated_station_type metar_remarks::automated_station() const
+{
+    decode();
+    return m_groups.automated_station;
+}
+
+util::optional<double> metar_remarks::sea_level_pressure() const
+{
+    decode();
+    return m_groups.sea_level_pressure;
+}
+
+util::optional<double> metar_remarks::precise_temperature() const
+{
+    decode();
+    return m_groups.precise_temperature;
+}
+
+util::optional<double> metar_remarks::precise_dewpoint() const
+{
+    decode();
+    return m_groups.precise_dewpoint;
+}
+
+util::optional<double> metar_remarks::hourly_precipitation() const
+{
+    decode();
+    return m_groups.hourly_precipitation;
+}
+
+util::optional<double> metar_remarks::period_precipitation() const
+{
+    decode();
+    return m_groups.period_precipitation;
+}
+
+util::optional<double> metar_remarks::daily_precipitation() const
+{
+    decode();
+    return m_groups.daily_precipitation;
+}
+
+util::optional<double> metar_remarks::maximum_temperature_6_hour() const
+{
+    decode();
+    return m_groups.maximum_temperature_6_hour;
+}
+
+util::optional<double> metar_remarks::minimum_temperature_6_hour() const
+{
+    decode();
+    return m_groups.minimum_temperature_6_hour;
+}
+
+util::optional<double> metar_remarks::maximum_temperature_24_hour() const
+{
+    decode();
+    return m_groups.maximum_temperature_24_hour;
+}
+
+util::optional<double> metar_remarks::minimum_temperature_24_hour() const
+{
+    decode();
+    return m_groups.minimum_temperature_24_hour;
+}
+
+util::optional<peak_wind> metar_remarks::peak_wind_group() const
+{
+    decode();
+    return m_groups.peak_wind_group;
+}
+
+util::optional<wind_shift> metar_remarks::wind_shift_group() const
+{
+    decode();
+    return m_groups.wind_shift_group;
+}
+
+std::vector<weather_event> const& metar_remarks::weather_events() const
+{
+    decode();
+    return m_groups.weather_events;
+}
+
+bool metar_remarks::lightning_detector_not_operating() const
+{
+    decode();
+    return m_groups.lightning_detector_not_operating;
+}
+
+bool metar_remarks::precipitation_identifier_not_operating() const
+{
+    decode();
+    return m_groups.precipitation_identifier_not_operating;
+}
+
+bool metar_remarks::maintenance_required() const
+{
+    decode();
+    return m_groups.maintenance_required;
+}
+
+std::vector<util::string_view> const& metar_remarks::unparsed() const
+{
+    decode();
+    return m_groups.unparsed;
+}
+
+void metar_remarks::decode() const
+{
+    if (m_state.load(std::memory_order_acquire) == state_decoded)
+    {
+        return;
+    }
+
+    // Only one thread decodes; any other waits for the groups to be published
+    auto expected = state_pending;
+    if (!m_state.compare_exchange_strong(expected, state_decoding, std::memory_order_acquire))
+    {
+        while (m_state.load(std::memory_order_acquire) != state_decoded)
+        {
+            std::this_thread::yield();
+        }
+        return;
+    }
+
+    try
+    {
+        decode_groups(m_text, m_groups);
+    }
+    catch (...)
+    {
+        m_groups = decoded_groups();
+        m_state.store(state_pending, std::memory_order_release);
+        throw;
+    }
+    m_state.store(state_decoded, std::memory_order_release);
+}
+
+void metar_remarks::decode_groups(util::string_view const& text, decoded_groups& groups)
+{
+    std::vector<util::string_view> tokens;
+    for_each_token(text, [&](util::string_view const& token)
+    {
+        tokens.push_back(token);
+    });
+
+    for (size_t i = 0; i < tokens.size(); ++i)
+    {
+        auto const& token = tokens[i];
+        auto const remaining = tokens.size() - i - 1;
+
+        if (token == "AO1")
+        {
+            groups.automated_station = automated_station_type::without_precipitation_discriminator;
+        }
+        else if (token == "AO2")
+        {
+            groups.automated_station = automated_station_type::with_precipitation_discriminator;
+        }
+        else if (token == "TSNO")
+        {
+            groups.lightning_detector_not_operating = true;
+        }
+        else if (token == "PWINO")
+        {
+            groups.precipitation_identifier_not_operating = true;
+        }
+        else if (token == "$")
+        {
+            groups.maintenance_required = true;
+        }
+        else if (token == "PK" && remaining >= 2 && tokens[i + 1] == "WND")
+        {
+            peak_wind peakWind;
+            if (!decode_peak_wind(tokens[i + 2], peakWind))
+            {
+                groups.unparsed.push_back(token);
+                continue;
+            }
+            groups.peak_wind_group = peakWind;
+            i += 2;
+        }
+        else if (token == "WSHFT" && remaining >= 1)
+        {
+            wind_shift windShift = { remark_time(), false };
+            if (!decode_remark_time(tokens[i + 1], windShift.time))
+            {
+                groups.unparsed.push_back(token);
+                continue;
+            }
+            ++i;
+            if (i + 1 < tokens.size() && tokens[i + 1] == "FROPA")
+            {
+                windShift.frontal_passage = true;
+                ++i;
+            }
+            groups.wind_shift_group = windShift;
+        }
+        else if (!decode_numeric_group(token, groups) && !decode_weather_events(token, groups.weather_events))
+        {
+            groups.unparsed.push_back(token);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -0,0 +1,544 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/runway_wind.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <AviationWeather/converters.h>
+
+#include "simd.h"
+
+namespace aw
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const double degrees_to_radians = 3.14159265358979323846 / 180.0;
+const size_t heading_count = 36;
+
+// Sine and cosine of every multiple of 10 degrees, indexed by tens of
+// degrees. Runway headings are always a multiple of 10 degrees, and so are
+// nearly all reported wind directions.
+class heading_table
+{
+public:
+    heading_table()
+    {
+        for (size_t i = 0; i < heading_count; ++i)
+        {
+            m_cos[i] = static_cast<float>(std::cos(i * 10 * degrees_to_radians));
+            m_sin[i] = static_cast<float>(std::sin(i * 10 * degrees_to_radians));
+        }
+    }
+
+    float cos(size_t index) const { return m_cos[index]; }
+    float sin(size_t index) const { return m_sin[index]; }
+
+    // Falls back to the library functions for directions in between
+    void direction(uint16_t degrees, float& c, float& s) const
+    {
+        if (degrees % 10 == 0)
+        {
+            c = m_cos[degrees / 10 % heading_count];
+            s = m_sin[degrees / 10 % heading_count];
+        }
+        else
+        {
+            c = static_cast<float>(std::cos(degrees * degrees_to_radians));
+            s = static_cast<float>(std::sin(degrees * degrees_to_radians));
+        }
+    }
+
+private:
+    float m_cos[heading_count];
+    float m_sin[heading_count];
+};
+
+heading_table const& headings()
+{
+    static const heading_table table;
+    return table;
+}
+
+// Whether heading + offset lies within the arc of width degrees clockwise
+// from lower. All inputs are whole degrees in [0, 360), which floats hold
+// exactly, so one correction each way is enough and the loop needs no modulo.
+inline bool arc_contains(float heading, float offset, float lower, float width)
+{
+    auto angle = heading + offset - lower;
+    angle += angle < 0.0f ? 360.0f : 0.0f;
+    angle -= angle >= 360.0f ? 360.0f : 0.0f;
+    return angle <= width;
+}
+
+// Wind inputs as columns of floats over a block of column_count * count
+// floats. They are gathered once per station, then repeated for each of the
+// station's runways along with the runway heading, so that the runway pass
+// reads every input contiguously. The runways are repeated a tile at a time,
+// which keeps the repeated columns in the L1 cache rather than writing them
+// all out to memory and reading them back.
+struct wind_columns
+{
+    static const size_t column_count = 13;
+    static const size_t tile_size = 256;
+
+    wind_columns(float* block, size_t count)
+    {
+        auto column = block;
+        for (auto field : { &speed, &gust, &cosDirection, &sinDirection, &cosLower, &sinLower, &cosUpper, &sinUpper,
+            &lower, &width, &heading, &cosHeading, &sinHeading })
+        {
+            *field = column;
+            column += count;
+        }
+    }
+
+    float* speed;        // Knots, NaN without a wind
+    float* gust;         // Knots, the steady speed without a gust
+    float* cosDirection; // Zero for variable winds without a direction
+    float* sinDirection;
+    float* cosLower;     // Ends of the variation range
+    float* sinLower;
+    float* cosUpper;
+    float* sinUpper;
+    float* lower;        // Start of the variation range in degrees
+    float* width;        // Clockwise width of the range in degrees
+    float* heading;      // Runway heading in degrees, runway columns only
+    float* cosHeading;
+    float* sinHeading;
+};
+
+void gather_station(wind const& windGroup, size_t index, wind_columns& columns)
+{
+    auto const& table = headings();
+
+    columns.speed[index] = static_cast<float>(convert(windGroup.wind_speed, windGroup.unit, speed_unit::kt));
+    columns.gust[index] = windGroup.gust_speed > windGroup.wind_speed ?
+        static_cast<float>(convert(windGroup.gust_speed, windGroup.unit, speed_unit::kt)) : columns.speed[index];
+
+    if (windGroup.direction == UINT16_MAX)
+    {
+        columns.cosDirection[index] = columns.sinDirection[index] = 0.0f;
+    }
+    else
+    {
+        table.direction(windGroup.direction % 360, columns.cosDirection[index], columns.sinDirection[index]);
+    }
+
+    if (windGroup.variation_lower && windGroup.variation_upper)
+    {
+        auto lower = *windGroup.variation_lower % 360;
+        auto upper = *windGroup.variation_upper % 360;
+        table.direction(lower, columns.cosLower[index], columns.sinLower[index]);
+        table.direction(upper, columns.cosUpper[index], columns.sinUpper[index]);
+        columns.lower[index] = static_cast<float>(lower);
+        columns.width[index] = static_cast<float>((upper - lower + 360) % 360);
+    }
+    else if (windGroup.direction == UINT16_MAX)
+    {
+        // Every direction, so the arc checks below always pass
+        columns.cosLower[index] = columns.sinLower[index] = columns.cosUpper[index] = columns.sinUpper[index] = 0.0f;
+        columns.lower[index] = 0.0f;
+        columns.width[index] = 360.0f;
+    }
+    else
+    {
+        columns.cosLower[index] = columns.cosUpper[index] = columns.cosDirection[index];
+        columns.sinLower[index] = columns.sinUpper[index] = columns.sinDirection[index];
+        columns.lower[index] = static_cast<float>(windGroup.direction % 360);
+        columns.width[index] = 0.0f;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+// The runway pass has a scalar form, which is the reference, and with SSE2 a
+// four-lane form. The angle between the wind and the runway comes from the
+// difference identities, so each runway costs a few multiplies rather than a
+// sin and cos. The extremes over an arc are at its ends, or at a direction
+// where the wind is directly across or behind the runway if the arc holds it.
+
+// Reads tile entry i and writes runway r
+void compute_runway(wind_columns const& w, size_t i, runway_winds& results, size_t r)
+{
+    auto cosHeading = w.cosHeading[i];
+    auto sinHeading = w.sinHeading[i];
+
+    auto along = w.cosDirection[i] * cosHeading + w.sinDirection[i] * sinHeading;
+    auto across = w.sinDirection[i] * cosHeading - w.cosDirection[i] * sinHeading;
+
+    results.headwind[r] = w.speed[i] * along;
+    results.crosswind[r] = w.speed[i] * across;
+    results.gust_headwind[r] = w.gust[i] * along;
+    results.gust_crosswind[r] = w.gust[i] * across;
+
+    auto alongLower = w.cosLower[i] * cosHeading + w.sinLower[i] * sinHeading;
+    auto acrossLower = w.sinLower[i] * cosHeading - w.cosLower[i] * sinHeading;
+    auto alongUpper = w.cosUpper[i] * cosHeading + w.sinUpper[i] * sinHeading;
+    auto acrossUpper = w.sinUpper[i] * cosHeading - w.cosUpper[i] * sinHeading;
+
+    auto heading = w.heading[i];
+    auto lower = w.lower[i];
+    auto width = w.width[i];
+
+    auto tail = (std::max)((std::max)(0.0f, -alongLower), -alongUpper);
+    tail = arc_contains(heading, 180.0f, lower, width) ? 1.0f : tail;
+
+    auto cross = (std::max)(std::fabs(acrossLower), std::fabs(acrossUpper));
+    cross = arc_contains(heading, 90.0f, lower, width) || arc_contains(heading, 270.0f, lower, width) ? 1.0f : cross;
+
+    results.max_tailwind[r] = w.gust[i] * tail;
+    results.max_crosswind[r] = w.gust[i] * cross;
+}
+
+#if defined(AW_SSE2)
+
+inline __m128 arc_contains(__m128 heading, float offset, __m128 lower, __m128 width)
+{
+    using namespace simd;
+    auto angle = _mm_sub_ps(_mm_add_ps(heading, set(offset)), lower);
+    angle = _mm_add_ps(angle, _mm_and_ps(_mm_cmplt_ps(angle, _mm_setzero_ps()), set(360.0f)));
+    angle = _mm_sub_ps(angle, _mm_and_ps(_mm_cmpge_ps(angle, set(360.0f)), set(360.0f)));
+    return _mm_cmple_ps(angle, width);
+}
+
+// a cos + b sin
+inline __m128 dot(__m128 a, __m128 cosine, __m128 b, __m128 sine)
+{
+    return _mm_add_ps(_mm_mul_ps(a, cosine), _mm_mul_ps(b, sine));
+}
+
+inline __m128 negate(__m128 value)
+{
+    return _mm_sub_ps(_mm_setzero_ps(), value);
+}
+
+inline __m128 absolute(__m128 value)
+{
+    return _mm_andnot_ps(simd::set(-0.0f), value);
+}
+
+// Tile entries i to i + 3 into runways r to r + 3. The max operands are
+// ordered so that equal lanes resolve as std::max does in the scalar form.
+void compute_runways(wind_columns const& w, size_t i, runway_winds& results, size_t r)
+{
+    using namespace simd;
+    auto load = [i](float const* column) { return _mm_loadu_ps(column + i); };
+
+    auto cosHeading = load(w.cosHeading);
+    auto sinHeading = load(w.sinHeading);
+    auto speed = load(w.speed);
+    auto gust = load(w.gust);
+
+    auto cosDirection = load(w.cosDirection);
+    auto sinDirection = load(w.sinDirection);
+    auto along = dot(cosDirection, cosHeading, sinDirection, sinHeading);
+    auto across = dot(sinDirection, cosHeading, negate(cosDirection), sinHeading);
+
+    _mm_storeu_ps(&results.headwind[r], _mm_mul_ps(speed, along));
+    _mm_storeu_ps(&results.crosswind[r], _mm_mul_ps(speed, across));
+    _mm_storeu_ps(&results.gust_headwind[r], _mm_mul_ps(gust, along));
+    _mm_storeu_ps(&results.gust_crosswind[r], _mm_mul_ps(gust, across));
+
+    auto cosLower = load(w.cosLower);
+    auto sinLower = load(w.sinLower);
+    auto cosUpper = load(w.cosUpper);
+    auto sinUpper = load(w.sinUpper);
+    auto alongLower = dot(cosLower, cosHeading, sinLower, sinHeading);
+    auto acrossLower = dot(sinLower, cosHeading, negate(cosLower), sinHeading);
+    auto alongUpper = dot(cosUpper, cosHeading, sinUpper, sinHeading);
+    auto acrossUpper = dot(sinUpper, cosHeading, negate(cosUpper), sinHeading);
+
+    auto heading = load(w.heading);
+    auto lower = load(w.lower);
+    auto width = load(w.width);
+
+    auto tail = _mm_max_ps(negate(alongUpper), _mm_max_ps(negate(alongLower), _mm_setzero_ps()));
+    tail = select(arc_contains(heading, 180.0f, lower, width), set(1.0f), tail);
+
+    auto cross = _mm_max_ps(absolute(acrossUpper), absolute(acrossLower));
+    auto crossing = _mm_or_ps(arc_contains(heading, 90.0f, lower, width), arc_contains(heading, 270.0f, lower, width));
+    cross = select(crossing, set(1.0f), cross);
+
+    _mm_storeu_ps(&results.max_tailwind[r], _mm_mul_ps(gust, tail));
+    _mm_storeu_ps(&results.max_crosswind[r], _mm_mul_ps(gust, cross));
+}
+
+#endif
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+runway_table::runway_table()
+{
+    m_offsets.push_back(0);
+}
+
+runway_table::runway_table(runway_table && other)
+{
+    m_offsets.push_back(0);
+    *this = std::move(other);
+}
+
+runway_table& runway_table::operator=(runway_table && rhs)
+{
+    if (this != &rhs)
+    {
+        m_stationIndices = std::move(rhs.m_stationIndices);
+        m_stations = std::move(rhs.m_stations);
+        m_offsets = std::move(rhs.m_offsets);
+        m_runwayStation = std::move(rhs.m_runwayStation);
+        m_numbers = std::move(rhs.m_numbers);
+        m_designators = std::move(rhs.m_designators);
+
+        rhs.m_stationIndices.clear();
+        rhs.m_stations.clear();
+        rhs.m_offsets.assign(1, 0);
+        rhs.m_runwayStation.clear();
+        rhs.m_numbers.clear();
+        rhs.m_designators.clear();
+    }
+    return *this;
+}
+
+void runway_table::add(station_identifier const& identifier, uint8_t number, runway_designator_type designator)
+{
+    if (number < 1 || number > heading_count)
+    {
+        throw aw_exception("Runway numbers must be between 1 and 36");
+    }
+
+    auto it = m_stationIndices.find(identifier);
+    if (it == m_stationIndices.end())
+    {
+        it = m_stationIndices.emplace(identifier, m_stations.size()).first;
+        m_stations.push_back(identifier);
+        m_offsets.push_back(m_offsets.back());
+    }
+
+    // Insert after the station's last runway and shift the later stations
+    auto stationIndex = it->second;
+    auto position = m_offsets[stationIndex + 1];
+    m_runwayStation.insert(m_runwayStation.begin() + position, static_cast<uint32_t>(stationIndex));
+    m_numbers.insert(m_numbers.begin() + position, number);
+    m_designators.insert(m_designators.begin() + position, designator);
+    for (auto i = stationIndex + 1; i < m_offsets.size(); ++i)
+    {
+        ++m_offsets[i];
+    }
+}
+
+util::optional<size_t> runway_table::find(station_identifier const& identifier) const
+{
+    auto it = m_stationIndices.find(identifier);
+    if (it == m_stationIndices.end())
+    {
+        return util::nullopt;
+    }
+    return it->second;
+}
+
+size_t runway_table::station_count() const
+{
+    return m_stations.size();
+}
+
+size_t runway_table::runway_count() const
+{
+    return m_numbers.size();
+}
+
+station_identifier const& runway_table::station(size_t stationIndex) const
+{
+    return m_stations[stationIndex];
+}
+
+size_t runway_table::first_runway(size_t stationIndex) const
+{
+    return m_offsets[stationIndex];
+}
+
+size_t runway_table::last_runway(size_t stationIndex) const
+{
+    return m_offsets[stationIndex + 1];
+}
+
+uint8_t runway_table::runway_number(size_t runwayIndex) const
+{
+    return m_numbers[runwayIndex];
+}
+
+runway_designator_type runway_table::runway_designator(size_t runwayIndex) const
+{
+    return m_designators[runwayIndex];
+}
+
+size_t runway_table::runway_station(size_t runwayIndex) const
+{
+    return m_runwayStation[runwayIndex];
+}
+
+//-----------------------------------------------------------------------------
+
+runway_winds::runway_winds()
+{}
+
+runway_winds::runway_winds(runway_winds && other)
+{
+    *this = std::move(other);
+}
+
+runway_winds& runway_winds::operator=(runway_winds && rhs)
+{
+    if (this != &rhs)
+    {
+        headwind = std::move(rhs.headwind);
+        crosswind = std::move(rhs.crosswind);
+        gust_headwind = std::move(rhs.gust_headwind);
+        gust_crosswind = std::move(rhs.gust_crosswind);
+        max_tailwind = std::move(rhs.max_tailwind);
+        max_crosswind = std::move(rhs.max_crosswind);
+        m_columns = std::move(rhs.m_columns);
+
+        rhs.headwind.clear();
+        rhs.crosswind.clear();
+        rhs.gust_headwind.clear();
+        rhs.gust_crosswind.clear();
+        rhs.max_tailwind.clear();
+        rhs.max_crosswind.clear();
+        rhs.m_columns.clear();
+    }
+    return *this;
+}
+
+void runway_winds::compute(runway_table const& runways, std::vector<util::optional<wind>> const& winds)
+{
+    if (winds.size() != runways.station_count())
+    {
+        throw aw_exception("Expected one wind per station");
+    }
+
+    // The columns are kept between calls, so that repeated updates do not
+    // allocate
+    m_columns.resize((winds.size() + wind_columns::tile_size) * wind_columns::column_count);
+    wind_columns stations(m_columns.data(), winds.size());
+    wind_columns tile(m_columns.data() + winds.size() * wind_columns::column_count, wind_columns::tile_size);
+
+    for (size_t i = 0; i < winds.size(); ++i)
+    {
+        if (winds[i])
+        {
+            gather_station(*winds[i], i, stations);
+        }
+        else
+        {
+            // NaN speeds carry through every product below
+            stations.speed[i] = stations.gust[i] = std::numeric_limits<float>::quiet_NaN();
+            stations.cosDirection[i] = stations.sinDirection[i] = 0.0f;
+            stations.cosLower[i] = stations.sinLower[i] = stations.cosUpper[i] = stations.sinUpper[i] = 0.0f;
+            stations.lower[i] = stations.width[i] = 0.0f;
+        }
+    }
+
+    auto const count = runways.runway_count();
+    headwind.resize(count);
+    crosswind.resize(count);
+    gust_headwind.resize(count);
+    gust_crosswind.resize(count);
+    max_tailwind.resize(count);
+    max_crosswind.resize(count);
+
+    auto const& table = headings();
+    for (size_t first = 0; first < count; first += wind_columns::tile_size)
+    {
+        // Repeat each station's inputs for its runways. The headings come
+        // from the table, as runway numbers are tens of degrees.
+        auto const remaining = count - first;
+        auto const size = remaining < wind_columns::tile_size ? remaining : wind_columns::tile_size;
+        for (size_t i = 0; i < size; ++i)
+        {
+            auto s = runways.m_runwayStation[first + i];
+            tile.speed[i] = stations.speed[s];
+            tile.gust[i] = stations.gust[s];
+            tile.cosDirection[i] = stations.cosDirection[s];
+            tile.sinDirection[i] = stations.sinDirection[s];
+            tile.cosLower[i] = stations.cosLower[s];
+            tile.sinLower[i] = stations.sinLower[s];
+            tile.cosUpper[i] = stations.cosUpper[s];
+            tile.sinUpper[i] = stations.sinUpper[s];
+            tile.lower[i] = stations.lower[s];
+            tile.width[i] = stations.width[s];
+
+            auto h = runways.m_numbers[first + i] % heading_count;
+            tile.heading[i] = static_cast<float>(h * 10);
+            tile.cosHeading[i] = table.cos(h);
+            tile.sinHeading[i] = table.sin(h);
+        }
+
+        size_t i = 0;
+#if defined(AW_SSE2)
+        for (; i + 4 <= size; i += 4)
+        {
+            compute_runways(tile, i, *this, first + i);
+        }
+#endif
+        for (; i < size; ++i)
+        {
+            compute_runway(tile, i, *this, first + i);
+        }
+    }
+}
+
+util::optional<size_t> runway_winds::best_runway(runway_table const& runways, size_t stationIndex) const
+{
+    util::optional<size_t> best;
+    for (auto r = runways.first_runway(stationIndex); r < runways.last_runway(stationIndex); ++r)
+    {
+        // Stations without a wind have NaN components and select nothing
+        if (std::isnan(headwind[r]))
+        {
+            return util::nullopt;
+        }
+        if (!best || headwind[r] > headwind[*best] ||
+            (headwind[r] == headwind[*best] && max_crosswind[r] < max_crosswind[*best]))
+        {
+            best = r;
+        }
+    }
+    return best;
+}
+
+void runway_winds::best_runways(runway_table const& runways, std::vector<util::optional<size_t>>& results) const
+{
+    results.resize(runways.station_count());
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        results[i] = best_runway(runways, i);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
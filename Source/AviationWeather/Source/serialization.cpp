@@ -0,0 +1,876 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/serialization.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "binary_format.h"
+#include "hash.h"
+
+namespace aw
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const uint8_t stream_magic[] = { 'A', 'W', 'M', 'B' };
+
+// Resolution of the scaled encodings: sixteenths cover every fractional
+// visibility and hundredths cover altimeter settings in inHg
+const double visibility_scale = 16.0;
+const double pressure_scale = 100.0;
+
+// Sky covers from this value on do not fit in the three bits of a cloud
+// layer's flags, which hold this value instead and are followed by the cover
+const uint32_t extended_sky_cover = 7;
+
+// Flags stored at the start of each report. Absent groups and empty lists
+// take no space beyond their flag.
+enum report_flags : uint32_t
+{
+    report_special                = 1 << 0,
+    report_corrected              = 1 << 1,
+    report_automatic              = 1 << 2,
+    report_wind                   = 1 << 3,
+    report_visibility             = 1 << 4,
+    report_minimum_visibility     = 1 << 5,
+    report_temperature            = 1 << 6,
+    report_dewpoint               = 1 << 7,
+    report_altimeter              = 1 << 8,
+    report_raw_data               = 1 << 9,
+    report_remarks                = 1 << 10,
+    report_runway_visual_range    = 1 << 11,
+    report_weather                = 1 << 12,
+    report_sky_condition          = 1 << 13,
+    report_recent_weather         = 1 << 14,
+    report_wind_shear             = 1 << 15,
+    report_trend                  = 1 << 16
+};
+
+enum trend_flags : uint32_t
+{
+    trend_from                    = 1 << 2,
+    trend_until                   = 1 << 3,
+    trend_at                      = 1 << 4,
+    trend_wind                    = 1 << 5,
+    trend_visibility              = 1 << 6,
+    trend_no_significant_weather  = 1 << 7
+};
+
+// The flag if the condition holds, otherwise no flags. Conditions may be
+// optional groups.
+template <class TCondition>
+uint32_t flag_if(TCondition const& condition, uint32_t flag)
+{
+    return condition ? flag : 0;
+}
+
+//-----------------------------------------------------------------------------
+
+// Groups left out of a report are reset, so that a report can be read over an
+// earlier one. Groups are read in place, and lists keep the elements they
+// already hold along with their capacity.
+template <class T>
+void read_group(binary_reader& reader, bool present, util::optional<T>& value)
+{
+    if (!present)
+    {
+        value = util::nullopt;
+        return;
+    }
+
+    if (!value)
+    {
+        value.emplace();
+    }
+    reader.read(*value);
+}
+
+// A default constructed time reads the clock, which costs more than the rest
+// of a report
+void read_group(binary_reader& reader, bool present, util::optional<time>& value)
+{
+    if (!present)
+    {
+        value = util::nullopt;
+        return;
+    }
+
+    if (!value)
+    {
+        value.emplace(uint8_t(1), uint8_t(0), uint8_t(0));
+    }
+    reader.read(*value);
+}
+
+template <class T>
+void read_group(binary_reader& reader, bool present, std::vector<T>& values)
+{
+    if (present)
+    {
+        reader.read(values);
+    }
+    else
+    {
+        reader.resize_list(values, 0);
+    }
+}
+
+template <class TText>
+void read_text(binary_reader& reader, bool present, TText& value)
+{
+    value = TText();
+    if (present)
+    {
+        reader.read_string(value);
+    }
+}
+
+// Checks the header of a stream and returns the number of reports in it
+uint64_t read_stream_header(binary_reader& reader)
+{
+    for (auto magic : stream_magic)
+    {
+        if (reader.read_byte() != magic)
+        {
+            throw aw_exception("Not a binary report stream");
+        }
+    }
+
+    auto version = reader.read_byte();
+    if (version == 0 || version > binary_format_version)
+    {
+        throw aw_exception("Unsupported binary report version");
+    }
+
+    auto count = reader.read_varint();
+    if (count > reader.remaining())
+    {
+        throw aw_exception("Truncated binary report");
+    }
+    return count;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+binary_writer::binary_writer(std::vector<uint8_t>& buffer) :
+    m_buffer(buffer)
+{}
+
+void binary_writer::write_byte(uint8_t value)
+{
+    m_buffer.push_back(value);
+}
+
+void binary_writer::write_varint(uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        m_buffer.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    m_buffer.push_back(static_cast<uint8_t>(value));
+}
+
+void binary_writer::write_signed(int64_t value)
+{
+    write_varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void binary_writer::write_fixed(uint64_t value)
+{
+    for (size_t i = 0; i < sizeof(value); ++i)
+    {
+        m_buffer.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+void binary_writer::write_double(double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    write_fixed(bits);
+}
+
+void binary_writer::write_string(std::string const& value)
+{
+    write_varint(value.size());
+    m_buffer.insert(m_buffer.end(), value.begin(), value.end());
+}
+
+// A tag in the low bit selects between the scaled varint and the raw double
+void binary_writer::write_scaled(double value, double scale)
+{
+    auto scaled = std::floor(value * scale);
+    if (scaled >= 0.0 && scaled < 9007199254740992.0 && scaled / scale == value)
+    {
+        write_varint(static_cast<uint64_t>(scaled) << 1);
+    }
+    else
+    {
+        write_varint(1);
+        write_double(value);
+    }
+}
+
+// Day, hour and minute in 16 bits
+void binary_writer::write(time const& value)
+{
+    write_varint((static_cast<uint32_t>(value.day_of_month) << 11) | (static_cast<uint32_t>(value.hour_of_day) << 6) | value.minute_of_hour);
+}
+
+void binary_writer::write(wind const& value)
+{
+    write_byte(static_cast<uint8_t>(static_cast<uint32_t>(value.unit) |
+        (value.variation_lower ? 1 << 2 : 0) |
+        (value.variation_upper ? 1 << 3 : 0)));
+
+    // Variable winds have no direction and are stored as zero
+    write_varint(value.direction == UINT16_MAX ? 0 : value.direction + 1U);
+    write_byte(value.wind_speed);
+    write_byte(value.gust_speed);
+
+    if (value.variation_lower)
+    {
+        write_varint(*value.variation_lower);
+    }
+    if (value.variation_upper)
+    {
+        write_varint(*value.variation_upper);
+    }
+}
+
+void binary_writer::write(visibility const& value)
+{
+    write_byte(static_cast<uint8_t>(static_cast<uint32_t>(value.unit) | (static_cast<uint32_t>(value.modifier) << 2)));
+    write_scaled(value.distance, visibility_scale);
+}
+
+void binary_writer::write(directional_visibility const& value)
+{
+    write(value.distance);
+    write_byte(static_cast<uint8_t>(value.direction));
+}
+
+void binary_writer::write(runway_visual_range const& value)
+{
+    write_byte(value.runway_number);
+    write_byte(static_cast<uint8_t>(static_cast<uint32_t>(value.runway_designator) | (static_cast<uint32_t>(value.tendency) << 2)));
+    write(value.visibility_min);
+    write(value.visibility_max);
+}
+
+void binary_writer::write(weather const& value)
+{
+    write_varint(static_cast<uint64_t>(value.intensity) |
+        (static_cast<uint64_t>(value.descriptor) << 2) |
+        (static_cast<uint64_t>(value.phenomena.size()) << 6));
+    for (auto phenomenon : value.phenomena)
+    {
+        write_byte(static_cast<uint8_t>(phenomenon));
+    }
+}
+
+// Unlimited layers have no height and set the top bit
+void binary_writer::write(cloud_layer const& value)
+{
+    auto unlimited = value.layer_height == UINT32_MAX;
+    auto cover = static_cast<uint32_t>(value.sky_cover);
+    write_byte(static_cast<uint8_t>((std::min)(cover, extended_sky_cover) |
+        (static_cast<uint32_t>(value.cloud_type) << 3) |
+        (static_cast<uint32_t>(value.unit) << 5) |
+        (unlimited ? 1 << 7 : 0)));
+    if (cover >= extended_sky_cover)
+    {
+        write_byte(static_cast<uint8_t>(cover));
+    }
+    if (!unlimited)
+    {
+        write_varint(value.layer_height);
+    }
+}
+
+void binary_writer::write(altimeter const& value)
+{
+    write_byte(static_cast<uint8_t>(value.unit));
+    write_scaled(value.pressure, pressure_scale);
+}
+
+void binary_writer::write(runway_wind_shear const& value)
+{
+    write_byte(static_cast<uint8_t>((value.all_runways ? 1 : 0) | (static_cast<uint32_t>(value.runway_designator) << 1)));
+    write_byte(value.runway_number);
+}
+
+void binary_writer::write(metar_trend const& value)
+{
+    write_varint(static_cast<uint32_t>(value.type) |
+        flag_if(value.from, trend_from) |
+        flag_if(value.until, trend_until) |
+        flag_if(value.at, trend_at) |
+        flag_if(value.wind_group, trend_wind) |
+        flag_if(value.visibility_group, trend_visibility) |
+        flag_if(value.no_significant_weather, trend_no_significant_weather));
+
+    if (value.from)
+    {
+        write(*value.from);
+    }
+    if (value.until)
+    {
+        write(*value.until);
+    }
+    if (value.at)
+    {
+        write(*value.at);
+    }
+    if (value.wind_group)
+    {
+        write(*value.wind_group);
+    }
+    if (value.visibility_group)
+    {
+        write(*value.visibility_group);
+    }
+    write(value.weather_group);
+    write(value.sky_condition_group);
+}
+
+// The body is written after a placeholder for its length, which is then
+// patched in. Lengths of most reports fit in one byte, so the body only
+// moves in the rare case that it needs more.
+void binary_writer::write(metar const& value, bool includeText)
+{
+    auto start = m_buffer.size();
+    m_buffer.push_back(0);
+
+    uint32_t flags =
+        flag_if(value.type == metar_report_type::special, report_special) |
+        flag_if(value.modifier == metar_modifier_type::corrected, report_corrected) |
+        flag_if(value.modifier == metar_modifier_type::automatic, report_automatic) |
+        flag_if(value.wind_group, report_wind) |
+        flag_if(value.visibility_group, report_visibility) |
+        flag_if(value.minimum_visibility_group, report_minimum_visibility) |
+        flag_if(value.temperature, report_temperature) |
+        flag_if(value.dewpoint, report_dewpoint) |
+        flag_if(value.altimeter_group, report_altimeter) |
+        flag_if(includeText && !value.raw_data.empty(), report_raw_data) |
+        flag_if(includeText && !value.remarks.empty(), report_remarks) |
+        flag_if(!value.runway_visual_range_group.empty(), report_runway_visual_range) |
+        flag_if(!value.weather_group.empty(), report_weather) |
+        flag_if(!value.sky_condition_group.empty(), report_sky_condition) |
+        flag_if(!value.recent_weather_group.empty(), report_recent_weather) |
+        flag_if(!value.wind_shear_group.empty(), report_wind_shear) |
+        flag_if(!value.trend_group.empty(), report_trend);
+
+    write_varint(flags);
+    write_string(value.identifier);
+    write(value.observation_time);
+
+    if (value.wind_group)
+    {
+        write(*value.wind_group);
+    }
+    if (value.visibility_group)
+    {
+        write(*value.visibility_group);
+    }
+    if (value.minimum_visibility_group)
+    {
+        write(*value.minimum_visibility_group);
+    }
+    if (flags & report_runway_visual_range)
+    {
+        write(value.runway_visual_range_group);
+    }
+    if (flags & report_weather)
+    {
+        write(value.weather_group);
+    }
+    if (flags & report_sky_condition)
+    {
+        write(value.sky_condition_group);
+    }
+    if (value.temperature)
+    {
+        write_signed(*value.temperature);
+    }
+    if (value.dewpoint)
+    {
+        write_signed(*value.dewpoint);
+    }
+    if (value.altimeter_group)
+    {
+        write(*value.altimeter_group);
+    }
+    if (flags & report_recent_weather)
+    {
+        write(value.recent_weather_group);
+    }
+    if (flags & report_wind_shear)
+    {
+        write(value.wind_shear_group);
+    }
+    if (flags & report_trend)
+    {
+        write(value.trend_group);
+    }
+    if (flags & report_raw_data)
+    {
+        write_string(value.raw_data);
+    }
+    if (flags & report_remarks)
+    {
+        write_string(value.remarks);
+    }
+
+    auto length = m_buffer.size() - start - 1;
+    if (length < 0x80)
+    {
+        m_buffer[start] = static_cast<uint8_t>(length);
+        return;
+    }
+
+    std::vector<uint8_t> prefix;
+    binary_writer(prefix).write_varint(length);
+    m_buffer[start] = prefix[0];
+    m_buffer.insert(m_buffer.begin() + start + 1, prefix.begin() + 1, prefix.end());
+}
+
+//-----------------------------------------------------------------------------
+
+binary_reader::binary_reader(uint8_t const* data, size_t size, binary_spares* spares) :
+    m_position(data),
+    m_end(data + size),
+    m_spares(spares)
+{}
+
+size_t binary_reader::remaining() const
+{
+    return static_cast<size_t>(m_end - m_position);
+}
+
+uint8_t const* binary_reader::position() const
+{
+    return m_position;
+}
+
+void binary_reader::skip(size_t count)
+{
+    if (count > remaining())
+    {
+        throw aw_exception("Truncated binary report");
+    }
+    m_position += count;
+}
+
+void binary_reader::throw_truncated()
+{
+    throw aw_exception("Truncated binary report");
+}
+
+uint64_t binary_reader::read_long_varint()
+{
+    uint64_t value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7)
+    {
+        auto byte = read_byte();
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return value;
+        }
+    }
+    throw aw_exception("Invalid value in binary report");
+}
+
+int64_t binary_reader::read_signed()
+{
+    auto value = read_varint();
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+uint64_t binary_reader::read_fixed()
+{
+    uint64_t value = 0;
+    if (remaining() < sizeof(value))
+    {
+        throw aw_exception("Truncated binary report");
+    }
+
+    for (size_t i = 0; i < sizeof(value); ++i)
+    {
+        value |= static_cast<uint64_t>(m_position[i]) << (i * 8);
+    }
+    m_position += sizeof(value);
+    return value;
+}
+
+double binary_reader::read_double()
+{
+    auto bits = read_fixed();
+
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void binary_reader::read_string(std::string& value)
+{
+    auto length = read_varint();
+    if (length > remaining())
+    {
+        throw aw_exception("Truncated binary report");
+    }
+    value.assign(reinterpret_cast<const char*>(m_position), static_cast<size_t>(length));
+    m_position += length;
+}
+
+void binary_reader::read_string(util::string_view& value)
+{
+    auto length = read_varint();
+    if (length > remaining())
+    {
+        throw aw_exception("Truncated binary report");
+    }
+    value = util::string_view(reinterpret_cast<const char*>(m_position), static_cast<size_t>(length));
+    m_position += length;
+}
+
+double binary_reader::read_scaled(double scale)
+{
+    auto value = read_varint();
+    if (value & 1)
+    {
+        return read_double();
+    }
+    return static_cast<double>(value >> 1) / scale;
+}
+
+void binary_reader::read(time& value)
+{
+    auto packed = read_varint();
+    value.day_of_month = static_cast<uint8_t>((packed >> 11) & 0x1F);
+    value.hour_of_day = static_cast<uint8_t>((packed >> 6) & 0x1F);
+    value.minute_of_hour = static_cast<uint8_t>(packed & 0x3F);
+}
+
+void binary_reader::read(wind& value)
+{
+    auto flags = read_byte();
+    value.unit = read_enum(flags & 0x3U, speed_unit::mps);
+
+    auto direction = read_varint();
+    value.direction = direction == 0 ? UINT16_MAX : static_cast<uint16_t>(direction - 1);
+    value.wind_speed = read_byte();
+    value.gust_speed = read_byte();
+
+    value.variation_lower = util::nullopt;
+    value.variation_upper = util::nullopt;
+    if (flags & (1 << 2))
+    {
+        value.variation_lower = static_cast<uint16_t>(read_varint());
+    }
+    if (flags & (1 << 3))
+    {
+        value.variation_upper = static_cast<uint16_t>(read_varint());
+    }
+}
+
+void binary_reader::read(visibility& value)
+{
+    auto flags = read_byte();
+    value.unit = read_enum(flags & 0x3U, distance_unit::nautical_miles);
+    value.modifier = read_enum((flags >> 2) & 0x3U, visibility_modifier_type::greater_than);
+    value.distance = read_scaled(visibility_scale);
+}
+
+void binary_reader::read(directional_visibility& value)
+{
+    read(value.distance);
+    value.direction = read_enum(read_byte(), compass_direction::north_west);
+}
+
+void binary_reader::read(runway_visual_range& value)
+{
+    value.runway_number = read_byte();
+
+    auto flags = read_byte();
+    value.runway_designator = read_enum(flags & 0x3U, runway_designator_type::center);
+    value.tendency = read_enum((flags >> 2) & 0x3U, rvr_tendency::no_change);
+
+    read(value.visibility_min);
+    read(value.visibility_max);
+}
+
+void binary_reader::read(weather& value)
+{
+    auto packed = read_varint();
+    value.intensity = read_enum(packed & 0x3U, weather_intensity::in_the_vicinity);
+    value.descriptor = read_enum((packed >> 2) & 0xFU, weather_descriptor::freezing);
+
+    auto count = packed >> 6;
+    if (count > remaining())
+    {
+        throw aw_exception("Truncated binary report");
+    }
+
+    value.phenomena.resize(static_cast<size_t>(count));
+    for (auto& phenomenon : value.phenomena)
+    {
+        phenomenon = read_enum(read_byte(), weather_phenomena::duststorm);
+    }
+}
+
+void binary_reader::read(cloud_layer& value)
+{
+    auto flags = read_byte();
+    auto cover = flags & 0x7U;
+    value.sky_cover = cover == extended_sky_cover ? read_enum(read_byte(), sky_cover_type::no_cloud_detected) :
+        read_enum(cover, sky_cover_type::overcast);
+    value.cloud_type = read_enum((flags >> 3) & 0x3U, sky_cover_cloud_type::towering_cumulus);
+    value.unit = read_enum((flags >> 5) & 0x3U, distance_unit::nautical_miles);
+    value.layer_height = (flags & 0x80) ? UINT32_MAX : static_cast<uint32_t>(read_varint());
+}
+
+void binary_reader::read(altimeter& value)
+{
+    value.unit = read_enum(read_byte(), pressure_unit::inHg);
+    value.pressure = read_scaled(pressure_scale);
+}
+
+void binary_reader::read(runway_wind_shear& value)
+{
+    auto flags = read_byte();
+    value.all_runways = (flags & 1) != 0;
+    value.runway_designator = read_enum(static_cast<uint32_t>(flags >> 1), runway_designator_type::center);
+    value.runway_number = read_byte();
+}
+
+void binary_reader::read(metar_trend& value)
+{
+    auto flags = read_varint();
+    value.type = read_enum(flags & 0x3U, metar_trend_type::temporary);
+    value.no_significant_weather = (flags & trend_no_significant_weather) != 0;
+
+    read_group(*this, (flags & trend_from) != 0, value.from);
+    read_group(*this, (flags & trend_until) != 0, value.until);
+    read_group(*this, (flags & trend_at) != 0, value.at);
+    read_group(*this, (flags & trend_wind) != 0, value.wind_group);
+    read_group(*this, (flags & trend_visibility) != 0, value.visibility_group);
+    read(value.weather_group);
+    read(value.sky_condition_group);
+}
+
+// Copying this is much cheaper than default construction, which asks for
+// the current time
+metar const& binary_reader::empty_metar()
+{
+    static const metar empty;
+    return empty;
+}
+
+template <class TReport>
+void binary_reader::read_report(TReport& result)
+{
+    auto length = read_varint();
+    if (length > remaining())
+    {
+        throw aw_exception("Truncated binary report");
+    }
+
+    // Read the body on its own so that a report cannot run into the next
+    binary_reader body(m_position, static_cast<size_t>(length), m_spares);
+    m_position += length;
+
+    auto flags = body.read_varint();
+
+    result.type = (flags & report_special) ? metar_report_type::special : metar_report_type::metar;
+    result.modifier = (flags & report_corrected) ? metar_modifier_type::corrected :
+        (flags & report_automatic) ? metar_modifier_type::automatic : metar_modifier_type::none;
+
+    body.read_string(result.identifier);
+    body.read(result.observation_time);
+
+    read_group(body, (flags & report_wind) != 0, result.wind_group);
+    read_group(body, (flags & report_visibility) != 0, result.visibility_group);
+    read_group(body, (flags & report_minimum_visibility) != 0, result.minimum_visibility_group);
+    read_group(body, (flags & report_runway_visual_range) != 0, result.runway_visual_range_group);
+    read_group(body, (flags & report_weather) != 0, result.weather_group);
+    read_group(body, (flags & report_sky_condition) != 0, result.sky_condition_group);
+
+    result.temperature = util::nullopt;
+    if (flags & report_temperature)
+    {
+        result.temperature = static_cast<int8_t>(body.read_signed());
+    }
+    result.dewpoint = util::nullopt;
+    if (flags & report_dewpoint)
+    {
+        result.dewpoint = static_cast<int8_t>(body.read_signed());
+    }
+
+    read_group(body, (flags & report_altimeter) != 0, result.altimeter_group);
+    read_group(body, (flags & report_recent_weather) != 0, result.recent_weather_group);
+    read_group(body, (flags & report_wind_shear) != 0, result.wind_shear_group);
+    read_group(body, (flags & report_trend) != 0, result.trend_group);
+    read_text(body, (flags & report_raw_data) != 0, result.raw_data);
+    read_text(body, (flags & report_remarks) != 0, result.remarks);
+
+    // The fingerprint is not stored, so that it always agrees with the
+    // fields as decoded, whatever wrote them
+    result.update_content_hash();
+}
+
+void binary_reader::read(metar& result)
+{
+    read_report(result);
+}
+
+void binary_reader::read(metar_view& result)
+{
+    read_report(result);
+}
+
+//-----------------------------------------------------------------------------
+
+void encode(metar const& report, std::vector<uint8_t>& buffer, bool includeText)
+{
+    binary_writer(buffer).write(report, includeText);
+}
+
+metar decode(uint8_t const* data, size_t size, size_t* consumed)
+{
+    binary_reader reader(data, size);
+    auto report = binary_reader::empty_metar();
+    reader.read(report);
+    if (consumed)
+    {
+        *consumed = size - reader.remaining();
+    }
+    return report;
+}
+
+void decode(uint8_t const* data, size_t size, metar_view& report, size_t* consumed)
+{
+    binary_reader reader(data, size);
+    reader.read(report);
+    if (consumed)
+    {
+        *consumed = size - reader.remaining();
+    }
+}
+
+void encode(metar const* reports, size_t count, std::vector<uint8_t>& buffer, bool includeText)
+{
+    binary_writer writer(buffer);
+    for (auto magic : stream_magic)
+    {
+        writer.write_byte(magic);
+    }
+    writer.write_byte(binary_format_version);
+    writer.write_varint(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        writer.write(reports[i], includeText);
+    }
+}
+
+void encode(std::vector<metar> const& reports, std::vector<uint8_t>& buffer, bool includeText)
+{
+    encode(reports.data(), reports.size(), buffer, includeText);
+}
+
+void decode(uint8_t const* data, size_t size, std::vector<metar>& reports)
+{
+    binary_reader reader(data, size);
+    auto count = read_stream_header(reader);
+
+    // Reports are decoded in place, so that none of them need to be moved
+    auto initialSize = reports.size();
+    auto const& empty = binary_reader::empty_metar();
+    reports.reserve(initialSize + static_cast<size_t>(count));
+    try
+    {
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            reports.push_back(empty);
+            reader.read(reports.back());
+        }
+    }
+    catch (aw_exception const&)
+    {
+        reports.erase(reports.begin() + initialSize, reports.end());
+        throw;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+binary_stream_reader::binary_stream_reader(uint8_t const* data, size_t size) :
+    m_position(data),
+    m_end(data + size),
+    m_remaining(0),
+    m_size(0),
+    m_report(util::string_view()),
+    m_spares(new binary_spares())
+{
+    binary_reader reader(data, size);
+    m_size = static_cast<size_t>(read_stream_header(reader));
+    m_remaining = m_size;
+    m_position = reader.position();
+}
+
+binary_stream_reader::~binary_stream_reader()
+{}
+
+size_t binary_stream_reader::size() const
+{
+    return m_size;
+}
+
+bool binary_stream_reader::next()
+{
+    if (m_remaining == 0)
+    {
+        return false;
+    }
+
+    binary_reader reader(m_position, static_cast<size_t>(m_end - m_position), m_spares.get());
+    reader.read(m_report);
+    m_position = reader.position();
+    --m_remaining;
+    return true;
+}
+
+metar_view const& binary_stream_reader::report() const
+{
+    return m_report;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
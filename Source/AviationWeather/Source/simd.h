@@ -0,0 +1,127 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+// SSE2 is part of x64 and is selected explicitly for x86 builds with
+// /arch:SSE2. Without it the batch kernels use their scalar loops only.
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define AW_SSE2 1
+#endif
+
+#if defined(AW_SSE2)
+
+#include <limits>
+
+#include <emmintrin.h>
+
+namespace aw
+{
+namespace simd
+{
+
+//-----------------------------------------------------------------------------
+
+// Four single precision lanes. The transcendental functions are the Cephes
+// single precision approximations, accurate to a few units in the last place
+// over the ranges the kernels use. NaN inputs give NaN results.
+
+inline __m128 set(float value)
+{
+    return _mm_set1_ps(value);
+}
+
+// Lanes of a where the mask is set, otherwise lanes of b
+inline __m128 select(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// Horner evaluation, highest order coefficient first
+template <size_t N>
+inline __m128 polynomial(__m128 x, float const (&coefficients)[N])
+{
+    auto result = set(coefficients[0]);
+    for (size_t i = 1; i < N; ++i)
+    {
+        result = _mm_add_ps(_mm_mul_ps(result, x), set(coefficients[i]));
+    }
+    return result;
+}
+
+inline __m128 exp(__m128 x)
+{
+    static const float coefficients[] =
+    {
+        1.9875691500e-4f, 1.3981999507e-3f, 8.3334519073e-3f, 4.1665795894e-2f, 1.6666665459e-1f, 5.0000001201e-1f
+    };
+
+    // minps and maxps return their second operand for NaN, which keeps it
+    x = _mm_max_ps(set(-87.0f), _mm_min_ps(set(88.0f), x));
+
+    // x = n ln2 + r, with ln2 split in two so that r stays accurate
+    auto n = _mm_cvtps_epi32(_mm_mul_ps(x, set(1.44269504088896341f)));
+    auto nf = _mm_cvtepi32_ps(n);
+    auto r = _mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(nf, set(0.693359375f))), _mm_mul_ps(nf, set(-2.12194440e-4f)));
+
+    auto r2 = _mm_mul_ps(r, r);
+    auto y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(polynomial(r, coefficients), r2), r), set(1.0f));
+
+    // 2^n built directly in the exponent bits
+    auto scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+    return _mm_mul_ps(y, scale);
+}
+
+// Natural logarithm. Lanes that are not positive give NaN.
+inline __m128 log(__m128 x)
+{
+    static const float coefficients[] =
+    {
+        7.0376836292e-2f, -1.1514610310e-1f, 1.1676998740e-1f, -1.2420140846e-1f, 1.4249322787e-1f,
+        -1.6668057665e-1f, 2.0000714765e-1f, -2.4999993993e-1f, 3.3333331174e-1f
+    };
+
+    auto valid = _mm_cmpgt_ps(x, _mm_setzero_ps());
+
+    // x = m 2^e with m in [sqrt(1/2), sqrt(2))
+    auto bits = _mm_castps_si128(x);
+    auto e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(126)));
+    auto m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F000000)));
+
+    auto small = _mm_cmplt_ps(m, set(0.707106781186547524f));
+    e = _mm_sub_ps(e, _mm_and_ps(small, set(1.0f)));
+    m = _mm_sub_ps(_mm_add_ps(m, _mm_and_ps(small, m)), set(1.0f));
+
+    auto m2 = _mm_mul_ps(m, m);
+    auto y = _mm_mul_ps(_mm_mul_ps(polynomial(m, coefficients), m), m2);
+    y = _mm_add_ps(y, _mm_mul_ps(e, set(-2.12194440e-4f)));
+    y = _mm_sub_ps(y, _mm_mul_ps(m2, set(0.5f)));
+    auto result = _mm_add_ps(_mm_add_ps(m, y), _mm_mul_ps(e, set(0.693359375f)));
+
+    return select(valid, result, set(std::numeric_limits<float>::quiet_NaN()));
+}
+
+// x^y for positive x
+inline __m128 pow(__m128 x, __m128 y)
+{
+    return exp(_mm_mul_ps(y, log(x)));
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace simd
+} // namespace aw
+
+#endif
@@ -0,0 +1,496 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/taf.h>
+
+#include "token_decoders.h"
+#include "tokens.h"
+
+namespace aw
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+// ddhhmmZ
+bool decode_issue_time(util::string_view const& token, time& result)
+{
+    if (token.size() != 7 || token[6] != 'Z' || !are_digits(token, 0, 6))
+    {
+        return false;
+    }
+    result = time(static_cast<uint8_t>(to_number(token, 0, 2)),
+        static_cast<uint8_t>(to_number(token, 2, 2)),
+        static_cast<uint8_t>(to_number(token, 4, 2)));
+    return true;
+}
+
+// ddhh/ddhh
+bool decode_period(util::string_view const& token, time& begin, time& end)
+{
+    if (token.size() != 9 || token[4] != '/' || !are_digits(token, 0, 4) || !are_digits(token, 5, 4))
+    {
+        return false;
+    }
+    begin = time(static_cast<uint8_t>(to_number(token, 0, 2)), static_cast<uint8_t>(to_number(token, 2, 2)), 0);
+    end = time(static_cast<uint8_t>(to_number(token, 5, 2)), static_cast<uint8_t>(to_number(token, 7, 2)), 0);
+    return true;
+}
+
+// FMddhhmm
+bool decode_from(util::string_view const& token, time& begin)
+{
+    if (token.size() != 8 || !starts_with(token, "FM") || !are_digits(token, 2, 6))
+    {
+        return false;
+    }
+    begin = time(static_cast<uint8_t>(to_number(token, 2, 2)),
+        static_cast<uint8_t>(to_number(token, 4, 2)),
+        static_cast<uint8_t>(to_number(token, 6, 2)));
+    return true;
+}
+
+// PROBnn
+bool decode_probability(util::string_view const& token, uint8_t& probability)
+{
+    if (token.size() != 6 || !starts_with(token, "PROB") || !are_digits(token, 4, 2))
+    {
+        return false;
+    }
+    probability = static_cast<uint8_t>(to_number(token, 4, 2));
+    return true;
+}
+
+// WShhh/dddffKT
+bool decode_wind_shear(util::string_view const& token, wind_shear& result)
+{
+    if (token.size() < 8 || !starts_with(token, "WS") || token[5] != '/' || !are_digits(token, 2, 3))
+    {
+        return false;
+    }
+
+    wind shearWind;
+    if (!decode_wind_token(token.substr(6), shearWind))
+    {
+        return false;
+    }
+
+    result.height = static_cast<uint32_t>(to_number(token, 2, 3)) * 100;
+    result.wind_group = shearWind;
+    return true;
+}
+
+// Clears a period for reuse while keeping its allocated storage
+void reset_period(taf_period& period, taf_change_type change)
+{
+    period.change = change;
+    period.probability = 0;
+    period.begin = time();
+    period.end = time();
+    period.wind_group = util::nullopt;
+    period.visibility_group = util::nullopt;
+    period.weather_group.clear();
+    period.sky_condition_group.clear();
+    period.no_significant_weather = false;
+    period.wind_shear_group = util::nullopt;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+wind_shear::wind_shear() :
+    height(0)
+{}
+
+wind_shear::wind_shear(wind_shear && other) :
+    height(0)
+{
+    *this = std::move(other);
+}
+
+wind_shear& wind_shear::operator=(wind_shear && rhs)
+{
+    if (this != &rhs)
+    {
+        height = rhs.height;
+        wind_group = std::move(rhs.wind_group);
+
+        rhs.height = 0;
+        rhs.wind_group = wind();
+    }
+    return *this;
+}
+
+bool wind_shear::operator== (wind_shear const& rhs) const
+{
+    return (height == rhs.height) &&
+        (wind_group == rhs.wind_group);
+}
+
+bool wind_shear::operator!= (wind_shear const& rhs) const
+{
+    return !(*this == rhs);
+}
+
+//-----------------------------------------------------------------------------
+
+taf_period::taf_period() :
+    change(taf_change_type::initial),
+    probability(0),
+    no_significant_weather(false)
+{}
+
+taf_period::taf_period(taf_period && other) :
+    change(taf_change_type::initial),
+    probability(0),
+    no_significant_weather(false)
+{
+    *this = std::move(other);
+}
+
+taf_period& taf_period::operator=(taf_period && rhs)
+{
+    if (this != &rhs)
+    {
+        change = rhs.change;
+        probability = rhs.probability;
+        begin = std::move(rhs.begin);
+        end = std::move(rhs.end);
+        wind_group = std::move(rhs.wind_group);
+        visibility_group = std::move(rhs.visibility_group);
+        weather_group = std::move(rhs.weather_group);
+        sky_condition_group = std::move(rhs.sky_condition_group);
+        no_significant_weather = rhs.no_significant_weather;
+        wind_shear_group = std::move(rhs.wind_shear_group);
+
+        reset_period(rhs, taf_change_type::initial);
+    }
+    return *this;
+}
+
+bool taf_period::operator== (taf_period const& rhs) const
+{
+    return (change == rhs.change) &&
+        (probability == rhs.probability) &&
+        (begin == rhs.begin) &&
+        (end == rhs.end) &&
+        (wind_group == rhs.wind_group) &&
+        (visibility_group == rhs.visibility_group) &&
+        (weather_group == rhs.weather_group) &&
+        (sky_condition_group == rhs.sky_condition_group) &&
+        (no_significant_weather == rhs.no_significant_weather) &&
+        (wind_shear_group == rhs.wind_shear_group);
+}
+
+bool taf_period::operator!= (taf_period const& rhs) const
+{
+    return !(*this == rhs);
+}
+
+//-----------------------------------------------------------------------------
+
+taf::taf() :
+    raw_data(""),
+    type(taf_report_type::routine),
+    identifier(""),
+    cancelled(false),
+    remarks("")
+{}
+
+taf::taf(std::string const& taf) :
+    raw_data(""),
+    type(taf_report_type::routine),
+    identifier(""),
+    cancelled(false),
+    remarks("")
+{
+    parse(taf);
+}
+
+taf::taf(taf && other) :
+    raw_data(""),
+    type(taf_report_type::routine),
+    identifier(""),
+    cancelled(false),
+    remarks("")
+{
+    *this = std::move(other);
+}
+
+taf& taf::operator=(taf && rhs)
+{
+    if (this != &rhs)
+    {
+        raw_data = std::move(rhs.raw_data);
+        type = rhs.type;
+        identifier = std::move(rhs.identifier);
+        issue_time = std::move(rhs.issue_time);
+        valid_from = std::move(rhs.valid_from);
+        valid_to = std::move(rhs.valid_to);
+        cancelled = rhs.cancelled;
+        forecast_group = std::move(rhs.forecast_group);
+        remarks = std::move(rhs.remarks);
+
+        rhs.raw_data = "";
+        rhs.type = taf_report_type::routine;
+        rhs.identifier = "";
+        rhs.issue_time = time();
+        rhs.valid_from = time();
+        rhs.valid_to = time();
+        rhs.cancelled = false;
+        rhs.forecast_group.clear();
+        rhs.remarks = "";
+    }
+    return *this;
+}
+
+bool taf::operator== (taf const& rhs) const
+{
+    return (type == rhs.type) &&
+        (identifier == rhs.identifier) &&
+        (issue_time == rhs.issue_time) &&
+        (valid_from == rhs.valid_from) &&
+        (valid_to == rhs.valid_to) &&
+        (cancelled == rhs.cancelled) &&
+        (forecast_group == rhs.forecast_group) &&
+        (remarks == rhs.remarks);
+}
+
+bool taf::operator!= (taf const& rhs) const
+{
+    return !(*this == rhs);
+}
+
+void taf::parse(util::string_view const& taf)
+{
+    raw_data.assign(taf.data(), taf.size());
+    type = taf_report_type::routine;
+    identifier.clear();
+    issue_time = time();
+    valid_from = time();
+    valid_to = time();
+    cancelled = false;
+    remarks.clear();
+
+    // Periods are reused in place and any left over are removed at the end
+    size_t periodCount = 0;
+    auto addPeriod = [&](taf_change_type change) -> taf_period&
+    {
+        if (periodCount < forecast_group.size())
+        {
+            reset_period(forecast_group[periodCount], change);
+        }
+        else
+        {
+            forecast_group.emplace_back();
+            forecast_group.back().change = change;
+        }
+        return forecast_group[periodCount++];
+    };
+
+    bool inHeader = true;
+    bool done = false;
+    bool awaitingPeriod = false;
+    util::string_view visibilityWhole;
+
+    for_each_token(raw_data, [&](util::string_view token)
+    {
+        if (done)
+        {
+            return;
+        }
+
+        // Strip the end-of-report marker
+        if (token[token.size() - 1] == '=')
+        {
+            token = token.substr(0, token.size() - 1);
+            if (token.empty())
+            {
+                return;
+            }
+        }
+
+        if (inHeader)
+        {
+            if (token == "AMD")
+            {
+                type = taf_report_type::amended;
+            }
+            else if (token == "COR")
+            {
+                type = taf_report_type::corrected;
+            }
+            else if (token == "NIL")
+            {
+                done = true;
+            }
+            else if (decode_period(token, valid_from, valid_to))
+            {
+                auto& initial = addPeriod(taf_change_type::initial);
+                initial.begin = valid_from;
+                initial.end = valid_to;
+                inHeader = false;
+            }
+            else if (!decode_issue_time(token, issue_time) && token != "TAF" && identifier.empty() && token.size() == 4)
+            {
+                identifier.assign(token.data(), token.size());
+            }
+            return;
+        }
+
+        if (token == "RMK")
+        {
+            auto offset = static_cast<size_t>(token.data() - raw_data.data()) + token.size();
+            auto start = raw_data.find_first_not_of(" \r\n\t", offset);
+            auto last = raw_data.find_last_not_of(" \r\n\t=");
+            if (start != std::string::npos && last != std::string::npos && last >= start)
+            {
+                remarks.assign(raw_data, start, last - start + 1);
+            }
+            done = true;
+            return;
+        }
+
+        auto& current = forecast_group[periodCount - 1];
+
+        // A whole number of statute miles followed by a fraction, e.g. "1 1/2SM"
+        if (!visibilityWhole.empty())
+        {
+            auto whole = visibilityWhole;
+            visibilityWhole = util::string_view();
+
+            visibility visibilityGroup;
+            if (decode_visibility_token(whole, token, visibilityGroup))
+            {
+                current.visibility_group = visibilityGroup;
+                return;
+            }
+        }
+
+        time begin;
+        time end;
+        uint8_t probability = 0;
+        wind windGroup;
+        visibility visibilityGroup;
+        cloud_layer skyCondition;
+        wind_shear windShear;
+
+        if (awaitingPeriod && decode_period(token, begin, end))
+        {
+            current.begin = begin;
+            current.end = end;
+            awaitingPeriod = false;
+        }
+        else if (decode_from(token, begin))
+        {
+            addPeriod(taf_change_type::from).begin = begin;
+            awaitingPeriod = false;
+        }
+        else if (token == "BECMG")
+        {
+            addPeriod(taf_change_type::becoming);
+            awaitingPeriod = true;
+        }
+        else if (token == "TEMPO")
+        {
+            // PROBnn TEMPO is a single probabilistic temporary group
+            if (awaitingPeriod && current.change == taf_change_type::probability)
+            {
+                current.change = taf_change_type::temporary;
+            }
+            else
+            {
+                addPeriod(taf_change_type::temporary);
+            }
+            awaitingPeriod = true;
+        }
+        else if (decode_probability(token, probability))
+        {
+            addPeriod(taf_change_type::probability).probability = probability;
+            awaitingPeriod = true;
+        }
+        else if (token == "CNL")
+        {
+            cancelled = true;
+        }
+        else if (token == "NSW")
+        {
+            current.no_significant_weather = true;
+        }
+        else if (decode_wind_token(token, windGroup))
+        {
+            current.wind_group = windGroup;
+        }
+        else if (current.wind_group && decode_wind_variation_token(token, *current.wind_group))
+        {
+            // The variation is applied to the wind group in place
+        }
+        else if (decode_visibility_token(token, visibilityGroup))
+        {
+            current.visibility_group = visibilityGroup;
+        }
+        else if (token.size() == 1 && is_digit(token[0]))
+        {
+            visibilityWhole = token;
+        }
+        else if (decode_sky_condition_token(token, skyCondition))
+        {
+            current.sky_condition_group.push_back(skyCondition);
+        }
+        else if (decode_wind_shear(token, windShear))
+        {
+            current.wind_shear_group = windShear;
+        }
+        else
+        {
+            weather weatherGroup;
+            if (decode_weather_token(token, weatherGroup))
+            {
+                current.weather_group.push_back(std::move(weatherGroup));
+            }
+
+            // Other groups, such as TX/TN temperature forecasts, are ignored
+        }
+    });
+
+    forecast_group.erase(forecast_group.begin() + periodCount, forecast_group.end());
+
+    // The initial conditions and each FM group last until the next FM group
+    size_t previous = forecast_group.size();
+    for (size_t i = 0; i < forecast_group.size(); ++i)
+    {
+        auto change = forecast_group[i].change;
+        if (change != taf_change_type::initial && change != taf_change_type::from)
+        {
+            continue;
+        }
+        if (previous != forecast_group.size())
+        {
+            forecast_group[previous].end = forecast_group[i].begin;
+        }
+        forecast_group[i].end = valid_to;
+        previous = i;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
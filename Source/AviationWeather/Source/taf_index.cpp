@@ -0,0 +1,476 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/taf_index.h>
+
+#include <algorithm>
+
+#include <AviationWeather/converters.h>
+
+#include "flight_rules.h"
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const uint32_t minutes_per_hour = 60;
+const uint32_t minutes_per_day = 24 * minutes_per_hour;
+
+// Days past the day of month the validity period starts on, in a month of
+// monthLength days
+uint32_t day_offset(uint8_t day, uint8_t firstDay, uint8_t monthLength)
+{
+    return day >= firstDay ? day - firstDay : day + monthLength - firstDay;
+}
+
+// The number of days in the month the validity period starts in. The month
+// is not part of the report, so this is the later of the 28th and the last
+// day the report names from the start day on; the next month's days are all
+// earlier, as a validity period is at most 30 hours. A period ending at
+// midnight names the last day as hour 24, so the month is only taken to be
+// short if the period spans its last day without naming it.
+uint8_t month_length(taf const& forecast)
+{
+    auto const firstDay = forecast.valid_from.day_of_month;
+    uint8_t length = (std::max)(firstDay, static_cast<uint8_t>(28));
+    auto include = [firstDay, &length](time const& t)
+    {
+        if (t.day_of_month >= firstDay)
+        {
+            length = (std::max)(length, t.day_of_month);
+        }
+    };
+
+    include(forecast.valid_to);
+    for (auto const& period : forecast.forecast_group)
+    {
+        include(period.begin);
+        include(period.end);
+    }
+    return (std::min)(length, static_cast<uint8_t>(31));
+}
+
+bool is_cavok(visibility const& visibilityGroup)
+{
+    return visibilityGroup.unit == distance_unit::metres && visibilityGroup.distance == UINT16_MAX;
+}
+
+double peak_speed_kt(wind const& windGroup)
+{
+    return convert((std::max)(windGroup.wind_speed, windGroup.gust_speed), windGroup.unit, speed_unit::kt);
+}
+
+//-----------------------------------------------------------------------------
+
+// Replaces each element the period forecasts
+void apply_period(taf_conditions& conditions, taf_period const& period)
+{
+    if (period.wind_group)
+    {
+        conditions.wind_group = period.wind_group;
+    }
+    if (period.visibility_group)
+    {
+        conditions.visibility_group = period.visibility_group;
+    }
+    if (!period.weather_group.empty() || period.no_significant_weather)
+    {
+        conditions.weather_group = period.weather_group;
+    }
+    if (!period.sky_condition_group.empty())
+    {
+        conditions.sky_condition_group = period.sky_condition_group;
+    }
+
+    // CAVOK also means no significant weather or cloud
+    if (period.visibility_group && is_cavok(*period.visibility_group))
+    {
+        conditions.weather_group.clear();
+        if (period.sky_condition_group.empty())
+        {
+            conditions.sky_condition_group.assign(1, cloud_layer());
+        }
+    }
+}
+
+// Keeps the worse of each element the period forecasts
+void merge_worst(taf_conditions& conditions, taf_period const& period)
+{
+    if (period.wind_group && (!conditions.wind_group || peak_speed_kt(*period.wind_group) > peak_speed_kt(*conditions.wind_group)))
+    {
+        conditions.wind_group = period.wind_group;
+    }
+    if (period.visibility_group && (!conditions.visibility_group || *period.visibility_group < *conditions.visibility_group))
+    {
+        conditions.visibility_group = period.visibility_group;
+    }
+    for (auto const& weatherGroup : period.weather_group)
+    {
+        if (std::find(conditions.weather_group.begin(), conditions.weather_group.end(), weatherGroup) == conditions.weather_group.end())
+        {
+            conditions.weather_group.push_back(weatherGroup);
+        }
+    }
+    if (!period.sky_condition_group.empty() && (conditions.sky_condition_group.empty() ||
+        find_ceiling(period.sky_condition_group).layer_height < find_ceiling(conditions.sky_condition_group).layer_height))
+    {
+        conditions.sky_condition_group = period.sky_condition_group;
+    }
+}
+
+void classify(taf_conditions& conditions)
+{
+    conditions.ceiling = find_ceiling(conditions.sky_condition_group);
+    conditions.category = find_flight_category(conditions.visibility_group, conditions.sky_condition_group);
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+taf_conditions::taf_conditions() :
+    category(flight_category::unknown)
+{}
+
+taf_conditions::taf_conditions(taf_conditions && other) :
+    category(flight_category::unknown)
+{
+    *this = std::move(other);
+}
+
+taf_conditions& taf_conditions::operator=(taf_conditions && rhs)
+{
+    if (this != &rhs)
+    {
+        wind_group = std::move(rhs.wind_group);
+        visibility_group = std::move(rhs.visibility_group);
+        weather_group = std::move(rhs.weather_group);
+        sky_condition_group = std::move(rhs.sky_condition_group);
+        ceiling = std::move(rhs.ceiling);
+        category = rhs.category;
+
+        rhs.wind_group = util::nullopt;
+        rhs.visibility_group = util::nullopt;
+        rhs.weather_group.clear();
+        rhs.sky_condition_group.clear();
+        rhs.ceiling = cloud_layer();
+        rhs.category = flight_category::unknown;
+    }
+    return *this;
+}
+
+bool taf_conditions::operator== (taf_conditions const& rhs) const
+{
+    return (wind_group == rhs.wind_group) &&
+        (visibility_group == rhs.visibility_group) &&
+        (weather_group == rhs.weather_group) &&
+        (sky_condition_group == rhs.sky_condition_group) &&
+        (ceiling == rhs.ceiling) &&
+        (category == rhs.category);
+}
+
+bool taf_conditions::operator!= (taf_conditions const& rhs) const
+{
+    return !(*this == rhs);
+}
+
+//-----------------------------------------------------------------------------
+
+taf_index::taf_index() :
+    m_identifier(""),
+    m_monthLength(31)
+{}
+
+taf_index::taf_index(taf const& forecast) :
+    m_identifier(forecast.identifier),
+    m_validFrom(forecast.valid_from),
+    m_validTo(forecast.valid_to),
+    m_monthLength(month_length(forecast))
+{
+    auto const from = to_minutes(m_validFrom);
+    auto const to = to_minutes(m_validTo);
+    if (to <= from)
+    {
+        throw aw_exception("Invalid TAF validity period");
+    }
+
+    // Interval boundaries, clamped to the validity period
+    m_boundaries.push_back(from);
+    m_boundaries.push_back(to);
+    for (auto const& period : forecast.forecast_group)
+    {
+        m_boundaries.push_back((std::min)((std::max)(to_minutes(period.begin), from), to));
+        m_boundaries.push_back((std::min)((std::max)(to_minutes(period.end), from), to));
+    }
+    std::sort(m_boundaries.begin(), m_boundaries.end());
+    m_boundaries.erase(std::unique(m_boundaries.begin(), m_boundaries.end()), m_boundaries.end());
+
+    auto const intervalCount = m_boundaries.size() - 1;
+    m_prevailing.resize(intervalCount);
+    m_worstCase.resize(intervalCount);
+
+    for (size_t i = 0; i < intervalCount; ++i)
+    {
+        auto const at = m_boundaries[i];
+        auto& prevailing = m_prevailing[i];
+
+        // Groups are evaluated in report order, so a later FM group discards
+        // anything an earlier BECMG group changed
+        for (auto const& period : forecast.forecast_group)
+        {
+            switch (period.change)
+            {
+            case taf_change_type::initial:
+            case taf_change_type::from:
+                if (to_minutes(period.begin) <= at)
+                {
+                    prevailing = taf_conditions();
+                    apply_period(prevailing, period);
+                }
+                break;
+            case taf_change_type::becoming:
+                if (to_minutes(period.end) <= at)
+                {
+                    apply_period(prevailing, period);
+                }
+                break;
+            default:
+                break;
+            }
+        }
+
+        auto& worstCase = m_worstCase[i];
+        worstCase = prevailing;
+        for (auto const& period : forecast.forecast_group)
+        {
+            if (period.change == taf_change_type::initial || period.change == taf_change_type::from)
+            {
+                continue;
+            }
+            if (to_minutes(period.begin) <= at && at < to_minutes(period.end))
+            {
+                merge_worst(worstCase, period);
+            }
+        }
+
+        classify(prevailing);
+        classify(worstCase);
+    }
+}
+
+taf_index::taf_index(taf_index && other) :
+    m_identifier(""),
+    m_monthLength(31)
+{
+    *this = std::move(other);
+}
+
+taf_index& taf_index::operator=(taf_index && rhs)
+{
+    if (this != &rhs)
+    {
+        m_identifier = std::move(rhs.m_identifier);
+        m_validFrom = std::move(rhs.m_validFrom);
+        m_validTo = std::move(rhs.m_validTo);
+        m_monthLength = rhs.m_monthLength;
+        m_boundaries = std::move(rhs.m_boundaries);
+        m_prevailing = std::move(rhs.m_prevailing);
+        m_worstCase = std::move(rhs.m_worstCase);
+
+        rhs.m_identifier = "";
+        rhs.m_validFrom = time();
+        rhs.m_validTo = time();
+        rhs.m_monthLength = 31;
+        rhs.m_boundaries.clear();
+        rhs.m_prevailing.clear();
+        rhs.m_worstCase.clear();
+    }
+    return *this;
+}
+
+station_identifier const& taf_index::identifier() const
+{
+    return m_identifier;
+}
+
+time const& taf_index::valid_from() const
+{
+    return m_validFrom;
+}
+
+time const& taf_index::valid_to() const
+{
+    return m_validTo;
+}
+
+bool taf_index::covers(time const& at) const
+{
+    if (m_boundaries.empty())
+    {
+        return false;
+    }
+    auto const minutes = to_minutes(at);
+    return minutes >= m_boundaries.front() && minutes < m_boundaries.back();
+}
+
+taf_conditions const& taf_index::prevailing(time const& at) const
+{
+    auto result = find(m_prevailing, at);
+    if (result == nullptr)
+    {
+        throw aw_exception("Time is outside of the TAF validity period");
+    }
+    return *result;
+}
+
+taf_conditions const& taf_index::worst_case(time const& at) const
+{
+    auto result = find(m_worstCase, at);
+    if (result == nullptr)
+    {
+        throw aw_exception("Time is outside of the TAF validity period");
+    }
+    return *result;
+}
+
+void taf_index::prevailing(std::vector<time> const& times, std::vector<taf_conditions const*>& results) const
+{
+    results.resize(times.size());
+    for (size_t i = 0; i < times.size(); ++i)
+    {
+        results[i] = find(m_prevailing, times[i]);
+    }
+}
+
+void taf_index::worst_case(std::vector<time> const& times, std::vector<taf_conditions const*>& results) const
+{
+    results.resize(times.size());
+    for (size_t i = 0; i < times.size(); ++i)
+    {
+        results[i] = find(m_worstCase, times[i]);
+    }
+}
+
+uint32_t taf_index::to_minutes(time const& at) const
+{
+    // A day the month does not have is never covered
+    if (at.day_of_month > m_monthLength)
+    {
+        return UINT32_MAX;
+    }
+    return day_offset(at.day_of_month, m_validFrom.day_of_month, m_monthLength) * minutes_per_day +
+        at.hour_of_day * minutes_per_hour + at.minute_of_hour;
+}
+
+taf_conditions const* taf_index::find(std::vector<taf_conditions> const& conditions, time const& at) const
+{
+    if (!covers(at))
+    {
+        return nullptr;
+    }
+
+    // The interval is the one starting at the last boundary not after the time
+    auto boundary = std::upper_bound(m_boundaries.begin(), m_boundaries.end(), to_minutes(at));
+    return &conditions[static_cast<size_t>(boundary - m_boundaries.begin()) - 1];
+}
+
+//-----------------------------------------------------------------------------
+
+taf_index_set::taf_index_set()
+{}
+
+taf_index_set::taf_index_set(taf_index_set && other)
+{
+    *this = std::move(other);
+}
+
+taf_index_set& taf_index_set::operator=(taf_index_set && rhs)
+{
+    if (this != &rhs)
+    {
+        m_indices = std::move(rhs.m_indices);
+        rhs.m_indices.clear();
+    }
+    return *this;
+}
+
+void taf_index_set::insert(taf const& forecast)
+{
+    m_indices[forecast.identifier] = taf_index(forecast);
+}
+
+taf_index const* taf_index_set::find(station_identifier const& identifier) const
+{
+    auto result = m_indices.find(identifier);
+    return result != m_indices.end() ? &result->second : nullptr;
+}
+
+size_t taf_index_set::size() const
+{
+    return m_indices.size();
+}
+
+void taf_index_set::clear()
+{
+    m_indices.clear();
+}
+
+void taf_index_set::prevailing(std::vector<taf_query> const& queries, std::vector<taf_conditions const*>& results) const
+{
+    results.resize(queries.size());
+
+    // Queries are usually grouped by station, so the last index is reused
+    // rather than hashing the identifier again
+    taf_index const* index = nullptr;
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        if (index == nullptr || index->identifier() != queries[i].identifier)
+        {
+            index = find(queries[i].identifier);
+        }
+        results[i] = (index != nullptr && index->covers(queries[i].at)) ? &index->prevailing(queries[i].at) : nullptr;
+    }
+}
+
+void taf_index_set::worst_case(std::vector<taf_query> const& queries, std::vector<taf_conditions const*>& results) const
+{
+    results.resize(queries.size());
+
+    taf_index const* index = nullptr;
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        if (index == nullptr || index->identifier() != queries[i].identifier)
+        {
+            index = find(queries[i].identifier);
+        }
+        results[i] = (index != nullptr && index->covers(queries[i].at)) ? &index->worst_case(queries[i].at) : nullptr;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
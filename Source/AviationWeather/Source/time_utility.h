@@ -0,0 +1,46 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include <AviationWeather/components.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// Signed minutes from one report time to another. Reports carry the day of
+// month but not the month, so a difference of more than about half a month
+// is taken to cross a month boundary.
+inline int32_t minutes_between(time const& from, time const& to)
+{
+    int32_t days = to.day_of_month - from.day_of_month;
+    if (days < -15)
+    {
+        days += 31;
+    }
+    else if (days > 15)
+    {
+        days -= 31;
+    }
+    return (days * 24 + to.hour_of_day - from.hour_of_day) * 60 + to.minute_of_hour - from.minute_of_hour;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
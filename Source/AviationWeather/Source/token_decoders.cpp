@@ -0,0 +1,326 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <string>
+
+#include "decoders.h"
+#include "token_decoders.h"
+#include "tokens.h"
+
+namespace aw
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+bool is_code(const char* codes, util::string_view const& symbol)
+{
+    if (symbol.size() != 2)
+    {
+        return false;
+    }
+    for (auto code = codes; *code; code += 2)
+    {
+        if (code[0] == symbol[0] && code[1] == symbol[1])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Reads a run of at most maxDigits digits starting at pos, advancing pos
+size_t read_digits(util::string_view const& token, size_t& pos, size_t maxDigits)
+{
+    auto start = pos;
+    while (pos < token.size() && pos - start < maxDigits && is_digit(token[pos]))
+    {
+        ++pos;
+    }
+    return pos - start;
+}
+
+bool ends_with_statute_miles(util::string_view const& token)
+{
+    auto size = token.size();
+    return size > 2 && token[size - 2] == 'S' && token[size - 1] == 'M';
+}
+
+// n/d with a one-digit numerator and a one- or two-digit denominator
+bool decode_fraction(util::string_view const& text, double& result)
+{
+    if (text.size() < 3 || text.size() > 4 || !is_digit(text[0]) || text[1] != '/' ||
+        !are_digits(text, 2, text.size() - 2))
+    {
+        return false;
+    }
+
+    auto denominator = to_number(text, 2, text.size() - 2);
+    if (denominator == 0)
+    {
+        return false;
+    }
+    result = static_cast<double>(to_number(text, 0, 1)) / denominator;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+bool is_weather_descriptor(util::string_view const& symbol)
+{
+    return is_code("MIPRBCDRBLSHTSFZ", symbol);
+}
+
+bool is_weather_phenomenon(util::string_view const& symbol)
+{
+    return is_code("DZRASNSGICPLGRGSUPBRFGFUVADUSAHZPYPOSQFCSSDS", symbol);
+}
+
+//-----------------------------------------------------------------------------
+
+bool decode_wind_token(util::string_view const& token, wind& result)
+{
+    size_t pos = 0;
+    uint16_t direction = UINT16_MAX;
+    if (starts_with(token, "VRB"))
+    {
+        pos = 3;
+    }
+    else if (are_digits(token, 0, 3))
+    {
+        direction = static_cast<uint16_t>(to_number(token, 0, 3));
+        pos = 3;
+    }
+    else
+    {
+        return false;
+    }
+
+    auto speedStart = pos;
+    auto speedDigits = read_digits(token, pos, 3);
+    if (speedDigits < 2)
+    {
+        return false;
+    }
+    auto speed = to_number(token, speedStart, speedDigits);
+
+    int gust = 0;
+    if (pos < token.size() && token[pos] == 'G')
+    {
+        auto gustStart = ++pos;
+        auto gustDigits = read_digits(token, pos, 3);
+        if (gustDigits < 2)
+        {
+            return false;
+        }
+        gust = to_number(token, gustStart, gustDigits);
+    }
+
+    auto unit = token.substr(pos);
+    if (unit != "KT" && unit != "MPS")
+    {
+        return false;
+    }
+
+    result = wind();
+    result.unit = decode_speed_unit(unit.to_string());
+    result.direction = direction;
+    result.wind_speed = static_cast<uint8_t>(speed);
+    result.gust_speed = static_cast<uint8_t>(gust);
+    return true;
+}
+
+bool decode_wind_variation_token(util::string_view const& token, wind& result)
+{
+    if (token.size() != 7 || token[3] != 'V' || !are_digits(token, 0, 3) || !are_digits(token, 4, 3))
+    {
+        return false;
+    }
+
+    result.variation_lower = static_cast<uint16_t>(to_number(token, 0, 3));
+    result.variation_upper = static_cast<uint16_t>(to_number(token, 4, 3));
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+bool decode_visibility_token(util::string_view const& token, visibility& result)
+{
+    if (token == "CAVOK")
+    {
+        result = visibility(UINT16_MAX, distance_unit::metres);
+        return true;
+    }
+
+    // 9999NDV: automatic stations without directional variation
+    if ((token.size() == 4 || (token.size() == 7 && token.substr(4) == "NDV")) && are_digits(token, 0, 4))
+    {
+        result = visibility(to_number(token, 0, 4), distance_unit::metres);
+        return true;
+    }
+
+    if (!ends_with_statute_miles(token))
+    {
+        return false;
+    }
+
+    auto body = token.substr(0, token.size() - 2);
+    auto modifier = visibility_modifier_type::none;
+    if (body[0] == 'M' || body[0] == 'P')
+    {
+        modifier = body[0] == 'M' ? visibility_modifier_type::less_than : visibility_modifier_type::greater_than;
+        body = body.substr(1);
+    }
+
+    double distance = 0.0;
+    if (!body.empty() && body.size() <= 3 && are_digits(body, 0, body.size()))
+    {
+        distance = to_number(body, 0, body.size());
+    }
+    else if (!decode_fraction(body, distance))
+    {
+        return false;
+    }
+
+    result = visibility(distance, distance_unit::statute_miles, modifier);
+    return true;
+}
+
+bool decode_visibility_token(util::string_view const& whole, util::string_view const& fraction, visibility& result)
+{
+    if (whole.size() != 1 || !is_digit(whole[0]) || !ends_with_statute_miles(fraction))
+    {
+        return false;
+    }
+
+    double distance = 0.0;
+    if (!decode_fraction(fraction.substr(0, fraction.size() - 2), distance))
+    {
+        return false;
+    }
+
+    result = visibility(to_number(whole, 0, 1) + distance, distance_unit::statute_miles);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+bool decode_weather_token(util::string_view const& token, weather& result)
+{
+    size_t pos = 0;
+    auto intensity = weather_intensity::moderate;
+    if (!token.empty() && (token[0] == '-' || token[0] == '+'))
+    {
+        intensity = decode_weather_intensity(std::string(1, token[0]));
+        pos = 1;
+    }
+    else if (starts_with(token, "VC"))
+    {
+        intensity = weather_intensity::in_the_vicinity;
+        pos = 2;
+    }
+
+    auto descriptor = weather_descriptor::none;
+    if (pos + 2 <= token.size() && is_weather_descriptor(token.substr(pos, 2)))
+    {
+        descriptor = decode_weather_descriptor(token.substr(pos, 2).to_string());
+        pos += 2;
+    }
+
+    auto const phenomenaStart = pos;
+    while (pos + 2 <= token.size() && is_weather_phenomenon(token.substr(pos, 2)))
+    {
+        pos += 2;
+    }
+
+    if (pos != token.size() || (descriptor == weather_descriptor::none && pos == phenomenaStart))
+    {
+        return false;
+    }
+
+    result.intensity = intensity;
+    result.descriptor = descriptor;
+    result.phenomena.clear();
+    for (auto i = phenomenaStart; i < pos; i += 2)
+    {
+        result.phenomena.push_back(decode_weather_phenomena(token.substr(i, 2).to_string()));
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+bool decode_sky_condition_token(util::string_view const& token, cloud_layer& result)
+{
+    if (token == "SKC" || token == "CLR" || token == "NSC" || token == "NCD")
+    {
+        result = cloud_layer();
+        result.sky_cover = decode_sky_cover(token.to_string());
+        result.layer_height = UINT32_MAX;
+        result.cloud_type = sky_cover_cloud_type::none;
+        return true;
+    }
+
+    size_t coverLength = starts_with(token, "VV") ? 2 : 3;
+    if (token.size() < coverLength + 3)
+    {
+        return false;
+    }
+
+    auto cover = token.substr(0, coverLength);
+    if (coverLength == 3 && cover != "FEW" && cover != "SCT" && cover != "BKN" && cover != "OVC")
+    {
+        return false;
+    }
+
+    auto heightText = token.substr(coverLength, 3);
+    uint32_t height = 0;
+    if (are_digits(heightText, 0, 3))
+    {
+        height = static_cast<uint32_t>(to_number(heightText, 0, 3)) * 100;
+    }
+    else if (heightText != "///")
+    {
+        return false;
+    }
+
+    auto cloudType = sky_cover_cloud_type::unspecified;
+    auto suffix = token.substr(coverLength + 3);
+    if (suffix == "CB" || suffix == "TCU")
+    {
+        cloudType = decode_sky_cover_cloud_type(suffix.to_string());
+    }
+    else if (!suffix.empty())
+    {
+        return false;
+    }
+
+    result = cloud_layer();
+    result.sky_cover = decode_sky_cover(cover.to_string());
+    result.layer_height = height;
+    result.cloud_type = cloudType;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
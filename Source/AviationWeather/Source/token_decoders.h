@@ -0,0 +1,54 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <AviationWeather/components.h>
+#include <AviationWeather/string_view.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// Single-token decoders for the groups shared by METARs and forecasts. They
+// return false without modifying the result if the token is not a group of
+// that kind.
+
+// dddff(f)(Gff(f))KT, VRBff(f)KT
+bool decode_wind_token(util::string_view const& token, wind& result);
+
+// dddVddd, applied to a previously decoded wind
+bool decode_wind_variation_token(util::string_view const& token, wind& result);
+
+// CAVOK, dddd[NDV] (metres), [M|P]d(dd)SM, [M]n/dSM
+bool decode_visibility_token(util::string_view const& token, visibility& result);
+
+// The whole-number part of a visibility split across two tokens, e.g. "1 1/2SM"
+bool decode_visibility_token(util::string_view const& whole, util::string_view const& fraction, visibility& result);
+
+// [+|-|VC][descriptor][phenomena...]
+bool decode_weather_token(util::string_view const& token, weather& result);
+
+// SKC, CLR, NSC, NCD, {VV|FEW|SCT|BKN|OVC}hhh[CB|TCU]
+bool decode_sky_condition_token(util::string_view const& token, cloud_layer& result);
+
+// Two-letter weather codes
+bool is_weather_descriptor(util::string_view const& symbol);
+bool is_weather_phenomenon(util::string_view const& symbol);
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
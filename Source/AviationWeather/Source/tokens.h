@@ -0,0 +1,115 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+#include <AviationWeather/string_view.h>
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+// Helpers for the hand-written, regex-free parsers that walk a report token
+// by token.
+
+inline bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+inline bool are_digits(util::string_view const& token, size_t offset, size_t count)
+{
+    if (offset + count > token.size())
+    {
+        return false;
+    }
+    for (size_t i = offset; i < offset + count; ++i)
+    {
+        if (!is_digit(token[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline int to_number(util::string_view const& token, size_t offset, size_t count)
+{
+    int value = 0;
+    for (size_t i = offset; i < offset + count; ++i)
+    {
+        value = value * 10 + (token[i] - '0');
+    }
+    return value;
+}
+
+inline bool starts_with(util::string_view const& token, const char* prefix)
+{
+    size_t i = 0;
+    for (; prefix[i]; ++i)
+    {
+        if (i >= token.size() || token[i] != prefix[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline bool is_separator(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// Calls l(token) for each whitespace-separated token
+template <class TLambda>
+void for_each_token(util::string_view const& text, TLambda && l)
+{
+    size_t start = 0;
+    for (size_t i = 0; i <= text.size(); ++i)
+    {
+        if (i == text.size() || is_separator(text[i]))
+        {
+            if (i > start)
+            {
+                l(text.substr(start, i - start));
+            }
+            start = i + 1;
+        }
+    }
+}
+
+// Calls l(line) for each line, without the line terminator
+template <class TLambda>
+void for_each_line(util::string_view const& text, TLambda && l)
+{
+    size_t start = 0;
+    for (size_t i = 0; i <= text.size(); ++i)
+    {
+        if (i == text.size() || text[i] == '\n')
+        {
+            auto end = (i > start && text[i - 1] == '\r') ? i - 1 : i;
+            l(text.substr(start, end - start));
+            start = i + 1;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -25,6 +25,12 @@ namespace aw
 template <class TExpected = double, class TEnum, class TUnit, class TVal, class TLambda>
 bool comparison_conversion_helper(TEnum to, TUnit leftUnit, TUnit rightUnit, TVal const& leftVal, TVal const& rightVal, TLambda && l)
 {
+    // Values in the same unit compare as they are, whatever the common unit
+    if (leftUnit == rightUnit)
+    {
+        return l(static_cast<TExpected>(leftVal), static_cast<TExpected>(rightVal));
+    }
+
     auto lhs = leftUnit == to ? static_cast<TExpected>(leftVal) : convert<TExpected>(leftVal, leftUnit, to);
     auto rhs = rightUnit == to ? static_cast<TExpected>(rightVal) : convert<TExpected>(rightVal, rightUnit, to);
 
@@ -84,4 +90,22 @@ bool is_less_than_or_equal(T a, T b)
 
 //-----------------------------------------------------------------------------
 
+// Longitude in degrees moved by whole turns to within half a turn of the
+// reference, so that an area or route across the antimeridian stays in one
+// piece
+inline double unwrap_longitude(double longitude, double reference)
+{
+    while (longitude - reference > 180.0)
+    {
+        longitude -= 360.0;
+    }
+    while (longitude - reference < -180.0)
+    {
+        longitude += 360.0;
+    }
+    return longitude;
+}
+
+//-----------------------------------------------------------------------------
+
 } // namespace aw
@@ -0,0 +1,629 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/winds_aloft.h>
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+#include "time_utility.h"
+#include "tokens.h"
+
+//-----------------------------------------------------------------------------
+
+namespace aw
+{
+
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const double pi = 3.14159265358979323846;
+const double degrees_to_radians = pi / 180.0;
+
+const uint8_t cell_wind = 0x01;
+const uint8_t cell_temperature = 0x02;
+
+struct column
+{
+    size_t end;       // Offset of the last character of the altitude label
+    size_t altitude;  // Index into winds_aloft::altitudes
+};
+
+//-----------------------------------------------------------------------------
+
+bool is_station_token(util::string_view const& token)
+{
+    if (token.size() < 3 || token.size() > 4)
+    {
+        return false;
+    }
+    for (auto c : token)
+    {
+        if (!is_digit(c) && (c < 'A' || c > 'Z'))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool decode_time_token(util::string_view const& token, time& result)
+{
+    if (token.size() != 7 || !are_digits(token, 0, 6) || token[6] != 'Z')
+    {
+        return false;
+    }
+    result = time(static_cast<uint8_t>(to_number(token, 0, 2)), static_cast<uint8_t>(to_number(token, 2, 2)), static_cast<uint8_t>(to_number(token, 4, 2)));
+    return true;
+}
+
+// hhmm-hhmmZ, optionally followed by a full stop
+bool decode_use_period_token(util::string_view const& token, time& from, time& to)
+{
+    if (token.size() < 10 || !are_digits(token, 0, 4) || token[4] != '-' || !are_digits(token, 5, 4) || token[9] != 'Z')
+    {
+        return false;
+    }
+    from = time(0, static_cast<uint8_t>(to_number(token, 0, 2)), static_cast<uint8_t>(to_number(token, 2, 2)));
+    to = time(0, static_cast<uint8_t>(to_number(token, 5, 2)), static_cast<uint8_t>(to_number(token, 7, 2)));
+    return true;
+}
+
+// DDSS, DDSS+TT or DDSSTT. Directions are in tens of degrees; 50 is added
+// to the direction for speeds of 100 knots or more, and 9900 is light and
+// variable. Temperatures without a sign are negative above negativeAbove.
+bool decode_entry_token(util::string_view const& token, uint32_t altitude, uint32_t negativeAbove,
+    uint16_t& direction, uint8_t& speed, util::optional<int8_t>& temperature)
+{
+    if ((token.size() != 4 && token.size() != 6 && token.size() != 7) || !are_digits(token, 0, 4))
+    {
+        return false;
+    }
+
+    auto directionCode = to_number(token, 0, 2);
+    auto speedCode = to_number(token, 2, 2);
+    if (directionCode == 99 && speedCode == 0)
+    {
+        direction = UINT16_MAX;
+        speed = 0;
+    }
+    else
+    {
+        if (directionCode > 50)
+        {
+            directionCode -= 50;
+            speedCode += 100;
+        }
+        if (directionCode < 1 || directionCode > 36)
+        {
+            return false;
+        }
+        direction = static_cast<uint16_t>(directionCode * 10);
+        speed = static_cast<uint8_t>(speedCode);
+    }
+
+    temperature = util::nullopt;
+    if (token.size() == 7)
+    {
+        if ((token[4] != '+' && token[4] != '-') || !are_digits(token, 5, 2))
+        {
+            return false;
+        }
+        auto value = to_number(token, 5, 2);
+        temperature = static_cast<int8_t>(token[4] == '-' ? -value : value);
+    }
+    else if (token.size() == 6)
+    {
+        if (!are_digits(token, 4, 2))
+        {
+            return false;
+        }
+        auto value = to_number(token, 4, 2);
+        temperature = static_cast<int8_t>(altitude > negativeAbove ? -value : value);
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+// Finds the nearest cells with the flag at or below and above the altitude.
+// upper is the first altitude index above the altitude. On success the value
+// is cells[below] + weight * (cells[above] - cells[below]).
+bool find_levels(std::vector<uint32_t> const& altitudes, uint8_t const* flags, size_t upper, double altitude, uint8_t flag,
+    size_t& below, size_t& above, double& weight)
+{
+    below = upper;
+    while (below > 0 && !(flags[below - 1] & flag))
+    {
+        --below;
+    }
+    if (below == 0)
+    {
+        return false;
+    }
+    --below;
+
+    if (altitudes[below] == altitude)
+    {
+        above = below;
+        weight = 0.0;
+        return true;
+    }
+
+    above = upper;
+    while (above < altitudes.size() && !(flags[above] & flag))
+    {
+        ++above;
+    }
+    if (above == altitudes.size())
+    {
+        return false;
+    }
+
+    weight = (altitude - altitudes[below]) / (altitudes[above] - altitudes[below]);
+    return true;
+}
+
+void to_polar(double u, double v, winds_aloft_sample& result)
+{
+    result.speed = std::sqrt(u * u + v * v);
+    if (result.speed == 0.0)
+    {
+        result.direction = 0.0;
+        return;
+    }
+    result.direction = std::atan2(-u, -v) / degrees_to_radians;
+    if (result.direction <= 0.0)
+    {
+        result.direction += 360.0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+const size_t winds_aloft::npos;
+
+//-----------------------------------------------------------------------------
+
+winds_aloft::winds_aloft() :
+    raw_data(""),
+    use_from(0, 0, 0),
+    use_to(0, 0, 0),
+    negative_above(24000)
+{}
+
+winds_aloft::winds_aloft(std::string const& forecast) :
+    raw_data(""),
+    use_from(0, 0, 0),
+    use_to(0, 0, 0),
+    negative_above(24000)
+{
+    parse(forecast);
+}
+
+winds_aloft::winds_aloft(winds_aloft && other) :
+    raw_data(""),
+    use_from(0, 0, 0),
+    use_to(0, 0, 0),
+    negative_above(24000)
+{
+    *this = std::move(other);
+}
+
+winds_aloft& winds_aloft::operator=(winds_aloft && rhs)
+{
+    if (this != &rhs)
+    {
+        raw_data = std::move(rhs.raw_data);
+        based_on = std::move(rhs.based_on);
+        valid = std::move(rhs.valid);
+        use_from = std::move(rhs.use_from);
+        use_to = std::move(rhs.use_to);
+        negative_above = rhs.negative_above;
+        altitudes = std::move(rhs.altitudes);
+        stations = std::move(rhs.stations);
+        m_windU = std::move(rhs.m_windU);
+        m_windV = std::move(rhs.m_windV);
+        m_direction = std::move(rhs.m_direction);
+        m_speed = std::move(rhs.m_speed);
+        m_temperature = std::move(rhs.m_temperature);
+        m_flags = std::move(rhs.m_flags);
+        m_stationOrder = std::move(rhs.m_stationOrder);
+
+        rhs.raw_data = "";
+        rhs.based_on = time();
+        rhs.valid = time();
+        rhs.use_from = time(0, 0, 0);
+        rhs.use_to = time(0, 0, 0);
+        rhs.negative_above = 24000;
+        rhs.altitudes.clear();
+        rhs.stations.clear();
+        rhs.m_windU.clear();
+        rhs.m_windV.clear();
+        rhs.m_direction.clear();
+        rhs.m_speed.clear();
+        rhs.m_temperature.clear();
+        rhs.m_flags.clear();
+        rhs.m_stationOrder.clear();
+    }
+    return *this;
+}
+
+bool winds_aloft::operator== (winds_aloft const& rhs) const
+{
+    return (based_on == rhs.based_on) &&
+        (valid == rhs.valid) &&
+        (use_from == rhs.use_from) &&
+        (use_to == rhs.use_to) &&
+        (negative_above == rhs.negative_above) &&
+        (altitudes == rhs.altitudes) &&
+        (stations == rhs.stations) &&
+        (m_direction == rhs.m_direction) &&
+        (m_speed == rhs.m_speed) &&
+        (m_temperature == rhs.m_temperature) &&
+        (m_flags == rhs.m_flags);
+}
+
+bool winds_aloft::operator!= (winds_aloft const& rhs) const
+{
+    return !(*this == rhs);
+}
+
+void winds_aloft::parse(util::string_view const& forecast)
+{
+    raw_data.assign(forecast.data(), forecast.size());
+    based_on = time();
+    valid = time();
+    use_from = time(0, 0, 0);
+    use_to = time(0, 0, 0);
+    negative_above = 24000;
+    altitudes.clear();
+    stations.clear();
+    m_windU.clear();
+    m_windV.clear();
+    m_direction.clear();
+    m_speed.clear();
+    m_temperature.clear();
+    m_flags.clear();
+    m_stationOrder.clear();
+
+    // The first pass reads the header and the altitudes of every section so
+    // that rows from all sections share the same columns
+    for_each_line(forecast, [&](util::string_view const& line)
+    {
+        enum class expect { keyword, based_on, valid, use_period, negative_above } state = expect::keyword;
+        bool altitudeLine = false;
+        size_t index = 0;
+
+        for_each_token(line, [&](util::string_view const& token)
+        {
+            if (index++ == 0 && token == "FT")
+            {
+                altitudeLine = true;
+                return;
+            }
+            if (altitudeLine)
+            {
+                if (are_digits(token, 0, token.size()))
+                {
+                    altitudes.push_back(static_cast<uint32_t>(to_number(token, 0, token.size())));
+                }
+                return;
+            }
+
+            switch (state)
+            {
+            case expect::based_on:
+                state = decode_time_token(token, based_on) ? expect::keyword : state;
+                break;
+            case expect::valid:
+                decode_time_token(token, valid);
+                state = expect::keyword;
+                break;
+            case expect::use_period:
+                decode_use_period_token(token, use_from, use_to);
+                state = expect::keyword;
+                break;
+            case expect::negative_above:
+                if (are_digits(token, 0, token.size()) && !token.empty())
+                {
+                    negative_above = static_cast<uint32_t>(to_number(token, 0, token.size()));
+                }
+                state = expect::keyword;
+                break;
+            default:
+                if (token == "BASED")
+                {
+                    state = expect::based_on;
+                }
+                else if (token == "VALID")
+                {
+                    state = expect::valid;
+                }
+                else if (token == "USE")
+                {
+                    state = expect::use_period;
+                }
+                else if (token == "ABV")
+                {
+                    state = expect::negative_above;
+                }
+                break;
+            }
+        });
+    });
+
+    std::sort(altitudes.begin(), altitudes.end());
+    altitudes.erase(std::unique(altitudes.begin(), altitudes.end()), altitudes.end());
+
+    // The second pass decodes the rows. Cells are matched to the altitude
+    // label they are right-aligned with, since missing cells leave gaps
+    // rather than placeholders.
+    std::vector<column> columns;
+    std::unordered_map<std::string, size_t> rows;
+    auto addRow = [&](util::string_view const& identifier) -> size_t
+    {
+        auto key = identifier.to_string();
+        auto row = rows.find(key);
+        if (row != rows.end())
+        {
+            return row->second;
+        }
+
+        auto const station = stations.size();
+        rows.emplace(key, station);
+        stations.push_back(std::move(key));
+
+        auto const cellCount = stations.size() * altitudes.size();
+        m_windU.resize(cellCount, 0.0f);
+        m_windV.resize(cellCount, 0.0f);
+        m_direction.resize(cellCount, 0);
+        m_speed.resize(cellCount, 0);
+        m_temperature.resize(cellCount, 0);
+        m_flags.resize(cellCount, 0);
+        return station;
+    };
+
+    for_each_line(forecast, [&](util::string_view const& line)
+    {
+        util::string_view identifier;
+        size_t station = npos;
+        bool altitudeLine = false;
+        size_t index = 0;
+
+        for_each_token(line, [&](util::string_view const& token)
+        {
+            auto const offset = static_cast<size_t>(token.data() - line.data());
+            if (index++ == 0)
+            {
+                if (token == "FT")
+                {
+                    altitudeLine = true;
+                    columns.clear();
+                }
+                else if (!columns.empty() && offset == 0 && is_station_token(token))
+                {
+                    identifier = token;
+                }
+                return;
+            }
+
+            auto const end = offset + token.size() - 1;
+            if (altitudeLine)
+            {
+                if (are_digits(token, 0, token.size()))
+                {
+                    auto altitude = static_cast<uint32_t>(to_number(token, 0, token.size()));
+                    auto position = std::lower_bound(altitudes.begin(), altitudes.end(), altitude) - altitudes.begin();
+                    columns.push_back({ end, static_cast<size_t>(position) });
+                }
+                return;
+            }
+            if (identifier.empty())
+            {
+                return;
+            }
+
+            auto nearest = columns.begin();
+            for (auto it = columns.begin(); it != columns.end(); ++it)
+            {
+                auto distance = it->end > end ? it->end - end : end - it->end;
+                auto nearestDistance = nearest->end > end ? nearest->end - end : end - nearest->end;
+                if (distance < nearestDistance)
+                {
+                    nearest = it;
+                }
+            }
+
+            uint16_t direction;
+            uint8_t speed;
+            util::optional<int8_t> temperature;
+            if (!decode_entry_token(token, altitudes[nearest->altitude], negative_above, direction, speed, temperature))
+            {
+                return;
+            }
+
+            // Rows are added on their first decoded cell so that header
+            // lines of later sections are not mistaken for stations
+            if (station == npos)
+            {
+                station = addRow(identifier);
+            }
+
+            auto const i = cell(station, nearest->altitude);
+            m_direction[i] = direction;
+            m_speed[i] = speed;
+            m_flags[i] = cell_wind;
+            if (direction == UINT16_MAX)
+            {
+                m_windU[i] = 0.0f;
+                m_windV[i] = 0.0f;
+            }
+            else
+            {
+                m_windU[i] = static_cast<float>(-speed * std::sin(direction * degrees_to_radians));
+                m_windV[i] = static_cast<float>(-speed * std::cos(direction * degrees_to_radians));
+            }
+            if (temperature)
+            {
+                m_temperature[i] = *temperature;
+                m_flags[i] |= cell_temperature;
+            }
+        });
+    });
+
+    m_stationOrder.resize(stations.size());
+    for (size_t i = 0; i < stations.size(); ++i)
+    {
+        m_stationOrder[i] = static_cast<uint32_t>(i);
+    }
+    std::sort(m_stationOrder.begin(), m_stationOrder.end(), [this](uint32_t a, uint32_t b)
+    {
+        return stations[a] < stations[b];
+    });
+}
+
+size_t winds_aloft::find_station(util::string_view const& identifier) const
+{
+    auto result = std::lower_bound(m_stationOrder.begin(), m_stationOrder.end(), identifier, [this](uint32_t row, util::string_view const& value)
+    {
+        auto const& station = stations[row];
+        return std::lexicographical_compare(station.begin(), station.end(), value.begin(), value.end());
+    });
+    if (result != m_stationOrder.end() && util::string_view(stations[*result]) == identifier)
+    {
+        return *result;
+    }
+    return npos;
+}
+
+util::optional<wind> winds_aloft::wind_at(size_t station, size_t altitude) const
+{
+    auto const i = cell(station, altitude);
+    if (!(m_flags[i] & cell_wind))
+    {
+        return util::nullopt;
+    }
+
+    wind result;
+    result.direction = m_direction[i];
+    result.wind_speed = m_speed[i];
+    return result;
+}
+
+util::optional<int8_t> winds_aloft::temperature_at(size_t station, size_t altitude) const
+{
+    auto const i = cell(station, altitude);
+    if (!(m_flags[i] & cell_temperature))
+    {
+        return util::nullopt;
+    }
+    return m_temperature[i];
+}
+
+bool winds_aloft::interpolate(size_t station, double altitude, winds_aloft_sample& result) const
+{
+    result.has_wind = false;
+    result.has_temperature = false;
+    result.direction = 0.0;
+    result.speed = 0.0;
+    result.temperature = 0.0;
+
+    if (station >= stations.size())
+    {
+        return false;
+    }
+
+    auto const base = station * altitudes.size();
+    auto const upper = static_cast<size_t>(std::upper_bound(altitudes.begin(), altitudes.end(), altitude) - altitudes.begin());
+    auto const flags = m_flags.data() + base;
+
+    size_t below, above;
+    double weight;
+    if (find_levels(altitudes, flags, upper, altitude, cell_wind, below, above, weight))
+    {
+        auto u = m_windU[base + below] + weight * (m_windU[base + above] - m_windU[base + below]);
+        auto v = m_windV[base + below] + weight * (m_windV[base + above] - m_windV[base + below]);
+        to_polar(u, v, result);
+        result.has_wind = true;
+    }
+    if (find_levels(altitudes, flags, upper, altitude, cell_temperature, below, above, weight))
+    {
+        result.temperature = m_temperature[base + below] + weight * (m_temperature[base + above] - m_temperature[base + below]);
+        result.has_temperature = true;
+    }
+    return result.has_wind;
+}
+
+void winds_aloft::interpolate(size_t station, std::vector<double> const& sampleAltitudes, std::vector<winds_aloft_sample>& results) const
+{
+    results.resize(sampleAltitudes.size());
+    for (size_t i = 0; i < sampleAltitudes.size(); ++i)
+    {
+        interpolate(station, sampleAltitudes[i], results[i]);
+    }
+}
+
+size_t winds_aloft::cell(size_t station, size_t altitude) const
+{
+    return station * altitudes.size() + altitude;
+}
+
+//-----------------------------------------------------------------------------
+
+bool interpolate(winds_aloft const& earlier, winds_aloft const& later, util::string_view const& identifier,
+    double altitude, time const& at, winds_aloft_sample& result)
+{
+    winds_aloft_sample first, second;
+    earlier.interpolate(earlier.find_station(identifier), altitude, first);
+    later.interpolate(later.find_station(identifier), altitude, second);
+
+    result = first;
+    if (!first.has_wind || !second.has_wind)
+    {
+        result.has_wind = false;
+        return false;
+    }
+
+    auto const span = minutes_between(earlier.valid, later.valid);
+    auto const elapsed = minutes_between(earlier.valid, at);
+    auto const weight = span <= 0 ? 0.0 : (std::min)(1.0, (std::max)(0.0, static_cast<double>(elapsed) / span));
+
+    // Back to the wind vector so that direction wraps correctly
+    auto u1 = -first.speed * std::sin(first.direction * degrees_to_radians);
+    auto v1 = -first.speed * std::cos(first.direction * degrees_to_radians);
+    auto u2 = -second.speed * std::sin(second.direction * degrees_to_radians);
+    auto v2 = -second.speed * std::cos(second.direction * degrees_to_radians);
+    to_polar(u1 + weight * (u2 - u1), v1 + weight * (v2 - v1), result);
+
+    result.has_temperature = first.has_temperature && second.has_temperature;
+    result.temperature = result.has_temperature ? first.temperature + weight * (second.temperature - first.temperature) : 0.0;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw
@@ -0,0 +1,844 @@
+/**********************************************************************************
+ *                                                                                *
+ * Copyright (c) 2015 Steven Frost, Orion Lyau. All rights reserved.              *
+ *                                                                                *
+ * This source is subject to the MIT License.                                     *
+ * See http://opensource.org/licenses/MIT                                         *
+ *                                                                                *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,    *
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED          *
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.         *
+ *                                                                                *
+ * NOT TO BE USED AS A SOLE SOURCE OF INFORMATION FOR FLIGHT CRITICAL OPERATIONS. *
+ *                                                                                *
+ **********************************************************************************/
+
+#include "AviationWeatherPch.h"
+
+#include <AviationWeather/xml_ingest.h>
+
+#include <AviationWeather/converters.h>
+#include <AviationWeather/metar_diff.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "decimal.h"
+
+namespace aw
+{
+namespace
+{
+
+//-----------------------------------------------------------------------------
+
+const char metar_open[] = "<METAR";
+const char metar_close[] = "</METAR>";
+const char cdata_open[] = "<![CDATA[";
+const char cdata_close[] = "]]>";
+const char comment_open[] = "<!--";
+const char comment_close[] = "-->";
+
+template <size_t Size>
+constexpr size_t literal_size(const char (&)[Size])
+{
+    return Size - 1;
+}
+
+// Finds text in [begin, end), or returns end
+const char* find(const char* begin, const char* end, const char* text, size_t size)
+{
+    while (static_cast<size_t>(end - begin) >= size)
+    {
+        auto found = static_cast<const char*>(memchr(begin, text[0], static_cast<size_t>(end - begin) - size + 1));
+        if (found == nullptr)
+        {
+            break;
+        }
+        if (memcmp(found, text, size) == 0)
+        {
+            return found;
+        }
+        begin = found + 1;
+    }
+    return end;
+}
+
+template <size_t Size>
+const char* find(const char* begin, const char* end, const char (&text)[Size])
+{
+    return find(begin, end, text, Size - 1);
+}
+
+const char* find(const char* begin, const char* end, char c)
+{
+    auto found = static_cast<const char*>(memchr(begin, c, static_cast<size_t>(end - begin)));
+    return found == nullptr ? end : found;
+}
+
+bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+template <size_t Size>
+bool starts_with(const char* begin, const char* end, const char (&text)[Size])
+{
+    return static_cast<size_t>(end - begin) >= Size - 1 && memcmp(begin, text, Size - 1) == 0;
+}
+
+template <size_t Size>
+bool is_name(util::string_view const& name, const char (&text)[Size])
+{
+    return name.size() == Size - 1 && memcmp(name.data(), text, Size - 1) == 0;
+}
+
+// Finds the next <METAR> start tag, which may have attributes, or comment,
+// or returns end. A tag at the very end of the data is not found until the
+// character after its name is known.
+const char* find_metar(const char* begin, const char* end)
+{
+    for (;;)
+    {
+        begin = find(begin, end, '<');
+        if (static_cast<size_t>(end - begin) <= literal_size(metar_open))
+        {
+            return end;
+        }
+        if (starts_with(begin, end, comment_open))
+        {
+            return begin;
+        }
+
+        auto next = begin + literal_size(metar_open);
+        if (memcmp(begin, metar_open, literal_size(metar_open)) == 0 && (*next == '>' || *next == '/' || is_space(*next)))
+        {
+            return begin;
+        }
+        ++begin;
+    }
+}
+
+util::string_view trim(const char* begin, const char* end)
+{
+    while (begin < end && is_space(*begin))
+    {
+        ++begin;
+    }
+    while (end > begin && is_space(end[-1]))
+    {
+        --end;
+    }
+    return util::string_view(begin, static_cast<size_t>(end - begin));
+}
+
+util::optional<double> parse_number(util::string_view const& text)
+{
+    // The dataserver writes visibilities beyond what is reported as 10+
+    auto size = text.size();
+    if (size > 0 && text[size - 1] == '+')
+    {
+        --size;
+    }
+    return parse_decimal(text.data(), size);
+}
+
+// Replaces the predefined and character entities, as long as they are ASCII;
+// others are kept as they are
+void replace_entities(util::string_view const& text, std::string& result)
+{
+    static const struct
+    {
+        const char* name;
+        size_t      size;
+        char        value;
+    } entities[] =
+    {
+        { "&lt;", 4, '<' }, { "&gt;", 4, '>' }, { "&amp;", 5, '&' }, { "&quot;", 6, '"' }, { "&apos;", 6, '\'' }
+    };
+
+    result.clear();
+    auto end = text.end();
+    for (auto p = text.begin(); p < end; ++p)
+    {
+        if (*p != '&')
+        {
+            result += *p;
+            continue;
+        }
+
+        auto replaced = false;
+        for (auto const& entity : entities)
+        {
+            if (static_cast<size_t>(end - p) >= entity.size && memcmp(p, entity.name, entity.size) == 0)
+            {
+                result += entity.value;
+                p += entity.size - 1;
+                replaced = true;
+                break;
+            }
+        }
+
+        auto semicolon = find(p, end, ';');
+        if (!replaced && semicolon != end && end - p > 3 && p[1] == '#')
+        {
+            auto hex = p[2] == 'x' || p[2] == 'X';
+            unsigned long code = 0;
+            auto valid = semicolon > p + (hex ? 3 : 2);
+            for (auto digit = p + (hex ? 3 : 2); valid && digit < semicolon && code < 128; ++digit)
+            {
+                auto c = *digit;
+                if (c >= '0' && c <= '9')
+                {
+                    code = code * (hex ? 16 : 10) + static_cast<unsigned long>(c - '0');
+                }
+                else if (hex && ((c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F')))
+                {
+                    code = code * 16 + static_cast<unsigned long>((c | 0x20) - 'a' + 10);
+                }
+                else
+                {
+                    valid = false;
+                }
+            }
+            if (valid && code > 0 && code < 128)
+            {
+                result += static_cast<char>(code);
+                p = semicolon;
+                replaced = true;
+            }
+        }
+
+        if (!replaced)
+        {
+            result += '&';
+        }
+    }
+}
+
+// Calls handler(name, value) for each attribute in the text of a tag
+template <class THandler>
+void read_attributes(const char* begin, const char* end, THandler&& handler)
+{
+    for (;;)
+    {
+        auto equals = find(begin, end, '=');
+        if (equals == end)
+        {
+            return;
+        }
+
+        auto quote = equals + 1;
+        while (quote < end && is_space(*quote))
+        {
+            ++quote;
+        }
+        if (quote == end || (*quote != '"' && *quote != '\''))
+        {
+            return;
+        }
+
+        auto closing = find(quote + 1, end, *quote);
+        if (closing == end)
+        {
+            return;
+        }
+
+        handler(trim(begin, equals), util::string_view(quote + 1, static_cast<size_t>(closing - quote - 1)));
+        begin = closing + 1;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+const char* sky_cover_contraction(sky_cover_type cover)
+{
+    switch (cover)
+    {
+    case sky_cover_type::vertical_visibility:
+        return "OVX";
+    case sky_cover_type::sky_clear:
+        return "SKC";
+    case sky_cover_type::clear_below_12000:
+        return "CLR";
+    case sky_cover_type::few:
+        return "FEW";
+    case sky_cover_type::scattered:
+        return "SCT";
+    case sky_cover_type::broken:
+        return "BKN";
+    case sky_cover_type::no_significant_cloud:
+        return "NSC";
+    case sky_cover_type::no_cloud_detected:
+        return "NCD";
+    default:
+        return "OVC";
+    }
+}
+
+// Decoded values are rounded, and converted from metric units, so they agree
+// with the report to within these amounts
+const double temperature_tolerance = 1.0;
+const double speed_tolerance = 1.0;
+const double direction_tolerance = 0.5;
+const double altimeter_tolerance = 0.01;
+
+// Fields that were not decoded are not checked, as the dataserver can be
+// asked for a subset of them
+bool same_value(util::optional<double> const& decoded, bool reported, double value, double tolerance)
+{
+    if (!decoded)
+    {
+        return true;
+    }
+    return reported && std::abs(*decoded - value) <= tolerance;
+}
+
+bool same_time(util::string_view const& text, time const& reported)
+{
+    // 2015-12-12T17:56:00Z
+    if (text.size() < 16)
+    {
+        return true;
+    }
+
+    auto digits = [&](size_t pos)
+    {
+        auto a = text[pos];
+        auto b = text[pos + 1];
+        return (a >= '0' && a <= '9' && b >= '0' && b <= '9') ? (a - '0') * 10 + (b - '0') : -1;
+    };
+
+    auto day = digits(8);
+    auto hour = digits(11);
+    auto minute = digits(14);
+    if (day < 0 || hour < 0 || minute < 0)
+    {
+        return true;
+    }
+    return day == reported.day_of_month && hour == reported.hour_of_day && minute == reported.minute_of_hour;
+}
+
+bool same_wind(xml_fields const& fields, util::optional<wind> const& reported)
+{
+    if (!fields.wind_speed && !fields.wind_direction)
+    {
+        return true;
+    }
+    if (!reported)
+    {
+        return false;
+    }
+
+    auto const& w = *reported;
+    auto speed = convert(static_cast<double>(w.wind_speed), w.unit, speed_unit::kt);
+    auto gust = convert(static_cast<double>(w.gust_speed), w.unit, speed_unit::kt);
+    if (!same_value(fields.wind_speed, true, speed, speed_tolerance) ||
+        !same_value(fields.wind_gust, w.gust_speed > 0, gust, speed_tolerance))
+    {
+        return false;
+    }
+
+    // VRB winds have no direction to compare with, though winds varying
+    // between two directions do
+    return w.direction == UINT16_MAX || !fields.wind_direction ||
+        std::abs(*fields.wind_direction - w.direction) <= direction_tolerance;
+}
+
+bool same_visibility(util::optional<double> const& decoded, util::optional<visibility> const& reported)
+{
+    if (!decoded)
+    {
+        return true;
+    }
+    if (!reported)
+    {
+        return false;
+    }
+
+    // 10 km or more, including CAVOK, is decoded as 6.21 miles
+    auto const& v = *reported;
+    if (v.unit == distance_unit::metres && v.distance >= 9999)
+    {
+        return *decoded >= 6.2;
+    }
+
+    auto miles = convert(v.distance, v.unit, distance_unit::statute_miles);
+    return std::abs(*decoded - miles) <= 0.01 + 0.01 * (std::max)(*decoded, miles);
+}
+
+bool same_sky_condition(std::vector<xml_sky_condition> const& decoded, std::vector<cloud_layer> const& reported)
+{
+    if (decoded.empty())
+    {
+        return true;
+    }
+
+    // CAVOK is decoded as a layer of its own
+    auto count = std::count_if(decoded.begin(), decoded.end(), [](xml_sky_condition const& layer)
+    {
+        return layer.sky_cover != "CAVOK";
+    });
+    if (static_cast<size_t>(count) != reported.size())
+    {
+        return false;
+    }
+
+    size_t index = 0;
+    for (auto const& layer : decoded)
+    {
+        if (layer.sky_cover == "CAVOK")
+        {
+            continue;
+        }
+
+        auto const& expected = reported[index++];
+        if (layer.sky_cover != sky_cover_contraction(expected.sky_cover))
+        {
+            return false;
+        }
+        if (layer.cloud_base && !expected.is_unlimited() &&
+            std::abs(convert(static_cast<double>(expected.layer_height), expected.unit, distance_unit::feet) - *layer.cloud_base) > 0.5)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace
+
+//-----------------------------------------------------------------------------
+
+xml_sky_condition::xml_sky_condition()
+{}
+
+xml_sky_condition::xml_sky_condition(xml_sky_condition && other) :
+    sky_cover(other.sky_cover),
+    cloud_base(std::move(other.cloud_base))
+{
+    other.sky_cover = util::string_view();
+    other.cloud_base = util::nullopt;
+}
+
+xml_sky_condition& xml_sky_condition::operator=(xml_sky_condition && rhs)
+{
+    if (this != &rhs)
+    {
+        sky_cover = rhs.sky_cover;
+        cloud_base = std::move(rhs.cloud_base);
+
+        rhs.sky_cover = util::string_view();
+        rhs.cloud_base = util::nullopt;
+    }
+    return *this;
+}
+
+//-----------------------------------------------------------------------------
+
+xml_fields::xml_fields()
+{}
+
+xml_fields::xml_fields(xml_fields && other) :
+    station_id(other.station_id),
+    observation_time(other.observation_time),
+    metar_type(other.metar_type),
+    position(std::move(other.position)),
+    elevation(std::move(other.elevation)),
+    temperature(std::move(other.temperature)),
+    dewpoint(std::move(other.dewpoint)),
+    wind_direction(std::move(other.wind_direction)),
+    wind_speed(std::move(other.wind_speed)),
+    wind_gust(std::move(other.wind_gust)),
+    visibility(std::move(other.visibility)),
+    altimeter(std::move(other.altimeter)),
+    sky_condition(std::move(other.sky_condition))
+{
+    other.clear();
+}
+
+xml_fields& xml_fields::operator=(xml_fields && rhs)
+{
+    if (this != &rhs)
+    {
+        station_id = rhs.station_id;
+        observation_time = rhs.observation_time;
+        metar_type = rhs.metar_type;
+        position = std::move(rhs.position);
+        elevation = std::move(rhs.elevation);
+        temperature = std::move(rhs.temperature);
+        dewpoint = std::move(rhs.dewpoint);
+        wind_direction = std::move(rhs.wind_direction);
+        wind_speed = std::move(rhs.wind_speed);
+        wind_gust = std::move(rhs.wind_gust);
+        visibility = std::move(rhs.visibility);
+        altimeter = std::move(rhs.altimeter);
+        sky_condition = std::move(rhs.sky_condition);
+
+        rhs.clear();
+    }
+    return *this;
+}
+
+// Keeps the capacity of sky_condition, so that reading reuses it
+void xml_fields::clear()
+{
+    station_id = util::string_view();
+    observation_time = util::string_view();
+    metar_type = util::string_view();
+    position = util::nullopt;
+    elevation = util::nullopt;
+    temperature = util::nullopt;
+    dewpoint = util::nullopt;
+    wind_direction = util::nullopt;
+    wind_speed = util::nullopt;
+    wind_gust = util::nullopt;
+    visibility = util::nullopt;
+    altimeter = util::nullopt;
+    sky_condition.clear();
+}
+
+//-----------------------------------------------------------------------------
+
+xml_reader::xml_reader(std::istream& stream, bool crossCheck, size_t blockSize) :
+    m_stream(&stream),
+    m_data(nullptr),
+    m_size(0),
+    m_position(0),
+    m_blockSize((std::max)(blockSize, size_t(1))),
+    m_crossCheck(crossCheck),
+    m_mismatches(0)
+{}
+
+xml_reader::xml_reader(const char* data, size_t size, bool crossCheck) :
+    m_stream(nullptr),
+    m_data(data),
+    m_size(size),
+    m_position(0),
+    m_blockSize(0),
+    m_crossCheck(crossCheck),
+    m_mismatches(0)
+{}
+
+bool xml_reader::next()
+{
+    for (;;)
+    {
+        auto end = m_data + m_size;
+        auto open = find_metar(m_data + m_position, end);
+        auto comment = open != end && starts_with(open, end, comment_open);
+        if (comment)
+        {
+            auto close = find(open, end, comment_close);
+            if (close != end)
+            {
+                m_position = static_cast<size_t>(close - m_data) + literal_size(comment_close);
+                continue;
+            }
+        }
+        else if (open != end)
+        {
+            auto close = find(open, end, metar_close);
+            if (close != end)
+            {
+                m_position = static_cast<size_t>(close - m_data) + literal_size(metar_close);
+                read_element(open, close);
+                return true;
+            }
+        }
+
+        // Keeps an unfinished element or comment, or otherwise enough of the
+        // end to hold the start of a tag, and discards the rest
+        auto keep = open != end ? static_cast<size_t>(open - m_data) :
+            (std::max)(m_position, m_size - (std::min)(m_size, literal_size(metar_open)));
+        m_position = keep;
+
+        if (!fill())
+        {
+            if (open != end && !comment)
+            {
+                throw aw_exception("XML input ends inside a METAR element");
+            }
+            m_position = m_size;
+            return false;
+        }
+    }
+}
+
+metar_view const& xml_reader::report() const
+{
+    return *m_report;
+}
+
+xml_fields const& xml_reader::fields() const
+{
+    return m_fields;
+}
+
+uint16_t xml_reader::mismatches() const
+{
+    return m_mismatches;
+}
+
+// Moves what is kept to the front of the buffer and reads a block after it
+bool xml_reader::fill()
+{
+    if (m_stream == nullptr)
+    {
+        return false;
+    }
+
+    auto kept = m_size - m_position;
+    if (m_position > 0 && kept > 0)
+    {
+        memmove(m_buffer.data(), m_buffer.data() + m_position, kept);
+    }
+    m_size = kept;
+    m_position = 0;
+
+    if (m_buffer.size() < m_size + m_blockSize)
+    {
+        m_buffer.resize(m_size + m_blockSize);
+    }
+
+    m_stream->read(m_buffer.data() + m_size, static_cast<std::streamsize>(m_blockSize));
+    auto count = static_cast<size_t>(m_stream->gcount());
+    m_size += count;
+    m_data = m_buffer.data();
+    return count > 0;
+}
+
+void xml_reader::read_element(const char* begin, const char* end)
+{
+    m_fields.clear();
+    m_mismatches = 0;
+
+    util::string_view rawText;
+    auto hasRawText = false;
+    util::optional<double> latitude;
+    util::optional<double> longitude;
+
+    auto p = find(begin, end, '>');
+    while (p < end)
+    {
+        p = find(p, end, '<');
+        if (p == end)
+        {
+            break;
+        }
+
+        // End tags, processing instructions, comments and stray CDATA
+        auto tag = p + 1;
+        if (tag < end && (*tag == '/' || *tag == '?' || *tag == '!'))
+        {
+            if (starts_with(p, end, comment_open))
+            {
+                p = find(p, end, comment_close);
+            }
+            else if (starts_with(p, end, cdata_open))
+            {
+                p = find(p, end, cdata_close);
+            }
+            p = find(p, end, '>');
+            continue;
+        }
+
+        auto nameEnd = tag;
+        while (nameEnd < end && !is_space(*nameEnd) && *nameEnd != '/' && *nameEnd != '>')
+        {
+            ++nameEnd;
+        }
+        auto tagEnd = find(nameEnd, end, '>');
+        if (tagEnd == end)
+        {
+            break;
+        }
+
+        util::string_view name(tag, static_cast<size_t>(nameEnd - tag));
+        auto empty = tagEnd[-1] == '/';
+        p = tagEnd + 1;
+
+        if (is_name(name, "sky_condition"))
+        {
+            xml_sky_condition layer;
+            read_attributes(nameEnd, empty ? tagEnd - 1 : tagEnd, [&](util::string_view const& attribute, util::string_view const& value)
+            {
+                if (is_name(attribute, "sky_cover"))
+                {
+                    layer.sky_cover = value;
+                }
+                else if (is_name(attribute, "cloud_base_ft_agl"))
+                {
+                    auto base = parse_decimal(value.data(), value.size());
+                    if (base && *base >= 0)
+                    {
+                        layer.cloud_base = static_cast<uint32_t>(*base);
+                    }
+                }
+            });
+            m_fields.sky_condition.push_back(layer);
+            continue;
+        }
+        if (empty)
+        {
+            continue;
+        }
+
+        if (is_name(name, "raw_text"))
+        {
+            hasRawText = true;
+            if (starts_with(p, end, cdata_open))
+            {
+                auto text = p + literal_size(cdata_open);
+                auto close = find(text, end, cdata_close);
+                rawText = util::string_view(text, static_cast<size_t>(close - text));
+                p = close;
+                continue;
+            }
+
+            auto close = find(p, end, '<');
+            rawText = trim(p, close);
+            if (find(rawText.begin(), rawText.end(), '&') != rawText.end())
+            {
+                replace_entities(rawText, m_text);
+                rawText = util::string_view(m_text);
+            }
+            p = close;
+            continue;
+        }
+
+        auto close = find(p, end, '<');
+        auto value = trim(p, close);
+        p = close;
+
+        if (is_name(name, "station_id"))
+        {
+            m_fields.station_id = value;
+        }
+        else if (is_name(name, "observation_time"))
+        {
+            m_fields.observation_time = value;
+        }
+        else if (is_name(name, "metar_type"))
+        {
+            m_fields.metar_type = value;
+        }
+        else if (is_name(name, "latitude"))
+        {
+            latitude = parse_number(value);
+        }
+        else if (is_name(name, "longitude"))
+        {
+            longitude = parse_number(value);
+        }
+        else if (is_name(name, "elevation_m"))
+        {
+            m_fields.elevation = parse_number(value);
+        }
+        else if (is_name(name, "temp_c"))
+        {
+            m_fields.temperature = parse_number(value);
+        }
+        else if (is_name(name, "dewpoint_c"))
+        {
+            m_fields.dewpoint = parse_number(value);
+        }
+        else if (is_name(name, "wind_dir_degrees"))
+        {
+            m_fields.wind_direction = parse_number(value);
+        }
+        else if (is_name(name, "wind_speed_kt"))
+        {
+            m_fields.wind_speed = parse_number(value);
+        }
+        else if (is_name(name, "wind_gust_kt"))
+        {
+            m_fields.wind_gust = parse_number(value);
+        }
+        else if (is_name(name, "visibility_statute_mi"))
+        {
+            m_fields.visibility = parse_number(value);
+        }
+        else if (is_name(name, "altim_in_hg"))
+        {
+            m_fields.altimeter = parse_number(value);
+        }
+    }
+
+    if (!hasRawText)
+    {
+        throw aw_exception("METAR element has no raw_text");
+    }
+
+    if (latitude && longitude)
+    {
+        m_fields.position = geo_point{ *latitude, *longitude };
+    }
+
+    if (m_report)
+    {
+        *m_report = metar_view(rawText);
+    }
+    else
+    {
+        m_report = metar_view(rawText);
+    }
+
+    if (m_crossCheck)
+    {
+        cross_check();
+    }
+}
+
+void xml_reader::cross_check()
+{
+    auto const& report = *m_report;
+    auto const& fields = m_fields;
+    uint16_t mask = 0;
+
+    if (!fields.station_id.empty() && fields.station_id != report.identifier)
+    {
+        mask |= element_mask(metar_element_type::station_identifier);
+    }
+    if (!fields.metar_type.empty() && (fields.metar_type == "SPECI") != (report.type == metar_report_type::special))
+    {
+        mask |= element_mask(metar_element_type::report_type);
+    }
+    if (!same_time(fields.observation_time, report.observation_time))
+    {
+        mask |= element_mask(metar_element_type::observation_time);
+    }
+    if (!same_wind(fields, report.wind_group))
+    {
+        mask |= element_mask(metar_element_type::wind);
+    }
+    if (!same_visibility(fields.visibility, report.visibility_group))
+    {
+        mask |= element_mask(metar_element_type::visibility);
+    }
+    if (!same_sky_condition(fields.sky_condition, report.sky_condition_group))
+    {
+        mask |= element_mask(metar_element_type::sky_condition);
+    }
+    if (!same_value(fields.temperature, static_cast<bool>(report.temperature), report.temperature ? *report.temperature : 0, temperature_tolerance) ||
+        !same_value(fields.dewpoint, static_cast<bool>(report.dewpoint), report.dewpoint ? *report.dewpoint : 0, temperature_tolerance))
+    {
+        mask |= element_mask(metar_element_type::temperature_dewpoint);
+    }
+
+    auto const& altimeter = report.altimeter_group;
+    auto inches = altimeter ? convert(altimeter->pressure, altimeter->unit, pressure_unit::inHg) : 0.0;
+    if (!same_value(fields.altimeter, static_cast<bool>(altimeter), inches, altimeter_tolerance))
+    {
+        mask |= element_mask(metar_element_type::altimeter);
+    }
+
+    m_mismatches = mask;
+}
+
+//-----------------------------------------------------------------------------
+
+} // namespace aw